@@ -17,6 +17,7 @@
 #include "hdf_io_service.h"
 
 struct HdfSyscallAdapter;
+struct HdfDevEventDispatchPool;
 
 enum HdfDevListenerThreadStatus {
     LISTENER_UNINITED = 0,
@@ -34,9 +35,12 @@ struct HdfDevListenerThread {
     struct HdfSyscallAdapter *adapter;
     struct pollfd *pfds;
     uint16_t pfdSize;
+    int epollFd;
+    int wakeupFd;
     bool pollChanged;
     bool shouldStop;
     struct DListHead *listenerListPtr;
+    struct HdfDevEventDispatchPool *dispatchPool;
     uint8_t status;
 };
 
@@ -48,6 +52,8 @@ struct HdfSyscallAdapter {
     struct DListHead listNode;
     struct HdfDevListenerThread *thread;
     struct HdfSyscallAdapterGroup *group;
+    uint8_t *eventRingBuffer;
+    uint32_t eventRingSize;
 };
 
 struct HdfSyscallAdapterGroup {
@@ -56,6 +62,7 @@ struct HdfSyscallAdapterGroup {
     struct DListHead adapterList;
     struct HdfDevListenerThread *thread;
     struct DListHead listenerList;
+    struct HdfDevEventDispatchPool *dispatchPool;
 };
 
 #endif /* HDF_SYSCALL_ADAPTER_H */
@@ -8,6 +8,8 @@
 
 #include <errno.h>
 #include <limits.h>
+#include <osal_atomic.h>
+#include <osal_sem.h>
 #include <osal_thread.h>
 #include <osal_time.h>
 #include <poll.h>
@@ -15,11 +17,16 @@
 #include <sys/ioctl.h>
 #include <sys/stat.h>
 #include <unistd.h>
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#endif
 
 #include "hdf_base.h"
 #include "hdf_log.h"
 #include "hdf_sbuf.h"
 #include "osal_mem.h"
+#include "svcmgr_ioservice.h"
 
 #include "hdf_syscall_adapter.h"
 
@@ -83,13 +90,322 @@ static struct HdfSyscallAdapter *HdfFdToAdapterLocked(const struct HdfDevListene
     return NULL;
 }
 
+static void HdfDevEventDispatchToListeners(const struct DListHead *groupListeners, struct HdfSyscallAdapter *adapter,
+    int32_t id, struct HdfSBuf *sbuf, size_t dataSize)
+{
+    struct HdfDevEventlistener *listener = NULL;
+
+    /* Dispatch events to the service group listener */
+    if (groupListeners != NULL) {
+        DLIST_FOR_EACH_ENTRY(listener, groupListeners, struct HdfDevEventlistener, listNode) {
+            if (listener->onReceive != NULL) {
+                (void)listener->onReceive(listener, &adapter->super, id, sbuf);
+            } else if (listener->callBack != NULL) {
+                (void)listener->callBack(listener->priv, id, sbuf);
+            }
+            HdfSbufSetDataSize(sbuf, dataSize);
+        }
+    }
+
+    OsalMutexLock(&adapter->mutex);
+    /* Dispatch events to the service (SyscallAdapter) listener */
+    DLIST_FOR_EACH_ENTRY(listener, &adapter->listenerList, struct HdfDevEventlistener, listNode) {
+        if (listener->onReceive != NULL) {
+            (void)listener->onReceive(listener, &adapter->super, id, sbuf);
+        } else if (listener->callBack != NULL) {
+            (void)listener->callBack(listener->priv, id, sbuf);
+        }
+        HdfSbufSetDataSize(sbuf, dataSize);
+    }
+    OsalMutexUnlock(&adapter->mutex);
+}
+
+struct HdfDevEventJob {
+    struct HdfSyscallAdapter *adapter;
+    int32_t id;
+    uint32_t dataSize;
+    struct HdfSBuf *data;
+};
+
+/*
+ * The queue mutex guards the job queue and stats and is held shortly by the listener thread.
+ * The dispatch mutex is held while a job runs, taking all of them keeps group listeners away from workers.
+ */
+struct HdfDevEventWorker {
+    struct OsalThread thread;
+    struct OsalMutex queueMutex;
+    struct OsalMutex dispatchMutex;
+    struct OsalSem jobSem;
+    struct OsalSem slotSem;
+    struct OsalSem exitSem;
+    struct HdfDevEventJob *jobs;
+    uint32_t head;
+    uint32_t count;
+    uint32_t maxCount;
+    uint64_t dispatched;
+    uint64_t blocked;
+    struct HdfDevEventDispatchPool *pool;
+    bool created;
+    bool started;
+};
+
+struct HdfDevEventDispatchPool {
+    const struct DListHead *listenerListPtr;
+    uint32_t workerCount;
+    uint32_t queueDepth;
+    bool shouldStop;
+    struct HdfDevEventWorker workers[];
+};
+
+static bool HdfDevEventWorkerPop(struct HdfDevEventWorker *worker, struct HdfDevEventJob *job)
+{
+    bool ret = false;
+
+    OsalMutexLock(&worker->queueMutex);
+    if (worker->count > 0) {
+        *job = worker->jobs[worker->head];
+        worker->head = (worker->head + 1) % worker->pool->queueDepth;
+        worker->count--;
+        worker->dispatched++;
+        ret = true;
+    }
+    OsalMutexUnlock(&worker->queueMutex);
+    return ret;
+}
+
+static int32_t HdfDevEventWorkerTask(void *para)
+{
+    struct HdfDevEventWorker *worker = (struct HdfDevEventWorker *)para;
+    struct HdfDevEventDispatchPool *pool = worker->pool;
+    struct HdfDevEventJob job;
+
+    while (!pool->shouldStop) {
+        (void)OsalSemWait(&worker->jobSem, HDF_WAIT_FOREVER);
+        OsalMutexLock(&worker->dispatchMutex);
+        if (pool->shouldStop || !HdfDevEventWorkerPop(worker, &job)) {
+            OsalMutexUnlock(&worker->dispatchMutex);
+            continue;
+        }
+        (void)OsalSemPost(&worker->slotSem);
+        HdfDevEventDispatchToListeners(pool->listenerListPtr, job.adapter, job.id, job.data, job.dataSize);
+        OsalMutexUnlock(&worker->dispatchMutex);
+        HdfSbufRecycle(job.data);
+    }
+
+    (void)OsalSemPost(&worker->exitSem);
+    return HDF_SUCCESS;
+}
+
+static void HdfDevEventWorkerDeinit(struct HdfDevEventWorker *worker)
+{
+    struct HdfDevEventJob job;
+
+    /* the worker posts exitSem on its way out, after that it no longer touches the worker */
+    if (worker->started) {
+        (void)OsalSemWait(&worker->exitSem, HDF_WAIT_FOREVER);
+    }
+    while (HdfDevEventWorkerPop(worker, &job)) {
+        HdfSbufRecycle(job.data);
+    }
+    if (worker->created) {
+        (void)OsalThreadDestroy(&worker->thread);
+    }
+    (void)OsalSemDestroy(&worker->exitSem);
+    (void)OsalSemDestroy(&worker->slotSem);
+    (void)OsalSemDestroy(&worker->jobSem);
+    (void)OsalMutexDestroy(&worker->dispatchMutex);
+    (void)OsalMutexDestroy(&worker->queueMutex);
+    OsalMemFree(worker->jobs);
+}
+
+static int32_t HdfDevEventWorkerInit(struct HdfDevEventDispatchPool *pool, struct HdfDevEventWorker *worker)
+{
+    struct OsalThreadParam config = {
+        .name = "hdf_event_worker",
+        .priority = OSAL_THREAD_PRI_DEFAULT,
+        .stackSize = 0,
+    };
+
+    worker->pool = pool;
+    worker->jobs = OsalMemCalloc(sizeof(struct HdfDevEventJob) * pool->queueDepth);
+    if (worker->jobs == NULL) {
+        return HDF_ERR_MALLOC_FAIL;
+    }
+    if (OsalMutexInit(&worker->queueMutex) != HDF_SUCCESS || OsalMutexInit(&worker->dispatchMutex) != HDF_SUCCESS ||
+        OsalSemInit(&worker->jobSem, 0) != HDF_SUCCESS ||
+        OsalSemInit(&worker->slotSem, pool->queueDepth) != HDF_SUCCESS ||
+        OsalSemInit(&worker->exitSem, 0) != HDF_SUCCESS) {
+        HdfDevEventWorkerDeinit(worker);
+        return HDF_FAILURE;
+    }
+    if (OsalThreadCreate(&worker->thread, HdfDevEventWorkerTask, worker) != HDF_SUCCESS) {
+        HdfDevEventWorkerDeinit(worker);
+        return HDF_ERR_THREAD_CREATE_FAIL;
+    }
+    worker->created = true;
+    if (OsalThreadStart(&worker->thread, &config) != HDF_SUCCESS) {
+        HdfDevEventWorkerDeinit(worker);
+        return HDF_ERR_THREAD_CREATE_FAIL;
+    }
+    worker->started = true;
+    return HDF_SUCCESS;
+}
+
+static void HdfDevEventDispatchPoolDestroy(struct HdfDevEventDispatchPool *pool)
+{
+    uint32_t i;
+
+    if (pool == NULL) {
+        return;
+    }
+    pool->shouldStop = true;
+    for (i = 0; i < pool->workerCount; i++) {
+        (void)OsalSemPost(&pool->workers[i].jobSem);
+    }
+    for (i = 0; i < pool->workerCount; i++) {
+        HdfDevEventWorkerDeinit(&pool->workers[i]);
+    }
+    OsalMemFree(pool);
+}
+
+static struct HdfDevEventDispatchPool *HdfDevEventDispatchPoolCreate(
+    const struct DListHead *listenerList, uint32_t workerCount, uint32_t queueDepth)
+{
+    struct HdfDevEventDispatchPool *pool =
+        OsalMemCalloc(sizeof(struct HdfDevEventDispatchPool) + sizeof(struct HdfDevEventWorker) * workerCount);
+    if (pool == NULL) {
+        return NULL;
+    }
+
+    pool->listenerListPtr = listenerList;
+    pool->queueDepth = queueDepth;
+    for (pool->workerCount = 0; pool->workerCount < workerCount; pool->workerCount++) {
+        if (HdfDevEventWorkerInit(pool, &pool->workers[pool->workerCount]) != HDF_SUCCESS) {
+            HDF_LOGE("%s: failed to start event worker %u", __func__, pool->workerCount);
+            HdfDevEventDispatchPoolDestroy(pool);
+            return NULL;
+        }
+    }
+    return pool;
+}
+
+static void HdfDevEventDispatchPoolLockAll(struct HdfDevEventDispatchPool *pool)
+{
+    if (pool == NULL) {
+        return;
+    }
+    for (uint32_t i = 0; i < pool->workerCount; i++) {
+        OsalMutexLock(&pool->workers[i].dispatchMutex);
+    }
+}
+
+static void HdfDevEventDispatchPoolUnlockAll(struct HdfDevEventDispatchPool *pool)
+{
+    if (pool == NULL) {
+        return;
+    }
+    for (uint32_t i = pool->workerCount; i > 0; i--) {
+        OsalMutexUnlock(&pool->workers[i - 1].dispatchMutex);
+    }
+}
+
+static struct HdfDevEventWorker *HdfDevEventDispatchPoolSelect(
+    struct HdfDevEventDispatchPool *pool, const struct HdfSyscallAdapter *adapter)
+{
+    /* all events of one service go to the same worker to keep them in order */
+    return &pool->workers[(uint32_t)adapter->fd % pool->workerCount];
+}
+
+static int32_t HdfDevEventDispatchPoolSubmit(struct HdfDevEventDispatchPool *pool, struct HdfSyscallAdapter *adapter,
+    int32_t id, struct HdfSBuf *data, uint32_t dataSize)
+{
+    struct HdfDevEventWorker *worker = HdfDevEventDispatchPoolSelect(pool, adapter);
+
+    if (OsalSemWait(&worker->slotSem, 0) != HDF_SUCCESS) {
+        /* queue full, hold the listener thread back until the worker catches up */
+        OsalMutexLock(&worker->queueMutex);
+        worker->blocked++;
+        OsalMutexUnlock(&worker->queueMutex);
+        if (OsalSemWait(&worker->slotSem, HDF_WAIT_FOREVER) != HDF_SUCCESS) {
+            return HDF_FAILURE;
+        }
+    }
+
+    OsalMutexLock(&worker->queueMutex);
+    struct HdfDevEventJob *job = &worker->jobs[(worker->head + worker->count) % pool->queueDepth];
+    job->adapter = adapter;
+    job->id = id;
+    job->dataSize = dataSize;
+    job->data = data;
+    worker->count++;
+    if (worker->count > worker->maxCount) {
+        worker->maxCount = worker->count;
+    }
+    OsalMutexUnlock(&worker->queueMutex);
+    (void)OsalSemPost(&worker->jobSem);
+    return HDF_SUCCESS;
+}
+
+/* Drops the queued events of a service and waits for its running dispatch, so the service can be released. */
+static void HdfDevEventDispatchPoolPurge(struct HdfDevEventDispatchPool *pool, const struct HdfSyscallAdapter *adapter)
+{
+    struct HdfDevEventWorker *worker = NULL;
+    uint32_t kept = 0;
+    uint32_t i;
+
+    if (pool == NULL) {
+        return;
+    }
+    worker = HdfDevEventDispatchPoolSelect(pool, adapter);
+    OsalMutexLock(&worker->dispatchMutex);
+    OsalMutexLock(&worker->queueMutex);
+    for (i = 0; i < worker->count; i++) {
+        struct HdfDevEventJob *job = &worker->jobs[(worker->head + i) % pool->queueDepth];
+        if (job->adapter == adapter) {
+            HdfSbufRecycle(job->data);
+            continue;
+        }
+        worker->jobs[(worker->head + kept) % pool->queueDepth] = *job;
+        kept++;
+    }
+    for (i = kept; i < worker->count; i++) {
+        (void)OsalSemPost(&worker->slotSem);
+    }
+    worker->count = kept;
+    OsalMutexUnlock(&worker->queueMutex);
+    OsalMutexUnlock(&worker->dispatchMutex);
+}
+
+static struct HdfSBuf *HdfDevEventCopySbuf(const uint8_t *data, uint32_t size)
+{
+    struct HdfSBuf *sbuf = NULL;
+    uint8_t *copy = NULL;
+
+    if (size == 0) {
+        return HdfSbufObtain(sizeof(int));
+    }
+    copy = OsalMemAlloc(size);
+    if (copy == NULL) {
+        return NULL;
+    }
+    (void)memcpy_s(copy, size, data, size);
+    sbuf = HdfSbufBind((uintptr_t)copy, size);
+    if (sbuf == NULL) {
+        OsalMemFree(copy);
+        return NULL;
+    }
+    HdfSbufTransDataOwnership(sbuf);
+    return sbuf;
+}
+
 static int32_t HdfDevEventDispatchLocked(
     const struct HdfDevListenerThread *thread, struct HdfSyscallAdapter *adapter, const struct HdfWriteReadBuf *bwr)
 {
-    struct HdfDevEventlistener *listener = NULL;
     struct HdfSBuf *sbuf = NULL;
 
-    if (bwr->readConsumed > 0) {
+    if (thread->dispatchPool != NULL) {
+        sbuf = HdfDevEventCopySbuf((const uint8_t *)(uintptr_t)bwr->readBuffer, bwr->readConsumed);
+    } else if (bwr->readConsumed > 0) {
         sbuf = HdfSbufBind(bwr->readBuffer, bwr->readConsumed);
     } else {
         sbuf = HdfSbufObtain(sizeof(int));
@@ -100,31 +416,50 @@ static int32_t HdfDevEventDispatchLocked(
         return HDF_DEV_ERR_NO_MEMORY;
     }
 
-    /* Dispatch events to the service group listener */
-    if (thread->listenerListPtr != NULL) {
-        DLIST_FOR_EACH_ENTRY(listener, thread->listenerListPtr, struct HdfDevEventlistener, listNode) {
-            if (listener->onReceive != NULL) {
-                (void)listener->onReceive(listener, &adapter->super, bwr->cmdCode, sbuf);
-            } else if (listener->callBack != NULL) {
-                (void)listener->callBack(listener->priv, bwr->cmdCode, sbuf);
-            }
-            HdfSbufSetDataSize(sbuf, bwr->readConsumed);
+    if (thread->dispatchPool != NULL) {
+        if (HdfDevEventDispatchPoolSubmit(thread->dispatchPool, adapter, bwr->cmdCode, sbuf, bwr->readConsumed) !=
+            HDF_SUCCESS) {
+            HdfSbufRecycle(sbuf);
+            return HDF_FAILURE;
         }
+        return HDF_SUCCESS;
     }
 
-    OsalMutexLock(&adapter->mutex);
-    /* Dispatch events to the service (SyscallAdapter) listener */
-    DLIST_FOR_EACH_ENTRY(listener, &adapter->listenerList, struct HdfDevEventlistener, listNode) {
-        if (listener->onReceive != NULL) {
-            (void)listener->onReceive(listener, &adapter->super, bwr->cmdCode, sbuf);
-        } else if (listener->callBack != NULL) {
-            (void)listener->callBack(listener->priv, bwr->cmdCode, sbuf);
+    HdfDevEventDispatchToListeners(thread->listenerListPtr, adapter, bwr->cmdCode, sbuf, bwr->readConsumed);
+    HdfSbufRecycle(sbuf);
+    return HDF_SUCCESS;
+}
+
+static int32_t HdfDevEventRingDrainAndDispatch(struct HdfDevListenerThread *thread, struct HdfSyscallAdapter *adapter)
+{
+    struct HdfDevEventDrain drain = {
+        .buffer = (uintptr_t)adapter->eventRingBuffer,
+        .size = adapter->eventRingSize,
+    };
+    struct HdfWriteReadBuf bwr = {0};
+
+    if (ioctl(adapter->fd, HDF_READ_DEV_EVENT_RING, &drain) != 0) {
+        HDF_LOGE("%s:ioctl failed, errno=%d", __func__, errno);
+        return errno;
+    }
+    if (drain.dropped != 0) {
+        HDF_LOGW("%s: %u events dropped by driver", __func__, drain.dropped);
+    }
+
+    uint32_t offset = 0;
+    for (uint32_t i = 0; i < drain.count && offset < drain.consumed; i++) {
+        const struct HdfDevEventRecord *record =
+            (const struct HdfDevEventRecord *)(adapter->eventRingBuffer + offset);
+        bwr.readBuffer = (uintptr_t)(record + 1);
+        bwr.readConsumed = record->size;
+        bwr.cmdCode = (int32_t)record->id;
+        int32_t ret = HdfDevEventDispatchLocked(thread, adapter, &bwr);
+        if (ret != HDF_SUCCESS) {
+            return ret;
         }
-        HdfSbufSetDataSize(sbuf, bwr->readConsumed);
+        offset += HDF_DEV_EVENT_RECORD_SIZE(record->size);
     }
-    OsalMutexUnlock(&adapter->mutex);
 
-    HdfSbufRecycle(sbuf);
     return HDF_SUCCESS;
 }
 
@@ -151,6 +486,11 @@ static int32_t HdfDevEventReadAndDispatch(struct HdfDevListenerThread *thread, i
         goto FINISH;
     }
 
+    if (adapter->eventRingBuffer != NULL) {
+        ret = HdfDevEventRingDrainAndDispatch(thread, adapter);
+        goto FINISH;
+    }
+
     while (true) {
         ret = ioctl(adapter->fd, HDF_READ_DEV_EVENT, &bwr);
         if (ret == 0) {
@@ -215,20 +555,18 @@ static int32_t AssignPfds(struct HdfDevListenerThread *thread, struct pollfd **p
 }
 
 #define POLL_WAIT_TIME_MS 100
-static int32_t HdfDevEventListenTask(void *para)
+static void HdfDevEventPollLoop(struct HdfDevListenerThread *thread)
 {
-    struct HdfDevListenerThread *thread = (struct HdfDevListenerThread *)para;
     struct pollfd *pfds = NULL;
     uint16_t pfdSize = 0;
     int32_t pollCount = 0;
 
-    thread->status = LISTENER_RUNNING;
     while (!thread->shouldStop) {
         if (thread->pollChanged) {
             pollCount = AssignPfds(thread, &pfds, &pfdSize);
         }
         if (pollCount <= 0) {
-            goto EXIT;
+            break;
         }
         int32_t pollSize = poll(pfds, pollCount, -1);
         if (pollSize <= 0) {
@@ -253,13 +591,167 @@ static int32_t HdfDevEventListenTask(void *para)
     }
 
 EXIT:
+    OsalMemFree(pfds);
+}
+
+#ifdef __linux__
+/*
+ * With epoll, services are added to and removed from the interest list with a single epoll_ctl,
+ * the listener thread is only woken up by the eventfd when it has to exit.
+ */
+static void HdfDevListenerThreadEpollInit(struct HdfDevListenerThread *thread)
+{
+    struct epoll_event event = {0};
+
+    thread->epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (thread->epollFd < 0) {
+        HDF_LOGE("%s: epoll unavailable (%d), use poll", __func__, errno);
+        thread->epollFd = SYSCALL_INVALID_FD;
+        return;
+    }
+    thread->wakeupFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    event.events = EPOLLIN;
+    event.data.fd = thread->wakeupFd;
+    if (thread->wakeupFd < 0 || epoll_ctl(thread->epollFd, EPOLL_CTL_ADD, thread->wakeupFd, &event) != 0) {
+        HDF_LOGE("%s: eventfd unavailable (%d), use poll", __func__, errno);
+        if (thread->wakeupFd >= 0) {
+            close(thread->wakeupFd);
+        }
+        close(thread->epollFd);
+        thread->wakeupFd = SYSCALL_INVALID_FD;
+        thread->epollFd = SYSCALL_INVALID_FD;
+    }
+}
+
+static int32_t HdfListenThreadEpollAdd(struct HdfDevListenerThread *thread, int fd)
+{
+    struct epoll_event event = {0};
+
+    event.events = EPOLLIN;
+    event.data.fd = fd;
+    if (epoll_ctl(thread->epollFd, EPOLL_CTL_ADD, fd, &event) != 0 && errno != EEXIST) {
+        HDF_LOGE("%s: failed to add fd %d to epoll %d", __func__, fd, errno);
+        return HDF_ERR_IO;
+    }
+    return HDF_SUCCESS;
+}
+
+static void HdfListenThreadEpollDel(struct HdfDevListenerThread *thread, int fd)
+{
+    if (epoll_ctl(thread->epollFd, EPOLL_CTL_DEL, fd, NULL) != 0 && errno != ENOENT) {
+        HDF_LOGE("%s: failed to del fd %d from epoll %d", __func__, fd, errno);
+    }
+}
+
+static int32_t HdfListenThreadEpollWakeup(struct HdfDevListenerThread *thread)
+{
+    uint64_t value = 1;
+    if (write(thread->wakeupFd, &value, sizeof(value)) != sizeof(value)) {
+        HDF_LOGE("%s: failed to wakeup listener thread %d", __func__, errno);
+        return HDF_ERR_IO;
+    }
+    return HDF_SUCCESS;
+}
+
+static void HdfDevEventEpollLoop(struct HdfDevListenerThread *thread)
+{
+    struct epoll_event events[EPOLL_MAX_EVENT_SIZE];
+    uint64_t value;
+
+    while (!thread->shouldStop) {
+        /* at most EPOLL_MAX_EVENT_SIZE ready services are served per wakeup, the rest stay ready */
+        int32_t eventCount = epoll_wait(thread->epollFd, events, EPOLL_MAX_EVENT_SIZE, -1);
+        if (eventCount < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            HDF_LOGE("%s: epoll fail (%d)%s", __func__, errno, strerror(errno));
+            OsalMSleep(POLL_WAIT_TIME_MS);
+            continue;
+        }
+        for (int32_t i = 0; i < eventCount; i++) {
+            if (events[i].data.fd == thread->wakeupFd) {
+                (void)read(thread->wakeupFd, &value, sizeof(value));
+                HDF_LOGI("event listener task received wakeup to exit");
+                return;
+            }
+            if ((events[i].events & EPOLLIN) &&
+                HdfDevEventReadAndDispatch(thread, events[i].data.fd) != HDF_SUCCESS) {
+                return;
+            } else if (events[i].events & EPOLLHUP) {
+                HDF_LOGI("event listener task received exit event");
+                return;
+            }
+        }
+    }
+}
+#else
+static void HdfDevListenerThreadEpollInit(struct HdfDevListenerThread *thread)
+{
+    thread->epollFd = SYSCALL_INVALID_FD;
+    thread->wakeupFd = SYSCALL_INVALID_FD;
+}
+
+static int32_t HdfListenThreadEpollAdd(struct HdfDevListenerThread *thread, int fd)
+{
+    (void)thread;
+    (void)fd;
+    return HDF_ERR_NOT_SUPPORT;
+}
+
+static void HdfListenThreadEpollDel(struct HdfDevListenerThread *thread, int fd)
+{
+    (void)thread;
+    (void)fd;
+}
+
+static int32_t HdfListenThreadEpollWakeup(struct HdfDevListenerThread *thread)
+{
+    (void)thread;
+    return HDF_ERR_NOT_SUPPORT;
+}
+
+static void HdfDevEventEpollLoop(struct HdfDevListenerThread *thread)
+{
+    (void)thread;
+}
+#endif
+
+static bool HdfListenThreadUseEpoll(const struct HdfDevListenerThread *thread)
+{
+    return thread->epollFd != SYSCALL_INVALID_FD;
+}
+
+static void HdfDevListenerThreadEpollRelease(struct HdfDevListenerThread *thread)
+{
+    if (thread->wakeupFd != SYSCALL_INVALID_FD) {
+        close(thread->wakeupFd);
+        thread->wakeupFd = SYSCALL_INVALID_FD;
+    }
+    if (thread->epollFd != SYSCALL_INVALID_FD) {
+        close(thread->epollFd);
+        thread->epollFd = SYSCALL_INVALID_FD;
+    }
+}
+
+static int32_t HdfDevEventListenTask(void *para)
+{
+    struct HdfDevListenerThread *thread = (struct HdfDevListenerThread *)para;
+
+    thread->status = LISTENER_RUNNING;
+    if (HdfListenThreadUseEpoll(thread)) {
+        HdfDevEventEpollLoop(thread);
+    } else {
+        HdfDevEventPollLoop(thread);
+    }
+
     HDF_LOGI("event listener task exit");
 
     thread->status = LISTENER_EXITED;
-    OsalMemFree(pfds);
 
     if (thread->shouldStop) {
         /* Exit due to async call and free the thread struct. */
+        HdfDevListenerThreadEpollRelease(thread);
         OsalMutexDestroy(&thread->mutex);
         OsalThreadDestroy(&thread->thread);
         OsalMemFree(thread->pfds);
@@ -316,6 +808,7 @@ static int32_t HdfDevListenerThreadDoInit(struct HdfDevListenerThread *thread)
         OsalMutexDestroy(&thread->mutex);
         return HDF_ERR_THREAD_CREATE_FAIL;
     }
+    HdfDevListenerThreadEpollInit(thread);
 
     thread->status = LISTENER_INITED;
     thread->shouldStop = false;
@@ -435,6 +928,9 @@ static int32_t HdfDevListenerThreadStart(struct HdfDevListenerThread *thread)
             if (thread->pfds[i].fd == SYSCALL_INVALID_FD) {
                 continue;
             }
+            if (HdfListenThreadUseEpoll(thread) && HdfListenThreadEpollAdd(thread, thread->pfds[i].fd) != HDF_SUCCESS) {
+                return HDF_ERR_IO;
+            }
             if (HdfAdapterStartListenIoctl(thread->pfds[i].fd)) {
                 return HDF_ERR_IO;
             }
@@ -465,6 +961,8 @@ static struct HdfDevListenerThread *HdfDevListenerThreadObtain(void)
         return NULL;
     }
     thread->status = LISTENER_UNINITED;
+    thread->epollFd = SYSCALL_INVALID_FD;
+    thread->wakeupFd = SYSCALL_INVALID_FD;
     if (HdfDevListenerThreadInit(thread) != HDF_SUCCESS) {
         OsalMemFree(thread);
         return NULL;
@@ -483,6 +981,7 @@ static int32_t HdfIoServiceGroupThreadInit(struct HdfSyscallAdapterGroup *group)
     }
     group->thread->adapterListPtr = &group->adapterList;
     group->thread->listenerListPtr = &group->listenerList;
+    group->thread->dispatchPool = group->dispatchPool;
     return HdfDevListenerThreadInit(group->thread);
 }
 
@@ -529,7 +1028,13 @@ static int32_t HdfListenThreadPollAdd(struct HdfDevListenerThread *thread, struc
         thread->pfds[index].events = POLLIN;
         thread->pfds[index].revents = 0;
 
-        if (headAdapter != NULL) {
+        if (HdfListenThreadUseEpoll(thread)) {
+            if (HdfListenThreadEpollAdd(thread, adapter->fd) != HDF_SUCCESS) {
+                thread->pfds[index].fd = SYSCALL_INVALID_FD;
+                ret = HDF_ERR_IO;
+                break;
+            }
+        } else if (headAdapter != NULL) {
             if (ioctl(headAdapter->fd, HDF_LISTEN_EVENT_WAKEUP, 0) != 0) {
                 HDF_LOGE("%s: failed to wakeup drv to add poll %d %{public}s", __func__, errno, strerror(errno));
                 thread->pfds[index].fd = SYSCALL_INVALID_FD;
@@ -539,6 +1044,9 @@ static int32_t HdfListenThreadPollAdd(struct HdfDevListenerThread *thread, struc
         }
 
         if (HdfAdapterStartListenIoctl(adapter->fd) != HDF_SUCCESS) {
+            if (HdfListenThreadUseEpoll(thread)) {
+                HdfListenThreadEpollDel(thread, adapter->fd);
+            }
             thread->pfds[index].fd = SYSCALL_INVALID_FD;
             ret = HDF_DEV_ERR_OP;
             break;
@@ -570,7 +1078,9 @@ static void HdfListenThreadPollDel(struct HdfDevListenerThread *thread, struct H
     }
 
     HdfAdapterStopListenIoctl(adapter->fd);
-    if (ioctl(adapter->fd, HDF_LISTEN_EVENT_WAKEUP, 0) != 0) {
+    if (HdfListenThreadUseEpoll(thread)) {
+        HdfListenThreadEpollDel(thread, adapter->fd);
+    } else if (ioctl(adapter->fd, HDF_LISTEN_EVENT_WAKEUP, 0) != 0) {
         HDF_LOGE("%s: failed to wakeup drv to del poll %d %s", __func__, errno, strerror(errno));
     }
     DListRemove(&adapter->listNode);
@@ -581,6 +1091,7 @@ static void HdfListenThreadPollDel(struct HdfDevListenerThread *thread, struct H
 
 static void HdfDevListenerThreadFree(struct HdfDevListenerThread *thread)
 {
+    HdfDevListenerThreadEpollRelease(thread);
     OsalMutexDestroy(&thread->mutex);
     OsalMemFree(thread->pfds);
     OsalThreadDestroy(&thread->thread);
@@ -609,6 +1120,9 @@ static void HdfDevListenerThreadDestroy(struct HdfDevListenerThread *thread)
                 }
                 thread->pfds[i].fd = SYSCALL_INVALID_FD;
             }
+            if (HdfListenThreadUseEpoll(thread) && HdfListenThreadEpollWakeup(thread) == HDF_SUCCESS) {
+                stopCount++;
+            }
 
             if (stopCount == 0) {
                 thread->shouldStop = true;
@@ -630,6 +1144,9 @@ static void HdfDevListenerThreadDestroy(struct HdfDevListenerThread *thread)
         }
         case LISTENER_STARTED:
             thread->shouldStop = true;
+            if (HdfListenThreadUseEpoll(thread)) {
+                (void)HdfListenThreadEpollWakeup(thread);
+            }
             break;
         case LISTENER_EXITED: // fall-through
         case LISTENER_INITED:
@@ -640,6 +1157,29 @@ static void HdfDevListenerThreadDestroy(struct HdfDevListenerThread *thread)
     }
 }
 
+static void HdfSyscallAdapterFillBwr(
+    struct HdfWriteReadBuf *wrBuf, int32_t code, struct HdfSBuf *data, struct HdfSBuf *reply)
+{
+    if (reply != NULL) {
+        wrBuf->readBuffer = (uintptr_t)HdfSbufGetData(reply);
+        wrBuf->readSize = HdfSbufGetCapacity(reply);
+    } else {
+        wrBuf->readBuffer = 0;
+        wrBuf->readSize = 0;
+    }
+    if (data != NULL) {
+        wrBuf->writeBuffer = (uintptr_t)HdfSbufGetData(data);
+        wrBuf->writeSize = HdfSbufGetDataSize(data);
+    } else {
+        wrBuf->writeBuffer = 0;
+        wrBuf->writeSize = 0;
+    }
+
+    wrBuf->readConsumed = 0;
+    wrBuf->writeConsumed = 0;
+    wrBuf->cmdCode = code;
+}
+
 static int32_t HdfSyscallAdapterDispatch(
     struct HdfObject *object, int32_t code, struct HdfSBuf *data, struct HdfSBuf *reply)
 {
@@ -649,24 +1189,7 @@ static int32_t HdfSyscallAdapterDispatch(
     }
     struct HdfSyscallAdapter *ioService = (struct HdfSyscallAdapter *)object;
     struct HdfWriteReadBuf wrBuf;
-    if (reply != NULL) {
-        wrBuf.readBuffer = (uintptr_t)HdfSbufGetData(reply);
-        wrBuf.readSize = HdfSbufGetCapacity(reply);
-    } else {
-        wrBuf.readBuffer = 0;
-        wrBuf.readSize = 0;
-    }
-    if (data != NULL) {
-        wrBuf.writeBuffer = (uintptr_t)HdfSbufGetData(data);
-        wrBuf.writeSize = HdfSbufGetDataSize(data);
-    } else {
-        wrBuf.writeBuffer = 0;
-        wrBuf.writeSize = 0;
-    }
-
-    wrBuf.readConsumed = 0;
-    wrBuf.writeConsumed = 0;
-    wrBuf.cmdCode = code;
+    HdfSyscallAdapterFillBwr(&wrBuf, code, data, reply);
     int32_t ret = ioctl(ioService->fd, HDF_WRITE_READ, &wrBuf);
     if (ret < 0) {
         HDF_LOGE("Failed to dispatch serv call ioctl %{public}d", -errno);
@@ -678,25 +1201,153 @@ static int32_t HdfSyscallAdapterDispatch(
     return ret;
 }
 
-static int TrytoLoadIoService(const char *serviceName, char *devNodePath, char *realPath)
+/* set once the kernel rejects HDF_WRITE_READ_BATCH, shared by all services of the process */
+static OsalAtomic g_batchUnsupported = { 0 };
+
+/* errno of the batch ioctl itself, a kernel without the command rejects it before any call is dispatched */
+static bool HdfSyscallBatchUnsupported(int err)
 {
-    if (HdfLoadDriverByServiceName(serviceName) != HDF_SUCCESS) {
-        HDF_LOGE("%s: load %{public}s driver failed", __func__, serviceName);
-        return HDF_DEV_ERR_NO_DEVICE;
+    return err == ENOTTY || err == EINVAL;
+}
+
+void HdfIoServiceAdapterSetBatchSupported(bool supported)
+{
+    OsalAtomicSet(&g_batchUnsupported, supported ? 0 : 1);
+}
+
+static int32_t HdfSyscallAdapterDispatchChunk(
+    struct HdfSyscallAdapter *adapter, struct HdfIoServiceCall *calls, uint32_t count)
+{
+    struct HdfWriteReadBuf wrBufs[HDF_WRITE_READ_BATCH_MAX];
+    int32_t results[HDF_WRITE_READ_BATCH_MAX];
+    struct HdfWriteReadBatch batch = {
+        .count = count,
+        .reserved = 0,
+        .bwrs = (uintptr_t)wrBufs,
+        .results = (uintptr_t)results,
+    };
+
+    for (uint32_t i = 0; i < count; i++) {
+        HdfSyscallAdapterFillBwr(&wrBufs[i], calls[i].cmdId, calls[i].data, calls[i].reply);
+    }
+
+    if (ioctl(adapter->fd, HDF_WRITE_READ_BATCH, &batch) < 0) {
+        return -errno;
     }
 
-    int waitCount = LOAD_IOSERVICE_WAIT_COUNT;
-    while (realpath(devNodePath, realPath) == NULL && waitCount-- > 0) {
-        OsalMSleep(LOAD_IOSERVICE_WAIT_TIME); // wait ueventd to crater dev
+    for (uint32_t i = 0; i < count; i++) {
+        calls[i].status = results[i];
+        if (calls[i].reply != NULL) {
+            HdfSbufSetDataSize(calls[i].reply, wrBufs[i].readConsumed);
+        }
     }
-    if (waitCount <= 0) {
-        HDF_LOGE("%s: char dev %{public}s is invalid", __func__, devNodePath);
-        return HDF_DEV_ERR_NO_DEVICE_SERVICE;
+    return HDF_SUCCESS;
+}
+
+int32_t HdfIoServiceAdapterDispatchBatch(struct HdfIoService *service, struct HdfIoServiceCall *calls, uint32_t count)
+{
+    struct HdfSyscallAdapter *adapter = (struct HdfSyscallAdapter *)service;
+    uint32_t done = 0;
+
+    if (adapter == NULL || calls == NULL) {
+        return HDF_ERR_INVALID_PARAM;
     }
 
+    while (done < count && OsalAtomicRead(&g_batchUnsupported) == 0) {
+        uint32_t chunk = (count - done > HDF_WRITE_READ_BATCH_MAX) ? HDF_WRITE_READ_BATCH_MAX : (count - done);
+        int32_t ret = HdfSyscallAdapterDispatchChunk(adapter, calls + done, chunk);
+        if (ret != HDF_SUCCESS) {
+            if (!HdfSyscallBatchUnsupported(-ret)) {
+                HDF_LOGE("Failed to dispatch serv call batch ioctl %{public}d", ret);
+                return ret;
+            }
+            HDF_LOGI("%s: batch ioctl not supported, dispatch one by one", __func__);
+            OsalAtomicSet(&g_batchUnsupported, 1);
+            break;
+        }
+        done += chunk;
+    }
+
+    for (; done < count; done++) {
+        calls[done].status = HdfSyscallAdapterDispatch(&service->object, calls[done].cmdId, calls[done].data,
+            calls[done].reply);
+    }
+    return HDF_SUCCESS;
+}
+
+int32_t HdfIoServiceAdapterSetEventRing(struct HdfIoService *service, uint32_t size)
+{
+    struct HdfSyscallAdapter *adapter = (struct HdfSyscallAdapter *)service;
+    uint8_t *buffer = NULL;
+
+    OsalMutexLock(&adapter->mutex);
+    if (adapter->eventRingBuffer != NULL) {
+        OsalMutexUnlock(&adapter->mutex);
+        return HDF_SUCCESS;
+    }
+    if (adapter->thread != NULL || adapter->group != NULL) {
+        OsalMutexUnlock(&adapter->mutex);
+        HDF_LOGE("%s: event ring must be set before listening", __func__);
+        return HDF_ERR_DEVICE_BUSY;
+    }
+    if (ioctl(adapter->fd, HDF_LISTEN_EVENT_RING, &size) != 0) {
+        OsalMutexUnlock(&adapter->mutex);
+        HDF_LOGE("%s: failed to enable event ring %d", __func__, errno);
+        return HDF_ERR_NOT_SUPPORT;
+    }
+    /* the drain buffer matches the ring, so one drain takes all pending events */
+    buffer = OsalMemAlloc(size);
+    if (buffer == NULL) {
+        OsalMutexUnlock(&adapter->mutex);
+        HDF_LOGE("%s: oom", __func__);
+        return HDF_ERR_MALLOC_FAIL;
+    }
+    adapter->eventRingBuffer = buffer;
+    adapter->eventRingSize = size;
+    OsalMutexUnlock(&adapter->mutex);
+    return HDF_SUCCESS;
+}
+
+static int WaitIoServiceNode(const char *devNodePath, char *realPath, uint64_t deadline)
+{
+    // the service may be published before ueventd creates its node, re-check until the deadline
+    while (realpath(devNodePath, realPath) == NULL) {
+        if (OsalGetSysTimeMs() >= deadline) {
+            HDF_LOGE("%s: char dev %{public}s is invalid", __func__, devNodePath);
+            return HDF_DEV_ERR_NO_DEVICE_SERVICE;
+        }
+        OsalMSleep(LOAD_IOSERVICE_WAIT_TIME);
+    }
     return HDF_SUCCESS;
 }
 
+static int TrytoLoadIoService(const char *serviceName, char *devNodePath, char *realPath)
+{
+    uint64_t deadline = OsalGetSysTimeMs() + LOAD_IOSERVICE_WAIT_TIME * LOAD_IOSERVICE_WAIT_COUNT;
+    struct HdfServiceWaiter *waiter = NULL;
+    int ret;
+
+    // binding the service manager itself must not wait on the service manager
+    if (strcmp(serviceName, DEV_SVCMGR_NODE) != 0) {
+        waiter = HdfServiceWaiterObtain(serviceName);
+    }
+    if (HdfLoadDriverByServiceName(serviceName) != HDF_SUCCESS) {
+        HDF_LOGE("%s: load %{public}s driver failed", __func__, serviceName);
+        HdfServiceWaiterRecycle(waiter);
+        return HDF_DEV_ERR_NO_DEVICE;
+    }
+    if (waiter != NULL) {
+        uint64_t now = OsalGetSysTimeMs();
+        ret = HdfServiceWaiterWait(waiter, (now < deadline) ? (uint32_t)(deadline - now) : 0);
+        HdfServiceWaiterRecycle(waiter);
+        if (ret != HDF_SUCCESS) {
+            HDF_LOGE("%s: service %{public}s is not published", __func__, serviceName);
+            return HDF_DEV_ERR_NO_DEVICE_SERVICE;
+        }
+    }
+    return WaitIoServiceNode(devNodePath, realPath, deadline);
+}
+
 struct HdfIoService *HdfIoServiceAdapterObtain(const char *serviceName)
 {
     struct HdfSyscallAdapter *adapter = NULL;
@@ -768,6 +1419,7 @@ void HdfIoServiceAdapterRecycle(struct HdfIoService *service)
             adapter->fd = -1;
         }
         OsalMutexDestroy(&adapter->mutex);
+        OsalMemFree(adapter->eventRingBuffer);
         OsalMemFree(adapter);
     }
 }
@@ -894,8 +1546,15 @@ void HdfIoServiceGroupRecycle(struct HdfIoServiceGroup *group)
     struct HdfSyscallAdapterGroup *adapterGroup = CONTAINER_OF(group, struct HdfSyscallAdapterGroup, serviceGroup);
     OsalMutexLock(&adapterGroup->mutex);
 
+    if (adapterGroup->thread != NULL) {
+        OsalMutexLock(&adapterGroup->thread->mutex);
+        adapterGroup->thread->dispatchPool = NULL;
+        OsalMutexUnlock(&adapterGroup->thread->mutex);
+    }
     HdfDevListenerThreadDestroy(adapterGroup->thread);
     adapterGroup->thread = NULL;
+    HdfDevEventDispatchPoolDestroy(adapterGroup->dispatchPool);
+    adapterGroup->dispatchPool = NULL;
 
     struct HdfSyscallAdapter *adapter = NULL;
     struct HdfSyscallAdapter *tmp = NULL;
@@ -941,7 +1600,9 @@ int32_t HdfIoServiceGroupRegisterListener(struct HdfIoServiceGroup *group, struc
             goto FINISH;
         }
     }
+    HdfDevEventDispatchPoolLockAll(adapterGroup->dispatchPool);
     DListInsertTail(&listener->listNode, &adapterGroup->listenerList);
+    HdfDevEventDispatchPoolUnlockAll(adapterGroup->dispatchPool);
     if (!DListIsEmpty(&adapterGroup->adapterList) && listenerThread->status < LISTENER_STARTED) {
         ret = HdfDevListenerThreadStart(listenerThread);
         if (ret != HDF_SUCCESS) {
@@ -996,7 +1657,9 @@ int32_t HdfIoServiceGroupUnregisterListener(struct HdfIoServiceGroup *group, str
     OsalMutexLock(&adapterGroup->mutex);
     struct HdfDevListenerThread *listenerThread = adapterGroup->thread;
 
+    HdfDevEventDispatchPoolLockAll(adapterGroup->dispatchPool);
     DListRemove(&listener->listNode);
+    HdfDevEventDispatchPoolUnlockAll(adapterGroup->dispatchPool);
 
     if (listenerThread != NULL && GetListenerCount(listenerThread) == 0) {
         HdfDevListenerThreadDestroy(listenerThread);
@@ -1074,10 +1737,70 @@ void HdfIoServiceGroupRemoveService(struct HdfIoServiceGroup *group, struct HdfI
     } else {
         HdfListenThreadPollDel(adapterGroup->thread, adapter);
     }
+    HdfDevEventDispatchPoolPurge(adapterGroup->dispatchPool, adapter);
     OsalMutexUnlock(&adapterGroup->mutex);
     adapter->group = NULL;
 }
 
+int32_t HdfIoServiceGroupSetDispatchPool(struct HdfIoServiceGroup *group, uint32_t workerCount, uint32_t queueDepth)
+{
+    if (group == NULL || workerCount == 0 || workerCount > HDF_IO_SERVICE_GROUP_WORKER_MAX ||
+        queueDepth == 0 || queueDepth > HDF_IO_SERVICE_GROUP_QUEUE_DEPTH_MAX) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+    struct HdfSyscallAdapterGroup *adapterGroup = CONTAINER_OF(group, struct HdfSyscallAdapterGroup, serviceGroup);
+
+    OsalMutexLock(&adapterGroup->mutex);
+    if (adapterGroup->dispatchPool != NULL) {
+        OsalMutexUnlock(&adapterGroup->mutex);
+        return HDF_ERR_DEVICE_BUSY;
+    }
+    adapterGroup->dispatchPool = HdfDevEventDispatchPoolCreate(&adapterGroup->listenerList, workerCount, queueDepth);
+    if (adapterGroup->dispatchPool == NULL) {
+        OsalMutexUnlock(&adapterGroup->mutex);
+        return HDF_FAILURE;
+    }
+    if (adapterGroup->thread != NULL) {
+        OsalMutexLock(&adapterGroup->thread->mutex);
+        adapterGroup->thread->dispatchPool = adapterGroup->dispatchPool;
+        OsalMutexUnlock(&adapterGroup->thread->mutex);
+    }
+    OsalMutexUnlock(&adapterGroup->mutex);
+    return HDF_SUCCESS;
+}
+
+int32_t HdfIoServiceGroupGetDispatchStat(const struct HdfIoServiceGroup *group,
+    struct HdfIoServiceGroupDispatchStat *stat)
+{
+    if (group == NULL || stat == NULL) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+    struct HdfSyscallAdapterGroup *adapterGroup = CONTAINER_OF(group, struct HdfSyscallAdapterGroup, serviceGroup);
+
+    (void)memset_s(stat, sizeof(*stat), 0, sizeof(*stat));
+    OsalMutexLock(&adapterGroup->mutex);
+    struct HdfDevEventDispatchPool *pool = adapterGroup->dispatchPool;
+    if (pool == NULL) {
+        OsalMutexUnlock(&adapterGroup->mutex);
+        return HDF_ERR_NOT_SUPPORT;
+    }
+    stat->workerCount = pool->workerCount;
+    stat->queueDepth = pool->queueDepth;
+    for (uint32_t i = 0; i < pool->workerCount; i++) {
+        struct HdfDevEventWorker *worker = &pool->workers[i];
+        OsalMutexLock(&worker->queueMutex);
+        stat->queued += worker->count;
+        if (worker->maxCount > stat->maxQueued) {
+            stat->maxQueued = worker->maxCount;
+        }
+        stat->dispatched += worker->dispatched;
+        stat->blocked += worker->blocked;
+        OsalMutexUnlock(&worker->queueMutex);
+    }
+    OsalMutexUnlock(&adapterGroup->mutex);
+    return HDF_SUCCESS;
+}
+
 int HdfIoserviceGetListenerCount(const struct HdfIoService *service)
 {
     if (service == NULL) {
@@ -21,6 +21,7 @@
 #define VOID_DATA_SIZE 4
 #define EVENT_QUEUE_MAX 100
 #define MAX_RW_SIZE (1024 * 1204) // 1M
+#define EVENT_RING_PAD_SIZE 0xFFFFFFFF
 
 enum HdfVNodeClientStatus {
     VNODE_CLIENT_RUNNING,
@@ -29,6 +30,17 @@ enum HdfVNodeClientStatus {
     VNODE_CLIENT_EXITED,
 };
 
+/*
+ * Single producer single consumer event ring. Senders append records under the client mutex, the drain ioctl
+ * copies [tail, head) to user space without holding the mutex, since senders never write into that range.
+ */
+struct HdfVNodeEventRing {
+    uint8_t *buffer;
+    uint32_t capacity;
+    uint32_t head;
+    uint32_t tail;
+};
+
 struct HdfVNodeAdapterClient {
     struct HdfVNodeAdapter *adapter;
     struct HdfDeviceIoClient ioServiceClient;
@@ -40,6 +52,8 @@ struct HdfVNodeAdapterClient {
     int32_t eventQueueSize;
     int32_t wakeup;
     uint32_t status;
+    struct HdfVNodeEventRing *eventRing;
+    uint32_t droppedEvents;
 };
 
 struct HdfIoServiceKClient {
@@ -131,33 +145,34 @@ void HdfIoServiceAdapterRecycle(struct HdfIoService *ioService)
     OsalMemFree(kClient);
 }
 
-static struct HdfSBuf *HdfSbufCopyFromUser(uintptr_t data, size_t size)
+static int HdfSbufCopyFromUser(uintptr_t data, size_t size, struct HdfSBuf **sbuf)
 {
     uint8_t *kData = NULL;
-    struct HdfSBuf *sbuf = NULL;
 
     if (size == 0) {
-        return HdfSbufObtain(VOID_DATA_SIZE);
+        *sbuf = HdfSbufObtain(VOID_DATA_SIZE);
+        return (*sbuf != NULL) ? HDF_SUCCESS : HDF_ERR_MALLOC_FAIL;
     }
 
     kData = OsalMemAlloc(size);
     if (kData == NULL) {
         HDF_LOGE("%s:oom", __func__);
-        return NULL;
+        return HDF_ERR_MALLOC_FAIL;
     }
     if (CopyFromUser((void*)kData, (void*)data, size) != 0) {
         HDF_LOGE("%s:failed to copy from user", __func__);
         OsalMemFree(kData);
-        return NULL;
+        return HDF_ERR_IO;
     }
 
-    sbuf = HdfSbufBind((uintptr_t)kData, size);
-    if (sbuf == NULL) {
+    *sbuf = HdfSbufBind((uintptr_t)kData, size);
+    if (*sbuf == NULL) {
         OsalMemFree(kData);
+        return HDF_ERR_MALLOC_FAIL;
     }
-    HdfSbufTransDataOwnership(sbuf);
+    HdfSbufTransDataOwnership(*sbuf);
 
-    return sbuf;
+    return HDF_SUCCESS;
 }
 
 static int HdfSbufCopyToUser(const struct HdfSBuf *sbuf, void *dstUser, size_t dstUserSize)
@@ -191,58 +206,136 @@ static void DevEventFree(struct HdfDevEvent *event)
     OsalMemFree(event);
 }
 
-static int HdfVNodeAdapterServCall(const struct HdfVNodeAdapterClient *client, unsigned long arg)
+static bool HdfVNodeAdapterServAvailable(const struct HdfVNodeAdapterClient *client)
+{
+    return client->serv != NULL && client->adapter != NULL && client->adapter->ioService.dispatcher != NULL &&
+        client->adapter->ioService.dispatcher->Dispatch != NULL;
+}
+
+static int HdfVNodeAdapterDoServCall(const struct HdfVNodeAdapterClient *client, struct HdfWriteReadBuf *bwr,
+    int32_t *dispatchRet)
 {
-    struct HdfWriteReadBuf bwr;
-    struct HdfWriteReadBuf *bwrUser = (struct HdfWriteReadBuf *)((uintptr_t)arg);
     struct HdfSBuf *data = NULL;
     struct HdfSBuf *reply = NULL;
     int ret;
 
-    if (client->serv == NULL || client->adapter == NULL ||
-        client->adapter->ioService.dispatcher == NULL ||
-        client->adapter->ioService.dispatcher->Dispatch == NULL) {
-        return HDF_ERR_INVALID_OBJECT;
-    }
-
-    if (bwrUser == NULL) {
-        return HDF_ERR_INVALID_PARAM;
-    }
-    if (CopyFromUser(&bwr, (void*)bwrUser, sizeof(bwr)) != 0) {
-        HDF_LOGE("copy from user failed");
-        return HDF_FAILURE;
-    }
-    if (bwr.writeSize > MAX_RW_SIZE || bwr.readSize > MAX_RW_SIZE) {
+    if (bwr->writeSize > MAX_RW_SIZE || bwr->readSize > MAX_RW_SIZE) {
         return HDF_ERR_INVALID_PARAM;
     }
 
-    data = HdfSbufCopyFromUser(bwr.writeBuffer, bwr.writeSize);
-    if (data == NULL) {
+    ret = HdfSbufCopyFromUser(bwr->writeBuffer, bwr->writeSize, &data);
+    if (ret != HDF_SUCCESS) {
         HDF_LOGE("vnode adapter bind data is null");
-        return HDF_FAILURE;
+        return ret;
     }
     reply = HdfSbufObtainDefaultSize();
     if (reply == NULL) {
         HDF_LOGE("%s: oom", __func__);
         HdfSbufRecycle(data);
-        return HDF_FAILURE;
+        return HDF_ERR_MALLOC_FAIL;
     }
     (void)HdfSbufWriteUint64(reply, (uintptr_t)&client->ioServiceClient);
-    ret = client->adapter->ioService.dispatcher->Dispatch(client->adapter->ioService.target,
-        bwr.cmdCode, data, reply);
-    if (bwr.readSize != 0 && HdfSbufCopyToUser(reply, (void*)(uintptr_t)bwr.readBuffer, bwr.readSize) != HDF_SUCCESS) {
+    *dispatchRet = client->adapter->ioService.dispatcher->Dispatch(client->adapter->ioService.target,
+        bwr->cmdCode, data, reply);
+    if (bwr->readSize != 0 &&
+        HdfSbufCopyToUser(reply, (void*)(uintptr_t)bwr->readBuffer, bwr->readSize) != HDF_SUCCESS) {
         HdfSbufRecycle(data);
         HdfSbufRecycle(reply);
         return HDF_ERR_IO;
     }
-    bwr.readConsumed = HdfSbufGetDataSize(reply);
+    bwr->readConsumed = HdfSbufGetDataSize(reply);
+
+    HdfSbufRecycle(data);
+    HdfSbufRecycle(reply);
+    return HDF_SUCCESS;
+}
+
+static int HdfVNodeAdapterServCall(const struct HdfVNodeAdapterClient *client, unsigned long arg)
+{
+    struct HdfWriteReadBuf bwr;
+    struct HdfWriteReadBuf *bwrUser = (struct HdfWriteReadBuf *)((uintptr_t)arg);
+    int32_t ret = HDF_FAILURE;
+    int callRet;
+
+    if (!HdfVNodeAdapterServAvailable(client)) {
+        return HDF_ERR_INVALID_OBJECT;
+    }
+
+    if (bwrUser == NULL) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+    if (CopyFromUser(&bwr, (void*)bwrUser, sizeof(bwr)) != 0) {
+        HDF_LOGE("copy from user failed");
+        return HDF_FAILURE;
+    }
+
+    callRet = HdfVNodeAdapterDoServCall(client, &bwr, &ret);
+    if (callRet != HDF_SUCCESS) {
+        return (callRet == HDF_ERR_MALLOC_FAIL) ? HDF_FAILURE : callRet;
+    }
     if (CopyToUser(bwrUser, &bwr, sizeof(struct HdfWriteReadBuf)) != 0) {
         HDF_LOGE("%s: fail to copy bwr", __func__);
         ret = HDF_FAILURE;
     }
 
-    HdfSbufRecycle(data);
-    HdfSbufRecycle(reply);
+    return ret;
+}
+
+/*
+ * Dispatches the entries of a batch in order and reports the result of each entry.
+ * The ioctl itself only fails when the batch can not be processed at all, never with HDF_FAILURE,
+ * so that user space can tell a kernel without batch support apart.
+ */
+static int HdfVNodeAdapterServCallBatch(const struct HdfVNodeAdapterClient *client, unsigned long arg)
+{
+    struct HdfWriteReadBatch batch;
+    struct HdfWriteReadBuf *bwrs = NULL;
+    int32_t *results = NULL;
+    size_t bwrsSize;
+    uint32_t i;
+    int callRet;
+    int ret = HDF_SUCCESS;
+
+    if (!HdfVNodeAdapterServAvailable(client)) {
+        return HDF_ERR_INVALID_OBJECT;
+    }
+    if (arg == 0 || CopyFromUser(&batch, (void *)(uintptr_t)arg, sizeof(batch)) != 0) {
+        HDF_LOGE("%s: copy batch from user failed", __func__);
+        return HDF_ERR_INVALID_PARAM;
+    }
+    if (batch.count == 0 || batch.count > HDF_WRITE_READ_BATCH_MAX || batch.bwrs == 0 || batch.results == 0) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+
+    bwrsSize = sizeof(struct HdfWriteReadBuf) * batch.count;
+    bwrs = OsalMemAlloc(bwrsSize + sizeof(int32_t) * batch.count);
+    if (bwrs == NULL) {
+        HDF_LOGE("%s: oom", __func__);
+        return HDF_ERR_MALLOC_FAIL;
+    }
+    results = (int32_t *)((uint8_t *)bwrs + bwrsSize);
+    if (CopyFromUser(bwrs, (void *)(uintptr_t)batch.bwrs, bwrsSize) != 0) {
+        HDF_LOGE("%s: copy bwrs from user failed", __func__);
+        OsalMemFree(bwrs);
+        return HDF_ERR_INVALID_PARAM;
+    }
+
+    for (i = 0; i < batch.count; i++) {
+        results[i] = HDF_FAILURE;
+        bwrs[i].readConsumed = 0;
+        callRet = HdfVNodeAdapterDoServCall(client, &bwrs[i], &results[i]);
+        if (callRet != HDF_SUCCESS) {
+            results[i] = callRet;
+        }
+    }
+
+    if (CopyToUser((void *)(uintptr_t)batch.bwrs, bwrs, bwrsSize) != 0 ||
+        CopyToUser((void *)(uintptr_t)batch.results, results, sizeof(int32_t) * batch.count) != 0) {
+        HDF_LOGE("%s: fail to copy batch result", __func__);
+        ret = HDF_ERR_IO;
+    }
+
+    OsalMemFree(bwrs);
     return ret;
 }
 
@@ -301,26 +394,234 @@ static int HdfVNodeAdapterReadDevEvent(struct HdfVNodeAdapterClient *client, uns
     return ret;
 }
 
+static void HdfVnodeCleanEventQueue(struct HdfVNodeAdapterClient *client)
+{
+    struct HdfDevEvent *event = NULL;
+    struct HdfDevEvent *eventTemp = NULL;
+    DLIST_FOR_EACH_ENTRY_SAFE(event, eventTemp, &client->eventQueue, struct HdfDevEvent, listNode) {
+        DListRemove(&event->listNode);
+        DevEventFree(event);
+    }
+}
+
 static void HdfVnodeAdapterDropOldEventLocked(struct HdfVNodeAdapterClient *client)
 {
     struct HdfDevEvent *dropEvent = CONTAINER_OF(client->eventQueue.next, struct HdfDevEvent, listNode);
 
-    HDF_LOGE("dev event queue full, drop old one");
+    client->droppedEvents++;
+    HDF_LOGE("dev event queue full, drop old one, %u dropped", client->droppedEvents);
     DListRemove(&dropEvent->listNode);
     DevEventFree(dropEvent);
     client->eventQueueSize--;
 }
 
+static int HdfVNodeEventRingPutLocked(struct HdfVNodeAdapterClient *client, uint32_t id, const struct HdfSBuf *data)
+{
+    struct HdfVNodeEventRing *ring = client->eventRing;
+    struct HdfDevEventRecord *record = NULL;
+    uint32_t dataSize = (uint32_t)HdfSbufGetDataSize(data);
+    uint32_t offset = ring->head & (ring->capacity - 1);
+    uint32_t padSize = 0;
+    uint32_t recordSize;
+
+    if (dataSize > ring->capacity) {
+        recordSize = ring->capacity + 1;
+    } else {
+        recordSize = HDF_DEV_EVENT_RECORD_SIZE(dataSize);
+    }
+    /* records never wrap, the tail room is skipped with a pad record instead */
+    if (recordSize > ring->capacity - offset) {
+        padSize = ring->capacity - offset;
+    }
+    if (recordSize > ring->capacity || recordSize + padSize > ring->capacity - (ring->head - ring->tail)) {
+        if (client->droppedEvents++ == 0) {
+            HDF_LOGE("dev event ring full, drop new events");
+        }
+        return HDF_SUCCESS;
+    }
+
+    if (padSize != 0) {
+        record = (struct HdfDevEventRecord *)(ring->buffer + offset);
+        record->id = 0;
+        record->size = EVENT_RING_PAD_SIZE;
+        ring->head += padSize;
+        offset = 0;
+    }
+    record = (struct HdfDevEventRecord *)(ring->buffer + offset);
+    record->id = id;
+    record->size = dataSize;
+    if (dataSize != 0 && memcpy_s((uint8_t *)(record + 1), ring->capacity - offset - sizeof(*record),
+        HdfSbufGetData(data), dataSize) != EOK) {
+        HDF_LOGE("%s: failed to copy event data", __func__);
+        return HDF_FAILURE;
+    }
+    ring->head += recordSize;
+    return HDF_SUCCESS;
+}
+
+static void HdfVNodeEventRingDiscardLocked(struct HdfVNodeAdapterClient *client)
+{
+    if (client->eventRing != NULL) {
+        client->eventRing->tail = client->eventRing->head;
+    }
+}
+
+static uint32_t HdfVNodeEventRingRoundSize(uint32_t size)
+{
+    uint32_t capacity = HDF_DEV_EVENT_RING_SIZE_MIN;
+    while (capacity < size && capacity < HDF_DEV_EVENT_RING_SIZE_MAX) {
+        capacity <<= 1;
+    }
+    return capacity;
+}
+
+static int HdfVNodeAdapterEnableEventRing(struct HdfVNodeAdapterClient *client, unsigned long arg)
+{
+    struct HdfVNodeEventRing *ring = NULL;
+    uint32_t size = 0;
+
+    if (arg == 0 || CopyFromUser(&size, (void *)(uintptr_t)arg, sizeof(size)) != 0) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+
+    OsalMutexLock(&client->mutex);
+    if (client->eventRing == NULL) {
+        ring = OsalMemCalloc(sizeof(struct HdfVNodeEventRing));
+        if (ring == NULL) {
+            OsalMutexUnlock(&client->mutex);
+            return HDF_ERR_MALLOC_FAIL;
+        }
+        ring->capacity = HdfVNodeEventRingRoundSize(size);
+        ring->buffer = OsalMemCalloc(ring->capacity);
+        if (ring->buffer == NULL) {
+            OsalMutexUnlock(&client->mutex);
+            HDF_LOGE("%s: oom", __func__);
+            OsalMemFree(ring);
+            return HDF_ERR_MALLOC_FAIL;
+        }
+        /* events queued before the switch would never be read again */
+        client->droppedEvents += (uint32_t)client->eventQueueSize;
+        HdfVnodeCleanEventQueue(client);
+        client->eventQueueSize = 0;
+        client->eventRing = ring;
+    }
+    size = client->eventRing->capacity;
+    OsalMutexUnlock(&client->mutex);
+
+    if (CopyToUser((void *)(uintptr_t)arg, &size, sizeof(size)) != 0) {
+        return HDF_ERR_IO;
+    }
+    return HDF_SUCCESS;
+}
+
+static int HdfVNodeEventRingCopySpan(const struct HdfVNodeEventRing *ring, uint32_t from, uint32_t size,
+    struct HdfDevEventDrain *drain)
+{
+    if (size == 0) {
+        return HDF_SUCCESS;
+    }
+    if (CopyToUser((uint8_t *)(uintptr_t)drain->buffer + drain->consumed,
+        ring->buffer + (from & (ring->capacity - 1)), size) != 0) {
+        HDF_LOGE("%s: failed to copy events", __func__);
+        return HDF_ERR_IO;
+    }
+    drain->consumed += size;
+    return HDF_SUCCESS;
+}
+
+static int HdfVNodeAdapterDrainEventRing(struct HdfVNodeAdapterClient *client, unsigned long arg)
+{
+    struct HdfDevEventDrain drain;
+    struct HdfVNodeEventRing *ring = NULL;
+    const struct HdfDevEventRecord *record = NULL;
+    uint32_t head;
+    uint32_t tail;
+    uint32_t pos;
+    uint32_t spanStart;
+    uint32_t offset;
+    uint32_t recordSize;
+
+    if (arg == 0 || CopyFromUser(&drain, (void *)(uintptr_t)arg, sizeof(drain)) != 0) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+    OsalMutexLock(&client->mutex);
+    ring = client->eventRing;
+    if (ring == NULL) {
+        OsalMutexUnlock(&client->mutex);
+        return HDF_ERR_NOT_SUPPORT;
+    }
+    head = ring->head;
+    tail = ring->tail;
+    OsalMutexUnlock(&client->mutex);
+
+    drain.consumed = 0;
+    drain.count = 0;
+    pos = tail;
+    spanStart = tail;
+    while (pos != head) {
+        offset = pos & (ring->capacity - 1);
+        if (offset == 0 && pos != spanStart) {
+            if (HdfVNodeEventRingCopySpan(ring, spanStart, pos - spanStart, &drain) != HDF_SUCCESS) {
+                return HDF_ERR_IO;
+            }
+            spanStart = pos;
+        }
+        record = (const struct HdfDevEventRecord *)(ring->buffer + offset);
+        if (record->size == EVENT_RING_PAD_SIZE) {
+            if (HdfVNodeEventRingCopySpan(ring, spanStart, pos - spanStart, &drain) != HDF_SUCCESS) {
+                return HDF_ERR_IO;
+            }
+            pos += ring->capacity - offset;
+            spanStart = pos;
+            continue;
+        }
+        recordSize = HDF_DEV_EVENT_RECORD_SIZE(record->size);
+        if (drain.consumed + (pos - spanStart) + recordSize > drain.size) {
+            break;
+        }
+        pos += recordSize;
+        drain.count++;
+    }
+    if (HdfVNodeEventRingCopySpan(ring, spanStart, pos - spanStart, &drain) != HDF_SUCCESS) {
+        return HDF_ERR_IO;
+    }
+    if (drain.count == 0 && pos != head) {
+        return HDF_DEV_ERR_NORANGE;
+    }
+
+    OsalMutexLock(&client->mutex);
+    /* the ring is discarded when listening stops, keep it that way */
+    if (ring->tail == tail) {
+        ring->tail = pos;
+    }
+    drain.dropped = client->droppedEvents;
+    client->droppedEvents = 0;
+    OsalMutexUnlock(&client->mutex);
+
+    if (CopyToUser((void *)(uintptr_t)arg, &drain, sizeof(drain)) != 0) {
+        HDF_LOGE("%s: failed to copy drain result", __func__);
+        return HDF_ERR_IO;
+    }
+    return HDF_SUCCESS;
+}
+
 static int VNodeAdapterSendDevEventToClient(struct HdfVNodeAdapterClient *vnodeClient,
     uint32_t id, const struct HdfSBuf *data)
 {
     struct HdfDevEvent *event = NULL;
+    int ret;
 
     OsalMutexLock(&vnodeClient->mutex);
     if (vnodeClient->status != VNODE_CLIENT_LISTENING) {
         OsalMutexUnlock(&vnodeClient->mutex);
         return HDF_SUCCESS;
     }
+    if (vnodeClient->eventRing != NULL) {
+        ret = HdfVNodeEventRingPutLocked(vnodeClient, id, data);
+        wake_up_interruptible(&vnodeClient->pollWait);
+        OsalMutexUnlock(&vnodeClient->mutex);
+        return ret;
+    }
     if (vnodeClient->eventQueueSize >= EVENT_QUEUE_MAX) {
         HdfVnodeAdapterDropOldEventLocked(vnodeClient);
     }
@@ -375,21 +676,12 @@ static void HdfVNodeAdapterClientStartListening(struct HdfVNodeAdapterClient *cl
     OsalMutexUnlock(&client->mutex);
 }
 
-static void HdfVnodeCleanEventQueue(struct HdfVNodeAdapterClient *client)
-{
-    struct HdfDevEvent *event = NULL;
-    struct HdfDevEvent *eventTemp = NULL;
-    DLIST_FOR_EACH_ENTRY_SAFE(event, eventTemp, &client->eventQueue, struct HdfDevEvent, listNode) {
-        DListRemove(&event->listNode);
-        DevEventFree(event);
-    }
-}
-
 static void HdfVNodeAdapterClientStopListening(struct HdfVNodeAdapterClient *client)
 {
     OsalMutexLock(&client->mutex);
     client->status = VNODE_CLIENT_STOPPED;
     HdfVnodeCleanEventQueue(client);
+    HdfVNodeEventRingDiscardLocked(client);
     wake_up_interruptible(&client->pollWait);
     OsalMutexUnlock(&client->mutex);
 }
@@ -399,6 +691,7 @@ static void HdfVNodeAdapterClientExitListening(struct HdfVNodeAdapterClient *cli
     OsalMutexLock(&client->mutex);
     client->status = VNODE_CLIENT_EXITED;
     HdfVnodeCleanEventQueue(client);
+    HdfVNodeEventRingDiscardLocked(client);
     wake_up_interruptible(&client->pollWait);
     OsalMutexUnlock(&client->mutex);
 }
@@ -424,8 +717,14 @@ static long HdfVNodeAdapterIoctl(struct file *filep,  unsigned int cmd, unsigned
     switch (cmd) {
         case HDF_WRITE_READ:
             return HdfVNodeAdapterServCall(client, arg);
+        case HDF_WRITE_READ_BATCH:
+            return HdfVNodeAdapterServCallBatch(client, arg);
         case HDF_READ_DEV_EVENT:
             return HdfVNodeAdapterReadDevEvent(client, arg);
+        case HDF_LISTEN_EVENT_RING:
+            return HdfVNodeAdapterEnableEventRing(client, arg);
+        case HDF_READ_DEV_EVENT_RING:
+            return HdfVNodeAdapterDrainEventRing(client, arg);
         case HDF_LISTEN_EVENT_START:
             HdfVNodeAdapterClientStartListening(client);
             break;
@@ -490,6 +789,11 @@ static void HdfDestoryVNodeAdapterClient(struct HdfVNodeAdapterClient *client)
         DListRemove(&event->listNode);
         DevEventFree(event);
     }
+    if (client->eventRing != NULL) {
+        OsalMemFree(client->eventRing->buffer);
+        OsalMemFree(client->eventRing);
+        client->eventRing = NULL;
+    }
     OsalMutexUnlock(&client->mutex);
     OsalMutexDestroy(&client->mutex);
     OsalMemFree(client);
@@ -536,6 +840,8 @@ static unsigned int HdfVNodeAdapterPoll(struct file *filep, poll_table *wait)
         mask |= POLLHUP;
     } else if (!DListIsEmpty(&client->eventQueue)) {
         mask |= POLLIN;
+    } else if (client->eventRing != NULL && client->eventRing->head != client->eventRing->tail) {
+        mask |= POLLIN;
     } else if (client->wakeup > 0) {
         mask |= POLLIN;
         client->wakeup--;
@@ -12,6 +12,7 @@
 #include "devsvc_manager.h"
 #include "devsvc_manager_clnt.h"
 #include "hdf_base.h"
+#include "hdf_boot_trace.h"
 #include "hdf_device_node.h"
 #include "hdf_io_service.h"
 #include "hdf_log.h"
@@ -73,6 +74,9 @@ int DeviceManagerDispatch(struct HdfObject *stub, int code, struct HdfSBuf *data
             GetDeviceServiceNameByClass(reply, deviceClass);
             ret = HDF_SUCCESS;
             break;
+        case DEVMGR_DUMP_BOOT_TRACE:
+            ret = HdfBootTraceDump(data, reply);
+            break;
         default:
             HDF_LOGE("%s: unsupported configuration type: %d", __func__, code);
             break;
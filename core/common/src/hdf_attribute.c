@@ -11,6 +11,7 @@
 #include "hcs_tree_if.h"
 #include "hdf_host_info.h"
 #include "hdf_log.h"
+#include "osal_mem.h"
 #ifdef LOSCFG_DRIVERS_HDF_USB_PNP_NOTIFY
 #include "usb_pnp_manager.h"
 #endif
@@ -23,6 +24,7 @@
 #define ATTR_DEV_MODULENAME "moduleName"
 #define ATTR_DEV_SVCNAME "serviceName"
 #define ATTR_DEV_MATCHATTR "deviceMatchAttr"
+#define ATTR_DEV_DEPENDS "depends"
 #define MANAGER_NODE_MATCH_ATTR "hdf_manager"
 
 #define DEFATLT_DEV_PRIORITY 100
@@ -156,6 +158,27 @@ static bool CheckDeviceInfo(const struct HdfDeviceInfo *deviceNodeInfo)
     return (strcmp(deviceNodeInfo->moduleName, "") != 0);
 }
 
+static bool GetDeviceNodeDepends(const struct DeviceResourceNode *deviceNode, struct HdfDeviceInfo *deviceNodeInfo)
+{
+    int32_t i;
+    int32_t count = HcsGetElemNum(deviceNode, ATTR_DEV_DEPENDS);
+    if (count <= 0) {
+        return true;
+    }
+    deviceNodeInfo->depends = (const char **)OsalMemCalloc(sizeof(const char *) * (uint32_t)count);
+    if (deviceNodeInfo->depends == NULL) {
+        return false;
+    }
+    for (i = 0; i < count; i++) {
+        if (HcsGetStringArrayElem(deviceNode, ATTR_DEV_DEPENDS, (uint32_t)i, &deviceNodeInfo->depends[i], NULL) !=
+            HDF_SUCCESS) {
+            return false;
+        }
+    }
+    deviceNodeInfo->dependCount = (uint16_t)count;
+    return true;
+}
+
 static bool GetDeviceNodeInfo(const struct DeviceResourceNode *deviceNode, struct HdfDeviceInfo *deviceNodeInfo)
 {
     HcsGetUint16(deviceNode, ATTR_DEV_POLICY, &deviceNodeInfo->policy, 0);
@@ -174,6 +197,11 @@ static bool GetDeviceNodeInfo(const struct DeviceResourceNode *deviceNode, struc
         return false;
     }
 
+    if (!GetDeviceNodeDepends(deviceNode, deviceNodeInfo)) {
+        HDF_LOGE("%s: failed to get depends of %s", __func__, deviceNodeInfo->svcName);
+        return false;
+    }
+
     return CheckDeviceInfo(deviceNodeInfo);
 }
 
@@ -197,7 +225,9 @@ static bool GetDevcieNodeList(const struct DeviceResourceNode *device,
         }
 
         deviceNodeInfo->deviceId = MK_DEVID(hostId, deviceIdx, deviceNodeIdx);
-        if (deviceNodeInfo->preload != DEVICE_PRELOAD_DISABLE) {
+        deviceNodeInfo->isDynamic = (deviceNodeInfo->preload == DEVICE_PRELOAD_DISABLE ||
+            deviceNodeInfo->preload == DEVICE_PRELOAD_ON_DEMAND);
+        if (!deviceNodeInfo->isDynamic) {
             if (!HdfSListAddOrder(&hostClnt->unloadDevInfos, &deviceNodeInfo->node, HdfDeviceListCompare)) {
                 HDF_LOGE("%s: failed to add device info to list %s", __func__, deviceNodeInfo->svcName);
                 HdfDeviceInfoFreeInstance(deviceNodeInfo);
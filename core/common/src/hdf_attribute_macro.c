@@ -163,7 +163,9 @@ static bool GetDevcieNodeList(const struct HdfDeviceType *device,
         }
 
         deviceNodeInfo->deviceId = MK_DEVID(hostId, deviceIdx, deviceNodeIdx);
-        if (deviceNodeInfo->preload != DEVICE_PRELOAD_DISABLE) {
+        deviceNodeInfo->isDynamic = (deviceNodeInfo->preload == DEVICE_PRELOAD_DISABLE ||
+            deviceNodeInfo->preload == DEVICE_PRELOAD_ON_DEMAND);
+        if (!deviceNodeInfo->isDynamic) {
             if (!HdfSListAddOrder(&hostClnt->unloadDevInfos, &deviceNodeInfo->node, HdfDeviceListCompare)) {
                 HDF_LOGE("%s: failed to add device info to list %s", __func__, deviceNodeInfo->svcName);
                 HdfDeviceInfoFreeInstance(deviceNodeInfo);
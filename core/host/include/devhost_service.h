@@ -20,6 +20,7 @@ struct DevHostService {
     uint16_t hostId;
     const char *hostName;
     struct DListHead devices;
+    struct OsalMutex devicesMutex; // devices of different hcs nodes may be added concurrently at boot
     struct HdfServiceObserver observer;
     struct HdfSysEventNotifyNode sysEventNotifyNode;
 };
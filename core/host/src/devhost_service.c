@@ -38,23 +38,29 @@ static struct HdfDevice *DevHostServiceFindDevice(struct DevHostService *hostSer
 static void DevHostServiceFreeDevice(struct DevHostService *hostService, struct HdfDevice *device)
 {
     if (device != NULL) {
+        OsalMutexLock(&hostService->devicesMutex);
         DListRemove(&device->node);
+        OsalMutexUnlock(&hostService->devicesMutex);
         HdfDeviceFreeInstance(device);
     }
 }
 
 static struct HdfDevice *DevHostServiceQueryOrAddDevice(struct DevHostService *inst, uint16_t deviceId)
 {
-    struct HdfDevice *device = DevHostServiceFindDevice(inst, deviceId);
+    struct HdfDevice *device = NULL;
+    OsalMutexLock(&inst->devicesMutex);
+    device = DevHostServiceFindDevice(inst, deviceId);
     if (device == NULL) {
         device = HdfDeviceNewInstance();
         if (device == NULL) {
+            OsalMutexUnlock(&inst->devicesMutex);
             HDF_LOGE("Dev host service failed to create driver instance");
             return NULL;
         }
         device->deviceId = MK_DEVID(inst->hostId, deviceId, 0);
         DListInsertHead(&device->node, &inst->devices);
     }
+    OsalMutexUnlock(&inst->devicesMutex);
     return device;
 }
 
@@ -223,6 +229,7 @@ void DevHostServiceConstruct(struct DevHostService *service)
         hostServiceIf->StartService = DevHostServiceStartService;
         hostServiceIf->PmNotify = DevHostServicePmNotify;
         DListHeadInit(&service->devices);
+        (void)OsalMutexInit(&service->devicesMutex);
         HdfServiceObserverConstruct(&service->observer);
     }
 }
@@ -238,6 +245,7 @@ void DevHostServiceDestruct(struct DevHostService *service)
     DLIST_FOR_EACH_ENTRY_SAFE(device, tmp, &service->devices, struct HdfDevice, node) {
         HdfDeviceFreeInstance(device);
     }
+    (void)OsalMutexDestroy(&service->devicesMutex);
     HdfServiceObserverDestruct(&service->observer);
 }
 
@@ -13,6 +13,7 @@
 #include "hcs_tree_if.h"
 #include "hdf_attribute_manager.h"
 #include "hdf_base.h"
+#include "hdf_boot_trace.h"
 #include "hdf_cstring.h"
 #include "hdf_device_object.h"
 #include "hdf_device_token.h"
@@ -43,11 +44,13 @@ static int HdfDeviceNodePublishService(struct HdfDeviceNode *devNode)
 {
     int status = HDF_SUCCESS;
     struct IDeviceNode *nodeIf = NULL;
+    HDF_BOOT_TRACE_DECLARE(traceBegin);
     if (devNode->policy == SERVICE_POLICY_NONE ||
         (devNode->servName != NULL && strlen(devNode->servName) == 0)) {
         return status;
     }
 
+    HDF_BOOT_TRACE_BEGIN(traceBegin);
     nodeIf = &devNode->super;
     if (devNode->policy == SERVICE_POLICY_PUBLIC || devNode->policy == SERVICE_POLICY_CAPACITY) {
         if (nodeIf->PublishService != NULL) {
@@ -57,6 +60,8 @@ static int HdfDeviceNodePublishService(struct HdfDeviceNode *devNode)
     if (status == HDF_SUCCESS) {
         status = HdfDeviceNodePublishLocalService(devNode);
     }
+    HDF_BOOT_TRACE_END(traceBegin, HDF_BOOT_PHASE_PUBLISH, devNode->devId, devNode->driver->entry->moduleName,
+        devNode->servName, status);
     return status;
 }
 
@@ -64,6 +69,7 @@ int DeviceDriverBind(struct HdfDeviceNode *devNode)
 {
     int ret;
     const struct HdfDriverEntry *driverEntry = NULL;
+    HDF_BOOT_TRACE_DECLARE(traceBegin);
     if (devNode == NULL) {
         return HDF_ERR_INVALID_PARAM;
     }
@@ -75,7 +81,10 @@ int DeviceDriverBind(struct HdfDeviceNode *devNode)
             devNode->devStatus = DEVNODE_NONE;
             return HDF_ERR_INVALID_OBJECT;
         }
+        HDF_BOOT_TRACE_BEGIN(traceBegin);
         ret = driverEntry->Bind(&devNode->deviceObject);
+        HDF_BOOT_TRACE_END(traceBegin, HDF_BOOT_PHASE_BIND, devNode->devId, driverEntry->moduleName,
+            devNode->servName, ret);
         if (ret != HDF_SUCCESS) {
             HDF_LOGE("bind driver %s failed", driverEntry->moduleName);
             return HDF_DEV_ERR_DEV_INIT_FAIL;
@@ -85,29 +94,18 @@ int DeviceDriverBind(struct HdfDeviceNode *devNode)
     return HDF_SUCCESS;
 }
 
-int HdfDeviceLaunchNode(struct HdfDeviceNode *devNode)
+static int HdfDeviceNodeStart(struct HdfDeviceNode *devNode, const struct HdfDriverEntry *driverEntry)
 {
-    const struct HdfDriverEntry *driverEntry = NULL;
-    int ret;
-    if (devNode == NULL) {
-        HDF_LOGE("failed to launch service, device or service is null");
-        return HDF_ERR_INVALID_PARAM;
-    }
-
-    HDF_LOGI("launch devnode %s", devNode->servName ? devNode->servName : "");
-    driverEntry = devNode->driver->entry;
-    if (driverEntry == NULL || driverEntry->Init == NULL) {
-        HDF_LOGE("failed to launch service, deviceEntry invalid");
-        return HDF_ERR_INVALID_PARAM;
-    }
-    devNode->devStatus = DEVNODE_LAUNCHED;
-
-    ret = DeviceDriverBind(devNode);
+    int ret = DeviceDriverBind(devNode);
+    HDF_BOOT_TRACE_DECLARE(traceBegin);
     if (ret != HDF_SUCCESS) {
         return ret;
     }
 
+    HDF_BOOT_TRACE_BEGIN(traceBegin);
     ret = driverEntry->Init(&devNode->deviceObject);
+    HDF_BOOT_TRACE_END(traceBegin, HDF_BOOT_PHASE_INIT, devNode->devId, driverEntry->moduleName,
+        devNode->servName, ret);
     if (ret != HDF_SUCCESS) {
         return HDF_DEV_ERR_DEV_INIT_FAIL;
     }
@@ -124,6 +122,31 @@ int HdfDeviceLaunchNode(struct HdfDeviceNode *devNode)
     return ret;
 }
 
+int HdfDeviceLaunchNode(struct HdfDeviceNode *devNode)
+{
+    const struct HdfDriverEntry *driverEntry = NULL;
+    int ret;
+    HDF_BOOT_TRACE_DECLARE(traceBegin);
+    if (devNode == NULL) {
+        HDF_LOGE("failed to launch service, device or service is null");
+        return HDF_ERR_INVALID_PARAM;
+    }
+
+    HDF_LOGI("launch devnode %s", devNode->servName ? devNode->servName : "");
+    driverEntry = devNode->driver->entry;
+    if (driverEntry == NULL || driverEntry->Init == NULL) {
+        HDF_LOGE("failed to launch service, deviceEntry invalid");
+        return HDF_ERR_INVALID_PARAM;
+    }
+    devNode->devStatus = DEVNODE_LAUNCHED;
+
+    HDF_BOOT_TRACE_BEGIN(traceBegin);
+    ret = HdfDeviceNodeStart(devNode, driverEntry);
+    HDF_BOOT_TRACE_END(traceBegin, HDF_BOOT_PHASE_LAUNCH, devNode->devId, driverEntry->moduleName,
+        devNode->servName, ret);
+    return ret;
+}
+
 int HdfDeviceNodeAddPowerStateListener(
     struct HdfDeviceNode *devNode, const struct IPowerEventListener *listener)
 {
@@ -27,11 +27,11 @@ int32_t HdfDriverEntryConstruct()
     addrBegin = (size_t *)(HDF_DRIVER_BEGIN());
     for (i = 0; i < count; i++) {
         driverEntry = (struct HdfDriverEntry *)(*addrBegin);
+        addrBegin++;
         if (HdfRegisterDriverEntry(driverEntry) != HDF_SUCCESS) {
             HDF_LOGE("failed to register driver %s, skip and try another", driverEntry ? driverEntry->moduleName : "");
             continue;
         }
-        addrBegin++;
     }
     return HDF_SUCCESS;
 }
@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ *
+ * HDF is dual licensed: you can use it either under the terms of
+ * the GPL, or the BSD license, at your option.
+ * See the LICENSE file in the root of this repository for complete details.
+ */
+
+#ifndef DEVMGR_BOOT_SCHEDULER_H
+#define DEVMGR_BOOT_SCHEDULER_H
+
+#include "devhost_service_clnt.h"
+#include "hdf_device_info.h"
+#include "hdf_dlist.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+#define DEVMGR_BOOT_WORKER_COUNT 4
+
+/*
+ * Boot scheduler of preload devices. It is only used when some device declares 'depends', then
+ * devices of a host load in priority tiers, devices of one hcs device node load in order, and a
+ * device with 'depends' waits for the devices publishing those services, and is not loaded if one
+ * of them fails. Everything else, devices of different hosts included, loads concurrently on
+ * DEVMGR_BOOT_WORKER_COUNT workers.
+ */
+bool DevmgrBootSchedulerEnabled(struct DListHead *hosts);
+
+/* Starts collecting devices, which DevHostServiceClntInstallDriver then queues instead of loading. */
+int32_t DevmgrBootSchedulerBegin(void);
+
+/* Returns true if the device is queued, false if the caller has to load it now. */
+bool DevmgrBootSchedulerAddDevice(struct DevHostServiceClnt *hostClnt, struct HdfDeviceInfo *deviceInfo);
+
+/* Loads the queued devices and returns when all of them are done. */
+int32_t DevmgrBootSchedulerRun(void);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* DEVMGR_BOOT_SCHEDULER_H */
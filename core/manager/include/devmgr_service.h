@@ -13,10 +13,17 @@
 #include "hdf_dlist.h"
 #include "osal_mutex.h"
 
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
 struct DevmgrService {
     struct IDevmgrService super;
     struct DListHead hosts;
     struct OsalMutex devMgrMutex;
+    struct OsalMutex devicesMutex; // guards the device token lists of the hosts
+    struct OsalMutex loadMutex;
+    struct DListHead loadRequests; // dynamic devices being loaded
 };
 
 int DevmgrServiceStartService(struct IDevmgrService *inst);
@@ -25,5 +32,15 @@ struct HdfObject *DevmgrServiceCreate(void);
 void DevmgrServiceRelease(struct HdfObject *object);
 struct IDevmgrService *DevmgrServiceGetInstance(void);
 int32_t DevmgrServiceLoadLeftDriver(struct DevmgrService *devMgrSvc);
+/*
+ * Loads the device publishing serviceName if its preload is DEVICE_PRELOAD_ON_DEMAND. A caller coming
+ * while the device is being loaded waits for that load, unless it runs inside the load itself, then it
+ * gets HDF_ERR_DEVICE_BUSY.
+ */
+int DevmgrServiceLoadOnDemand(struct DevmgrService *devMgrSvc, const char *serviceName);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
 
 #endif /* DEVICE_MANAGER_SERVICE_H */
@@ -12,14 +12,32 @@
 #include "devsvc_manager_if.h"
 #include "hdf_service_observer.h"
 #include "hdf_dlist.h"
+#include "osal_atomic.h"
 #include "osal_mutex.h"
 
+#define DEVSVC_CLASS_COUNT 9 /* device class bits below DEVICE_CLASS_MAX */
+
+struct DevSvcHashTable;
+
+struct DevSvcListenerIndex {
+    struct ServStatListenerHolder **holders;
+    uint32_t count;
+    uint32_t capacity;
+};
+
 struct DevSvcManager {
     struct IDevSvcManager super;
     struct DListHead services;
     struct HdfServiceObserver observer;
     struct DListHead svcstatListeners;
     struct OsalMutex mutex;
+    struct DevSvcHashTable *svcTable;
+    uint32_t svcCount;
+    OsalAtomic seq;     /* odd while the table is being changed */
+    OsalAtomic readers; /* lookups running without the mutex */
+    struct DListHead retiredServices;
+    struct DevSvcHashTable *retiredTables;
+    struct DevSvcListenerIndex listenerIndex[DEVSVC_CLASS_COUNT];
 };
 
 struct HdfObject *DevSvcManagerCreate(void);
@@ -34,6 +52,8 @@ int DevSvcManagerAddService(struct IDevSvcManager *manager, const char *svcName,
 struct HdfObject *DevSvcManagerGetService(struct IDevSvcManager *manager, const char *svcName);
 void DevSvcManagerRemoveService(struct IDevSvcManager *manager, const char *svcName);
 void DevSvcManagerListService(struct HdfSBuf *serviceNameSet, DeviceClass deviceClass);
+void DevSvcManagerUpdateServListener(struct IDevSvcManager *inst,
+    struct ServStatListenerHolder *listenerHolder, uint16_t listenClass);
 
 int DevSvcManagerClntSubscribeService(const char *svcName, struct SubscriberCallback callback);
 int DevSvcManagerClntUnsubscribeService(const char *svcName);
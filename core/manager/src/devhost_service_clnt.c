@@ -8,8 +8,10 @@
 
 #include "devhost_service_clnt.h"
 #include "device_token_clnt.h"
+#include "devmgr_boot_scheduler.h"
 #include "devmgr_service_start.h"
 #include "hdf_base.h"
+#include "hdf_boot_trace.h"
 #include "hdf_driver_installer.h"
 #include "hdf_log.h"
 #include "osal_mem.h"
@@ -22,6 +24,7 @@ int DevHostServiceClntInstallDriver(struct DevHostServiceClnt *hostClnt)
     struct HdfSListIterator it;
     struct HdfDeviceInfo *deviceInfo = NULL;
     struct IDevHostService *devHostSvcIf = NULL;
+    HDF_BOOT_TRACE_DECLARE(traceBegin);
     if (hostClnt == NULL) {
         HDF_LOGE("failed to install driver, hostClnt is null");
         return HDF_FAILURE;
@@ -46,7 +49,14 @@ int DevHostServiceClntInstallDriver(struct DevHostServiceClnt *hostClnt)
             deviceInfo->preload == DEVICE_PRELOAD_ENABLE_STEP2) {
             continue;
         }
+        // the boot scheduler loads it later, together with the devices of the other hosts
+        if (DevmgrBootSchedulerAddDevice(hostClnt, deviceInfo)) {
+            continue;
+        }
+        HDF_BOOT_TRACE_BEGIN(traceBegin);
         ret = devHostSvcIf->AddDevice(devHostSvcIf, deviceInfo);
+        HDF_BOOT_TRACE_END(traceBegin, HDF_BOOT_PHASE_LOAD, deviceInfo->deviceId, deviceInfo->moduleName,
+            deviceInfo->svcName, ret);
         if (ret != HDF_SUCCESS) {
             HDF_LOGE("failed to install driver %s, ret = %d", deviceInfo->svcName, ret);
             continue;
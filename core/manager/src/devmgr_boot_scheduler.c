@@ -0,0 +1,712 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ *
+ * HDF is dual licensed: you can use it either under the terms of
+ * the GPL, or the BSD license, at your option.
+ * See the LICENSE file in the root of this repository for complete details.
+ */
+
+#include "devmgr_boot_scheduler.h"
+#include <string.h>
+#include "hdf_boot_trace.h"
+#include "hdf_device.h"
+#include "hdf_log.h"
+#include "hdf_map.h"
+#include "osal_atomic.h"
+#include "osal_mem.h"
+#include "osal_mutex.h"
+#include "osal_sem.h"
+#include "osal_thread.h"
+#include "osal_time.h"
+#include "securec.h"
+
+#define HDF_LOG_TAG devmgr_boot_scheduler
+
+#define BOOT_JOB_NONE 0xFFFFFFFF
+#define BOOT_EDGE_DEPEND 0x80000000 // successor flag of an edge declared by 'depends'
+#define BOOT_JOB_INIT_CAPACITY 32
+#define BOOT_EDGES_PER_JOB 3 // tier barrier in and out, and the previous device of the same hcs device
+#define BOOT_WORKER_NAME "hdf_boot_worker"
+#define BOOT_SCC_ARRAYS 5 // order, low, cursor, stack and path of DevmgrBootSccWalk
+
+enum DevmgrBootState {
+    BOOT_STATE_IDLE,
+    BOOT_STATE_COLLECTING,
+    BOOT_STATE_RUNNING,
+};
+
+struct DevmgrBootJob {
+    struct DevHostServiceClnt *hostClnt;
+    struct HdfDeviceInfo *deviceInfo; // NULL for the barrier between two priority tiers of a host
+    uint32_t prevInHost;              // previous job of the same host, hosts may attach concurrently
+    uint32_t pending;                 // unfinished dependencies
+    uint32_t edgeStart;               // successors in the edge table
+    uint32_t edgeCount;
+    uint32_t failedProvider;          // first 'depends' provider that failed, the job is skipped then
+    bool started;
+    int32_t result;
+};
+
+struct DevmgrBootEdge {
+    uint32_t from;
+    uint32_t to;
+    bool depend;
+};
+
+/* Iterative Tarjan walk over the jobs not started yet, see DevmgrBootBreakCycle. */
+struct DevmgrBootSccWalk {
+    uint32_t *order;  // discovery order from 1, 0 before the visit, BOOT_JOB_NONE once the component closed
+    uint32_t *low;
+    uint32_t *cursor; // next successor to visit
+    uint32_t *stack;  // jobs of the components still open
+    uint32_t *path;   // jobs on the current DFS path
+    uint32_t stackTop;
+    uint32_t pathTop;
+    uint32_t visited;
+    uint32_t pick;    // first job, in serial boot order, of the last closed component
+};
+
+struct DevmgrBootScheduler {
+    OsalAtomic inited;
+    uint32_t state;
+    struct OsalMutex mutex;
+    struct OsalSem wakeSem;
+    struct OsalSem exitSem;
+    struct DevmgrBootJob *jobs; // in the order the serial boot would load them
+    uint32_t jobCount;
+    uint32_t jobCapacity;
+    uint32_t *edges;
+    uint32_t *ready;            // min-heap of job numbers, so ready jobs start in serial boot order
+    uint32_t readyCount;
+    uint32_t remaining;
+    uint32_t running;
+    uint32_t waiting;
+};
+
+static struct DevmgrBootScheduler g_bootScheduler;
+
+bool DevmgrBootSchedulerEnabled(struct DListHead *hosts)
+{
+    struct DevHostServiceClnt *hostClnt = NULL;
+    struct HdfSListIterator it;
+
+    DLIST_FOR_EACH_ENTRY(hostClnt, hosts, struct DevHostServiceClnt, node) {
+        HdfSListIteratorInit(&it, &hostClnt->unloadDevInfos);
+        while (HdfSListIteratorHasNext(&it)) {
+            struct HdfDeviceInfo *deviceInfo = (struct HdfDeviceInfo *)HdfSListIteratorNext(&it);
+            if (deviceInfo->dependCount > 0) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+int32_t DevmgrBootSchedulerBegin(void)
+{
+    struct DevmgrBootScheduler *sched = &g_bootScheduler;
+
+    if (OsalAtomicRead(&sched->inited) == 0) {
+        if (OsalMutexInit(&sched->mutex) != HDF_SUCCESS) {
+            return HDF_FAILURE;
+        }
+        if (OsalSemInit(&sched->wakeSem, 0) != HDF_SUCCESS) {
+            (void)OsalMutexDestroy(&sched->mutex);
+            return HDF_FAILURE;
+        }
+        if (OsalSemInit(&sched->exitSem, 0) != HDF_SUCCESS) {
+            (void)OsalSemDestroy(&sched->wakeSem);
+            (void)OsalMutexDestroy(&sched->mutex);
+            return HDF_FAILURE;
+        }
+        /* a value returning op, the locks are set up before anyone sees the flag */
+        (void)OsalAtomicIncReturn(&sched->inited);
+    }
+
+    OsalMutexLock(&sched->mutex);
+    if (sched->state != BOOT_STATE_IDLE) {
+        OsalMutexUnlock(&sched->mutex);
+        return HDF_ERR_DEVICE_BUSY;
+    }
+    sched->state = BOOT_STATE_COLLECTING;
+    OsalMutexUnlock(&sched->mutex);
+    return HDF_SUCCESS;
+}
+
+static uint32_t DevmgrBootLastJobOfHost(const struct DevmgrBootScheduler *sched,
+    const struct DevHostServiceClnt *hostClnt)
+{
+    uint32_t i = sched->jobCount;
+    while (i > 0) {
+        i--;
+        if (sched->jobs[i].hostClnt == hostClnt) {
+            return i;
+        }
+    }
+    return BOOT_JOB_NONE;
+}
+
+static bool DevmgrBootJobAppend(struct DevmgrBootScheduler *sched, struct DevHostServiceClnt *hostClnt,
+    struct HdfDeviceInfo *deviceInfo, uint32_t prevInHost)
+{
+    struct DevmgrBootJob *job = NULL;
+
+    if (sched->jobCount == sched->jobCapacity) {
+        uint32_t capacity = (sched->jobCapacity == 0) ? BOOT_JOB_INIT_CAPACITY : sched->jobCapacity * 2;
+        struct DevmgrBootJob *jobs = (struct DevmgrBootJob *)OsalMemCalloc(sizeof(*jobs) * capacity);
+        if (jobs == NULL) {
+            return false;
+        }
+        if (sched->jobs != NULL) {
+            (void)memcpy_s(jobs, sizeof(*jobs) * capacity, sched->jobs, sizeof(*jobs) * sched->jobCount);
+            OsalMemFree(sched->jobs);
+        }
+        sched->jobs = jobs;
+        sched->jobCapacity = capacity;
+    }
+    job = &sched->jobs[sched->jobCount++];
+    job->hostClnt = hostClnt;
+    job->deviceInfo = deviceInfo;
+    job->prevInHost = prevInHost;
+    job->failedProvider = BOOT_JOB_NONE;
+    job->result = HDF_SUCCESS;
+    return true;
+}
+
+bool DevmgrBootSchedulerAddDevice(struct DevHostServiceClnt *hostClnt, struct HdfDeviceInfo *deviceInfo)
+{
+    struct DevmgrBootScheduler *sched = &g_bootScheduler;
+    bool queued = false;
+    uint32_t last;
+
+    if ((hostClnt == NULL) || (deviceInfo == NULL) || OsalAtomicRead(&sched->inited) == 0) {
+        return false;
+    }
+    OsalMutexLock(&sched->mutex);
+    if (sched->state == BOOT_STATE_COLLECTING) {
+        last = DevmgrBootLastJobOfHost(sched, hostClnt);
+        // the device list of a host is sorted by priority, a higher value starts a new tier
+        if ((last != BOOT_JOB_NONE) && (deviceInfo->priority > sched->jobs[last].deviceInfo->priority)) {
+            if (!DevmgrBootJobAppend(sched, hostClnt, NULL, last)) {
+                OsalMutexUnlock(&sched->mutex);
+                return false;
+            }
+            last = sched->jobCount - 1;
+        }
+        queued = DevmgrBootJobAppend(sched, hostClnt, deviceInfo, last);
+    }
+    OsalMutexUnlock(&sched->mutex);
+    return queued;
+}
+
+static void DevmgrBootAddEdge(struct DevmgrBootEdge *edges, uint32_t *count, uint32_t from, uint32_t to,
+    bool depend)
+{
+    edges[*count].from = from;
+    edges[*count].to = to;
+    edges[*count].depend = depend;
+    (*count)++;
+}
+
+static void DevmgrBootAddHostEdges(struct DevmgrBootScheduler *sched, struct DevmgrBootEdge *edges, uint32_t *count)
+{
+    uint32_t lane;
+    uint32_t prev;
+    uint32_t i;
+
+    for (i = 0; i < sched->jobCount; i++) {
+        struct HdfDeviceInfo *deviceInfo = sched->jobs[i].deviceInfo;
+        lane = BOOT_JOB_NONE;
+        prev = sched->jobs[i].prevInHost;
+        // walk back through the current tier of the host, up to the barrier opening it
+        while ((prev != BOOT_JOB_NONE) && (sched->jobs[prev].deviceInfo != NULL)) {
+            if (deviceInfo == NULL) {
+                DevmgrBootAddEdge(edges, count, prev, i, false);
+            } else if ((lane == BOOT_JOB_NONE) &&
+                (DEVICEID(sched->jobs[prev].deviceInfo->deviceId) == DEVICEID(deviceInfo->deviceId))) {
+                // nodes of one hcs device share the HdfDevice of the host, so they load one by one
+                lane = prev;
+            }
+            prev = sched->jobs[prev].prevInHost;
+        }
+        if (lane != BOOT_JOB_NONE) {
+            DevmgrBootAddEdge(edges, count, lane, i, false);
+        }
+        if ((deviceInfo != NULL) && (prev != BOOT_JOB_NONE)) {
+            DevmgrBootAddEdge(edges, count, prev, i, false);
+        }
+    }
+}
+
+/* A provider in a later priority tier or later on the device lane of the same host can never load first. */
+static bool DevmgrBootLoadsLater(const struct DevmgrBootScheduler *sched, uint32_t provider, uint32_t job)
+{
+    const struct HdfDeviceInfo *providerInfo = sched->jobs[provider].deviceInfo;
+    const struct HdfDeviceInfo *deviceInfo = sched->jobs[job].deviceInfo;
+
+    if ((provider <= job) || (sched->jobs[provider].hostClnt != sched->jobs[job].hostClnt)) {
+        return false;
+    }
+    return (providerInfo->priority > deviceInfo->priority) ||
+        (DEVICEID(providerInfo->deviceId) == DEVICEID(deviceInfo->deviceId));
+}
+
+static void DevmgrBootAddDependEdges(struct DevmgrBootScheduler *sched, const Map *services,
+    struct DevmgrBootEdge *edges, uint32_t *count)
+{
+    uint32_t i;
+    uint16_t k;
+
+    for (i = 0; i < sched->jobCount; i++) {
+        struct HdfDeviceInfo *deviceInfo = sched->jobs[i].deviceInfo;
+        if (deviceInfo == NULL) {
+            continue;
+        }
+        for (k = 0; k < deviceInfo->dependCount; k++) {
+            uint32_t *provider = (uint32_t *)MapGet(services, deviceInfo->depends[k]);
+            if (provider == NULL) {
+                HDF_LOGW("%s depends on %s, which is not a preload service", deviceInfo->svcName,
+                    deviceInfo->depends[k]);
+                continue;
+            }
+            if (DevmgrBootLoadsLater(sched, *provider, i)) {
+                HDF_LOGE("%s depends on %s, which loads later on the same host, config error", deviceInfo->svcName,
+                    deviceInfo->depends[k]);
+                continue;
+            }
+            if (*provider != i) {
+                DevmgrBootAddEdge(edges, count, *provider, i, true);
+            }
+        }
+    }
+}
+
+static uint32_t DevmgrBootCountEdges(struct DevmgrBootScheduler *sched, Map *services)
+{
+    uint32_t count = sched->jobCount * BOOT_EDGES_PER_JOB;
+    uint32_t i;
+
+    for (i = 0; i < sched->jobCount; i++) {
+        struct HdfDeviceInfo *deviceInfo = sched->jobs[i].deviceInfo;
+        if (deviceInfo == NULL) {
+            continue;
+        }
+        count += deviceInfo->dependCount;
+        if ((deviceInfo->svcName != NULL) && (strcmp(deviceInfo->svcName, "") != 0)) {
+            (void)MapSet(services, deviceInfo->svcName, &i, sizeof(i));
+        }
+    }
+    return count;
+}
+
+/* Sorts the edges into a successor table and counts the dependencies of each job. */
+static int32_t DevmgrBootLinkEdges(struct DevmgrBootScheduler *sched, const struct DevmgrBootEdge *edges,
+    uint32_t count)
+{
+    uint32_t edgeStart = 0;
+    uint32_t i;
+
+    sched->edges = (uint32_t *)OsalMemCalloc(sizeof(uint32_t) * (count + 1));
+    sched->ready = (uint32_t *)OsalMemCalloc(sizeof(uint32_t) * sched->jobCount);
+    if ((sched->edges == NULL) || (sched->ready == NULL)) {
+        return HDF_ERR_MALLOC_FAIL;
+    }
+    for (i = 0; i < count; i++) {
+        sched->jobs[edges[i].from].edgeCount++;
+        sched->jobs[edges[i].to].pending++;
+    }
+    for (i = 0; i < sched->jobCount; i++) {
+        sched->jobs[i].edgeStart = edgeStart;
+        edgeStart += sched->jobs[i].edgeCount;
+        sched->jobs[i].edgeCount = 0;
+    }
+    for (i = 0; i < count; i++) {
+        struct DevmgrBootJob *from = &sched->jobs[edges[i].from];
+        sched->edges[from->edgeStart + from->edgeCount++] = edges[i].to | (edges[i].depend ? BOOT_EDGE_DEPEND : 0);
+    }
+    return HDF_SUCCESS;
+}
+
+static int32_t DevmgrBootBuildGraph(struct DevmgrBootScheduler *sched)
+{
+    Map services;
+    struct DevmgrBootEdge *edges = NULL;
+    uint32_t edgeCount = 0;
+    uint32_t capacity;
+    int32_t ret;
+
+    MapInit(&services);
+    capacity = DevmgrBootCountEdges(sched, &services);
+    edges = (struct DevmgrBootEdge *)OsalMemCalloc(sizeof(*edges) * (capacity + 1));
+    if (edges == NULL) {
+        MapDelete(&services);
+        return HDF_ERR_MALLOC_FAIL;
+    }
+    DevmgrBootAddHostEdges(sched, edges, &edgeCount);
+    DevmgrBootAddDependEdges(sched, &services, edges, &edgeCount);
+    MapDelete(&services);
+
+    ret = DevmgrBootLinkEdges(sched, edges, edgeCount);
+    OsalMemFree(edges);
+    return ret;
+}
+
+static void DevmgrBootPushReady(struct DevmgrBootScheduler *sched, uint32_t job)
+{
+    uint32_t pos = sched->readyCount++;
+    while (pos > 0) {
+        uint32_t parent = (pos - 1) / 2;
+        if (sched->ready[parent] <= job) {
+            break;
+        }
+        sched->ready[pos] = sched->ready[parent];
+        pos = parent;
+    }
+    sched->ready[pos] = job;
+}
+
+static uint32_t DevmgrBootPopReady(struct DevmgrBootScheduler *sched)
+{
+    uint32_t top;
+    uint32_t last;
+    uint32_t pos = 0;
+
+    if (sched->readyCount == 0) {
+        return BOOT_JOB_NONE;
+    }
+    top = sched->ready[0];
+    last = sched->ready[--sched->readyCount];
+    while (pos * 2 + 1 < sched->readyCount) {
+        uint32_t child = pos * 2 + 1;
+        if ((child + 1 < sched->readyCount) && (sched->ready[child + 1] < sched->ready[child])) {
+            child++;
+        }
+        if (last <= sched->ready[child]) {
+            break;
+        }
+        sched->ready[pos] = sched->ready[child];
+        pos = child;
+    }
+    sched->ready[pos] = last;
+    return top;
+}
+
+static void DevmgrBootSccEnter(struct DevmgrBootSccWalk *walk, uint32_t job)
+{
+    walk->order[job] = ++walk->visited;
+    walk->low[job] = walk->order[job];
+    walk->cursor[job] = 0;
+    walk->stack[walk->stackTop++] = job;
+    walk->path[walk->pathTop++] = job;
+}
+
+static void DevmgrBootSccClose(struct DevmgrBootSccWalk *walk, uint32_t root)
+{
+    uint32_t job;
+
+    walk->pick = root;
+    do {
+        job = walk->stack[--walk->stackTop];
+        walk->order[job] = BOOT_JOB_NONE;
+        if (job < walk->pick) {
+            walk->pick = job;
+        }
+    } while (job != root);
+}
+
+static void DevmgrBootSccVisit(const struct DevmgrBootScheduler *sched, struct DevmgrBootSccWalk *walk, uint32_t start)
+{
+    uint32_t job;
+    uint32_t next;
+
+    DevmgrBootSccEnter(walk, start);
+    while (walk->pathTop > 0) {
+        job = walk->path[walk->pathTop - 1];
+        if (walk->cursor[job] < sched->jobs[job].edgeCount) {
+            next = sched->edges[sched->jobs[job].edgeStart + walk->cursor[job]++] & ~BOOT_EDGE_DEPEND;
+            if (sched->jobs[next].started) {
+                continue;
+            }
+            if (walk->order[next] == 0) {
+                DevmgrBootSccEnter(walk, next);
+            } else if ((walk->order[next] != BOOT_JOB_NONE) && (walk->order[next] < walk->low[job])) {
+                walk->low[job] = walk->order[next];
+            }
+            continue;
+        }
+        walk->pathTop--;
+        if (walk->low[job] == walk->order[job]) {
+            DevmgrBootSccClose(walk, job);
+        }
+        if ((walk->pathTop > 0) && (walk->low[job] < walk->low[walk->path[walk->pathTop - 1]])) {
+            walk->low[walk->path[walk->pathTop - 1]] = walk->low[job];
+        }
+    }
+}
+
+/*
+ * Returns a job on a cycle that depends on no other unstarted job outside of it. Components close in
+ * reverse topological order, so the last one has no unstarted dependency left outside, and as every
+ * unstarted job still waits for another one, it holds a cycle.
+ */
+static uint32_t DevmgrBootFindCycle(const struct DevmgrBootScheduler *sched)
+{
+    struct DevmgrBootSccWalk walk;
+    uint32_t *mem = (uint32_t *)OsalMemCalloc(sizeof(uint32_t) * sched->jobCount * BOOT_SCC_ARRAYS);
+    uint32_t i;
+
+    if (mem == NULL) {
+        return BOOT_JOB_NONE;
+    }
+    (void)memset_s(&walk, sizeof(walk), 0, sizeof(walk));
+    walk.order = mem;
+    walk.low = walk.order + sched->jobCount;
+    walk.cursor = walk.low + sched->jobCount;
+    walk.stack = walk.cursor + sched->jobCount;
+    walk.path = walk.stack + sched->jobCount;
+    walk.pick = BOOT_JOB_NONE;
+    for (i = 0; i < sched->jobCount; i++) {
+        if (!sched->jobs[i].started && (walk.order[i] == 0)) {
+            DevmgrBootSccVisit(sched, &walk, i);
+        }
+    }
+    OsalMemFree(mem);
+    return walk.pick;
+}
+
+/* Nothing is ready or running while jobs remain, so the declared dependencies form a cycle. */
+static uint32_t DevmgrBootBreakCycle(struct DevmgrBootScheduler *sched)
+{
+    struct DevmgrBootJob *job = NULL;
+    uint32_t pick = DevmgrBootFindCycle(sched);
+    uint32_t i;
+
+    for (i = 0; (pick == BOOT_JOB_NONE) && (i < sched->jobCount); i++) {
+        // out of memory, any unstarted job still unblocks the boot
+        if (!sched->jobs[i].started) {
+            pick = i;
+        }
+    }
+    if (pick == BOOT_JOB_NONE) {
+        return BOOT_JOB_NONE;
+    }
+    job = &sched->jobs[pick];
+    HDF_LOGW("dependency cycle at %s, load it anyway",
+        (job->deviceInfo != NULL) ? job->deviceInfo->svcName : "priority barrier");
+    job->pending = 0;
+    return pick;
+}
+
+static void DevmgrBootWake(struct DevmgrBootScheduler *sched, uint32_t count)
+{
+    while ((count > 0) && (sched->waiting > 0)) {
+        sched->waiting--;
+        count--;
+        (void)OsalSemPost(&sched->wakeSem);
+    }
+}
+
+static void DevmgrBootComplete(struct DevmgrBootScheduler *sched, uint32_t done)
+{
+    const struct DevmgrBootJob *job = &sched->jobs[done];
+    uint32_t i;
+
+    sched->running--;
+    sched->remaining--;
+    for (i = 0; i < job->edgeCount; i++) {
+        uint32_t edge = sched->edges[job->edgeStart + i];
+        struct DevmgrBootJob *next = &sched->jobs[edge & ~BOOT_EDGE_DEPEND];
+        if (next->started) {
+            continue;
+        }
+        // a failed tier or lane neighbour did not stop the serial boot either, only 'depends' propagates
+        if ((job->result != HDF_SUCCESS) && ((edge & BOOT_EDGE_DEPEND) != 0) &&
+            (next->failedProvider == BOOT_JOB_NONE)) {
+            next->failedProvider = done;
+        }
+        if ((next->pending > 0) && (--next->pending == 0)) {
+            DevmgrBootPushReady(sched, edge & ~BOOT_EDGE_DEPEND);
+        }
+    }
+    DevmgrBootWake(sched, (sched->remaining == 0) ? sched->waiting : sched->readyCount);
+}
+
+static void DevmgrBootExecute(const struct DevmgrBootScheduler *sched, struct DevmgrBootJob *job)
+{
+    struct IDevHostService *hostService = job->hostClnt->hostService;
+    HDF_BOOT_TRACE_DECLARE(traceBegin);
+    if (job->deviceInfo == NULL) {
+        return;
+    }
+    if (job->failedProvider != BOOT_JOB_NONE) {
+        // a skipped job fails too, so whatever depends on it is skipped in turn
+        HDF_LOGE("skip driver %s, it depends on %s which failed to load", job->deviceInfo->svcName,
+            sched->jobs[job->failedProvider].deviceInfo->svcName);
+        job->result = HDF_DEV_ERR_NO_DEVICE_SERVICE;
+        return;
+    }
+    if ((hostService == NULL) || (hostService->AddDevice == NULL)) {
+        job->result = HDF_FAILURE;
+        return;
+    }
+    HDF_BOOT_TRACE_BEGIN(traceBegin);
+    job->result = hostService->AddDevice(hostService, job->deviceInfo);
+    HDF_BOOT_TRACE_END(traceBegin, HDF_BOOT_PHASE_LOAD, job->deviceInfo->deviceId, job->deviceInfo->moduleName,
+        job->deviceInfo->svcName, job->result);
+}
+
+static void DevmgrBootWork(struct DevmgrBootScheduler *sched)
+{
+    uint32_t job;
+
+    OsalMutexLock(&sched->mutex);
+    while (sched->remaining > 0) {
+        job = DevmgrBootPopReady(sched);
+        if ((job == BOOT_JOB_NONE) && (sched->running == 0)) {
+            job = DevmgrBootBreakCycle(sched);
+        }
+        if (job == BOOT_JOB_NONE) {
+            // the waker decrements waiting, so each post matches one sleeping worker
+            sched->waiting++;
+            OsalMutexUnlock(&sched->mutex);
+            (void)OsalSemWait(&sched->wakeSem, HDF_WAIT_FOREVER);
+            OsalMutexLock(&sched->mutex);
+            continue;
+        }
+        sched->jobs[job].started = true;
+        sched->running++;
+        OsalMutexUnlock(&sched->mutex);
+        DevmgrBootExecute(sched, &sched->jobs[job]);
+        OsalMutexLock(&sched->mutex);
+        DevmgrBootComplete(sched, job);
+    }
+    OsalMutexUnlock(&sched->mutex);
+}
+
+static int32_t DevmgrBootWorkerThread(void *para)
+{
+    struct DevmgrBootScheduler *sched = (struct DevmgrBootScheduler *)para;
+    DevmgrBootWork(sched);
+    (void)OsalSemPost(&sched->exitSem);
+    return HDF_SUCCESS;
+}
+
+static uint32_t DevmgrBootStartWorkers(struct DevmgrBootScheduler *sched, struct OsalThread *threads,
+    uint32_t count)
+{
+    struct OsalThreadParam param;
+    uint32_t started;
+
+    (void)memset_s(&param, sizeof(param), 0, sizeof(param));
+    param.name = BOOT_WORKER_NAME;
+    param.priority = OSAL_THREAD_PRI_DEFAULT;
+    for (started = 0; started < count; started++) {
+        if (OsalThreadCreate(&threads[started], DevmgrBootWorkerThread, sched) != HDF_SUCCESS) {
+            break;
+        }
+        if (OsalThreadStart(&threads[started], &param) != HDF_SUCCESS) {
+            (void)OsalThreadDestroy(&threads[started]);
+            break;
+        }
+    }
+    return started;
+}
+
+static void DevmgrBootStopWorkers(struct DevmgrBootScheduler *sched, struct OsalThread *threads, uint32_t count)
+{
+    uint32_t i;
+    for (i = 0; i < count; i++) {
+        (void)OsalSemWait(&sched->exitSem, HDF_WAIT_FOREVER);
+    }
+    for (i = 0; i < count; i++) {
+        (void)OsalThreadDestroy(&threads[i]);
+    }
+}
+
+static void DevmgrBootFinish(struct DevmgrBootScheduler *sched)
+{
+    uint32_t i;
+
+    for (i = 0; i < sched->jobCount; i++) {
+        struct DevmgrBootJob *job = &sched->jobs[i];
+        if (job->deviceInfo == NULL) {
+            continue;
+        }
+        if (job->result != HDF_SUCCESS) {
+            if (job->failedProvider == BOOT_JOB_NONE) {
+                HDF_LOGE("failed to install driver %s, ret = %d", job->deviceInfo->svcName, job->result);
+            }
+            continue;
+        }
+#ifndef __USER__
+        HdfSListRemove(&job->hostClnt->unloadDevInfos, &job->deviceInfo->node);
+#endif
+    }
+    OsalMemFree(sched->jobs);
+    OsalMemFree(sched->edges);
+    OsalMemFree(sched->ready);
+    sched->jobs = NULL;
+    sched->edges = NULL;
+    sched->ready = NULL;
+    sched->jobCount = 0;
+    sched->jobCapacity = 0;
+    sched->readyCount = 0;
+}
+
+static void DevmgrBootRunJobs(struct DevmgrBootScheduler *sched)
+{
+    struct OsalThread threads[DEVMGR_BOOT_WORKER_COUNT - 1];
+    uint32_t workerCount = DEVMGR_BOOT_WORKER_COUNT - 1;
+    uint32_t i;
+
+    if (DevmgrBootBuildGraph(sched) != HDF_SUCCESS) {
+        HDF_LOGE("%s: failed to build boot graph, load devices one by one", __func__);
+        for (i = 0; i < sched->jobCount; i++) {
+            DevmgrBootExecute(sched, &sched->jobs[i]);
+        }
+        return;
+    }
+    for (i = 0; i < sched->jobCount; i++) {
+        if (sched->jobs[i].pending == 0) {
+            DevmgrBootPushReady(sched, i);
+        }
+    }
+    sched->remaining = sched->jobCount;
+    if (workerCount > sched->jobCount - 1) {
+        workerCount = sched->jobCount - 1;
+    }
+    // the calling thread works too, so a failure to start workers only costs parallelism
+    workerCount = DevmgrBootStartWorkers(sched, threads, workerCount);
+    DevmgrBootWork(sched);
+    DevmgrBootStopWorkers(sched, threads, workerCount);
+    HDF_LOGI("boot scheduler loaded %u jobs with %u workers", sched->jobCount, workerCount + 1);
+}
+
+int32_t DevmgrBootSchedulerRun(void)
+{
+    struct DevmgrBootScheduler *sched = &g_bootScheduler;
+    uint64_t startTime = OsalGetSysTimeMs();
+
+    if (OsalAtomicRead(&sched->inited) == 0) {
+        return HDF_ERR_NOT_SUPPORT;
+    }
+    OsalMutexLock(&sched->mutex);
+    if (sched->state != BOOT_STATE_COLLECTING) {
+        OsalMutexUnlock(&sched->mutex);
+        return HDF_ERR_NOT_SUPPORT;
+    }
+    // devices of hosts attaching from now on are loaded by their host as before
+    sched->state = BOOT_STATE_RUNNING;
+    OsalMutexUnlock(&sched->mutex);
+
+    if (sched->jobCount > 0) {
+        DevmgrBootRunJobs(sched);
+    }
+    DevmgrBootFinish(sched);
+    HDF_LOGI("boot scheduler done in %llu ms", (unsigned long long)(OsalGetSysTimeMs() - startTime));
+
+    OsalMutexLock(&sched->mutex);
+    sched->state = BOOT_STATE_IDLE;
+    OsalMutexUnlock(&sched->mutex);
+    return HDF_SUCCESS;
+}
@@ -7,8 +7,14 @@
  */
 
 #include "devmgr_service.h"
+#if defined(__KERNEL__)
+#include <linux/sched.h>
+#else
+#include <pthread.h>
+#endif
 #include "devhost_service_clnt.h"
 #include "device_token_clnt.h"
+#include "devmgr_boot_scheduler.h"
 #include "devsvc_manager.h"
 #include "hdf_attribute_manager.h"
 #include "hdf_base.h"
@@ -16,10 +22,27 @@
 #include "hdf_host_info.h"
 #include "hdf_log.h"
 #include "hdf_object_manager.h"
+#include "osal_mem.h"
+#include "osal_sem.h"
 #include "osal_time.h"
 
 #define HDF_LOG_TAG devmgr_service
 
+#if defined(__KERNEL__)
+#define DEVMGR_CURRENT_THREAD() ((uintptr_t)current)
+#else
+#define DEVMGR_CURRENT_THREAD() ((uintptr_t)pthread_self())
+#endif
+
+struct DevmgrLoadRequest {
+    struct DListHead node;
+    const struct HdfDeviceInfo *deviceInfo;
+    uintptr_t loader;    // thread adding the device
+    struct OsalSem done; // posted once per waiter when the load finishes
+    uint32_t waiters;
+    int32_t ret;
+};
+
 static bool DevmgrServiceDynamicDevInfoFound(
     const char *svcName, struct DevHostServiceClnt **targetHostClnt, struct HdfDeviceInfo **targetDeviceInfo)
 {
@@ -81,14 +104,90 @@ static int DevmgrServiceStartHostProcess(struct DevHostServiceClnt *hostClnt, bo
     return HDF_SUCCESS;
 }
 
+static int DevmgrServiceAddDynamicDevice(struct DevHostServiceClnt *hostClnt, struct HdfDeviceInfo *deviceInfo)
+{
+    bool dynamic = HdfSListIsEmpty(&hostClnt->unloadDevInfos) && !HdfSListIsEmpty(&hostClnt->dynamicDevInfos);
+    if (hostClnt->hostPid < 0 && DevmgrServiceStartHostProcess(hostClnt, true, dynamic) != HDF_SUCCESS) {
+        HDF_LOGW("failed to start device host(%s, %u)", hostClnt->hostName, hostClnt->hostId);
+        return HDF_FAILURE;
+    }
+
+    return hostClnt->hostService->AddDevice(hostClnt->hostService, deviceInfo);
+}
+
+static void DevmgrLoadRequestRelease(struct DevmgrLoadRequest *request)
+{
+    (void)OsalSemDestroy(&request->done);
+    OsalMemFree(request);
+}
+
+/*
+ * The first caller loading a device does the work, callers coming meanwhile wait on its completion
+ * and share the result instead of adding the device again. The host adds the device on the loading
+ * thread, so a call from that thread comes from the driver being loaded, from its Init getting its
+ * own service for instance. It would wait for itself and gets HDF_ERR_DEVICE_BUSY instead.
+ */
+static int DevmgrServiceLoadDynamicDevice(struct DevmgrService *devmgr, struct DevHostServiceClnt *hostClnt,
+    struct HdfDeviceInfo *deviceInfo)
+{
+    struct DevmgrLoadRequest *request = NULL;
+    uintptr_t self = DEVMGR_CURRENT_THREAD();
+    int32_t ret;
+
+    OsalMutexLock(&devmgr->loadMutex);
+    DLIST_FOR_EACH_ENTRY(request, &devmgr->loadRequests, struct DevmgrLoadRequest, node) {
+        if (request->deviceInfo == deviceInfo) {
+            if (request->loader == self) {
+                OsalMutexUnlock(&devmgr->loadMutex);
+                HDF_LOGW("%s is requested while it is being loaded", deviceInfo->svcName);
+                return HDF_ERR_DEVICE_BUSY;
+            }
+            request->waiters++;
+            OsalMutexUnlock(&devmgr->loadMutex);
+            (void)OsalSemWait(&request->done, HDF_WAIT_FOREVER);
+            OsalMutexLock(&devmgr->loadMutex);
+            ret = request->ret;
+            if (--request->waiters == 0) {
+                DevmgrLoadRequestRelease(request);
+            }
+            OsalMutexUnlock(&devmgr->loadMutex);
+            return ret;
+        }
+    }
+    request = (struct DevmgrLoadRequest *)OsalMemCalloc(sizeof(*request));
+    if (request == NULL || OsalSemInit(&request->done, 0) != HDF_SUCCESS) {
+        OsalMutexUnlock(&devmgr->loadMutex);
+        OsalMemFree(request);
+        return DevmgrServiceAddDynamicDevice(hostClnt, deviceInfo);
+    }
+    request->deviceInfo = deviceInfo;
+    request->loader = self;
+    DListInsertTail(&request->node, &devmgr->loadRequests);
+    OsalMutexUnlock(&devmgr->loadMutex);
+
+    ret = DevmgrServiceAddDynamicDevice(hostClnt, deviceInfo);
+
+    OsalMutexLock(&devmgr->loadMutex);
+    DListRemove(&request->node);
+    request->ret = ret;
+    if (request->waiters == 0) {
+        DevmgrLoadRequestRelease(request);
+    } else {
+        uint32_t i;
+        for (i = 0; i < request->waiters; i++) {
+            (void)OsalSemPost(&request->done);
+        }
+    }
+    OsalMutexUnlock(&devmgr->loadMutex);
+    return ret;
+}
+
 static int DevmgrServiceLoadDevice(struct IDevmgrService *devMgrSvc, const char *serviceName)
 {
     struct HdfDeviceInfo *deviceInfo = NULL;
     struct DevHostServiceClnt *hostClnt = NULL;
-    bool dynamic = true;
-    (void)devMgrSvc;
 
-    if (serviceName == NULL) {
+    if (serviceName == NULL || devMgrSvc == NULL) {
         return HDF_ERR_INVALID_PARAM;
     }
 
@@ -97,18 +196,28 @@ static int DevmgrServiceLoadDevice(struct IDevmgrService *devMgrSvc, const char
         return HDF_DEV_ERR_NO_DEVICE;
     }
 
-    if (deviceInfo->preload != DEVICE_PRELOAD_DISABLE) {
+    if (!deviceInfo->isDynamic) {
         HDF_LOGE("device %s not an dynamic load device", serviceName);
         return HDF_DEV_ERR_NORANGE;
     }
 
-    dynamic = HdfSListIsEmpty(&hostClnt->unloadDevInfos) && !HdfSListIsEmpty(&hostClnt->dynamicDevInfos);
-    if (hostClnt->hostPid < 0 && DevmgrServiceStartHostProcess(hostClnt, true, dynamic) != HDF_SUCCESS) {
-        HDF_LOGW("failed to start device host(%s, %u)", hostClnt->hostName, hostClnt->hostId);
-        return HDF_FAILURE;
-    }
+    return DevmgrServiceLoadDynamicDevice((struct DevmgrService *)devMgrSvc, hostClnt, deviceInfo);
+}
 
-    return hostClnt->hostService->AddDevice(hostClnt->hostService, deviceInfo);
+int DevmgrServiceLoadOnDemand(struct DevmgrService *devMgrSvc, const char *serviceName)
+{
+    struct HdfDeviceInfo *deviceInfo = NULL;
+    struct DevHostServiceClnt *hostClnt = NULL;
+
+    if (serviceName == NULL || devMgrSvc == NULL) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+    if (!DevmgrServiceDynamicDevInfoFound(serviceName, &hostClnt, &deviceInfo) ||
+        deviceInfo->preload != DEVICE_PRELOAD_ON_DEMAND) {
+        return HDF_DEV_ERR_NO_DEVICE;
+    }
+    HDF_LOGI("load %s on first use", serviceName);
+    return DevmgrServiceLoadDynamicDevice(devMgrSvc, hostClnt, deviceInfo);
 }
 
 static int DevmgrServiceStopHost(struct DevHostServiceClnt *hostClnt)
@@ -134,8 +243,7 @@ static int DevmgrServiceUnloadDevice(struct IDevmgrService *devMgrSvc, const cha
         return HDF_ERR_INVALID_PARAM;
     }
 
-    if (!DevmgrServiceDynamicDevInfoFound(serviceName, &hostClnt, &deviceInfo) ||
-        deviceInfo->preload != DEVICE_PRELOAD_DISABLE) {
+    if (!DevmgrServiceDynamicDevInfoFound(serviceName, &hostClnt, &deviceInfo) || !deviceInfo->isDynamic) {
         HDF_LOGE("device %s not in configed dynamic device list", serviceName);
         return HDF_DEV_ERR_NO_DEVICE;
     }
@@ -217,7 +325,9 @@ static int DevmgrServiceAttachDevice(struct IDevmgrService *inst, struct IHdfDev
         return HDF_FAILURE;
     }
 
+    OsalMutexLock(&((struct DevmgrService *)inst)->devicesMutex);
     HdfSListAdd(&hostClnt->devices, &tokenClnt->node);
+    OsalMutexUnlock(&((struct DevmgrService *)inst)->devicesMutex);
     return HDF_SUCCESS;
 }
 
@@ -238,13 +348,16 @@ static int DevmgrServiceDetachDevice(struct IDevmgrService *inst, devid_t devid)
         HDF_LOGE("failed to attach device, hostClnt is null");
         return HDF_FAILURE;
     }
+    OsalMutexLock(&((struct DevmgrService *)inst)->devicesMutex);
     tokenClntNode = HdfSListSearch(&hostClnt->devices, devid, HdfSListHostSearchDeviceTokenComparer);
     if (tokenClntNode == NULL) {
+        OsalMutexUnlock(&((struct DevmgrService *)inst)->devicesMutex);
         HDF_LOGE("devmgr detach device %x not found", devid);
         return HDF_DEV_ERR_NO_DEVICE;
     }
     tokenClnt = CONTAINER_OF(tokenClntNode, struct DeviceTokenClnt, node);
     HdfSListRemove(&hostClnt->devices, &tokenClnt->node);
+    OsalMutexUnlock(&((struct DevmgrService *)inst)->devicesMutex);
     return HDF_SUCCESS;
 }
 
@@ -265,7 +378,7 @@ static int DevmgrServiceAttachDeviceHost(
     return DevHostServiceClntInstallDriver(hostClnt);
 }
 
-static int DevmgrServiceStartDeviceHost(struct DevmgrService *devmgr, struct HdfHostInfo *hostAttr)
+static int DevmgrServiceCreateDeviceHost(struct DevmgrService *devmgr, struct HdfHostInfo *hostAttr)
 {
     struct DevHostServiceClnt *hostClnt = DevHostServiceClntNewInstance(hostAttr->hostId, hostAttr->hostName);
     if (hostClnt == NULL) {
@@ -279,24 +392,33 @@ static int DevmgrServiceStartDeviceHost(struct DevmgrService *devmgr, struct Hdf
     }
 
     DListInsertTail(&hostClnt->node, &devmgr->hosts);
+    return HDF_SUCCESS;
+}
 
-    // not start the host which only have dynamic devices
-    if (HdfSListIsEmpty(&hostClnt->unloadDevInfos)) {
-        return HDF_SUCCESS;
-    }
+static void DevmgrServiceStartHostProcesses(struct DevmgrService *devmgr)
+{
+    struct DevHostServiceClnt *hostClnt = NULL;
+    struct DevHostServiceClnt *hostClntTmp = NULL;
 
-    if (DevmgrServiceStartHostProcess(hostClnt, false, false) != HDF_SUCCESS) {
-        HDF_LOGW("failed to start device host, host id is %u", hostAttr->hostId);
-        DListRemove(&hostClnt->node);
-        DevHostServiceClntFreeInstance(hostClnt);
-        return HDF_FAILURE;
+    DLIST_FOR_EACH_ENTRY_SAFE(hostClnt, hostClntTmp, &devmgr->hosts, struct DevHostServiceClnt, node) {
+        // not start the host which only have dynamic devices
+        if (HdfSListIsEmpty(&hostClnt->unloadDevInfos)) {
+            continue;
+        }
+
+        if (DevmgrServiceStartHostProcess(hostClnt, false, false) != HDF_SUCCESS) {
+            HDF_LOGW("failed to start device host, host id is %u, host name is '%s'", hostClnt->hostId,
+                hostClnt->hostName);
+            DListRemove(&hostClnt->node);
+            DevHostServiceClntFreeInstance(hostClnt);
+        }
     }
-    return HDF_SUCCESS;
 }
 
 static int DevmgrServiceStartDeviceHosts(struct DevmgrService *inst)
 {
     int ret;
+    bool scheduled = false;
     struct HdfSList hostList;
     struct HdfSListIterator it;
     struct HdfHostInfo *hostAttr = NULL;
@@ -309,12 +431,21 @@ static int DevmgrServiceStartDeviceHosts(struct DevmgrService *inst)
     HdfSListIteratorInit(&it, &hostList);
     while (HdfSListIteratorHasNext(&it)) {
         hostAttr = (struct HdfHostInfo *)HdfSListIteratorNext(&it);
-        ret = DevmgrServiceStartDeviceHost(inst, hostAttr);
+        ret = DevmgrServiceCreateDeviceHost(inst, hostAttr);
         if (ret != HDF_SUCCESS) {
-            HDF_LOGW("%s failed to start device host, host id is %u, host name is '%s'", __func__, hostAttr->hostId,
-                hostAttr->hostName);
+            HDF_LOGW("%s failed to create device host, host id is %u, host name is '%s'", __func__,
+                hostAttr->hostId, hostAttr->hostName);
         }
     }
+
+    // without any 'depends' in the config, devices keep loading one by one in host order
+    if (DevmgrBootSchedulerEnabled(&inst->hosts)) {
+        scheduled = (DevmgrBootSchedulerBegin() == HDF_SUCCESS);
+    }
+    DevmgrServiceStartHostProcesses(inst);
+    if (scheduled) {
+        (void)DevmgrBootSchedulerRun();
+    }
     HdfSListFlush(&hostList, HdfHostInfoDelete);
     return HDF_SUCCESS;
 }
@@ -380,6 +511,19 @@ bool DevmgrServiceConstruct(struct DevmgrService *inst)
         HDF_LOGE("%s:failed to mutex init ", __func__);
         return false;
     }
+    // attach and detach of devices may come from the boot scheduler workers concurrently
+    if (OsalMutexInit(&inst->devicesMutex) != HDF_SUCCESS) {
+        HDF_LOGE("%s:failed to init devices mutex", __func__);
+        (void)OsalMutexDestroy(&inst->devMgrMutex);
+        return false;
+    }
+    if (OsalMutexInit(&inst->loadMutex) != HDF_SUCCESS) {
+        HDF_LOGE("%s:failed to init load mutex", __func__);
+        (void)OsalMutexDestroy(&inst->devicesMutex);
+        (void)OsalMutexDestroy(&inst->devMgrMutex);
+        return false;
+    }
+    DListHeadInit(&inst->loadRequests);
     devMgrSvcIf = (struct IDevmgrService *)inst;
     if (devMgrSvcIf != NULL) {
         devMgrSvcIf->AttachDevice = DevmgrServiceAttachDevice;
@@ -432,4 +576,6 @@ void DevmgrServiceRelease(struct HdfObject *object)
     }
 
     OsalMutexDestroy(&devmgrService->devMgrMutex);
+    OsalMutexDestroy(&devmgrService->devicesMutex);
+    OsalMutexDestroy(&devmgrService->loadMutex);
 }
@@ -9,54 +9,271 @@
 #include "devsvc_manager.h"
 #include "devmgr_service.h"
 #include "hdf_base.h"
+#include "hdf_boot_trace.h"
 #include "hdf_cstring.h"
 #include "hdf_log.h"
 #include "hdf_object_manager.h"
 #include "hdf_service_record.h"
 #include "hdf_device_node.h"
 #include "osal_mem.h"
+#include "securec.h"
 
 #define HDF_LOG_TAG devsvc_manager
 
-static struct DevSvcRecord *DevSvcManagerSearchService(struct IDevSvcManager *inst, uint32_t serviceKey)
+#define DEVSVC_TABLE_MIN_SIZE 16
+#define DEVSVC_READ_RETRY_MAX 4
+#define DEVSVC_LISTENER_INDEX_MIN_SIZE 4
+
+struct DevSvcHashTable {
+    struct DevSvcHashTable *next; /* link on the retired list */
+    uint32_t bucketMask;
+    struct DevSvcRecord *buckets[];
+};
+
+/*
+ * Lookups walk the service table without the mutex. Writers make the sequence odd while they
+ * relink records, readers retry (or fall back to the mutex) when the sequence moved under them.
+ * Records and tables taken out of the table are freed only once no reader is running.
+ * The sequence and reader count change through value returning atomics, which order the
+ * table accesses around them.
+ */
+static OsalAtomic g_devSvcFence = { 0 };
+
+/* The value returning OSAL atomics are full barriers, this is one that leaves no trace. */
+static inline void DevSvcMemoryBarrier(void)
+{
+    (void)OsalAtomicIncReturn(&g_devSvcFence);
+    (void)OsalAtomicDecReturn(&g_devSvcFence);
+}
+
+static void DevSvcManagerWriteBegin(struct DevSvcManager *devSvcManager)
+{
+    (void)OsalAtomicIncReturn(&devSvcManager->seq);
+}
+
+static void DevSvcManagerWriteEnd(struct DevSvcManager *devSvcManager)
+{
+    (void)OsalAtomicIncReturn(&devSvcManager->seq);
+}
+
+static void DevSvcManagerReclaimLocked(struct DevSvcManager *devSvcManager, bool force)
 {
     struct DevSvcRecord *record = NULL;
-    struct DevSvcRecord *searchResult = NULL;
-    struct DevSvcManager *devSvcManager = (struct DevSvcManager *)inst;
-    if (devSvcManager == NULL) {
-        HDF_LOGE("failed to search service, devSvcManager is null");
+    struct DevSvcRecord *tmp = NULL;
+    struct DevSvcHashTable *table = NULL;
+
+    DevSvcMemoryBarrier();
+    if (!force && OsalAtomicRead(&devSvcManager->readers) != 0) {
+        return;
+    }
+    DLIST_FOR_EACH_ENTRY_SAFE(record, tmp, &devSvcManager->retiredServices, struct DevSvcRecord, entry) {
+        DListRemove(&record->entry);
+        DevSvcRecordFreeInstance(record);
+    }
+    while (devSvcManager->retiredTables != NULL) {
+        table = devSvcManager->retiredTables;
+        devSvcManager->retiredTables = table->next;
+        OsalMemFree(table);
+    }
+}
+
+static struct DevSvcRecord *DevSvcManagerLookup(struct DevSvcManager *devSvcManager,
+    uint32_t serviceKey, const char *servName)
+{
+    struct DevSvcHashTable *table = devSvcManager->svcTable;
+    struct DevSvcRecord *record = NULL;
+    uint32_t steps = 0;
+
+    if (table == NULL) {
         return NULL;
     }
+    for (record = table->buckets[serviceKey & table->bucketMask]; record != NULL; record = record->hashNext) {
+        if (record->key == serviceKey && strcmp(record->servName, servName) == 0) {
+            return record;
+        }
+        // a reader racing with a rehash may walk into another chain, never let it run away
+        if (++steps > devSvcManager->svcCount) {
+            break;
+        }
+    }
+    return NULL;
+}
 
-    OsalMutexLock(&devSvcManager->mutex);
+static struct HdfDeviceObject *DevSvcManagerReadObject(struct DevSvcManager *devSvcManager,
+    uint32_t serviceKey, const char *servName)
+{
+    struct HdfDeviceObject *object = NULL;
+    struct DevSvcRecord *record = NULL;
+    int32_t seq;
+    uint32_t retry;
+
+    (void)OsalAtomicIncReturn(&devSvcManager->readers);
+    for (retry = 0; retry < DEVSVC_READ_RETRY_MAX; retry++) {
+        seq = OsalAtomicRead(&devSvcManager->seq);
+        if ((seq & 1) != 0) {
+            continue;
+        }
+        DevSvcMemoryBarrier();
+        record = DevSvcManagerLookup(devSvcManager, serviceKey, servName);
+        object = (record != NULL) ? record->value : NULL;
+        DevSvcMemoryBarrier();
+        if (OsalAtomicRead(&devSvcManager->seq) == seq) {
+            break;
+        }
+    }
+    (void)OsalAtomicDecReturn(&devSvcManager->readers);
+
+    if (retry == DEVSVC_READ_RETRY_MAX) {
+        OsalMutexLock(&devSvcManager->mutex);
+        record = DevSvcManagerLookup(devSvcManager, serviceKey, servName);
+        object = (record != NULL) ? record->value : NULL;
+        OsalMutexUnlock(&devSvcManager->mutex);
+    }
+    return object;
+}
+
+static int32_t DevSvcManagerGrowTableLocked(struct DevSvcManager *devSvcManager)
+{
+    struct DevSvcHashTable *oldTable = devSvcManager->svcTable;
+    struct DevSvcHashTable *table = NULL;
+    struct DevSvcRecord *record = NULL;
+    uint32_t size = DEVSVC_TABLE_MIN_SIZE;
+    uint32_t idx;
+
+    if (oldTable != NULL) {
+        if (devSvcManager->svcCount < oldTable->bucketMask + 1) {
+            return HDF_SUCCESS;
+        }
+        size = (oldTable->bucketMask + 1) * 2;
+    }
+
+    table = (struct DevSvcHashTable *)OsalMemCalloc(sizeof(*table) + size * sizeof(struct DevSvcRecord *));
+    if (table == NULL) {
+        // keep the current table, chains just get longer
+        return (oldTable != NULL) ? HDF_SUCCESS : HDF_ERR_MALLOC_FAIL;
+    }
+    table->bucketMask = size - 1;
+
+    DevSvcManagerWriteBegin(devSvcManager);
     DLIST_FOR_EACH_ENTRY(record, &devSvcManager->services, struct DevSvcRecord, entry) {
-        if (record->key == serviceKey) {
-            searchResult = record;
+        idx = record->key & table->bucketMask;
+        record->hashNext = table->buckets[idx];
+        table->buckets[idx] = record;
+    }
+    devSvcManager->svcTable = table;
+    DevSvcManagerWriteEnd(devSvcManager);
+
+    if (oldTable != NULL) {
+        oldTable->next = devSvcManager->retiredTables;
+        devSvcManager->retiredTables = oldTable;
+    }
+    return HDF_SUCCESS;
+}
+
+static void DevSvcManagerUnlinkLocked(struct DevSvcManager *devSvcManager, struct DevSvcRecord *record)
+{
+    struct DevSvcRecord **link = &devSvcManager->svcTable->buckets[record->key & devSvcManager->svcTable->bucketMask];
+
+    while (*link != NULL && *link != record) {
+        link = &(*link)->hashNext;
+    }
+    if (*link != NULL) {
+        *link = record->hashNext;
+    }
+    DListRemove(&record->entry);
+    devSvcManager->svcCount--;
+}
+
+static void DevSvcListenerIndexRemove(struct DevSvcManager *devSvcManager, struct ServStatListenerHolder *holder)
+{
+    struct DevSvcListenerIndex *index = NULL;
+    uint32_t i;
+    uint32_t pos;
+
+    for (i = 0; i < DEVSVC_CLASS_COUNT; i++) {
+        index = &devSvcManager->listenerIndex[i];
+        for (pos = 0; pos < index->count; pos++) {
+            if (index->holders[pos] != holder) {
+                continue;
+            }
+            // keep the registration order of the rest
+            for (; pos + 1 < index->count; pos++) {
+                index->holders[pos] = index->holders[pos + 1];
+            }
+            index->count--;
             break;
         }
     }
-    OsalMutexUnlock(&devSvcManager->mutex);
-    return searchResult;
+}
+
+static int32_t DevSvcListenerIndexAdd(struct DevSvcManager *devSvcManager, struct ServStatListenerHolder *holder)
+{
+    struct DevSvcListenerIndex *index = NULL;
+    struct ServStatListenerHolder **holders = NULL;
+    uint32_t capacity;
+    uint32_t i;
+
+    for (i = 0; i < DEVSVC_CLASS_COUNT; i++) {
+        if ((holder->listenClass & (1U << i)) == 0) {
+            continue;
+        }
+        index = &devSvcManager->listenerIndex[i];
+        if (index->count == index->capacity) {
+            capacity = (index->capacity == 0) ? DEVSVC_LISTENER_INDEX_MIN_SIZE : index->capacity * 2;
+            holders = (struct ServStatListenerHolder **)OsalMemCalloc(capacity * sizeof(*holders));
+            if (holders == NULL) {
+                DevSvcListenerIndexRemove(devSvcManager, holder);
+                return HDF_ERR_MALLOC_FAIL;
+            }
+            if (index->count > 0 && memcpy_s(holders, capacity * sizeof(*holders),
+                index->holders, index->count * sizeof(*holders)) != EOK) {
+                OsalMemFree(holders);
+                DevSvcListenerIndexRemove(devSvcManager, holder);
+                return HDF_FAILURE;
+            }
+            OsalMemFree(index->holders);
+            index->holders = holders;
+            index->capacity = capacity;
+        }
+        index->holders[index->count++] = holder;
+    }
+    return HDF_SUCCESS;
 }
 
 static void NotifyServiceStatusLocked(struct DevSvcManager *devSvcManager,
     struct DevSvcRecord *record, uint32_t status)
 {
     struct ServStatListenerHolder *holder = NULL;
-    struct ServStatListenerHolder *tmp = NULL;
+    struct DevSvcListenerIndex *index = NULL;
     struct ServiceStatus svcstat = {
         .deviceClass = record->devClass,
         .serviceName = record->servName,
         .status = status,
         .info = record->servInfo,
     };
-    DLIST_FOR_EACH_ENTRY_SAFE(holder, tmp, &devSvcManager->svcstatListeners, struct ServStatListenerHolder, node) {
-        if ((holder->listenClass & record->devClass) && holder->NotifyStatus != NULL) {
-            if (holder->NotifyStatus(holder, &svcstat) == HDF_FAILURE) {
-                DListRemove(&holder->node);
-                if (holder->Recycle != NULL) {
-                    holder->Recycle(holder);
-                }
+    uint32_t i;
+    uint32_t pos;
+
+    for (i = 0; i < DEVSVC_CLASS_COUNT; i++) {
+        if ((record->devClass & (1U << i)) == 0) {
+            continue;
+        }
+        index = &devSvcManager->listenerIndex[i];
+        for (pos = 0; pos < index->count;) {
+            holder = index->holders[pos];
+            // listeners of several classes of the record are notified once, under the lowest one
+            if ((holder->listenClass & record->devClass & ((1U << i) - 1)) != 0 || holder->NotifyStatus == NULL) {
+                pos++;
+                continue;
+            }
+            if (holder->NotifyStatus(holder, &svcstat) != HDF_FAILURE) {
+                pos++;
+                continue;
+            }
+            DListRemove(&holder->node);
+            DevSvcListenerIndexRemove(devSvcManager, holder);
+            if (holder->Recycle != NULL) {
+                holder->Recycle(holder);
             }
         }
     }
@@ -82,29 +299,37 @@ static void NotifyServiceStatusOnRegisterLocked(struct DevSvcManager *devSvcMana
     }
 }
 
-int DevSvcManagerAddService(struct IDevSvcManager *inst, const char *servName,
+static int DevSvcManagerAddRecord(struct IDevSvcManager *inst, const char *servName,
     uint16_t devClass, struct HdfDeviceObject *service, const char *servInfo)
 {
     struct DevSvcManager *devSvcManager = (struct DevSvcManager *)inst;
     struct DevSvcRecord *record = NULL;
+    struct DevSvcRecord *exist = NULL;
+    uint32_t serviceKey;
+    uint32_t idx;
     if (devSvcManager == NULL || service == NULL || servName == NULL) {
         HDF_LOGE("failed to add service, input param is null");
         return HDF_FAILURE;
     }
-    record = DevSvcManagerSearchService(inst, HdfStringMakeHashKey(servName, 0));
+    serviceKey = HdfStringMakeHashKey(servName, 0);
+    OsalMutexLock(&devSvcManager->mutex);
+    record = DevSvcManagerLookup(devSvcManager, serviceKey, servName);
     if (record != NULL) {
         HDF_LOGI("%s:add service %s exist, only update value", __func__, servName);
         // on service died will release old service object
         record->value = service;
+        OsalMutexUnlock(&devSvcManager->mutex);
         return HDF_SUCCESS;
     }
+    OsalMutexUnlock(&devSvcManager->mutex);
+
     record = DevSvcRecordNewInstance();
     if (record == NULL) {
         HDF_LOGE("failed to add service , record is null");
         return HDF_FAILURE;
     }
 
-    record->key = HdfStringMakeHashKey(servName, 0);
+    record->key = serviceKey;
     record->value = service;
     record->devClass = devClass;
     record->servName = HdfStringCopy(servName);
@@ -114,12 +339,43 @@ int DevSvcManagerAddService(struct IDevSvcManager *inst, const char *servName,
         return HDF_ERR_MALLOC_FAIL;
     }
     OsalMutexLock(&devSvcManager->mutex);
+    exist = DevSvcManagerLookup(devSvcManager, serviceKey, servName);
+    if (exist != NULL) {
+        // added by someone else meanwhile
+        exist->value = service;
+        OsalMutexUnlock(&devSvcManager->mutex);
+        DevSvcRecordFreeInstance(record);
+        return HDF_SUCCESS;
+    }
+    if (DevSvcManagerGrowTableLocked(devSvcManager) != HDF_SUCCESS) {
+        OsalMutexUnlock(&devSvcManager->mutex);
+        DevSvcRecordFreeInstance(record);
+        return HDF_ERR_MALLOC_FAIL;
+    }
+    idx = serviceKey & devSvcManager->svcTable->bucketMask;
+    record->hashNext = devSvcManager->svcTable->buckets[idx];
+    DevSvcManagerWriteBegin(devSvcManager);
+    devSvcManager->svcTable->buckets[idx] = record;
+    devSvcManager->svcCount++;
+    DevSvcManagerWriteEnd(devSvcManager);
     DListInsertTail(&record->entry, &devSvcManager->services);
     NotifyServiceStatusLocked(devSvcManager, record, SERVIE_STATUS_START);
+    DevSvcManagerReclaimLocked(devSvcManager, false);
     OsalMutexUnlock(&devSvcManager->mutex);
     return HDF_SUCCESS;
 }
 
+int DevSvcManagerAddService(struct IDevSvcManager *inst, const char *servName,
+    uint16_t devClass, struct HdfDeviceObject *service, const char *servInfo)
+{
+    int ret;
+    HDF_BOOT_TRACE_DECLARE(traceBegin);
+    HDF_BOOT_TRACE_BEGIN(traceBegin);
+    ret = DevSvcManagerAddRecord(inst, servName, devClass, service, servInfo);
+    HDF_BOOT_TRACE_END(traceBegin, HDF_BOOT_PHASE_ADD_SERVICE, HDF_BOOT_TRACE_NO_DEVICE, NULL, servName, ret);
+    return ret;
+}
+
 int DevSvcManagerUpdateService(struct IDevSvcManager *inst, const char *servName,
     uint16_t devClass, struct HdfDeviceObject *service, const char *servInfo)
 {
@@ -131,23 +387,28 @@ int DevSvcManagerUpdateService(struct IDevSvcManager *inst, const char *servName
         return HDF_FAILURE;
     }
 
-    record = DevSvcManagerSearchService(inst, HdfStringMakeHashKey(servName, 0));
-    if (record == NULL) {
-        return HDF_DEV_ERR_NO_DEVICE;
-    }
-
     if (servInfo != NULL) {
         servInfoStr = HdfStringCopy(servInfo);
         if (servInfoStr == NULL) {
             return HDF_ERR_MALLOC_FAIL;
         }
+    }
+
+    OsalMutexLock(&devSvcManager->mutex);
+    record = DevSvcManagerLookup(devSvcManager, HdfStringMakeHashKey(servName, 0), servName);
+    if (record == NULL) {
+        OsalMutexUnlock(&devSvcManager->mutex);
+        OsalMemFree(servInfoStr);
+        return HDF_DEV_ERR_NO_DEVICE;
+    }
+
+    if (servInfoStr != NULL) {
         OsalMemFree((char *)record->servInfo);
         record->servInfo = servInfoStr;
     }
 
     record->value = service;
     record->devClass = devClass;
-    OsalMutexLock(&devSvcManager->mutex);
     NotifyServiceStatusLocked(devSvcManager, record, SERVIE_STATUS_CHANGE);
     OsalMutexUnlock(&devSvcManager->mutex);
     return HDF_SUCCESS;
@@ -176,36 +437,37 @@ void DevSvcManagerRemoveService(struct IDevSvcManager *inst, const char *svcName
 {
     struct DevSvcManager *devSvcManager = (struct DevSvcManager *)inst;
     struct DevSvcRecord *serviceRecord = NULL;
-    uint32_t serviceKey = HdfStringMakeHashKey(svcName, 0);
 
     if (svcName == NULL || devSvcManager == NULL) {
         return;
     }
-    serviceRecord = DevSvcManagerSearchService(inst, serviceKey);
+    OsalMutexLock(&devSvcManager->mutex);
+    serviceRecord = DevSvcManagerLookup(devSvcManager, HdfStringMakeHashKey(svcName, 0), svcName);
     if (serviceRecord == NULL) {
+        OsalMutexUnlock(&devSvcManager->mutex);
         return;
     }
-    OsalMutexLock(&devSvcManager->mutex);
     NotifyServiceStatusLocked(devSvcManager, serviceRecord, SERVIE_STATUS_STOP);
-    DListRemove(&serviceRecord->entry);
+    DevSvcManagerWriteBegin(devSvcManager);
+    DevSvcManagerUnlinkLocked(devSvcManager, serviceRecord);
+    DevSvcManagerWriteEnd(devSvcManager);
+    DListInsertTail(&serviceRecord->entry, &devSvcManager->retiredServices);
+    DevSvcManagerReclaimLocked(devSvcManager, false);
     OsalMutexUnlock(&devSvcManager->mutex);
-
-    DevSvcRecordFreeInstance(serviceRecord);
 }
 
 struct HdfDeviceObject *DevSvcManagerGetObject(struct IDevSvcManager *inst, const char *svcName)
 {
-    uint32_t serviceKey = HdfStringMakeHashKey(svcName, 0);
-    struct DevSvcRecord *serviceRecord = NULL;
+    struct DevSvcManager *devSvcManager = (struct DevSvcManager *)inst;
     if (svcName == NULL) {
         HDF_LOGE("Get service failed, svcName is null");
         return NULL;
     }
-    serviceRecord = DevSvcManagerSearchService(inst, serviceKey);
-    if (serviceRecord != NULL) {
-        return serviceRecord->value;
+    if (devSvcManager == NULL) {
+        HDF_LOGE("failed to search service, devSvcManager is null");
+        return NULL;
     }
-    return NULL;
+    return DevSvcManagerReadObject(devSvcManager, HdfStringMakeHashKey(svcName, 0), svcName);
 }
 
 // only use for kernel space
@@ -230,6 +492,11 @@ void DevSvcManagerListService(struct HdfSBuf *serviceNameSet, DeviceClass device
 struct HdfObject *DevSvcManagerGetService(struct IDevSvcManager *inst, const char *svcName)
 {
     struct HdfDeviceObject *deviceObject = DevSvcManagerGetObject(inst, svcName);
+    if (deviceObject == NULL && svcName != NULL &&
+        DevmgrServiceLoadOnDemand((struct DevmgrService *)DevmgrServiceGetInstance(), svcName) == HDF_SUCCESS) {
+        // the device publishes its service while it is added, so it is there once the load returns
+        deviceObject = DevSvcManagerGetObject(inst, svcName);
+    }
     if (deviceObject == NULL) {
         return NULL;
     }
@@ -245,6 +512,10 @@ int DevSvcManagerRegsterServListener(struct IDevSvcManager *inst,
     }
 
     OsalMutexLock(&devSvcManager->mutex);
+    if (DevSvcListenerIndexAdd(devSvcManager, listenerHolder) != HDF_SUCCESS) {
+        OsalMutexUnlock(&devSvcManager->mutex);
+        return HDF_ERR_MALLOC_FAIL;
+    }
     DListInsertTail(&listenerHolder->node, &devSvcManager->svcstatListeners);
     NotifyServiceStatusOnRegisterLocked(devSvcManager, listenerHolder);
     OsalMutexUnlock(&devSvcManager->mutex);
@@ -262,6 +533,26 @@ void DevSvcManagerUnregsterServListener(struct IDevSvcManager *inst,
 
     OsalMutexLock(&devSvcManager->mutex);
     DListRemove(&listenerHolder->node);
+    DevSvcListenerIndexRemove(devSvcManager, listenerHolder);
+    OsalMutexUnlock(&devSvcManager->mutex);
+}
+
+void DevSvcManagerUpdateServListener(struct IDevSvcManager *inst,
+    struct ServStatListenerHolder *listenerHolder, uint16_t listenClass)
+{
+    struct DevSvcManager *devSvcManager = (struct DevSvcManager *)inst;
+    if (devSvcManager == NULL || listenerHolder == NULL) {
+        return;
+    }
+
+    OsalMutexLock(&devSvcManager->mutex);
+    listenerHolder->listenClass = listenClass;
+    if (listenerHolder->node.next != NULL) {
+        DevSvcListenerIndexRemove(devSvcManager, listenerHolder);
+        if (DevSvcListenerIndexAdd(devSvcManager, listenerHolder) != HDF_SUCCESS) {
+            HDF_LOGE("failed to index service status listener of class %x", listenClass);
+        }
+    }
     OsalMutexUnlock(&devSvcManager->mutex);
 }
 
@@ -288,6 +579,9 @@ bool DevSvcManagerConstruct(struct DevSvcManager *inst)
     }
     DListHeadInit(&inst->services);
     DListHeadInit(&inst->svcstatListeners);
+    DListHeadInit(&inst->retiredServices);
+    OsalAtomicSet(&inst->seq, 0);
+    OsalAtomicSet(&inst->readers, 0);
     return true;
 }
 
@@ -332,9 +626,17 @@ void DevSvcManagerRelease(struct IDevSvcManager *inst)
     }
     struct DevSvcRecord *record = NULL;
     struct DevSvcRecord *tmp = NULL;
+    uint32_t i;
     DLIST_FOR_EACH_ENTRY_SAFE(record, tmp, &devSvcManager->services, struct DevSvcRecord, entry) {
         DevSvcRecordFreeInstance(record);
     }
+    DevSvcManagerReclaimLocked(devSvcManager, true);
+    OsalMemFree(devSvcManager->svcTable);
+    devSvcManager->svcTable = NULL;
+    for (i = 0; i < DEVSVC_CLASS_COUNT; i++) {
+        OsalMemFree(devSvcManager->listenerIndex[i].holders);
+        devSvcManager->listenerIndex[i].holders = NULL;
+    }
     OsalMutexDestroy(&devSvcManager->mutex);
 }
 
@@ -51,7 +51,7 @@ static int32_t DevSvcManagerExtRegisterListener(struct HdfDeviceIoClient *client
     holder = ServStatListenerHolderGet((uintptr_t)client);
     if (holder != NULL) {
         HDF_LOGE("%s:register listener exist, update and return", __func__);
-        holder->listenClass = devClass;
+        DevSvcManagerUpdateServListener(&svcmgrInst->super.super, holder, devClass);
         return HDF_SUCCESS;
     }
 
@@ -6,20 +6,122 @@
  * See the LICENSE file in the root of this repository for complete details.
  */
 
+#include "hdf_cstring.h"
 #include "hdf_dlist.h"
 #include "hdf_driver.h"
 #include "hdf_log.h"
 #include "osal_mem.h"
+#include "osal_mutex.h"
 #include "osal_sysevent.h"
 
+#define HDF_LOG_TAG driver_manager
+
+#define DRIVER_TABLE_MIN_SIZE 64
+
+/*
+ * Registered drivers stay on the list in registration order, the hash table over moduleName
+ * only indexes them. Registration runs from the driver loader construction at boot and from
+ * module init of dynamically loaded drivers, lookups from every device that is added.
+ */
+struct HdfDriverRegistry {
+    struct DListHead drivers;
+    struct OsalMutex mutex;
+    struct HdfDriver **buckets;
+    uint32_t bucketMask;
+    uint32_t count;
+};
+
+static struct HdfDriverRegistry *HdfDriverRegistryGet(void)
+{
+    static struct HdfDriverRegistry registry = {0};
+    // first called by the driver loader construction, before anything else may run concurrently
+    if (registry.drivers.next == NULL) {
+        if (OsalMutexInit(&registry.mutex) != HDF_SUCCESS) {
+            HDF_LOGE("%s: failed to init driver registry mutex", __func__);
+        }
+        DListHeadInit(&registry.drivers);
+    }
+
+    return &registry;
+}
+
 static struct DListHead *HdfDriverHead(void)
 {
-    static struct DListHead driverHead = {0};
-    if (driverHead.next == NULL) {
-        DListHeadInit(&driverHead);
+    return &HdfDriverRegistryGet()->drivers;
+}
+
+/* Keeps chains in registration order, so a duplicated moduleName resolves to the first driver. */
+static void HdfDriverRegistryLink(struct HdfDriverRegistry *registry, struct HdfDriver *driver)
+{
+    struct HdfDriver **link = &registry->buckets[driver->hashKey & registry->bucketMask];
+    while (*link != NULL) {
+        link = &(*link)->hashNext;
     }
+    driver->hashNext = NULL;
+    *link = driver;
+}
 
-    return &driverHead;
+static void HdfDriverRegistryUnlink(struct HdfDriverRegistry *registry, struct HdfDriver *driver)
+{
+    struct HdfDriver **link = NULL;
+    if (registry->buckets == NULL) {
+        return;
+    }
+    link = &registry->buckets[driver->hashKey & registry->bucketMask];
+    while (*link != NULL && *link != driver) {
+        link = &(*link)->hashNext;
+    }
+    if (*link != NULL) {
+        *link = driver->hashNext;
+    }
+}
+
+/* Returns true if the table was rebuilt, which links every driver on the list. */
+static bool HdfDriverRegistryGrow(struct HdfDriverRegistry *registry)
+{
+    struct HdfDriver **buckets = NULL;
+    struct HdfDriver *driver = NULL;
+    uint32_t size = DRIVER_TABLE_MIN_SIZE;
+
+    if (registry->buckets != NULL) {
+        if (registry->count <= registry->bucketMask + 1) {
+            return false;
+        }
+        size = (registry->bucketMask + 1) * 2;
+    }
+    buckets = (struct HdfDriver **)OsalMemCalloc(size * sizeof(struct HdfDriver *));
+    if (buckets == NULL) {
+        // keep the current table, chains just get longer
+        return false;
+    }
+    OsalMemFree(registry->buckets);
+    registry->buckets = buckets;
+    registry->bucketMask = size - 1;
+    DLIST_FOR_EACH_ENTRY(driver, &registry->drivers, struct HdfDriver, node) {
+        HdfDriverRegistryLink(registry, driver);
+    }
+    return true;
+}
+
+static void HdfDriverRegistryAdd(struct HdfDriver *driver)
+{
+    struct HdfDriverRegistry *registry = HdfDriverRegistryGet();
+
+    driver->hashKey = HdfStringMakeHashKey(driver->entry->moduleName, 0);
+    OsalMutexLock(&registry->mutex);
+    DListInsertTail(&driver->node, &registry->drivers);
+    registry->count++;
+    if (!HdfDriverRegistryGrow(registry) && registry->buckets != NULL) {
+        HdfDriverRegistryLink(registry, driver);
+    }
+    OsalMutexUnlock(&registry->mutex);
+}
+
+static void HdfDriverRegistryRemove(struct HdfDriverRegistry *registry, struct HdfDriver *driver)
+{
+    HdfDriverRegistryUnlink(registry, driver);
+    DListRemove(&driver->node);
+    registry->count--;
 }
 
 int32_t HdfRegisterDriverEntry(const struct HdfDriverEntry *entry)
@@ -37,14 +139,14 @@ int32_t HdfRegisterDriverEntry(const struct HdfDriverEntry *entry)
 
     newDriver->entry = entry;
 
-    DListInsertTail(&newDriver->node, HdfDriverHead());
+    HdfDriverRegistryAdd(newDriver);
 
     return HDF_SUCCESS;
 }
 
 int32_t HdfUnregisterDriverEntry(const struct HdfDriverEntry *entry)
 {
-    struct DListHead *driverHead = NULL;
+    struct HdfDriverRegistry *registry = NULL;
     struct HdfDriver *driver = NULL;
     struct HdfDriver *tmp = NULL;
 
@@ -52,14 +154,16 @@ int32_t HdfUnregisterDriverEntry(const struct HdfDriverEntry *entry)
         return HDF_ERR_INVALID_OBJECT;
     }
 
-    driverHead = HdfDriverHead();
-    DLIST_FOR_EACH_ENTRY_SAFE(driver, tmp, driverHead, struct HdfDriver, node) {
+    registry = HdfDriverRegistryGet();
+    OsalMutexLock(&registry->mutex);
+    DLIST_FOR_EACH_ENTRY_SAFE(driver, tmp, &registry->drivers, struct HdfDriver, node) {
         if (driver->entry == entry) {
-            DListRemove(&driver->node);
+            HdfDriverRegistryRemove(registry, driver);
             OsalMemFree(driver);
             break;
         }
     }
+    OsalMutexUnlock(&registry->mutex);
 
     return HDF_SUCCESS;
 }
@@ -70,13 +174,14 @@ int32_t HdfRegisterDriver(struct HdfDriver *driver)
         return HDF_ERR_INVALID_OBJECT;
     }
 
-    DListInsertTail(&driver->node, HdfDriverHead());
+    driver->hashNext = NULL;
+    HdfDriverRegistryAdd(driver);
     return HDF_SUCCESS;
 }
 
 int32_t HdfUnregisterDriver(struct HdfDriver *driver)
 {
-    struct DListHead *driverHead = NULL;
+    struct HdfDriverRegistry *registry = NULL;
     struct HdfDriver *it = NULL;
     struct HdfDriver *tmp = NULL;
 
@@ -84,30 +189,44 @@ int32_t HdfUnregisterDriver(struct HdfDriver *driver)
         return HDF_ERR_INVALID_PARAM;
     }
 
-    driverHead = HdfDriverHead();
-    DLIST_FOR_EACH_ENTRY_SAFE(it, tmp, driverHead, struct HdfDriver, node) {
+    registry = HdfDriverRegistryGet();
+    OsalMutexLock(&registry->mutex);
+    DLIST_FOR_EACH_ENTRY_SAFE(it, tmp, &registry->drivers, struct HdfDriver, node) {
         if (it == driver) {
-            DListRemove(&it->node);
+            HdfDriverRegistryRemove(registry, it);
             break;
         }
     }
+    OsalMutexUnlock(&registry->mutex);
 
     return HDF_SUCCESS;
 }
 
 static struct HdfDriver *HdfDriverManagerFoundDriver(const char *driverName)
 {
-    struct DListHead *driverHead = NULL;
+    struct HdfDriverRegistry *registry = HdfDriverRegistryGet();
     struct HdfDriver *driver = NULL;
-    driverHead = HdfDriverHead();
-    DLIST_FOR_EACH_ENTRY(driver, driverHead, struct HdfDriver, node) {
-        if (driver->entry != NULL && driver->entry->moduleName != NULL &&
-            !strcmp(driver->entry->moduleName, driverName)) {
-            return driver;
+    uint32_t hashKey = HdfStringMakeHashKey(driverName, 0);
+
+    OsalMutexLock(&registry->mutex);
+    if (registry->buckets == NULL) {
+        // no table could be allocated yet, fall back to the list
+        DLIST_FOR_EACH_ENTRY(driver, &registry->drivers, struct HdfDriver, node) {
+            if (strcmp(driver->entry->moduleName, driverName) == 0) {
+                OsalMutexUnlock(&registry->mutex);
+                return driver;
+            }
         }
+        driver = NULL;
+    } else {
+        driver = registry->buckets[hashKey & registry->bucketMask];
     }
+    while (driver != NULL && (driver->hashKey != hashKey || strcmp(driver->entry->moduleName, driverName) != 0)) {
+        driver = driver->hashNext;
+    }
+    OsalMutexUnlock(&registry->mutex);
 
-    return NULL;
+    return driver;
 }
 
 struct HdfDriver *HdfDriverManagerGetDriver(const char *driverName)
@@ -0,0 +1,218 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ *
+ * HDF is dual licensed: you can use it either under the terms of
+ * the GPL, or the BSD license, at your option.
+ * See the LICENSE file in the root of this repository for complete details.
+ */
+
+#include <atomic>
+#include <cstring>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include "devhost_service_if.h"
+#include "devmgr_boot_scheduler.h"
+#include "hdf_base.h"
+#include "hdf_device.h"
+
+using namespace testing::ext;
+
+static const uint16_t BOOT_TEST_HOST_ID = 1;
+static const uint16_t BOOT_TEST_PRIORITY = 100;
+static const uint16_t BOOT_TEST_LATER_PRIORITY = 200;
+static const int BOOT_TEST_LOAD_MS = 2;
+static const char *BOOT_TEST_FAIL_PREFIX = "fail_";
+
+struct BootTestRecord {
+    int loads = 0;
+    int startSeq = 0;
+    int endSeq = 0;
+};
+
+static std::mutex g_recordLock;
+static std::map<std::string, BootTestRecord> g_records;
+static std::atomic<int> g_bootSeq(0);
+
+static int BootTestAddDevice(struct IDevHostService *hostService, const struct HdfDeviceInfo *devInfo)
+{
+    (void)hostService;
+    int startSeq = ++g_bootSeq;
+    // give a dependent running too early the chance to overlap its provider
+    std::this_thread::sleep_for(std::chrono::milliseconds(BOOT_TEST_LOAD_MS));
+    std::lock_guard<std::mutex> lock(g_recordLock);
+    BootTestRecord &record = g_records[devInfo->svcName];
+    record.loads++;
+    record.startSeq = startSeq;
+    record.endSeq = ++g_bootSeq;
+    return (strncmp(devInfo->svcName, BOOT_TEST_FAIL_PREFIX, strlen(BOOT_TEST_FAIL_PREFIX)) == 0) ?
+        HDF_FAILURE : HDF_SUCCESS;
+}
+
+class HdfBootSchedulerTest : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        g_records.clear();
+        g_bootSeq = 0;
+        hostService_.AddDevice = BootTestAddDevice;
+        hostClnt_.hostService = &hostService_;
+        HdfSListInit(&hostClnt_.unloadDevInfos);
+    }
+    void TearDown() override
+    {
+        for (auto device : devices_) {
+            delete device;
+        }
+        devices_.clear();
+    }
+
+    // devices are queued in the order of the calls, so keep the priorities of one host ascending
+    void AddDevice(const char *svcName, uint16_t priority, std::vector<const char *> depends)
+    {
+        auto device = new BootTestDevice();
+        device->depends = depends;
+        device->info.deviceId = MK_DEVID(BOOT_TEST_HOST_ID, static_cast<uint32_t>(devices_.size()), 0);
+        device->info.priority = priority;
+        device->info.preload = DEVICE_PRELOAD_ENABLE;
+        device->info.moduleName = svcName;
+        device->info.svcName = svcName;
+        device->info.depends = device->depends.empty() ? nullptr : device->depends.data();
+        device->info.dependCount = static_cast<uint16_t>(device->depends.size());
+        devices_.push_back(device);
+        queued_.push_back(&device->info);
+    }
+
+    void RunQueued()
+    {
+        ASSERT_EQ(DevmgrBootSchedulerBegin(), HDF_SUCCESS);
+        for (auto deviceInfo : queued_) {
+            ASSERT_TRUE(DevmgrBootSchedulerAddDevice(&hostClnt_, deviceInfo));
+        }
+        ASSERT_EQ(DevmgrBootSchedulerRun(), HDF_SUCCESS);
+    }
+
+    void Run()
+    {
+        RunQueued();
+        for (auto device : devices_) {
+            ASSERT_EQ(g_records[device->info.svcName].loads, 1) << device->info.svcName;
+        }
+    }
+
+    static bool LoadedBefore(const char *provider, const char *dependent)
+    {
+        return g_records[provider].endSeq < g_records[dependent].startSeq;
+    }
+
+private:
+    struct BootTestDevice {
+        struct HdfDeviceInfo info = {};
+        std::vector<const char *> depends;
+    };
+    struct IDevHostService hostService_ = {};
+    struct DevHostServiceClnt hostClnt_ = {};
+    std::vector<BootTestDevice *> devices_;
+    std::vector<struct HdfDeviceInfo *> queued_;
+};
+
+/**
+  * @tc.name: HdfBootSchedulerChain001
+  * @tc.desc: a chain declared in reverse loads from its end
+  * @tc.type: FUNC
+  * @tc.require:
+  */
+HWTEST_F(HdfBootSchedulerTest, HdfBootSchedulerChain001, TestSize.Level1)
+{
+    AddDevice("chain_c", BOOT_TEST_PRIORITY, { "chain_b" });
+    AddDevice("chain_b", BOOT_TEST_PRIORITY, { "chain_a" });
+    AddDevice("chain_a", BOOT_TEST_PRIORITY, {});
+    Run();
+    EXPECT_TRUE(LoadedBefore("chain_a", "chain_b"));
+    EXPECT_TRUE(LoadedBefore("chain_b", "chain_c"));
+}
+
+/**
+  * @tc.name: HdfBootSchedulerFanIn002
+  * @tc.desc: a device with several providers waits for all of them
+  * @tc.type: FUNC
+  * @tc.require:
+  */
+HWTEST_F(HdfBootSchedulerTest, HdfBootSchedulerFanIn002, TestSize.Level1)
+{
+    AddDevice("fan_sink", BOOT_TEST_PRIORITY, { "fan_a", "fan_b", "fan_c" });
+    AddDevice("fan_a", BOOT_TEST_PRIORITY, {});
+    AddDevice("fan_b", BOOT_TEST_PRIORITY, {});
+    AddDevice("fan_c", BOOT_TEST_PRIORITY, {});
+    Run();
+    EXPECT_TRUE(LoadedBefore("fan_a", "fan_sink"));
+    EXPECT_TRUE(LoadedBefore("fan_b", "fan_sink"));
+    EXPECT_TRUE(LoadedBefore("fan_c", "fan_sink"));
+}
+
+/**
+  * @tc.name: HdfBootSchedulerCycle003
+  * @tc.desc: devices depending on each other are still loaded once each
+  * @tc.type: FUNC
+  * @tc.require:
+  */
+HWTEST_F(HdfBootSchedulerTest, HdfBootSchedulerCycle003, TestSize.Level1)
+{
+    AddDevice("cycle_c", BOOT_TEST_PRIORITY, { "cycle_d" });
+    AddDevice("cycle_d", BOOT_TEST_PRIORITY, { "cycle_c" });
+    Run();
+}
+
+/**
+  * @tc.name: HdfBootSchedulerDependOnCycle004
+  * @tc.desc: the cycle is broken on the cycle, not at an earlier device waiting for it
+  * @tc.type: FUNC
+  * @tc.require:
+  */
+HWTEST_F(HdfBootSchedulerTest, HdfBootSchedulerDependOnCycle004, TestSize.Level1)
+{
+    AddDevice("cycle_x", BOOT_TEST_PRIORITY, { "cycle_c" });
+    AddDevice("cycle_c", BOOT_TEST_PRIORITY, { "cycle_d" });
+    AddDevice("cycle_d", BOOT_TEST_PRIORITY, { "cycle_c" });
+    Run();
+    EXPECT_TRUE(LoadedBefore("cycle_c", "cycle_x"));
+}
+
+/**
+  * @tc.name: HdfBootSchedulerLaterTier005
+  * @tc.desc: a dependency on a later priority tier of the same host is ignored instead of deadlocking
+  * @tc.type: FUNC
+  * @tc.require:
+  */
+HWTEST_F(HdfBootSchedulerTest, HdfBootSchedulerLaterTier005, TestSize.Level1)
+{
+    AddDevice("tier_early", BOOT_TEST_PRIORITY, { "tier_late" });
+    AddDevice("tier_late", BOOT_TEST_LATER_PRIORITY, {});
+    Run();
+    EXPECT_TRUE(LoadedBefore("tier_early", "tier_late"));
+}
+
+/**
+  * @tc.name: HdfBootSchedulerFailedDepend006
+  * @tc.desc: devices depending on a failed device are not loaded, other devices of the host still are
+  * @tc.type: FUNC
+  * @tc.require:
+  */
+HWTEST_F(HdfBootSchedulerTest, HdfBootSchedulerFailedDepend006, TestSize.Level1)
+{
+    AddDevice("fail_provider", BOOT_TEST_PRIORITY, {});
+    AddDevice("skip_direct", BOOT_TEST_PRIORITY, { "fail_provider" });
+    AddDevice("skip_indirect", BOOT_TEST_PRIORITY, { "skip_direct" });
+    AddDevice("load_sibling", BOOT_TEST_PRIORITY, {});
+    AddDevice("load_later_tier", BOOT_TEST_LATER_PRIORITY, {});
+    RunQueued();
+    EXPECT_EQ(g_records["fail_provider"].loads, 1);
+    EXPECT_EQ(g_records["skip_direct"].loads, 0);
+    EXPECT_EQ(g_records["skip_indirect"].loads, 0);
+    EXPECT_EQ(g_records["load_sibling"].loads, 1);
+    EXPECT_EQ(g_records["load_later_tier"].loads, 1);
+}
@@ -0,0 +1,207 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ *
+ * HDF is dual licensed: you can use it either under the terms of
+ * the GPL, or the BSD license, at your option.
+ * See the LICENSE file in the root of this repository for complete details.
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include "hdf_boot_trace.h"
+#include "hdf_device.h"
+#include "hdf_sbuf.h"
+
+using namespace testing::ext;
+
+#ifdef LOSCFG_DRIVERS_HDF_BOOT_TRACE
+static const uint32_t BOOT_TRACE_TEST_DEVICE = MK_DEVID(3, 5, 0);
+static const uint32_t BOOT_TRACE_TEST_OVERFLOW = 10;
+static const uint64_t BOOT_TRACE_TEST_AGO_US = 1000;
+
+class HdfBootTraceTest : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        base_ = Drain();
+    }
+    void TearDown() override {}
+
+    // dumps from @start, returns the record count and leaves the sequence number to go on with in @next
+    static uint32_t Dump(uint32_t format, uint32_t start, uint32_t &next, const void **data, uint32_t &size,
+        struct HdfSBuf *reply)
+    {
+        struct HdfSBuf *request = HdfSbufObtainDefaultSize();
+        uint32_t count = 0;
+        EXPECT_NE(request, nullptr);
+        if (request == nullptr) {
+            return 0;
+        }
+        (void)HdfSbufWriteUint32(request, format);
+        (void)HdfSbufWriteUint32(request, start);
+        EXPECT_EQ(HdfBootTraceDump(request, reply), HDF_SUCCESS);
+        HdfSbufRecycle(request);
+        EXPECT_TRUE(HdfSbufReadUint32(reply, &next));
+        EXPECT_TRUE(HdfSbufReadUint32(reply, &count));
+        EXPECT_TRUE(HdfSbufReadBuffer(reply, data, &size));
+        return count;
+    }
+
+    static uint32_t DumpBinary(uint32_t start, uint32_t &next, std::vector<HdfBootTraceRecord> &records)
+    {
+        struct HdfSBuf *reply = HdfSbufObtainDefaultSize();
+        const void *data = nullptr;
+        uint32_t size = 0;
+        EXPECT_NE(reply, nullptr);
+        if (reply == nullptr) {
+            return 0;
+        }
+        uint32_t count = Dump(HDF_BOOT_TRACE_BINARY, start, next, &data, size, reply);
+        EXPECT_EQ(size, count * sizeof(HdfBootTraceRecord));
+        if (data != nullptr) {
+            auto begin = static_cast<const HdfBootTraceRecord *>(data);
+            records.insert(records.end(), begin, begin + count);
+        }
+        HdfSbufRecycle(reply);
+        return count;
+    }
+
+    // skips whatever earlier tests and the boot left in the ring
+    static uint32_t Drain()
+    {
+        std::vector<HdfBootTraceRecord> records;
+        uint32_t start = 0;
+        uint32_t next = 0;
+        while (DumpBinary(start, next, records) > 0) {
+            start = next;
+        }
+        return next;
+    }
+
+    static void Trace(uint32_t phase, uint32_t deviceId, const char *moduleName, const char *serviceName, int32_t ret)
+    {
+        HdfBootTraceEnd(HdfBootTraceNow() - BOOT_TRACE_TEST_AGO_US, phase, deviceId, moduleName, serviceName, ret);
+    }
+
+    static std::string ServiceName(uint32_t i)
+    {
+        char name[HDF_BOOT_TRACE_NAME_LEN] = {0};
+        (void)snprintf(name, sizeof(name), "svc_%u", i);
+        return name;
+    }
+
+    uint32_t base_ = 0;
+};
+
+/**
+  * @tc.name: HdfBootTraceRecord001
+  * @tc.desc: records are dumped in order with their fields, names sanitized and truncated
+  * @tc.type: FUNC
+  * @tc.require:
+  */
+HWTEST_F(HdfBootTraceTest, HdfBootTraceRecord001, TestSize.Level1)
+{
+    std::string longName(HDF_BOOT_TRACE_NAME_LEN * 2, 'x');
+    std::vector<HdfBootTraceRecord> records;
+    uint32_t next = 0;
+
+    Trace(HDF_BOOT_PHASE_INIT, BOOT_TRACE_TEST_DEVICE, "trace_module", "trace_service", HDF_FAILURE);
+    Trace(HDF_BOOT_PHASE_ADD_SERVICE, HDF_BOOT_TRACE_NO_DEVICE, nullptr, "quote\"d\\name", HDF_SUCCESS);
+    Trace(HDF_BOOT_PHASE_LOAD, BOOT_TRACE_TEST_DEVICE, longName.c_str(), "", HDF_SUCCESS);
+
+    ASSERT_EQ(DumpBinary(base_, next, records), 3u);
+    EXPECT_EQ(next, base_ + 3);
+    EXPECT_EQ(records[0].phase, HDF_BOOT_PHASE_INIT);
+    EXPECT_EQ(records[0].deviceId, BOOT_TRACE_TEST_DEVICE);
+    EXPECT_EQ(records[0].hostId, HOSTID(BOOT_TRACE_TEST_DEVICE));
+    EXPECT_EQ(records[0].ret, HDF_FAILURE);
+    EXPECT_GE(records[0].durationUs, BOOT_TRACE_TEST_AGO_US);
+    EXPECT_STREQ(records[0].moduleName, "trace_module");
+    EXPECT_STREQ(records[0].serviceName, "trace_service");
+    EXPECT_EQ(records[1].hostId, HDF_BOOT_TRACE_NO_HOST);
+    EXPECT_STREQ(records[1].moduleName, "");
+    EXPECT_STREQ(records[1].serviceName, "quote_d_name");
+    EXPECT_EQ(strlen(records[2].moduleName), HDF_BOOT_TRACE_NAME_LEN - 1u);
+    EXPECT_LE(records[0].beginUs, records[1].beginUs);
+
+    records.clear();
+    EXPECT_EQ(DumpBinary(next, next, records), 0u);
+    EXPECT_EQ(next, base_ + 3);
+}
+
+/**
+  * @tc.name: HdfBootTraceWrap002
+  * @tc.desc: a reader behind an overwritten record skips ahead by sequence number and pages through the rest
+  * @tc.type: FUNC
+  * @tc.require:
+  */
+HWTEST_F(HdfBootTraceTest, HdfBootTraceWrap002, TestSize.Level1)
+{
+    const uint32_t total = HDF_BOOT_TRACE_RING_SIZE + BOOT_TRACE_TEST_OVERFLOW;
+    std::vector<HdfBootTraceRecord> records;
+    uint32_t start = base_;
+    uint32_t next = 0;
+    uint32_t count;
+
+    for (uint32_t i = 0; i < total; i++) {
+        Trace(HDF_BOOT_PHASE_BIND, BOOT_TRACE_TEST_DEVICE, "wrap", ServiceName(i).c_str(), HDF_SUCCESS);
+    }
+    count = DumpBinary(start, next, records);
+    ASSERT_EQ(count, static_cast<uint32_t>(HDF_BOOT_TRACE_DUMP_MAX));
+    // the first page starts at the oldest record kept, not at the overwritten ones asked for
+    EXPECT_EQ(next, base_ + BOOT_TRACE_TEST_OVERFLOW + HDF_BOOT_TRACE_DUMP_MAX);
+    while (count > 0) {
+        start = next;
+        count = DumpBinary(start, next, records);
+    }
+    EXPECT_EQ(next, base_ + total);
+    ASSERT_EQ(records.size(), static_cast<size_t>(HDF_BOOT_TRACE_RING_SIZE));
+    for (uint32_t i = 0; i < records.size(); i++) {
+        ASSERT_EQ(ServiceName(i + BOOT_TRACE_TEST_OVERFLOW), records[i].serviceName) << i;
+    }
+}
+
+/**
+  * @tc.name: HdfBootTraceJson003
+  * @tc.desc: the JSON dump is one terminated trace-event document and unknown formats are rejected
+  * @tc.type: FUNC
+  * @tc.require:
+  */
+HWTEST_F(HdfBootTraceTest, HdfBootTraceJson003, TestSize.Level1)
+{
+    struct HdfSBuf *reply = HdfSbufObtainDefaultSize();
+    struct HdfSBuf *request = HdfSbufObtainDefaultSize();
+    const void *data = nullptr;
+    uint32_t size = 0;
+    uint32_t next = 0;
+    ASSERT_NE(reply, nullptr);
+    ASSERT_NE(request, nullptr);
+
+    Trace(HDF_BOOT_PHASE_INIT, BOOT_TRACE_TEST_DEVICE, "json_module", "json_service", HDF_SUCCESS);
+    Trace(HDF_BOOT_PHASE_PUBLISH, BOOT_TRACE_TEST_DEVICE, "json_module", "", HDF_FAILURE);
+    ASSERT_EQ(Dump(HDF_BOOT_TRACE_JSON, base_, next, &data, size, reply), 2u);
+    ASSERT_NE(data, nullptr);
+    std::string json(static_cast<const char *>(data));
+    EXPECT_EQ(json.size() + 1, size);
+    EXPECT_EQ(json.find("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[{"), 0u);
+    EXPECT_EQ(json.rfind("}]}"), json.size() - strlen("}]}"));
+    EXPECT_NE(json.find("\"name\":\"json_service\",\"cat\":\"init\",\"ph\":\"X\""), std::string::npos);
+    // an event without a service is named after its module
+    EXPECT_NE(json.find("\"name\":\"json_module\",\"cat\":\"publish\""), std::string::npos);
+    EXPECT_NE(json.find("\"pid\":3,\"tid\":5"), std::string::npos);
+    EXPECT_NE(json.find("\"ret\":-1}}"), std::string::npos);
+    HdfSbufRecycle(reply);
+
+    (void)HdfSbufWriteUint32(request, HDF_BOOT_TRACE_BINARY + 1);
+    (void)HdfSbufWriteUint32(request, base_);
+    EXPECT_EQ(HdfBootTraceDump(request, nullptr), HDF_ERR_INVALID_PARAM);
+    reply = HdfSbufObtainDefaultSize();
+    ASSERT_NE(reply, nullptr);
+    EXPECT_EQ(HdfBootTraceDump(request, reply), HDF_ERR_INVALID_PARAM);
+    HdfSbufRecycle(request);
+    HdfSbufRecycle(reply);
+}
+#endif /* LOSCFG_DRIVERS_HDF_BOOT_TRACE */
@@ -20,6 +20,7 @@
 #include "hdf_sbuf.h"
 #include "hdf_uhdf_test.h"
 #include "ioservstat_listener.h"
+#include "osal_sem.h"
 #include "osal_time.h"
 #include "sample_driver_test.h"
 #include "svcmgr_ioservice.h"
@@ -97,6 +98,21 @@ int IoServiceTest::OnDevEventReceived(
     return 0;
 }
 
+static struct OsalSem g_eventGate;
+
+static int OnDevEventReceivedGated(
+    struct HdfDevEventlistener *listener, struct HdfIoService *service, uint32_t id, struct HdfSBuf *data)
+{
+    (void)service;
+    (void)id;
+    (void)data;
+    // holds the dispatch worker until the test opens the gate
+    (void)OsalSemWait(&g_eventGate, HDF_WAIT_FOREVER);
+    struct Eventlistener *l = CONTAINER_OF(listener, struct Eventlistener, listener);
+    l->eventCount++;
+    return 0;
+}
+
 static int SendEvent(struct HdfIoService *serv, const char *eventData, bool broadcast)
 {
     OsalTimespec time;
@@ -905,3 +921,421 @@ HWTEST_F(IoServiceTest, HdfIoService017, TestSize.Level0)
     SvcMgrIoserviceRelease(servmgr);
     HdfSbufRecycle(data);
 }
+
+/* *
+ * @tc.name: HdfIoService018
+ * @tc.desc: ioservice event ring delivery test
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(IoServiceTest, HdfIoService018, TestSize.Level0)
+{
+    const int eventNum = 3;
+    struct HdfIoService *serv = HdfIoServiceBind(testSvcName);
+    ASSERT_NE(serv, nullptr);
+    serv->priv = (void *)"serv0";
+
+    int ret = HdfIoServiceSetEventRing(serv, HDF_DEV_EVENT_RING_SIZE_MIN);
+    ASSERT_EQ(ret, HDF_SUCCESS);
+    ret = HdfDeviceRegisterEventListener(serv, &listener0.listener);
+    ASSERT_EQ(ret, HDF_SUCCESS);
+
+    for (int i = 0; i < eventNum; i++) {
+        ret = SendEvent(serv, testSvcName, false);
+        ASSERT_EQ(ret, HDF_SUCCESS);
+    }
+    usleep(eventWaitTimeUs);
+    ASSERT_EQ(eventNum, listener0.eventCount);
+
+    struct HdfIoService *serv1 = HdfIoServiceBind(testSvcName);
+    ASSERT_NE(serv1, nullptr);
+    serv1->priv = (void *)"serv1";
+    ret = HdfDeviceRegisterEventListener(serv1, &listener1.listener);
+    ASSERT_EQ(ret, HDF_SUCCESS);
+    ret = HdfIoServiceSetEventRing(serv1, HDF_DEV_EVENT_RING_SIZE_MIN);
+    ASSERT_EQ(ret, HDF_ERR_DEVICE_BUSY);
+
+    ret = HdfDeviceUnregisterEventListener(serv1, &listener1.listener);
+    ASSERT_EQ(ret, HDF_SUCCESS);
+    ret = HdfDeviceUnregisterEventListener(serv, &listener0.listener);
+    ASSERT_EQ(ret, HDF_SUCCESS);
+    HdfIoServiceRecycle(serv1);
+    HdfIoServiceRecycle(serv);
+}
+
+/* *
+ * @tc.name: HdfIoService019
+ * @tc.desc: service group listener keeps serving after services are added and removed
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(IoServiceTest, HdfIoService019, TestSize.Level0)
+{
+    const int servNum = 3;
+    struct HdfIoService *servs[servNum] = { nullptr };
+    struct HdfIoServiceGroup *group = HdfIoServiceGroupObtain();
+    ASSERT_NE(group, nullptr);
+
+    int ret = HdfIoServiceGroupRegisterListener(group, &listener0.listener);
+    ASSERT_EQ(ret, HDF_SUCCESS);
+    for (int i = 0; i < servNum; i++) {
+        servs[i] = HdfIoServiceBind(testSvcName);
+        ASSERT_NE(servs[i], nullptr);
+        servs[i]->priv = (void *)"serv";
+        ret = HdfIoServiceGroupAddService(group, servs[i]);
+        ASSERT_EQ(ret, HDF_SUCCESS);
+    }
+    ASSERT_EQ(HdfIoserviceGroupGetServiceCount(group), servNum);
+
+    for (int i = 0; i < servNum; i++) {
+        ret = SendEvent(servs[i], testSvcName, false);
+        ASSERT_EQ(ret, HDF_SUCCESS);
+    }
+    usleep(eventWaitTimeUs);
+    ASSERT_EQ(servNum, listener0.eventCount);
+
+    HdfIoServiceGroupRemoveService(group, servs[0]);
+    ASSERT_EQ(HdfIoserviceGroupGetServiceCount(group), servNum - 1);
+    ret = SendEvent(servs[0], testSvcName, false);
+    ASSERT_EQ(ret, HDF_SUCCESS);
+    ret = SendEvent(servs[servNum - 1], testSvcName, false);
+    ASSERT_EQ(ret, HDF_SUCCESS);
+    usleep(eventWaitTimeUs);
+    ASSERT_EQ(servNum + 1, listener0.eventCount);
+
+    HdfIoServiceGroupRecycle(group);
+    for (int i = 0; i < servNum; i++) {
+        HdfIoServiceRecycle(servs[i]);
+    }
+}
+
+/* *
+ * @tc.name: HdfIoService020
+ * @tc.desc: service group dispatch worker backpressure test
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(IoServiceTest, HdfIoService020, TestSize.Level0)
+{
+    const int eventNum = 4;
+    const int blockedWaitMs = 5;
+    const int blockedWaitRetry = 200;
+    struct Eventlistener slowListener;
+    slowListener.listener.onReceive = OnDevEventReceivedGated;
+    slowListener.listener.priv = (void *)"slowListener";
+    slowListener.eventCount = 0;
+    ASSERT_EQ(OsalSemInit(&g_eventGate, 0), HDF_SUCCESS);
+
+    struct HdfIoService *serv = HdfIoServiceBind(testSvcName);
+    ASSERT_NE(serv, nullptr);
+    serv->priv = (void *)"serv";
+    struct HdfIoServiceGroup *group = HdfIoServiceGroupObtain();
+    ASSERT_NE(group, nullptr);
+
+    struct HdfIoServiceGroupDispatchStat stat;
+    int ret = HdfIoServiceGroupGetDispatchStat(group, &stat);
+    ASSERT_EQ(ret, HDF_ERR_NOT_SUPPORT);
+    ret = HdfIoServiceGroupSetDispatchPool(group, 1, 1);
+    ASSERT_EQ(ret, HDF_SUCCESS);
+    ret = HdfIoServiceGroupSetDispatchPool(group, 1, 1);
+    ASSERT_EQ(ret, HDF_ERR_DEVICE_BUSY);
+
+    ret = HdfIoServiceGroupAddService(group, serv);
+    ASSERT_EQ(ret, HDF_SUCCESS);
+    ret = HdfIoServiceGroupRegisterListener(group, &slowListener.listener);
+    ASSERT_EQ(ret, HDF_SUCCESS);
+
+    /*
+     * the worker is held in the listener by the closed gate and the one slot queue takes the next event,
+     * so the listener thread must block on the third one however the threads are scheduled
+     */
+    for (int i = 0; i < eventNum; i++) {
+        ret = SendEvent(serv, testSvcName, false);
+        ASSERT_EQ(ret, HDF_SUCCESS);
+    }
+    for (int i = 0; i < blockedWaitRetry; i++) {
+        ret = HdfIoServiceGroupGetDispatchStat(group, &stat);
+        ASSERT_EQ(ret, HDF_SUCCESS);
+        if (stat.blocked > 0) {
+            break;
+        }
+        OsalMSleep(blockedWaitMs);
+    }
+    ASSERT_GT(stat.blocked, 0u);
+    ASSERT_EQ(stat.queued, 1u);
+    ASSERT_EQ(slowListener.eventCount, 0);
+
+    for (int i = 0; i < eventNum; i++) {
+        (void)OsalSemPost(&g_eventGate);
+    }
+    usleep(eventWaitTimeUs);
+    ASSERT_EQ(eventNum, slowListener.eventCount);
+
+    ret = HdfIoServiceGroupGetDispatchStat(group, &stat);
+    ASSERT_EQ(ret, HDF_SUCCESS);
+    ASSERT_EQ(stat.workerCount, 1u);
+    ASSERT_EQ(stat.queueDepth, 1u);
+    ASSERT_EQ(stat.queued, 0u);
+    ASSERT_EQ(stat.maxQueued, 1u);
+    ASSERT_EQ(stat.dispatched, static_cast<uint64_t>(eventNum));
+
+    /* recycle with events still queued, the worker must exit and release them */
+    for (int i = 0; i < eventNum; i++) {
+        (void)OsalSemPost(&g_eventGate);
+        ret = SendEvent(serv, testSvcName, false);
+        ASSERT_EQ(ret, HDF_SUCCESS);
+    }
+    HdfIoServiceGroupRecycle(group);
+    HdfIoServiceRecycle(serv);
+    (void)OsalSemDestroy(&g_eventGate);
+}
+
+/* *
+ * @tc.name: HdfIoService021
+ * @tc.desc: service lookup and class filtered status listeners with many services
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(IoServiceTest, HdfIoService021, TestSize.Level0)
+{
+    const int servNum = 8;
+    struct ISvcMgrIoservice *servmgr = SvcMgrIoserviceGet();
+    ASSERT_NE(servmgr, nullptr);
+
+    struct IoServiceStatusData defaultIssd;
+    struct ServiceStatusListener *defaultListener = IoServiceStatusListenerNewInstance();
+    ASSERT_NE(defaultListener, nullptr);
+    defaultListener->callback = TestOnServiceStatusReceived;
+    defaultListener->priv = (void *)&defaultIssd;
+    struct IoServiceStatusData sensorIssd;
+    struct ServiceStatusListener *sensorListener = IoServiceStatusListenerNewInstance();
+    ASSERT_NE(sensorListener, nullptr);
+    sensorListener->callback = TestOnServiceStatusReceived;
+    sensorListener->priv = (void *)&sensorIssd;
+
+    int status = servmgr->RegisterServiceStatusListener(servmgr, defaultListener, DEVICE_CLASS_DEFAULT);
+    ASSERT_EQ(status, HDF_SUCCESS);
+    status = servmgr->RegisterServiceStatusListener(servmgr, sensorListener, DEVICE_CLASS_SENSOR);
+    ASSERT_EQ(status, HDF_SUCCESS);
+
+    struct HdfIoService *testService = HdfIoServiceBind(SAMPLE_SERVICE);
+    ASSERT_NE(testService, nullptr);
+    std::string servNames[servNum];
+    for (int i = 0; i < servNum; i++) {
+        servNames[i] = "sample_hash_service" + std::to_string(i);
+        HdfSBuf *data = HdfSbufObtainDefaultSize();
+        ASSERT_NE(data, nullptr);
+        ASSERT_TRUE(HdfSbufWriteString(data, "sample_driver"));
+        ASSERT_TRUE(HdfSbufWriteString(data, servNames[i].c_str()));
+        int ret = testService->dispatcher->Dispatch(&testService->object, SAMPLE_DRIVER_REGISTER_DEVICE, data, nullptr);
+        HdfSbufRecycle(data);
+        ASSERT_EQ(ret, HDF_SUCCESS);
+    }
+
+    for (int i = 0; i < servNum; i++) {
+        struct HdfIoService *serv = HdfIoServiceBind(servNames[i].c_str());
+        ASSERT_NE(serv, nullptr);
+        HdfIoServiceRecycle(serv);
+    }
+    OsalMSleep(servstatWaitTime);
+    ASSERT_TRUE(defaultIssd.callbacked);
+    ASSERT_EQ(defaultIssd.servStatus, SERVIE_STATUS_START);
+    ASSERT_FALSE(sensorIssd.callbacked);
+
+    for (int i = 0; i < servNum; i++) {
+        HdfSBuf *data = HdfSbufObtainDefaultSize();
+        ASSERT_NE(data, nullptr);
+        ASSERT_TRUE(HdfSbufWriteString(data, "sample_driver"));
+        ASSERT_TRUE(HdfSbufWriteString(data, servNames[i].c_str()));
+        int ret = testService->dispatcher->Dispatch(&testService->object, SAMPLE_DRIVER_UNREGISTER_DEVICE, data,
+            nullptr);
+        HdfSbufRecycle(data);
+        ASSERT_EQ(ret, HDF_SUCCESS);
+    }
+    OsalMSleep(servstatWaitTime);
+    ASSERT_EQ(defaultIssd.servStatus, SERVIE_STATUS_STOP);
+    ASSERT_FALSE(sensorIssd.callbacked);
+
+    status = servmgr->UnregisterServiceStatusListener(servmgr, sensorListener);
+    ASSERT_EQ(status, HDF_SUCCESS);
+    status = servmgr->UnregisterServiceStatusListener(servmgr, defaultListener);
+    ASSERT_EQ(status, HDF_SUCCESS);
+    IoServiceStatusListenerFree(sensorListener);
+    IoServiceStatusListenerFree(defaultListener);
+    HdfIoServiceRecycle(testService);
+    SvcMgrIoserviceRelease(servmgr);
+}
+
+/* *
+ * @tc.name: HdfIoService022
+ * @tc.desc: service waiter wakes up when the service is published
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(IoServiceTest, HdfIoService022, TestSize.Level0)
+{
+    const char *newServName = "sample_service_waited";
+    struct HdfServiceWaiter *waiter = HdfServiceWaiterObtain(newServName);
+    ASSERT_NE(waiter, nullptr);
+    ASSERT_EQ(HdfServiceWaiterWait(waiter, 0), HDF_ERR_TIMEOUT);
+
+    struct HdfIoService *testService = HdfIoServiceBind(SAMPLE_SERVICE);
+    ASSERT_NE(testService, nullptr);
+    HdfSBuf *data = HdfSbufObtainDefaultSize();
+    ASSERT_NE(data, nullptr);
+    ASSERT_TRUE(HdfSbufWriteString(data, "sample_driver"));
+    ASSERT_TRUE(HdfSbufWriteString(data, newServName));
+    int ret = testService->dispatcher->Dispatch(&testService->object, SAMPLE_DRIVER_REGISTER_DEVICE, data, nullptr);
+    ASSERT_EQ(ret, HDF_SUCCESS);
+
+    ASSERT_EQ(HdfServiceWaiterWait(waiter, servstatWaitTime), HDF_SUCCESS);
+    // a published service stays reported for further waits
+    ASSERT_EQ(HdfServiceWaiterWait(waiter, 0), HDF_SUCCESS);
+    HdfServiceWaiterRecycle(waiter);
+
+    ret = testService->dispatcher->Dispatch(&testService->object, SAMPLE_DRIVER_UNREGISTER_DEVICE, data, nullptr);
+    ASSERT_EQ(ret, HDF_SUCCESS);
+    HdfIoServiceRecycle(testService);
+    HdfSbufRecycle(data);
+}
+
+/* *
+ * @tc.name: HdfIoService023
+ * @tc.desc: service waiter times out for a service nobody publishes
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(IoServiceTest, HdfIoService023, TestSize.Level0)
+{
+    struct HdfServiceWaiter *waiter = HdfServiceWaiterObtain("sample_service_never_published");
+    ASSERT_NE(waiter, nullptr);
+    uint64_t begin = OsalGetSysTimeMs();
+    ASSERT_EQ(HdfServiceWaiterWait(waiter, servstatWaitTime), HDF_ERR_TIMEOUT);
+    ASSERT_GE(OsalGetSysTimeMs() - begin, static_cast<uint64_t>(servstatWaitTime - 1));
+    HdfServiceWaiterRecycle(waiter);
+    ASSERT_EQ(HdfServiceWaiterWait(nullptr, 0), HDF_ERR_INVALID_PARAM);
+}
+
+/* *
+ * @tc.name: HdfIoService024
+ * @tc.desc: a waiter obtained after the service was published returns at once
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(IoServiceTest, HdfIoService024, TestSize.Level0)
+{
+    struct HdfIoService *testService = HdfIoServiceBind(SAMPLE_SERVICE);
+    ASSERT_NE(testService, nullptr);
+
+    struct HdfServiceWaiter *waiter = HdfServiceWaiterObtain(SAMPLE_SERVICE);
+    ASSERT_NE(waiter, nullptr);
+    ASSERT_EQ(HdfServiceWaiterWait(waiter, servstatWaitTime), HDF_SUCCESS);
+    HdfServiceWaiterRecycle(waiter);
+    HdfIoServiceRecycle(testService);
+}
+
+/* *
+ * @tc.name: HdfIoService025
+ * @tc.desc: recycled waiters leave the others working and are not woken any more
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(IoServiceTest, HdfIoService025, TestSize.Level0)
+{
+    const char *newServName = "sample_service_recycled";
+    const int waiterCount = 4;
+    struct HdfServiceWaiter *waiters[waiterCount] = { nullptr };
+    for (int i = 0; i < waiterCount; i++) {
+        waiters[i] = HdfServiceWaiterObtain(newServName);
+        ASSERT_NE(waiters[i], nullptr);
+    }
+    // drop every other waiter before the service shows up
+    for (int i = 0; i < waiterCount; i += 2) {
+        HdfServiceWaiterRecycle(waiters[i]);
+        waiters[i] = nullptr;
+    }
+    HdfServiceWaiterRecycle(nullptr);
+
+    struct HdfIoService *testService = HdfIoServiceBind(SAMPLE_SERVICE);
+    ASSERT_NE(testService, nullptr);
+    HdfSBuf *data = HdfSbufObtainDefaultSize();
+    ASSERT_NE(data, nullptr);
+    ASSERT_TRUE(HdfSbufWriteString(data, "sample_driver"));
+    ASSERT_TRUE(HdfSbufWriteString(data, newServName));
+    int ret = testService->dispatcher->Dispatch(&testService->object, SAMPLE_DRIVER_REGISTER_DEVICE, data, nullptr);
+    ASSERT_EQ(ret, HDF_SUCCESS);
+
+    for (int i = 1; i < waiterCount; i += 2) {
+        ASSERT_EQ(HdfServiceWaiterWait(waiters[i], servstatWaitTime), HDF_SUCCESS);
+        HdfServiceWaiterRecycle(waiters[i]);
+    }
+
+    ret = testService->dispatcher->Dispatch(&testService->object, SAMPLE_DRIVER_UNREGISTER_DEVICE, data, nullptr);
+    ASSERT_EQ(ret, HDF_SUCCESS);
+    OsalMSleep(servstatWaitTime);
+    // the stopped service is not reported to a new waiter
+    struct HdfServiceWaiter *waiter = HdfServiceWaiterObtain(newServName);
+    ASSERT_NE(waiter, nullptr);
+    ASSERT_EQ(HdfServiceWaiterWait(waiter, 0), HDF_ERR_TIMEOUT);
+    HdfServiceWaiterRecycle(waiter);
+    HdfIoServiceRecycle(testService);
+    HdfSbufRecycle(data);
+}
+
+static void IoServiceBatchTest(struct HdfIoService *serv)
+{
+    // more than one chunk, so the adapter splits the batch
+    const uint32_t callCount = HDF_WRITE_READ_BATCH_MAX + 3;
+    struct HdfIoServiceCall calls[callCount];
+    for (uint32_t i = 0; i < callCount; i++) {
+        calls[i].cmdId = SAMPLE_DRIVER_SENDEVENT_SINGLE_DEVICE;
+        calls[i].data = HdfSbufObtainDefaultSize();
+        calls[i].reply = HdfSbufObtainDefaultSize();
+        calls[i].status = HDF_FAILURE;
+        ASSERT_NE(calls[i].data, nullptr);
+        ASSERT_NE(calls[i].reply, nullptr);
+        ASSERT_TRUE(HdfSbufWriteString(calls[i].data, "batch event"));
+    }
+
+    ASSERT_EQ(HdfIoServiceDispatchBatch(serv, calls, callCount), HDF_SUCCESS);
+    for (uint32_t i = 0; i < callCount; i++) {
+        int32_t replyData = 0;
+        ASSERT_EQ(calls[i].status, HDF_SUCCESS);
+        ASSERT_TRUE(HdfSbufReadInt32(calls[i].reply, &replyData));
+        ASSERT_EQ(replyData, INT32_MAX);
+        HdfSbufRecycle(calls[i].data);
+        HdfSbufRecycle(calls[i].reply);
+    }
+}
+
+/* *
+ * @tc.name: HdfIoService026
+ * @tc.desc: batched service calls report the status and reply of each call
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(IoServiceTest, HdfIoService026, TestSize.Level0)
+{
+    struct HdfIoService *serv = HdfIoServiceBind(testSvcName);
+    ASSERT_NE(serv, nullptr);
+    IoServiceBatchTest(serv);
+    ASSERT_EQ(HdfIoServiceDispatchBatch(serv, nullptr, 1), HDF_ERR_INVALID_PARAM);
+    HdfIoServiceRecycle(serv);
+}
+
+/* *
+ * @tc.name: HdfIoService027
+ * @tc.desc: batched service calls fall back to one call at a time with the same results
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(IoServiceTest, HdfIoService027, TestSize.Level0)
+{
+    ASSERT_NE(HdfIoServiceAdapterSetBatchSupported, nullptr);
+    struct HdfIoService *serv = HdfIoServiceBind(testSvcName);
+    ASSERT_NE(serv, nullptr);
+    HdfIoServiceAdapterSetBatchSupported(false);
+    IoServiceBatchTest(serv);
+    HdfIoServiceAdapterSetBatchSupported(true);
+    HdfIoServiceRecycle(serv);
+}
@@ -138,3 +138,19 @@ HWTEST_F(HdfManagerTest, HdfGetServiceNameByDeviceClass001, TestSize.Level0)
     HdfSbufRecycle(data);
     EXPECT_TRUE(flag);
 }
+
+/**
+ * @tc.name: HdfDriverIndex001
+ * @tc.desc: drivers resolve by moduleName through the registry index, duplicates in registration order
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(HdfManagerTest, HdfDriverIndex001, TestSize.Level1)
+{
+    struct HdfIoService *ioService = HdfIoServiceBind(SAMPLE_SERVICE);
+    ASSERT_TRUE(ioService != nullptr);
+    int32_t ret = ioService->dispatcher->Dispatch(&ioService->object, SAMPLE_DRIVER_CHECK_DRIVER_INDEX, nullptr,
+        nullptr);
+    EXPECT_EQ(ret, HDF_SUCCESS);
+    HdfIoServiceRecycle(ioService);
+}
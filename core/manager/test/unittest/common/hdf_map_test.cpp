@@ -0,0 +1,247 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ *
+ * HDF is dual licensed: you can use it either under the terms of
+ * the GPL, or the BSD license, at your option.
+ * See the LICENSE file in the root of this repository for complete details.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include "hdf_base.h"
+#include "hdf_map.h"
+
+using namespace testing::ext;
+
+static const int MAP_RANDOM_KEY_RANGE = 5000;
+static const int MAP_RANDOM_LOOP_COUNT = 100000;
+static const int MAP_OP_COUNT = 3;
+static const int MAP_BENCH_ROUNDS = 5;
+static const int MAP_BENCH_SIZES[] = { 1000, 10000, 100000 };
+
+class HdfMapTest : public ::testing::Test {
+protected:
+    void SetUp() override {}
+    void TearDown() override {}
+
+    static std::vector<std::string> GenKeys(int count, const char *prefix)
+    {
+        std::vector<std::string> keys;
+        char key[32] = {0};
+        for (int i = 0; i < count; ++i) {
+            (void)snprintf(key, sizeof(key), "%s_%08x_%d", prefix, static_cast<uint32_t>(i * 2654435761U), i);
+            keys.push_back(key);
+        }
+        return keys;
+    }
+
+    static void BenchMap(uint32_t type, const std::vector<std::string> &keys, const std::vector<std::string> &misses)
+    {
+        std::vector<uint32_t> hashes;
+        std::vector<size_t> order(keys.size());
+        for (size_t i = 0; i < keys.size(); ++i) {
+            hashes.push_back(MapHashKey(keys[i].c_str()));
+            order[i] = i;
+        }
+        std::shuffle(order.begin(), order.end(), std::mt19937(keys.size()));
+
+        Map map;
+        MapInitWithType(&map, type);
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < keys.size(); ++i) {
+            uint32_t value = i;
+            ASSERT_EQ(MapSet(&map, keys[i].c_str(), &value, sizeof(value)), HDF_SUCCESS);
+        }
+        auto insert = std::chrono::steady_clock::now();
+        for (int round = 0; round < MAP_BENCH_ROUNDS; ++round) {
+            for (auto i : order) {
+                ASSERT_NE(MapGet(&map, keys[i].c_str()), nullptr);
+            }
+        }
+        auto get = std::chrono::steady_clock::now();
+        for (int round = 0; round < MAP_BENCH_ROUNDS; ++round) {
+            for (auto i : order) {
+                ASSERT_NE(MapGetByHash(&map, keys[i].c_str(), hashes[i]), nullptr);
+            }
+        }
+        auto getByHash = std::chrono::steady_clock::now();
+        for (int round = 0; round < MAP_BENCH_ROUNDS; ++round) {
+            for (auto &key : misses) {
+                ASSERT_EQ(MapGet(&map, key.c_str()), nullptr);
+            }
+        }
+        auto miss = std::chrono::steady_clock::now();
+        for (auto &key : keys) {
+            ASSERT_EQ(MapErase(&map, key.c_str()), HDF_SUCCESS);
+        }
+        auto erase = std::chrono::steady_clock::now();
+        MapDelete(&map);
+
+        double lookups = static_cast<double>(keys.size()) * MAP_BENCH_ROUNDS;
+        auto ns = [](std::chrono::steady_clock::time_point from, std::chrono::steady_clock::time_point to) {
+            return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(to - from).count());
+        };
+        printf("%-7s keys %6zu: set %6.1f get %6.1f getByHash %6.1f miss %6.1f erase %6.1f ns/op\n",
+            (type == MAP_TYPE_OPEN) ? "open" : "chained", keys.size(), ns(start, insert) / keys.size(),
+            ns(insert, get) / lookups, ns(get, getByHash) / lookups, ns(getByHash, miss) / lookups,
+            ns(miss, erase) / keys.size());
+    }
+};
+
+/**
+  * @tc.name: HdfMapOpenBasic001
+  * @tc.desc: set, update, get and erase on an open-addressing map
+  * @tc.type: FUNC
+  */
+HWTEST_F(HdfMapTest, HdfMapOpenBasic001, TestSize.Level1)
+{
+    Map map;
+    MapInitWithType(&map, MAP_TYPE_OPEN);
+    ASSERT_EQ(MapGet(&map, "none"), nullptr);
+
+    uint32_t value = 1;
+    ASSERT_EQ(MapSet(&map, "key", &value, sizeof(value)), HDF_SUCCESS);
+    uint32_t *stored = static_cast<uint32_t *>(MapGet(&map, "key"));
+    ASSERT_NE(stored, nullptr);
+    ASSERT_EQ(*stored, value);
+
+    value = 2;
+    ASSERT_EQ(MapSet(&map, "key", &value, sizeof(value)), HDF_SUCCESS);
+    ASSERT_EQ(static_cast<uint32_t *>(MapGet(&map, "key")), stored);
+    ASSERT_EQ(*stored, value);
+
+    uint64_t bigValue = 0;
+    ASSERT_EQ(MapSet(&map, "key", &bigValue, sizeof(bigValue)), HDF_ERR_INVALID_OBJECT);
+    ASSERT_EQ(MapGetByHash(&map, "key", MapHashKey("key")), stored);
+
+    ASSERT_EQ(MapErase(&map, "key"), HDF_SUCCESS);
+    ASSERT_EQ(MapGet(&map, "key"), nullptr);
+    ASSERT_NE(MapErase(&map, "key"), HDF_SUCCESS);
+    ASSERT_EQ(map.nodeSize, 0u);
+    MapDelete(&map);
+}
+
+/**
+  * @tc.name: HdfMapOpenStable002
+  * @tc.desc: value pointers of an open-addressing map survive table growth
+  * @tc.type: FUNC
+  */
+HWTEST_F(HdfMapTest, HdfMapOpenStable002, TestSize.Level1)
+{
+    Map map;
+    MapInitWithType(&map, MAP_TYPE_OPEN);
+    std::vector<std::string> keys = GenKeys(MAP_RANDOM_KEY_RANGE, "stable");
+    std::vector<void *> values;
+    for (size_t i = 0; i < keys.size(); ++i) {
+        uint32_t value = i;
+        ASSERT_EQ(MapSet(&map, keys[i].c_str(), &value, sizeof(value)), HDF_SUCCESS);
+        values.push_back(MapGet(&map, keys[i].c_str()));
+    }
+    for (size_t i = 0; i < keys.size(); ++i) {
+        ASSERT_EQ(MapGet(&map, keys[i].c_str()), values[i]);
+        ASSERT_EQ(*static_cast<uint32_t *>(values[i]), i);
+    }
+    MapDelete(&map);
+    ASSERT_EQ(MapGet(&map, keys[0].c_str()), nullptr);
+}
+
+/**
+  * @tc.name: HdfMapRandomOps003
+  * @tc.desc: random set, get and erase give the same results on chained and open maps
+  * @tc.type: FUNC
+  */
+HWTEST_F(HdfMapTest, HdfMapRandomOps003, TestSize.Level1)
+{
+    Map chained;
+    Map open;
+    MapInit(&chained);
+    MapInitWithType(&open, MAP_TYPE_OPEN);
+    std::vector<std::string> keys = GenKeys(MAP_RANDOM_KEY_RANGE, "random");
+    std::mt19937 rnd(MAP_RANDOM_LOOP_COUNT);
+
+    for (int i = 0; i < MAP_RANDOM_LOOP_COUNT; ++i) {
+        const char *key = keys[rnd() % keys.size()].c_str();
+        uint32_t value = rnd();
+        switch (rnd() % MAP_OP_COUNT) {
+            case 0:
+                ASSERT_EQ(MapSet(&chained, key, &value, sizeof(value)), MapSet(&open, key, &value, sizeof(value)));
+                break;
+            case 1: {
+                uint32_t *chainedValue = static_cast<uint32_t *>(MapGet(&chained, key));
+                uint32_t *openValue = static_cast<uint32_t *>(MapGetByHash(&open, key, MapHashKey(key)));
+                ASSERT_EQ(chainedValue == nullptr, openValue == nullptr);
+                if (chainedValue != nullptr) {
+                    ASSERT_EQ(*chainedValue, *openValue);
+                }
+                break;
+            }
+            default:
+                ASSERT_EQ(MapErase(&chained, key), MapErase(&open, key));
+                break;
+        }
+        ASSERT_EQ(chained.nodeSize, open.nodeSize);
+    }
+
+    MapDelete(&chained);
+    MapDelete(&open);
+}
+
+/**
+  * @tc.name: HdfMapBenchmark004
+  * @tc.desc: compare chained and open-addressing maps from 1K to 100K keys
+  * @tc.type: PERF
+  */
+HWTEST_F(HdfMapTest, HdfMapBenchmark004, TestSize.Level3)
+{
+    for (auto size : MAP_BENCH_SIZES) {
+        std::vector<std::string> keys = GenKeys(size, "service");
+        std::vector<std::string> misses = GenKeys(size, "missing");
+        BenchMap(MAP_TYPE_CHAINED, keys, misses);
+        BenchMap(MAP_TYPE_OPEN, keys, misses);
+    }
+}
+
+/**
+  * @tc.name: HdfMapOpenReuse005
+  * @tc.desc: entries of an open-addressing map reuse the space of erased entries of the same size
+  * @tc.type: FUNC
+  */
+HWTEST_F(HdfMapTest, HdfMapOpenReuse005, TestSize.Level1)
+{
+    const int keyCount = 16;
+    const int erased = 3;
+    Map map;
+    MapInitWithType(&map, MAP_TYPE_OPEN);
+    std::vector<std::string> keys = GenKeys(keyCount, "reuse");
+    std::vector<std::string> others = GenKeys(keyCount, "other");
+    for (size_t i = 0; i < keys.size(); ++i) {
+        uint32_t value = i;
+        ASSERT_EQ(MapSet(&map, keys[i].c_str(), &value, sizeof(value)), HDF_SUCCESS);
+    }
+    void *hole = MapGet(&map, keys[erased].c_str());
+    ASSERT_EQ(MapErase(&map, keys[erased].c_str()), HDF_SUCCESS);
+
+    // churn at a steady size keeps landing in the same space
+    for (int round = 0; round < MAP_BENCH_ROUNDS; ++round) {
+        uint32_t value = round;
+        const char *key = others[erased].c_str();
+        ASSERT_EQ(MapSet(&map, key, &value, sizeof(value)), HDF_SUCCESS);
+        ASSERT_EQ(MapGet(&map, key), hole);
+        ASSERT_EQ(MapErase(&map, key), HDF_SUCCESS);
+    }
+    for (size_t i = 0; i < keys.size(); ++i) {
+        uint32_t *value = static_cast<uint32_t *>(MapGet(&map, keys[i].c_str()));
+        if (i == erased) {
+            ASSERT_EQ(value, nullptr);
+        } else {
+            ASSERT_NE(value, nullptr);
+            ASSERT_EQ(*value, i);
+        }
+    }
+    MapDelete(&map);
+}
@@ -0,0 +1,224 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ *
+ * HDF is dual licensed: you can use it either under the terms of
+ * the GPL, or the BSD license, at your option.
+ * See the LICENSE file in the root of this repository for complete details.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <set>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include "hdf_base.h"
+#include "hdf_message_looper.h"
+#include "hdf_message_task.h"
+#include "osal_message.h"
+#include "osal_msg_queue.h"
+
+using namespace testing::ext;
+
+static const int MESSAGE_SLAB_BURST = 200;
+static const int MESSAGE_SAME_TIME_COUNT = 32;
+static const int MESSAGE_WAIT_ROUNDS = 100;
+static const long MESSAGE_DELAY_MS = 10;
+
+static std::vector<int> g_dispatched;
+static std::atomic<int> g_dispatchCount(0);
+
+static int32_t MessageTestDispatch(struct HdfMessageTask *task, struct HdfMessage *msg)
+{
+    (void)task;
+    g_dispatched.push_back(msg->messageId);
+    g_dispatchCount++;
+    return HDF_SUCCESS;
+}
+
+static struct HdfMessage *MessageTestObtain(int id)
+{
+    struct HdfMessage *message = HdfMessageObtain(0);
+    if (message != nullptr) {
+        message->messageId = id;
+    }
+    return message;
+}
+
+/*
+ * Takes @count messages from @queue in dispatch order, gives up after MESSAGE_WAIT_ROUNDS empty waits.
+ * The queue is not read past @count, an empty queue without timers would block forever.
+ */
+static std::vector<int> MessageTestCollect(struct HdfMessageQueue *queue, int count)
+{
+    std::vector<int> ids;
+    for (int round = 0; round < MESSAGE_WAIT_ROUNDS && static_cast<int>(ids.size()) < count;) {
+        struct HdfMessage *message = HdfMessageQueueNext(queue);
+        if (message == nullptr) {
+            ++round;
+            continue;
+        }
+        ids.push_back(message->messageId);
+        HdfMessageRecycle(message);
+    }
+    return ids;
+}
+
+class HdfMessageTest : public ::testing::Test {
+protected:
+    void SetUp() override {}
+    void TearDown() override {}
+};
+
+/**
+  * @tc.name: HdfMessageSlabReuse001
+  * @tc.desc: small messages come from the slab and recycled blocks are served again
+  * @tc.type: FUNC
+  * @tc.require:
+  */
+HWTEST_F(HdfMessageTest, HdfMessageSlabReuse001, TestSize.Level1)
+{
+    struct HdfMessage *message = HdfMessageObtain(HDF_MESSAGE_SLAB_EXTEND_SIZE);
+    ASSERT_NE(message, nullptr);
+    ASSERT_EQ(message->flags, HDF_MESSAGE_FLAG_SLAB);
+    message->messageId = 1;
+    message->target = reinterpret_cast<struct HdfMessageTask *>(message);
+    HdfMessageRecycle(message);
+
+    struct HdfMessage *again = HdfMessageObtain(0);
+    ASSERT_EQ(again, message);
+    ASSERT_EQ(again->flags, HDF_MESSAGE_FLAG_SLAB);
+    ASSERT_EQ(again->messageId, 0);
+    ASSERT_EQ(again->target, nullptr);
+    HdfMessageRecycle(again);
+}
+
+/**
+  * @tc.name: HdfMessageSlabFallback002
+  * @tc.desc: messages with a large extension are allocated from heap
+  * @tc.type: FUNC
+  * @tc.require:
+  */
+HWTEST_F(HdfMessageTest, HdfMessageSlabFallback002, TestSize.Level1)
+{
+    struct HdfMessage *message = HdfMessageObtain(HDF_MESSAGE_SLAB_EXTEND_SIZE + 1);
+    ASSERT_NE(message, nullptr);
+    ASSERT_EQ(message->flags & HDF_MESSAGE_FLAG_SLAB, 0);
+    HdfMessageRecycle(message);
+    HdfMessageRecycle(nullptr);
+}
+
+/**
+  * @tc.name: HdfMessageSlabBurst003
+  * @tc.desc: a burst larger than one slab chunk gets distinct blocks that can all be recycled
+  * @tc.type: FUNC
+  * @tc.require:
+  */
+HWTEST_F(HdfMessageTest, HdfMessageSlabBurst003, TestSize.Level1)
+{
+    std::vector<struct HdfMessage *> messages;
+    std::set<struct HdfMessage *> unique;
+    for (int i = 0; i < MESSAGE_SLAB_BURST; ++i) {
+        struct HdfMessage *message = HdfMessageObtain(sizeof(uint64_t));
+        ASSERT_NE(message, nullptr);
+        ASSERT_EQ(message->flags, HDF_MESSAGE_FLAG_SLAB);
+        messages.push_back(message);
+        unique.insert(message);
+    }
+    ASSERT_EQ(unique.size(), messages.size());
+    for (auto message : messages) {
+        HdfMessageRecycle(message);
+    }
+
+    struct HdfMessage *message = HdfMessageObtain(0);
+    ASSERT_NE(message, nullptr);
+    ASSERT_NE(unique.find(message), unique.end());
+    HdfMessageRecycle(message);
+}
+
+/**
+  * @tc.name: HdfMessageQueueDelay004
+  * @tc.desc: delayed messages are dispatched by due time, after the ones due now
+  * @tc.type: FUNC
+  * @tc.require:
+  */
+HWTEST_F(HdfMessageTest, HdfMessageQueueDelay004, TestSize.Level1)
+{
+    struct HdfMessageQueue queue;
+    OsalMessageQueueInit(&queue);
+    const long delays[] = { 3 * MESSAGE_DELAY_MS, MESSAGE_DELAY_MS, 0, 2 * MESSAGE_DELAY_MS, 0 };
+    const std::vector<int> expected = { 2, 4, 1, 3, 0 };
+    for (int i = 0; i < static_cast<int>(sizeof(delays) / sizeof(delays[0])); ++i) {
+        struct HdfMessage *message = MessageTestObtain(i);
+        ASSERT_NE(message, nullptr);
+        HdfMessageQueueEnqueue(&queue, message, delays[i]);
+    }
+
+    ASSERT_EQ(MessageTestCollect(&queue, expected.size()), expected);
+    OsalMessageQueueDestroy(&queue);
+}
+
+/**
+  * @tc.name: HdfMessageQueueSameTime005
+  * @tc.desc: delayed messages due at the same time are dispatched in the order they were enqueued
+  * @tc.type: FUNC
+  * @tc.require:
+  */
+HWTEST_F(HdfMessageTest, HdfMessageQueueSameTime005, TestSize.Level1)
+{
+    struct HdfMessageQueue queue;
+    OsalMessageQueueInit(&queue);
+    std::vector<int> expected;
+    // enough entries that the heap has to move them around
+    for (int i = 0; i < MESSAGE_SAME_TIME_COUNT; ++i) {
+        struct HdfMessage *message = MessageTestObtain(i);
+        ASSERT_NE(message, nullptr);
+        HdfMessageQueueEnqueue(&queue, message, MESSAGE_DELAY_MS);
+        expected.push_back(i);
+    }
+
+    ASSERT_EQ(MessageTestCollect(&queue, expected.size()), expected);
+    OsalMessageQueueDestroy(&queue);
+}
+
+/**
+  * @tc.name: HdfMessageLooperDrainAll006
+  * @tc.desc: a looper in drainAll mode dispatches every message in order and stops
+  * @tc.type: FUNC
+  * @tc.require:
+  */
+HWTEST_F(HdfMessageTest, HdfMessageLooperDrainAll006, TestSize.Level1)
+{
+    struct HdfMessageLooper looper;
+    struct HdfMessageTask task;
+    struct IHdfMessageHandler handler = { MessageTestDispatch };
+    HdfMessageLooperConstruct(&looper);
+    looper.drainAll = true;
+    HdfMessageTaskConstruct(&task, &looper, &handler);
+    g_dispatched.clear();
+    g_dispatchCount = 0;
+
+    std::vector<int> expected;
+    for (int i = 0; i < MESSAGE_SAME_TIME_COUNT; ++i) {
+        struct HdfMessage *message = MessageTestObtain(i);
+        ASSERT_NE(message, nullptr);
+        ASSERT_EQ(task.SendMessage(&task, message, false), HDF_SUCCESS);
+        expected.push_back(i);
+    }
+    struct HdfMessage *delayed = MessageTestObtain(MESSAGE_SAME_TIME_COUNT);
+    ASSERT_NE(delayed, nullptr);
+    delayed->target = &task;
+    HdfMessageQueueEnqueue(&looper.messageQueue, delayed, MESSAGE_DELAY_MS);
+    expected.push_back(MESSAGE_SAME_TIME_COUNT);
+
+    std::thread thread([&looper]() { looper.Start(&looper); });
+    for (int round = 0; round < MESSAGE_WAIT_ROUNDS && g_dispatchCount.load() < static_cast<int>(expected.size());
+        ++round) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(MESSAGE_DELAY_MS));
+    }
+    looper.Stop(&looper);
+    thread.join();
+
+    ASSERT_FALSE(looper.isRunning);
+    ASSERT_EQ(g_dispatched, expected);
+}
@@ -0,0 +1,188 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ *
+ * HDF is dual licensed: you can use it either under the terms of
+ * the GPL, or the BSD license, at your option.
+ * See the LICENSE file in the root of this repository for complete details.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include "hdf_base.h"
+#include "hdf_mpmc_queue.h"
+#include "hdf_task_queue.h"
+
+using namespace testing::ext;
+
+static const uint32_t MPMC_TEST_CAPACITY = 8;
+static const uint32_t MPMC_TEST_LAPS = 5;
+static const int MPMC_STRESS_THREADS = 4;
+static const uintptr_t MPMC_STRESS_ITEMS = 20000;
+static const int TASK_QUEUE_TASK_COUNT = 512;
+static const int TASK_QUEUE_WAIT_MS = 2000;
+
+class HdfMpmcQueueTest : public ::testing::Test {
+protected:
+    void SetUp() override {}
+    void TearDown() override {}
+};
+
+static void *ItemOf(uintptr_t value)
+{
+    /* the ring rejects NULL, keep 0 representable */
+    return reinterpret_cast<void *>(value + 1);
+}
+
+static uintptr_t ValueOf(void *item)
+{
+    return reinterpret_cast<uintptr_t>(item) - 1;
+}
+
+/**
+  * @tc.name: HdfMpmcQueueFullEmpty001
+  * @tc.desc: push fails on a full ring and pop fails on an empty one
+  * @tc.type: FUNC
+  * @tc.require:
+  */
+HWTEST_F(HdfMpmcQueueTest, HdfMpmcQueueFullEmpty001, TestSize.Level1)
+{
+    struct HdfMpmcQueue queue;
+    ASSERT_EQ(HdfMpmcQueueInit(&queue, MPMC_TEST_CAPACITY - 1), HDF_SUCCESS);
+    ASSERT_EQ(HdfMpmcQueueTryPop(&queue), nullptr);
+
+    for (uintptr_t i = 0; i < MPMC_TEST_CAPACITY; ++i) {
+        ASSERT_TRUE(HdfMpmcQueueTryPush(&queue, ItemOf(i)));
+    }
+    ASSERT_FALSE(HdfMpmcQueueTryPush(&queue, ItemOf(MPMC_TEST_CAPACITY)));
+    ASSERT_EQ(HdfMpmcQueueOffer(&queue, ItemOf(MPMC_TEST_CAPACITY)), HDF_ERR_QUEUE_FULL);
+    ASSERT_EQ(HdfMpmcQueueOffer(&queue, nullptr), HDF_ERR_INVALID_PARAM);
+
+    for (uintptr_t i = 0; i < MPMC_TEST_CAPACITY; ++i) {
+        void *item = HdfMpmcQueueTryPop(&queue);
+        ASSERT_NE(item, nullptr);
+        ASSERT_EQ(ValueOf(item), i);
+    }
+    ASSERT_EQ(HdfMpmcQueueTryPop(&queue), nullptr);
+    ASSERT_EQ(HdfMpmcQueuePoll(&queue, 1), nullptr);
+    HdfMpmcQueueDestroy(&queue);
+}
+
+/**
+  * @tc.name: HdfMpmcQueueWrapAround002
+  * @tc.desc: items keep their order while the positions wrap around the ring several times
+  * @tc.type: FUNC
+  * @tc.require:
+  */
+HWTEST_F(HdfMpmcQueueTest, HdfMpmcQueueWrapAround002, TestSize.Level1)
+{
+    struct HdfMpmcQueue queue;
+    ASSERT_EQ(HdfMpmcQueueInit(&queue, MPMC_TEST_CAPACITY), HDF_SUCCESS);
+
+    uintptr_t pushed = 0;
+    uintptr_t popped = 0;
+    /* keep the ring partly filled so head and tail cross the end at different times */
+    const uintptr_t batch = MPMC_TEST_CAPACITY / 2 + 1;
+    for (uint32_t lap = 0; lap < MPMC_TEST_LAPS * 2; ++lap) {
+        for (uintptr_t i = 0; i < batch; ++i) {
+            ASSERT_TRUE(HdfMpmcQueueTryPush(&queue, ItemOf(pushed++)));
+        }
+        while (pushed - popped > 1) {
+            void *item = HdfMpmcQueueTryPop(&queue);
+            ASSERT_NE(item, nullptr);
+            ASSERT_EQ(ValueOf(item), popped++);
+        }
+    }
+    void *item = HdfMpmcQueuePoll(&queue, 1);
+    ASSERT_NE(item, nullptr);
+    ASSERT_EQ(ValueOf(item), popped++);
+    ASSERT_EQ(HdfMpmcQueueTryPop(&queue), nullptr);
+    ASSERT_GT(pushed, static_cast<uintptr_t>(MPMC_TEST_CAPACITY * MPMC_TEST_LAPS));
+    HdfMpmcQueueDestroy(&queue);
+}
+
+/**
+  * @tc.name: HdfMpmcQueueStress003
+  * @tc.desc: concurrent producers and consumers pass every item exactly once
+  * @tc.type: FUNC
+  * @tc.require:
+  */
+HWTEST_F(HdfMpmcQueueTest, HdfMpmcQueueStress003, TestSize.Level1)
+{
+    struct HdfMpmcQueue queue;
+    ASSERT_EQ(HdfMpmcQueueInit(&queue, MPMC_TEST_CAPACITY), HDF_SUCCESS);
+
+    std::vector<std::atomic<int>> seen(MPMC_STRESS_ITEMS * MPMC_STRESS_THREADS);
+    for (auto &count : seen) {
+        count = 0;
+    }
+    std::atomic<uintptr_t> consumed(0);
+    const uintptr_t total = MPMC_STRESS_ITEMS * MPMC_STRESS_THREADS;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < MPMC_STRESS_THREADS; ++t) {
+        threads.emplace_back([&queue, t]() {
+            for (uintptr_t i = 0; i < MPMC_STRESS_ITEMS; ++i) {
+                while (HdfMpmcQueueOffer(&queue, ItemOf(t * MPMC_STRESS_ITEMS + i)) != HDF_SUCCESS) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+        threads.emplace_back([&queue, &seen, &consumed, total]() {
+            while (consumed.load() < total) {
+                void *item = HdfMpmcQueuePoll(&queue, 1);
+                if (item != nullptr) {
+                    seen[ValueOf(item)]++;
+                    consumed++;
+                }
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    ASSERT_EQ(consumed.load(), total);
+    for (uintptr_t i = 0; i < total; ++i) {
+        ASSERT_EQ(seen[i].load(), 1);
+    }
+    ASSERT_EQ(HdfMpmcQueueTryPop(&queue), nullptr);
+    HdfMpmcQueueDestroy(&queue);
+}
+
+static std::atomic<int> g_taskRunCount(0);
+
+static int32_t CountTask(struct HdfTaskType *task)
+{
+    (void)task;
+    g_taskRunCount++;
+    return HDF_SUCCESS;
+}
+
+/**
+  * @tc.name: HdfTaskQueueDestroyDrain004
+  * @tc.desc: tasks enqueued before the task queue is destroyed still run
+  * @tc.type: FUNC
+  * @tc.require:
+  */
+HWTEST_F(HdfMpmcQueueTest, HdfTaskQueueDestroyDrain004, TestSize.Level1)
+{
+    static struct HdfTaskType tasks[TASK_QUEUE_TASK_COUNT];
+    g_taskRunCount = 0;
+    struct HdfTaskQueue *queue = HdfTaskQueueCreate(CountTask, "mpmc_drain_test");
+    ASSERT_NE(queue, nullptr);
+
+    /* more tasks than the ring holds, so some go through the overflow list */
+    for (int i = 0; i < TASK_QUEUE_TASK_COUNT; ++i) {
+        tasks[i].func = nullptr;
+        HdfTaskEnqueue(queue, &tasks[i]);
+    }
+    HdfTaskQueueDestroy(queue);
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(TASK_QUEUE_WAIT_MS);
+    while (g_taskRunCount.load() < TASK_QUEUE_TASK_COUNT && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    ASSERT_EQ(g_taskRunCount.load(), TASK_QUEUE_TASK_COUNT);
+}
@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ *
+ * HDF is dual licensed: you can use it either under the terms of
+ * the GPL, or the BSD license, at your option.
+ * See the LICENSE file in the root of this repository for complete details.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <gtest/gtest.h>
+#include "devhost_service_clnt.h"
+#include "devmgr_service.h"
+#include "hdf_base.h"
+#include "hdf_device_desc.h"
+#include "hdf_device_info.h"
+
+using namespace testing::ext;
+
+static const uint16_t ON_DEMAND_TEST_HOST_ID = 0xfe;
+static const char *ON_DEMAND_TEST_SERVICE = "on_demand_test_service";
+static const int ON_DEMAND_TEST_LOAD_MS = 100;
+
+static std::atomic<int> g_addCount(0);
+static std::atomic<bool> g_loadStarted(false);
+static int g_loadMs = 0;
+static int g_reentrantRet = HDF_SUCCESS;
+
+// stands for a driver whose Init gets its own service, which is not published yet
+static int OnDemandTestAddDevice(struct IDevHostService *hostService, const struct HdfDeviceInfo *devInfo)
+{
+    (void)hostService;
+    g_addCount++;
+    g_loadStarted = true;
+    g_reentrantRet = DevmgrServiceLoadOnDemand((struct DevmgrService *)DevmgrServiceGetInstance(), devInfo->svcName);
+    // keep the load in flight for callers on other threads
+    std::this_thread::sleep_for(std::chrono::milliseconds(g_loadMs));
+    return HDF_SUCCESS;
+}
+
+class HdfOnDemandTest : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        g_addCount = 0;
+        g_loadStarted = false;
+        g_loadMs = 0;
+        g_reentrantRet = HDF_SUCCESS;
+        devmgr_ = (struct DevmgrService *)DevmgrServiceGetInstance();
+        ASSERT_NE(devmgr_, nullptr);
+        hostService_.AddDevice = OnDemandTestAddDevice;
+        hostClnt_.hostService = &hostService_;
+        hostClnt_.hostId = ON_DEMAND_TEST_HOST_ID;
+        hostClnt_.hostName = "on_demand_test_host";
+        hostClnt_.hostPid = 0; // already running, nothing to start
+        HdfSListInit(&hostClnt_.unloadDevInfos);
+        HdfSListInit(&hostClnt_.dynamicDevInfos);
+        deviceInfo_.deviceId = MK_DEVID(ON_DEMAND_TEST_HOST_ID, 0, 0);
+        deviceInfo_.moduleName = ON_DEMAND_TEST_SERVICE;
+        deviceInfo_.svcName = ON_DEMAND_TEST_SERVICE;
+        deviceInfo_.isDynamic = true;
+        HdfSListAdd(&hostClnt_.dynamicDevInfos, &deviceInfo_.node);
+        DListInsertTail(&hostClnt_.node, &devmgr_->hosts);
+    }
+    void TearDown() override
+    {
+        if (devmgr_ != nullptr) {
+            DListRemove(&hostClnt_.node);
+        }
+    }
+
+    struct DevmgrService *devmgr_ = nullptr;
+    struct HdfDeviceInfo deviceInfo_ = {};
+
+private:
+    struct IDevHostService hostService_ = {};
+    struct DevHostServiceClnt hostClnt_ = {};
+};
+
+/**
+  * @tc.name: HdfOnDemandPreloadValue001
+  * @tc.desc: the on demand policy keeps the existing preload values and stays below the invalid sentinel
+  * @tc.type: FUNC
+  * @tc.require:
+  */
+HWTEST_F(HdfOnDemandTest, HdfOnDemandPreloadValue001, TestSize.Level1)
+{
+    EXPECT_EQ(DEVICE_PRELOAD_ENABLE, 0);
+    EXPECT_EQ(DEVICE_PRELOAD_ENABLE_STEP2, 1);
+    EXPECT_EQ(DEVICE_PRELOAD_DISABLE, 2);
+    EXPECT_EQ(DEVICE_PRELOAD_ON_DEMAND, 3);
+    EXPECT_EQ(DEVICE_PRELOAD_INVALID, 4);
+}
+
+/**
+  * @tc.name: HdfOnDemandLoad002
+  * @tc.desc: an on demand device is loaded once and a lookup from its own init does not wait for the load
+  * @tc.type: FUNC
+  * @tc.require:
+  */
+HWTEST_F(HdfOnDemandTest, HdfOnDemandLoad002, TestSize.Level1)
+{
+    deviceInfo_.preload = DEVICE_PRELOAD_ON_DEMAND;
+    ASSERT_EQ(DevmgrServiceLoadOnDemand(devmgr_, ON_DEMAND_TEST_SERVICE), HDF_SUCCESS);
+    EXPECT_EQ(g_addCount.load(), 1);
+    EXPECT_EQ(g_reentrantRet, HDF_ERR_DEVICE_BUSY);
+    EXPECT_TRUE(DListIsEmpty(&devmgr_->loadRequests));
+}
+
+/**
+  * @tc.name: HdfOnDemandNotOnDemand003
+  * @tc.desc: getting the service of a dynamic device without the on demand policy does not load it
+  * @tc.type: FUNC
+  * @tc.require:
+  */
+HWTEST_F(HdfOnDemandTest, HdfOnDemandNotOnDemand003, TestSize.Level1)
+{
+    deviceInfo_.preload = DEVICE_PRELOAD_DISABLE;
+    EXPECT_EQ(DevmgrServiceLoadOnDemand(devmgr_, ON_DEMAND_TEST_SERVICE), HDF_DEV_ERR_NO_DEVICE);
+    EXPECT_EQ(DevmgrServiceLoadOnDemand(devmgr_, "on_demand_no_such_service"), HDF_DEV_ERR_NO_DEVICE);
+    EXPECT_EQ(g_addCount.load(), 0);
+}
+
+/**
+  * @tc.name: HdfOnDemandJoin004
+  * @tc.desc: a caller on another thread waits for the load in flight and shares its result
+  * @tc.type: FUNC
+  * @tc.require:
+  */
+HWTEST_F(HdfOnDemandTest, HdfOnDemandJoin004, TestSize.Level1)
+{
+    int loaderRet = HDF_FAILURE;
+    deviceInfo_.preload = DEVICE_PRELOAD_ON_DEMAND;
+    g_loadMs = ON_DEMAND_TEST_LOAD_MS;
+
+    std::thread loader([this, &loaderRet]() {
+        loaderRet = DevmgrServiceLoadOnDemand(devmgr_, ON_DEMAND_TEST_SERVICE);
+    });
+    while (!g_loadStarted) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(DevmgrServiceLoadOnDemand(devmgr_, ON_DEMAND_TEST_SERVICE), HDF_SUCCESS);
+    loader.join();
+    EXPECT_EQ(loaderRet, HDF_SUCCESS);
+    EXPECT_EQ(g_addCount.load(), 1);
+    EXPECT_EQ(g_reentrantRet, HDF_ERR_DEVICE_BUSY);
+    EXPECT_TRUE(DListIsEmpty(&devmgr_->loadRequests));
+}
@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ *
+ * HDF is dual licensed: you can use it either under the terms of
+ * the GPL, or the BSD license, at your option.
+ * See the LICENSE file in the root of this repository for complete details.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include "hdf_once.h"
+
+using namespace testing::ext;
+
+static const int ONCE_TEST_THREADS = 8;
+static const int ONCE_TEST_INIT_MS = 20;
+
+struct OnceTestObject {
+    int value;
+};
+
+static std::atomic<int> g_onceInitCount(0);
+static OnceTestObject g_onceObject;
+
+static void *OnceTestInit(void *arg)
+{
+    g_onceInitCount++;
+    // keep the other callers arriving while the initializer runs
+    std::this_thread::sleep_for(std::chrono::milliseconds(ONCE_TEST_INIT_MS));
+    auto object = static_cast<OnceTestObject *>(arg);
+    object->value = 1;
+    return object;
+}
+
+static void *OnceTestInitFail(void *arg)
+{
+    (void)arg;
+    g_onceInitCount++;
+    return nullptr;
+}
+
+class HdfOnceTest : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        g_onceInitCount = 0;
+        g_onceObject.value = 0;
+    }
+    void TearDown() override {}
+};
+
+/**
+  * @tc.name: HdfOnceConcurrent001
+  * @tc.desc: callers arriving during the initialization wait for it and see the initialized object
+  * @tc.type: FUNC
+  * @tc.require:
+  */
+HWTEST_F(HdfOnceTest, HdfOnceConcurrent001, TestSize.Level1)
+{
+    static struct HdfOnce once = HDF_ONCE_INIT;
+    std::vector<std::thread> threads;
+    std::vector<int> values(ONCE_TEST_THREADS, 0);
+
+    ASSERT_EQ(HdfOncePeek(&once), nullptr);
+    for (int i = 0; i < ONCE_TEST_THREADS; ++i) {
+        threads.emplace_back([&values, i]() {
+            auto object = static_cast<OnceTestObject *>(HdfOnceRun(&once, OnceTestInit, &g_onceObject));
+            values[i] = (object == &g_onceObject) ? object->value : -1;
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    ASSERT_EQ(g_onceInitCount.load(), 1);
+    for (int value : values) {
+        ASSERT_EQ(value, 1);
+    }
+    ASSERT_EQ(HdfOncePeek(&once), &g_onceObject);
+    ASSERT_EQ(HdfOnceRun(&once, OnceTestInit, nullptr), &g_onceObject);
+    ASSERT_EQ(g_onceInitCount.load(), 1);
+}
+
+/**
+  * @tc.name: HdfOnceFailed002
+  * @tc.desc: a failed initialization is reported to every caller and not retried
+  * @tc.type: FUNC
+  * @tc.require:
+  */
+HWTEST_F(HdfOnceTest, HdfOnceFailed002, TestSize.Level1)
+{
+    static struct HdfOnce once = HDF_ONCE_INIT;
+
+    ASSERT_EQ(HdfOnceRun(&once, OnceTestInitFail, nullptr), nullptr);
+    ASSERT_EQ(HdfOnceRun(&once, OnceTestInitFail, nullptr), nullptr);
+    ASSERT_EQ(HdfOncePeek(&once), nullptr);
+    ASSERT_EQ(g_onceInitCount.load(), 1);
+    ASSERT_EQ(HdfOnceRun(nullptr, OnceTestInitFail, nullptr), nullptr);
+}
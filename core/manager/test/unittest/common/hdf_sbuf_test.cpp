@@ -11,15 +11,23 @@
 #include <map>
 #include <memory>
 #include <random>
+#include <vector>
 #include <cstring>
 #include <gtest/gtest.h>
 #include <hdf_sbuf.h>
+#include <hdf_sbuf_pool.h>
 using namespace testing::ext;
 
 static const int DEFAULT_SBUF_SIZE = 256;
 static const int DEFAULT_LOOP_COUNT = 500;
 static const int DEFAULT_BIG_LOOP_COUNT = 1000;
 static const int DATA_MOD = 26;
+static const uint32_t SG_REF_BUFFER_SIZE = 4096;
+
+static void SbufTestRefRelease(void *priv)
+{
+    (*static_cast<int *>(priv))++;
+}
 
 class HdfSBufTest : public ::testing::Test {
 protected:
@@ -808,3 +816,196 @@ HWTEST_F(HdfSBufTest, SbufTestSbufMoveHalf019, TestSize.Level1)
     HdfSbufRecycle(sBuf);
     HdfSbufRecycle(readBuf);
 }
+
+/**
+  * @tc.name: SbufTestPoolReuse020
+  * @tc.desc: recycled data blocks are served again from the pool
+  * @tc.type: FUNC
+  * @tc.require: AR000F869B
+  */
+HWTEST_F(HdfSBufTest, SbufTestPoolReuse020, TestSize.Level1)
+{
+    size_t blockSize = 0;
+    uint32_t cacheId = HdfSbufPoolDataClass(DEFAULT_SBUF_SIZE, &blockSize);
+    ASSERT_EQ(cacheId, static_cast<uint32_t>(SBUF_POOL_DATA_256));
+    ASSERT_EQ(blockSize, static_cast<size_t>(DEFAULT_SBUF_SIZE));
+
+    HdfSbufPoolDrain();
+    struct HdfSbufPoolStat before;
+    ASSERT_EQ(HdfSbufPoolGetStat(cacheId, &before), HDF_SUCCESS);
+    ASSERT_EQ(before.cached, 0u);
+
+    void *block = HdfSbufPoolObtain(cacheId, blockSize);
+    ASSERT_NE(block, nullptr);
+    HdfSbufPoolRecycle(cacheId, block);
+
+    void *again = HdfSbufPoolObtain(cacheId, blockSize);
+    ASSERT_EQ(again, block);
+
+    struct HdfSbufPoolStat after;
+    ASSERT_EQ(HdfSbufPoolGetStat(cacheId, &after), HDF_SUCCESS);
+    ASSERT_EQ(after.miss, before.miss + 1);
+    ASSERT_EQ(after.hit, before.hit + 1);
+    ASSERT_EQ(after.cached, 0u);
+    HdfSbufPoolRecycle(cacheId, again);
+
+    HdfSBuf *sBuf = HdfSbufObtainDefaultSize();
+    ASSERT_NE(sBuf, nullptr);
+    ASSERT_TRUE(HdfSbufWriteUint32(sBuf, DEFAULT_LOOP_COUNT));
+    HdfSbufRecycle(sBuf);
+    sBuf = HdfSbufObtainDefaultSize();
+    ASSERT_NE(sBuf, nullptr);
+    uint32_t value = 0;
+    ASSERT_FALSE(HdfSbufReadUint32(sBuf, &value));
+    HdfSbufRecycle(sBuf);
+}
+
+/**
+  * @tc.name: SbufTestPoolHighWater021
+  * @tc.desc: recycling beyond the cache limit releases blocks to heap
+  * @tc.type: FUNC
+  * @tc.require: AR000F869B
+  */
+HWTEST_F(HdfSBufTest, SbufTestPoolHighWater021, TestSize.Level1)
+{
+    const uint32_t limit = 2;
+    const int blockCount = 4;
+    uint32_t cacheId = SBUF_POOL_DATA_256;
+    struct HdfSbufPoolStat origin;
+    ASSERT_EQ(HdfSbufPoolGetStat(cacheId, &origin), HDF_SUCCESS);
+    ASSERT_EQ(HdfSbufPoolSetLimit(cacheId, limit), HDF_SUCCESS);
+
+    struct HdfSbufPoolStat before;
+    ASSERT_EQ(HdfSbufPoolGetStat(cacheId, &before), HDF_SUCCESS);
+    ASSERT_LE(before.cached, limit);
+
+    void *blocks[blockCount] = { nullptr };
+    for (int i = 0; i < blockCount; ++i) {
+        blocks[i] = HdfSbufPoolObtain(cacheId, DEFAULT_SBUF_SIZE);
+        ASSERT_NE(blocks[i], nullptr);
+    }
+    for (int i = 0; i < blockCount; ++i) {
+        HdfSbufPoolRecycle(cacheId, blocks[i]);
+    }
+
+    struct HdfSbufPoolStat after;
+    ASSERT_EQ(HdfSbufPoolGetStat(cacheId, &after), HDF_SUCCESS);
+    ASSERT_EQ(after.cached, limit);
+    ASSERT_EQ(after.overflow, before.overflow + blockCount - limit);
+
+    ASSERT_EQ(HdfSbufPoolSetLimit(cacheId, 0), HDF_SUCCESS);
+    ASSERT_EQ(HdfSbufPoolGetStat(cacheId, &after), HDF_SUCCESS);
+    ASSERT_EQ(after.cached, 0u);
+    ASSERT_EQ(HdfSbufPoolSetLimit(cacheId, origin.limit), HDF_SUCCESS);
+}
+
+/**
+  * @tc.name: SbufTestSgWriteRef022
+  * @tc.desc: sg sbuf keeps buffers written by reference until recycled
+  * @tc.type: FUNC
+  * @tc.require: AR000F869B
+  */
+HWTEST_F(HdfSBufTest, SbufTestSgWriteRef022, TestSize.Level1)
+{
+    HdfSBuf *sBuf = HdfSbufTypedObtain(SBUF_SG);
+    ASSERT_NE(sBuf, nullptr);
+
+    std::vector<uint8_t> payload(SG_REF_BUFFER_SIZE);
+    for (uint32_t i = 0; i < SG_REF_BUFFER_SIZE; ++i) {
+        payload[i] = static_cast<uint8_t>(i % DATA_MOD);
+    }
+    int released = 0;
+    ASSERT_TRUE(HdfSbufWriteUint32(sBuf, SG_REF_BUFFER_SIZE));
+    ASSERT_TRUE(HdfSbufWriteBufferRef(sBuf, payload.data(), SG_REF_BUFFER_SIZE, SbufTestRefRelease, &released));
+    ASSERT_TRUE(HdfSbufWriteUint32(sBuf, DEFAULT_LOOP_COUNT));
+    ASSERT_EQ(released, 0);
+
+    uint32_t value = 0;
+    ASSERT_TRUE(HdfSbufReadUint32(sBuf, &value));
+    ASSERT_EQ(value, SG_REF_BUFFER_SIZE);
+    const void *data = nullptr;
+    uint32_t readSize = 0;
+    ASSERT_TRUE(HdfSbufReadBuffer(sBuf, &data, &readSize));
+    ASSERT_EQ(readSize, SG_REF_BUFFER_SIZE);
+    ASSERT_EQ(memcmp(data, payload.data(), SG_REF_BUFFER_SIZE), 0);
+    ASSERT_TRUE(HdfSbufReadUint32(sBuf, &value));
+    ASSERT_EQ(value, static_cast<uint32_t>(DEFAULT_LOOP_COUNT));
+    ASSERT_EQ(released, 0);
+
+    HdfSbufRecycle(sBuf);
+    ASSERT_EQ(released, 1);
+}
+
+/**
+  * @tc.name: SbufTestSgCrossSegment023
+  * @tc.desc: sg sbuf reads values spanning segments and linearizes to the raw encoding
+  * @tc.type: FUNC
+  * @tc.require: AR000F869B
+  */
+HWTEST_F(HdfSBufTest, SbufTestSgCrossSegment023, TestSize.Level1)
+{
+    HdfSBuf *sBuf = HdfSbufTypedObtainCapacity(SBUF_SG, DEFAULT_SBUF_SIZE);
+    ASSERT_NE(sBuf, nullptr);
+
+    GenDataTable();
+    GenDataSequence(DEFAULT_LOOP_COUNT);
+    ASSERT_TRUE(PushDataSequence(sBuf));
+    std::string str(DEFAULT_SBUF_SIZE * 2, 'a');
+    ASSERT_TRUE(HdfSbufWriteString(sBuf, str.c_str()));
+    ASSERT_GT(HdfSbufGetDataSize(sBuf), static_cast<size_t>(DEFAULT_SBUF_SIZE));
+
+    ASSERT_TRUE(PullDataSequence(sBuf));
+    const char *readStr = HdfSbufReadString(sBuf);
+    ASSERT_NE(readStr, nullptr);
+    ASSERT_EQ(std::string(readStr), str);
+
+    size_t size = HdfSbufGetDataSize(sBuf);
+    uint8_t *linear = HdfSbufGetData(sBuf);
+    ASSERT_NE(linear, nullptr);
+    ASSERT_EQ(HdfSbufGetDataSize(sBuf), size);
+
+    HdfSBuf *rawBuf = HdfSbufBind(reinterpret_cast<uintptr_t>(linear), size);
+    ASSERT_NE(rawBuf, nullptr);
+    ASSERT_TRUE(PullDataSequence(rawBuf));
+    readStr = HdfSbufReadString(rawBuf);
+    ASSERT_NE(readStr, nullptr);
+    ASSERT_EQ(std::string(readStr), str);
+    HdfSbufRecycle(rawBuf);
+    HdfSbufRecycle(sBuf);
+}
+
+/**
+  * @tc.name: SbufTestRefRelease024
+  * @tc.desc: release callback of buffers written by reference
+  * @tc.type: FUNC
+  * @tc.require: AR000F869B
+  */
+HWTEST_F(HdfSBufTest, SbufTestRefRelease024, TestSize.Level1)
+{
+    uint8_t payload[DEFAULT_SBUF_SIZE] = { 0 };
+    int released = 0;
+
+    HdfSBuf *rawBuf = HdfSbufObtainDefaultSize();
+    ASSERT_NE(rawBuf, nullptr);
+    ASSERT_TRUE(HdfSbufWriteBufferRef(rawBuf, payload, sizeof(payload), SbufTestRefRelease, &released));
+    ASSERT_EQ(released, 1);
+    HdfSbufRecycle(rawBuf);
+    ASSERT_EQ(released, 1);
+
+    released = 0;
+    HdfSBuf *sBuf = HdfSbufTypedObtain(SBUF_SG);
+    ASSERT_NE(sBuf, nullptr);
+    ASSERT_TRUE(HdfSbufWriteBufferRef(sBuf, payload, sizeof(payload), SbufTestRefRelease, &released));
+    ASSERT_TRUE(HdfSbufWriteBufferRef(sBuf, payload, sizeof(payload), nullptr, nullptr));
+    HdfSbufFlush(sBuf);
+    ASSERT_EQ(released, 1);
+    ASSERT_EQ(HdfSbufGetDataSize(sBuf), 0u);
+
+    ASSERT_TRUE(HdfSbufWriteBufferRef(sBuf, payload, sizeof(payload), SbufTestRefRelease, &released));
+    HdfSBuf *moved = HdfSbufMove(sBuf);
+    ASSERT_NE(moved, nullptr);
+    HdfSbufRecycle(sBuf);
+    ASSERT_EQ(released, 1);
+    HdfSbufRecycle(moved);
+    ASSERT_EQ(released, 2);
+}
@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ *
+ * HDF is dual licensed: you can use it either under the terms of
+ * the GPL, or the BSD license, at your option.
+ * See the LICENSE file in the root of this repository for complete details.
+ */
+
+#ifndef HDF_BOOT_TRACE_H
+#define HDF_BOOT_TRACE_H
+
+#include "hdf_base.h"
+#include "hdf_sbuf.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+#define HDF_BOOT_TRACE_RING_SIZE 1024 // records kept, the oldest ones are overwritten
+#define HDF_BOOT_TRACE_DUMP_MAX 256   // records returned by one DEVMGR_DUMP_BOOT_TRACE call
+#define HDF_BOOT_TRACE_NAME_LEN 32
+#define HDF_BOOT_TRACE_NO_HOST 0xFFFF
+#define HDF_BOOT_TRACE_NO_DEVICE 0xFFFFFFFF // the phase is traced by service name only
+
+enum HdfBootTracePhase {
+    HDF_BOOT_PHASE_LOAD,        // devmgr asks a host to add the device
+    HDF_BOOT_PHASE_LAUNCH,      // host launches the device node, bind, init and publish included
+    HDF_BOOT_PHASE_BIND,
+    HDF_BOOT_PHASE_INIT,
+    HDF_BOOT_PHASE_PUBLISH,
+    HDF_BOOT_PHASE_ADD_SERVICE, // service manager records the published service
+    HDF_BOOT_PHASE_MAX,
+};
+
+enum HdfBootTraceFormat {
+    HDF_BOOT_TRACE_JSON,   // Chrome trace-event JSON document
+    HDF_BOOT_TRACE_BINARY, // array of struct HdfBootTraceRecord
+};
+
+/* Layout of the binary dump, names are truncated and always terminated. */
+struct HdfBootTraceRecord {
+    uint64_t beginUs;
+    uint32_t durationUs;
+    int32_t ret;
+    uint32_t deviceId;
+    uint16_t hostId;
+    uint8_t phase;
+    uint8_t reserved;
+    char moduleName[HDF_BOOT_TRACE_NAME_LEN];
+    char serviceName[HDF_BOOT_TRACE_NAME_LEN];
+};
+
+/*
+ * Boot tracing is compiled in with LOSCFG_DRIVERS_HDF_BOOT_TRACE only, otherwise the trace points
+ * below expand to nothing and DEVMGR_DUMP_BOOT_TRACE returns HDF_ERR_NOT_SUPPORT.
+ * HDF_BOOT_TRACE_DECLARE goes last among the declarations of a block, so the empty statement it
+ * leaves in a disabled build never precedes a declaration.
+ */
+#ifdef LOSCFG_DRIVERS_HDF_BOOT_TRACE
+uint64_t HdfBootTraceNow(void);
+void HdfBootTraceEnd(uint64_t beginUs, uint32_t phase, uint32_t deviceId, const char *moduleName,
+    const char *serviceName, int32_t ret);
+
+/*
+ * Dumps records from the sequence number in data, formatted as data asks.
+ * data: uint32 format, uint32 first sequence number, 0 for the oldest record kept.
+ * reply: uint32 next sequence number, uint32 record count, then a buffer holding the terminated JSON
+ * text or the records.
+ */
+int32_t HdfBootTraceDump(struct HdfSBuf *data, struct HdfSBuf *reply);
+
+#define HDF_BOOT_TRACE_DECLARE(stamp) uint64_t stamp = 0
+#define HDF_BOOT_TRACE_BEGIN(stamp) ((stamp) = HdfBootTraceNow())
+#define HDF_BOOT_TRACE_END(stamp, phase, deviceId, moduleName, serviceName, ret) \
+    HdfBootTraceEnd(stamp, phase, deviceId, moduleName, serviceName, ret)
+#else
+static inline int32_t HdfBootTraceDump(struct HdfSBuf *data, struct HdfSBuf *reply)
+{
+    (void)data;
+    (void)reply;
+    return HDF_ERR_NOT_SUPPORT;
+}
+
+#define HDF_BOOT_TRACE_DECLARE(stamp)
+#define HDF_BOOT_TRACE_BEGIN(stamp)
+#define HDF_BOOT_TRACE_END(stamp, phase, deviceId, moduleName, serviceName, ret)
+#endif /* LOSCFG_DRIVERS_HDF_BOOT_TRACE */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* HDF_BOOT_TRACE_H */
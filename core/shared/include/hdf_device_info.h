@@ -35,6 +35,8 @@ struct HdfDeviceInfo {
     const char *moduleName;
     const char *svcName;
     const char *deviceMatchAttr;
+    const char **depends; // services that must be published before this device loads
+    uint16_t dependCount;
 };
 
 struct HdfPrivateInfo {
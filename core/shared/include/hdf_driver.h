@@ -18,6 +18,8 @@ struct HdfDriver {
     uint16_t bus;
     struct DListHead node;
     void *priv;
+    struct HdfDriver *hashNext; // moduleName chain of the driver registry
+    uint32_t hashKey;
 };
 
 int32_t HdfRegisterDriverEntry(const struct HdfDriverEntry *entry);
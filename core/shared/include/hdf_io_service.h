@@ -26,11 +26,22 @@ extern "C" {
 #define HDF_LISTEN_EVENT_STOP _IO('b', 4)
 #define HDF_LISTEN_EVENT_WAKEUP _IO('b', 5)
 #define HDF_LISTEN_EVENT_EXIT _IO('b', 6)
+#define HDF_WRITE_READ_BATCH _IO('b', 7)
+#define HDF_WRITE_READ_BATCH_MAX 32
+#define HDF_LISTEN_EVENT_RING _IO('b', 8)
+#define HDF_READ_DEV_EVENT_RING _IO('b', 9)
+#define HDF_DEV_EVENT_RING_SIZE_MIN (4 * 1024)
+#define HDF_DEV_EVENT_RING_SIZE_MAX (1024 * 1024)
+#define HDF_DEV_EVENT_RECORD_ALIGN 8
+#define HDF_DEV_EVENT_RECORD_SIZE(dataSize) \
+    (((uint32_t)sizeof(struct HdfDevEventRecord) + (dataSize) + HDF_DEV_EVENT_RECORD_ALIGN - 1) & \
+    ~((uint32_t)HDF_DEV_EVENT_RECORD_ALIGN - 1))
 
 typedef enum {
     DEVMGR_LOAD_SERVICE = 0,
     DEVMGR_UNLOAD_SERVICE,
     DEVMGR_GET_SERVICE,
+    DEVMGR_DUMP_BOOT_TRACE,
 } DevMgrCmd;
 
 struct HdfWriteReadBuf {
@@ -43,6 +54,26 @@ struct HdfWriteReadBuf {
     int32_t cmdCode;
 };
 
+struct HdfWriteReadBatch {
+    uint32_t count;   // count of HdfWriteReadBuf entries, HDF_WRITE_READ_BATCH_MAX at most
+    uint32_t reserved;
+    uint64_t bwrs;    // array of HdfWriteReadBuf, dispatched in order
+    uint64_t results; // array of int32_t receiving the dispatch result of each entry
+};
+
+struct HdfDevEventRecord {
+    uint32_t id;   // event id
+    uint32_t size; // bytes of event data following the header, records are padded to HDF_DEV_EVENT_RECORD_ALIGN
+};
+
+struct HdfDevEventDrain {
+    uint64_t buffer;   // receives HdfDevEventRecord entries back to back
+    uint32_t size;     // bytes of buffer
+    uint32_t consumed; // bytes of records written to buffer
+    uint32_t count;    // count of records written to buffer
+    uint32_t dropped;  // events dropped because the ring was full since last drain
+};
+
 struct HdfIoService *HdfIoServicePublish(const char *serviceName, uint32_t mode);
 void HdfIoServiceRemove(struct HdfIoService *service);
 
@@ -50,6 +81,11 @@ struct HdfIoService *HdfIoServiceAdapterObtain(const char *serviceName);
 void HdfIoServiceAdapterRecycle(struct HdfIoService *service);
 struct HdfIoService *HdfIoServiceAdapterPublish(const char *serviceName, uint32_t mode) __attribute__((weak));
 void HdfIoServiceAdapterRemove(struct HdfIoService *service) __attribute__((weak));
+int32_t HdfIoServiceAdapterDispatchBatch(struct HdfIoService *service, struct HdfIoServiceCall *calls,
+    uint32_t count) __attribute__((weak));
+/* forces HdfIoServiceDispatchBatch onto the per-call path, for tests */
+void HdfIoServiceAdapterSetBatchSupported(bool supported) __attribute__((weak));
+int32_t HdfIoServiceAdapterSetEventRing(struct HdfIoService *service, uint32_t size) __attribute__((weak));
 int32_t HdfLoadDriverByServiceName(const char *serviceName);
 
 #ifdef __cplusplus
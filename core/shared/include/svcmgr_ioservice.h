@@ -33,6 +33,19 @@ struct ISvcMgrIoservice {
 struct ISvcMgrIoservice *SvcMgrIoserviceGet(void);
 void SvcMgrIoserviceRelease(struct ISvcMgrIoservice *svcmgr);
 
+struct HdfServiceWaiter;
+
+/*
+ * Starts waiting for the publication of serviceName, so a load triggered afterwards cannot be
+ * missed. A service published before is reported at once. All waiters share one service status
+ * listener, set up by the first of them. Returns NULL if the listener cannot be set up.
+ */
+struct HdfServiceWaiter *HdfServiceWaiterObtain(const char *serviceName);
+
+/* Blocks until the service is published or timeoutMs passed, returns HDF_ERR_TIMEOUT then. */
+int32_t HdfServiceWaiterWait(struct HdfServiceWaiter *waiter, uint32_t timeoutMs);
+void HdfServiceWaiterRecycle(struct HdfServiceWaiter *waiter);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
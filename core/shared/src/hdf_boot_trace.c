@@ -0,0 +1,195 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ *
+ * HDF is dual licensed: you can use it either under the terms of
+ * the GPL, or the BSD license, at your option.
+ * See the LICENSE file in the root of this repository for complete details.
+ */
+
+#include "hdf_boot_trace.h"
+
+#ifdef LOSCFG_DRIVERS_HDF_BOOT_TRACE
+#include "hdf_device.h"
+#include "hdf_log.h"
+#include "osal_atomic.h"
+#include "osal_mem.h"
+#include "osal_time.h"
+#include "securec.h"
+
+#define HDF_LOG_TAG hdf_boot_trace
+
+#define BOOT_TRACE_JSON_HEAD "{\"displayTimeUnit\":\"ms\",\"traceEvents\":["
+#define BOOT_TRACE_JSON_TAIL "]}"
+#define BOOT_TRACE_JSON_EVENT_MAX 320 // fixed text plus two names and six numbers of one event
+
+struct HdfBootTraceSlot {
+    OsalAtomic seq; // sequence number of the record plus one, 0 while it is written
+    struct HdfBootTraceRecord record;
+};
+
+static struct HdfBootTraceSlot g_bootTraceRing[HDF_BOOT_TRACE_RING_SIZE];
+static OsalAtomic g_bootTraceNext = { 0 };
+static OsalAtomic g_bootTraceFence = { 0 };
+
+static const char *g_bootTracePhaseNames[HDF_BOOT_PHASE_MAX] = {
+    [HDF_BOOT_PHASE_LOAD] = "load",
+    [HDF_BOOT_PHASE_LAUNCH] = "launch",
+    [HDF_BOOT_PHASE_BIND] = "bind",
+    [HDF_BOOT_PHASE_INIT] = "init",
+    [HDF_BOOT_PHASE_PUBLISH] = "publish",
+    [HDF_BOOT_PHASE_ADD_SERVICE] = "add_service",
+};
+
+uint64_t HdfBootTraceNow(void)
+{
+    OsalTimespec time = { 0, 0 };
+    (void)OsalGetTime(&time);
+    return time.sec * HDF_KILO_UNIT * HDF_KILO_UNIT + time.usec;
+}
+
+static void HdfBootTraceCopyName(char *dst, const char *src)
+{
+    uint32_t i;
+    if (src == NULL) {
+        dst[0] = '\0';
+        return;
+    }
+    // names go into JSON strings unescaped, so keep them to printable characters without quotes
+    for (i = 0; (i < HDF_BOOT_TRACE_NAME_LEN - 1) && (src[i] != '\0'); i++) {
+        dst[i] = (src[i] < ' ' || src[i] > '~' || src[i] == '"' || src[i] == '\\') ? '_' : src[i];
+    }
+    dst[i] = '\0';
+}
+
+/* The value returning OSAL atomics are full barriers, this is one that leaves no trace. */
+static void HdfBootTraceFence(void)
+{
+    (void)OsalAtomicIncReturn(&g_bootTraceFence);
+    (void)OsalAtomicDecReturn(&g_bootTraceFence);
+}
+
+void HdfBootTraceEnd(uint64_t beginUs, uint32_t phase, uint32_t deviceId, const char *moduleName,
+    const char *serviceName, int32_t ret)
+{
+    uint64_t now = HdfBootTraceNow();
+    uint32_t seq = (uint32_t)OsalAtomicIncReturn(&g_bootTraceNext) - 1;
+    struct HdfBootTraceSlot *slot = &g_bootTraceRing[seq % HDF_BOOT_TRACE_RING_SIZE];
+    struct HdfBootTraceRecord *record = &slot->record;
+
+    // readers see the slot invalidated before any field of it changes
+    OsalAtomicSet(&slot->seq, 0);
+    HdfBootTraceFence();
+    record->beginUs = beginUs;
+    record->durationUs = (uint32_t)(now - beginUs);
+    record->ret = ret;
+    record->deviceId = deviceId;
+    record->hostId = (deviceId == HDF_BOOT_TRACE_NO_DEVICE) ? HDF_BOOT_TRACE_NO_HOST : (uint16_t)HOSTID(deviceId);
+    record->phase = (uint8_t)phase;
+    record->reserved = 0;
+    HdfBootTraceCopyName(record->moduleName, moduleName);
+    HdfBootTraceCopyName(record->serviceName, serviceName);
+    HdfBootTraceFence();
+    OsalAtomicSet(&slot->seq, (int32_t)(seq + 1));
+}
+
+/* Copies a record unless a writer is overwriting it meanwhile. */
+static bool HdfBootTraceRead(uint32_t seq, struct HdfBootTraceRecord *record)
+{
+    const struct HdfBootTraceSlot *slot = &g_bootTraceRing[seq % HDF_BOOT_TRACE_RING_SIZE];
+    if ((uint32_t)OsalAtomicRead(&slot->seq) != seq + 1) {
+        return false;
+    }
+    HdfBootTraceFence();
+    (void)memcpy_s(record, sizeof(*record), &slot->record, sizeof(slot->record));
+    HdfBootTraceFence();
+    return (uint32_t)OsalAtomicRead(&slot->seq) == seq + 1;
+}
+
+static uint32_t HdfBootTraceCollect(uint32_t *start, struct HdfBootTraceRecord *records)
+{
+    uint32_t next = (uint32_t)OsalAtomicRead(&g_bootTraceNext);
+    uint32_t count = 0;
+    uint32_t seq;
+
+    if (next - *start > HDF_BOOT_TRACE_RING_SIZE) {
+        *start = next - HDF_BOOT_TRACE_RING_SIZE;
+    }
+    for (seq = *start; (seq != next) && (count < HDF_BOOT_TRACE_DUMP_MAX); seq++) {
+        if (HdfBootTraceRead(seq, &records[count])) {
+            count++;
+        }
+    }
+    *start = seq;
+    return count;
+}
+
+static bool HdfBootTraceWriteJson(struct HdfSBuf *reply, const struct HdfBootTraceRecord *records, uint32_t count)
+{
+    uint32_t size = sizeof(BOOT_TRACE_JSON_HEAD) + sizeof(BOOT_TRACE_JSON_TAIL) + count * BOOT_TRACE_JSON_EVENT_MAX;
+    uint32_t offset = sizeof(BOOT_TRACE_JSON_HEAD) - 1;
+    char *json = (char *)OsalMemAlloc(size);
+    uint32_t i;
+    bool ret = false;
+
+    if (json == NULL) {
+        return false;
+    }
+    (void)memcpy_s(json, size, BOOT_TRACE_JSON_HEAD, offset);
+    for (i = 0; i < count; i++) {
+        const struct HdfBootTraceRecord *record = &records[i];
+        // one row per host and hcs device, so concurrent loads show up side by side
+        int len = snprintf_s(json + offset, size - offset, size - offset - 1,
+            "%s{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%llu,\"dur\":%u,\"pid\":%u,\"tid\":%u,"
+            "\"args\":{\"module\":\"%s\",\"service\":\"%s\",\"ret\":%d}}",
+            (i == 0) ? "" : ",", (record->serviceName[0] != '\0') ? record->serviceName : record->moduleName,
+            (record->phase < HDF_BOOT_PHASE_MAX) ? g_bootTracePhaseNames[record->phase] : "unknown",
+            (unsigned long long)record->beginUs, record->durationUs, record->hostId,
+            (record->deviceId == HDF_BOOT_TRACE_NO_DEVICE) ? 0 : DEVICEID(record->deviceId),
+            record->moduleName, record->serviceName, record->ret);
+        if (len < 0) {
+            goto OUT;
+        }
+        offset += (uint32_t)len;
+    }
+    if (memcpy_s(json + offset, size - offset, BOOT_TRACE_JSON_TAIL, sizeof(BOOT_TRACE_JSON_TAIL)) != EOK) {
+        goto OUT;
+    }
+    // a page exceeds the string limit of sbuf, so the text goes as a buffer, terminator included
+    ret = HdfSbufWriteBuffer(reply, json, offset + sizeof(BOOT_TRACE_JSON_TAIL));
+OUT:
+    OsalMemFree(json);
+    return ret;
+}
+
+int32_t HdfBootTraceDump(struct HdfSBuf *data, struct HdfSBuf *reply)
+{
+    uint32_t format = HDF_BOOT_TRACE_JSON;
+    uint32_t start = 0;
+    uint32_t count;
+    struct HdfBootTraceRecord *records = NULL;
+    bool written = false;
+
+    if (reply == NULL) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+    if (data != NULL) {
+        (void)HdfSbufReadUint32(data, &format);
+        (void)HdfSbufReadUint32(data, &start);
+    }
+    if (format != HDF_BOOT_TRACE_JSON && format != HDF_BOOT_TRACE_BINARY) {
+        HDF_LOGE("%s: unknown boot trace format %u", __func__, format);
+        return HDF_ERR_INVALID_PARAM;
+    }
+    records = (struct HdfBootTraceRecord *)OsalMemAlloc(sizeof(*records) * HDF_BOOT_TRACE_DUMP_MAX);
+    if (records == NULL) {
+        return HDF_ERR_MALLOC_FAIL;
+    }
+    count = HdfBootTraceCollect(&start, records);
+    if (HdfSbufWriteUint32(reply, start) && HdfSbufWriteUint32(reply, count)) {
+        written = (format == HDF_BOOT_TRACE_JSON) ? HdfBootTraceWriteJson(reply, records, count) :
+            HdfSbufWriteBuffer(reply, records, sizeof(*records) * count);
+    }
+    OsalMemFree(records);
+    return written ? HDF_SUCCESS : HDF_FAILURE;
+}
+#endif /* LOSCFG_DRIVERS_HDF_BOOT_TRACE */
@@ -28,6 +28,8 @@ void HdfDeviceInfoConstruct(struct HdfDeviceInfo *deviceInfo)
     deviceInfo->svcName = NULL;
     deviceInfo->moduleName = NULL;
     deviceInfo->deviceMatchAttr = NULL;
+    deviceInfo->depends = NULL;
+    deviceInfo->dependCount = 0;
 }
 
 struct HdfDeviceInfo *HdfDeviceInfoNewInstance(void)
@@ -45,6 +47,7 @@ struct HdfDeviceInfo *HdfDeviceInfoNewInstance(void)
 void HdfDeviceInfoFreeInstance(struct HdfDeviceInfo *deviceInfo)
 {
     if (deviceInfo != NULL) {
+        OsalMemFree(deviceInfo->depends);
         OsalMemFree(deviceInfo);
     }
 }
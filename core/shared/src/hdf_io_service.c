@@ -19,6 +19,38 @@ void HdfIoServiceRecycle(struct HdfIoService *service)
     HdfIoServiceAdapterRecycle(service);
 }
 
+int32_t HdfIoServiceDispatchBatch(struct HdfIoService *service, struct HdfIoServiceCall *calls, uint32_t count)
+{
+    uint32_t i;
+    if (service == NULL || service->dispatcher == NULL || service->dispatcher->Dispatch == NULL ||
+        calls == NULL || count == 0) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+
+    if (HdfIoServiceAdapterDispatchBatch != NULL) {
+        return HdfIoServiceAdapterDispatchBatch(service, calls, count);
+    }
+
+    for (i = 0; i < count; i++) {
+        calls[i].status = service->dispatcher->Dispatch(&service->object, calls[i].cmdId, calls[i].data,
+            calls[i].reply);
+    }
+    return HDF_SUCCESS;
+}
+
+int32_t HdfIoServiceSetEventRing(struct HdfIoService *service, uint32_t size)
+{
+    if (service == NULL || size == 0) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+
+    if (HdfIoServiceAdapterSetEventRing != NULL) {
+        return HdfIoServiceAdapterSetEventRing(service, size);
+    }
+
+    return HDF_ERR_NOT_SUPPORT;
+}
+
 struct HdfIoService *HdfIoServicePublish(const char *serviceName, uint32_t mode)
 {
     if (HdfIoServiceAdapterPublish != NULL) {
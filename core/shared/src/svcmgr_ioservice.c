@@ -11,9 +11,15 @@
 #include "hdf_dlist.h"
 #include "hdf_io_service_if.h"
 #include "hdf_log.h"
+#include "hdf_once.h"
 #include "hdf_sbuf.h"
 #include "ioservstat_listener.h"
 #include "osal_mem.h"
+#include "osal_mutex.h"
+#include "osal_sem.h"
+#include "securec.h"
+
+#define SVC_LISTEN_ALL_CLASS (DEVICE_CLASS_MAX - 1)
 
 struct SvcMgrIoservice {
     struct ISvcMgrIoservice svcmgr;
@@ -21,6 +27,35 @@ struct SvcMgrIoservice {
     struct DListHead listeners;
 };
 
+struct HdfServiceWaiter {
+    struct DListHead node;
+    char *serviceName;
+    struct OsalSem published;
+    bool posted;
+};
+
+struct HdfPublishedService {
+    struct DListHead node;
+    char *serviceName;
+};
+
+/*
+ * All waiters of the process share one svcmgr ioservice and one status listener, set up by the first
+ * waiter and kept afterwards. The listener tracks the published services, so a waiter coming later
+ * learns about a service published before it.
+ */
+struct HdfServiceWaiterHub {
+    struct ISvcMgrIoservice *svcmgr;
+    struct ServiceStatusListener *listener;
+    struct OsalMutex mutex;
+    struct DListHead waiters;
+    struct DListHead services;
+};
+
+static struct HdfServiceWaiterHub g_serviceWaiterHub;
+/* publishes g_serviceWaiterHub once its mutex is created */
+static struct HdfOnce g_serviceWaiterHubOnce = HDF_ONCE_INIT;
+
 static int32_t SetListenClass(struct SvcMgrIoservice *svcmgrInst, uint16_t devClass)
 {
     struct HdfSBuf *data = HdfSbufObtainDefaultSize();
@@ -127,4 +162,186 @@ void SvcMgrIoserviceRelease(struct ISvcMgrIoservice *svcmgr)
     struct SvcMgrIoservice *svcmgrInst = CONTAINER_OF(svcmgr, struct SvcMgrIoservice, svcmgr);
     HdfIoServiceRecycle(svcmgrInst->iosvc);
     OsalMemFree(svcmgrInst);
-}
\ No newline at end of file
+}
+
+static char *HdfServiceWaiterNameDup(const char *serviceName)
+{
+    size_t len = strlen(serviceName) + 1;
+    char *name = OsalMemAlloc(len);
+    if (name != NULL && memcpy_s(name, len, serviceName, len) != EOK) {
+        OsalMemFree(name);
+        return NULL;
+    }
+    return name;
+}
+
+static struct HdfPublishedService *HdfServiceWaiterHubFindService(
+    struct HdfServiceWaiterHub *hub, const char *serviceName)
+{
+    struct HdfPublishedService *service = NULL;
+    DLIST_FOR_EACH_ENTRY(service, &hub->services, struct HdfPublishedService, node) {
+        if (strcmp(service->serviceName, serviceName) == 0) {
+            return service;
+        }
+    }
+    return NULL;
+}
+
+static void HdfServiceWaiterHubPublish(struct HdfServiceWaiterHub *hub, const char *serviceName)
+{
+    struct HdfServiceWaiter *waiter = NULL;
+    struct HdfPublishedService *service = HdfServiceWaiterHubFindService(hub, serviceName);
+
+    if (service == NULL) {
+        service = OsalMemCalloc(sizeof(*service));
+        if (service != NULL) {
+            service->serviceName = HdfServiceWaiterNameDup(serviceName);
+        }
+        if (service == NULL || service->serviceName == NULL) {
+            HDF_LOGE("%s: failed to record service %s", __func__, serviceName);
+            OsalMemFree(service);
+        } else {
+            DListInsertTail(&service->node, &hub->services);
+        }
+    }
+    DLIST_FOR_EACH_ENTRY(waiter, &hub->waiters, struct HdfServiceWaiter, node) {
+        if (!waiter->posted && strcmp(waiter->serviceName, serviceName) == 0) {
+            waiter->posted = true;
+            (void)OsalSemPost(&waiter->published);
+        }
+    }
+}
+
+static void HdfServiceWaiterHubUnpublish(struct HdfServiceWaiterHub *hub, const char *serviceName)
+{
+    struct HdfPublishedService *service = HdfServiceWaiterHubFindService(hub, serviceName);
+    if (service != NULL) {
+        DListRemove(&service->node);
+        OsalMemFree(service->serviceName);
+        OsalMemFree(service);
+    }
+}
+
+// runs on the event thread of the shared svcmgr ioservice
+static void HdfServiceWaiterHubOnStatus(struct ServiceStatusListener *listener, struct ServiceStatus *status)
+{
+    struct HdfServiceWaiterHub *hub = listener->priv;
+    if (hub == NULL || status->serviceName == NULL) {
+        return;
+    }
+    OsalMutexLock(&hub->mutex);
+    if (status->status == SERVIE_STATUS_STOP) {
+        HdfServiceWaiterHubUnpublish(hub, status->serviceName);
+    } else {
+        HdfServiceWaiterHubPublish(hub, status->serviceName);
+    }
+    OsalMutexUnlock(&hub->mutex);
+}
+
+static void *HdfServiceWaiterHubInit(void *arg)
+{
+    struct HdfServiceWaiterHub *hub = (struct HdfServiceWaiterHub *)arg;
+    DListHeadInit(&hub->waiters);
+    DListHeadInit(&hub->services);
+    if (OsalMutexInit(&hub->mutex) != HDF_SUCCESS) {
+        HDF_LOGE("%s: failed to init service waiter mutex", __func__);
+        return NULL;
+    }
+    return hub;
+}
+
+// called with the hub mutex held, a failed setup is retried by the next waiter
+static int32_t HdfServiceWaiterHubListen(struct HdfServiceWaiterHub *hub)
+{
+    if (hub->listener != NULL) {
+        return HDF_SUCCESS;
+    }
+    if (hub->svcmgr == NULL) {
+        hub->svcmgr = SvcMgrIoserviceGet();
+        if (hub->svcmgr == NULL) {
+            return HDF_DEV_ERR_NO_DEVICE_SERVICE;
+        }
+    }
+    hub->listener = IoServiceStatusListenerNewInstance();
+    if (hub->listener == NULL) {
+        return HDF_ERR_MALLOC_FAIL;
+    }
+    hub->listener->callback = HdfServiceWaiterHubOnStatus;
+    hub->listener->priv = hub;
+    if (hub->svcmgr->RegisterServiceStatusListener(hub->svcmgr, hub->listener, SVC_LISTEN_ALL_CLASS) !=
+        HDF_SUCCESS) {
+        IoServiceStatusListenerFree(hub->listener);
+        hub->listener = NULL;
+        return HDF_FAILURE;
+    }
+    return HDF_SUCCESS;
+}
+
+void HdfServiceWaiterRecycle(struct HdfServiceWaiter *waiter)
+{
+    struct HdfServiceWaiterHub *hub = HdfOncePeek(&g_serviceWaiterHubOnce);
+    // waiters are only obtained once the hub is published
+    if (waiter == NULL || hub == NULL) {
+        return;
+    }
+    OsalMutexLock(&hub->mutex);
+    DListRemove(&waiter->node);
+    OsalMutexUnlock(&hub->mutex);
+    (void)OsalSemDestroy(&waiter->published);
+    OsalMemFree(waiter->serviceName);
+    OsalMemFree(waiter);
+}
+
+struct HdfServiceWaiter *HdfServiceWaiterObtain(const char *serviceName)
+{
+    struct HdfServiceWaiterHub *hub = NULL;
+    struct HdfServiceWaiter *waiter = NULL;
+
+    if (serviceName == NULL) {
+        return NULL;
+    }
+    hub = HdfOnceRun(&g_serviceWaiterHubOnce, HdfServiceWaiterHubInit, &g_serviceWaiterHub);
+    if (hub == NULL) {
+        return NULL;
+    }
+    waiter = OsalMemCalloc(sizeof(*waiter));
+    if (waiter == NULL) {
+        return NULL;
+    }
+    waiter->serviceName = HdfServiceWaiterNameDup(serviceName);
+    if (waiter->serviceName == NULL || OsalSemInit(&waiter->published, 0) != HDF_SUCCESS) {
+        OsalMemFree(waiter->serviceName);
+        OsalMemFree(waiter);
+        return NULL;
+    }
+
+    OsalMutexLock(&hub->mutex);
+    if (HdfServiceWaiterHubListen(hub) != HDF_SUCCESS) {
+        OsalMutexUnlock(&hub->mutex);
+        HDF_LOGE("%s: failed to listen for service %s", __func__, serviceName);
+        (void)OsalSemDestroy(&waiter->published);
+        OsalMemFree(waiter->serviceName);
+        OsalMemFree(waiter);
+        return NULL;
+    }
+    if (HdfServiceWaiterHubFindService(hub, serviceName) != NULL) {
+        waiter->posted = true;
+        (void)OsalSemPost(&waiter->published);
+    }
+    DListInsertTail(&waiter->node, &hub->waiters);
+    OsalMutexUnlock(&hub->mutex);
+    return waiter;
+}
+
+int32_t HdfServiceWaiterWait(struct HdfServiceWaiter *waiter, uint32_t timeoutMs)
+{
+    if (waiter == NULL) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+    if (OsalSemWait(&waiter->published, timeoutMs) != HDF_SUCCESS) {
+        return HDF_ERR_TIMEOUT;
+    }
+    // let a later wait on the same waiter return at once
+    (void)OsalSemPost(&waiter->published);
+    return HDF_SUCCESS;
+}
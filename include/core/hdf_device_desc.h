@@ -78,7 +78,8 @@ typedef enum {
     DEVICE_PRELOAD_ENABLE = 0, /**< The driver is loaded during system startup by default. */
     DEVICE_PRELOAD_ENABLE_STEP2, /**< The driver is loaded after OS startup if quick start is enabled. */
     DEVICE_PRELOAD_DISABLE,     /**< The driver is not loaded during system startup by default. */
-    DEVICE_PRELOAD_INVALID     /**< The loading policy is incorrect. */
+    DEVICE_PRELOAD_ON_DEMAND,   /**< The driver is loaded when its service is obtained for the first time. */
+    DEVICE_PRELOAD_INVALID      /**< The loading policy is incorrect. */
 } DevicePreload;
 
 /**
@@ -133,6 +133,22 @@ struct HdfIoService {
     void *priv;
 };
 
+/**
+ * @brief Defines a driver service call submitted through {@link HdfIoServiceDispatchBatch}.
+ *
+ * @since 1.0
+ */
+struct HdfIoServiceCall {
+    /** Command word of the function */
+    int cmdId;
+    /** Pointer to the data passed to the driver. The value can be a null pointer. */
+    struct HdfSBuf *data;
+    /** Pointer to the data returned by the driver. The value can be a null pointer. */
+    struct HdfSBuf *reply;
+    /** Result of the call returned by the driver, which is filled in by the HDF */
+    int32_t status;
+};
+
 /**
  * @brief Defines a driver service group object.
  *
@@ -143,6 +159,40 @@ struct HdfIoServiceGroup {
     struct HdfObject object;
 };
 
+/**
+ * @brief Defines the maximum count of event dispatch workers of a driver service group.
+ *
+ * @since 1.0
+ */
+#define HDF_IO_SERVICE_GROUP_WORKER_MAX 16
+
+/**
+ * @brief Defines the maximum depth of the event queue of a dispatch worker.
+ *
+ * @since 1.0
+ */
+#define HDF_IO_SERVICE_GROUP_QUEUE_DEPTH_MAX 4096
+
+/**
+ * @brief Defines the statistics of the event dispatch workers of a driver service group.
+ *
+ * @since 1.0
+ */
+struct HdfIoServiceGroupDispatchStat {
+    /** Count of dispatch workers */
+    uint32_t workerCount;
+    /** Depth of the event queue of each worker */
+    uint32_t queueDepth;
+    /** Count of events waiting in the worker queues */
+    uint32_t queued;
+    /** Highest count of events waiting in a single worker queue */
+    uint32_t maxQueued;
+    /** Count of events handed to listeners */
+    uint64_t dispatched;
+    /** Count of events that had to wait for a full worker queue */
+    uint64_t blocked;
+};
+
 /**
  * @brief Obtains an instance of the driver service group object.
  *
@@ -211,6 +261,37 @@ int32_t HdfIoServiceGroupRegisterListener(struct HdfIoServiceGroup *group, struc
  */
 int32_t HdfIoServiceGroupUnregisterListener(struct HdfIoServiceGroup *group, struct HdfDevEventlistener *listener);
 
+/**
+ * @brief Attaches event dispatch workers to a specified driver service group.
+ *
+ * Without workers, the listener thread of the group calls all listeners itself, so that one slow listener
+ * delays the events of every service in the group. With workers, the listener thread only reads events and
+ * queues them to the workers. Events of one service are always handled by the same worker, so they reach
+ * the listeners in the order they are reported. When the queue of a worker is full, the listener thread waits
+ * until the worker catches up.
+ *
+ * @param group Indicates the pointer to the driver service group object.
+ * @param workerCount Indicates the count of workers, at most <b>HDF_IO_SERVICE_GROUP_WORKER_MAX</b>.
+ * @param queueDepth Indicates the depth of the event queue of each worker,
+ * at most <b>HDF_IO_SERVICE_GROUP_QUEUE_DEPTH_MAX</b>.
+ * @return Returns <b>0</b> if the operation is successful; returns a negative value otherwise.
+ *
+ * @since 1.0
+ */
+int32_t HdfIoServiceGroupSetDispatchPool(struct HdfIoServiceGroup *group, uint32_t workerCount, uint32_t queueDepth);
+
+/**
+ * @brief Obtains the statistics of the event dispatch workers of a specified driver service group.
+ *
+ * @param group Indicates the pointer to the driver service group object.
+ * @param stat Indicates the pointer to the statistics to fill.
+ * @return Returns <b>0</b> if the operation is successful; returns a negative value otherwise.
+ *
+ * @since 1.0
+ */
+int32_t HdfIoServiceGroupGetDispatchStat(const struct HdfIoServiceGroup *group,
+    struct HdfIoServiceGroupDispatchStat *stat);
+
 /**
  * @brief Obtains a driver service object.
  *
@@ -233,6 +314,39 @@ struct HdfIoService *HdfIoServiceBind(const char *serviceName);
  */
 void HdfIoServiceRecycle(struct HdfIoService *service);
 
+/**
+ * @brief Dispatches a batch of driver service calls to a driver service object.
+ *
+ * The calls are dispatched in order. In user space, up to <b>HDF_WRITE_READ_BATCH_MAX</b> calls are submitted
+ * to the kernel with one system call, so that a burst of small calls does not pay the system call overhead
+ * for each call. The result of each call is stored in its <b>status</b> field.
+ *
+ * @param service Indicates the pointer to the driver service object obtained by {@link HdfIoServiceBind}.
+ * @param calls Indicates the pointer to the array of calls to dispatch.
+ * @param count Indicates the count of calls in the array.
+ * @return Returns <b>0</b> if all calls are submitted; returns a negative value otherwise.
+ * A successful submission does not mean that each call succeeds.
+ *
+ * @since 1.0
+ */
+int32_t HdfIoServiceDispatchBatch(struct HdfIoService *service, struct HdfIoServiceCall *calls, uint32_t count);
+
+/**
+ * @brief Switches event delivery of a driver service object to a ring buffer.
+ *
+ * The driver writes events into a per-client ring instead of queueing a copy of each event, and the listener
+ * reads all pending events with one system call after a poll wakeup. When the ring is full, new events are
+ * dropped and counted instead of evicting older ones. Call this function before registering listeners.
+ *
+ * @param service Indicates the pointer to the driver service object obtained by {@link HdfIoServiceBind}.
+ * @param size Indicates the size of the ring in bytes. It is rounded up to a power of two and clamped to
+ * the range supported by the framework.
+ * @return Returns <b>0</b> if the operation is successful; returns a negative value otherwise.
+ *
+ * @since 1.0
+ */
+int32_t HdfIoServiceSetEventRing(struct HdfIoService *service, uint32_t size);
+
 /**
  * @brief Registers a custom {@link HdfDevEventlistener} for listening for events reported
  * by a specified driver service object.
@@ -213,6 +213,148 @@ struct NetDevice;
  */
 NetBuf *NetBufDevAlloc(const struct NetDevice *dev, uint32_t size);
 
+/**
+ * @brief Releases a network data buffer applied by {@link NetBufDevAlloc}.
+ *
+ * If the buffer was applied from a buffer pool, it is returned to that pool. Otherwise, the buffer is
+ * released by {@link NetBufFree}. Only buffers exclusively owned by the driver can be released by this function,
+ * for example, a received frame that is dropped. Buffers passed to {@link NetIfRx} belong to the network stack.
+ *
+ * @param nb Indicates the pointer to the network data buffer.
+ *
+ * @since 1.0
+ * @version 1.0
+ */
+void NetBufDevFree(NetBuf *nb);
+
+/**
+ * @brief Defines a pool of network data buffers reserved for a network device.
+ */
+struct NetBufPool;
+
+/**
+ * @brief Defines the statistics of a network data buffer pool.
+ */
+struct NetBufPoolStat {
+    uint32_t bufSize;   /**< Data size of the buffers, excluding the reserved space of the network device */
+    uint32_t free;      /**< Number of buffers kept in the pool */
+    uint32_t lowWater;  /**< {@link NetBufPoolRefill} refills the pool if fewer buffers are kept */
+    uint32_t highWater; /**< Maximum number of buffers kept in the pool */
+    uint32_t hit;       /**< Applications served from the pool */
+    uint32_t miss;      /**< Applications that fell back to {@link NetBufAlloc} because the pool was empty */
+    uint32_t overflow;  /**< Returned buffers released because the pool was full or the buffer unfit */
+};
+
+/**
+ * @brief Creates a buffer pool for a network device and attaches it to the device.
+ *
+ * The pool is filled with <b>count</b> buffers whose header and tail space reserved by the network device,
+ * <b>neededHeadRoom</b> and <b>neededTailRoom</b>, is already set. Afterwards {@link NetBufDevAlloc} serves
+ * applications of up to <b>bufSize</b> bytes from the pool, and {@link NetBufDevFree} returns buffers to it.
+ * The low watermark defaults to a quarter of <b>count</b> and the high watermark to <b>count</b>.
+ *
+ * @param dev Indicates the pointer to the network device, which must not have a buffer pool yet.
+ * @param bufSize Indicates the data size of the buffers, excluding the reserved space.
+ * @param count Indicates the number of buffers to allocate in advance.
+ *
+ * @return Returns the pointer to the buffer pool if the operation is successful; returns <b>NULL</b> otherwise.
+ *
+ * @since 1.0
+ * @version 1.0
+ */
+struct NetBufPool *NetBufPoolCreate(struct NetDevice *dev, uint32_t bufSize, uint32_t count);
+
+/**
+ * @brief Detaches a buffer pool from its network device and releases the pool and the buffers kept in it.
+ *
+ * The receive path of the network device must be stopped. {@link NetDeviceDeInit} destroys the pool of the
+ * network device as well. Buffers of the pool still held by the driver stay valid, {@link NetBufDevFree} releases
+ * them afterwards without accessing the network device, which may be gone by then. The pool itself is released
+ * once the last of them is.
+ *
+ * @param pool Indicates the pointer to the buffer pool.
+ *
+ * @since 1.0
+ * @version 1.0
+ */
+void NetBufPoolDestroy(struct NetBufPool *pool);
+
+/**
+ * @brief Applies for a network data buffer from a buffer pool.
+ *
+ * The buffer has the reserved space of the network device set, as one applied by {@link NetBufDevAlloc}, and
+ * its <b>dev</b> refers to the pool until it is passed to {@link NetIfRx}. It goes back to the pool through
+ * {@link NetBufDevFree} or {@link NetBufPoolRecycle}, not through {@link NetBufFree}, which would keep a destroyed
+ * pool from being released. If the pool is empty, a new buffer is applied by {@link NetBufAlloc}.
+ * This function does not sleep or lock, and can be called in interrupt context if {@link NetBufAlloc} can.
+ *
+ * @param pool Indicates the pointer to the buffer pool.
+ *
+ * @return Returns the pointer to the network data buffer if the operation is successful;
+ * returns <b>NULL</b> otherwise.
+ *
+ * @since 1.0
+ * @version 1.0
+ */
+NetBuf *NetBufPoolAlloc(struct NetBufPool *pool);
+
+/**
+ * @brief Returns a network data buffer to a buffer pool.
+ *
+ * The data segment of the buffer is emptied and its reserved space is restored. The buffer is released instead
+ * if the pool holds the high watermark of buffers, or if the buffer space no longer fits the pool.
+ *
+ * @param pool Indicates the pointer to the buffer pool.
+ * @param nb Indicates the pointer to the network data buffer.
+ *
+ * @since 1.0
+ * @version 1.0
+ */
+void NetBufPoolRecycle(struct NetBufPool *pool, NetBuf *nb);
+
+/**
+ * @brief Sets the watermarks of a buffer pool.
+ *
+ * @param pool Indicates the pointer to the buffer pool.
+ * @param lowWater Indicates the number of buffers below which {@link NetBufPoolRefill} refills the pool.
+ * @param highWater Indicates the maximum number of buffers kept in the pool, which cannot exceed the
+ * <b>count</b> the pool is created with.
+ *
+ * @return Returns <b>0</b> if the operation is successful; returns a negative value otherwise.
+ *
+ * @since 1.0
+ * @version 1.0
+ */
+int32_t NetBufPoolSetWatermark(struct NetBufPool *pool, uint32_t lowWater, uint32_t highWater);
+
+/**
+ * @brief Refills a buffer pool up to the high watermark if it holds fewer buffers than the low watermark.
+ *
+ * Drivers call this function out of the receive hot path, for example, once per batch of received frames, so that
+ * buffer applications during a burst are served from the pool.
+ *
+ * @param pool Indicates the pointer to the buffer pool.
+ *
+ * @return Returns the number of buffers added to the pool.
+ *
+ * @since 1.0
+ * @version 1.0
+ */
+uint32_t NetBufPoolRefill(struct NetBufPool *pool);
+
+/**
+ * @brief Obtains the statistics of a buffer pool.
+ *
+ * @param pool Indicates the pointer to the buffer pool.
+ * @param stat Indicates the pointer to the statistics.
+ *
+ * @return Returns <b>0</b> if the operation is successful; returns a negative value otherwise.
+ *
+ * @since 1.0
+ * @version 1.0
+ */
+int32_t NetBufPoolGetStat(const struct NetBufPool *pool, struct NetBufPoolStat *stat);
+
 /**
  * @brief Performs operations based on the segment ID of a network data buffer.
  * The function is opposite to that of {@link NetBufPop}.
@@ -443,6 +443,47 @@ struct NetDevStats {
     uint32_t txDropped; /**< Packets dropped before transmission */
 };
 
+struct NetRxGro;
+
+/**
+ * @brief Defines the configuration of the receive aggregation stage of a network device.
+ *
+ * In-order TCP segments of one flow are merged into a single frame before they are passed to the protocol stack.
+ *
+ * @since 1.0
+ * @version 1.0
+ */
+struct NetRxGroConfig {
+    uint16_t maxFlows;     /**< Number of flows held at a time, up to {@link NET_RX_GRO_MAX_FLOWS} */
+    uint16_t maxSegments;  /**< Number of segments merged into one frame, at least <b>2</b> */
+    uint32_t maxSize;      /**< Size of a merged frame including the Ether header, in bytes */
+    uint32_t flushTimeout; /**< Time a held frame waits for more segments, in milliseconds. The value <b>0</b>
+                            * means held frames are flushed only by {@link NetIfRxGroFlush}.
+                            */
+};
+
+/**
+ * @brief Indicates the maximum number of flows the receive aggregation stage holds at a time.
+ *
+ * @since 1.0
+ * @version 1.0
+ */
+#define NET_RX_GRO_MAX_FLOWS 32
+
+/**
+ * @brief Defines the statistics of the receive aggregation stage of a network device.
+ *
+ * @since 1.0
+ * @version 1.0
+ */
+struct NetRxGroStat {
+    uint32_t received;   /**< Frames passed to the aggregation stage */
+    uint32_t merged;     /**< Segments merged into a held frame */
+    uint32_t delivered;  /**< Frames passed to the protocol stack */
+    uint32_t batchFlush; /**< Flushes by {@link NetIfRxGroFlush} */
+    uint32_t timerFlush; /**< Flushes when the flush timeout expires */
+};
+
 /**
  * @brief Defines ioctrl data.
  *
@@ -482,6 +523,8 @@ typedef struct NetDevice {
     struct NetDeviceInterFace *netDeviceIf;   /**< Network device interface */
     struct NetDevice *owner;                  /**< Network device */
     struct NetDevStats stats;                 /**< Network statistics */
+    struct NetBufPool *rxPool;                /**< Pool of buffers for {@link NetBufDevAlloc}, see NetBufPoolCreate */
+    struct NetRxGro *rxGro;                   /**< Receive aggregation stage, see {@link NetIfRxGroEnable} */
 } NetDevice;
 
 /**
@@ -741,6 +784,65 @@ int32_t NetIfRx(const struct NetDevice *netDevice, NetBuf *buff);
  */
 int32_t NetIfRxNi(const struct NetDevice *netDevice, NetBuf *buff);
 
+/**
+ * @brief Enables the receive aggregation stage of a network device.
+ *
+ * Once enabled, {@link NetIfRx} and {@link NetIfRxNi} hold in-order TCP segments of a flow and merge the following
+ * segments into the held frame. Other frames pass through unchanged. A driver calls {@link NetIfRxGroFlush} at the
+ * end of each receive batch.
+ *
+ * @param netDevice Indicates the pointer to the network device obtained during initialization.
+ * @param config Indicates the pointer to the configuration. The value <b>NULL</b> selects the default
+ * configuration.
+ *
+ * @return Returns <b>0</b> if the operation is successful; returns a non-zero value {@link HDF_STATUS} if the
+ * operation fails.
+ *
+ * @since 1.0
+ * @version 1.0
+ */
+int32_t NetIfRxGroEnable(struct NetDevice *netDevice, const struct NetRxGroConfig *config);
+
+/**
+ * @brief Disables the receive aggregation stage of a network device, the held frames are passed to the
+ * protocol stack.
+ *
+ * The driver must not receive frames on the network device while this function is running.
+ *
+ * @param netDevice Indicates the pointer to the network device obtained during initialization.
+ *
+ * @since 1.0
+ * @version 1.0
+ */
+void NetIfRxGroDisable(struct NetDevice *netDevice);
+
+/**
+ * @brief Passes all frames held by the receive aggregation stage to the protocol stack.
+ *
+ * @param netDevice Indicates the pointer to the network device obtained during initialization.
+ *
+ * @return Returns <b>0</b> if the operation is successful; returns a non-zero value {@link HDF_STATUS} if the
+ * operation fails.
+ *
+ * @since 1.0
+ * @version 1.0
+ */
+int32_t NetIfRxGroFlush(const struct NetDevice *netDevice);
+
+/**
+ * @brief Obtains the statistics of the receive aggregation stage of a network device.
+ *
+ * @param netDevice Indicates the pointer to the network device obtained during initialization.
+ * @param stat Indicates the pointer to the statistics obtained.
+ *
+ * @return Returns <b>0</b> if the operation is successful; returns a non-zero value {@link HDF_STATUS} if the
+ * operation fails.
+ *
+ * @since 1.0
+ * @version 1.0
+ */
+int32_t NetIfRxGroGetStat(const struct NetDevice *netDevice, struct NetRxGroStat *stat);
+
 /**
  * @brief Starts the DHCP server.
  *
@@ -46,6 +46,11 @@ extern "C" {
  */
 typedef enum {
     HDF_CONFIG_SOURCE = 0,               /**< HDF configuration file */
+    HDF_CONFIG_SOURCE_BLOB,              /**< HDF configuration file read in place from the blob, available only
+                                          * with <b>LOSCFG_DRIVERS_HDF_CONFIG_BLOB</b>. Nodes have no
+                                          * <b>attrData</b>, so {@link DEV_RES_NODE_FOR_EACH_ATTR} is not supported
+                                          * and drivers that traverse attributes must use <b>HDF_CONFIG_SOURCE</b>.
+                                          */
     INVALID,                             /**< Invalid configuration file type */
 } DeviceResourceType;
 
@@ -61,6 +66,8 @@ struct DeviceResourceAttr {
     struct DeviceResourceAttr *next;      /**< Pointer to the next attribute of the node in the configuration tree. */
 };
 
+struct HcsNodeIndex;
+
 /**
  * @brief Defines a tree node in the configuration tree.
  *
@@ -74,6 +81,7 @@ struct DeviceResourceNode {
     struct DeviceResourceNode *parent;     /**< Pointer to the parent node */
     struct DeviceResourceNode *child;      /**< Pointer to a child node */
     struct DeviceResourceNode *sibling;    /**< Pointer to a sibling node */
+    const struct HcsNodeIndex *index;      /**< Lookup index built by the parser, NULL if the node is not indexed */
 };
 
 /**
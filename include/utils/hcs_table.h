@@ -0,0 +1,330 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ *
+ * HDF is dual licensed: you can use it either under the terms of
+ * the GPL, or the BSD license, at your option.
+ * See the LICENSE file in the root of this repository for complete details.
+ */
+
+/**
+ * @addtogroup DriverConfig
+ * @{
+ *
+ * @brief Defines APIs for HDF driver developers to read driver configuration information.
+ *
+ * During version compilation of the device resource source file defined by developers, the compilation tool
+ * (for example, the compilation tool of the HCS file is hc-gen) generates bytecodes. When the HDF starts,
+ * it transfers the bytecode memory to the <b>DriverConfig</b> module. The <b>DriverConfig</b> module converts
+ * the bytecodes into a configuration tree and provides APIs for developers to query the tree.
+ *
+ * @since 1.0
+ */
+
+/**
+ * @file hcs_table.h
+ *
+ * @brief Defines the table-based APIs used for querying the configuration tree.
+ *
+ * During version compilation, the hc-gen tool can be used with the <b>-c</b> option to convert the configuration
+ * tree into constant C tables. The tables are placed in read-only data and queried in place, so reading the
+ * configuration needs neither parsing nor memory allocation.
+ * 1. All nodes are saved in one node table. The child nodes of a node are adjacent in the table and kept in the
+ * order of the configuration source, and each node carries the number of its child nodes and attributes.
+ * 2. The attributes of a node are adjacent in the attribute table and sorted by name.
+ * 3. The child node indexes of a node are sorted by child node name.
+ * 4. The nodes that have the <b>match_attr</b> attribute are saved in a match table sorted by the attribute value.
+ * Nodes, attributes and <b>match_attr</b> values are therefore looked up by binary search.
+ *
+ * Example of reading the configuration:
+ * const struct HcsTableNode *node = HcsTableGetNodeByMatchAttr("sample_driver");
+ * HcsTableGetUint32(node, "bus_num", &busNum, 0);
+ *
+ * @since 1.0
+ */
+
+#ifndef HCS_TABLE_H
+#define HCS_TABLE_H
+
+#include "hdf_base.h"
+
+#ifdef __cplusplus
+#if __cplusplus
+extern "C" {
+#endif
+#endif /* __cplusplus */
+
+/**
+ * @brief Enumerates the value types of attributes in the configuration tables.
+ */
+enum HcsTableType {
+    HCS_TABLE_UINT8 = 1, /**< Unsigned 8-bit integer */
+    HCS_TABLE_UINT16,    /**< Unsigned 16-bit integer */
+    HCS_TABLE_UINT32,    /**< Unsigned 32-bit integer */
+    HCS_TABLE_UINT64,    /**< Unsigned 64-bit integer */
+    HCS_TABLE_STRING,    /**< String */
+    HCS_TABLE_REF,       /**< Reference to a node */
+};
+
+struct HcsTableNode;
+
+/**
+ * @brief Defines an attribute of a node in the configuration tables.
+ */
+struct HcsTableAttr {
+    const char *name;   /**< Attribute name */
+    /**
+     * String for a string, node for a reference, or elements for an array. The elements of an array are saved as
+     * uint8_t, uint16_t, uint32_t, uint64_t or const char * according to <b>type</b>.
+     */
+    const void *data;
+    uint64_t value;     /**< Value of an integer that is not an array element */
+    uint16_t count;     /**< Number of array elements, <b>1</b> for a value that is not an array */
+    uint8_t type;       /**< Type of the value or array elements, see {@link HcsTableType} */
+    uint8_t isArray;    /**< Whether the attribute is an array */
+};
+
+/**
+ * @brief Defines a node in the configuration tables.
+ */
+struct HcsTableNode {
+    const char *name;                      /**< Node name */
+    const struct HcsTableNode *parent;     /**< Parent node, <b>NULL</b> for the root node */
+    const struct HcsTableAttr *attrs;      /**< Attributes sorted by name */
+    const struct HcsTableNode *children;   /**< Child nodes in the order of the configuration source */
+    const uint16_t *childIndex;            /**< Indexes in <b>children</b> sorted by child node name */
+    uint16_t attrCount;                    /**< Number of attributes */
+    uint16_t childCount;                   /**< Number of child nodes */
+};
+
+/**
+ * @brief Defines a node that has the <b>match_attr</b> attribute.
+ */
+struct HcsTableMatch {
+    const char *matchAttr;                 /**< Value of the <b>match_attr</b> attribute */
+    const struct HcsTableNode *node;       /**< Node that has the attribute */
+};
+
+/**
+ * @brief Defines the configuration tables generated by hc-gen.
+ */
+struct HcsTable {
+    const struct HcsTableNode *root;       /**< Root node */
+    const struct HcsTableMatch *matches;   /**< Nodes that have <b>match_attr</b>, sorted by the attribute value */
+    uint32_t matchCount;                   /**< Number of nodes in <b>matches</b> */
+    uint32_t nodeCount;                    /**< Number of nodes in the tables */
+};
+
+/**
+ * @brief Traverses the child nodes of a node in the order of the configuration source.
+ *
+ * @param node Indicates the node whose child nodes are traversed.
+ * @param child Indicates the <b>const struct HcsTableNode *</b> pointing to each child node.
+ * @since 1.0
+ */
+#define HCS_TABLE_FOREACH_CHILD(node, child) \
+    for ((child) = (node)->children; (child) < (node)->children + (node)->childCount; (child)++)
+
+/**
+ * @brief Traverses the attributes of a node in the order of attribute names.
+ *
+ * @param node Indicates the node whose attributes are traversed.
+ * @param attr Indicates the <b>const struct HcsTableAttr *</b> pointing to each attribute.
+ * @since 1.0
+ */
+#define HCS_TABLE_FOREACH_ATTR(node, attr) \
+    for ((attr) = (node)->attrs; (attr) < (node)->attrs + (node)->attrCount; (attr)++)
+
+/**
+ * @brief Obtains the configuration tables compiled into the image.
+ *
+ * The tables are provided by the C file that hc-gen generates with the <b>-c</b> option.
+ *
+ * @return Returns the tables if they are compiled into the image; returns <b>NULL</b> otherwise.
+ * @since 1.0
+ */
+const struct HcsTable *HcsTableGetInstance(void);
+
+/**
+ * @brief Obtains the root node of the configuration tables.
+ *
+ * @return Returns the root node if the tables are compiled into the image; returns <b>NULL</b> otherwise.
+ * @since 1.0
+ */
+const struct HcsTableNode *HcsTableGetRootNode(void);
+
+/**
+ * @brief Obtains a child node of a node by name.
+ *
+ * @param node Indicates the node whose child node is to obtain.
+ * @param nodeName Indicates the name of the child node.
+ * @return Returns the child node if it exists; returns <b>NULL</b> otherwise.
+ * @since 1.0
+ */
+const struct HcsTableNode *HcsTableGetChildNode(const struct HcsTableNode *node, const char *nodeName);
+
+/**
+ * @brief Obtains an attribute of a node by name.
+ *
+ * @param node Indicates the node whose attribute is to obtain.
+ * @param attrName Indicates the name of the attribute.
+ * @return Returns the attribute if it exists; returns <b>NULL</b> otherwise.
+ * @since 1.0
+ */
+const struct HcsTableAttr *HcsTableGetAttr(const struct HcsTableNode *node, const char *attrName);
+
+/**
+ * @brief Obtains the node whose <b>match_attr</b> attribute equals the given value.
+ *
+ * If several nodes have the value, the first one in depth-first order is returned.
+ *
+ * @param attrValue Indicates the value of the <b>match_attr</b> attribute.
+ * @return Returns the node if it exists; returns <b>NULL</b> otherwise.
+ * @since 1.0
+ */
+const struct HcsTableNode *HcsTableGetNodeByMatchAttr(const char *attrValue);
+
+/**
+ * @brief Obtains the node that a reference attribute of a node points to.
+ *
+ * @param node Indicates the node that has the reference attribute.
+ * @param attrName Indicates the name of the reference attribute.
+ * @return Returns the referenced node if the attribute exists and is a reference; returns <b>NULL</b> otherwise.
+ * @since 1.0
+ */
+const struct HcsTableNode *HcsTableGetNodeByRefAttr(const struct HcsTableNode *node, const char *attrName);
+
+/**
+ * @brief Obtains the value of a Boolean attribute, which is an 8-bit integer in the configuration source.
+ *
+ * @param node Indicates the node that has the attribute.
+ * @param attrName Indicates the name of the attribute.
+ * @return Returns <b>true</b> if the attribute exists and is not zero; returns <b>false</b> otherwise.
+ * @since 1.0
+ */
+bool HcsTableGetBool(const struct HcsTableNode *node, const char *attrName);
+
+/**
+ * @brief Obtains the value of an integer attribute that fits in 8 bits.
+ *
+ * @param node Indicates the node that has the attribute.
+ * @param attrName Indicates the name of the attribute.
+ * @param value Indicates the pointer to the value. It is set to <b>def</b> if the operation fails.
+ * @param def Indicates the default value.
+ * @return Returns <b>HDF_SUCCESS</b> if the operation is successful; returns a negative value otherwise.
+ * @since 1.0
+ */
+int32_t HcsTableGetUint8(const struct HcsTableNode *node, const char *attrName, uint8_t *value, uint8_t def);
+
+/**
+ * @brief Obtains the value of an integer attribute that fits in 16 bits.
+ *
+ * @see HcsTableGetUint8
+ * @since 1.0
+ */
+int32_t HcsTableGetUint16(const struct HcsTableNode *node, const char *attrName, uint16_t *value, uint16_t def);
+
+/**
+ * @brief Obtains the value of an integer attribute that fits in 32 bits.
+ *
+ * @see HcsTableGetUint8
+ * @since 1.0
+ */
+int32_t HcsTableGetUint32(const struct HcsTableNode *node, const char *attrName, uint32_t *value, uint32_t def);
+
+/**
+ * @brief Obtains the value of an integer attribute.
+ *
+ * @see HcsTableGetUint8
+ * @since 1.0
+ */
+int32_t HcsTableGetUint64(const struct HcsTableNode *node, const char *attrName, uint64_t *value, uint64_t def);
+
+/**
+ * @brief Obtains an element of an integer array attribute whose elements fit in 8 bits.
+ *
+ * @param node Indicates the node that has the attribute.
+ * @param attrName Indicates the name of the attribute.
+ * @param index Indicates the index of the element, starting from <b>0</b>.
+ * @param value Indicates the pointer to the element. It is set to <b>def</b> if the operation fails.
+ * @param def Indicates the default value.
+ * @return Returns <b>HDF_SUCCESS</b> if the operation is successful; returns a negative value otherwise.
+ * @since 1.0
+ */
+int32_t HcsTableGetUint8ArrayElem(const struct HcsTableNode *node, const char *attrName, uint32_t index,
+    uint8_t *value, uint8_t def);
+
+/**
+ * @brief Obtains an element of an integer array attribute whose elements fit in 16 bits.
+ *
+ * @see HcsTableGetUint8ArrayElem
+ * @since 1.0
+ */
+int32_t HcsTableGetUint16ArrayElem(const struct HcsTableNode *node, const char *attrName, uint32_t index,
+    uint16_t *value, uint16_t def);
+
+/**
+ * @brief Obtains an element of an integer array attribute whose elements fit in 32 bits.
+ *
+ * @see HcsTableGetUint8ArrayElem
+ * @since 1.0
+ */
+int32_t HcsTableGetUint32ArrayElem(const struct HcsTableNode *node, const char *attrName, uint32_t index,
+    uint32_t *value, uint32_t def);
+
+/**
+ * @brief Obtains an element of an integer array attribute.
+ *
+ * @see HcsTableGetUint8ArrayElem
+ * @since 1.0
+ */
+int32_t HcsTableGetUint64ArrayElem(const struct HcsTableNode *node, const char *attrName, uint32_t index,
+    uint64_t *value, uint64_t def);
+
+/**
+ * @brief Obtains the value of a string attribute.
+ *
+ * @param node Indicates the node that has the attribute.
+ * @param attrName Indicates the name of the attribute.
+ * @param value Indicates the pointer to the string, which is saved in the tables and must not be released.
+ * It is set to <b>def</b> if the operation fails.
+ * @param def Indicates the default string.
+ * @return Returns <b>HDF_SUCCESS</b> if the operation is successful; returns a negative value otherwise.
+ * @since 1.0
+ */
+int32_t HcsTableGetString(const struct HcsTableNode *node, const char *attrName, const char **value,
+    const char *def);
+
+/**
+ * @brief Obtains an element of a string array attribute.
+ *
+ * @param node Indicates the node that has the attribute.
+ * @param attrName Indicates the name of the attribute.
+ * @param index Indicates the index of the element, starting from <b>0</b>.
+ * @param value Indicates the pointer to the string, which is saved in the tables and must not be released.
+ * It is set to <b>def</b> if the operation fails.
+ * @param def Indicates the default string.
+ * @return Returns <b>HDF_SUCCESS</b> if the operation is successful; returns a negative value otherwise.
+ * @since 1.0
+ */
+int32_t HcsTableGetStringArrayElem(const struct HcsTableNode *node, const char *attrName, uint32_t index,
+    const char **value, const char *def);
+
+/**
+ * @brief Obtains the number of elements of an array attribute.
+ *
+ * @param node Indicates the node that has the attribute.
+ * @param attrName Indicates the name of the attribute.
+ * @return Returns the number of elements if the attribute exists and is an array; returns a negative value
+ * otherwise.
+ * @since 1.0
+ */
+int32_t HcsTableGetElemNum(const struct HcsTableNode *node, const char *attrName);
+
+#ifdef __cplusplus
+#if __cplusplus
+}
+#endif
+#endif /* __cplusplus */
+
+#endif /* HCS_TABLE_H */
+/** @} */
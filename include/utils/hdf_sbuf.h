@@ -51,9 +51,19 @@ enum HdfSbufType {
     SBUF_RAW = 0,   /* SBUF used for communication between the user space and the kernel space */
     SBUF_IPC,      /* SBUF used for inter-process communication (IPC) */
     SBUF_IPC_HW,    /* Reserved for extension */
+    SBUF_SG,        /* SBUF storing data in a chain of segments, large payloads can be appended by reference */
     SBUF_TYPE_MAX,  /* Maximum value of the SBUF type */
 };
 
+/**
+ * @brief Defines the callback invoked when a <b>SBuf</b> no longer references an appended buffer.
+ *
+ * @param priv Indicates the private data passed to {@link HdfSbufWriteBufferRef}.
+ *
+ * @since 1.0
+ */
+typedef void (*HdfSbufRefRelease)(void *priv);
+
 /**
  * @brief Writes a data segment to a <b>SBuf</b>.
  *
@@ -78,6 +88,27 @@ bool HdfSbufWriteBuffer(struct HdfSBuf *sbuf, const void *data, uint32_t writeSi
  */
 bool HdfSbufWriteUnpadBuffer(struct HdfSBuf *sbuf, const uint8_t *data, uint32_t writeSize);
 
+/**
+ * @brief Writes a data segment to a <b>SBuf</b> by reference. The data is encoded the same way as
+ * {@link HdfSbufWriteBuffer} and can be read by {@link HdfSbufReadBuffer}.
+ *
+ * On a <b>SBuf</b> of the {@link SBUF_SG} type the data is not copied: it must stay valid until
+ * <b>release</b> is called, which happens once the <b>SBuf</b> drops the reference. Other <b>SBuf</b>
+ * types copy the data and call <b>release</b> before returning. If the operation fails, <b>release</b>
+ * is not called and the caller keeps the ownership of the data.
+ *
+ * @param sbuf Indicates the pointer to the target <b>SBuf</b>.
+ * @param data Indicates the pointer to the data segment to write.
+ * @param writeSize Indicates the size of the data segment to write.
+ * @param release Indicates the callback releasing the data. The value can be a null pointer.
+ * @param priv Indicates the private data passed to <b>release</b>.
+ * @return Returns <b>true</b> if the operation is successful; returns <b>false</b> otherwise.
+ *
+ * @since 1.0
+ */
+bool HdfSbufWriteBufferRef(struct HdfSBuf *sbuf, const void *data, uint32_t writeSize,
+    HdfSbufRefRelease release, void *priv);
+
 /**
  * @brief Writes a 64-bit unsigned integer to a <b>SBuf</b>.
  *
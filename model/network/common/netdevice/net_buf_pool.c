@@ -0,0 +1,296 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ *
+ * HDF is dual licensed: you can use it either under the terms of
+ * the GPL, or the BSD license, at your option.
+ * See the LICENSE file in the root of this repository for complete details.
+ */
+
+#include "hdf_log.h"
+#include "hdf_mpmc_queue.h"
+#include "hdf_netbuf.h"
+#include "net_device.h"
+#include "net_device_impl.h"
+#include "osal_atomic.h"
+#include "osal_mem.h"
+
+#define HDF_LOG_TAG "NetBufPool"
+
+#define NETBUF_POOL_LOW_WATER_SHIFT 2 // the low watermark defaults to a quarter of the pool
+#define NETBUF_POOL_DEV_TAG ((uintptr_t)1)
+
+/*
+ * Free buffers are kept in a lock-free ring sized for the count the pool is created with, so the
+ * receive path allocates and recycles without locks. @free counts the buffers in the ring, it may
+ * briefly run ahead of the ring while a buffer is being pushed.
+ *
+ * The device is freed by NetDeviceDeInit while drivers may still hold buffers of its pool, so a
+ * buffer handed out refers to the pool rather than to the device: its dev is the pool address with
+ * NETBUF_POOL_DEV_TAG set, telling it from a device without reading either. @refs counts the device
+ * and every buffer handed out, which returns to the pool or hands its reference over to the network
+ * stack in NetIfRx, and the last one frees the pool.
+ */
+struct NetBufPool {
+    struct HdfMpmcQueue freeList;
+    struct NetDevice *dev;
+    OsalAtomic refs;
+    OsalAtomic detached;
+    uint32_t bufSize;
+    uint32_t headRoom;
+    uint32_t tailRoom;
+    uint32_t capacity;
+    OsalAtomic lowWater;
+    OsalAtomic highWater;
+    OsalAtomic free;
+    OsalAtomic hit;
+    OsalAtomic miss;
+    OsalAtomic overflow;
+};
+
+static void *NetBufPoolTag(const struct NetBufPool *pool)
+{
+    return (void *)((uintptr_t)pool | NETBUF_POOL_DEV_TAG);
+}
+
+struct NetBufPool *NetBufGetPool(const NetBuf *nb)
+{
+    uintptr_t dev = (uintptr_t)nb->dev;
+    return ((dev & NETBUF_POOL_DEV_TAG) != 0) ? (struct NetBufPool *)(dev & ~NETBUF_POOL_DEV_TAG) : NULL;
+}
+
+static NetBuf *NetBufPoolNewBuf(const struct NetBufPool *pool)
+{
+    NetBuf *nb = NetBufAlloc(pool->headRoom + pool->bufSize + pool->tailRoom);
+    if (nb == NULL) {
+        return NULL;
+    }
+    nb->dev = NetBufPoolTag(pool);
+    NetBufPop(nb, E_TAIL_BUF, pool->headRoom);
+    NetBufPop(nb, E_DATA_BUF, pool->headRoom);
+    return nb;
+}
+
+/* Empties the data segment and restores the reserved head room, as a new buffer of the pool has. */
+static bool NetBufPoolResetBuf(const struct NetBufPool *pool, NetBuf *nb)
+{
+    uint32_t headRoom = NetBufGetRoom(nb, E_HEAD_BUF);
+    uint32_t used = headRoom + NetBufGetDataLen(nb);
+
+    if ((headRoom != 0) && (NetBufPop(nb, E_HEAD_BUF, headRoom) == NULL)) {
+        return false;
+    }
+    if ((used != 0) && (NetBufPush(nb, E_TAIL_BUF, used) == NULL)) {
+        return false;
+    }
+    if (NetBufGetRoom(nb, E_TAIL_BUF) < pool->headRoom + pool->bufSize + pool->tailRoom) {
+        return false;
+    }
+    nb->dev = NetBufPoolTag(pool);
+    NetBufPop(nb, E_TAIL_BUF, pool->headRoom);
+    NetBufPop(nb, E_DATA_BUF, pool->headRoom);
+    return true;
+}
+
+/* Takes a slot below the high watermark and pushes the buffer, returns false if the pool is full. */
+static bool NetBufPoolPut(struct NetBufPool *pool, NetBuf *nb)
+{
+    if (OsalAtomicIncReturn(&pool->free) > OsalAtomicRead(&pool->highWater)) {
+        OsalAtomicDec(&pool->free);
+        return false;
+    }
+    if (!HdfMpmcQueueTryPush(&pool->freeList, nb)) {
+        OsalAtomicDec(&pool->free);
+        return false;
+    }
+    return true;
+}
+
+/* Fills the pool up to the high watermark, returns the count of buffers added. */
+static uint32_t NetBufPoolFill(struct NetBufPool *pool)
+{
+    uint32_t added = 0;
+    NetBuf *nb = NULL;
+
+    while (OsalAtomicRead(&pool->free) < OsalAtomicRead(&pool->highWater)) {
+        nb = NetBufPoolNewBuf(pool);
+        if (nb == NULL) {
+            break;
+        }
+        if (!NetBufPoolPut(pool, nb)) {
+            NetBufFree(nb);
+            break;
+        }
+        added++;
+    }
+    return added;
+}
+
+static void NetBufPoolRelease(struct NetBufPool *pool)
+{
+    NetBuf *nb = NULL;
+
+    if (OsalAtomicDecReturn(&pool->refs) != 0) {
+        return;
+    }
+    while ((nb = (NetBuf *)HdfMpmcQueueTryPop(&pool->freeList)) != NULL) {
+        NetBufFree(nb);
+    }
+    HdfMpmcQueueDestroy(&pool->freeList);
+    OsalMemFree(pool);
+}
+
+struct NetBufPool *NetBufPoolCreate(struct NetDevice *dev, uint32_t bufSize, uint32_t count)
+{
+    struct NetBufPool *pool = NULL;
+
+    if (dev == NULL || bufSize == 0 || count == 0 || count > INT32_MAX) {
+        HDF_LOGE("%s: invalid param", __func__);
+        return NULL;
+    }
+    if (dev->rxPool != NULL) {
+        HDF_LOGE("%s: %s already has a buffer pool", __func__, dev->name);
+        return NULL;
+    }
+    pool = (struct NetBufPool *)OsalMemCalloc(sizeof(*pool));
+    if (pool == NULL) {
+        HDF_LOGE("%s: OsalMemCalloc fail", __func__);
+        return NULL;
+    }
+    if (HdfMpmcQueueInit(&pool->freeList, count) != HDF_SUCCESS) {
+        HDF_LOGE("%s: failed to init free list of %u buffers", __func__, count);
+        OsalMemFree(pool);
+        return NULL;
+    }
+    pool->dev = dev;
+    pool->bufSize = bufSize;
+    pool->headRoom = dev->neededHeadRoom;
+    pool->tailRoom = dev->neededTailRoom;
+    pool->capacity = count;
+    OsalAtomicSet(&pool->refs, 1); // held by the device until NetBufPoolDestroy
+    OsalAtomicSet(&pool->lowWater, (int32_t)(count >> NETBUF_POOL_LOW_WATER_SHIFT));
+    OsalAtomicSet(&pool->highWater, (int32_t)count);
+    if (NetBufPoolFill(pool) != count) {
+        HDF_LOGW("%s: %s pool filled with %d of %u buffers", __func__, dev->name, OsalAtomicRead(&pool->free), count);
+    }
+    dev->rxPool = pool;
+    return pool;
+}
+
+void NetBufPoolDestroy(struct NetBufPool *pool)
+{
+    if (pool == NULL) {
+        return;
+    }
+    if (pool->dev != NULL && pool->dev->rxPool == pool) {
+        pool->dev->rxPool = NULL;
+    }
+    // buffers still out are freed when they come back, and the last of them frees the pool
+    pool->dev = NULL;
+    OsalAtomicSet(&pool->detached, 1);
+    NetBufPoolRelease(pool);
+}
+
+NetBuf *NetBufPoolAlloc(struct NetBufPool *pool)
+{
+    NetBuf *nb = NULL;
+
+    if (pool == NULL) {
+        return NULL;
+    }
+    nb = (NetBuf *)HdfMpmcQueueTryPop(&pool->freeList);
+    if (nb != NULL) {
+        OsalAtomicDec(&pool->free);
+        OsalAtomicInc(&pool->hit);
+    } else {
+        OsalAtomicInc(&pool->miss);
+        nb = NetBufPoolNewBuf(pool);
+    }
+    if (nb != NULL) {
+        OsalAtomicInc(&pool->refs);
+    }
+    return nb;
+}
+
+void NetBufPoolRecycle(struct NetBufPool *pool, NetBuf *nb)
+{
+    struct NetBufPool *owner = NULL;
+
+    if (nb == NULL) {
+        return;
+    }
+    // read before the push, another CPU may take the buffer out of the ring right after it
+    owner = NetBufGetPool(nb);
+    if (pool == NULL || OsalAtomicRead(&pool->detached) != 0 || !NetBufPoolResetBuf(pool, nb) ||
+        !NetBufPoolPut(pool, nb)) {
+        if (pool != NULL) {
+            OsalAtomicInc(&pool->overflow);
+        }
+        NetBufFree(nb);
+    }
+    if (owner != NULL) {
+        NetBufPoolRelease(owner);
+    }
+}
+
+void NetBufPoolHandOver(NetBuf *nb, const struct NetDevice *dev)
+{
+    struct NetBufPool *pool = (nb != NULL) ? NetBufGetPool(nb) : NULL;
+
+    if (pool != NULL) {
+        nb->dev = (void *)dev;
+        NetBufPoolRelease(pool);
+    }
+}
+
+int32_t NetBufPoolSetWatermark(struct NetBufPool *pool, uint32_t lowWater, uint32_t highWater)
+{
+    if (pool == NULL || lowWater > highWater || highWater == 0 || highWater > pool->capacity) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+    OsalAtomicSet(&pool->lowWater, (int32_t)lowWater);
+    OsalAtomicSet(&pool->highWater, (int32_t)highWater);
+    return HDF_SUCCESS;
+}
+
+uint32_t NetBufPoolRefill(struct NetBufPool *pool)
+{
+    if (pool == NULL || OsalAtomicRead(&pool->free) >= OsalAtomicRead(&pool->lowWater)) {
+        return 0;
+    }
+    return NetBufPoolFill(pool);
+}
+
+int32_t NetBufPoolGetStat(const struct NetBufPool *pool, struct NetBufPoolStat *stat)
+{
+    if (pool == NULL || stat == NULL) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+    stat->bufSize = pool->bufSize;
+    stat->free = (uint32_t)OsalAtomicRead(&pool->free);
+    stat->lowWater = (uint32_t)OsalAtomicRead(&pool->lowWater);
+    stat->highWater = (uint32_t)OsalAtomicRead(&pool->highWater);
+    stat->hit = (uint32_t)OsalAtomicRead(&pool->hit);
+    stat->miss = (uint32_t)OsalAtomicRead(&pool->miss);
+    stat->overflow = (uint32_t)OsalAtomicRead(&pool->overflow);
+    return HDF_SUCCESS;
+}
+
+uint32_t NetBufPoolGetBufSize(const struct NetBufPool *pool)
+{
+    return pool->bufSize;
+}
+
+void NetBufDevFree(NetBuf *nb)
+{
+    struct NetBufPool *pool = NULL;
+
+    if (nb == NULL) {
+        return;
+    }
+    pool = NetBufGetPool(nb);
+    if (pool != NULL) {
+        NetBufPoolRecycle(pool, nb);
+        return;
+    }
+    NetBufFree(nb);
+}
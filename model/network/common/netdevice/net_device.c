@@ -203,6 +203,8 @@ int32_t NetDeviceDeInit(struct NetDevice *netDevice)
         HDF_LOGI("%s success: already deinit!", __func__);
         return HDF_SUCCESS;
     }
+    NetIfRxGroDisable(netDevice);
+    NetBufPoolDestroy(netDevice->rxPool);
     ndImpl = GetImplByNetDevice(netDevice);
     if (ndImpl == NULL) {
         HDF_LOGI("%s success: already free.", __func__);
@@ -335,6 +337,16 @@ int32_t NetIfSetAddr(const struct NetDevice *netDevice, const IpV4Addr *ipAddr,
     return HDF_ERR_INVALID_PARAM;
 }
 
+static int32_t NetIfRxDeliver(const struct NetDevice *netDevice, NetBuf *buff, ReceiveFlag flag)
+{
+    struct NetDeviceImpl *ndImpl = GetImplByNetDevice(netDevice);
+    if (ndImpl == NULL || ndImpl->interFace == NULL || ndImpl->interFace->receive == NULL) {
+        HDF_LOGE("%s: netdevice not exist!", __func__);
+        return HDF_ERR_INVALID_PARAM;
+    }
+    return ndImpl->interFace->receive(ndImpl, buff, flag);
+}
+
 static int32_t NetIfRxImpl(const struct NetDevice *netDevice, NetBuf *buff, ReceiveFlag flag)
 {
     struct NetDeviceImpl *ndImpl = GetImplByNetDevice(netDevice);
@@ -344,6 +356,7 @@ static int32_t NetIfRxImpl(const struct NetDevice *netDevice, NetBuf *buff, Rece
         HDF_LOGE("%s: NetIfRxImpl fail : netdevice not exist!", __func__);
         return HDF_ERR_INVALID_PARAM;
     }
+    NetBufPoolHandOver(buff, netDevice);
 
     /* to do driver special process */
     if (netDevice->netDeviceIf != NULL && netDevice->netDeviceIf->specialEtherTypeProcess != NULL) {
@@ -351,6 +364,9 @@ static int32_t NetIfRxImpl(const struct NetDevice *netDevice, NetBuf *buff, Rece
     }
     /* Sent to TCP/IP Stack. */
     if (ret == PROCESSING_CONTINUE) {
+        if (netDevice->rxGro != NULL) {
+            return NetRxGroReceive(netDevice->rxGro, buff, flag);
+        }
         return ndImpl->interFace->receive(ndImpl, buff, flag);
     } else if (ret == PROCESSING_COMPLETE) {
         HDF_LOGI("NetIfRxImpl specialEtherType Process not need TCP/IP stack!");
@@ -398,6 +414,49 @@ int32_t NetIfRxNi(const struct NetDevice *netDevice, NetBuf *buff)
     return NetIfRxImpl(netDevice, buff, NO_IN_INTERRUPT);
 }
 
+int32_t NetIfRxGroEnable(struct NetDevice *netDevice, const struct NetRxGroConfig *config)
+{
+    if (netDevice == NULL) {
+        HDF_LOGE("%s: input param is null!", __func__);
+        return HDF_ERR_INVALID_PARAM;
+    }
+    if (netDevice->rxGro != NULL) {
+        HDF_LOGE("%s: %s already enabled!", __func__, netDevice->name);
+        return HDF_ERR_DEVICE_BUSY;
+    }
+    netDevice->rxGro = NetRxGroCreate(netDevice, config, NetIfRxDeliver);
+    return (netDevice->rxGro != NULL) ? HDF_SUCCESS : HDF_FAILURE;
+}
+
+void NetIfRxGroDisable(struct NetDevice *netDevice)
+{
+    struct NetRxGro *gro = NULL;
+
+    if (netDevice == NULL || netDevice->rxGro == NULL) {
+        return;
+    }
+    gro = netDevice->rxGro;
+    netDevice->rxGro = NULL;
+    NetRxGroDestroy(gro);
+}
+
+int32_t NetIfRxGroFlush(const struct NetDevice *netDevice)
+{
+    if (netDevice == NULL || netDevice->rxGro == NULL) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+    return NetRxGroFlush(netDevice->rxGro, IN_INTERRUPT);
+}
+
+int32_t NetIfRxGroGetStat(const struct NetDevice *netDevice, struct NetRxGroStat *stat)
+{
+    if (netDevice == NULL || netDevice->rxGro == NULL || stat == NULL) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+    NetRxGroGetStat(netDevice->rxGro, stat);
+    return HDF_SUCCESS;
+}
+
 int32_t NetIfSetStatus(const struct NetDevice *netDevice, NetIfStatus status)
 {
     struct NetDeviceImpl *ndImpl = GetImplByNetDevice(netDevice);
@@ -490,6 +549,9 @@ NetBuf *NetBufDevAlloc(const struct NetDevice *dev, uint32_t size)
     uint32_t reserve = 0;
     NetBuf *nb = NULL;
 
+    if (dev != NULL && dev->rxPool != NULL && size <= NetBufPoolGetBufSize(dev->rxPool)) {
+        return NetBufPoolAlloc(dev->rxPool);
+    }
     if (dev != NULL) {
         reserve = dev->neededHeadRoom + dev->neededTailRoom;
     }
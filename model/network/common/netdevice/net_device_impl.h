@@ -43,4 +43,20 @@ struct NetDeviceImplOp {
     int32_t (*changeMacAddr)(struct NetDeviceImpl *netDevice);
 };
 
+/* Data size of the buffers in a pool, NetBufDevAlloc serves larger requests outside the pool. */
+uint32_t NetBufPoolGetBufSize(const struct NetBufPool *pool);
+/* Returns the pool a buffer was handed out from, or NULL if it is not out of a pool. */
+struct NetBufPool *NetBufGetPool(const NetBuf *nb);
+/* The network stack takes over a buffer, which no longer returns to its pool and refers to @dev again. */
+void NetBufPoolHandOver(NetBuf *nb, const struct NetDevice *dev);
+
+/* Receive aggregation stage, frames leaving it are passed to @deliver outside of its lock. */
+typedef int32_t (*NetRxGroDeliver)(const struct NetDevice *netDevice, NetBuf *buff, ReceiveFlag flag);
+struct NetRxGro *NetRxGroCreate(const struct NetDevice *netDevice, const struct NetRxGroConfig *config,
+    NetRxGroDeliver deliver);
+void NetRxGroDestroy(struct NetRxGro *gro);
+int32_t NetRxGroReceive(struct NetRxGro *gro, NetBuf *buff, ReceiveFlag flag);
+int32_t NetRxGroFlush(struct NetRxGro *gro, ReceiveFlag flag);
+void NetRxGroGetStat(struct NetRxGro *gro, struct NetRxGroStat *stat);
+
 #endif /* HDF_NET_DEVICE_IMPL_MODULE_H */
\ No newline at end of file
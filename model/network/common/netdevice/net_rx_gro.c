@@ -0,0 +1,521 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ *
+ * HDF is dual licensed: you can use it either under the terms of
+ * the GPL, or the BSD license, at your option.
+ * See the LICENSE file in the root of this repository for complete details.
+ */
+
+#include "securec.h"
+#include "hdf_log.h"
+#include "net_device.h"
+#include "net_device_adapter.h"
+#include "net_device_impl.h"
+#include "osal_mem.h"
+#include "osal_spinlock.h"
+#include "osal_timer.h"
+
+#define HDF_LOG_TAG "NetRxGro"
+
+#define GRO_DEFAULT_MAX_FLOWS 8
+#define GRO_DEFAULT_MAX_SEGMENTS 44
+#define GRO_DEFAULT_FLUSH_TIMEOUT 1 // ms
+#define GRO_IP_MAX_LEN 0xFFFF
+
+#define GRO_IPV4_VERSION_HL 0x45 // version 4 without options
+#define GRO_IP_FRAG_MASK 0x3FFF  // more fragments flag and fragment offset
+#define GRO_IP_PROTO_TCP 6
+#define GRO_TCP_HDR_LEN_SHIFT 4
+#define GRO_TCP_HDR_LEN_UNIT 4
+#define GRO_TCP_FLAG_PSH 0x08
+#define GRO_TCP_FLAG_ACK 0x10
+#define GRO_TCP_CHECK_OFFSET 16
+
+#define GRO_ETHER_HDR_LEN sizeof(struct EtherHeader)
+#define GRO_IP_HDR_LEN sizeof(struct IpHeader)
+#define GRO_TCP_HDR_LEN sizeof(struct TcpHeader)
+#define GRO_DEFAULT_MAX_SIZE (GRO_ETHER_HDR_LEN + GRO_IP_MAX_LEN)
+
+#define BITS_PER_BYTE 8
+#define CSUM_WORD_MASK 0xFFFF
+#define CSUM_BYTE_MASK 0xFF
+#define CSUM_WORD_SHIFT 16
+
+/*
+ * A held frame keeps its own Ether, IP and TCP headers, the payload of each merged segment is appended to it.
+ * The headers are fixed up when the frame is flushed. The TCP checksum of a merged frame is derived from the
+ * checksums the segments arrived with rather than computed over the payload, so a corrupted segment still
+ * fails verification in the protocol stack.
+ */
+struct NetRxGroFlow {
+    NetBuf *head;
+    uint32_t sAddr;
+    uint32_t dAddr;
+    uint16_t sPort;
+    uint16_t dPort;
+    uint32_t ackNum;
+    uint32_t nextSeq;
+    uint32_t payloadLen;
+    uint32_t payloadSum;
+    uint32_t age;
+    uint16_t tcpHdrLen;
+    uint16_t segments;
+};
+
+struct NetRxGro {
+    const struct NetDevice *netDevice;
+    NetRxGroDeliver deliver;
+    struct NetRxGroConfig config;
+    OsalSpinlock lock;
+    OsalTimer timer;
+    bool timerArmed;
+    uint32_t age;
+    struct NetRxGroStat stat;
+    struct NetRxGroFlow flows[0];
+};
+
+/* Parsed view of a frame that is a candidate for merging. */
+struct NetRxGroSegment {
+    struct IpHeader *ipHdr;
+    struct TcpHeader *tcpHdr;
+    uint32_t tcpHdrLen;
+    uint32_t payloadLen;
+};
+
+static uint32_t GroCsumAdd(uint32_t sum, const uint8_t *data, uint32_t len)
+{
+    while (len > 1) {
+        sum += ((uint32_t)data[0] << BITS_PER_BYTE) | data[1];
+        data += sizeof(uint16_t);
+        len -= sizeof(uint16_t);
+    }
+    if (len != 0) {
+        sum += (uint32_t)data[0] << BITS_PER_BYTE;
+    }
+    return sum;
+}
+
+static uint16_t GroCsumFold(uint32_t sum)
+{
+    while ((sum >> CSUM_WORD_SHIFT) != 0) {
+        sum = (sum & CSUM_WORD_MASK) + (sum >> CSUM_WORD_SHIFT);
+    }
+    return (uint16_t)sum;
+}
+
+static uint32_t GroCsumPseudo(const struct IpHeader *ipHdr, uint32_t tcpLen)
+{
+    uint32_t sum = GroCsumAdd(0, (const uint8_t *)&ipHdr->sAddr, sizeof(ipHdr->sAddr));
+    sum = GroCsumAdd(sum, (const uint8_t *)&ipHdr->dAddr, sizeof(ipHdr->dAddr));
+    return sum + GRO_IP_PROTO_TCP + tcpLen;
+}
+
+/* Sum of the TCP header with the checksum field taken as zero. */
+static uint32_t GroCsumTcpHdr(const struct TcpHeader *tcpHdr, uint32_t tcpHdrLen)
+{
+    const uint8_t *data = (const uint8_t *)tcpHdr;
+    uint32_t sum = GroCsumAdd(0, data, GRO_TCP_CHECK_OFFSET);
+    return GroCsumAdd(sum, data + GRO_TCP_CHECK_OFFSET + sizeof(tcpHdr->check),
+        tcpHdrLen - GRO_TCP_CHECK_OFFSET - sizeof(tcpHdr->check));
+}
+
+/* Recovers the sum of the payload from the checksum of the segment. */
+static uint32_t GroCsumPayload(const struct IpHeader *ipHdr, const struct TcpHeader *tcpHdr, uint32_t tcpHdrLen,
+    uint32_t payloadLen)
+{
+    uint16_t total = (uint16_t)~ntohs(tcpHdr->check);
+    uint16_t pseudo = GroCsumFold(GroCsumPseudo(ipHdr, tcpHdrLen + payloadLen));
+    uint16_t header = GroCsumFold(GroCsumTcpHdr(tcpHdr, tcpHdrLen));
+    return GroCsumFold((uint32_t)total + (uint16_t)~pseudo + (uint16_t)~header);
+}
+
+static bool GroParseSegment(NetBuf *buff, struct NetRxGroSegment *seg)
+{
+    uint8_t *data = NetBufGetAddress(buff, E_DATA_BUF);
+    uint32_t len = NetBufGetDataLen(buff);
+    const struct EtherHeader *etherHdr = (const struct EtherHeader *)data;
+    uint32_t ipLen;
+
+    if (data == NULL || len < GRO_ETHER_HDR_LEN + GRO_IP_HDR_LEN + GRO_TCP_HDR_LEN ||
+        etherHdr->etherType != htons(ETHER_TYPE_IP)) {
+        return false;
+    }
+    seg->ipHdr = (struct IpHeader *)(data + GRO_ETHER_HDR_LEN);
+    ipLen = ntohs(seg->ipHdr->totLen);
+    /* frames with Ether padding are left alone, only full sized segments are worth merging */
+    if (seg->ipHdr->versionAndHl != GRO_IPV4_VERSION_HL || seg->ipHdr->protocol != GRO_IP_PROTO_TCP ||
+        (ntohs(seg->ipHdr->fragInfo) & GRO_IP_FRAG_MASK) != 0 || ipLen != len - GRO_ETHER_HDR_LEN ||
+        GroCsumFold(GroCsumAdd(0, (const uint8_t *)seg->ipHdr, GRO_IP_HDR_LEN)) != CSUM_WORD_MASK) {
+        return false;
+    }
+    seg->tcpHdr = (struct TcpHeader *)(data + GRO_ETHER_HDR_LEN + GRO_IP_HDR_LEN);
+    seg->tcpHdrLen = (uint32_t)(seg->tcpHdr->offset >> GRO_TCP_HDR_LEN_SHIFT) * GRO_TCP_HDR_LEN_UNIT;
+    if (seg->tcpHdrLen < GRO_TCP_HDR_LEN || seg->tcpHdrLen > ipLen - GRO_IP_HDR_LEN) {
+        return false;
+    }
+    seg->payloadLen = ipLen - GRO_IP_HDR_LEN - seg->tcpHdrLen;
+    return true;
+}
+
+static bool GroSegmentMergeable(const struct NetRxGroSegment *seg)
+{
+    return seg->payloadLen != 0 && (seg->tcpHdr->flags & GRO_TCP_FLAG_ACK) != 0 &&
+        (seg->tcpHdr->flags & ~(GRO_TCP_FLAG_ACK | GRO_TCP_FLAG_PSH)) == 0;
+}
+
+static bool GroFlowMatch(const struct NetRxGroFlow *flow, const struct NetRxGroSegment *seg)
+{
+    return flow->head != NULL && flow->sAddr == seg->ipHdr->sAddr && flow->dAddr == seg->ipHdr->dAddr &&
+        flow->sPort == seg->tcpHdr->sPort && flow->dPort == seg->tcpHdr->dPort;
+}
+
+static void GroHeldHeaders(const struct NetRxGroFlow *flow, struct IpHeader **ipHdr, struct TcpHeader **tcpHdr)
+{
+    uint8_t *data = NetBufGetAddress(flow->head, E_DATA_BUF);
+    *ipHdr = (struct IpHeader *)(data + GRO_ETHER_HDR_LEN);
+    *tcpHdr = (struct TcpHeader *)(data + GRO_ETHER_HDR_LEN + GRO_IP_HDR_LEN);
+}
+
+/* Fixes up the headers of a merged frame and takes it out of the flow table. */
+static NetBuf *GroFlowRelease(struct NetRxGroFlow *flow)
+{
+    NetBuf *buff = flow->head;
+    struct IpHeader *ipHdr = NULL;
+    struct TcpHeader *tcpHdr = NULL;
+    uint32_t tcpLen;
+    uint16_t check;
+
+    if (flow->segments > 1) {
+        GroHeldHeaders(flow, &ipHdr, &tcpHdr);
+        tcpLen = flow->tcpHdrLen + flow->payloadLen;
+        ipHdr->totLen = htons((uint16_t)(GRO_IP_HDR_LEN + tcpLen));
+        ipHdr->check = 0;
+        ipHdr->check = htons((uint16_t)~GroCsumFold(GroCsumAdd(0, (const uint8_t *)ipHdr, GRO_IP_HDR_LEN)));
+        check = (uint16_t)~GroCsumFold(GroCsumPseudo(ipHdr, tcpLen) + GroCsumTcpHdr(tcpHdr, flow->tcpHdrLen) +
+            flow->payloadSum);
+        tcpHdr->check = htons(check);
+    }
+    flow->head = NULL;
+    return buff;
+}
+
+static void GroFlowHold(struct NetRxGro *gro, struct NetRxGroFlow *flow, NetBuf *buff,
+    const struct NetRxGroSegment *seg)
+{
+    flow->head = buff;
+    flow->sAddr = seg->ipHdr->sAddr;
+    flow->dAddr = seg->ipHdr->dAddr;
+    flow->sPort = seg->tcpHdr->sPort;
+    flow->dPort = seg->tcpHdr->dPort;
+    flow->ackNum = seg->tcpHdr->ackNum;
+    flow->nextSeq = ntohl(seg->tcpHdr->seqNum) + seg->payloadLen;
+    flow->payloadLen = seg->payloadLen;
+    flow->tcpHdrLen = (uint16_t)seg->tcpHdrLen;
+    flow->segments = 1;
+    flow->age = gro->age++;
+}
+
+/* Moves the held frame into a buffer with room for merged segments. */
+static bool GroFlowGrow(struct NetRxGro *gro, struct NetRxGroFlow *flow)
+{
+    NetBuf *head = NULL;
+
+    if (NetBufGetRoom(flow->head, E_TAIL_BUF) + NetBufGetDataLen(flow->head) >= gro->config.maxSize) {
+        return true;
+    }
+    head = NetBufDevAlloc(gro->netDevice, gro->config.maxSize);
+    if (head == NULL) {
+        return false;
+    }
+    if (NetBufConcat(head, flow->head) != HDF_SUCCESS) {
+        NetBufFree(head);
+        return false;
+    }
+    flow->head = head;
+    return true;
+}
+
+static bool GroFlowMerge(struct NetRxGro *gro, struct NetRxGroFlow *flow, NetBuf *buff,
+    const struct NetRxGroSegment *seg)
+{
+    struct IpHeader *ipHdr = NULL;
+    struct TcpHeader *tcpHdr = NULL;
+    uint32_t hdrLen = GRO_ETHER_HDR_LEN + GRO_IP_HDR_LEN + seg->tcpHdrLen;
+    uint32_t payloadSum;
+    uint16_t window;
+    uint8_t tcpFlags;
+
+    GroHeldHeaders(flow, &ipHdr, &tcpHdr);
+    if (flow->segments >= gro->config.maxSegments || seg->tcpHdrLen != flow->tcpHdrLen ||
+        seg->tcpHdr->ackNum != flow->ackNum || ntohl(seg->tcpHdr->seqNum) != flow->nextSeq ||
+        seg->ipHdr->tos != ipHdr->tos || seg->ipHdr->ttl != ipHdr->ttl ||
+        GRO_ETHER_HDR_LEN + GRO_IP_HDR_LEN + flow->tcpHdrLen + flow->payloadLen + seg->payloadLen >
+        gro->config.maxSize ||
+        memcmp((const uint8_t *)seg->tcpHdr + GRO_TCP_HDR_LEN, (const uint8_t *)tcpHdr + GRO_TCP_HDR_LEN,
+        seg->tcpHdrLen - GRO_TCP_HDR_LEN) != 0) {
+        return false;
+    }
+    if (flow->segments == 1) {
+        flow->payloadSum = GroCsumPayload(ipHdr, tcpHdr, flow->tcpHdrLen, flow->payloadLen);
+        if (!GroFlowGrow(gro, flow)) {
+            return false;
+        }
+        GroHeldHeaders(flow, &ipHdr, &tcpHdr);
+    }
+    payloadSum = GroCsumPayload(seg->ipHdr, seg->tcpHdr, seg->tcpHdrLen, seg->payloadLen);
+    /* an odd offset in the merged payload swaps the bytes of each word of the segment */
+    if ((flow->payloadLen & 1) != 0) {
+        payloadSum = ((payloadSum & CSUM_BYTE_MASK) << BITS_PER_BYTE) | (payloadSum >> BITS_PER_BYTE);
+    }
+    window = seg->tcpHdr->window;
+    tcpFlags = seg->tcpHdr->flags;
+    if (NetBufPop(buff, E_DATA_BUF, hdrLen) == NULL) {
+        return false;
+    }
+    /* the segment is freed once its payload is appended */
+    if (NetBufConcat(flow->head, buff) != HDF_SUCCESS) {
+        NetBufPop(buff, E_HEAD_BUF, hdrLen);
+        return false;
+    }
+    tcpHdr->window = window;
+    tcpHdr->flags |= tcpFlags;
+    flow->payloadSum = GroCsumFold(flow->payloadSum + payloadSum);
+    flow->payloadLen += seg->payloadLen;
+    flow->nextSeq += seg->payloadLen;
+    flow->segments++;
+    gro->stat.merged++;
+    return true;
+}
+
+static struct NetRxGroFlow *GroFlowFindFree(struct NetRxGro *gro, NetBufQueue *out)
+{
+    struct NetRxGroFlow *oldest = &gro->flows[0];
+    uint16_t i;
+
+    for (i = 0; i < gro->config.maxFlows; i++) {
+        if (gro->flows[i].head == NULL) {
+            return &gro->flows[i];
+        }
+        if ((int32_t)(gro->flows[i].age - oldest->age) < 0) {
+            oldest = &gro->flows[i];
+        }
+    }
+    NetBufQueueEnqueue(out, GroFlowRelease(oldest));
+    return oldest;
+}
+
+/* Returns true if the frame was held or merged, frames to be passed on are queued to @out in order. */
+static bool GroReceiveLocked(struct NetRxGro *gro, NetBuf *buff, NetBufQueue *out)
+{
+    struct NetRxGroSegment seg;
+    struct NetRxGroFlow *flow = NULL;
+    bool push = false;
+    uint16_t i;
+
+    gro->stat.received++;
+    if (!GroParseSegment(buff, &seg)) {
+        NetBufQueueEnqueue(out, buff);
+        return false;
+    }
+    for (i = 0; i < gro->config.maxFlows; i++) {
+        if (GroFlowMatch(&gro->flows[i], &seg)) {
+            flow = &gro->flows[i];
+            break;
+        }
+    }
+    push = (seg.tcpHdr->flags & GRO_TCP_FLAG_PSH) != 0;
+    if (flow != NULL && GroSegmentMergeable(&seg) && GroFlowMerge(gro, flow, buff, &seg)) {
+        if (push) {
+            NetBufQueueEnqueue(out, GroFlowRelease(flow));
+        }
+        return true;
+    }
+    /* the held frame of the flow goes first so the stream stays in order */
+    if (flow != NULL) {
+        NetBufQueueEnqueue(out, GroFlowRelease(flow));
+    }
+    if (!GroSegmentMergeable(&seg) || push) {
+        NetBufQueueEnqueue(out, buff);
+        return false;
+    }
+    if (flow == NULL) {
+        flow = GroFlowFindFree(gro, out);
+    }
+    GroFlowHold(gro, flow, buff, &seg);
+    return true;
+}
+
+static void GroReleaseAllLocked(struct NetRxGro *gro, NetBufQueue *out)
+{
+    uint16_t i;
+
+    for (i = 0; i < gro->config.maxFlows; i++) {
+        if (gro->flows[i].head != NULL) {
+            NetBufQueueEnqueue(out, GroFlowRelease(&gro->flows[i]));
+        }
+    }
+}
+
+static bool GroHasHeldLocked(const struct NetRxGro *gro)
+{
+    uint16_t i;
+
+    for (i = 0; i < gro->config.maxFlows; i++) {
+        if (gro->flows[i].head != NULL) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static int32_t GroDeliverQueue(struct NetRxGro *gro, NetBufQueue *out, ReceiveFlag flag)
+{
+    int32_t ret = HDF_SUCCESS;
+    int32_t err;
+    uint32_t flags = 0;
+    uint32_t count = NetBufQueueSize(out);
+    NetBuf *buff = NULL;
+
+    while ((buff = NetBufQueueDequeue(out)) != NULL) {
+        err = gro->deliver(gro->netDevice, buff, flag);
+        if (err != HDF_SUCCESS) {
+            HDF_LOGE("%s: %s deliver fail, ret=%d", __func__, gro->netDevice->name, err);
+            ret = err;
+        }
+    }
+    if (count != 0) {
+        OsalSpinLockIrqSave(&gro->lock, &flags);
+        gro->stat.delivered += count;
+        OsalSpinUnlockIrqRestore(&gro->lock, &flags);
+    }
+    return ret;
+}
+
+static void GroTimerEntry(uintptr_t arg)
+{
+    struct NetRxGro *gro = (struct NetRxGro *)arg;
+    NetBufQueue out;
+    uint32_t flags = 0;
+
+    NetBufQueueInit(&out);
+    OsalSpinLockIrqSave(&gro->lock, &flags);
+    gro->timerArmed = false;
+    GroReleaseAllLocked(gro, &out);
+    if (NetBufQueueSize(&out) != 0) {
+        gro->stat.timerFlush++;
+    }
+    OsalSpinUnlockIrqRestore(&gro->lock, &flags);
+    (void)GroDeliverQueue(gro, &out, IN_INTERRUPT);
+}
+
+int32_t NetRxGroReceive(struct NetRxGro *gro, NetBuf *buff, ReceiveFlag flag)
+{
+    NetBufQueue out;
+    uint32_t flags = 0;
+    bool held = false;
+    bool armTimer = false;
+    int32_t ret;
+
+    NetBufQueueInit(&out);
+    OsalSpinLockIrqSave(&gro->lock, &flags);
+    held = GroReceiveLocked(gro, buff, &out);
+    if (gro->config.flushTimeout != 0 && !gro->timerArmed && GroHasHeldLocked(gro)) {
+        gro->timerArmed = true;
+        armTimer = true;
+    }
+    OsalSpinUnlockIrqRestore(&gro->lock, &flags);
+
+    if (armTimer && OsalTimerStartOnce(&gro->timer) != HDF_SUCCESS) {
+        HDF_LOGW("%s: start flush timer fail", __func__);
+        OsalSpinLockIrqSave(&gro->lock, &flags);
+        gro->timerArmed = false;
+        OsalSpinUnlockIrqRestore(&gro->lock, &flags);
+    }
+    ret = GroDeliverQueue(gro, &out, flag);
+    return held ? HDF_SUCCESS : ret;
+}
+
+int32_t NetRxGroFlush(struct NetRxGro *gro, ReceiveFlag flag)
+{
+    NetBufQueue out;
+    uint32_t flags = 0;
+
+    NetBufQueueInit(&out);
+    OsalSpinLockIrqSave(&gro->lock, &flags);
+    GroReleaseAllLocked(gro, &out);
+    if (NetBufQueueSize(&out) != 0) {
+        gro->stat.batchFlush++;
+    }
+    OsalSpinUnlockIrqRestore(&gro->lock, &flags);
+    return GroDeliverQueue(gro, &out, flag);
+}
+
+void NetRxGroGetStat(struct NetRxGro *gro, struct NetRxGroStat *stat)
+{
+    uint32_t flags = 0;
+
+    OsalSpinLockIrqSave(&gro->lock, &flags);
+    *stat = gro->stat;
+    OsalSpinUnlockIrqRestore(&gro->lock, &flags);
+}
+
+static bool GroConfigValid(const struct NetRxGroConfig *config)
+{
+    return config->maxFlows != 0 && config->maxFlows <= NET_RX_GRO_MAX_FLOWS && config->maxSegments > 1 &&
+        config->maxSize > GRO_ETHER_HDR_LEN + GRO_IP_HDR_LEN + GRO_TCP_HDR_LEN &&
+        config->maxSize <= GRO_DEFAULT_MAX_SIZE;
+}
+
+struct NetRxGro *NetRxGroCreate(const struct NetDevice *netDevice, const struct NetRxGroConfig *config,
+    NetRxGroDeliver deliver)
+{
+    static const struct NetRxGroConfig defaultConfig = {
+        .maxFlows = GRO_DEFAULT_MAX_FLOWS,
+        .maxSegments = GRO_DEFAULT_MAX_SEGMENTS,
+        .maxSize = GRO_DEFAULT_MAX_SIZE,
+        .flushTimeout = GRO_DEFAULT_FLUSH_TIMEOUT,
+    };
+    struct NetRxGro *gro = NULL;
+
+    if (config == NULL) {
+        config = &defaultConfig;
+    }
+    if (netDevice == NULL || deliver == NULL || !GroConfigValid(config)) {
+        HDF_LOGE("%s: invalid param", __func__);
+        return NULL;
+    }
+    gro = (struct NetRxGro *)OsalMemCalloc(sizeof(*gro) + sizeof(struct NetRxGroFlow) * config->maxFlows);
+    if (gro == NULL) {
+        HDF_LOGE("%s: OsalMemCalloc fail", __func__);
+        return NULL;
+    }
+    gro->netDevice = netDevice;
+    gro->deliver = deliver;
+    gro->config = *config;
+    if (OsalSpinInit(&gro->lock) != HDF_SUCCESS) {
+        HDF_LOGE("%s: OsalSpinInit fail", __func__);
+        OsalMemFree(gro);
+        return NULL;
+    }
+    if (config->flushTimeout != 0 &&
+        OsalTimerCreate(&gro->timer, config->flushTimeout, GroTimerEntry, (uintptr_t)gro) != HDF_SUCCESS) {
+        HDF_LOGE("%s: OsalTimerCreate fail", __func__);
+        (void)OsalSpinDestroy(&gro->lock);
+        OsalMemFree(gro);
+        return NULL;
+    }
+    return gro;
+}
+
+void NetRxGroDestroy(struct NetRxGro *gro)
+{
+    if (gro == NULL) {
+        return;
+    }
+    if (gro->config.flushTimeout != 0) {
+        (void)OsalTimerDelete(&gro->timer);
+    }
+    (void)NetRxGroFlush(gro, NO_IN_INTERRUPT);
+    (void)OsalSpinDestroy(&gro->lock);
+    OsalMemFree(gro);
+}
@@ -86,6 +86,36 @@ typedef enum {
     THREAD_STATUS_COUNT    /**< Total number of thread statuses */
 }FcThreadStatus;
 
+/**
+ * @brief Describes the scheduling parameters of a flow control queue.
+ *
+ * @since 1.0
+ * @version 1.0
+ */
+struct FlowControlSchedParam {
+    uint32_t quantum;        /**< Bytes a queue may send per deficit round robin round. The value <b>0</b> means
+                              * the queue is served before all round robin queues.
+                              */
+    uint32_t codelTarget;    /**< Acceptable queueing delay, in microseconds */
+    uint32_t codelInterval;  /**< Time the queueing delay may stay above the target before packets are
+                              * dropped, in microseconds
+                              */
+};
+
+/**
+ * @brief Describes the statistics of a flow control queue.
+ *
+ * @since 1.0
+ * @version 1.0
+ */
+struct FlowControlQueueStat {
+    uint32_t enqueued;    /**< Packets queued */
+    uint32_t sent;        /**< Packets handed to the driver */
+    uint32_t dropped;     /**< Packets dropped by the queue limit or the scheduler */
+    uint32_t sojournAvg;  /**< Moving average of the queueing delay, in microseconds */
+    uint32_t sojournMax;  /**< Largest queueing delay, in microseconds */
+};
+
 /**
  * @brief Describes a flow control queue.
  *
@@ -93,11 +123,13 @@ typedef enum {
  * @version 1.0
  */
 struct FlowControlQueue {
-    FlowControlQueueID queueID;  /**< Flow control queue ID */
-    NetBufQueue dataQueue;       /**< Network data queue */
-    uint32_t queueThreshold;     /**< Network data queue threshold */
-    OsalSpinlock lock;           /**< Queue lock */
-    uint32_t pktCount;           /**< Number of packets received by the network data queue */
+    FlowControlQueueID queueID;          /**< Flow control queue ID */
+    NetBufQueue dataQueue;               /**< Network data queue */
+    uint32_t queueThreshold;             /**< Network data queue threshold */
+    OsalSpinlock lock;                   /**< Queue lock */
+    uint32_t pktCount;                   /**< Number of packets received by the network data queue */
+    struct FlowControlSchedParam param;  /**< Scheduling parameters */
+    struct FlowControlQueueStat stat;    /**< Queue statistics */
 };
 
 /**
@@ -202,6 +234,69 @@ struct FlowControlOp {
     int32_t (*getRxPriorityId)(FlowControlQueueID id);
 };
 
+struct FlowControlModule;
+
+/**
+ * @brief Describes a flow control scheduler, which decides how the packets of one flow direction are queued and
+ * in which order the queues are handed to the driver.
+ *
+ * A module without a scheduler serves its queues in strict priority order.
+ *
+ * @since 1.0
+ * @version 1.0
+ */
+struct FlowControlScheduler {
+    /**
+     * @brief Prepares the scheduler for a flow direction, the packets already queued are kept.
+     *
+     * @param fcm Indicates the pointer to the {@link FlowControlModule}.
+     * @param dir Indicates the flow control direction, as enumerated in {@link FlowDir}.
+     * @return Returns <b>0</b> if the scheduler is prepared; returns a negative value otherwise.
+     *
+     * @since 1.0
+     * @version 1.0
+     */
+    int32_t (*init)(struct FlowControlModule *fcm, FlowDir dir);
+
+    /**
+     * @brief Releases the scheduler of a flow direction, the packets queued are kept.
+     *
+     * @param fcm Indicates the pointer to the {@link FlowControlModule}.
+     * @param dir Indicates the flow control direction, as enumerated in {@link FlowDir}.
+     *
+     * @since 1.0
+     * @version 1.0
+     */
+    void (*deinit)(struct FlowControlModule *fcm, FlowDir dir);
+
+    /**
+     * @brief Queues a packet, the scheduler owns the packet afterwards even if it drops it.
+     *
+     * @param fcm Indicates the pointer to the {@link FlowControlModule}.
+     * @param buff Indicates the pointer to the packet.
+     * @param id Indicates the ID of the flow control queue.
+     * @param dir Indicates the flow control direction, as enumerated in {@link FlowDir}.
+     * @return Returns <b>0</b> if the packet is queued; returns a negative value otherwise.
+     *
+     * @since 1.0
+     * @version 1.0
+     */
+    int32_t (*enqueue)(struct FlowControlModule *fcm, NetBuf *buff, FlowControlQueueID id, FlowDir dir);
+
+    /**
+     * @brief Hands the queued packets to the driver, called by the flow control thread of the direction.
+     *
+     * @param fcm Indicates the pointer to the {@link FlowControlModule}.
+     * @param dir Indicates the flow control direction, as enumerated in {@link FlowDir}.
+     * @return Returns the longest time in milliseconds the thread waits for <b>schedFCM</b> before calling
+     * again, <b>HDF_WAIT_FOREVER</b> if no packets are left.
+     *
+     * @since 1.0
+     * @version 1.0
+     */
+    uint32_t (*schedule)(struct FlowControlModule *fcm, FlowDir dir);
+};
+
 /**
  * @brief Describes a flow control module.
  *
@@ -217,6 +312,8 @@ struct FlowControlModule {
     struct FlowControlOp *op;                           /**< Flow control operation */
     struct FlowControlInterface *interface;             /**< Flow control function */
     void *fcmPriv;                                      /**< Private data of the flow control module */
+    const struct FlowControlScheduler *scheduler[FLOW_DIR_COUNT]; /**< Scheduler of each flow direction */
+    void *schedPriv[FLOW_DIR_COUNT];                    /**< Private data of the scheduler of each direction */
 };
 
 /**
@@ -265,6 +362,22 @@ struct FlowControlInterface {
      */
     int32_t (*sendBuffToFCM)(struct FlowControlModule *fcm, NetBuf *buff, uint32_t id, uint32_t dir);
 
+    /**
+     * @brief Classifies a batch of data and sends it to a specified {@link FlowControlModule}.
+     *
+     * Each buffer is dequeued from <b>q</b>, classified as {@link getQueueIdByEtherBuff} does and sent to its
+     * flow control queue. Buffers that cannot be sent are freed, so <b>q</b> is empty on return.
+     *
+     * @param fcm Indicates the pointer to the {@link FlowControlModule}.
+     * @param q Indicates the pointer to the queue of buffers to send.
+     * @param dir Indicates the flow control direction, as enumerated in {@link FlowDir}.
+     * @return Returns the number of buffers sent.
+     *
+     * @since 1.0
+     * @version 1.0
+     */
+    uint32_t (*sendQueueToFCM)(struct FlowControlModule *fcm, NetBufQueue *q, uint32_t dir);
+
     /**
      * @brief Schedules a specified {@link FlowControlModule}.
      *
@@ -288,6 +401,54 @@ struct FlowControlInterface {
      * @version 1.0
      */
     int32_t (*registerFlowControlOp)(struct FlowControlModule *fcm, struct FlowControlOp *op);
+
+    /**
+     * @brief Sets the scheduler of a flow direction.
+     *
+     * The direction must be idle while its scheduler is changed, for example right after the module is
+     * initialized.
+     *
+     * @param fcm Indicates the pointer to the {@link FlowControlModule}.
+     * @param scheduler Indicates the pointer to the scheduler, such as {@link GetFlowControlDrrScheduler}.
+     * The value <b>NULL</b> restores strict priority scheduling.
+     * @param dir Indicates the flow control direction, as enumerated in {@link FlowDir}.
+     * @return Returns <b>0</b> if the scheduler is set; returns a negative value otherwise.
+     *
+     * @since 1.0
+     * @version 1.0
+     */
+    int32_t (*setScheduler)(struct FlowControlModule *fcm, const struct FlowControlScheduler *scheduler,
+        uint32_t dir);
+
+    /**
+     * @brief Sets the scheduling parameters of a specified flow control queue.
+     *
+     * @param fcm Indicates the pointer to the {@link FlowControlModule} that contains the flow control queue.
+     * @param param Indicates the pointer to the scheduling parameters.
+     * @param id Indicates the ID of the flow control queue.
+     * @param dir Indicates the flow control direction, as enumerated in {@link FlowDir}.
+     * @return Returns <b>0</b> if the parameters are set; returns a negative value otherwise.
+     *
+     * @since 1.0
+     * @version 1.0
+     */
+    int32_t (*setQueueSchedParam)(struct FlowControlModule *fcm, const struct FlowControlSchedParam *param,
+        uint32_t id, uint32_t dir);
+
+    /**
+     * @brief Obtains the statistics of a specified flow control queue.
+     *
+     * @param fcm Indicates the pointer to the {@link FlowControlModule} that contains the flow control queue.
+     * @param stat Indicates the pointer to the statistics obtained.
+     * @param id Indicates the ID of the flow control queue.
+     * @param dir Indicates the flow control direction, as enumerated in {@link FlowDir}.
+     * @return Returns <b>0</b> if the statistics are obtained; returns a negative value otherwise.
+     *
+     * @since 1.0
+     * @version 1.0
+     */
+    int32_t (*getQueueStat)(struct FlowControlModule *fcm, struct FlowControlQueueStat *stat, uint32_t id,
+        uint32_t dir);
 };
 
 /**
@@ -360,5 +521,19 @@ void DeInitFlowControl(struct FlowControlModule *fcm);
  */
 int32_t SendFlowControlQueue(struct FlowControlModule *fcm, uint32_t id, uint32_t dir);
 
+/**
+ * @brief Obtains the deficit round robin scheduler.
+ *
+ * Queues with a quantum of <b>0</b> are served first in strict order, the others share the link in proportion to
+ * their quanta. Instead of by its threshold, a queue drops packets from its head, CoDel style, once its queueing
+ * delay has stayed above the target for longer than the interval.
+ *
+ * @return Returns the pointer to the scheduler.
+ *
+ * @since 1.0
+ * @version 1.0
+ */
+const struct FlowControlScheduler *GetFlowControlDrrScheduler(void);
+
 #endif /* WIFI_FLOW_CONTROL_H */
 /** @} */
@@ -30,6 +30,10 @@
 #define DEFAULT_DISPATCHER_PRIORITY_COUNT 2
 #endif
 
+#ifndef MESSAGE_DISPATCHER_MAX_WORKER
+#define MESSAGE_DISPATCHER_MAX_WORKER 4
+#endif
+
 #define IOCTL_SEND_QUEUE_SIZE 300
 #define IOCTL_SEND_QUEUE_PROPIRTY_LEVEL 1
 
@@ -52,6 +56,7 @@ typedef struct DispatcherConfig_ {
     DispatcherId dispatcherId;
     uint8_t priorityLevelCount;
     uint16_t queueSize;
+    uint8_t workerCount; // worker threads of the dispatcher, 0 means 1
 } DispatcherConfig;
 
 #endif
\ No newline at end of file
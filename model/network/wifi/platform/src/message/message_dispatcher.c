@@ -8,8 +8,8 @@
 
 #include "securec.h"
 #include "osal/osal_thread.h"
-#include "osal/osal_time.h"
 #include "osal/osal_mutex.h"
+#include "osal/osal_sem.h"
 #include "utils/hdf_log.h"
 #include "message_dispatcher.h"
 #include "hdf_wlan_priority_queue.h"
@@ -21,9 +21,18 @@
 #define HDF_LOG_TAG KMsgEngine
 #endif
 
+typedef struct {
+    MessageDispatcher *dispatcher;
+    uint8_t index;
+    OSAL_DECLARE_THREAD(thread);
+} DispatcherWorker;
+
 typedef struct {
     INHERT_MESSAGE_DISPATCHER;
-    OSAL_DECLARE_THREAD(dispatcherThread);
+    OsalAtomic readyWorkers;
+    struct OsalSem readySem;
+    struct OsalSem startSem;
+    DispatcherWorker workers[MESSAGE_DISPATCHER_MAX_WORKER];
 } LocalMessageDispatcher;
 
 void ReleaseMessageContext(MessageContext *context)
@@ -79,8 +88,21 @@ struct MessageDef *GetMsgDef(const struct ServiceDef *serviceDef, uint32_t comma
     return msgDef;
 }
 
+/*
+ * Messages are sharded to the workers by the service they are delivered to, so the handlers of a service
+ * never run concurrently and see its messages in order.
+ */
+static PriorityQueue *GetServiceQueue(const MessageDispatcher *dispatcher, ServiceId serviceId)
+{
+    if (dispatcher->workerCount == 0) {
+        return NULL;
+    }
+    return dispatcher->messageQueue[serviceId % dispatcher->workerCount];
+}
+
 ErrorCode AppendToLocalDispatcher(MessageDispatcher *dispatcher, const uint8_t priority, MessageContext *context)
 {
+    PriorityQueue *queue = NULL;
     if (context == NULL) {
         HDF_LOGE("%s:Input context is NULL!", __func__);
         return ME_ERROR_NULL_PTR;
@@ -90,7 +112,8 @@ ErrorCode AppendToLocalDispatcher(MessageDispatcher *dispatcher, const uint8_t p
         return ME_ERROR_NULL_PTR;
     }
 
-    if (dispatcher->messageQueue == NULL) {
+    queue = GetServiceQueue(dispatcher, context->receiverId);
+    if (queue == NULL) {
         HDF_LOGE("MessageQueue is NULL.");
         return ME_ERROR_NULL_PTR;
     }
@@ -99,7 +122,7 @@ ErrorCode AppendToLocalDispatcher(MessageDispatcher *dispatcher, const uint8_t p
         HDF_LOGE("%s:dispatcher is not running", __func__);
         return ME_ERROR_DISPATCHER_NOT_RUNNING;
     }
-    return PushPriorityQueue(dispatcher->messageQueue, priority, context);
+    return PushPriorityQueue(queue, priority, context);
 }
 
 void SetToResponse(MessageContext *context)
@@ -224,64 +247,142 @@ static void HandleMessage(MessageContext *context)
 static void ReleaseAllMessage(MessageDispatcher *dispatcher)
 {
     MessageContext *context = NULL;
-    do {
-        context = PopPriorityQueue(dispatcher->messageQueue, 0);
-        ReleaseMessageContext(context);
-    } while (context != NULL);
+    uint8_t i;
+    for (i = 0; i < MESSAGE_DISPATCHER_MAX_WORKER; i++) {
+        if (dispatcher->messageQueue[i] == NULL) {
+            continue;
+        }
+        do {
+            context = PopPriorityQueue(dispatcher->messageQueue[i], 0);
+            ReleaseMessageContext(context);
+        } while (context != NULL);
+    }
 }
 
 static int RunDispatcher(void *para)
 {
+    DispatcherWorker *worker = NULL;
     MessageDispatcher *dispatcher = NULL;
+    LocalMessageDispatcher *localDispatcher = NULL;
+    PriorityQueue *queue = NULL;
     MessageContext *context = NULL;
     if (para == NULL) {
         HDF_LOGE("Start dispatcher failed! cause:%s\n", "input para is NULL");
         return ME_ERROR_NULL_PTR;
     }
-    dispatcher = (MessageDispatcher *)para;
-    if (dispatcher->messageQueue == NULL) {
-        HDF_LOGE("Start dispatcher failed! cause:%s\n", "message queue is NULL");
-        return ME_ERROR_NULL_PTR;
-    }
-
-    if (dispatcher->Ref != NULL) {
-        dispatcher = dispatcher->Ref(dispatcher);
-    }
-
-    if (dispatcher->status != ME_STATUS_STARTTING) {
+    // StartDispatcher has taken the reference this worker holds
+    worker = (DispatcherWorker *)para;
+    dispatcher = worker->dispatcher;
+    localDispatcher = (LocalMessageDispatcher *)dispatcher;
+    queue = dispatcher->messageQueue[worker->index];
+
+    // Report in and wait until StartDispatcher knows whether every worker came up
+    (void)OsalSemPost(&localDispatcher->readySem);
+    (void)OsalSemWait(&localDispatcher->startSem, HDF_WAIT_FOREVER);
+    if (dispatcher->status == ME_STATUS_STOPPED) {
+        // Another worker failed to start, StartDispatcher waits for this one to leave
+        HDF_LOGE("Start dispatcher failed! cause:%s\n", "other worker failed to start");
+        (void)OsalSemPost(&localDispatcher->readySem);
         if (dispatcher->Disref != NULL) {
             dispatcher->Disref(dispatcher);
         }
-        HDF_LOGE("Start dispatcher failed! cause:%s\n", "dispatcher is not stopped");
         return ME_ERROR_WRONG_STATUS;
-    } else {
-        dispatcher->status = ME_STATUS_RUNNING;
     }
+
     while (dispatcher->status == ME_STATUS_RUNNING) {
-        context = PopPriorityQueue(dispatcher->messageQueue, QUEUE_OPER_TIMEOUT);
+        context = PopPriorityQueue(queue, QUEUE_OPER_TIMEOUT);
         if (context == NULL) {
             continue;
         }
         HandleMessage(context);
     }
 
-    ReleaseAllMessage(dispatcher);
-    dispatcher->status = ME_STATUS_TODESTROY;
+    // The last worker to leave releases what is still queued
+    if (OsalAtomicDecReturn(&localDispatcher->readyWorkers) == 0) {
+        ReleaseAllMessage(dispatcher);
+        dispatcher->status = ME_STATUS_TODESTROY;
+    }
+    // The worker lives in the dispatcher, which may be freed by the reference released here
+    HDF_LOGW("Dispatcher worker %u shutdown!", worker->index);
     if (dispatcher->Disref != NULL) {
         dispatcher->Disref(dispatcher);
         dispatcher = NULL;
     }
+    return ME_SUCCESS;
+}
+
+static ErrorCode StartDispatcherWorker(DispatcherWorker *worker)
+{
+    HDF_STATUS status;
+    struct OsalThreadParam config;
+    MessageDispatcher *dispatcher = worker->dispatcher;
+    if (dispatcher->messageQueue[worker->index] == NULL) {
+        HDF_LOGE("%s:message queue is NULL!", __func__);
+        return ME_ERROR_NULL_PTR;
+    }
+    // The worker releases this reference when it leaves
+    if (dispatcher->Ref == NULL || dispatcher->Ref(dispatcher) == NULL) {
+        HDF_LOGE("%s:dispatcher is released!", __func__);
+        return ME_ERROR_WRONG_STATUS;
+    }
+    config.name = "MessageDispatcher";
+    config.priority = OSAL_THREAD_PRI_DEFAULT;
+    config.stackSize = 0x2000;
+    status = OsalThreadCreate(&worker->thread, RunDispatcher, worker);
+    if (status != HDF_SUCCESS) {
+        HDF_LOGE("%s:OsalThreadCreate failed!status=%d", __func__, status);
+        dispatcher->Disref(dispatcher);
+        return ME_ERROR_CREATE_THREAD_FAILED;
+    }
 
-    HDF_LOGW("Dispatcher shutdown!");
+    status = OsalThreadStart(&worker->thread, &config);
+    if (status != HDF_SUCCESS) {
+        HDF_LOGE("%s:OsalThreadStart failed!status=%d", __func__, status);
+        OsalThreadDestroy(&worker->thread);
+        dispatcher->Disref(dispatcher);
+        return ME_ERROR_CREATE_THREAD_FAILED;
+    }
     return ME_SUCCESS;
 }
 
+// Called with the dispatcher mutex held, so the status stays STARTTING until the workers are released
+static ErrorCode StartDispatcherWorkers(LocalMessageDispatcher *localDispatcher)
+{
+    ErrorCode errCode = ME_SUCCESS;
+    uint8_t started;
+    uint8_t i;
+    for (started = 0; started < localDispatcher->workerCount; started++) {
+        errCode = StartDispatcherWorker(&localDispatcher->workers[started]);
+        if (errCode != ME_SUCCESS) {
+            break;
+        }
+    }
+    for (i = 0; i < started; i++) {
+        (void)OsalSemWait(&localDispatcher->readySem, HDF_WAIT_FOREVER);
+    }
+
+    if (errCode == ME_SUCCESS) {
+        OsalAtomicSet(&localDispatcher->readyWorkers, started);
+        localDispatcher->status = ME_STATUS_RUNNING;
+    } else {
+        localDispatcher->status = ME_STATUS_STOPPED;
+    }
+    for (i = 0; i < started; i++) {
+        (void)OsalSemPost(&localDispatcher->startSem);
+    }
+    if (errCode != ME_SUCCESS) {
+        // Leave the dispatcher stopped only once the started workers are gone, so it can be started again
+        for (i = 0; i < started; i++) {
+            (void)OsalSemWait(&localDispatcher->readySem, HDF_WAIT_FOREVER);
+        }
+    }
+    return errCode;
+}
+
 static ErrorCode StartDispatcher(MessageDispatcher *dispatcher)
 {
     HDF_STATUS status;
     ErrorCode errCode;
-    LocalMessageDispatcher *localDispatcher = NULL;
-    struct OsalThreadParam config;
     if (dispatcher == NULL) {
         return ME_ERROR_NULL_PTR;
     }
@@ -298,26 +399,7 @@ static ErrorCode StartDispatcher(MessageDispatcher *dispatcher)
             break;
         }
         dispatcher->status = ME_STATUS_STARTTING;
-        config.name = "MessageDispatcher";
-        config.priority = OSAL_THREAD_PRI_DEFAULT;
-        config.stackSize = 0x2000;
-        localDispatcher = (LocalMessageDispatcher *)dispatcher;
-        status = OsalThreadCreate(&localDispatcher->dispatcherThread, RunDispatcher, localDispatcher);
-        if (status != HDF_SUCCESS) {
-            HDF_LOGE("%s:OsalThreadCreate failed!status=%d", __func__, status);
-            dispatcher->status = ME_STATUS_STOPPED;
-            errCode = ME_ERROR_CREATE_THREAD_FAILED;
-            break;
-        }
-
-        status = OsalThreadStart(&localDispatcher->dispatcherThread, &config);
-        if (status != HDF_SUCCESS) {
-            HDF_LOGE("%s:OsalThreadStart failed!status=%d", __func__, status);
-            dispatcher->status = ME_STATUS_STOPPED;
-            OsalThreadDestroy(&localDispatcher->dispatcherThread);
-            errCode = ME_ERROR_CREATE_THREAD_FAILED;
-            break;
-        }
+        errCode = StartDispatcherWorkers((LocalMessageDispatcher *)dispatcher);
     } while (false);
 
     status = OsalMutexUnlock(&dispatcher->mutex);
@@ -325,14 +407,7 @@ static ErrorCode StartDispatcher(MessageDispatcher *dispatcher)
         HDF_LOGE("%s:Destroy mutex failed!", __func__);
     }
 
-    if (errCode != ME_SUCCESS) {
-        return errCode;
-    }
-
-    do {
-        OsalMSleep(1);
-    } while (dispatcher->status == ME_STATUS_STARTTING);
-    return (dispatcher->status == ME_STATUS_RUNNING) ? ME_SUCCESS : ME_ERROR_WRONG_STATUS;
+    return errCode;
 }
 
 static void ShutdownDispatcher(MessageDispatcher *dispatcher)
@@ -364,16 +439,20 @@ static void ShutdownDispatcher(MessageDispatcher *dispatcher)
 IMPLEMENT_SHARED_OBJ(MessageDispatcher);
 static void DestroyLocalDispatcher(MessageDispatcher *dispatcher)
 {
+    LocalMessageDispatcher *localDispatcher = NULL;
     int32_t ret;
+    uint8_t i;
     if (dispatcher == NULL) {
         return;
     }
 
     ReleaseAllMessage(dispatcher);
 
-    if (dispatcher->messageQueue != NULL) {
-        DestroyPriorityQueue(dispatcher->messageQueue);
-        dispatcher->messageQueue = NULL;
+    for (i = 0; i < MESSAGE_DISPATCHER_MAX_WORKER; i++) {
+        if (dispatcher->messageQueue[i] != NULL) {
+            DestroyPriorityQueue(dispatcher->messageQueue[i]);
+            dispatcher->messageQueue[i] = NULL;
+        }
     }
 
     ret = OsalMutexDestroy(&dispatcher->mutex);
@@ -381,6 +460,14 @@ static void DestroyLocalDispatcher(MessageDispatcher *dispatcher)
         HDF_LOGE("%s:Release mutex failed.ret=%d", __func__, ret);
     }
 
+    localDispatcher = (LocalMessageDispatcher *)dispatcher;
+    if (localDispatcher->readySem.realSemaphore != NULL) {
+        (void)OsalSemDestroy(&localDispatcher->readySem);
+    }
+    if (localDispatcher->startSem.realSemaphore != NULL) {
+        (void)OsalSemDestroy(&localDispatcher->startSem);
+    }
+
     DEINIT_SHARED_OBJ(MessageDispatcher, dispatcher);
 }
 
@@ -389,9 +476,14 @@ ErrorCode CreateLocalDispatcher(MessageDispatcher **dispatcher, const Dispatcher
     LocalMessageDispatcher *localDispatcher = NULL;
     int32_t ret;
     ErrorCode errCode;
+    uint8_t i;
     if (dispatcher == NULL || config == NULL) {
         return ME_ERROR_NULL_PTR;
     }
+    if (config->workerCount > MESSAGE_DISPATCHER_MAX_WORKER) {
+        HDF_LOGE("%s:workerCount exceed max value!workerCount=%u", __func__, config->workerCount);
+        return ME_ERROR_PARA_WRONG;
+    }
 
     localDispatcher = (LocalMessageDispatcher *)OsalMemCalloc(sizeof(LocalMessageDispatcher));
     if (localDispatcher == NULL) {
@@ -402,10 +494,20 @@ ErrorCode CreateLocalDispatcher(MessageDispatcher **dispatcher, const Dispatcher
         localDispatcher->AppendMessage = AppendToLocalDispatcher;
         localDispatcher->Shutdown = ShutdownDispatcher;
         localDispatcher->Start = StartDispatcher;
-
-        localDispatcher->messageQueue = CreatePriorityQueue(config->queueSize, config->priorityLevelCount);
-        if (localDispatcher->messageQueue == NULL) {
-            errCode = ME_ERROR_OPER_QUEUE_FAILED;
+        localDispatcher->workerCount = (config->workerCount == 0) ? 1 : config->workerCount;
+        OsalAtomicSet(&localDispatcher->readyWorkers, 0);
+
+        errCode = ME_SUCCESS;
+        for (i = 0; i < localDispatcher->workerCount; i++) {
+            localDispatcher->workers[i].dispatcher = (MessageDispatcher *)localDispatcher;
+            localDispatcher->workers[i].index = i;
+            localDispatcher->messageQueue[i] = CreatePriorityQueue(config->queueSize, config->priorityLevelCount);
+            if (localDispatcher->messageQueue[i] == NULL) {
+                errCode = ME_ERROR_OPER_QUEUE_FAILED;
+                break;
+            }
+        }
+        if (errCode != ME_SUCCESS) {
             break;
         }
 
@@ -415,6 +517,17 @@ ErrorCode CreateLocalDispatcher(MessageDispatcher **dispatcher, const Dispatcher
             break;
         }
 
+        ret = OsalSemInit(&localDispatcher->readySem, 0);
+        if (ret != HDF_SUCCESS) {
+            errCode = ME_ERROR_OPER_SMSEMIPHORE_FAILED;
+            break;
+        }
+        ret = OsalSemInit(&localDispatcher->startSem, 0);
+        if (ret != HDF_SUCCESS) {
+            errCode = ME_ERROR_OPER_SMSEMIPHORE_FAILED;
+            break;
+        }
+
         errCode = INIT_SHARED_OBJ(MessageDispatcher, (MessageDispatcher *)localDispatcher, DestroyLocalDispatcher);
         if (errCode != ME_SUCCESS) {
             break;
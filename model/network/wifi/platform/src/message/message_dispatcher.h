@@ -27,7 +27,8 @@ struct MessageDispatcher;
     ErrorCode (*AppendMessage)(struct MessageDispatcher *, const uint8_t priority, MessageContext * context); \
     ErrorCode (*Start)(struct MessageDispatcher * dispatcher);                        \
     void (*Shutdown)(struct MessageDispatcher * dispatcher);                          \
-    PriorityQueue *messageQueue
+    uint8_t workerCount;                                                              \
+    PriorityQueue *messageQueue[MESSAGE_DISPATCHER_MAX_WORKER]
 
 typedef struct MessageDispatcher {
     INHERT_MESSAGE_DISPATCHER;
@@ -13,7 +13,9 @@
 #include <unistd.h>
 #endif
 #include "utils/hdf_log.h"
+#include "osal/osal_atomic.h"
 #include "osal/osal_mutex.h"
+#include "osal/osal_sem.h"
 #include "securec.h"
 #include "message_router_inner.h"
 #include "message_dispatcher.h"
@@ -35,10 +37,18 @@
 IMPLEMENT_SHARED_OBJ(MessageNode);
 IMPLEMENT_SHARED_OBJ(RemoteService);
 
+/*
+ * The index is changed under g_routerMutex but looked up without it: a lookup announces itself in
+ * @readers before it loads @remoteService, and a service taken out of the index is released only once
+ * no lookup of its slot is left. The value returning OSAL atomics are full barriers, so only those are
+ * used on @readers. The last lookup to leave a @draining slot wakes the taker up through g_serviceDrainSem.
+ */
 typedef struct {
     uint8_t nodeIndex;
     DispatcherId dispatcherId;
+    bool draining;
     RemoteService *remoteService;
+    OsalAtomic readers;
 } ServiceInfo;
 
 #define MAX_NODE_COUNT 2
@@ -49,12 +59,25 @@ OSAL_DECLARE_MUTEX(g_routerMutex) = {
 
 static ServiceInfo g_servicesIndex[MESSAGE_ENGINE_MAX_SERVICE] = {0};
 
+static OSAL_DECLARE_SEMAPHORE(g_serviceDrainSem) = {
+    .realSemaphore = NULL
+};
+
 static MessageNode *g_messageNodes[MAX_NODE_COUNT] = { 0, 0};
 
 MessageDispatcher *g_dispatchers[MESSAGE_ENGINE_MAX_DISPATCHER] = {0};
 
 static uint8_t g_routerStatus = ME_STATUS_STOPPED;
 
+static OsalAtomic g_serviceFence = { 0 };
+
+/* A full barrier from the value returning OSAL atomics, the counter is back to 0 afterwards. */
+static void ServiceIndexFence(void)
+{
+    (void)OsalAtomicIncReturn(&g_serviceFence);
+    (void)OsalAtomicDecReturn(&g_serviceFence);
+}
+
 static void ReleaseRemoteService(RemoteService *service)
 {
     if (service == NULL) {
@@ -255,13 +278,37 @@ static ErrorCode DoRegistService(const NodeId nodeId, const DispatcherId dispatc
         return ME_ERROR_SERVICEID_CONFLICT;
     }
 
-    g_servicesIndex[remoteService->serviceId].remoteService = remoteService;
     g_servicesIndex[remoteService->serviceId].nodeIndex = nodeId;
     g_servicesIndex[remoteService->serviceId].dispatcherId = dispatcherId;
+    // Lookups load the service without g_routerMutex, so it and the slot are written before it is published
+    ServiceIndexFence();
+    g_servicesIndex[remoteService->serviceId].remoteService = remoteService;
 
     return ME_SUCCESS;
 }
 
+// Takes the service out of the index, the caller holds g_routerMutex and releases the service returned
+static RemoteService *TakeServiceIndex(ServiceId serviceId)
+{
+    ServiceInfo *info = &g_servicesIndex[serviceId];
+    RemoteService *service = info->remoteService;
+
+    info->remoteService = NULL;
+    info->nodeIndex = NO_SUCH_NODE_INDEX;
+    info->dispatcherId = BAD_DISPATCHER_ID;
+    info->draining = true;
+    // Counting the taker in orders the store above before it; lookups counted later find the slot empty
+    if (OsalAtomicIncReturn(&info->readers) != 1) {
+        // A post may be left over from an earlier take, so check again after every wake up
+        while (OsalAtomicRead(&info->readers) != 1) {
+            (void)OsalSemWait(&g_serviceDrainSem, HDF_WAIT_FOREVER);
+        }
+    }
+    info->draining = false;
+    (void)OsalAtomicDecReturn(&info->readers);
+    return service;
+}
+
 static ErrorCode RegistServiceInner(const NodeId nodeId, const DispatcherId dispatcherId, struct ServiceDef *mapper)
 {
     MessageNode *node = NULL;
@@ -385,11 +432,8 @@ static ErrorCode UnregistServiceInner(const NodeId nodeId, const DispatcherId di
             errCode = ME_ERROR_NO_SUCH_SERVICE;
             break;
         }
-        service = g_servicesIndex[serviceId].remoteService;
+        service = TakeServiceIndex(serviceId);
         ReleaseRemoteService(service);
-        g_servicesIndex[serviceId].remoteService = NULL;
-        g_servicesIndex[serviceId].nodeIndex = NO_SUCH_NODE_INDEX;
-        g_servicesIndex[serviceId].dispatcherId = BAD_DISPATCHER_ID;
         NotifyAllNodesServiceDel(nodeId, serviceId);
     } while (false);
     status = OsalMutexUnlock(&g_routerMutex);
@@ -437,7 +481,7 @@ static bool CheckServiceID(ServiceId serviceId, bool allowSync)
 
 RemoteService *RefRemoteService(ServiceId serviceId)
 {
-    HDF_STATUS status;
+    ServiceInfo *info = NULL;
     RemoteService *remoteService = NULL;
     RemoteService *service = NULL;
     if (serviceId >= MESSAGE_ENGINE_MAX_SERVICE) {
@@ -447,22 +491,15 @@ RemoteService *RefRemoteService(ServiceId serviceId)
     if (!CheckServiceID(serviceId, true)) {
         return NULL;
     }
-    status = OsalMutexTimedLock(&g_routerMutex, HDF_WAIT_FOREVER);
-    if (status != HDF_SUCCESS) {
-        HDF_LOGE("Unable to get lock!status=%d", status);
-        return NULL;
+    info = &g_servicesIndex[serviceId];
+    (void)OsalAtomicIncReturn(&info->readers);
+    remoteService = info->remoteService;
+    if (remoteService != NULL && remoteService->Ref != NULL) {
+        service = remoteService->Ref(remoteService);
     }
-
-    do {
-        remoteService = g_servicesIndex[serviceId].remoteService;
-        if (remoteService != NULL && remoteService->Ref != NULL) {
-            service = remoteService->Ref(remoteService);
-        }
-    } while (false);
-
-    status = OsalMutexUnlock(&g_routerMutex);
-    if (status != HDF_SUCCESS) {
-        HDF_LOGE("Unable to get lock!status=%d", status);
+    // Only the taker is left
+    if (OsalAtomicDecReturn(&info->readers) == 1 && info->draining) {
+        (void)OsalSemPost(&g_serviceDrainSem);
     }
     return service;
 }
@@ -563,6 +600,8 @@ static ErrorCode DoStartMessageRouter(uint8_t nodesConfig)
         g_servicesIndex[i].remoteService = NULL;
         g_servicesIndex[i].nodeIndex = NO_SUCH_NODE_INDEX;
         g_servicesIndex[i].dispatcherId = BAD_DISPATCHER_ID;
+        g_servicesIndex[i].draining = false;
+        OsalAtomicSet(&g_servicesIndex[i].readers, 0);
     }
     do {
         HDF_LOGE("%s:Create local node ...", __func__);
@@ -619,6 +658,13 @@ ErrorCode StartMessageRouter(uint8_t nodesConfig)
             return ME_ERROR_OPER_MUTEX_FAILED;
         }
     }
+    if (g_serviceDrainSem.realSemaphore == NULL) {
+        status = OsalSemInit(&g_serviceDrainSem, 0);
+        if (status != HDF_SUCCESS) {
+            HDF_LOGE("Init router semaphore failed!status=%d", status);
+            return ME_ERROR_OPER_SMSEMIPHORE_FAILED;
+        }
+    }
     status = OsalMutexTimedLock(&g_routerMutex, HDF_WAIT_FOREVER);
     if (status != HDF_SUCCESS) {
         HDF_LOGE("Unable to get lock!status=%d", status);
@@ -645,10 +691,7 @@ static ErrorCode DoShutdownMessageRouter(void)
         if (g_servicesIndex[i].remoteService == NULL) {
             continue;
         }
-        service = g_servicesIndex[i].remoteService;
-        g_servicesIndex[i].remoteService = NULL;
-        g_servicesIndex[i].nodeIndex = NO_SUCH_NODE_INDEX;
-        g_servicesIndex[i].dispatcherId = BAD_DISPATCHER_ID;
+        service = TakeServiceIndex(i);
 
         ReleaseRemoteService(service);
     }
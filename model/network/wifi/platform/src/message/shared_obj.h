@@ -44,8 +44,7 @@
         if (obj == NULL) {                                                                      \
             return;                                                                             \
         }                                                                                       \
-        OsalAtomicDec(&obj->refCount);                                                           \
-        if (OsalAtomicRead(&obj->refCount) <= 0) {                                               \
+        if (OsalAtomicDecReturn(&obj->refCount) <= 0) {                                          \
             obj->status = ME_STATUS_TODESTROY;                                                  \
             if (obj->Destroy != NULL) {                                                         \
                 obj->Destroy(obj);                                                              \
@@ -16,23 +16,38 @@
 #include "net_device_adapter.h"
 
 #define HDF_LOG_TAG "WiFiFlowControl"
-#define ETHER_TYPE_PROCESS_COUNT 8
+#define ETHER_TYPE_HASH_SIZE 32
+/* folds both bytes of the type, the types in g_etherTypeProMap land in distinct slots */
+#define ETHER_TYPE_HASH(type) ((((type) >> 8) ^ (type)) & (ETHER_TYPE_HASH_SIZE - 1))
+#define IP_FRAG_OFFSET_MASK 0x1FFF
+#define IP_HDR_LEN_MASK 0x0F
+#define TCP_HDR_LEN_SHIFT 4
 #define TOS_TO_ID_COUNT 6
 #define PROTOCOL_STANDARD_SHIFT_COUNT 2
+#define FC_QUANTUM_UNIT 1514     /* one full sized Ether frame */
+#define FC_CODEL_TARGET 5000     /* 5ms */
+#define FC_CODEL_INTERVAL 100000 /* 100ms */
 static FlowControlQueueID g_tosToIdHash[TOS_TO_ID_COUNT] = {
     BE_QUEUE_ID, BK_QUEUE_ID, BK_QUEUE_ID, BE_QUEUE_ID, VI_QUEUE_ID, VI_QUEUE_ID
 };
 
+/* round robin weights of the queues in frames, control and VIP frames go first */
+static uint8_t g_defaultQuantum[QUEUE_ID_COUNT] = {
+    [CTRL_QUEUE_ID] = 0, [VIP_QUEUE_ID] = 0, [NORMAL_QUEUE_ID] = 1, [TCP_DATA_QUEUE_ID] = 2,
+    [TCP_ACK_QUEUE_ID] = 1, [BK_QUEUE_ID] = 1, [BE_QUEUE_ID] = 2, [VI_QUEUE_ID] = 3, [VO_QUEUE_ID] = 4
+};
+
 static FlowControlQueueID IpProcessFunc(const void *buff, uint32_t len);
-static struct EtherProcessMap g_etherTypeProMap[ETHER_TYPE_PROCESS_COUNT] = {
-    {ETHER_TYPE_IP, IpProcessFunc},
-    {ETHER_TYPE_IPV6, NULL},
-    {ETHER_TYPE_PAE, NULL},
-    {ETHER_TYPE_TDLS, NULL},
-    {ETHER_TYPE_PPP_DISC, NULL},
-    {ETHER_TYPE_PPP_SES, NULL},
-    {ETHER_TYPE_WAI, NULL},
-    {ETHER_TYPE_VLAN, NULL},
+/* indexed by ETHER_TYPE_HASH, the types without a process function are VIP frames */
+static const struct EtherProcessMap g_etherTypeProMap[ETHER_TYPE_HASH_SIZE] = {
+    [ETHER_TYPE_HASH(ETHER_TYPE_IP)] = {ETHER_TYPE_IP, IpProcessFunc},
+    [ETHER_TYPE_HASH(ETHER_TYPE_IPV6)] = {ETHER_TYPE_IPV6, NULL},
+    [ETHER_TYPE_HASH(ETHER_TYPE_PAE)] = {ETHER_TYPE_PAE, NULL},
+    [ETHER_TYPE_HASH(ETHER_TYPE_TDLS)] = {ETHER_TYPE_TDLS, NULL},
+    [ETHER_TYPE_HASH(ETHER_TYPE_PPP_DISC)] = {ETHER_TYPE_PPP_DISC, NULL},
+    [ETHER_TYPE_HASH(ETHER_TYPE_PPP_SES)] = {ETHER_TYPE_PPP_SES, NULL},
+    [ETHER_TYPE_HASH(ETHER_TYPE_WAI)] = {ETHER_TYPE_WAI, NULL},
+    [ETHER_TYPE_HASH(ETHER_TYPE_VLAN)] = {ETHER_TYPE_VLAN, NULL},
 };
 
 static FlowControlQueueID TosToFcQueueId(uint8_t priority)
@@ -43,59 +58,20 @@ static FlowControlQueueID TosToFcQueueId(uint8_t priority)
     return g_tosToIdHash[priority];
 }
 
-static bool IsDhcpPort(struct UdpHeader *udpHdr, uint32_t len)
-{
-    if (udpHdr == NULL) {
-        HDF_LOGE("%s udpHdr:  = null!", __func__);
-        return false;
-    }
-    if (len < sizeof(struct UdpHeader)) {
-        HDF_LOGE("%s len not right!", __func__);
-        return false;
-    }
-    if ((ntohs(udpHdr->dest) == DHCP_UDP_SRC_PORT) || (ntohs(udpHdr->dest) == DHCP_UDP_DES_PORT)) {
-        return true;
-    }
-    return false;
-}
-
-/* TcpKeyFrame:ACK/SYN */
-static bool IsTcpKeyFrame(struct IpHeader *ipHeader, uint32_t len)
-{
-    struct TcpHeader *tcpHdr = NULL;
-    uint32_t ipPktLen;
-    uint32_t tcpHdrLen;
-    uint8_t ipHdrLen;
-    uint8_t *ip = NULL;
-    if (ipHeader == NULL) {
-        HDF_LOGE("IsTcpAck Fail ipHeader = null");
-        return false;
-    }
-    if (len < sizeof(struct IpHeader)) {
-        HDF_LOGE("%s len not right!", __func__);
-        return false;
-    }
-    if ((len - sizeof(struct IpHeader)) < sizeof(struct TcpHeader)) {
-        HDF_LOGE("%s tcp hdr len not right!", __func__);
-        return false;
-    }
-
-    tcpHdr = (struct TcpHeader *)(ipHeader + 1);
-    ip = (uint8_t *)(ipHeader);
-    ipPktLen = ntohs(ipHeader->totLen);
-    ipHdrLen = ((*ip) & 0x0F) << PROTOCOL_STANDARD_SHIFT_COUNT;
-    tcpHdrLen = (tcpHdr->offset & 0xF0) << PROTOCOL_STANDARD_SHIFT_COUNT;
-    if (tcpHdrLen + ipHdrLen == ipPktLen) {
-        return true;
-    }
-    return false;
-}
-
+/*
+ * Classifies an IPv4 packet in one pass over its headers:
+ * UDP goes by TOS priority unless it is unfragmented DHCP, which is VIP,
+ * TCP segments carrying no payload (ACK/SYN) are key frames.
+ * The transport header follows the IP options, if any.
+ */
 static FlowControlQueueID IpProcessFunc(const void *buff, uint32_t len)
 {
-    struct IpHeader *ipHeader = NULL;
-    struct UdpHeader *udpHdr = NULL;
-    FlowControlQueueID id = NORMAL_QUEUE_ID;
+    const struct IpHeader *ipHeader = (const struct IpHeader *)buff;
+    const struct UdpHeader *udpHdr = NULL;
+    const struct TcpHeader *tcpHdr = NULL;
+    uint32_t ipHdrLen;
+    uint32_t tcpHdrLen;
+    uint16_t port;
     if (buff == NULL) {
         HDF_LOGE("%s fail: buff = null!", __func__);
         return QUEUE_ID_COUNT;
@@ -104,34 +80,36 @@ static FlowControlQueueID IpProcessFunc(const void *buff, uint32_t len)
         HDF_LOGE("%s fail: IpHeader len not right!", __func__);
         return QUEUE_ID_COUNT;
     }
-    ipHeader = (struct IpHeader *)buff;
-    if (ipHeader->protocol == UDP_PROTOCOL) {
-        /* from IP TOS find priority */
-        /*
-         * ----------------------------------------------------------------------
-         *     tos define
-         *  ----------------------------------------------------------------------
-         * | bit7~bit5 | bit4  |  bit3      |  bit2       |   bit1            | bit0    |
-         * | priority  | Delay | Throughput | reliability | Transmission cost | reserve |
-         *  ----------------------------------------------------------------------
-         */
-        id = TosToFcQueueId(ipHeader->tos >> IP_PRI_SHIFT);
-        if ((len - sizeof(struct IpHeader)) < sizeof(struct UdpHeader)) {
-            HDF_LOGE("%s fail: UdpHeader len not right!", __func__);
-            return QUEUE_ID_COUNT;
-        }
-        udpHdr = (struct UdpHeader *)(ipHeader + 1);
-        if (((ntohs(ipHeader->fragInfo) & 0x1FFF) == 0) && IsDhcpPort(udpHdr, len - sizeof(struct IpHeader))) {
-            id = VIP_QUEUE_ID;
-        }
-    } else if (ipHeader->protocol == TCP_PROTOCOL) {
-        if (IsTcpKeyFrame(ipHeader, len)) {
-            id = TCP_ACK_QUEUE_ID;
-        } else {
-            id = TCP_DATA_QUEUE_ID;
-        }
+    ipHdrLen = (uint32_t)(ipHeader->versionAndHl & IP_HDR_LEN_MASK) << PROTOCOL_STANDARD_SHIFT_COUNT;
+    if (ipHdrLen < sizeof(struct IpHeader) || ipHdrLen > len) {
+        HDF_LOGE("%s fail: IpHeader len not right!", __func__);
+        return QUEUE_ID_COUNT;
+    }
+    switch (ipHeader->protocol) {
+        case UDP_PROTOCOL:
+            if (len - ipHdrLen < sizeof(struct UdpHeader)) {
+                HDF_LOGE("%s fail: UdpHeader len not right!", __func__);
+                return QUEUE_ID_COUNT;
+            }
+            udpHdr = (const struct UdpHeader *)((const uint8_t *)ipHeader + ipHdrLen);
+            port = ntohs(udpHdr->dest);
+            if ((ntohs(ipHeader->fragInfo) & IP_FRAG_OFFSET_MASK) == 0 &&
+                (port == DHCP_UDP_SRC_PORT || port == DHCP_UDP_DES_PORT)) {
+                return VIP_QUEUE_ID;
+            }
+            /* bit7~bit5 of TOS is the priority */
+            return TosToFcQueueId(ipHeader->tos >> IP_PRI_SHIFT);
+        case TCP_PROTOCOL:
+            if (len - ipHdrLen < sizeof(struct TcpHeader)) {
+                HDF_LOGE("%s tcp hdr len not right!", __func__);
+                return TCP_DATA_QUEUE_ID;
+            }
+            tcpHdr = (const struct TcpHeader *)((const uint8_t *)ipHeader + ipHdrLen);
+            tcpHdrLen = (uint32_t)(tcpHdr->offset >> TCP_HDR_LEN_SHIFT) << PROTOCOL_STANDARD_SHIFT_COUNT;
+            return (ipHdrLen + tcpHdrLen == ntohs(ipHeader->totLen)) ? TCP_ACK_QUEUE_ID : TCP_DATA_QUEUE_ID;
+        default:
+            return NORMAL_QUEUE_ID;
     }
-    return id;
 }
 
 static void FlowControlQueueInit(struct FlowControlModule *fcm)
@@ -145,6 +123,10 @@ static void FlowControlQueueInit(struct FlowControlModule *fcm)
         for (j = 0; j < QUEUE_ID_COUNT; j++) {
             NetBufQueueInit(&fcm->fcmQueue[i].queues[j].dataQueue);
             OsalSpinInit(&fcm->fcmQueue[i].queues[j].lock);
+            fcm->fcmQueue[i].queues[j].queueID = (FlowControlQueueID)j;
+            fcm->fcmQueue[i].queues[j].param.quantum = g_defaultQuantum[j] * FC_QUANTUM_UNIT;
+            fcm->fcmQueue[i].queues[j].param.codelTarget = FC_CODEL_TARGET;
+            fcm->fcmQueue[i].queues[j].param.codelInterval = FC_CODEL_INTERVAL;
         }
     }
 }
@@ -222,6 +204,7 @@ static void FcmQueuePreProcess(struct FlowControlQueue *fcmQueue)
         oldBuff = NetBufQueueDequeue(dataQ);
         if (oldBuff != NULL) {
             NetBufFree(oldBuff);
+            fcmQueue->stat.dropped++;
         }
     }
     return;
@@ -240,6 +223,10 @@ static int32_t SendBuffToFCM(struct FlowControlModule *fcm, NetBuf *buff, uint32
         return HDF_ERR_INVALID_PARAM;
     }
 
+    if (fcm->scheduler[dir] != NULL) {
+        return fcm->scheduler[dir]->enqueue(fcm, buff, (FlowControlQueueID)id, (FlowDir)dir);
+    }
+
     fcmQueue = &fcm->fcmQueue[dir].queues[id];
     dataQ = &fcmQueue->dataQueue;
     FcmQueuePreProcess(fcmQueue);
@@ -248,14 +235,15 @@ static int32_t SendBuffToFCM(struct FlowControlModule *fcm, NetBuf *buff, uint32
     }
     NetBufQueueEnqueue(dataQ, buff);
     fcm->fcmQueue[dir].queues[id].pktCount++;
+    fcmQueue->stat.enqueued++;
     return HDF_SUCCESS;
 }
 
 static FlowControlQueueID GetQueueIdByEtherBuff(const NetBuf *buff)
 {
     uint32_t len;
-    struct EtherHeader *header = NULL;
-    int i;
+    const struct EtherHeader *header = NULL;
+    const struct EtherProcessMap *entry = NULL;
     uint16_t etherType = 0;
     if (buff == NULL) {
         HDF_LOGE("%s fail : buff = null!", __func__);
@@ -266,44 +254,129 @@ static FlowControlQueueID GetQueueIdByEtherBuff(const NetBuf *buff)
         HDF_LOGE("%s fail : buff->data_len not right!", __func__);
         return QUEUE_ID_COUNT;
     }
-    header = (struct EtherHeader *)NetBufGetAddress(buff, E_DATA_BUF);
+    header = (const struct EtherHeader *)NetBufGetAddress(buff, E_DATA_BUF);
     etherType = ntohs(header->etherType);
 
-    /* if processFun = null  return VIP_QUEUE_ID */
-    for (i = 0; i < ETHER_TYPE_PROCESS_COUNT; i++) {
-        if (g_etherTypeProMap[i].etherType == etherType) {
-            if (g_etherTypeProMap[i].processFun != NULL) {
-                return g_etherTypeProMap[i].processFun((void *)(header + 1), len - sizeof(struct EtherHeader));
-            }
-            return VIP_QUEUE_ID;
+    entry = &g_etherTypeProMap[ETHER_TYPE_HASH(etherType)];
+    if (etherType == 0 || entry->etherType != etherType) {
+        return NORMAL_QUEUE_ID;
+    }
+    if (entry->processFun != NULL) {
+        return entry->processFun((const void *)(header + 1), len - sizeof(struct EtherHeader));
+    }
+    return VIP_QUEUE_ID;
+}
+
+static uint32_t SendQueueToFCM(struct FlowControlModule *fcm, NetBufQueue *q, uint32_t dir)
+{
+    NetBuf *buff = NULL;
+    uint32_t count = 0;
+    if (fcm == NULL || q == NULL || dir >= FLOW_DIR_COUNT) {
+        HDF_LOGE("%s fail : fcm = null or q = null or dir not right!", __func__);
+        return 0;
+    }
+    while ((buff = NetBufQueueDequeue(q)) != NULL) {
+        if (SendBuffToFCM(fcm, buff, GetQueueIdByEtherBuff(buff), dir) != HDF_SUCCESS) {
+            NetBufFree(buff);
+            continue;
         }
+        count++;
+    }
+    return count;
+}
+
+static int32_t SetScheduler(struct FlowControlModule *fcm, const struct FlowControlScheduler *scheduler,
+    uint32_t dir)
+{
+    if (fcm == NULL || dir >= FLOW_DIR_COUNT) {
+        HDF_LOGE("%s fail : fcm = null or dir not right!", __func__);
+        return HDF_ERR_INVALID_PARAM;
+    }
+    if (scheduler != NULL && (scheduler->enqueue == NULL || scheduler->schedule == NULL)) {
+        HDF_LOGE("%s fail : scheduler incomplete!", __func__);
+        return HDF_ERR_INVALID_PARAM;
+    }
+    if (fcm->scheduler[dir] == scheduler) {
+        return HDF_SUCCESS;
+    }
+    if (fcm->scheduler[dir] != NULL && fcm->scheduler[dir]->deinit != NULL) {
+        fcm->scheduler[dir]->deinit(fcm, (FlowDir)dir);
+    }
+    fcm->scheduler[dir] = NULL;
+    if (scheduler != NULL && scheduler->init != NULL && scheduler->init(fcm, (FlowDir)dir) != HDF_SUCCESS) {
+        HDF_LOGE("%s fail : scheduler init fail, dir=%u!", __func__, dir);
+        return HDF_FAILURE;
+    }
+    fcm->scheduler[dir] = scheduler;
+    return HDF_SUCCESS;
+}
+
+static int32_t SetQueueSchedParam(struct FlowControlModule *fcm, const struct FlowControlSchedParam *param,
+    uint32_t id, uint32_t dir)
+{
+    struct FlowControlQueue *fcmQueue = NULL;
+    uint32_t flags = 0;
+
+    if (param == NULL || !IsValidSentToFCMPra(fcm, id, dir)) {
+        HDF_LOGE("%s fail : param = null or IsValidSentToFCMPra FALSE!", __func__);
+        return HDF_ERR_INVALID_PARAM;
     }
-    return NORMAL_QUEUE_ID;
+    fcmQueue = &fcm->fcmQueue[dir].queues[id];
+    /* the scheduler reads the quantum and the CoDel parameters under the queue lock */
+    OsalSpinLockIrqSave(&fcmQueue->lock, &flags);
+    fcmQueue->param = *param;
+    OsalSpinUnlockIrqRestore(&fcmQueue->lock, &flags);
+    return HDF_SUCCESS;
+}
+
+static int32_t GetQueueStat(struct FlowControlModule *fcm, struct FlowControlQueueStat *stat, uint32_t id,
+    uint32_t dir)
+{
+    if (stat == NULL || !IsValidSentToFCMPra(fcm, id, dir)) {
+        HDF_LOGE("%s fail : stat = null or IsValidSentToFCMPra FALSE!", __func__);
+        return HDF_ERR_INVALID_PARAM;
+    }
+    *stat = fcm->fcmQueue[dir].queues[id].stat;
+    return HDF_SUCCESS;
 }
 
 static struct FlowControlInterface g_fcInterface = {
     .setQueueThreshold = SetQueueThreshold,
     .getQueueIdByEtherBuff = GetQueueIdByEtherBuff,
     .sendBuffToFCM = SendBuffToFCM,
+    .sendQueueToFCM = SendQueueToFCM,
     .schedFCM = SchedTransfer,
     .registerFlowControlOp = RegisterFlowControlOp,
+    .setScheduler = SetScheduler,
+    .setQueueSchedParam = SetQueueSchedParam,
+    .getQueueStat = GetQueueStat,
 };
 
 static struct FlowControlModule *g_fcm = NULL;
 
 int32_t SendFlowControlQueue(struct FlowControlModule *fcm, uint32_t id, uint32_t dir)
 {
-    NetBufQueue *q = NULL;
-    int32_t fwPriorityId = 0;
-    int32_t rxPriorityId = 0;
+    struct FlowControlQueue *fcmQueue = NULL;
+    uint32_t count;
+    int32_t ret;
     if (!IsValidSentToFCMPra(fcm, id, dir)) {
         HDF_LOGE("%s fail : IsValidSentToFCMPra FALSE!", __func__);
         return HDF_ERR_INVALID_PARAM;
     }
-    q = &fcm->fcmQueue[dir].queues[id].dataQueue;
-    if (NetBufQueueIsEmpty(q)) {
+    fcmQueue = &fcm->fcmQueue[dir].queues[id];
+    count = NetBufQueueSize(&fcmQueue->dataQueue);
+    if (count == 0) {
         return HDF_SUCCESS;
     }
+    ret = FlowControlDeliverQueue(fcm, &fcmQueue->dataQueue, id, dir);
+    fcmQueue->stat.sent += count - NetBufQueueSize(&fcmQueue->dataQueue);
+    return ret;
+}
+
+int32_t FlowControlDeliverQueue(struct FlowControlModule *fcm, NetBufQueue *q, uint32_t id, uint32_t dir)
+{
+    int32_t fwPriorityId = 0;
+    int32_t rxPriorityId = 0;
     if (dir == FLOW_TX) {
         if (fcm->op != NULL && fcm->op->getTxPriorityId != NULL) {
             fwPriorityId = fcm->op->getTxPriorityId(id);
@@ -387,6 +460,9 @@ void DeInitFlowControl(struct FlowControlModule *fcm)
 
     /* 1:Destroy task. 2:Destroy osalwait. 3:free NetBuff. */
     DestroyFlowControlTask(fcm);
+    for (i = 0; i < FLOW_DIR_COUNT; i++) {
+        (void)SetScheduler(fcm, NULL, i);
+    }
     for (i = 0; i < FLOW_DIR_COUNT; i++) {
         OsalSemDestroy(&fcm->sem[i]);
     }
@@ -0,0 +1,396 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ *
+ * HDF is dual licensed: you can use it either under the terms of
+ * the GPL, or the BSD license, at your option.
+ * See the LICENSE file in the root of this repository for complete details.
+ */
+
+#include "flow_control.h"
+#include "flow_control_task.h"
+#include "hdf_log.h"
+#include "osal_mem.h"
+#include "osal_time.h"
+
+#define HDF_LOG_TAG "WiFiFlowControl"
+
+#define FC_DRR_QUEUE_LIMIT 256 /* packets a queue holds before it drops at the tail */
+#define FC_DRR_BATCH_MAX 32    /* packets handed to the driver per call */
+#define FC_DRR_MAX_ROUNDS 16   /* rounds per wakeup, the thread goes on without waiting if packets are left */
+#define FC_DRR_BUSY_WAIT_MS 1  /* longest wait for a busy driver, which resumes the thread by schedFCM */
+#define FC_CODEL_MTU 1514
+#define FC_CODEL_REENTER_INTERVALS 16
+#define FC_SOJOURN_AVG_SHIFT 3 /* moving average over 8 packets */
+#define FC_USEC_PER_SEC 1000000
+
+/* CoDel state of a queue, as in RFC 8289 */
+struct FcCodel {
+    bool dropping;
+    bool aboveTarget;
+    uint32_t firstAboveTime;
+    uint32_t dropNext;
+    uint32_t count;
+    uint32_t lastCount;
+};
+
+/*
+ * Enqueue times sit in a ring beside the packets of the queue, both change only under the queue lock so the
+ * head of the ring always belongs to the head packet.
+ */
+struct FcDrrQueue {
+    uint32_t enqueueTime[FC_DRR_QUEUE_LIMIT];
+    uint32_t head;
+    uint32_t count;
+    uint32_t backlog;
+    uint32_t deficit;
+    struct FcCodel codel;
+};
+
+struct FcDrrState {
+    struct FcDrrQueue queues[QUEUE_ID_COUNT];
+};
+
+static uint32_t FcNowUs(void)
+{
+    OsalTimespec now = {0, 0};
+    (void)OsalGetTime(&now);
+    return (uint32_t)(now.sec * FC_USEC_PER_SEC + now.usec);
+}
+
+static bool FcTimeAfterEq(uint32_t a, uint32_t b)
+{
+    return (int32_t)(a - b) >= 0;
+}
+
+static uint32_t FcIntSqrt(uint32_t value)
+{
+    uint32_t root = 0;
+    uint32_t bit = 1u << 30; /* highest power of four in 32 bits */
+
+    while (bit > value) {
+        bit >>= 2;
+    }
+    while (bit != 0) {
+        if (value >= root + bit) {
+            value -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return root;
+}
+
+static uint32_t FcCodelControlLaw(uint32_t t, uint32_t interval, uint32_t count)
+{
+    return t + interval / FcIntSqrt(count);
+}
+
+/* Decides whether the head packet, queued for @sojourn microseconds, is dropped. */
+static bool FcCodelShouldDrop(const struct FlowControlSchedParam *param, struct FcDrrQueue *q, uint32_t sojourn,
+    uint32_t now)
+{
+    struct FcCodel *codel = &q->codel;
+    bool okToDrop = false;
+    uint32_t delta;
+
+    if (sojourn < param->codelTarget || q->backlog <= FC_CODEL_MTU) {
+        codel->aboveTarget = false;
+    } else if (!codel->aboveTarget) {
+        codel->aboveTarget = true;
+        codel->firstAboveTime = now + param->codelInterval;
+    } else {
+        okToDrop = FcTimeAfterEq(now, codel->firstAboveTime);
+    }
+
+    if (codel->dropping) {
+        if (!okToDrop) {
+            codel->dropping = false;
+            return false;
+        }
+        if (!FcTimeAfterEq(now, codel->dropNext)) {
+            return false;
+        }
+        codel->count++;
+        codel->dropNext = FcCodelControlLaw(codel->dropNext, param->codelInterval, codel->count);
+        return true;
+    }
+    if (!okToDrop) {
+        return false;
+    }
+    /* resume near the previous drop rate if dropping stopped only a short while ago */
+    codel->dropping = true;
+    delta = codel->count - codel->lastCount;
+    if (delta > 1 && !FcTimeAfterEq(now, codel->dropNext + FC_CODEL_REENTER_INTERVALS * param->codelInterval)) {
+        codel->count = delta;
+    } else {
+        codel->count = 1;
+    }
+    codel->dropNext = FcCodelControlLaw(now, param->codelInterval, codel->count);
+    codel->lastCount = codel->count;
+    return true;
+}
+
+static void FcDrrPushTail(struct FlowControlQueue *fcmQueue, struct FcDrrQueue *q, NetBuf *buff, uint32_t time)
+{
+    q->enqueueTime[(q->head + q->count) % FC_DRR_QUEUE_LIMIT] = time;
+    q->count++;
+    q->backlog += NetBufGetDataLen(buff);
+    NetBufQueueEnqueue(&fcmQueue->dataQueue, buff);
+}
+
+static void FcDrrPushHead(struct FlowControlQueue *fcmQueue, struct FcDrrQueue *q, NetBuf *buff, uint32_t time)
+{
+    q->head = (q->head + FC_DRR_QUEUE_LIMIT - 1) % FC_DRR_QUEUE_LIMIT;
+    q->enqueueTime[q->head] = time;
+    q->count++;
+    q->backlog += NetBufGetDataLen(buff);
+    NetBufQueueEnqueueHead(&fcmQueue->dataQueue, buff);
+}
+
+static NetBuf *FcDrrPopHead(struct FlowControlQueue *fcmQueue, struct FcDrrQueue *q, uint32_t *time)
+{
+    NetBuf *buff = NetBufQueueDequeue(&fcmQueue->dataQueue);
+    if (buff == NULL) {
+        return NULL;
+    }
+    *time = q->enqueueTime[q->head];
+    q->head = (q->head + 1) % FC_DRR_QUEUE_LIMIT;
+    q->count--;
+    q->backlog -= NetBufGetDataLen(buff);
+    return buff;
+}
+
+static void FcUpdateSojourn(struct FlowControlQueueStat *stat, uint32_t sojourn)
+{
+    int32_t diff = (int32_t)(sojourn - stat->sojournAvg);
+    stat->sojournAvg = (uint32_t)((int32_t)stat->sojournAvg + diff / (1 << FC_SOJOURN_AVG_SHIFT));
+    if (sojourn > stat->sojournMax) {
+        stat->sojournMax = sojourn;
+    }
+}
+
+static int32_t FcDrrEnqueue(struct FlowControlModule *fcm, NetBuf *buff, FlowControlQueueID id, FlowDir dir)
+{
+    struct FcDrrState *state = (struct FcDrrState *)fcm->schedPriv[dir];
+    struct FlowControlQueue *fcmQueue = &fcm->fcmQueue[dir].queues[id];
+    struct FcDrrQueue *q = &state->queues[id];
+    uint32_t flags = 0;
+    bool full = false;
+
+    OsalSpinLockIrqSave(&fcmQueue->lock, &flags);
+    full = (q->count == FC_DRR_QUEUE_LIMIT);
+    if (full) {
+        fcmQueue->stat.dropped++;
+    } else {
+        FcDrrPushTail(fcmQueue, q, buff, FcNowUs());
+        fcmQueue->pktCount++;
+        fcmQueue->stat.enqueued++;
+    }
+    OsalSpinUnlockIrqRestore(&fcmQueue->lock, &flags);
+    if (full) {
+        NetBufFree(buff);
+    }
+    return HDF_SUCCESS;
+}
+
+/*
+ * Takes up to FC_DRR_BATCH_MAX packets that fit the deficit of the queue, a queue with quantum 0 has no limit.
+ * Packets CoDel drops are moved to @dropped. Returns false once the queue has nothing more to send this round.
+ */
+static bool FcDrrTakeBatch(struct FlowControlQueue *fcmQueue, struct FcDrrQueue *q, NetBufQueue *batch,
+    uint32_t *times, NetBufQueue *dropped)
+{
+    bool strict = (fcmQueue->param.quantum == 0);
+    uint32_t now = FcNowUs();
+    uint32_t taken = 0;
+    uint32_t time = 0;
+    uint32_t len;
+    NetBuf *buff = NULL;
+
+    while (q->count != 0 && taken < FC_DRR_BATCH_MAX) {
+        buff = NetBufQueueAtHead(&fcmQueue->dataQueue);
+        len = NetBufGetDataLen(buff);
+        if (FcCodelShouldDrop(&fcmQueue->param, q, now - q->enqueueTime[q->head], now)) {
+            NetBufQueueEnqueue(dropped, FcDrrPopHead(fcmQueue, q, &time));
+            fcmQueue->stat.dropped++;
+            continue;
+        }
+        if (!strict && len > q->deficit) {
+            return false;
+        }
+        buff = FcDrrPopHead(fcmQueue, q, &time);
+        FcUpdateSojourn(&fcmQueue->stat, now - time);
+        times[taken++] = time;
+        NetBufQueueEnqueue(batch, buff);
+        if (!strict) {
+            q->deficit -= len;
+        }
+    }
+    if (q->count == 0) {
+        q->deficit = 0;
+        return false;
+    }
+    return taken == FC_DRR_BATCH_MAX;
+}
+
+/* Serves one queue for a round, returns true if it still holds packets. @busy is set if the driver left some. */
+static bool FcDrrServeQueue(struct FlowControlModule *fcm, struct FcDrrState *state, FlowControlQueueID id,
+    FlowDir dir, bool *busy)
+{
+    struct FlowControlQueue *fcmQueue = &fcm->fcmQueue[dir].queues[id];
+    struct FcDrrQueue *q = &state->queues[id];
+    uint32_t times[FC_DRR_BATCH_MAX];
+    NetBufQueue batch;
+    NetBufQueue dropped;
+    NetBuf *buff = NULL;
+    uint32_t flags = 0;
+    uint32_t taken;
+    uint32_t left = 0;
+    uint32_t sent;
+    bool more = false;
+    bool backlogged = false;
+
+    NetBufQueueInit(&batch);
+    NetBufQueueInit(&dropped);
+    /*
+     * A queue earns its quantum only when the head packet no longer fits its deficit. When the driver left
+     * packets behind in an earlier round the deficit still covers them, so a busy driver does not let the
+     * deficit grow without bound.
+     */
+    OsalSpinLockIrqSave(&fcmQueue->lock, &flags);
+    if (q->count != 0 && fcmQueue->param.quantum != 0 &&
+        NetBufGetDataLen(NetBufQueueAtHead(&fcmQueue->dataQueue)) > q->deficit) {
+        q->deficit += fcmQueue->param.quantum;
+    }
+    OsalSpinUnlockIrqRestore(&fcmQueue->lock, &flags);
+    do {
+        OsalSpinLockIrqSave(&fcmQueue->lock, &flags);
+        more = FcDrrTakeBatch(fcmQueue, q, &batch, times, &dropped);
+        OsalSpinUnlockIrqRestore(&fcmQueue->lock, &flags);
+        NetBufQueueClear(&dropped);
+
+        taken = NetBufQueueSize(&batch);
+        if (taken == 0) {
+            break;
+        }
+        (void)FlowControlDeliverQueue(fcm, &batch, id, dir);
+        left = NetBufQueueSize(&batch);
+        sent = taken - left;
+        /* what the driver did not take goes back to the head of the queue in order */
+        OsalSpinLockIrqSave(&fcmQueue->lock, &flags);
+        fcmQueue->stat.sent += sent;
+        while ((buff = NetBufQueueDequeueTail(&batch)) != NULL) {
+            if (fcmQueue->param.quantum != 0) {
+                q->deficit += NetBufGetDataLen(buff);
+            }
+            FcDrrPushHead(fcmQueue, q, buff, times[sent + NetBufQueueSize(&batch)]);
+        }
+        OsalSpinUnlockIrqRestore(&fcmQueue->lock, &flags);
+    } while (more && left == 0); /* the driver is busy once it leaves packets behind */
+    if (taken != 0 && left != 0) {
+        *busy = true;
+    }
+
+    OsalSpinLockIrqSave(&fcmQueue->lock, &flags);
+    backlogged = (q->count != 0);
+    OsalSpinUnlockIrqRestore(&fcmQueue->lock, &flags);
+    return backlogged;
+}
+
+static bool FcDrrIsStrict(struct FlowControlModule *fcm, FlowDir dir, uint32_t id)
+{
+    struct FlowControlQueue *fcmQueue = &fcm->fcmQueue[dir].queues[id];
+    uint32_t flags = 0;
+    bool strict = false;
+
+    OsalSpinLockIrqSave(&fcmQueue->lock, &flags);
+    strict = (fcmQueue->param.quantum == 0);
+    OsalSpinUnlockIrqRestore(&fcmQueue->lock, &flags);
+    return strict;
+}
+
+static uint32_t FcDrrSchedule(struct FlowControlModule *fcm, FlowDir dir)
+{
+    struct FcDrrState *state = (struct FcDrrState *)fcm->schedPriv[dir];
+    uint32_t round;
+    uint32_t id;
+    bool backlogged = true;
+    bool busy = false;
+
+    for (round = 0; round < FC_DRR_MAX_ROUNDS && backlogged && !busy; round++) {
+        backlogged = false;
+        /* strict queues are drained before each round robin pass */
+        for (id = 0; id < QUEUE_ID_COUNT; id++) {
+            if (!busy && FcDrrIsStrict(fcm, dir, id)) {
+                backlogged = FcDrrServeQueue(fcm, state, (FlowControlQueueID)id, dir, &busy) || backlogged;
+            }
+        }
+        for (id = 0; id < QUEUE_ID_COUNT; id++) {
+            if (!busy && !FcDrrIsStrict(fcm, dir, id)) {
+                backlogged = FcDrrServeQueue(fcm, state, (FlowControlQueueID)id, dir, &busy) || backlogged;
+            }
+        }
+    }
+    if (!backlogged) {
+        return HDF_WAIT_FOREVER;
+    }
+    /*
+     * Retrying a busy driver at once only spins, it is tried again when schedFCM reports an enqueue or a
+     * completed packet. The timed wait covers drivers that do not report their completions.
+     */
+    return busy ? FC_DRR_BUSY_WAIT_MS : 0;
+}
+
+/* Adopts the packets queued before the scheduler was set, they count as queued now. */
+static void FcDrrAdoptQueue(struct FlowControlQueue *fcmQueue, struct FcDrrQueue *q)
+{
+    uint32_t count = NetBufQueueSize(&fcmQueue->dataQueue);
+    uint32_t now = FcNowUs();
+    NetBuf *buff = NULL;
+
+    for (; count > 0; count--) {
+        buff = NetBufQueueDequeue(&fcmQueue->dataQueue);
+        if (q->count == FC_DRR_QUEUE_LIMIT) {
+            NetBufFree(buff);
+            fcmQueue->stat.dropped++;
+            continue;
+        }
+        FcDrrPushTail(fcmQueue, q, buff, now);
+    }
+}
+
+static int32_t FcDrrInit(struct FlowControlModule *fcm, FlowDir dir)
+{
+    struct FcDrrState *state = (struct FcDrrState *)OsalMemCalloc(sizeof(struct FcDrrState));
+    uint32_t id;
+
+    if (state == NULL) {
+        HDF_LOGE("%s fail: malloc fail!", __func__);
+        return HDF_ERR_MALLOC_FAIL;
+    }
+    for (id = 0; id < QUEUE_ID_COUNT; id++) {
+        FcDrrAdoptQueue(&fcm->fcmQueue[dir].queues[id], &state->queues[id]);
+    }
+    fcm->schedPriv[dir] = state;
+    return HDF_SUCCESS;
+}
+
+static void FcDrrDeinit(struct FlowControlModule *fcm, FlowDir dir)
+{
+    OsalMemFree(fcm->schedPriv[dir]);
+    fcm->schedPriv[dir] = NULL;
+}
+
+static const struct FlowControlScheduler g_drrScheduler = {
+    .init = FcDrrInit,
+    .deinit = FcDrrDeinit,
+    .enqueue = FcDrrEnqueue,
+    .schedule = FcDrrSchedule,
+};
+
+const struct FlowControlScheduler *GetFlowControlDrrScheduler(void)
+{
+    return &g_drrScheduler;
+}
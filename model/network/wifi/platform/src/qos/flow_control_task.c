@@ -84,6 +84,8 @@ static void FlowControlRxTreadProcess(struct FlowControlModule *fcm)
 static int32_t RunWiFiFlowControl(void *para, FlowDir dir)
 {
     struct FlowControlModule *fcm = (struct FlowControlModule *)para;
+    uint32_t waitMs = HDF_WAIT_FOREVER;
+    int32_t ret;
     if (para == NULL || dir >= FLOW_DIR_COUNT) {
         HDF_LOGE("%s fail: para = null or dir=%d!", __func__, dir);
         return HDF_ERR_INVALID_PARAM;
@@ -92,7 +94,8 @@ static int32_t RunWiFiFlowControl(void *para, FlowDir dir)
     fcm->threadStatus[dir] = THREAD_STARTING;
     while (true) {
         fcm->threadStatus[dir] = THREAD_WAITING;
-        if (OsalSemWait(&fcm->sem[dir], HDF_WAIT_FOREVER) != HDF_SUCCESS) {
+        ret = OsalSemWait(&fcm->sem[dir], waitMs);
+        if (ret != HDF_SUCCESS && ret != HDF_ERR_TIMEOUT) {
             HDF_LOGE("%s exit: OsalSemWait return false!", __func__);
             continue;
         }
@@ -101,7 +104,10 @@ static int32_t RunWiFiFlowControl(void *para, FlowDir dir)
             break;
         }
         fcm->threadStatus[dir] = THREAD_RUNNING;
-        if (dir == FLOW_TX) {
+        waitMs = HDF_WAIT_FOREVER;
+        if (fcm->scheduler[dir] != NULL) {
+            waitMs = fcm->scheduler[dir]->schedule(fcm, dir);
+        } else if (dir == FLOW_TX) {
             FlowControlTxTreadProcess(fcm);
         } else if (dir == FLOW_RX) {
             FlowControlRxTreadProcess(fcm);
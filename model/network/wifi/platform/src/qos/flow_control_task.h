@@ -13,6 +13,8 @@
 #define MAX_EXIT_THREAD_COUNT 10 /* 10MS */
 int32_t CreateFlowControlTask(struct FlowControlModule *fcm);
 void DestroyFlowControlTask(struct FlowControlModule *fcm);
+/* Hands @q to the driver op of @dir, which takes the packets it sends off the queue. */
+int32_t FlowControlDeliverQueue(struct FlowControlModule *fcm, NetBufQueue *q, uint32_t id, uint32_t dir);
 
 #define TX_THREAD_NAME "hdf_wifi_tx"
 #define RX_THREAD_NAME "hdf_wifi_rx"
@@ -9,10 +9,12 @@
 #include "devmgr_service.h"
 #include "devsvc_manager_clnt.h"
 #include "hdf_device_object.h"
+#include "hdf_driver.h"
 #include "hdf_log.h"
 #include "hdf_pm.h"
 #include "osal_file.h"
 #include "osal_mem.h"
+#include "securec.h"
 
 #define HDF_LOG_TAG sample_driver_test
 
@@ -30,6 +32,14 @@ struct DListHead g_sampleDeviceList = { NULL };
 #define REGISTER_DEV_MAX 16
 struct HdfDeviceObject *g_resistedDevice[REGISTER_DEV_MAX] = { 0 };
 
+#define INDEX_TEST_DRIVER_COUNT 200 // enough to grow the driver registry table a few times
+#define INDEX_TEST_NAME_LEN 32
+
+struct SampleIndexTestDriver {
+    struct HdfDriverEntry entry;
+    char moduleName[INDEX_TEST_NAME_LEN];
+};
+
 static void SaveRegistedDevice(struct SampleTestDevice *sampleDev)
 {
     if (g_sampleDeviceList.next == NULL) {
@@ -164,6 +174,60 @@ int32_t SampleDriverPowerStateInject(uint32_t powerState)
     return ret;
 }
 
+static bool SampleDriverIndexFound(const struct SampleIndexTestDriver *drivers, uint32_t count)
+{
+    uint32_t i;
+    struct HdfDriver *driver = NULL;
+    for (i = 0; i < count; i++) {
+        driver = HdfDriverManagerGetDriver(drivers[i].moduleName);
+        if ((driver == NULL) || (driver->entry != &drivers[i].entry)) {
+            HDF_LOGE("%s: driver %s resolves to the wrong entry", __func__, drivers[i].moduleName);
+            return false;
+        }
+    }
+    return true;
+}
+
+/* Lookups by moduleName go through the registry hash table, check them against what was registered. */
+static int32_t SampleDriverCheckDriverIndex(void)
+{
+    struct SampleIndexTestDriver *drivers = NULL;
+    struct HdfDriverEntry duplicate;
+    struct HdfDriver *driver = NULL;
+    uint32_t registered;
+    bool found = false;
+
+    drivers = OsalMemCalloc(sizeof(*drivers) * INDEX_TEST_DRIVER_COUNT);
+    if (drivers == NULL) {
+        return HDF_ERR_MALLOC_FAIL;
+    }
+    for (registered = 0; registered < INDEX_TEST_DRIVER_COUNT; registered++) {
+        if (sprintf_s(drivers[registered].moduleName, INDEX_TEST_NAME_LEN, "sample_index_%u", registered) < 0) {
+            break;
+        }
+        drivers[registered].entry.moduleName = drivers[registered].moduleName;
+        if (HdfRegisterDriverEntry(&drivers[registered].entry) != HDF_SUCCESS) {
+            break;
+        }
+    }
+    // a later driver with the same moduleName stays hidden until the first one goes away
+    (void)memset_s(&duplicate, sizeof(duplicate), 0, sizeof(duplicate));
+    duplicate.moduleName = drivers[0].moduleName;
+    if ((registered == INDEX_TEST_DRIVER_COUNT) && (HdfRegisterDriverEntry(&duplicate) == HDF_SUCCESS)) {
+        found = SampleDriverIndexFound(drivers, registered) && (HdfDriverManagerGetDriver("sample_driver") != NULL);
+        (void)HdfUnregisterDriverEntry(&drivers[0].entry);
+        driver = HdfDriverManagerGetDriver(drivers[0].moduleName);
+        found = found && (driver != NULL) && (driver->entry == &duplicate) &&
+            SampleDriverIndexFound(drivers + 1, registered - 1);
+        (void)HdfUnregisterDriverEntry(&duplicate);
+    }
+    while (registered > 0) {
+        (void)HdfUnregisterDriverEntry(&drivers[--registered].entry);
+    }
+    OsalMemFree(drivers);
+    return found ? HDF_SUCCESS : HDF_FAILURE;
+}
+
 int32_t SampleDriverUpdateService(struct HdfDeviceIoClient *client, struct HdfSBuf *data)
 {
     const char *servInfo = HdfSbufReadString(data);
@@ -213,6 +277,8 @@ int32_t SampleDriverDispatch(struct HdfDeviceIoClient *client, int cmdId, struct
         case SAMPLE_DRIVER_PM_STATE_INJECT:
             HdfSbufReadUint32(data, &powerState);
             return SampleDriverPowerStateInject(powerState);
+        case SAMPLE_DRIVER_CHECK_DRIVER_INDEX:
+            return SampleDriverCheckDriverIndex();
         default:
             break;
     }
@@ -20,6 +20,7 @@ typedef enum {
     SAMPLE_DRIVER_SENDEVENT_SINGLE_DEVICE,
     SAMPLE_DRIVER_SENDEVENT_BROADCAST_DEVICE,
     SAMPLE_DRIVER_PM_STATE_INJECT,
+    SAMPLE_DRIVER_CHECK_DRIVER_INDEX,
 } SAMPLE_DRIVER_CMDID;
 
 struct HdfDeviceObject *GetDeviceObject(void);
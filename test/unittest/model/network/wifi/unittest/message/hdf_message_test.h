@@ -57,5 +57,6 @@ int32_t MessageSingleNodeTest002(void);
 int32_t MessageSingleNodeTest003(void);
 int32_t MessageSingleNodeTest004(void);
 int32_t MessageSingleNodeTest005(void);
+int32_t MessageSingleNodeTest006(void);
 
 #endif
\ No newline at end of file
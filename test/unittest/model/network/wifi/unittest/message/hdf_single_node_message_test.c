@@ -18,15 +18,20 @@ const uint32_t SEND_MESSAGE_COUNT = 40000;
 const uint32_t SYNC_MESSAGE_TIMEOUT = 2;
 const uint32_t ASYNC_MESSAGE_TIMEOUT = 8;
 #define COMMON_SEM_TIMEOUT 300
+#define MULTI_WORKER_SEM_TIMEOUT 2000
 
 enum ServiceList {
     SERVICE_ID_A = 10,
-    SERVICE_ID_B
+    SERVICE_ID_B,
+    SERVICE_ID_C,
+    SERVICE_ID_D
 };
 
 const uint8_t CUSTOM_DISPATCHER_ID = 1;
 const uint8_t SINGLE_NODE_TEST_CUSTOM_DISPATCHER_PRIORITYLEVEL = 4;
 const uint32_t SINGLE_NODE_TEST_CUSTOM_DISPATCHER_QUEUESIZE = 10000;
+const uint8_t MULTI_WORKER_DISPATCHER_ID = 2;
+const uint8_t MULTI_WORKER_DISPATCHER_WORKER_COUNT = 2;
 
 const uint16_t SMALL_LOAD_WAIT_TIME = 500;
 
@@ -335,3 +340,139 @@ int32_t MessageSingleNodeTest005(void)
 
     return errCode;
 }
+
+static ErrorCode FuncParallelLoad(const RequestContext *context, struct HdfSBuf *reqData, struct HdfSBuf *rspData)
+{
+    (void)context;
+    (void)reqData;
+    (void)rspData;
+    OsalMSleep(SMALL_LOAD_WAIT_TIME);
+    return ME_SUCCESS;
+}
+
+#define ORDERED_MESSAGE_COUNT 8
+const uint16_t ORDERED_LOAD_WAIT_TIME = 10;
+static uint32_t g_orderedList[ORDERED_MESSAGE_COUNT];
+static uint32_t g_orderedCount = 0;
+static bool g_orderedBusy = false;
+static bool g_orderedOverlap = false;
+
+// Records the arrival order; a service must never be handled by two workers at once
+static ErrorCode FuncOrderedLoad(const RequestContext *context, struct HdfSBuf *reqData, struct HdfSBuf *rspData)
+{
+    (void)reqData;
+    (void)rspData;
+    if (context == NULL) {
+        HDF_LOGE("%s:FuncOrderedLoad context NULL!", __func__);
+        return HDF_FAILURE;
+    }
+    if (g_orderedBusy) {
+        g_orderedOverlap = true;
+    }
+    g_orderedBusy = true;
+    OsalMSleep(ORDERED_LOAD_WAIT_TIME);
+    if (g_orderedCount < ORDERED_MESSAGE_COUNT) {
+        g_orderedList[g_orderedCount++] = context->commandId;
+    }
+    g_orderedBusy = false;
+    return ME_SUCCESS;
+}
+
+static struct MessageDef g_testServiceCCmds[] = {
+    DUEMessage(0, FuncParallelLoad, 1),
+    DUEMessage(1, FuncOrderedLoad, 1),
+    DUEMessage(2, FuncOrderedLoad, 1),
+    DUEMessage(3, FuncOrderedLoad, 1),
+    DUEMessage(4, FuncOrderedLoad, 1),
+    DUEMessage(5, FuncOrderedLoad, 1),
+    DUEMessage(6, FuncOrderedLoad, 1),
+    DUEMessage(7, FuncOrderedLoad, 1),
+    DUEMessage(8, FuncOrderedLoad, 1)
+};
+
+ServiceDefine(TestServiceC, SERVICE_ID_C, g_testServiceCCmds);
+
+static struct MessageDef g_testServiceDCmds[] = {
+    DUEMessage(0, FuncParallelLoad, 1)
+};
+
+ServiceDefine(TestServiceD, SERVICE_ID_D, g_testServiceDCmds);
+
+static bool g_multiWorkerDispatcherInited = false;
+
+// Services on a multi-worker dispatcher are handled in parallel
+int32_t MessageSingleNodeTest006(void)
+{
+    ErrorCode errCode;
+    ErrorCode errShutdown = 0;
+    Service *serviceC = NULL;
+    Service *serviceD = NULL;
+    ServiceCfg cfg = {
+        .dispatcherId = MULTI_WORKER_DISPATCHER_ID
+    };
+    uint32_t i;
+
+    do {
+        OsalTimespec startTime;
+        OsalTimespec endTime;
+        OsalTimespec diffTime;
+        MSG_BREAK_IF_FUNCTION_FAILED(errCode, StartEnv());
+        MSG_BREAK_IF(errCode, g_serviceA == NULL);
+        if (!g_multiWorkerDispatcherInited) {
+            DispatcherConfig config = {
+                .dispatcherId = MULTI_WORKER_DISPATCHER_ID,
+                .priorityLevelCount = SINGLE_NODE_TEST_CUSTOM_DISPATCHER_PRIORITYLEVEL,
+                .queueSize = SINGLE_NODE_TEST_CUSTOM_DISPATCHER_QUEUESIZE,
+                .workerCount = MULTI_WORKER_DISPATCHER_WORKER_COUNT
+            };
+            MSG_BREAK_IF_FUNCTION_FAILED(errCode, AddDispatcher(&config));
+            g_multiWorkerDispatcherInited = true;
+        }
+        serviceC = CreateService(TestServiceC, &cfg);
+        MSG_BREAK_IF(errCode, serviceC == NULL);
+        serviceD = CreateService(TestServiceD, &cfg);
+        MSG_BREAK_IF(errCode, serviceD == NULL);
+
+        MSG_BREAK_IF_FUNCTION_FAILED(errCode, OsalSemInit(&g_callBackSem, 0));
+        MSG_BREAK_IF_FUNCTION_FAILED(errCode, OsalGetTime(&startTime));
+        MSG_BREAK_IF_FUNCTION_FAILED(errCode,
+            g_serviceA->SendAsyncMessage(g_serviceA, SERVICE_ID_C, 0, NULL, SendMessagePerfTestCallBack));
+        MSG_BREAK_IF_FUNCTION_FAILED(errCode,
+            g_serviceA->SendAsyncMessage(g_serviceA, SERVICE_ID_D, 0, NULL, SendMessagePerfTestCallBack));
+        for (i = 0; i < MULTI_WORKER_DISPATCHER_WORKER_COUNT; i++) {
+            MSG_BREAK_IF_FUNCTION_FAILED(errCode, OsalSemWait(&g_callBackSem, MULTI_WORKER_SEM_TIMEOUT));
+        }
+        MSG_BREAK_IF_FUNCTION_FAILED(errCode, OsalGetTime(&endTime));
+        MSG_BREAK_IF_FUNCTION_FAILED(errCode, OsalDiffTime(&startTime, &endTime, &diffTime));
+
+        HDF_LOGI("Process time %llu ms\n", diffTime.sec * 1000 + diffTime.usec / 1000);
+        MSG_BREAK_IF(errCode, diffTime.sec * 1000 + diffTime.usec / 1000 >= 2 * SMALL_LOAD_WAIT_TIME);
+
+        // Messages to one service keep their order although the dispatcher has several workers
+        g_orderedCount = 0;
+        g_orderedOverlap = false;
+        for (i = 0; i < ORDERED_MESSAGE_COUNT; i++) {
+            MSG_BREAK_IF_FUNCTION_FAILED(errCode,
+                g_serviceA->SendAsyncMessage(g_serviceA, SERVICE_ID_C, i + 1, NULL, SendMessagePerfTestCallBack));
+        }
+        MSG_BREAK_IF(errCode, errCode != ME_SUCCESS);
+        for (i = 0; i < ORDERED_MESSAGE_COUNT; i++) {
+            MSG_BREAK_IF_FUNCTION_FAILED(errCode, OsalSemWait(&g_callBackSem, MULTI_WORKER_SEM_TIMEOUT));
+        }
+        MSG_BREAK_IF(errCode, errCode != ME_SUCCESS);
+        MSG_BREAK_IF(errCode, g_orderedCount != ORDERED_MESSAGE_COUNT || g_orderedOverlap);
+        for (i = 0; i < ORDERED_MESSAGE_COUNT; i++) {
+            MSG_BREAK_IF(errCode, g_orderedList[i] != i + 1);
+        }
+    } while (false);
+    errShutdown = errShutdown | OsalSemDestroy(&g_callBackSem);
+    if (serviceC != NULL && serviceC->Destroy != NULL) {
+        serviceC->Destroy(serviceC);
+    }
+    if (serviceD != NULL && serviceD->Destroy != NULL) {
+        serviceD->Destroy(serviceD);
+    }
+    errShutdown = errShutdown | StopEnv();
+
+    return errCode;
+}
@@ -9,6 +9,11 @@
 #include "hdf_netbuf.h"
 #include "hdf_log.h"
 #include "hdf_wifi_test.h"
+#include "net_device.h"
+#include "net_device_impl.h"
+#include "osal_mem.h"
+#include "osal_time.h"
+#include "securec.h"
 
 #define DEFAULT_NETBUF_SIZE     100
 #define DEFAULT_OP_SIZE         10
@@ -828,6 +833,303 @@ int32_t HdfNetBufQueueTest009(void)
     return HDF_SUCCESS;
 }
 
+#define DEFAULT_POOL_BUF_SIZE   1600
+#define DEFAULT_POOL_BUF_COUNT  8
+#define DEFAULT_POOL_HEAD_ROOM  64
+#define DEFAULT_POOL_TAIL_ROOM  32
+#define POOL_PERF_TEST_COUNT    100000
+
+static struct NetDevice g_poolTestDev = {
+    .name = "pooltest0",
+    .neededHeadRoom = DEFAULT_POOL_HEAD_ROOM,
+    .neededTailRoom = DEFAULT_POOL_TAIL_ROOM,
+};
+
+static bool NetBufIsFreshPoolBuf(const NetBuf *nb)
+{
+    return nb != NULL && g_poolTestDev.rxPool != NULL && NetBufGetPool(nb) == g_poolTestDev.rxPool &&
+        NetBufGetRoom(nb, E_HEAD_BUF) == DEFAULT_POOL_HEAD_ROOM && NetBufGetDataLen(nb) == 0 &&
+        NetBufGetRoom(nb, E_TAIL_BUF) >= DEFAULT_POOL_BUF_SIZE + DEFAULT_POOL_TAIL_ROOM;
+}
+
+/*
+* @tc.name: HdfNetBufPoolTest001
+* @tc.desc: NetBufPoolCreate and NetBufPoolDestroy test
+* @tc.type: FUNC
+* @tc.require: AR000DT1UD
+*/
+int32_t HdfNetBufPoolTest001(void)
+{
+    struct NetBufPoolStat stat;
+    struct NetBufPool *pool = NetBufPoolCreate(&g_poolTestDev, DEFAULT_POOL_BUF_SIZE, DEFAULT_POOL_BUF_COUNT);
+    if (pool == NULL || g_poolTestDev.rxPool != pool) {
+        HDF_LOGE("NetBufPoolCreate fail");
+        NetBufPoolDestroy(pool);
+        return HDF_FAILURE;
+    }
+    if (NetBufPoolCreate(&g_poolTestDev, DEFAULT_POOL_BUF_SIZE, DEFAULT_POOL_BUF_COUNT) != NULL) {
+        HDF_LOGE("NetBufPoolCreate twice for one device");
+        NetBufPoolDestroy(pool);
+        return HDF_FAILURE;
+    }
+    if (NetBufPoolGetStat(pool, &stat) != HDF_SUCCESS || stat.free != DEFAULT_POOL_BUF_COUNT ||
+        stat.highWater != DEFAULT_POOL_BUF_COUNT || stat.bufSize != DEFAULT_POOL_BUF_SIZE) {
+        HDF_LOGE("NetBufPoolGetStat fail, free:%u", stat.free);
+        NetBufPoolDestroy(pool);
+        return HDF_FAILURE;
+    }
+    NetBufPoolDestroy(pool);
+    if (g_poolTestDev.rxPool != NULL) {
+        HDF_LOGE("NetBufPoolDestroy fail");
+        return HDF_FAILURE;
+    }
+    return HDF_SUCCESS;
+}
+
+/*
+* @tc.name: HdfNetBufPoolTest002
+* @tc.desc: NetBufPoolAlloc and NetBufDevFree test, buffers come back reset
+* @tc.type: FUNC
+* @tc.require: AR000DT1UD
+*/
+int32_t HdfNetBufPoolTest002(void)
+{
+    int32_t ret = HDF_SUCCESS;
+    NetBuf *nb = NULL;
+    struct NetBufPoolStat stat;
+    struct NetBufPool *pool = NetBufPoolCreate(&g_poolTestDev, DEFAULT_POOL_BUF_SIZE, DEFAULT_POOL_BUF_COUNT);
+    if (pool == NULL) {
+        HDF_LOGE("NetBufPoolCreate fail");
+        return HDF_FAILURE;
+    }
+
+    nb = NetBufPoolAlloc(pool);
+    if (!NetBufIsFreshPoolBuf(nb)) {
+        HDF_LOGE("NetBufPoolAlloc fail");
+        NetBufDevFree(nb);
+        NetBufPoolDestroy(pool);
+        return HDF_FAILURE;
+    }
+    NetBufPop(nb, E_TAIL_BUF, DEFAULT_NETBUF_SIZE);
+    NetBufPush(nb, E_HEAD_BUF, DEFAULT_HEAD_SIZE);
+    NetBufDevFree(nb);
+
+    nb = NetBufDevAlloc(&g_poolTestDev, DEFAULT_NETBUF_SIZE);
+    if (!NetBufIsFreshPoolBuf(nb)) {
+        HDF_LOGE("NetBufDevAlloc did not reuse a reset pool buffer");
+        ret = HDF_FAILURE;
+    }
+    NetBufDevFree(nb);
+    if (NetBufPoolGetStat(pool, &stat) != HDF_SUCCESS || stat.free != DEFAULT_POOL_BUF_COUNT ||
+        stat.hit != 2 || stat.miss != 0) {
+        HDF_LOGE("NetBufPoolGetStat fail, free:%u hit:%u miss:%u", stat.free, stat.hit, stat.miss);
+        ret = HDF_FAILURE;
+    }
+    NetBufPoolDestroy(pool);
+    return ret;
+}
+
+/*
+* @tc.name: HdfNetBufPoolTest003
+* @tc.desc: Pool miss and overflow test
+* @tc.type: FUNC
+* @tc.require: AR000DT1UD
+*/
+int32_t HdfNetBufPoolTest003(void)
+{
+    int32_t ret = HDF_SUCCESS;
+    uint32_t i;
+    NetBuf *nbs[DEFAULT_POOL_BUF_COUNT + 1] = { NULL };
+    struct NetBufPoolStat stat;
+    struct NetBufPool *pool = NetBufPoolCreate(&g_poolTestDev, DEFAULT_POOL_BUF_SIZE, DEFAULT_POOL_BUF_COUNT);
+    if (pool == NULL) {
+        HDF_LOGE("NetBufPoolCreate fail");
+        return HDF_FAILURE;
+    }
+
+    for (i = 0; i < DEFAULT_POOL_BUF_COUNT + 1; i++) {
+        nbs[i] = NetBufPoolAlloc(pool);
+        if (!NetBufIsFreshPoolBuf(nbs[i])) {
+            HDF_LOGE("NetBufPoolAlloc fail, index:%u", i);
+            ret = HDF_FAILURE;
+        }
+    }
+    for (i = 0; i < DEFAULT_POOL_BUF_COUNT + 1; i++) {
+        NetBufDevFree(nbs[i]);
+    }
+    if (NetBufPoolGetStat(pool, &stat) != HDF_SUCCESS || stat.free != DEFAULT_POOL_BUF_COUNT ||
+        stat.miss != 1 || stat.overflow != 1) {
+        HDF_LOGE("NetBufPoolGetStat fail, free:%u miss:%u overflow:%u", stat.free, stat.miss, stat.overflow);
+        ret = HDF_FAILURE;
+    }
+    NetBufPoolDestroy(pool);
+    return ret;
+}
+
+/*
+* @tc.name: HdfNetBufPoolTest004
+* @tc.desc: NetBufPoolSetWatermark and NetBufPoolRefill test
+* @tc.type: FUNC
+* @tc.require: AR000DT1UD
+*/
+int32_t HdfNetBufPoolTest004(void)
+{
+    int32_t ret = HDF_SUCCESS;
+    uint32_t i;
+    NetBuf *nbs[DEFAULT_POOL_BUF_COUNT] = { NULL };
+    struct NetBufPoolStat stat;
+    struct NetBufPool *pool = NetBufPoolCreate(&g_poolTestDev, DEFAULT_POOL_BUF_SIZE, DEFAULT_POOL_BUF_COUNT);
+    if (pool == NULL) {
+        HDF_LOGE("NetBufPoolCreate fail");
+        return HDF_FAILURE;
+    }
+    if (NetBufPoolSetWatermark(pool, DEFAULT_POOL_BUF_COUNT, DEFAULT_POOL_BUF_COUNT + 1) == HDF_SUCCESS ||
+        NetBufPoolSetWatermark(pool, DEFAULT_POOL_BUF_COUNT / 2, DEFAULT_POOL_BUF_COUNT) != HDF_SUCCESS) {
+        HDF_LOGE("NetBufPoolSetWatermark fail");
+        NetBufPoolDestroy(pool);
+        return HDF_FAILURE;
+    }
+
+    for (i = 0; i < DEFAULT_POOL_BUF_COUNT / 2; i++) {
+        nbs[i] = NetBufPoolAlloc(pool);
+    }
+    if (NetBufPoolRefill(pool) != 0) {
+        HDF_LOGE("NetBufPoolRefill at the low watermark should not fill");
+        ret = HDF_FAILURE;
+    }
+    nbs[i] = NetBufPoolAlloc(pool);
+    if (NetBufPoolRefill(pool) != DEFAULT_POOL_BUF_COUNT / 2 + 1) {
+        HDF_LOGE("NetBufPoolRefill below the low watermark fail");
+        ret = HDF_FAILURE;
+    }
+    for (i = 0; i < DEFAULT_POOL_BUF_COUNT; i++) {
+        NetBufDevFree(nbs[i]);
+    }
+    if (NetBufPoolGetStat(pool, &stat) != HDF_SUCCESS || stat.free != DEFAULT_POOL_BUF_COUNT) {
+        HDF_LOGE("NetBufPoolGetStat fail, free:%u", stat.free);
+        ret = HDF_FAILURE;
+    }
+    NetBufPoolDestroy(pool);
+    return ret;
+}
+
+/*
+* @tc.name: HdfNetBufPoolTest005
+* @tc.desc: Alloc and free churn is served from the pool, timed against the plain allocator
+* @tc.type: PERF
+* @tc.require: AR000DT1UD
+*/
+int32_t HdfNetBufPoolTest005(void)
+{
+    int32_t ret = HDF_SUCCESS;
+    uint32_t i;
+    NetBuf *nb = NULL;
+    OsalTimespec startTime, endTime, plainTime, poolTime;
+    struct NetBufPoolStat stat;
+    struct NetDevice plainDev = g_poolTestDev;
+    struct NetBufPool *pool = NetBufPoolCreate(&g_poolTestDev, DEFAULT_POOL_BUF_SIZE, DEFAULT_POOL_BUF_COUNT);
+    if (pool == NULL) {
+        HDF_LOGE("NetBufPoolCreate fail");
+        return HDF_FAILURE;
+    }
+    plainDev.rxPool = NULL;
+
+    OsalGetTime(&startTime);
+    for (i = 0; i < POOL_PERF_TEST_COUNT; i++) {
+        nb = NetBufDevAlloc(&plainDev, DEFAULT_POOL_BUF_SIZE);
+        if (nb == NULL) {
+            HDF_LOGE("NetBufDevAlloc without pool fail, index:%u", i);
+            NetBufPoolDestroy(pool);
+            return HDF_FAILURE;
+        }
+        NetBufFree(nb);
+    }
+    OsalGetTime(&endTime);
+    OsalDiffTime(&startTime, &endTime, &plainTime);
+
+    OsalGetTime(&startTime);
+    for (i = 0; i < POOL_PERF_TEST_COUNT; i++) {
+        nb = NetBufDevAlloc(&g_poolTestDev, DEFAULT_POOL_BUF_SIZE);
+        if (!NetBufIsFreshPoolBuf(nb)) {
+            HDF_LOGE("NetBufDevAlloc from pool fail, index:%u", i);
+            NetBufDevFree(nb);
+            ret = HDF_FAILURE;
+            break;
+        }
+        NetBufDevFree(nb);
+    }
+    OsalGetTime(&endTime);
+    OsalDiffTime(&startTime, &endTime, &poolTime);
+
+    // one buffer at a time never empties the pool, so every application is a hit and every free a recycle
+    if (NetBufPoolGetStat(pool, &stat) != HDF_SUCCESS || stat.hit != POOL_PERF_TEST_COUNT || stat.miss != 0 ||
+        stat.overflow != 0 || stat.free != DEFAULT_POOL_BUF_COUNT) {
+        HDF_LOGE("NetBufPoolGetStat fail, hit:%u miss:%u overflow:%u free:%u", stat.hit, stat.miss, stat.overflow,
+            stat.free);
+        ret = HDF_FAILURE;
+    }
+    NetBufPoolDestroy(pool);
+
+    HDF_LOGI("%u alloc/free: plain %llu.%06llus, pool %llu.%06llus", POOL_PERF_TEST_COUNT,
+        plainTime.sec, plainTime.usec, poolTime.sec, poolTime.usec);
+    return ret;
+}
+
+/*
+* @tc.name: HdfNetBufPoolTest006
+* @tc.desc: Buffers still held when the pool and its device are gone are released without touching the device,
+*           and a buffer handed over to the network stack no longer refers to the pool
+* @tc.type: FUNC
+* @tc.require: AR000DT1UD
+*/
+int32_t HdfNetBufPoolTest006(void)
+{
+    int32_t ret = HDF_SUCCESS;
+    uint32_t i;
+    NetBuf *nbs[DEFAULT_POOL_BUF_COUNT] = { NULL };
+    struct NetBufPool *pool = NULL;
+    struct NetDevice *dev = (struct NetDevice *)OsalMemCalloc(sizeof(*dev));
+    if (dev == NULL) {
+        HDF_LOGE("OsalMemCalloc fail");
+        return HDF_FAILURE;
+    }
+    *dev = g_poolTestDev;
+    pool = NetBufPoolCreate(dev, DEFAULT_POOL_BUF_SIZE, DEFAULT_POOL_BUF_COUNT);
+    if (pool == NULL) {
+        HDF_LOGE("NetBufPoolCreate fail");
+        OsalMemFree(dev);
+        return HDF_FAILURE;
+    }
+    for (i = 0; i < DEFAULT_POOL_BUF_COUNT; i++) {
+        nbs[i] = NetBufDevAlloc(dev, DEFAULT_POOL_BUF_SIZE);
+    }
+    // half of the buffers are returned while the device is still there
+    for (i = 0; i < DEFAULT_POOL_BUF_COUNT / 2; i++) {
+        NetBufDevFree(nbs[i]);
+    }
+    // as NetIfRx does, the stack takes one over and frees it by itself
+    NetBufPoolHandOver(nbs[i], dev);
+    if (nbs[i] == NULL || nbs[i]->dev != (void *)dev || NetBufGetPool(nbs[i]) != NULL) {
+        HDF_LOGE("NetBufPoolHandOver fail");
+        ret = HDF_FAILURE;
+    }
+    NetBufFree(nbs[i]);
+    nbs[i] = NULL;
+
+    // as NetDeviceDeInit does, the device goes away while the driver still holds buffers
+    NetBufPoolDestroy(pool);
+    if (dev->rxPool != NULL) {
+        HDF_LOGE("NetBufPoolDestroy did not detach the pool");
+        ret = HDF_FAILURE;
+    }
+    (void)memset_s(dev, sizeof(*dev), 0xff, sizeof(*dev));
+    OsalMemFree(dev);
+    for (i = DEFAULT_POOL_BUF_COUNT / 2; i < DEFAULT_POOL_BUF_COUNT; i++) {
+        NetBufDevFree(nbs[i]);
+    }
+    return ret;
+}
+
 // add test case
 pTestCaseFunc g_hdfNetBufTestCaseLists[] = {
     HdfNetBufTest001,
@@ -860,6 +1162,16 @@ pTestCaseFunc g_hdfNetBufQueueTestCaseLists[] = {
     HdfNetBufQueueTest009,
 };
 
+// add test case
+pTestCaseFunc g_hdfNetBufPoolTestCaseLists[] = {
+    HdfNetBufPoolTest001,
+    HdfNetBufPoolTest002,
+    HdfNetBufPoolTest003,
+    HdfNetBufPoolTest004,
+    HdfNetBufPoolTest005,
+    HdfNetBufPoolTest006,
+};
+
 // HDFNetBuf test case Entry
 int32_t HdfNetBufTest(void)
 {
@@ -897,3 +1209,22 @@ int32_t HdfNetBufQueueTest(void)
 
     return HDF_SUCCESS;
 }
+
+// HdfNetBufPool test case Entry
+int32_t HdfNetBufPoolTest(void)
+{
+    int32_t ret, i;
+
+    for (i = 0; i < sizeof(g_hdfNetBufPoolTestCaseLists) / sizeof(g_hdfNetBufPoolTestCaseLists[0]); ++i) {
+        if (g_hdfNetBufPoolTestCaseLists[i] != NULL) {
+            ret = g_hdfNetBufPoolTestCaseLists[i]();
+            HDF_LOGI("HdfTest:HdfNetBufPool test_case[%d] result[%s-%d]",
+                i + 1, (ret != HDF_SUCCESS) ? "failed" : "pass", ret);
+            if (ret != HDF_SUCCESS) {
+                return HDF_FAILURE;
+            }
+        }
+    }
+
+    return HDF_SUCCESS;
+}
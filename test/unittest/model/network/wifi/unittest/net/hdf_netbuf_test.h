@@ -11,6 +11,7 @@
 
 int32_t HdfNetBufTest(void);
 int32_t HdfNetBufQueueTest(void);
+int32_t HdfNetBufPoolTest(void);
 
 #endif // HDF_NETBUF_TEST_H
 
@@ -9,6 +9,8 @@
 #include "net_device_test.h"
 #include "hdf_log.h"
 #include "net_device.h"
+#include "net_device_adapter.h"
+#include "net_device_impl.h"
 #include <securec.h>
 
 static struct NetDevice *g_netDevice = NULL;
@@ -138,6 +140,280 @@ int32_t WiFiNetDviceTestRx(void)
     return NetIfRx(g_netDevice, buff);
 }
 
+#define GRO_TEST_PAYLOAD_LEN 100
+#define GRO_TEST_HDR_LEN (sizeof(struct EtherHeader) + sizeof(struct IpHeader) + sizeof(struct TcpHeader))
+#define GRO_TEST_FRAME_LEN (GRO_TEST_HDR_LEN + GRO_TEST_PAYLOAD_LEN)
+#define GRO_TEST_MAX_FRAMES 4
+#define GRO_TEST_TCP_FIN 0x01
+#define GRO_TEST_TCP_PSH 0x08
+#define GRO_TEST_TCP_ACK 0x10
+#define GRO_TEST_CSUM_OK 0xFFFF
+
+static NetBuf *g_groFrames[GRO_TEST_MAX_FRAMES];
+static uint32_t g_groFrameCount = 0;
+
+static uint16_t WiFiNetDeviceTestCsum(uint32_t sum, const uint8_t *data, uint32_t len)
+{
+    while (len > 1) {
+        sum += ((uint32_t)data[0] << 8) | data[1]; // high byte of a big endian word
+        data += sizeof(uint16_t);
+        len -= sizeof(uint16_t);
+    }
+    if (len != 0) {
+        sum += (uint32_t)data[0] << 8; // odd byte is padded with zero
+    }
+    while ((sum >> 16) != 0) {
+        sum = (sum & 0xFFFF) + (sum >> 16);
+    }
+    return (uint16_t)sum;
+}
+
+static uint16_t WiFiNetDeviceTestTcpCsum(const struct IpHeader *ipHeader, uint32_t tcpLen)
+{
+    uint32_t sum = WiFiNetDeviceTestCsum(0, (const uint8_t *)&ipHeader->sAddr,
+        sizeof(ipHeader->sAddr) + sizeof(ipHeader->dAddr));
+    sum += ipHeader->protocol + tcpLen;
+    return WiFiNetDeviceTestCsum(sum, (const uint8_t *)(ipHeader + 1), tcpLen);
+}
+
+/* The payload byte at sequence number n is (uint8_t)n, so a merged payload can be checked against its sequence. */
+static NetBuf *WiFiNetDeviceTestTcpSegment(uint32_t seq, uint8_t flags)
+{
+    struct IpHeader *ipHeader = NULL;
+    struct TcpHeader *tcpHeader = NULL;
+    uint8_t *payload = NULL;
+    uint32_t i;
+    uint8_t *data = NULL;
+    NetBuf *buff = NetBufAlloc(GRO_TEST_FRAME_LEN);
+
+    if (buff == NULL) {
+        return NULL;
+    }
+    NetBufPush(buff, E_DATA_BUF, GRO_TEST_FRAME_LEN);
+    data = NetBufGetAddress(buff, E_DATA_BUF);
+    (void)memset_s(data, GRO_TEST_FRAME_LEN, 0, GRO_TEST_FRAME_LEN);
+    ((struct EtherHeader *)data)->etherType = htons(ETHER_TYPE_IP);
+    ipHeader = (struct IpHeader *)(data + sizeof(struct EtherHeader));
+    ipHeader->versionAndHl = 0x45; // IPv4 without options
+    ipHeader->totLen = htons(GRO_TEST_FRAME_LEN - sizeof(struct EtherHeader));
+    ipHeader->ttl = 64;            // default ttl
+    ipHeader->protocol = 6;        // TCP
+    ipHeader->sAddr = htonl(0xC0A80102);
+    ipHeader->dAddr = htonl(0xC0A80103);
+    ipHeader->check = htons((uint16_t)~WiFiNetDeviceTestCsum(0, (const uint8_t *)ipHeader, sizeof(*ipHeader)));
+    tcpHeader = (struct TcpHeader *)(ipHeader + 1);
+    tcpHeader->sPort = htons(80);
+    tcpHeader->dPort = htons(50000);
+    tcpHeader->seqNum = htonl(seq);
+    tcpHeader->ackNum = htonl(1);
+    tcpHeader->offset = (sizeof(struct TcpHeader) / sizeof(uint32_t)) << 4;
+    tcpHeader->flags = flags;
+    tcpHeader->window = htons(0xFFFF);
+    payload = (uint8_t *)(tcpHeader + 1);
+    for (i = 0; i < GRO_TEST_PAYLOAD_LEN; i++) {
+        payload[i] = (uint8_t)(seq + i);
+    }
+    tcpHeader->check = htons((uint16_t)~WiFiNetDeviceTestTcpCsum(ipHeader,
+        sizeof(struct TcpHeader) + GRO_TEST_PAYLOAD_LEN));
+    return buff;
+}
+
+static int32_t WiFiNetDeviceTestGroDeliver(const struct NetDevice *netDevice, NetBuf *buff, ReceiveFlag flag)
+{
+    (void)netDevice;
+    (void)flag;
+    if (g_groFrameCount >= GRO_TEST_MAX_FRAMES) {
+        NetBufFree(buff);
+        return HDF_FAILURE;
+    }
+    g_groFrames[g_groFrameCount++] = buff;
+    return HDF_SUCCESS;
+}
+
+static void WiFiNetDeviceTestGroClear(void)
+{
+    uint32_t i;
+
+    for (i = 0; i < g_groFrameCount; i++) {
+        NetBufFree(g_groFrames[i]);
+        g_groFrames[i] = NULL;
+    }
+    g_groFrameCount = 0;
+}
+
+/* Checks a delivered frame carries payloadLen bytes from seq with valid lengths and checksums. */
+static bool WiFiNetDeviceTestGroCheckFrame(uint32_t index, uint32_t seq, uint32_t payloadLen, uint8_t flags)
+{
+    const uint8_t *data = NULL;
+    const struct IpHeader *ipHeader = NULL;
+    const struct TcpHeader *tcpHeader = NULL;
+    const uint8_t *payload = NULL;
+    uint32_t tcpLen = sizeof(struct TcpHeader) + payloadLen;
+    uint32_t i;
+
+    if (index >= g_groFrameCount || NetBufGetDataLen(g_groFrames[index]) != GRO_TEST_HDR_LEN + payloadLen) {
+        HDF_LOGE("%s fail : frame %u missing or bad length", __func__, index);
+        return false;
+    }
+    data = NetBufGetAddress(g_groFrames[index], E_DATA_BUF);
+    ipHeader = (const struct IpHeader *)(data + sizeof(struct EtherHeader));
+    tcpHeader = (const struct TcpHeader *)(ipHeader + 1);
+    if (ntohs(ipHeader->totLen) != sizeof(struct IpHeader) + tcpLen ||
+        WiFiNetDeviceTestCsum(0, (const uint8_t *)ipHeader, sizeof(*ipHeader)) != GRO_TEST_CSUM_OK ||
+        WiFiNetDeviceTestTcpCsum(ipHeader, tcpLen) != GRO_TEST_CSUM_OK) {
+        HDF_LOGE("%s fail : frame %u bad IP length or checksum", __func__, index);
+        return false;
+    }
+    if (ntohl(tcpHeader->seqNum) != seq || tcpHeader->flags != flags) {
+        HDF_LOGE("%s fail : frame %u seq=%u flags=0x%x", __func__, index, ntohl(tcpHeader->seqNum),
+            tcpHeader->flags);
+        return false;
+    }
+    payload = (const uint8_t *)(tcpHeader + 1);
+    for (i = 0; i < payloadLen; i++) {
+        if (payload[i] != (uint8_t)(seq + i)) {
+            HDF_LOGE("%s fail : frame %u payload differs at %u", __func__, index, i);
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool WiFiNetDeviceTestGroReceive(struct NetRxGro *gro, uint32_t seq, uint8_t flags)
+{
+    NetBuf *buff = WiFiNetDeviceTestTcpSegment(seq, flags);
+
+    if (buff == NULL) {
+        HDF_LOGE("%s fail : alloc fail", __func__);
+        return false;
+    }
+    return NetRxGroReceive(gro, buff, NO_IN_INTERRUPT) == HDF_SUCCESS;
+}
+
+/* Two in-order segments are merged into one frame with rewritten lengths and checksums. */
+static bool WiFiNetDeviceTestGroMerge(struct NetRxGro *gro)
+{
+    const uint32_t seq = 1;
+
+    if (!WiFiNetDeviceTestGroReceive(gro, seq, GRO_TEST_TCP_ACK) ||
+        !WiFiNetDeviceTestGroReceive(gro, seq + GRO_TEST_PAYLOAD_LEN, GRO_TEST_TCP_ACK) || g_groFrameCount != 0) {
+        return false;
+    }
+    (void)NetRxGroFlush(gro, NO_IN_INTERRUPT);
+    return g_groFrameCount == 1 &&
+        WiFiNetDeviceTestGroCheckFrame(0, seq, GRO_TEST_PAYLOAD_LEN * 2, GRO_TEST_TCP_ACK);
+}
+
+/* A gap in the sequence passes on the held frame first and holds the new segment on its own. */
+static bool WiFiNetDeviceTestGroOutOfOrder(struct NetRxGro *gro)
+{
+    const uint32_t seq = 1001;
+    const uint32_t nextSeq = seq + GRO_TEST_PAYLOAD_LEN * 2;
+
+    if (!WiFiNetDeviceTestGroReceive(gro, seq, GRO_TEST_TCP_ACK) ||
+        !WiFiNetDeviceTestGroReceive(gro, nextSeq, GRO_TEST_TCP_ACK) || g_groFrameCount != 1 ||
+        !WiFiNetDeviceTestGroCheckFrame(0, seq, GRO_TEST_PAYLOAD_LEN, GRO_TEST_TCP_ACK)) {
+        return false;
+    }
+    (void)NetRxGroFlush(gro, NO_IN_INTERRUPT);
+    return g_groFrameCount == 2 &&
+        WiFiNetDeviceTestGroCheckFrame(1, nextSeq, GRO_TEST_PAYLOAD_LEN, GRO_TEST_TCP_ACK);
+}
+
+/* A PSH segment is merged and the frame is passed on at once. */
+static bool WiFiNetDeviceTestGroPush(struct NetRxGro *gro)
+{
+    const uint32_t seq = 2001;
+
+    if (!WiFiNetDeviceTestGroReceive(gro, seq, GRO_TEST_TCP_ACK) ||
+        !WiFiNetDeviceTestGroReceive(gro, seq + GRO_TEST_PAYLOAD_LEN, GRO_TEST_TCP_ACK | GRO_TEST_TCP_PSH)) {
+        return false;
+    }
+    return g_groFrameCount == 1 &&
+        WiFiNetDeviceTestGroCheckFrame(0, seq, GRO_TEST_PAYLOAD_LEN * 2, GRO_TEST_TCP_ACK | GRO_TEST_TCP_PSH);
+}
+
+/* A FIN segment is not merged, the held frame goes first and the FIN follows unchanged. */
+static bool WiFiNetDeviceTestGroFin(struct NetRxGro *gro)
+{
+    const uint32_t seq = 3001;
+
+    (void)WiFiNetDeviceTestGroReceive(gro, seq, GRO_TEST_TCP_ACK);
+    (void)WiFiNetDeviceTestGroReceive(gro, seq + GRO_TEST_PAYLOAD_LEN, GRO_TEST_TCP_ACK | GRO_TEST_TCP_FIN);
+    return g_groFrameCount == 2 && WiFiNetDeviceTestGroCheckFrame(0, seq, GRO_TEST_PAYLOAD_LEN, GRO_TEST_TCP_ACK) &&
+        WiFiNetDeviceTestGroCheckFrame(1, seq + GRO_TEST_PAYLOAD_LEN, GRO_TEST_PAYLOAD_LEN,
+        GRO_TEST_TCP_ACK | GRO_TEST_TCP_FIN);
+}
+
+static int32_t WiFiNetDeviceTestGroFrames(void)
+{
+    static bool (*const cases[])(struct NetRxGro *gro) = {
+        WiFiNetDeviceTestGroMerge,
+        WiFiNetDeviceTestGroOutOfOrder,
+        WiFiNetDeviceTestGroPush,
+        WiFiNetDeviceTestGroFin,
+    };
+    struct NetRxGroConfig config = {
+        .maxFlows = 1,
+        .maxSegments = 4,
+        .maxSize = GRO_TEST_HDR_LEN + GRO_TEST_PAYLOAD_LEN * 4,
+        .flushTimeout = 0,
+    };
+    int32_t ret = HDF_SUCCESS;
+    uint32_t i;
+    struct NetRxGro *gro = NetRxGroCreate(g_netDevice, &config, WiFiNetDeviceTestGroDeliver);
+
+    if (gro == NULL) {
+        HDF_LOGE("%s fail : NetRxGroCreate fail!", __func__);
+        return HDF_FAILURE;
+    }
+    for (i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        if (!cases[i](gro)) {
+            HDF_LOGE("%s fail : case %u fail, frames=%u", __func__, i, g_groFrameCount);
+            ret = HDF_FAILURE;
+        }
+        (void)NetRxGroFlush(gro, NO_IN_INTERRUPT);
+        WiFiNetDeviceTestGroClear();
+    }
+    NetRxGroDestroy(gro);
+    WiFiNetDeviceTestGroClear();
+    return ret;
+}
+
+int32_t WiFiNetDviceTestRxGro(void)
+{
+    struct NetRxGroConfig config = {
+        .maxFlows = 1,
+        .maxSegments = 2,
+        .maxSize = GRO_TEST_FRAME_LEN + GRO_TEST_PAYLOAD_LEN,
+        .flushTimeout = 0,
+    };
+    struct NetRxGroStat stat = {0};
+    NetBuf *first = WiFiNetDeviceTestTcpSegment(1, GRO_TEST_TCP_ACK);
+    NetBuf *second = WiFiNetDeviceTestTcpSegment(1 + GRO_TEST_PAYLOAD_LEN, GRO_TEST_TCP_ACK);
+
+    if (first == NULL || second == NULL || NetIfRxGroEnable(g_netDevice, &config) != HDF_SUCCESS) {
+        NetBufFree(first);
+        NetBufFree(second);
+        HDF_LOGE("%s fail : prepare fail!", __func__);
+        return HDF_FAILURE;
+    }
+    if (NetIfRx(g_netDevice, first) != HDF_SUCCESS || NetIfRx(g_netDevice, second) != HDF_SUCCESS) {
+        NetIfRxGroDisable(g_netDevice);
+        return HDF_FAILURE;
+    }
+    NetIfRxGroFlush(g_netDevice);
+    if (NetIfRxGroGetStat(g_netDevice, &stat) != HDF_SUCCESS || stat.received != 2 || stat.merged != 1 ||
+        stat.delivered != 1) {
+        HDF_LOGE("%s fail : received=%u merged=%u delivered=%u", __func__, stat.received, stat.merged,
+            stat.delivered);
+        NetIfRxGroDisable(g_netDevice);
+        return HDF_FAILURE;
+    }
+    NetIfRxGroDisable(g_netDevice);
+    return WiFiNetDeviceTestGroFrames();
+}
+
 int32_t WiFiNetDviceTestSetStatus(void)
 {
     return NetIfSetStatus(g_netDevice, NETIF_DOWN);
@@ -20,6 +20,7 @@ int32_t WiFiNetDviceTestGetCount(void);
 int32_t WiFiNetDviceTestGetCap(void);
 int32_t WiFiNetDviceTestSetAddr(void);
 int32_t WiFiNetDviceTestRx(void);
+int32_t WiFiNetDviceTestRxGro(void);
 int32_t WiFiNetDviceTestSetStatus(void);
 int32_t WiFiNetDviceTestSetLinkStatus(void);
 int32_t WifiNetDeviceDhcpClient(void);
@@ -9,6 +9,8 @@
 #include "flow_control_test.h"
 #include "flow_control.h"
 #include "hdf_log.h"
+#include "net_device.h"
+#include "net_device_adapter.h"
 #include "securec.h"
 #include "osal_time.h"
 
@@ -142,35 +144,351 @@ int32_t WiFiFlowControlTestGetEapolQueueId(void)
     return HDF_FAILURE;
 }
 
-int32_t WiFiFlowControlTestSendData(void)
+/*
+ * Sends one EAPOL frame through the queue it is classified to, optionally under @scheduler. The frame goes in
+ * with sendQueueToFCM when @asQueue is set and with sendBuffToFCM otherwise.
+ */
+static int32_t WiFiFlowControlTestSendEapol(const struct FlowControlScheduler *scheduler, bool asQueue,
+    struct FlowControlQueueStat *stat)
 {
     NetBuf *buff = NULL;
+    NetBufQueue q;
     FlowControlQueueID id;
+    int32_t ret;
     if (!WiFiFlowControlTestEnv()) {
-        return false;
+        return HDF_FAILURE;
     }
-    buff = ConstructEapolNetBuf();
-    if (buff == NULL) {
+    if (scheduler != NULL && g_flowControlInstance->interface->setScheduler(g_flowControlInstance, scheduler,
+        FLOW_TX) != HDF_SUCCESS) {
+        HDF_LOGE("%s setScheduler fail!", __func__);
         return HDF_FAILURE;
     }
-    if (g_flowControlInstance->interface == NULL) {
-        HDF_LOGE("%s interface = null!", __func__);
+    buff = ConstructEapolNetBuf();
+    if (buff == NULL) {
         return HDF_FAILURE;
     }
     id = g_flowControlInstance->interface->getQueueIdByEtherBuff(buff);
     g_result = false;
-    if (g_flowControlInstance->interface->sendBuffToFCM(g_flowControlInstance, buff, id, FLOW_TX) != HDF_SUCCESS) {
-        HDF_LOGE("%s sendBuffToFCM fail!", __func__);
+    if (asQueue) {
+        NetBufQueueInit(&q);
+        NetBufQueueEnqueue(&q, buff);
+        ret = (g_flowControlInstance->interface->sendQueueToFCM(g_flowControlInstance, &q, FLOW_TX) == 1) ?
+            HDF_SUCCESS : HDF_FAILURE;
+    } else {
+        ret = g_flowControlInstance->interface->sendBuffToFCM(g_flowControlInstance, buff, id, FLOW_TX);
+    }
+    if (ret != HDF_SUCCESS) {
+        HDF_LOGE("%s send to FCM fail!", __func__);
         return HDF_FAILURE;
     }
     if (g_flowControlInstance->interface->schedFCM(g_flowControlInstance, FLOW_TX) != HDF_SUCCESS) {
-        HDF_LOGE("%s sendBuffToFCM fail!", __func__);
+        HDF_LOGE("%s schedFCM fail!", __func__);
         return HDF_FAILURE;
     }
     OsalMSleep(WATITE_RESULT_TIME);
+    (void)g_flowControlInstance->interface->getQueueStat(g_flowControlInstance, stat, id, FLOW_TX);
     NetBufFree(buff);
     DeInitFlowControl(g_flowControlInstance);
     g_flowControlInstance = NULL;
-    HDF_LOGE("%s g_result = %d!", __func__, g_result);
+    HDF_LOGE("%s g_result = %d, sent = %u!", __func__, g_result, stat->sent);
     return g_result ? HDF_SUCCESS : HDF_FAILURE;
-}
\ No newline at end of file
+}
+
+int32_t WiFiFlowControlTestSendData(void)
+{
+    struct FlowControlQueueStat stat = {0};
+    return WiFiFlowControlTestSendEapol(NULL, false, &stat);
+}
+
+int32_t WiFiFlowControlTestDrrSendData(void)
+{
+    struct FlowControlQueueStat stat = {0};
+    if (WiFiFlowControlTestSendEapol(GetFlowControlDrrScheduler(), false, &stat) != HDF_SUCCESS) {
+        return HDF_FAILURE;
+    }
+    return (stat.enqueued == 1 && stat.sent == 1) ? HDF_SUCCESS : HDF_FAILURE;
+}
+
+int32_t WiFiFlowControlTestSendQueue(void)
+{
+    struct FlowControlQueueStat stat = {0};
+    return WiFiFlowControlTestSendEapol(NULL, true, &stat);
+}
+
+#define TCP_TEST_OPT_NOP 0x01
+#define TCP_TEST_FLAG_SYN 0x02
+#define TCP_TEST_FLAG_ACK 0x10
+#define TCP_TEST_HDR_LEN_SHIFT 4
+#define TCP_TEST_WORD_LEN 4
+#define TCP_TEST_TRUNCATED_LEN 10 /* bytes of a TCP header too short to classify */
+
+struct TcpClassifyCase {
+    uint32_t ipOptLen;
+    uint32_t tcpOptLen;
+    uint8_t flags;
+    uint32_t payloadLen;
+    FlowControlQueueID id;
+};
+
+/* Builds an IPv4 TCP frame, the options are padded with NOPs. */
+static NetBuf *ConstructTcpNetBuf(const struct TcpClassifyCase *tc)
+{
+    NetBuf *buff = NULL;
+    uint8_t *data = NULL;
+    struct IpHeader *ipHeader = NULL;
+    struct TcpHeader *tcpHdr = NULL;
+    uint32_t ipHdrLen = sizeof(struct IpHeader) + tc->ipOptLen;
+    uint32_t tcpHdrLen = sizeof(struct TcpHeader) + tc->tcpOptLen;
+    uint32_t len = sizeof(struct EtherHeader) + ipHdrLen + tcpHdrLen + tc->payloadLen;
+
+    buff = NetBufAlloc(len);
+    if (buff == NULL) {
+        HDF_LOGE("%s fail : NetBufAlloc = null!", __func__);
+        return NULL;
+    }
+    NetBufPush(buff, E_DATA_BUF, len);
+    data = NetBufGetAddress(buff, E_DATA_BUF);
+    (void)memset_s(data, len, 0, len);
+    ((struct EtherHeader *)data)->etherType = htons(ETHER_TYPE_IP);
+    ipHeader = (struct IpHeader *)(data + sizeof(struct EtherHeader));
+    (void)memset_s(ipHeader + 1, tc->ipOptLen, TCP_TEST_OPT_NOP, tc->ipOptLen);
+    ipHeader->versionAndHl = (uint8_t)(0x40 | (ipHdrLen / TCP_TEST_WORD_LEN)); // IPv4
+    ipHeader->totLen = htons((uint16_t)(ipHdrLen + tcpHdrLen + tc->payloadLen));
+    ipHeader->protocol = TCP_PROTOCOL;
+    tcpHdr = (struct TcpHeader *)((uint8_t *)ipHeader + ipHdrLen);
+    (void)memset_s(tcpHdr + 1, tc->tcpOptLen, TCP_TEST_OPT_NOP, tc->tcpOptLen);
+    tcpHdr->offset = (uint8_t)((tcpHdrLen / TCP_TEST_WORD_LEN) << TCP_TEST_HDR_LEN_SHIFT);
+    tcpHdr->flags = tc->flags;
+    return buff;
+}
+
+int32_t WiFiFlowControlTestGetTcpQueueId(void)
+{
+    static const struct TcpClassifyCase cases[] = {
+        {0, 0, TCP_TEST_FLAG_SYN, 0, TCP_ACK_QUEUE_ID},
+        {0, 0, TCP_TEST_FLAG_ACK, 0, TCP_ACK_QUEUE_ID},
+        {0, 0, TCP_TEST_FLAG_ACK, 100, TCP_DATA_QUEUE_ID},
+        {0, 12, TCP_TEST_FLAG_ACK, 0, TCP_ACK_QUEUE_ID},
+        {4, 0, TCP_TEST_FLAG_SYN, 0, TCP_ACK_QUEUE_ID},
+        {4, 0, TCP_TEST_FLAG_ACK, 0, TCP_ACK_QUEUE_ID},
+        {8, 12, TCP_TEST_FLAG_ACK, 0, TCP_ACK_QUEUE_ID},
+        {8, 12, TCP_TEST_FLAG_ACK, 100, TCP_DATA_QUEUE_ID},
+    };
+    struct TcpClassifyCase truncated = {4, 0, TCP_TEST_FLAG_ACK, 0, TCP_DATA_QUEUE_ID};
+    int32_t ret = HDF_SUCCESS;
+    FlowControlQueueID id;
+    NetBuf *buff = NULL;
+    uint32_t i;
+    if (!WiFiFlowControlTestEnv()) {
+        return HDF_FAILURE;
+    }
+    for (i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        buff = ConstructTcpNetBuf(&cases[i]);
+        if (buff == NULL) {
+            ret = HDF_FAILURE;
+            break;
+        }
+        id = g_flowControlInstance->interface->getQueueIdByEtherBuff(buff);
+        NetBufFree(buff);
+        if (id != cases[i].id) {
+            HDF_LOGE("%s case %u get id = %d!", __func__, i, id);
+            ret = HDF_FAILURE;
+        }
+    }
+    /* a TCP header cut short by the frame still counts as data */
+    buff = ConstructTcpNetBuf(&truncated);
+    if (buff != NULL) {
+        NetBufPush(buff, E_TAIL_BUF, sizeof(struct TcpHeader) - TCP_TEST_TRUNCATED_LEN);
+        id = g_flowControlInstance->interface->getQueueIdByEtherBuff(buff);
+        NetBufFree(buff);
+        if (id != truncated.id) {
+            HDF_LOGE("%s truncated get id = %d!", __func__, id);
+            ret = HDF_FAILURE;
+        }
+    } else {
+        ret = HDF_FAILURE;
+    }
+    WiFiFlowControlTestOut();
+    return ret;
+}
+
+#define DRR_TEST_PKT_LEN 100
+#define DRR_TEST_QUEUE_LIMIT 256 /* packets a DRR queue holds */
+#define DRR_TEST_RATIO_PKTS 60
+#define DRR_TEST_RATIO_SENT 60   /* sends checked while both queues are backlogged */
+#define DRR_TEST_CODEL_PKTS 60
+#define DRR_TEST_CODEL_TARGET 1000    /* 1ms */
+#define DRR_TEST_CODEL_INTERVAL 10000 /* 10ms */
+#define DRR_TEST_NO_DROP_TARGET 1000000 /* 1s, longer than the test runs */
+#define DRR_TEST_CODEL_AGE 5          /* ms the packets wait before the first service */
+#define DRR_TEST_SLOW_SEND 1          /* ms the slow driver takes per packet */
+#define DRR_TEST_RECORD_MAX (DRR_TEST_RATIO_PKTS * 2)
+
+static FlowControlQueueID g_drrSentIds[DRR_TEST_RECORD_MAX];
+static uint32_t g_drrSentCount = 0;
+static bool g_drrSlowDriver = false;
+
+static int32_t DrrTestGetTxPriorityId(FlowControlQueueID id)
+{
+    return (int32_t)id;
+}
+
+/* Records the queue of each packet sent, the slow driver takes one packet per call. */
+static int32_t DrrTestSendDataPacket(NetBufQueue *q, void *fcmPrivate, int32_t fwPriorityId)
+{
+    NetBuf *buff = NULL;
+    (void)fcmPrivate;
+    while ((buff = NetBufQueueDequeue(q)) != NULL) {
+        if (g_drrSentCount < DRR_TEST_RECORD_MAX) {
+            g_drrSentIds[g_drrSentCount] = (FlowControlQueueID)fwPriorityId;
+        }
+        g_drrSentCount++;
+        NetBufFree(buff);
+        if (g_drrSlowDriver) {
+            OsalMSleep(DRR_TEST_SLOW_SEND);
+            break;
+        }
+    }
+    return HDF_SUCCESS;
+}
+
+static struct FlowControlOp g_drrTestOp = {
+    .isDeviceStaOrP2PClient = IsDeviceStaOrP2PClient,
+    .txDataPacket = DrrTestSendDataPacket,
+    .rxDataPacket = NULL,
+    .getTxQueueId = NULL,
+    .getRxQueueId = NULL,
+    .getTxPriorityId = DrrTestGetTxPriorityId,
+    .getRxPriorityId = NULL,
+};
+
+static bool DrrTestEnv(void)
+{
+    g_drrSentCount = 0;
+    g_drrSlowDriver = false;
+    if (!WiFiFlowControlTestEnv()) {
+        return false;
+    }
+    g_flowControlInstance->interface->registerFlowControlOp(g_flowControlInstance, &g_drrTestOp);
+    if (g_flowControlInstance->interface->setScheduler(g_flowControlInstance, GetFlowControlDrrScheduler(),
+        FLOW_TX) != HDF_SUCCESS) {
+        HDF_LOGE("%s setScheduler fail!", __func__);
+        WiFiFlowControlTestOut();
+        return false;
+    }
+    return true;
+}
+
+static bool DrrTestSetParam(FlowControlQueueID id, uint32_t quantum, uint32_t target, uint32_t interval)
+{
+    struct FlowControlSchedParam param = {
+        .quantum = quantum,
+        .codelTarget = target,
+        .codelInterval = interval,
+    };
+    return g_flowControlInstance->interface->setQueueSchedParam(g_flowControlInstance, &param, id, FLOW_TX) ==
+        HDF_SUCCESS;
+}
+
+static bool DrrTestEnqueue(FlowControlQueueID id, uint32_t count)
+{
+    NetBuf *buff = NULL;
+    uint32_t i;
+    for (i = 0; i < count; i++) {
+        buff = NetBufAlloc(DRR_TEST_PKT_LEN);
+        if (buff == NULL) {
+            HDF_LOGE("%s fail : NetBufAlloc = null!", __func__);
+            return false;
+        }
+        NetBufPush(buff, E_DATA_BUF, DRR_TEST_PKT_LEN);
+        (void)memset_s(NetBufGetAddress(buff, E_DATA_BUF), DRR_TEST_PKT_LEN, 0, DRR_TEST_PKT_LEN);
+        if (g_flowControlInstance->interface->sendBuffToFCM(g_flowControlInstance, buff, id, FLOW_TX) !=
+            HDF_SUCCESS) {
+            NetBufFree(buff);
+            return false;
+        }
+    }
+    return true;
+}
+
+static void DrrTestGetStat(FlowControlQueueID id, struct FlowControlQueueStat *stat)
+{
+    (void)g_flowControlInstance->interface->getQueueStat(g_flowControlInstance, stat, id, FLOW_TX);
+}
+
+int32_t WiFiFlowControlTestDrrQuantum(void)
+{
+    uint32_t bkCount = 0;
+    uint32_t beCount = 0;
+    uint32_t i;
+    if (!DrrTestEnv()) {
+        return HDF_FAILURE;
+    }
+    /* BE may send two packets for each packet of BK */
+    if (!DrrTestSetParam(BK_QUEUE_ID, DRR_TEST_PKT_LEN, DRR_TEST_NO_DROP_TARGET, DRR_TEST_CODEL_INTERVAL) ||
+        !DrrTestSetParam(BE_QUEUE_ID, DRR_TEST_PKT_LEN * 2, DRR_TEST_NO_DROP_TARGET, DRR_TEST_CODEL_INTERVAL) ||
+        !DrrTestEnqueue(BK_QUEUE_ID, DRR_TEST_RATIO_PKTS) || !DrrTestEnqueue(BE_QUEUE_ID, DRR_TEST_RATIO_PKTS)) {
+        WiFiFlowControlTestOut();
+        return HDF_FAILURE;
+    }
+    (void)g_flowControlInstance->interface->schedFCM(g_flowControlInstance, FLOW_TX);
+    OsalMSleep(WATITE_RESULT_TIME);
+    WiFiFlowControlTestOut();
+    if (g_drrSentCount != DRR_TEST_RATIO_PKTS * 2) {
+        HDF_LOGE("%s fail : sent %u!", __func__, g_drrSentCount);
+        return HDF_FAILURE;
+    }
+    for (i = 0; i < DRR_TEST_RATIO_SENT; i++) {
+        if (g_drrSentIds[i] == BK_QUEUE_ID) {
+            bkCount++;
+        } else if (g_drrSentIds[i] == BE_QUEUE_ID) {
+            beCount++;
+        }
+    }
+    HDF_LOGE("%s bk = %u, be = %u!", __func__, bkCount, beCount);
+    return (beCount == bkCount * 2 && bkCount + beCount == DRR_TEST_RATIO_SENT) ? HDF_SUCCESS : HDF_FAILURE;
+}
+
+int32_t WiFiFlowControlTestDrrCodel(void)
+{
+    struct FlowControlQueueStat stat = {0};
+    if (!DrrTestEnv()) {
+        return HDF_FAILURE;
+    }
+    if (!DrrTestSetParam(BE_QUEUE_ID, DRR_TEST_PKT_LEN * 2, DRR_TEST_CODEL_TARGET, DRR_TEST_CODEL_INTERVAL) ||
+        !DrrTestEnqueue(BE_QUEUE_ID, DRR_TEST_CODEL_PKTS)) {
+        WiFiFlowControlTestOut();
+        return HDF_FAILURE;
+    }
+    /* the slow driver keeps the queueing delay above the target for longer than the interval */
+    g_drrSlowDriver = true;
+    OsalMSleep(DRR_TEST_CODEL_AGE);
+    (void)g_flowControlInstance->interface->schedFCM(g_flowControlInstance, FLOW_TX);
+    OsalMSleep(WATITE_RESULT_TIME);
+    DrrTestGetStat(BE_QUEUE_ID, &stat);
+    WiFiFlowControlTestOut();
+    HDF_LOGE("%s sent = %u, dropped = %u, sojournMax = %u!", __func__, stat.sent, stat.dropped, stat.sojournMax);
+    return (stat.dropped != 0 && stat.sent + stat.dropped == DRR_TEST_CODEL_PKTS &&
+        stat.sojournMax > DRR_TEST_CODEL_TARGET) ? HDF_SUCCESS : HDF_FAILURE;
+}
+
+int32_t WiFiFlowControlTestDrrOverflow(void)
+{
+    const uint32_t extra = 10;
+    struct FlowControlQueueStat stat = {0};
+    if (!DrrTestEnv()) {
+        return HDF_FAILURE;
+    }
+    /* nothing is scheduled while the packets are queued, so every packet past the limit is dropped at the tail */
+    if (!DrrTestEnqueue(BE_QUEUE_ID, DRR_TEST_QUEUE_LIMIT + extra)) {
+        WiFiFlowControlTestOut();
+        return HDF_FAILURE;
+    }
+    (void)g_flowControlInstance->interface->schedFCM(g_flowControlInstance, FLOW_TX);
+    OsalMSleep(WATITE_RESULT_TIME);
+    DrrTestGetStat(BE_QUEUE_ID, &stat);
+    WiFiFlowControlTestOut();
+    HDF_LOGE("%s enqueued = %u, sent = %u, dropped = %u!", __func__, stat.enqueued, stat.sent, stat.dropped);
+    return (stat.enqueued == DRR_TEST_QUEUE_LIMIT && stat.sent == DRR_TEST_QUEUE_LIMIT && stat.dropped == extra &&
+        g_drrSentCount == DRR_TEST_QUEUE_LIMIT) ? HDF_SUCCESS : HDF_FAILURE;
+}
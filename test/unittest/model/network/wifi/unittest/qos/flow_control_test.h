@@ -12,5 +12,11 @@
 int32_t WiFiFlowControlTestInit(void);
 int32_t WiFiFlowControlTestDeinit(void);
 int32_t WiFiFlowControlTestSendData(void);
+int32_t WiFiFlowControlTestDrrSendData(void);
+int32_t WiFiFlowControlTestDrrQuantum(void);
+int32_t WiFiFlowControlTestDrrCodel(void);
+int32_t WiFiFlowControlTestDrrOverflow(void);
+int32_t WiFiFlowControlTestSendQueue(void);
 int32_t WiFiFlowControlTestGetEapolQueueId(void);
+int32_t WiFiFlowControlTestGetTcpQueueId(void);
 #endif
\ No newline at end of file
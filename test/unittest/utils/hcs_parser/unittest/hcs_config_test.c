@@ -8,7 +8,14 @@
 
 #include "hcs_config_test.h"
 #include "device_resource_if.h"
+#include "hcs_table.h"
 #include "hdf_log.h"
+#ifdef LOSCFG_DRIVERS_HDF_CONFIG_BLOB
+#include "hcs_blob_if.h"
+#include "hcs_blob_index.h"
+#include "osal_mem.h"
+#include "securec.h"
+#endif
 
 #define HDF_LOG_TAG hcs_config_test
 
@@ -1126,4 +1133,535 @@ int HcsTestGetNodeAttrRefFail(void)
         return HDF_FAILURE;
     }
     return HDF_SUCCESS;
-}
\ No newline at end of file
+}
+
+static const struct DeviceResourceNode *TestNextNodeInPreorder(const struct DeviceResourceNode *node)
+{
+    if (node->child != NULL) {
+        return node->child;
+    }
+    while ((node != NULL) && (node->sibling == NULL)) {
+        node = node->parent;
+    }
+    return (node != NULL) ? node->sibling : NULL;
+}
+
+/* Reference for the match_attr index: a plain preorder walk starting at @start. */
+static const struct DeviceResourceNode *TestWalkNodeByMatchAttr(const struct DeviceResourceNode *start,
+    const char *attrValue)
+{
+    const struct DeviceResourceNode *node = start;
+    const char *value = NULL;
+    for (; node != NULL; node = TestNextNodeInPreorder(node)) {
+        if ((g_devResInstance->GetString(node, "match_attr", &value, NULL) == HDF_SUCCESS) &&
+            (strcmp(value, attrValue) == 0)) {
+            break;
+        }
+    }
+    return node;
+}
+
+static const struct DeviceResourceNode *TestWalkNodeByHash(uint32_t hashValue)
+{
+    const struct DeviceResourceNode *node = g_testRoot;
+    for (; node != NULL; node = TestNextNodeInPreorder(node)) {
+        if (node->hashValue == hashValue) {
+            break;
+        }
+    }
+    return node;
+}
+
+static bool TestHcsAttrIsFound(const struct DeviceResourceNode *node, const char *attrName)
+{
+    uint64_t data;
+    const char *value = NULL;
+    return (g_devResInstance->GetUint64(node, attrName, &data, 0) == HDF_SUCCESS) ||
+        (g_devResInstance->GetString(node, attrName, &value, NULL) == HDF_SUCCESS) ||
+        (g_devResInstance->GetElemNum(node, attrName) >= 0) ||
+        (g_devResInstance->GetNodeByRefAttr(node, attrName) != NULL);
+}
+
+static bool TestHcsIndexAttrLookup(void)
+{
+    const struct DeviceResourceNode *audioNode = g_devResInstance->GetChildNode(g_testRoot, AUDIO_INFO);
+    struct DeviceResourceAttr *pp = NULL;
+    const char *value = NULL;
+    uint32_t attrNum = 0;
+    if (audioNode == NULL) {
+        return false;
+    }
+    DEV_RES_NODE_FOR_EACH_ATTR(audioNode, pp) {
+        if (!TestHcsAttrIsFound(audioNode, pp->name)) {
+            HDF_LOGE("%s: attr %s is not found, line: %d", __func__, pp->name, __LINE__);
+            return false;
+        }
+        attrNum++;
+    }
+    /* enough attributes to be served by the per-node attribute table */
+    if (attrNum <= INDEX_NUM_FOUR) {
+        return false;
+    }
+    if ((g_devResInstance->GetString(audioNode, "pa_identifier", &value, NULL) != HDF_SUCCESS) ||
+        (strcmp(value, "smartpakit") != 0)) {
+        return false;
+    }
+    if ((g_devResInstance->GetString(audioNode, "status", &value, NULL) != HDF_SUCCESS) ||
+        (strcmp(value, "ok") != 0)) {
+        return false;
+    }
+    /* a prefix of existing names and an unknown name must both miss */
+    return !TestHcsAttrIsFound(audioNode, "smartpa") && !TestHcsAttrIsFound(audioNode, INVALID_STRING);
+}
+
+static bool TestHcsIndexMatchAttrLookup(void)
+{
+    static const char *matchValues[] = { HW_AUDIO_INFO, HW_FINGERPRINT_INFO, HW_DATA_TYPE_TEST };
+    const struct DeviceResourceNode *node = g_testRoot;
+    uint32_t i;
+    /* every node is a start point, so both the first match and the ones after it are covered */
+    for (; node != NULL; node = TestNextNodeInPreorder(node)) {
+        for (i = 0; i < sizeof(matchValues) / sizeof(matchValues[0]); i++) {
+            if (g_devResInstance->GetNodeByMatchAttr(node, matchValues[i]) !=
+                TestWalkNodeByMatchAttr(node, matchValues[i])) {
+                HDF_LOGE("%s: %s from %s differs from the walk", __func__, matchValues[i], node->name);
+                return false;
+            }
+        }
+    }
+    return g_devResInstance->GetNodeByMatchAttr(g_testRoot, INVALID_STRING) == NULL;
+}
+
+static bool TestHcsIndexRefLookup(void)
+{
+    const struct DeviceResourceNode *fingerprintNode = g_devResInstance->GetChildNode(g_testRoot, FINGERPRINT_INFO);
+    const struct DeviceResourceNode *ret = NULL;
+    if (fingerprintNode == NULL) {
+        return false;
+    }
+    ret = g_devResInstance->GetNodeByRefAttr(fingerprintNode, FINGER_INFO);
+    if ((ret == NULL) || (ret != TestWalkNodeByHash(ret->hashValue))) {
+        return false;
+    }
+    ret = g_devResInstance->GetNodeByRefAttr(fingerprintNode, AUDIO_INFO);
+    return (ret != NULL) && (ret == TestWalkNodeByHash(ret->hashValue));
+}
+
+int HcsTestIndexLookupMatchesWalk(void)
+{
+    if (!TestGetRootNode()) {
+        return HDF_FAILURE;
+    }
+    if (!TestHcsIndexAttrLookup() || !TestHcsIndexMatchAttrLookup() || !TestHcsIndexRefLookup()) {
+        return HDF_FAILURE;
+    }
+    return HDF_SUCCESS;
+}
+
+#ifdef LOSCFG_DRIVERS_HDF_CONFIG_BLOB
+static bool TestHcsSameNode(const struct DeviceResourceNode *treeNode, const struct DeviceResourceNode *blobNode)
+{
+    if ((treeNode == NULL) || (blobNode == NULL)) {
+        return treeNode == blobNode;
+    }
+    return (treeNode->hashValue == blobNode->hashValue) && (strcmp(treeNode->name, blobNode->name) == 0);
+}
+
+/* Reads one attribute through both backends with every getter that could apply to it. */
+static bool TestHcsSameAttr(const struct DeviceResourceIface *blobIface, const struct DeviceResourceNode *treeNode,
+    const struct DeviceResourceNode *blobNode, const char *attrName)
+{
+    uint64_t treeData = 0;
+    uint64_t blobData = 0;
+    const char *treeValue = NULL;
+    const char *blobValue = NULL;
+    int32_t treeRet = g_devResInstance->GetUint64(treeNode, attrName, &treeData, 0);
+    if ((treeRet != blobIface->GetUint64(blobNode, attrName, &blobData, 0)) || (treeData != blobData)) {
+        return false;
+    }
+    treeRet = g_devResInstance->GetString(treeNode, attrName, &treeValue, NULL);
+    if (treeRet != blobIface->GetString(blobNode, attrName, &blobValue, NULL)) {
+        return false;
+    }
+    if ((treeRet == HDF_SUCCESS) && (strcmp(treeValue, blobValue) != 0)) {
+        return false;
+    }
+    if (g_devResInstance->GetElemNum(treeNode, attrName) != blobIface->GetElemNum(blobNode, attrName)) {
+        return false;
+    }
+    return TestHcsSameNode(g_devResInstance->GetNodeByRefAttr(treeNode, attrName),
+        blobIface->GetNodeByRefAttr(blobNode, attrName));
+}
+
+static bool TestHcsBlobSourceWalk(const struct DeviceResourceIface *blobIface)
+{
+    static const char *matchValues[] = { HW_AUDIO_INFO, HW_FINGERPRINT_INFO, HW_DATA_TYPE_TEST, INVALID_STRING };
+    const struct DeviceResourceNode *treeNode = g_testRoot;
+    const struct DeviceResourceNode *blobNode = blobIface->GetRootNode();
+    struct DeviceResourceAttr *pp = NULL;
+    uint32_t i;
+
+    for (; (treeNode != NULL) && (blobNode != NULL);
+        treeNode = TestNextNodeInPreorder(treeNode), blobNode = TestNextNodeInPreorder(blobNode)) {
+        if (!TestHcsSameNode(treeNode, blobNode)) {
+            HDF_LOGE("%s: node %s differs between the backends", __func__, treeNode->name);
+            return false;
+        }
+        DEV_RES_NODE_FOR_EACH_ATTR(treeNode, pp) {
+            if (!TestHcsSameAttr(blobIface, treeNode, blobNode, pp->name)) {
+                HDF_LOGE("%s: attr %s of %s differs between the backends", __func__, pp->name, treeNode->name);
+                return false;
+            }
+        }
+        for (i = 0; i < sizeof(matchValues) / sizeof(matchValues[0]); i++) {
+            if (!TestHcsSameNode(g_devResInstance->GetNodeByMatchAttr(treeNode, matchValues[i]),
+                blobIface->GetNodeByMatchAttr(blobNode, matchValues[i]))) {
+                HDF_LOGE("%s: %s from %s differs between the backends", __func__, matchValues[i], treeNode->name);
+                return false;
+            }
+        }
+    }
+    return (treeNode == NULL) && (blobNode == NULL);
+}
+#endif
+
+int HcsTestBlobSourceMatchesTree(void)
+{
+#ifdef LOSCFG_DRIVERS_HDF_CONFIG_BLOB
+    const struct DeviceResourceIface *blobIface = DeviceResourceGetIfaceInstance(HDF_CONFIG_SOURCE_BLOB);
+    if (!TestGetRootNode() || (blobIface == NULL) || (blobIface->GetRootNode() == NULL)) {
+        return HDF_FAILURE;
+    }
+    if (!TestHcsBlobSourceWalk(blobIface)) {
+        return HDF_FAILURE;
+    }
+#endif
+    return HDF_SUCCESS;
+}
+
+#ifdef LOSCFG_DRIVERS_HDF_CONFIG_BLOB
+void __attribute__((weak)) HdfGetBuildInConfigData(const unsigned char **data, unsigned int *size);
+
+/* hc-gen -x -i of tools/hc-gen/test/37_blob_index/case.hcs, a 0.8 blob carrying its index. */
+static const unsigned char g_testIndexedBlob[] = {
+    0x0a, 0xa0, 0x0a, 0xa0, 0x00, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x33, 0x01, 0x00, 0x00, 0x01, 0x72, 0x6f, 0x6f, 0x74, 0x00, 0x29, 0x01, 0x00, 0x00, 0x02, 0x6d,
+    0x6f, 0x64, 0x75, 0x6c, 0x65, 0x00, 0x14, 0x69, 0x6e, 0x64, 0x65, 0x78, 0x00, 0x01, 0x61, 0x75,
+    0x64, 0x69, 0x6f, 0x00, 0x48, 0x00, 0x00, 0x00, 0x02, 0x6d, 0x61, 0x74, 0x63, 0x68, 0x5f, 0x61,
+    0x74, 0x74, 0x72, 0x00, 0x14, 0x69, 0x6e, 0x64, 0x65, 0x78, 0x5f, 0x61, 0x75, 0x64, 0x69, 0x6f,
+    0x00, 0x02, 0x73, 0x74, 0x61, 0x74, 0x75, 0x73, 0x00, 0x14, 0x6f, 0x6b, 0x00, 0x02, 0x63, 0x6f,
+    0x64, 0x65, 0x63, 0x00, 0x10, 0x02, 0x02, 0x70, 0x69, 0x6e, 0x73, 0x00, 0x04, 0x03, 0x00, 0x10,
+    0x01, 0x10, 0x02, 0x10, 0x03, 0x02, 0x70, 0x65, 0x65, 0x72, 0x00, 0x03, 0x80, 0x00, 0x00, 0x00,
+    0x01, 0x73, 0x65, 0x6e, 0x73, 0x6f, 0x72, 0x00, 0x89, 0x00, 0x00, 0x00, 0x02, 0x6d, 0x61, 0x74,
+    0x63, 0x68, 0x5f, 0x61, 0x74, 0x74, 0x72, 0x00, 0x14, 0x69, 0x6e, 0x64, 0x65, 0x78, 0x5f, 0x73,
+    0x65, 0x6e, 0x73, 0x6f, 0x72, 0x00, 0x02, 0x6e, 0x61, 0x6d, 0x65, 0x00, 0x14, 0x61, 0x63, 0x63,
+    0x65, 0x6c, 0x00, 0x02, 0x72, 0x61, 0x74, 0x65, 0x00, 0x10, 0x64, 0x01, 0x61, 0x63, 0x63, 0x65,
+    0x6c, 0x00, 0x22, 0x00, 0x00, 0x00, 0x02, 0x6d, 0x61, 0x74, 0x63, 0x68, 0x5f, 0x61, 0x74, 0x74,
+    0x72, 0x00, 0x14, 0x69, 0x6e, 0x64, 0x65, 0x78, 0x5f, 0x61, 0x75, 0x64, 0x69, 0x6f, 0x00, 0x02,
+    0x72, 0x61, 0x6e, 0x67, 0x65, 0x00, 0x10, 0x10, 0x01, 0x67, 0x79, 0x72, 0x6f, 0x00, 0x23, 0x00,
+    0x00, 0x00, 0x02, 0x6d, 0x61, 0x74, 0x63, 0x68, 0x5f, 0x61, 0x74, 0x74, 0x72, 0x00, 0x14, 0x69,
+    0x6e, 0x64, 0x65, 0x78, 0x5f, 0x67, 0x79, 0x72, 0x6f, 0x00, 0x02, 0x70, 0x65, 0x65, 0x72, 0x00,
+    0x03, 0x2d, 0x00, 0x00, 0x00, 0x01, 0x62, 0x6f, 0x61, 0x72, 0x64, 0x00, 0x27, 0x00, 0x00, 0x00,
+    0x02, 0x69, 0x64, 0x00, 0x04, 0x02, 0x00, 0x10, 0x10, 0x10, 0x20, 0x02, 0x6e, 0x61, 0x6d, 0x65,
+    0x73, 0x00, 0x04, 0x02, 0x00, 0x14, 0x61, 0x00, 0x14, 0x62, 0x00, 0x02, 0x6f, 0x77, 0x6e, 0x65,
+    0x72, 0x00, 0x03, 0xe8, 0x00, 0x00, 0x00, 0x00, 0x49, 0x4e, 0x44, 0x58, 0x7c, 0x01, 0x00, 0x00,
+    0x06, 0x00, 0x00, 0x00, 0x38, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x00, 0xc8, 0x00, 0x00, 0x00,
+    0x04, 0x00, 0x00, 0x00, 0x08, 0x01, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x28, 0x01, 0x00, 0x00,
+    0x03, 0x00, 0x00, 0x00, 0x30, 0x01, 0x00, 0x00, 0x10, 0x00, 0x00, 0x00, 0x3c, 0x01, 0x00, 0x00,
+    0x14, 0x00, 0x00, 0x00, 0xff, 0xff, 0xff, 0xff, 0x01, 0x00, 0x00, 0x00, 0xff, 0xff, 0xff, 0xff,
+    0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x2d, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0xff, 0xff, 0xff, 0xff, 0x02, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x05, 0x00, 0x00, 0x00,
+    0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00, 0x05, 0x00, 0x00, 0x00,
+    0x06, 0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00, 0xbb, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00,
+    0xff, 0xff, 0xff, 0xff, 0x04, 0x00, 0x00, 0x00, 0x09, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00,
+    0xe8, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0x0b, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x15, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x0d, 0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00,
+    0x1e, 0x00, 0x00, 0x00, 0x5d, 0x00, 0x00, 0x00, 0x38, 0x00, 0x00, 0x00, 0x75, 0x00, 0x00, 0x00,
+    0x66, 0x00, 0x00, 0x00, 0x51, 0x00, 0x00, 0x00, 0x8c, 0x00, 0x00, 0x00, 0xa6, 0x00, 0x00, 0x00,
+    0xb3, 0x00, 0x00, 0x00, 0xc6, 0x00, 0x00, 0x00, 0xdf, 0x00, 0x00, 0x00, 0xf2, 0x00, 0x00, 0x00,
+    0x0a, 0x01, 0x00, 0x00, 0x20, 0x01, 0x00, 0x00, 0x2b, 0x01, 0x00, 0x00, 0x3b, 0x01, 0x00, 0x00,
+    0x45, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0xd3, 0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00,
+    0xff, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x99, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00,
+    0x04, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0xff, 0xff, 0xff, 0xff, 0x00, 0x00, 0x00, 0x00, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0x02, 0x00, 0x00, 0x00, 0xff, 0xff, 0xff, 0xff, 0x04, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00,
+    0x03, 0x00, 0x00, 0x00, 0x05, 0x00, 0x00, 0x00, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff
+};
+
+static bool TestHcsSameMatch(const char *blob, const struct HcsBlobIndexHeader *embedded,
+    const struct HcsBlobIndexHeader *built, const char *attrValue)
+{
+    uint32_t node;
+    for (node = 0; node <= built->nodeCount; node++) {
+        if (HcsBlobIndexFindMatch(blob, embedded, node, attrValue) !=
+            HcsBlobIndexFindMatch(blob, built, node, attrValue)) {
+            HDF_LOGE("%s: %s from node %u differs between the indexes", __func__, attrValue);
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool TestHcsSameIndexLookup(const char *blob, const struct HcsBlobIndexHeader *embedded,
+    const struct HcsBlobIndexHeader *built)
+{
+    const struct HcsBlobIndexNode *nodes = HcsBlobIndexNodes(built);
+    const uint32_t *attrs = (const uint32_t *)((const char *)built + built->attrTable);
+    const struct HcsBlobIndexMatch *matches = (const struct HcsBlobIndexMatch *)((const char *)built +
+        built->matchTable);
+    uint32_t node;
+    uint32_t i;
+
+    if ((embedded->nodeCount != built->nodeCount) || (embedded->attrCount != built->attrCount) ||
+        (embedded->matchCount != built->matchCount) || (embedded->refSlotCount == 0) ||
+        (embedded->hashBucketCount == 0)) {
+        return false;
+    }
+    for (node = 0; node < built->nodeCount; node++) {
+        if ((HcsBlobIndexFindNode(embedded, nodes[node].offset) != node) ||
+            (HcsBlobIndexFindNode(built, nodes[node].offset) != node) ||
+            (HcsBlobIndexFindNode(embedded, nodes[node].offset + 1) != HCS_BLOB_INDEX_NONE)) {
+            HDF_LOGE("%s: node %u differs between the indexes", __func__, node);
+            return false;
+        }
+        for (i = nodes[node].attrStart; i < nodes[node].attrStart + nodes[node].attrCount; i++) {
+            const char *attrName = blob + attrs[i] + HCS_PREFIX_LENGTH;
+            if (HcsBlobIndexFindAttr(blob, embedded, node, attrName) != HcsBlobIndexFindAttr(blob, built, node,
+                attrName)) {
+                HDF_LOGE("%s: attr %s of node %u differs between the indexes", __func__, attrName, node);
+                return false;
+            }
+        }
+        if (HcsBlobIndexFindAttr(blob, embedded, node, INVALID_STRING) != 0) {
+            return false;
+        }
+    }
+    for (i = 0; i < built->matchCount; i++) {
+        if (!TestHcsSameMatch(blob, embedded, built, blob + matches[i].value)) {
+            return false;
+        }
+    }
+    return TestHcsSameMatch(blob, embedded, built, INVALID_STRING);
+}
+
+/* A ref table without an empty slot never ends a probe for a missing offset. */
+static bool TestHcsIndexRejectFullRefTable(const struct HcsBlobIndexHeader *embedded, uint32_t treeEnd)
+{
+    struct HcsBlobIndexHeader *index = OsalMemAlloc(embedded->size);
+    bool ret = false;
+    if (index == NULL) {
+        return false;
+    }
+    if (memcpy_s(index, embedded->size, embedded, embedded->size) == EOK) {
+        (void)memset_s((char *)index + index->refTable, index->refSlotCount * sizeof(uint32_t), 0,
+            index->refSlotCount * sizeof(uint32_t));
+        ret = !HcsBlobIndexCheck(index, index->size, treeEnd);
+    }
+    OsalMemFree(index);
+    return ret;
+}
+
+/* Parsing the test blob switched the byte alignment, the running config may use the other one. */
+static void TestHcsRestoreBlobFormat(void)
+{
+    const unsigned char *data = NULL;
+    unsigned int length = 0;
+    if (HdfGetBuildInConfigData != NULL) {
+        HdfGetBuildInConfigData(&data, &length);
+        (void)HcsCheckBlobFormat((const char *)data, length);
+    }
+}
+#endif
+
+int HcsTestBlobIndexMatchesBuild(void)
+{
+#ifdef LOSCFG_DRIVERS_HDF_CONFIG_BLOB
+    const char *blob = (const char *)g_testIndexedBlob;
+    uint32_t length = sizeof(g_testIndexedBlob);
+    const struct HcsBlobIndexHeader *embedded = NULL;
+    struct HcsBlobIndexHeader *built = NULL;
+    uint32_t indexOffset;
+    int ret = HDF_FAILURE;
+
+    if (!HcsCheckBlobFormat(blob, length)) {
+        goto OUT;
+    }
+    indexOffset = HcsGetBlobIndexOffset(blob, length);
+    if (indexOffset == 0) {
+        goto OUT;
+    }
+    embedded = (const struct HcsBlobIndexHeader *)(blob + indexOffset);
+    if (!HcsBlobIndexCheck(embedded, length - indexOffset, indexOffset)) {
+        goto OUT;
+    }
+    built = HcsBlobIndexBuild(blob);
+    if (built == NULL) {
+        goto OUT;
+    }
+    if (TestHcsSameIndexLookup(blob, embedded, built) && TestHcsIndexRejectFullRefTable(embedded, indexOffset)) {
+        ret = HDF_SUCCESS;
+    }
+    OsalMemFree(built);
+OUT:
+    TestHcsRestoreBlobFormat();
+    return ret;
+#else
+    return HDF_SUCCESS;
+#endif
+}
+
+/* hc-gen -c -p hcsTest of tools/hc-gen/test/36_table_config/case.hcs, kept out of HdfGetBuildInConfigTable. */
+static const struct HcsTableNode g_hcsTestHcsTableNodes[4];
+
+static const uint8_t g_hcsTestHcsTableUint8Pool[] = {
+    0x1, 0x2, 0x3,
+};
+
+static const uint32_t g_hcsTestHcsTableUint32Pool[] = {
+    0x1, 0x100, 0x10000,
+};
+
+static const char *const g_hcsTestHcsTableStringPool[] = {
+    "a\\b", "c",
+};
+
+static const uint16_t g_hcsTestHcsTableChildIndex[] = {
+    0, 1, 0,
+};
+
+static const struct HcsTableAttr g_hcsTestHcsTableAttrs[] = {
+    { "module", "test", 0x0, 1, HCS_TABLE_STRING, 0 },
+    { "alpha", NULL, 0x3, 1, HCS_TABLE_UINT8, 0 },
+    { "buddy", &g_hcsTestHcsTableNodes[2], 0x0, 1, HCS_TABLE_REF, 0 },
+    { "bytes", &g_hcsTestHcsTableUint8Pool[0], 0x0, 3, HCS_TABLE_UINT8, 1 },
+    { "lines", "first\nsecond", 0x0, 1, HCS_TABLE_STRING, 0 },
+    { "match_attr", "table_device", 0x0, 1, HCS_TABLE_STRING, 0 },
+    { "names", &g_hcsTestHcsTableStringPool[0], 0x0, 2, HCS_TABLE_STRING, 1 },
+    { "path", "C:\\dev\\x", 0x0, 1, HCS_TABLE_STRING, 0 },
+    { "pattern", "a\?\?=b", 0x0, 1, HCS_TABLE_STRING, 0 },
+    { "u16", NULL, 0x100, 1, HCS_TABLE_UINT16, 0 },
+    { "u32", NULL, 0x10000, 1, HCS_TABLE_UINT32, 0 },
+    { "u64", NULL, 0x100000000, 1, HCS_TABLE_UINT64, 0 },
+    { "u8", NULL, 0x1, 1, HCS_TABLE_UINT8, 0 },
+    { "words", &g_hcsTestHcsTableUint32Pool[0], 0x0, 3, HCS_TABLE_UINT32, 1 },
+    { "match_attr", "table_device", 0x0, 1, HCS_TABLE_STRING, 0 },
+    { "zeta", "z", 0x0, 1, HCS_TABLE_STRING, 0 },
+    { "value", NULL, 0x7, 1, HCS_TABLE_UINT8, 0 },
+};
+
+static const struct HcsTableNode g_hcsTestHcsTableNodes[4] = {
+    { "root", NULL, &g_hcsTestHcsTableAttrs[0], &g_hcsTestHcsTableNodes[1], &g_hcsTestHcsTableChildIndex[0],
+        1, 2 },
+    { "device", &g_hcsTestHcsTableNodes[0], &g_hcsTestHcsTableAttrs[1], NULL, NULL, 13, 0 },
+    { "other", &g_hcsTestHcsTableNodes[0], &g_hcsTestHcsTableAttrs[14], &g_hcsTestHcsTableNodes[3],
+        &g_hcsTestHcsTableChildIndex[2], 2, 1 },
+    { "inner", &g_hcsTestHcsTableNodes[2], &g_hcsTestHcsTableAttrs[16], NULL, NULL, 1, 0 },
+};
+
+static const struct HcsTableMatch g_hcsTestHcsTableMatches[] = {
+    { "table_device", &g_hcsTestHcsTableNodes[1] },
+    { "table_device", &g_hcsTestHcsTableNodes[2] },
+};
+
+static const struct HcsTable g_hcsTestHcsTable = {
+    &g_hcsTestHcsTableNodes[0],
+    g_hcsTestHcsTableMatches,
+    2,
+    4,
+};
+
+static bool TestHcsTableIntegers(const struct HcsTableNode *device)
+{
+    uint8_t u8 = 0;
+    uint16_t u16 = 0;
+    uint32_t u32 = 0;
+    uint64_t u64 = 0;
+
+    if (!HcsTableGetBool(device, "u8") || (HcsTableGetUint8(device, "u8", &u8, 0) != HDF_SUCCESS) || (u8 != U8_DATA) ||
+        (HcsTableGetUint16(device, "u16", &u16, 0) != HDF_SUCCESS) || (u16 != U16_DATA) ||
+        (HcsTableGetUint32(device, "u32", &u32, 0) != HDF_SUCCESS) || (u32 != U32_DATA) ||
+        (HcsTableGetUint64(device, "u64", &u64, 0) != HDF_SUCCESS) || (u64 != U64_DATA)) {
+        return false;
+    }
+    // a value is read into a type at least as wide as the one hc-gen fitted it to
+    if ((HcsTableGetUint64(device, "u8", &u64, 0) != HDF_SUCCESS) || (u64 != U8_DATA) ||
+        (HcsTableGetUint8(device, "u16", &u8, DEFAULT_UINT8_MAX) == HDF_SUCCESS) || (u8 != DEFAULT_UINT8_MAX) ||
+        (HcsTableGetUint32(device, INVALID_STRING, &u32, 0) == HDF_SUCCESS)) {
+        return false;
+    }
+    if ((HcsTableGetElemNum(device, "bytes") != DATA_TYPE_NUM_U32) ||
+        (HcsTableGetUint8ArrayElem(device, "bytes", INDEX_NUM_TWO, &u8, 0) != HDF_SUCCESS) || (u8 != TEST_DATA_THREE) ||
+        (HcsTableGetUint8ArrayElem(device, "bytes", INDEX_NUM_THREE, &u8, 0) == HDF_SUCCESS) ||
+        (HcsTableGetUint32ArrayElem(device, "words", INDEX_NUM_TWO, &u32, 0) != HDF_SUCCESS) || (u32 != U32_DATA) ||
+        (HcsTableGetUint16ArrayElem(device, "words", INDEX_NUM_ZERO, &u16, 0) == HDF_SUCCESS) ||
+        (HcsTableGetElemNum(device, "u8") >= 0)) {
+        return false;
+    }
+    return true;
+}
+
+static bool TestHcsTableStrings(const struct HcsTableNode *device)
+{
+    const char *value = NULL;
+
+    if ((HcsTableGetString(device, "path", &value, NULL) != HDF_SUCCESS) || (strcmp(value, "C:\\dev\\x") != 0) ||
+        (HcsTableGetString(device, "lines", &value, NULL) != HDF_SUCCESS) || (strcmp(value, "first\nsecond") != 0) ||
+        (HcsTableGetString(device, "pattern", &value, NULL) != HDF_SUCCESS) || (strcmp(value, "a\?\?=b") != 0)) {
+        return false;
+    }
+    if ((HcsTableGetStringArrayElem(device, "names", INDEX_NUM_ZERO, &value, NULL) != HDF_SUCCESS) ||
+        (strcmp(value, "a\\b") != 0) ||
+        (HcsTableGetStringArrayElem(device, "names", INDEX_NUM_TWO, &value, NULL) == HDF_SUCCESS) ||
+        (HcsTableGetString(device, "u8", &value, STRING_ATTR_VALUE) == HDF_SUCCESS) ||
+        (strcmp(value, STRING_ATTR_VALUE) != 0)) {
+        return false;
+    }
+    return true;
+}
+
+static bool TestHcsTableNodes(const struct HcsTableNode *root)
+{
+    static const char *childNames[] = { "device", "other" };
+    const struct HcsTableNode *device = HcsTableGetChildNode(root, "device");
+    const struct HcsTableNode *other = HcsTableGetChildNode(root, "other");
+    const struct HcsTableNode *child = NULL;
+    const struct HcsTableAttr *attr = NULL;
+    uint32_t i = 0;
+
+    if ((device == NULL) || (other == NULL) || (device->parent != root) ||
+        (HcsTableGetChildNode(other, "inner") == NULL) || (HcsTableGetChildNode(root, "inner") != NULL) ||
+        (HcsTableGetNodeByRefAttr(device, "buddy") != other) || (HcsTableGetNodeByRefAttr(device, "u8") != NULL)) {
+        return false;
+    }
+    HCS_TABLE_FOREACH_CHILD(root, child) {
+        if ((i >= sizeof(childNames) / sizeof(childNames[0])) || (strcmp(child->name, childNames[i++]) != 0)) {
+            return false;
+        }
+    }
+    HCS_TABLE_FOREACH_ATTR(device, attr) {
+        if ((attr != device->attrs) && (strcmp((attr - 1)->name, attr->name) >= 0)) {
+            return false;
+        }
+        if (HcsTableGetAttr(device, attr->name) != attr) {
+            return false;
+        }
+    }
+    return (HcsTableGetAttr(device, INVALID_STRING) == NULL) && TestHcsTableIntegers(device) &&
+        TestHcsTableStrings(device);
+}
+
+int HcsTestTableGetters(void)
+{
+    const struct HcsTable *table = &g_hcsTestHcsTable;
+
+    // nodes sharing a match_attr value keep the depth-first order of the tree
+    if ((table->nodeCount != INDEX_NUM_FOUR) || (table->matchCount != INDEX_NUM_TWO) ||
+        (table->matches[0].node != HcsTableGetChildNode(table->root, "device")) ||
+        (table->matches[1].node != HcsTableGetChildNode(table->root, "other"))) {
+        return HDF_FAILURE;
+    }
+    return TestHcsTableNodes(table->root) ? HDF_SUCCESS : HDF_FAILURE;
+}
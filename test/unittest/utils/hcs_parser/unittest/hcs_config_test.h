@@ -56,6 +56,10 @@ int HcsTestGetStringArrayElemSuccess(void);
 int HcsTestGetStringArrayElemFail(void);
 int HcsTestGetNodeAttrRefSuccess(void);
 int HcsTestGetNodeAttrRefFail(void);
+int HcsTestIndexLookupMatchesWalk(void);
+int HcsTestBlobSourceMatchesTree(void);
+int HcsTestBlobIndexMatchesBuild(void);
+int HcsTestTableGetters(void);
 
 #ifdef __cplusplus
 #if __cplusplus
@@ -67,6 +67,10 @@ HdfTestCaseList g_hdfConfigTestCaseList[] = {
     { HDF_MACRO_TRAVERSAL_NODE_CHILD, HcsMacroTraversalOneNodeChild },
     { HDF_MACRO_TRAVERSAL_NODE_CHILD_VARGS, HcsMacroTraversalOneNodeChildVargs },
     { HDF_MACRO_GET_ONE_FILE, HcsMacroGetOneFile },
+    { HDF_HCS_INDEX_LOOKUP_001, HcsTestIndexLookupMatchesWalk },
+    { HDF_HCS_BLOB_SOURCE_001, HcsTestBlobSourceMatchesTree },
+    { HDF_HCS_BLOB_INDEX_001, HcsTestBlobIndexMatchesBuild },
+    { HDF_HCS_TABLE_001, HcsTestTableGetters },
 };
 
 int32_t HdfConfigEntry(HdfTestMsg *msg)
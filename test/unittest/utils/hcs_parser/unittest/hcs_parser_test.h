@@ -67,6 +67,10 @@ enum HdfConfigTestCaseCmd {
     HDF_MACRO_TRAVERSAL_NODE_CHILD,
     HDF_MACRO_TRAVERSAL_NODE_CHILD_VARGS,
     HDF_MACRO_GET_ONE_FILE,
+    HDF_HCS_INDEX_LOOKUP_001,
+    HDF_HCS_BLOB_SOURCE_001,
+    HDF_HCS_BLOB_INDEX_001,
+    HDF_HCS_TABLE_001,
 };
 
 int32_t HdfConfigEntry(HdfTestMsg *msg);
@@ -30,8 +30,10 @@ static HdfTestCaseList g_hdfWiFiTestCaseList[] = {
     {WIFI_NET_DEVICE_RX, WiFiNetDviceTestRx},
     {WIFI_NET_DEVICE_DHCPC, WifiNetDeviceDhcpClient},
     {WIFI_NET_DEVICE_DHCPS, WifiNetDeviceDhcpServer},
+    {WIFI_NET_DEVICE_RX_GRO, WiFiNetDviceTestRxGro},
     {WIFI_NET_BUF_TEST, HdfNetBufTest},
     {WIFI_NET_BUF_QUEUE_TEST, HdfNetBufQueueTest},
+    {WIFI_NET_BUF_POOL_TEST, HdfNetBufPoolTest},
     {WIFI_MODULE_CREATE_MODULE, WiFiModuleTestCreateModule},
     {WIFI_MODULE_DELETE_MODULE, WiFiModuleTestDeleteModule},
     {WIFI_MODULE_ADD_FEATURE, WiFiModuleTestAddFeature},
@@ -40,6 +42,12 @@ static HdfTestCaseList g_hdfWiFiTestCaseList[] = {
     {WIFI_FLOW_CONTROL_DEINIT, WiFiFlowControlTestDeinit},
     {WIFI_FLOW_CONTROL_GET_QUEUE_ID, WiFiFlowControlTestGetEapolQueueId},
     {WIFI_FLOW_CONTROL_SEND_DATA, WiFiFlowControlTestSendData},
+    {WIFI_FLOW_CONTROL_DRR_SEND_DATA, WiFiFlowControlTestDrrSendData},
+    {WIFI_FLOW_CONTROL_SEND_QUEUE, WiFiFlowControlTestSendQueue},
+    {WIFI_FLOW_CONTROL_DRR_QUANTUM, WiFiFlowControlTestDrrQuantum},
+    {WIFI_FLOW_CONTROL_DRR_CODEL, WiFiFlowControlTestDrrCodel},
+    {WIFI_FLOW_CONTROL_DRR_OVERFLOW, WiFiFlowControlTestDrrOverflow},
+    {WIFI_FLOW_CONTROL_GET_TCP_QUEUE_ID, WiFiFlowControlTestGetTcpQueueId},
     {WIFI_MESSAGE_QUEUE_001, MessageQueueTest001},
     {WIFI_MESSAGE_QUEUE_002, MessageQueueTest002},
     {WIFI_MESSAGE_QUEUE_003, MessageQueueTest003},
@@ -48,6 +56,7 @@ static HdfTestCaseList g_hdfWiFiTestCaseList[] = {
     {WIFI_MESSAGE_SINGLE_NODE_003, MessageSingleNodeTest003},
     {WIFI_MESSAGE_SINGLE_NODE_004, MessageSingleNodeTest004},
     {WIFI_MESSAGE_SINGLE_NODE_005, MessageSingleNodeTest005},
+    {WIFI_MESSAGE_SINGLE_NODE_006, MessageSingleNodeTest006},
 };
 
 int32_t HdfWifiEntry(HdfTestMsg *msg)
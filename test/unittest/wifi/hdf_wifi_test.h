@@ -18,6 +18,12 @@ typedef enum {
     WIFI_FLOW_CONTROL_DEINIT,
     WIFI_FLOW_CONTROL_GET_QUEUE_ID,
     WIFI_FLOW_CONTROL_SEND_DATA,
+    WIFI_FLOW_CONTROL_DRR_SEND_DATA,
+    WIFI_FLOW_CONTROL_SEND_QUEUE,
+    WIFI_FLOW_CONTROL_DRR_QUANTUM,
+    WIFI_FLOW_CONTROL_DRR_CODEL,
+    WIFI_FLOW_CONTROL_DRR_OVERFLOW,
+    WIFI_FLOW_CONTROL_GET_TCP_QUEUE_ID,
     WIFI_FLOW_CONTROL_END = 50,
     /* netdevice. */
     WIFI_NET_DEVICE_INIT = WIFI_FLOW_CONTROL_END,
@@ -33,10 +39,12 @@ typedef enum {
     WIFI_NET_DEVICE_RX,
     WIFI_NET_DEVICE_DHCPC,
     WIFI_NET_DEVICE_DHCPS,
+    WIFI_NET_DEVICE_RX_GRO,
     WIFI_NET_DEVICE_END = 100,
     /* netbuff */
     WIFI_NET_BUF_TEST = WIFI_NET_DEVICE_END,
     WIFI_NET_BUF_QUEUE_TEST,
+    WIFI_NET_BUF_POOL_TEST,
     WIFI_NET_BUFF_END = 150,
     /* module */
     WIFI_MODULE_CREATE_MODULE = WIFI_NET_BUFF_END,
@@ -53,6 +61,7 @@ typedef enum {
     WIFI_MESSAGE_SINGLE_NODE_003,
     WIFI_MESSAGE_SINGLE_NODE_004,
     WIFI_MESSAGE_SINGLE_NODE_005,
+    WIFI_MESSAGE_SINGLE_NODE_006,
     WIFI_MESSAGE_END = 300,
 } HdfWiFiTestCaseCmd;
 
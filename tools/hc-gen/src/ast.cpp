@@ -920,6 +920,10 @@ std::shared_ptr<AstObject> AstObjectFactory::Build(std::shared_ptr<AstObject> ob
 
 void Ast::Dump(const std::string &prefix)
 {
+    // merging dumps the whole tree for every included file, skip the walk unless it is printed
+    if (!Option::Instance().VerboseLog()) {
+        return;
+    }
     Logger().Debug() << "Dump " << prefix << " AST:";
     WalkForward([](const std::shared_ptr<AstObject> &current, int32_t walkDepth) -> int32_t {
         Logger().Debug() << ::std::setw(walkDepth * 4) << " " << *current;
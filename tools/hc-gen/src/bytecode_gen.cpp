@@ -8,6 +8,7 @@
 
 #include "bytecode_gen.h"
 #include <string>
+#include "bytecode_index.h"
 #include "file.h"
 #include "logger.h"
 #include "opcode.h"
@@ -36,6 +37,10 @@ bool ByteCodeGen::Output()
         return false;
     }
 
+    if (Option::Instance().ShouldGenIndex() && !IndexBuild()) {
+        return false;
+    }
+
     if (!ByteCodeWrite(false)) {
         return false;
     }
@@ -184,7 +189,33 @@ bool ByteCodeGen::ByteCodeWrite(bool dummy)
         return false;
     }
 
-    return ByteCodeWriteWalk();
+    if (!ByteCodeWriteWalk()) {
+        return false;
+    }
+
+    return index_.empty() || IndexWrite();
+}
+
+bool ByteCodeGen::IndexBuild()
+{
+    ByteCodeIndex index(Align(OPCODE_BYTE_WIDTH));
+    if (!index.Build(ast_)) {
+        Logger().Error() << "failed to build hcb index";
+        return false;
+    }
+    index_ = index.Data();
+    return true;
+}
+
+/* The index starts at a four byte boundary even in unaligned hcb, the runtime reads it in place. */
+bool ByteCodeGen::IndexWrite()
+{
+    static const char padding[ALIGN_SIZE] = {0};
+    uint32_t paddingSize = ((writeSize_ + ALIGN_SIZE - 1) & (~(ALIGN_SIZE - 1))) - writeSize_;
+    FsWrite(padding, paddingSize);
+    FsWrite(reinterpret_cast<const char *>(index_.data()), static_cast<uint32_t>(index_.size()));
+    writeSize_ += paddingSize + static_cast<uint32_t>(index_.size());
+    return !WriteBad();
 }
 
 bool ByteCodeGen::ByteCodeWriteWalk()
@@ -10,6 +10,7 @@
 #define HC_GEN_BYTECODE_GEN_H
 
 #include <fstream>
+#include <vector>
 #include "generator.h"
 
 namespace OHOS {
@@ -48,6 +49,10 @@ private:
 
     bool ByteCodeWriteWalk();
 
+    bool IndexBuild();
+
+    bool IndexWrite();
+
     template <typename T>
     void Write(T &data);
 
@@ -72,6 +77,7 @@ private:
     std::string outFileName_;
     bool dummyOutput_;
     uint32_t writeSize_;
+    std::vector<uint8_t> index_;
 };
 } // namespace Hardware
 } // namespace OHOS
@@ -0,0 +1,234 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ *
+ * HDF is dual licensed: you can use it either under the terms of
+ * the GPL, or the BSD license, at your option.
+ * See the LICENSE file in the root of this repository for complete details.
+ */
+
+#include "bytecode_index.h"
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+#include "logger.h"
+
+using namespace OHOS::Hardware;
+
+static constexpr const char *HCS_MATCH_ATTR = "match_attr";
+static constexpr uint32_t HASH_KEYS_PER_BUCKET = 2;
+static constexpr uint32_t HASH_SEED_MAX = 1 << 20;
+static constexpr uint32_t REF_LOAD_FACTOR = 2;
+
+ByteCodeIndex::ByteCodeIndex(uint32_t prefixSize) : prefixSize_(prefixSize) {}
+
+uint32_t ByteCodeIndex::Mix(uint32_t value)
+{
+    value ^= value >> 16;
+    value *= 0x85EBCA6B;
+    value ^= value >> 13;
+    value *= 0xC2B2AE35;
+    value ^= value >> 16;
+    return value;
+}
+
+uint32_t ByteCodeIndex::Hash(const std::string &str, uint32_t seed)
+{
+    uint32_t hash = seed ^ 0x811C9DC5;
+    for (auto c : str) {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 0x01000193;
+    }
+    return Mix(hash);
+}
+
+bool ByteCodeIndex::Build(const std::shared_ptr<Ast> &ast)
+{
+    auto root = ast->GetAstRoot();
+    if (root == nullptr || !root->IsNode()) {
+        return false;
+    }
+    AddNode(root, HCB_INDEX_NONE);
+
+    std::vector<uint32_t> order(matches_.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [this](uint32_t a, uint32_t b) {
+        int ret = matchValues_[a].compare(matchValues_[b]);
+        return ret != 0 ? ret < 0 : matches_[a].node < matches_[b].node;
+    });
+    std::vector<HcbIndexMatch> matches;
+    std::vector<std::string> values;
+    for (auto i : order) {
+        matches.push_back(matches_[i]);
+        values.push_back(matchValues_[i]);
+    }
+    matches_.swap(matches);
+    matchValues_.swap(values);
+
+    if (!BuildPerfectHash()) {
+        Logger().Warning() << "no perfect hash found for " << matchValues_.size() << " match_attr values";
+        seeds_.clear();
+        slots_.clear();
+    }
+    BuildRefTable();
+    Serialize();
+    return true;
+}
+
+const std::vector<uint8_t> &ByteCodeIndex::Data() const
+{
+    return data_;
+}
+
+/* Numbers nodes in preorder and groups attributes by node, matching the runtime built index. */
+uint32_t ByteCodeIndex::AddNode(const std::shared_ptr<AstObject> &node, uint32_t parent)
+{
+    auto id = static_cast<uint32_t>(nodes_.size());
+    nodes_.push_back({node->GetHash(), parent, HCB_INDEX_NONE, HCB_INDEX_NONE,
+        static_cast<uint32_t>(attrs_.size()), 0});
+
+    std::vector<std::shared_ptr<AstObject>> terms;
+    for (auto child = node->Child(); child != nullptr; child = child->Next()) {
+        if (child->OpCode() != HCS_TERM_OP) {
+            continue;
+        }
+        terms.push_back(child);
+        auto value = child->Child();
+        if (child->Name() == HCS_MATCH_ATTR && value != nullptr && value->OpCode() == HCS_STRING_OP) {
+            matches_.push_back({value->GetHash() + prefixSize_, id});
+            matchValues_.push_back(value->StringValue());
+        }
+    }
+    // the tree lists attributes in reverse blob order, so the last duplicate wins there too
+    std::stable_sort(terms.begin(), terms.end(), [](const std::shared_ptr<AstObject> &a,
+        const std::shared_ptr<AstObject> &b) {
+        int ret = a->Name().compare(b->Name());
+        return ret != 0 ? ret < 0 : a->GetHash() > b->GetHash();
+    });
+    for (auto &term : terms) {
+        attrs_.push_back(term->GetHash());
+    }
+    nodes_[id].attrCount = static_cast<uint32_t>(terms.size());
+
+    uint32_t lastChild = HCB_INDEX_NONE;
+    for (auto child = node->Child(); child != nullptr; child = child->Next()) {
+        if (child->OpCode() != HCS_NODE_OP) {
+            continue;
+        }
+        auto childId = AddNode(child, id);
+        if (lastChild == HCB_INDEX_NONE) {
+            nodes_[id].child = childId;
+        } else {
+            nodes_[lastChild].sibling = childId;
+        }
+        lastChild = childId;
+    }
+    return id;
+}
+
+/*
+ * Hash and displace: keys are spread over buckets by an unseeded hash, then the largest buckets
+ * first search a seed that places all their keys on free slots. Each slot holds the first match
+ * table entry of its value, so a lookup costs two hashes and one string compare.
+ */
+bool ByteCodeIndex::BuildPerfectHash()
+{
+    std::vector<uint32_t> keys;
+    for (uint32_t i = 0; i < matches_.size(); ++i) {
+        if (i == 0 || matchValues_[i] != matchValues_[i - 1]) {
+            keys.push_back(i);
+        }
+    }
+    if (keys.empty()) {
+        return true;
+    }
+
+    auto slotCount = static_cast<uint32_t>(keys.size());
+    uint32_t bucketCount = (slotCount + HASH_KEYS_PER_BUCKET - 1) / HASH_KEYS_PER_BUCKET;
+    std::vector<std::vector<uint32_t>> buckets(bucketCount);
+    for (auto key : keys) {
+        buckets[Hash(matchValues_[key], 0) % bucketCount].push_back(key);
+    }
+    std::vector<uint32_t> order(bucketCount);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(),
+        [&buckets](uint32_t a, uint32_t b) { return buckets[a].size() > buckets[b].size(); });
+
+    seeds_.assign(bucketCount, 0);
+    slots_.assign(slotCount, HCB_INDEX_NONE);
+    std::vector<uint32_t> placed;
+    for (auto bucket : order) {
+        if (buckets[bucket].empty()) {
+            break;
+        }
+        uint32_t seed = 1;
+        for (; seed < HASH_SEED_MAX; ++seed) {
+            placed.clear();
+            for (auto key : buckets[bucket]) {
+                uint32_t slot = Hash(matchValues_[key], seed) % slotCount;
+                if (slots_[slot] != HCB_INDEX_NONE || std::find(placed.begin(), placed.end(), slot) != placed.end()) {
+                    break;
+                }
+                placed.push_back(slot);
+            }
+            if (placed.size() == buckets[bucket].size()) {
+                break;
+            }
+        }
+        if (seed == HASH_SEED_MAX) {
+            return false;
+        }
+        seeds_[bucket] = seed;
+        for (size_t i = 0; i < placed.size(); ++i) {
+            slots_[placed[i]] = buckets[bucket][i];
+        }
+    }
+    return true;
+}
+
+void ByteCodeIndex::BuildRefTable()
+{
+    uint32_t slotCount = 1;
+    while (slotCount < nodes_.size() * REF_LOAD_FACTOR) {
+        slotCount <<= 1;
+    }
+    refs_.assign(slotCount, HCB_INDEX_NONE);
+    for (uint32_t i = 0; i < nodes_.size(); ++i) {
+        uint32_t slot = Mix(nodes_[i].offset) & (slotCount - 1);
+        while (refs_[slot] != HCB_INDEX_NONE) {
+            slot = (slot + 1) & (slotCount - 1);
+        }
+        refs_[slot] = i;
+    }
+}
+
+template <typename T>
+void ByteCodeIndex::Append(const std::vector<T> &table, uint32_t &offset)
+{
+    offset = static_cast<uint32_t>(data_.size());
+    if (table.empty()) {
+        return;
+    }
+    auto bytes = reinterpret_cast<const uint8_t *>(table.data());
+    data_.insert(data_.end(), bytes, bytes + table.size() * sizeof(T));
+}
+
+void ByteCodeIndex::Serialize()
+{
+    HcbIndexHeader header {};
+    data_.assign(sizeof(header), 0);
+    header.magic = HCB_INDEX_MAGIC_NUM;
+    header.nodeCount = static_cast<uint32_t>(nodes_.size());
+    Append(nodes_, header.nodeTable);
+    header.attrCount = static_cast<uint32_t>(attrs_.size());
+    Append(attrs_, header.attrTable);
+    header.matchCount = static_cast<uint32_t>(matches_.size());
+    Append(matches_, header.matchTable);
+    header.hashBucketCount = static_cast<uint32_t>(seeds_.size());
+    Append(seeds_, header.hashSeedTable);
+    header.hashSlotCount = static_cast<uint32_t>(slots_.size());
+    Append(slots_, header.hashSlotTable);
+    header.refSlotCount = static_cast<uint32_t>(refs_.size());
+    Append(refs_, header.refTable);
+    header.size = static_cast<uint32_t>(data_.size());
+    (void)memcpy(data_.data(), &header, sizeof(header));
+}
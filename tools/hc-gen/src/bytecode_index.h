@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ *
+ * HDF is dual licensed: you can use it either under the terms of
+ * the GPL, or the BSD license, at your option.
+ * See the LICENSE file in the root of this repository for complete details.
+ */
+
+#ifndef HC_GEN_BYTECODE_INDEX_H
+#define HC_GEN_BYTECODE_INDEX_H
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "ast.h"
+#include "opcode.h"
+
+namespace OHOS {
+namespace Hardware {
+/*
+ * Builds the lookup index appended to hcb files. It must run after the bytecode walk has set
+ * the hash of every object, which is the object's offset in the blob.
+ */
+class ByteCodeIndex {
+public:
+    explicit ByteCodeIndex(uint32_t prefixSize);
+
+    ~ByteCodeIndex() = default;
+
+    bool Build(const std::shared_ptr<Ast> &ast);
+
+    const std::vector<uint8_t> &Data() const;
+
+    /* Must match HcsBlobIndexHash() and HcsBlobIndexMix() of the runtime. */
+    static uint32_t Hash(const std::string &str, uint32_t seed);
+
+    static uint32_t Mix(uint32_t value);
+
+private:
+    uint32_t AddNode(const std::shared_ptr<AstObject> &node, uint32_t parent);
+
+    bool BuildPerfectHash();
+
+    void BuildRefTable();
+
+    void Serialize();
+
+    template <typename T>
+    void Append(const std::vector<T> &table, uint32_t &offset);
+
+    uint32_t prefixSize_;
+    std::vector<HcbIndexNode> nodes_;
+    std::vector<uint32_t> attrs_;
+    std::vector<HcbIndexMatch> matches_;
+    std::vector<std::string> matchValues_;
+    std::vector<uint32_t> seeds_;
+    std::vector<uint32_t> slots_;
+    std::vector<uint32_t> refs_;
+    std::vector<uint8_t> data_;
+};
+} // namespace Hardware
+} // namespace OHOS
+
+#endif // HC_GEN_BYTECODE_INDEX_H
@@ -9,6 +9,8 @@
 #include "file.h"
 #include <climits>
 #include <cstdlib>
+#include <fstream>
+#include <sstream>
 #include "types.h"
 
 using namespace OHOS::Hardware::Util;
@@ -27,6 +29,18 @@ std::string File::AbsPath(const std::string &path)
     return p == nullptr ? "" : p;
 }
 
+bool File::ReadAll(const std::string &path, std::string &content)
+{
+    std::ifstream file(path, std::ifstream::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    std::ostringstream stream;
+    stream << file.rdbuf();
+    content = stream.str();
+    return !file.bad();
+}
+
 std::string File::StripSuffix(std::string path)
 {
     auto sepPos = path.rfind(OS_SEPARATOR);
@@ -17,6 +17,7 @@ namespace Util {
 class File {
 public:
     static std::string AbsPath(const std::string &path);
+    static bool ReadAll(const std::string &path, std::string &content);
     static std::string StripSuffix(std::string path);
     static std::string GetDir(std::string path);
     static std::string FileNameBase(const std::string &path);
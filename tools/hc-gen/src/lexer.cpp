@@ -8,9 +8,11 @@
 
 #include "lexer.h"
 
+#include <cstring>
 #include <sstream>
 #include <string>
 
+#include "file.h"
 #include "logger.h"
 
 using namespace OHOS::Hardware;
@@ -32,19 +34,17 @@ std::map<std::string, TokenType> Lexer::keyWords_ = {
 bool Lexer::Initialize(const std::string &sourceName)
 {
     srcName_ = std::make_shared<std::string>(sourceName);
-
-    if (src_.is_open()) {
-        src_.close();
-    }
     bufferStart_ = nullptr;
     bufferEnd_ = nullptr;
-    lineno_ = 1;
-    lineLoc_ = 1;
-    src_.open(srcName_->c_str(), std::ifstream::binary);
-    if (!src_.is_open()) {
+    // the whole file is lexed from memory, hcs sources are small
+    if (!Util::File::ReadAll(sourceName, content_)) {
         Logger().Error() << "Failed to open source file: " << srcName_->data();
         return false;
     }
+    bufferStart_ = content_.data();
+    bufferEnd_ = bufferStart_ + content_.size();
+    lineno_ = 1;
+    lineLoc_ = 1;
     return true;
 }
 
@@ -146,7 +146,7 @@ bool Lexer::PeekChar(char &c, bool skipSpace)
     }
 
     if (skipSpace) {
-        while (bufferStart_ <= bufferEnd_ && (IsSpace(*bufferStart_) || *bufferStart_ == '\n')) {
+        while (bufferStart_ < bufferEnd_ && (IsSpace(*bufferStart_) || *bufferStart_ == '\n')) {
             lineLoc_++;
             if (*bufferStart_ == '\n') {
                 lineLoc_ = 0;
@@ -156,7 +156,7 @@ bool Lexer::PeekChar(char &c, bool skipSpace)
         }
     }
 
-    if (bufferStart_ > bufferEnd_) {
+    if (bufferStart_ >= bufferEnd_) {
         return false;
     }
     c = *bufferStart_;
@@ -170,16 +170,20 @@ bool Lexer::IsSpace(char c)
 
 bool Lexer::FillBuffer()
 {
-    if (bufferStart_ != nullptr && bufferStart_ <= bufferEnd_) {
-        return true;
-    }
-    auto size = src_.readsome(buffer_, BUFFER_SIZE);
-    if (size == 0) {
-        return false;
+    return bufferStart_ != nullptr && bufferStart_ < bufferEnd_;
+}
+
+void Lexer::SkipLine()
+{
+    const char *lineEnd = static_cast<const char *>(memchr(bufferStart_, '\n', bufferEnd_ - bufferStart_));
+    if (lineEnd == nullptr) {
+        lineLoc_ += bufferEnd_ - bufferStart_;
+        bufferStart_ = bufferEnd_;
+        return;
     }
-    bufferStart_ = buffer_;
-    bufferEnd_ = bufferStart_ + size - 1;
-    return true;
+    bufferStart_ = lineEnd + 1;
+    lineno_++;
+    lineLoc_ = 0;
 }
 
 bool Lexer::ProcessComment()
@@ -192,11 +196,7 @@ bool Lexer::ProcessComment()
     }
 
     if (c == '/') {
-        while (c != '\n' && GetChar(c)) {}
-        if (c != '\n' && c != EOF) {
-            Logger().Error() << *this << "unterminated signal line comment";
-            return false;
-        }
+        SkipLine();
     } else if (c == '*') {
         while (GetChar(c)) {
             if (c == '*' && GetChar(c) && c == '/') {
@@ -246,19 +246,25 @@ void Lexer::InitToken(Token &token)
 
 bool Lexer::LexFromString(Token &token)
 {
-    char c;
-    GetChar(c, false); // skip first '"'
-    std::string value;
-    while (GetChar(c, false) && c != '"') {
-        value.push_back(c);
+    ConsumeChar(); // skip first '"'
+    const char *begin = bufferStart_;
+    const char *end = static_cast<const char *>(memchr(begin, '"', bufferEnd_ - begin));
+    const char *stop = (end == nullptr) ? bufferEnd_ : end;
+    for (const char *p = begin; p < stop; p++) {
+        lineLoc_++;
+        if (*p == '\n') {
+            lineno_++;
+            lineLoc_ = 0;
+        }
     }
-
-    if (c != '"') {
+    bufferStart_ = stop;
+    if (end == nullptr) {
         Logger().Error() << *this << "unterminated string";
         return false;
     }
+    ConsumeChar(); // skip last '"'
     token.type = STRING;
-    token.strval = std::move(value);
+    token.strval.assign(begin, end);
     token.lineNo = lineno_;
     return true;
 }
@@ -335,16 +341,14 @@ bool Lexer::LexFromNumber(Token &token)
 
 void Lexer::LexFromLiteral(Token &token)
 {
-    std::string value;
-    char c;
-
-    while (PeekChar(c, false) && !IsSpace(c)) {
-        if (!isalnum(c) && c != '_' && c != '.' && c != '\\') {
-            break;
-        }
-        value.push_back(c);
-        ConsumeChar();
+    const char *begin = bufferStart_;
+    const char *end = begin;
+    while (end < bufferEnd_ && (isalnum(*end) || *end == '_' || *end == '.' || *end == '\\')) {
+        end++;
     }
+    lineLoc_ += end - begin;
+    bufferStart_ = end;
+    std::string value(begin, end);
 
     do {
         if (value == "true") {
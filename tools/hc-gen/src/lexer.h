@@ -9,7 +9,6 @@
 #ifndef HC_GEN_LEXER_H
 #define HC_GEN_LEXER_H
 
-#include <fstream>
 #include <iostream>
 #include <map>
 #include <string>
@@ -39,8 +38,6 @@ public:
     int32_t GetLineLoc() const;
 
 private:
-    static constexpr int BUFFER_SIZE = (1024 * 1024);
-
     void InitToken(Token &token);
 
     bool GetChar(char &c, bool skipSpace = true);
@@ -57,6 +54,8 @@ private:
 
     bool ProcessComment();
 
+    void SkipLine();
+
     bool LexInclude(Token &token);
 
     bool LexFromString(Token &token);
@@ -71,11 +70,10 @@ private:
 
     static std::map<std::string, TokenType> keyWords_;
 
-    std::ifstream src_;
     std::shared_ptr<std::string> srcName_;
-    char buffer_[BUFFER_SIZE] {0};
+    std::string content_;
     const char *bufferStart_ {nullptr};
-    const char *bufferEnd_ {nullptr};
+    const char *bufferEnd_ {nullptr}; // one past the last character of content_
     int32_t lineno_;
     int32_t lineLoc_;
 };
@@ -25,12 +25,19 @@ public:
     inline ~Logger()
     {
         if (level_ > INFO) {
-            ::std::cout << ERROR_COLOR_END;
+            *Output() << ERROR_COLOR_END;
         }
         if (level_ <= DEBUG && !Option::Instance().VerboseLog()) {
             return;
         }
-        ::std::cout << ::std::endl;
+        *Output() << ::std::endl;
+    }
+
+    /* stream the logs of the calling thread go to, parse workers collect theirs to print them in order */
+    static inline ::std::ostream *&Output()
+    {
+        static thread_local ::std::ostream *output = &::std::cout;
+        return output;
     }
 
     template <typename T>
@@ -39,7 +46,7 @@ public:
         if (level_ <= DEBUG && !Option::Instance().VerboseLog()) {
             return *this;
         }
-        ::std::cout << v;
+        *Output() << v;
         return *this;
     }
 
@@ -101,9 +108,9 @@ private:
             {FATAL,   "Fatal"  }
         };
         if (level_ > INFO) {
-            ::std::cout << ERROR_COLOR_PREFIX;
+            *Output() << ERROR_COLOR_PREFIX;
         }
-        ::std::cout << "[" << levelStrMap[level_] << "] ";
+        *Output() << "[" << levelStrMap[level_] << "] ";
     }
 
 #ifdef OS_LINUX
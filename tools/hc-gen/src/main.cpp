@@ -12,6 +12,7 @@
 #include "macro_gen.h"
 #include "option.h"
 #include "parser.h"
+#include "table_gen.h"
 #include "text_gen.h"
 
 using namespace OHOS::Hardware;
@@ -60,6 +61,11 @@ int main(int argc, char *argv[])
             return EFAIL;
         }
     }
+    if (option.ShouldGenTableConfig()) {
+        if (!TableGen(parser.GetAst()).Output()) {
+            return EFAIL;
+        }
+    }
 
     if (option.ShouldGenStartConfig()) {
         if (!StartupCfgGen(parser.GetAst()).Output()) {
@@ -34,6 +34,44 @@ struct HcbHeader {
     uint32_t checkSum;
     int32_t totalSize;
 };
+
+/*
+ * Optional lookup index appended after the config tree, starting at the next four byte boundary.
+ * Offsets of tables are relative to the index start, blob offsets are relative to the blob start.
+ */
+constexpr uint32_t HCB_INDEX_MAGIC_NUM = 0x58444E49;
+constexpr uint32_t HCB_INDEX_NONE = 0xFFFFFFFF;
+
+struct HcbIndexHeader {
+    uint32_t magic;
+    uint32_t size;
+    uint32_t nodeCount;
+    uint32_t nodeTable;
+    uint32_t attrCount;
+    uint32_t attrTable;
+    uint32_t matchCount;
+    uint32_t matchTable;
+    uint32_t hashBucketCount;
+    uint32_t hashSeedTable;
+    uint32_t hashSlotCount;
+    uint32_t hashSlotTable;
+    uint32_t refSlotCount;
+    uint32_t refTable;
+};
+
+struct HcbIndexNode {
+    uint32_t offset;
+    uint32_t parent;
+    uint32_t child;
+    uint32_t sibling;
+    uint32_t attrStart;
+    uint32_t attrCount;
+};
+
+struct HcbIndexMatch {
+    uint32_t value;
+    uint32_t node;
+};
 } // namespace Hardware
 } // namespace OHOS
 
@@ -6,6 +6,7 @@
  * See the LICENSE file in the root of this repository for complete details.
  */
 
+#include <cstdlib>
 #include <cstring>
 #include <getopt.h>
 #include <iomanip>
@@ -17,9 +18,11 @@
 
 using namespace OHOS::Hardware;
 static constexpr int HCS_COMPILER_VERSION_MAJOR = 00;
-static constexpr int HCS_COMPILER_VERSION_MINOR = 7;
+static constexpr int HCS_COMPILER_VERSION_MINOR = 8;
 
 static constexpr int ARG_COUNT_MIN = 2;
+static constexpr int PARSE_JOBS_BASE = 10;
+static constexpr unsigned long PARSE_JOBS_MAX = 256;
 
 Option &Option::Instance()
 {
@@ -28,7 +31,7 @@ Option &Option::Instance()
 }
 
 static constexpr int OPTION_END = -1;
-static constexpr const char *HCS_SUPPORT_ARGS = "o:ap:bditmvVhs";
+static constexpr const char *HCS_SUPPORT_ARGS = "o:ap:bcditmvVhsxj:";
 
 Option &Option::Parse(int argc, char **argv)
 {
@@ -84,11 +87,19 @@ void Option::SetOptionData(char op)
             shouldGenTextConfig_ = true;
             shouldGenByteCodeConfig_ = false;
             shouldGenMacroConfig_ = false;
+            shouldGenTableConfig_ = false;
             break;
         case 'm':
             shouldGenTextConfig_ = false;
             shouldGenByteCodeConfig_ = false;
             shouldGenMacroConfig_ = true;
+            shouldGenTableConfig_ = false;
+            break;
+        case 'c':
+            shouldGenTextConfig_ = false;
+            shouldGenByteCodeConfig_ = false;
+            shouldGenMacroConfig_ = false;
+            shouldGenTableConfig_ = true;
             break;
         case 'p':
             symbolNamePrefix_ = optarg;
@@ -102,6 +113,12 @@ void Option::SetOptionData(char op)
         case 'd':
             shouldDecompile_ = true;
             break;
+        case 'x':
+            shouldGenIndex_ = true;
+            break;
+        case 'j':
+            SetParseJobs(optarg);
+            break;
         case 'v':
             showVersion_ = true;
             break;
@@ -129,9 +146,12 @@ void Option::ShowUsage()
     ShowOption("-b", "output binary output, default enable");
     ShowOption("-t", "output config in C language source file style");
     ShowOption("-m", "output config in macro file style");
+    ShowOption("-c", "output config as const tables in C language source file style");
     ShowOption("-s", "output start config of host");
     ShowOption("-i", "output binary hex dump in C language source file style");
+    ShowOption("-x", "append lookup index to binary output");
     ShowOption("-p <prefix>", "prefix of generated symbol name");
+    ShowOption("-j <jobs>", "parse included files with jobs threads, default one per cpu");
     ShowOption("-d", "decompile hcb to hcs");
     ShowOption("-V", "show verbose info");
     ShowOption("-v", "show version");
@@ -179,6 +199,11 @@ bool Option::ShouldGenMacroConfig() const
     return shouldGenMacroConfig_;
 }
 
+bool Option::ShouldGenTableConfig() const
+{
+    return shouldGenTableConfig_;
+}
+
 bool Option::ShouldGenBinaryConfig() const
 {
     return shouldGenByteCodeConfig_;
@@ -194,6 +219,28 @@ bool Option::ShouldDecompile() const
     return shouldDecompile_;
 }
 
+bool Option::ShouldGenIndex() const
+{
+    return shouldGenIndex_;
+}
+
+uint32_t Option::GetParseJobs() const
+{
+    return parseJobs_;
+}
+
+void Option::SetParseJobs(const char *jobs)
+{
+    char *end = nullptr;
+    unsigned long value = strtoul(jobs, &end, PARSE_JOBS_BASE);
+    if (end == jobs || *end != '\0' || value == 0 || value > PARSE_JOBS_MAX) {
+        Logger().Error() << "invalid parse jobs: " << jobs;
+        SetOptionError();
+        return;
+    }
+    parseJobs_ = static_cast<uint32_t>(value);
+}
+
 bool Option::ShouldGenStartConfig() const
 {
     return genStartCfg_;
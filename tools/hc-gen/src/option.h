@@ -41,6 +41,8 @@ public:
 
     bool ShouldGenMacroConfig() const;
 
+    bool ShouldGenTableConfig() const;
+
     bool ShouldGenBinaryConfig() const;
 
     bool ShouldGenStartConfig() const;
@@ -49,6 +51,10 @@ public:
 
     bool ShouldDecompile() const;
 
+    bool ShouldGenIndex() const;
+
+    uint32_t GetParseJobs() const;
+
     std::string GetSymbolPrefix();
 
     std::string GetSourceName();
@@ -70,18 +76,22 @@ private:
     bool ParseOptions(int argc, char *argv[]);
     void SetOptionError(bool shouldShowUsage = true);
     bool SetSourceOption(const char *srcName);
+    void SetParseJobs(const char *jobs);
 
     bool showUsage_ = false;
     bool showVersion_ = false;
     bool shouldAlign_ = false;
     bool shouldGenTextConfig_ = false;
     bool shouldGenMacroConfig_ = false;
+    bool shouldGenTableConfig_ = false;
     bool shouldGenByteCodeConfig_ = true;
     bool genStartCfg_ = false;
     bool showGenHexDump_ = false;
     bool shouldDecompile_ = false;
+    bool shouldGenIndex_ = false;
     bool verboseLog_ = false;
     bool optionError_ = false;
+    uint32_t parseJobs_ = 0;
     std::string symbolNamePrefix_;
     std::string sourceName_;
     std::string sourceNameBase_;
@@ -7,7 +7,11 @@
  */
 
 #include <algorithm>
+#include <atomic>
 #include <memory>
+#include <sstream>
+#include <system_error>
+#include <thread>
 
 #include "file.h"
 #include "logger.h"
@@ -88,35 +92,130 @@ std::shared_ptr<AstObject> Parser::ParseOneContent(const std::string &src, std::
     return rootNode;
 }
 
-std::list<std::shared_ptr<Ast>> Parser::ParseOne(const std::string &src)
+bool Parser::ParseUnitContent(const std::string &src, ParseUnit &unit)
 {
-    srcQueue_.push_back(src);
-
-    std::list<std::shared_ptr<Ast>> astList;
-    std::list<std::string> includeList;
+    srcQueue_.assign(1, src);
     CleanError();
 
-    std::shared_ptr<AstObject> rootNode = ParseOneContent(src, includeList);
+    unit.root = ParseOneContent(src, unit.includeList);
     /* hcs allows a file have only include list, but does not allow empty files */
-    if ((rootNode == nullptr && includeList.empty()) || errno_ != NOERR) {
-        return astList;
+    return (unit.root != nullptr || !unit.includeList.empty()) && errno_ == NOERR;
+}
+
+std::shared_ptr<ParseUnit> Parser::ParseUnitOf(const std::string &src)
+{
+    auto unit = std::make_shared<ParseUnit>();
+    std::ostringstream log;
+    std::ostream *output = Logger::Output();
+    Logger::Output() = &log;
+    Parser parser;
+    unit->ok = parser.ParseUnitContent(src, *unit);
+    Logger::Output() = output;
+    unit->log = log.str();
+    return unit;
+}
+
+static void ParseUnitsInParallel(const std::vector<std::string> &sources,
+    std::vector<std::shared_ptr<ParseUnit>> &units)
+{
+    uint32_t jobs = Option::Instance().GetParseJobs();
+    if (jobs == 0) {
+        jobs = std::max(std::thread::hardware_concurrency(), 1U);
+    }
+    size_t threadCount = std::min<size_t>(jobs, sources.size()) - 1;
+    std::atomic<size_t> next(0);
+    auto worker = [&sources, &units, &next]() {
+        for (size_t i = next++; i < sources.size(); i = next++) {
+            units[i] = Parser::ParseUnitOf(sources[i]);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < threadCount; i++) {
+        try {
+            threads.emplace_back(worker);
+        } catch (const std::system_error &) {
+            break; // the threads started and this one take the rest
+        }
+    }
+    worker();
+    for (auto &thread : threads) {
+        thread.join();
+    }
+}
+
+/*
+ * Parses src and everything it includes, one include level at a time, the files of a level in
+ * parallel. Each file is parsed once here however often it is included.
+ */
+void Parser::ParseUnits(const std::string &src, ParseUnitMap &units)
+{
+    std::vector<std::string> level {src};
+    units.emplace(src, nullptr);
+    while (!level.empty()) {
+        std::vector<std::shared_ptr<ParseUnit>> parsed(level.size());
+        ParseUnitsInParallel(level, parsed);
+
+        std::vector<std::string> nextLevel;
+        for (size_t i = 0; i < level.size(); i++) {
+            units[level[i]] = parsed[i];
+            if (!parsed[i]->ok) {
+                continue;
+            }
+            for (auto &includeSrc : parsed[i]->includeList) {
+                if (units.emplace(includeSrc, nullptr).second) {
+                    nextLevel.push_back(includeSrc);
+                }
+            }
+        }
+        level.swap(nextLevel);
+    }
+}
+
+/*
+ * Walks the includes depth first as a serial parse would, so logs, errors and the order of the
+ * ast list do not depend on how the files were parsed.
+ */
+bool Parser::AssembleOne(const std::string &src, ParseUnitMap &units, std::list<std::shared_ptr<Ast>> &astList)
+{
+    srcQueue_.push_back(src);
+
+    auto &unit = units[src];
+    if (unit == nullptr || unit->taken) {
+        // merging consumes the ast of a file, one included again is parsed again
+        unit = ParseUnitOf(src);
+    }
+    unit->taken = true;
+    *Logger::Output() << unit->log;
+    if (!unit->ok) {
+        return false;
     }
 
-    for (auto includeSrc : includeList) {
+    for (auto &includeSrc : unit->includeList) {
         if (!CheckCycleInclude(includeSrc)) {
             Logger().Error() << src << " circular include " << includeSrc;
-            return std::list<std::shared_ptr<Ast>>();
+            return false;
         }
-        auto includeAstList = ParseOne(includeSrc);
-        if (includeAstList.empty()) {
-            return std::list<std::shared_ptr<Ast>>();
+        if (!AssembleOne(includeSrc, units, astList)) {
+            return false;
         }
-        astList.splice(astList.end(), includeAstList);
     }
     srcQueue_.pop_back();
-    auto oneAst = std::make_shared<Ast>(rootNode);
+    auto oneAst = std::make_shared<Ast>(unit->root);
     oneAst->Dump(src);
     astList.emplace_back(oneAst);
+    return true;
+}
+
+std::list<std::shared_ptr<Ast>> Parser::ParseOne(const std::string &src)
+{
+    ParseUnitMap units;
+    ParseUnits(src, units);
+
+    std::list<std::shared_ptr<Ast>> astList;
+    if (!AssembleOne(src, units, astList)) {
+        return std::list<std::shared_ptr<Ast>>();
+    }
     return astList;
 }
 
@@ -181,6 +280,7 @@ std::shared_ptr<AstObject> Parser::ParseNode(Token &name, bool bracesStart)
 
     auto node = std::make_shared<ConfigNode>(name, NODE_NOREF, "");
     std::shared_ptr<AstObject> child;
+    std::shared_ptr<AstObject> lastChild;
     while (lexer_.Lex(current_) && current_ != '}') {
         switch (current_.type) {
             case TEMPLATE:
@@ -198,7 +298,13 @@ std::shared_ptr<AstObject> Parser::ParseNode(Token &name, bool bracesStart)
             return nullptr;
         }
 
-        node->AddChild(child);
+        // append after the last child instead of walking all children of large nodes again
+        if (lastChild == nullptr) {
+            node->AddChild(child);
+        } else {
+            lastChild->AddPeer(child);
+        }
+        lastChild = child;
     }
 
     if (current_ != '}') {
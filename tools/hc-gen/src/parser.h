@@ -9,13 +9,25 @@
 #ifndef HC_GEN_PARSER_H
 #define HC_GEN_PARSER_H
 
+#include <map>
 #include <memory>
+#include <vector>
 
 #include "ast.h"
 #include "lexer.h"
 
 namespace OHOS {
 namespace Hardware {
+/* One source file parsed without its includes, with the console output of parsing it. */
+struct ParseUnit {
+    std::shared_ptr<AstObject> root;
+    std::list<std::string> includeList;
+    std::string log;
+    bool ok = false;
+    bool taken = false;
+};
+
+using ParseUnitMap = std::map<std::string, std::shared_ptr<ParseUnit>>;
 
 class Parser {
 public:
@@ -31,7 +43,15 @@ public:
 
     std::shared_ptr<Ast> GetAst();
 
+    static std::shared_ptr<ParseUnit> ParseUnitOf(const std::string &src);
+
 private:
+    bool ParseUnitContent(const std::string &src, ParseUnit &unit);
+
+    static void ParseUnits(const std::string &src, ParseUnitMap &units);
+
+    bool AssembleOne(const std::string &src, ParseUnitMap &units, std::list<std::shared_ptr<Ast>> &astList);
+
     bool ProcessInclude(std::list<std::string> &includeList);
 
     bool CheckCycleInclude(const std::string &includeSrc);
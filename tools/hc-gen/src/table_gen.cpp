@@ -0,0 +1,396 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ *
+ * HDF is dual licensed: you can use it either under the terms of
+ * the GPL, or the BSD license, at your option.
+ * See the LICENSE file in the root of this repository for complete details.
+ */
+
+#include "table_gen.h"
+
+#include <algorithm>
+#include <numeric>
+#include <sstream>
+
+#include "file.h"
+#include "logger.h"
+
+using namespace OHOS::Hardware;
+
+constexpr static const char *FILE_HEAD_COMMENT =
+    "/*\n"
+    " * This is an automatically generated HDF config file. Do not modify it manually.\n"
+    " */\n\n";
+
+static constexpr const char *HCS_MATCH_ATTR = "match_attr";
+static constexpr uint32_t TABLE_COUNT_MAX = UINT16_MAX;
+static constexpr uint32_t ELEMENT_PER_LINE = 8;
+static constexpr uint32_t TABLE_NONE = UINT32_MAX;
+
+TableGen::TableGen(std::shared_ptr<Ast> ast) : Generator(ast) {}
+
+bool TableGen::Output()
+{
+    if (!Initialize() || !TemplateNodeSeparate() || !Collect()) {
+        return false;
+    }
+
+    if (!ImplOutput()) {
+        Logger().Error() << "failed to write file: " << outFileName_;
+        return false;
+    }
+    return true;
+}
+
+bool TableGen::Initialize()
+{
+    std::string outFileName = Option::Instance().GetOutputName();
+    if (outFileName.empty()) {
+        outFileName = Option::Instance().GetSourceNameBase();
+    }
+    outFileName_ = Util::File::StripSuffix(outFileName).append(".c");
+
+    prefix_ = Option::Instance().GetSymbolPrefix();
+    prefix_.append(prefix_.empty() ? "hcsTable" : "HcsTable");
+
+    ofs_.open(outFileName_, std::ofstream::out | std::ofstream::binary);
+    if (!ofs_.is_open()) {
+        Logger().Error() << "failed to open output file: " << outFileName_;
+        return false;
+    }
+    Logger().Debug() << "output: " << outFileName_ << '\n';
+    return true;
+}
+
+bool TableGen::TemplateNodeSeparate()
+{
+    return ast_->WalkBackward([](std::shared_ptr<AstObject> &object, int32_t) {
+        if (object->IsNode() && ConfigNode::CastFrom(object)->GetNodeType() == NODE_TEMPLATE) {
+            object->Separate();
+        }
+        return NOERR;
+    });
+}
+
+/* Numbers nodes breadth first, so the children of every node are adjacent in the node table. */
+bool TableGen::Collect()
+{
+    auto root = ast_->GetAstRoot();
+    if (root == nullptr || !root->IsNode()) {
+        return false;
+    }
+    nodes_.push_back({root, TABLE_NONE, 0, 0, 0, 0, 0});
+    nodeIds_[root.get()] = 0;
+    for (uint32_t id = 0; id < nodes_.size(); id++) {
+        if (!CollectChildren(id)) {
+            return false;
+        }
+    }
+
+    for (uint32_t id = 0; id < nodes_.size(); id++) {
+        if (!CollectAttrs(id)) {
+            return false;
+        }
+    }
+    return CollectMatches();
+}
+
+bool TableGen::CollectChildren(uint32_t nodeId)
+{
+    auto firstChild = static_cast<uint32_t>(nodes_.size());
+    std::vector<std::shared_ptr<AstObject>> children;
+    for (auto child = nodes_[nodeId].object->Child(); child != nullptr; child = child->Next()) {
+        if (!child->IsNode()) {
+            continue;
+        }
+        // the child count and the child indexes are uint16_t in the tables, reject as for array elements
+        if (children.size() == TABLE_COUNT_MAX) {
+            Logger().Error() << nodes_[nodeId].object->SourceInfo() << "too many child nodes for table config";
+            return false;
+        }
+        nodeIds_[child.get()] = static_cast<uint32_t>(nodes_.size());
+        nodes_.push_back({child, nodeId, 0, 0, 0, 0, 0});
+        children.push_back(child);
+    }
+
+    std::vector<uint16_t> order(children.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(),
+        [&children](uint16_t a, uint16_t b) { return children[a]->Name() < children[b]->Name(); });
+
+    auto &node = nodes_[nodeId];
+    node.firstChild = children.empty() ? TABLE_NONE : firstChild;
+    node.childCount = static_cast<uint16_t>(children.size());
+    node.firstChildIndex = static_cast<uint32_t>(childIndexes_.size());
+    childIndexes_.insert(childIndexes_.end(), order.begin(), order.end());
+    return true;
+}
+
+bool TableGen::CollectAttrs(uint32_t nodeId)
+{
+    std::vector<std::shared_ptr<AstObject>> terms;
+    for (auto child = nodes_[nodeId].object->Child(); child != nullptr; child = child->Next()) {
+        if (child->IsTerm()) {
+            terms.push_back(child);
+        }
+    }
+    // attributes are looked up by binary search, a duplicated name keeps the last value as the tree does
+    std::stable_sort(terms.begin(), terms.end(),
+        [](const std::shared_ptr<AstObject> &a, const std::shared_ptr<AstObject> &b) { return a->Name() < b->Name(); });
+    auto last = std::unique(terms.rbegin(), terms.rend(),
+        [](const std::shared_ptr<AstObject> &a, const std::shared_ptr<AstObject> &b) {
+            return a->Name() == b->Name();
+        });
+    terms.erase(terms.begin(), last.base());
+    // counted once duplicates are dropped, the attribute count is a uint16_t in the tables
+    if (terms.size() > TABLE_COUNT_MAX) {
+        Logger().Error() << nodes_[nodeId].object->SourceInfo() << "too many attributes for table config";
+        return false;
+    }
+
+    nodes_[nodeId].firstAttr = static_cast<uint32_t>(attrs_.size());
+    nodes_[nodeId].attrCount = static_cast<uint16_t>(terms.size());
+    for (auto &term : terms) {
+        auto value = term->Child();
+        std::string data = "NULL";
+        switch (value->Type()) {
+            case PARSEROP_STRING:
+                data = StringToLiteral(value->StringValue());
+                break;
+            case PARSEROP_ARRAY:
+                if (!CollectArray(value, data)) {
+                    return false;
+                }
+                break;
+            case PARSEROP_NODEREF: {
+                auto refNode = ConfigTerm::CastFrom(term)->RefNode().lock();
+                auto ref = nodeIds_.find(refNode.get());
+                if (ref == nodeIds_.end()) {
+                    Logger().Error() << term->SourceInfo() << "reference node not found in table config";
+                    return false;
+                }
+                data = NodeRef(ref->second);
+                break;
+            }
+            default:
+                break;
+        }
+        attrs_.push_back({term, data});
+    }
+    return true;
+}
+
+bool TableGen::CollectArray(const std::shared_ptr<AstObject> &array, std::string &data)
+{
+    // the element count of an attribute is a uint16_t in the tables, count here as ArraySize() wraps
+    uint32_t count = 0;
+    for (auto element = array->Child(); element != nullptr; element = element->Next()) {
+        if (++count > TABLE_COUNT_MAX) {
+            Logger().Error() << array->SourceInfo() << "too many array elements for table config";
+            return false;
+        }
+    }
+    auto type = ConfigArray::CastFrom(array)->ArrayType();
+    auto &pool = pools_[type];
+    auto offset = pool.size();
+    for (auto element = array->Child(); element != nullptr; element = element->Next()) {
+        pool.push_back(type == PARSEROP_STRING ? StringToLiteral(element->StringValue()) :
+            IntegerToStr(element->IntegerValue()));
+    }
+
+    static const std::map<uint32_t, std::string> poolNames = {
+        {PARSEROP_UINT8, "Uint8Pool"},
+        {PARSEROP_UINT16, "Uint16Pool"},
+        {PARSEROP_UINT32, "Uint32Pool"},
+        {PARSEROP_UINT64, "Uint64Pool"},
+        {PARSEROP_STRING, "StringPool"},
+    };
+    data = "&" + SymbolName(poolNames.at(type)) + "[" + std::to_string(offset) + "]";
+    return true;
+}
+
+/* Nodes with the same match_attr keep the preorder of the tree, so lookups find the one the tree finds. */
+bool TableGen::CollectMatches()
+{
+    ast_->WalkForward([this](std::shared_ptr<AstObject> &object, int32_t) {
+        if (object->IsTerm() && object->Name() == HCS_MATCH_ATTR && object->Child()->Type() == PARSEROP_STRING) {
+            auto node = nodeIds_.find(object->Parent().get());
+            if (node != nodeIds_.end()) {
+                matches_.emplace_back(object->Child()->StringValue(), node->second);
+            }
+        }
+        return NOERR;
+    });
+    std::stable_sort(matches_.begin(), matches_.end(),
+        [](const std::pair<std::string, uint32_t> &a, const std::pair<std::string, uint32_t> &b) {
+            return a.first < b.first;
+        });
+    return true;
+}
+
+bool TableGen::ImplOutput()
+{
+    ofs_ << FILE_HEAD_COMMENT;
+    ofs_ << "#include \"hcs_table.h\"\n\n";
+    ofs_ << "static const struct HcsTableNode " << SymbolName("Nodes") << "[" << nodes_.size() << "];\n\n";
+
+    PoolOutput("uint8_t", "Uint8Pool", pools_[PARSEROP_UINT8]);
+    PoolOutput("uint16_t", "Uint16Pool", pools_[PARSEROP_UINT16]);
+    PoolOutput("uint32_t", "Uint32Pool", pools_[PARSEROP_UINT32]);
+    PoolOutput("uint64_t", "Uint64Pool", pools_[PARSEROP_UINT64]);
+    PoolOutput("char *const", "StringPool", pools_[PARSEROP_STRING]);
+    std::vector<std::string> childIndexes;
+    for (auto index : childIndexes_) {
+        childIndexes.push_back(std::to_string(index));
+    }
+    PoolOutput("uint16_t", "ChildIndex", childIndexes);
+
+    AttrsOutput();
+    NodesOutput();
+    TableOutput();
+    ofs_.close();
+    return ofs_.good();
+}
+
+void TableGen::PoolOutput(const std::string &type, const std::string &name, const std::vector<std::string> &pool)
+{
+    if (pool.empty()) {
+        return;
+    }
+    ofs_ << "static const " << type << ' ' << SymbolName(name) << "[] = {";
+    for (size_t i = 0; i < pool.size(); i++) {
+        ofs_ << ((i % ELEMENT_PER_LINE == 0) ? "\n" TAB : " ") << pool[i] << ',';
+    }
+    ofs_ << "\n};\n\n";
+}
+
+void TableGen::AttrsOutput()
+{
+    if (attrs_.empty()) {
+        return;
+    }
+    ofs_ << "static const struct HcsTableAttr " << SymbolName("Attrs") << "[] = {\n";
+    for (auto &node : nodes_) {
+        for (uint32_t i = node.firstAttr; i < node.firstAttr + node.attrCount; i++) {
+            auto &attr = attrs_[i];
+            auto value = attr.term->Child();
+            uint32_t type = value->Type();
+            uint64_t integer = 0;
+            uint32_t count = 1;
+            bool isArray = false;
+            if (type == PARSEROP_ARRAY) {
+                type = ConfigArray::CastFrom(value)->ArrayType();
+                count = ConfigArray::CastFrom(value)->ArraySize();
+                isArray = true;
+            } else if (type <= PARSEROP_UINT64) {
+                integer = value->IntegerValue();
+            }
+            static const std::map<uint32_t, std::string> typeNames = {
+                {PARSEROP_UINT8, "HCS_TABLE_UINT8"},
+                {PARSEROP_UINT16, "HCS_TABLE_UINT16"},
+                {PARSEROP_UINT32, "HCS_TABLE_UINT32"},
+                {PARSEROP_UINT64, "HCS_TABLE_UINT64"},
+                {PARSEROP_STRING, "HCS_TABLE_STRING"},
+                {PARSEROP_NODEREF, "HCS_TABLE_REF"},
+            };
+            ofs_ << TAB << "{ \"" << attr.term->Name() << "\", " << attr.data << ", " << IntegerToStr(integer) << ", "
+                 << count << ", " << typeNames.at(type) << ", " << (isArray ? 1 : 0) << " },\n";
+        }
+    }
+    ofs_ << "};\n\n";
+}
+
+void TableGen::NodesOutput()
+{
+    ofs_ << "static const struct HcsTableNode " << SymbolName("Nodes") << "[" << nodes_.size() << "] = {\n";
+    for (uint32_t id = 0; id < nodes_.size(); id++) {
+        auto &node = nodes_[id];
+        ofs_ << TAB << "{ \"" << node.object->Name() << "\", "
+             << (node.parent == TABLE_NONE ? "NULL" : NodeRef(node.parent)) << ", "
+             << (node.attrCount == 0 ? "NULL" : "&" + SymbolName("Attrs") + "[" + std::to_string(node.firstAttr) + "]")
+             << ", " << (node.childCount == 0 ? "NULL" : NodeRef(node.firstChild)) << ", "
+             << (node.childCount == 0 ? "NULL" :
+                 "&" + SymbolName("ChildIndex") + "[" + std::to_string(node.firstChildIndex) + "]")
+             << ", " << node.attrCount << ", " << node.childCount << " },\n";
+    }
+    ofs_ << "};\n\n";
+}
+
+void TableGen::TableOutput()
+{
+    if (!matches_.empty()) {
+        ofs_ << "static const struct HcsTableMatch " << SymbolName("Matches") << "[] = {\n";
+        for (auto &match : matches_) {
+            ofs_ << TAB << "{ " << StringToLiteral(match.first) << ", " << NodeRef(match.second) << " },\n";
+        }
+        ofs_ << "};\n\n";
+    }
+
+    ofs_ << "static const struct HcsTable " << SymbolName("") << " = {\n"
+         << TAB << NodeRef(0) << ",\n"
+         << TAB << (matches_.empty() ? "NULL" : SymbolName("Matches")) << ",\n"
+         << TAB << matches_.size() << ",\n"
+         << TAB << nodes_.size() << ",\n"
+         << "};\n\n";
+
+    ofs_ << "const struct HcsTable *HdfGetBuildInConfigTable(void)\n"
+         << "{\n"
+         << TAB << "return &" << SymbolName("") << ";\n"
+         << "}\n";
+}
+
+std::string TableGen::SymbolName(const std::string &name) const
+{
+    return "g_" + prefix_ + name;
+}
+
+std::string TableGen::NodeRef(uint32_t nodeId) const
+{
+    return "&" + SymbolName("Nodes") + "[" + std::to_string(nodeId) + "]";
+}
+
+std::string TableGen::IntegerToStr(uint64_t value)
+{
+    std::stringstream str;
+    str << "0x" << std::hex << value;
+    return str.str();
+}
+
+/* Strings of the source are taken verbatim up to the closing quote, so they may hold backslashes and line breaks. */
+std::string TableGen::StringToLiteral(const std::string &value)
+{
+    std::stringstream str;
+    str << '"';
+    for (unsigned char c : value) {
+        switch (c) {
+            case '"':
+                str << "\\\"";
+                break;
+            case '\\':
+                str << "\\\\";
+                break;
+            case '\n':
+                str << "\\n";
+                break;
+            case '\t':
+                str << "\\t";
+                break;
+            case '\r':
+                str << "\\r";
+                break;
+            case '?': // keep "??" from being read as a trigraph
+                str << "\\?";
+                break;
+            default:
+                if (c < ' ' || c >= 0x7f) {
+                    // three octal digits, so a following digit is not taken into the escape
+                    str << '\\' << std::oct << ((c >> 6) & 0x7) << ((c >> 3) & 0x7) << (c & 0x7) << std::dec;
+                } else {
+                    str << c;
+                }
+                break;
+        }
+    }
+    str << '"';
+    return str.str();
+}
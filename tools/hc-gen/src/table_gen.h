@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ *
+ * HDF is dual licensed: you can use it either under the terms of
+ * the GPL, or the BSD license, at your option.
+ * See the LICENSE file in the root of this repository for complete details.
+ */
+
+#ifndef HC_GEN_TABLE_GEN_H
+#define HC_GEN_TABLE_GEN_H
+
+#include <fstream>
+#include <map>
+#include <vector>
+
+#include "generator.h"
+
+namespace OHOS {
+namespace Hardware {
+/* Outputs the config as the const tables of include/utils/hcs_table.h. */
+class TableGen : public Generator {
+public:
+    explicit TableGen(std::shared_ptr<Ast> ast);
+
+    ~TableGen() override = default;
+
+    bool Output() override;
+
+private:
+    struct TableNode {
+        std::shared_ptr<AstObject> object;
+        uint32_t parent;
+        uint32_t firstChild;
+        uint16_t childCount; // the counts and child indexes are uint16_t in the tables
+        uint32_t firstAttr;
+        uint16_t attrCount;
+        uint32_t firstChildIndex;
+    };
+
+    struct TableAttr {
+        std::shared_ptr<AstObject> term;
+        std::string data;
+    };
+
+    bool Initialize();
+
+    bool TemplateNodeSeparate();
+
+    bool Collect();
+
+    bool CollectAttrs(uint32_t nodeId);
+
+    bool CollectChildren(uint32_t nodeId);
+
+    bool CollectArray(const std::shared_ptr<AstObject> &array, std::string &data);
+
+    bool CollectMatches();
+
+    bool ImplOutput();
+
+    void PoolOutput(const std::string &type, const std::string &name, const std::vector<std::string> &pool);
+
+    void AttrsOutput();
+
+    void NodesOutput();
+
+    void TableOutput();
+
+    std::string SymbolName(const std::string &name) const;
+
+    std::string NodeRef(uint32_t nodeId) const;
+
+    static std::string IntegerToStr(uint64_t value);
+
+    static std::string StringToLiteral(const std::string &value);
+
+    std::ofstream ofs_;
+    std::string outFileName_;
+    std::string prefix_;
+    std::vector<TableNode> nodes_;
+    std::map<const AstObject *, uint32_t> nodeIds_;
+    std::vector<TableAttr> attrs_;
+    std::vector<uint16_t> childIndexes_;
+    std::map<uint32_t, std::vector<std::string>> pools_;
+    std::vector<std::pair<std::string, uint32_t>> matches_;
+};
+} // namespace Hardware
+} // namespace OHOS
+#endif // HC_GEN_TABLE_GEN_H
@@ -0,0 +1,131 @@
+#!/usr/bin/env python
+# coding: utf-8
+#
+# Copyright (c) 2022 Huawei Device Co., Ltd.
+#
+# HDF is dual licensed: you can use it either under the terms of
+# the GPL, or the BSD license, at your option.
+# See the LICENSE file in the root of this repository for complete details.
+
+"""Measures hc-gen compile time on a large generated hcs tree.
+
+The tree is a root file including group files, which include leaf files
+and one common file shared by all groups. It is compiled with one parse
+job and with the given parse jobs, both must produce the same hcb.
+"""
+
+import argparse
+import multiprocessing
+import os
+import shutil
+import statistics
+import subprocess
+import sys
+import tempfile
+import time
+
+
+def write_leaf(path, group, leaf, nodes, terms):
+    lines = ['root {', '    module = "bench";',
+             '    leaf_%d_%d {' % (group, leaf)]
+    for node in range(nodes):
+        lines.append('        node_%d {' % node)
+        for term in range(terms):
+            lines.append('            term_%d = %d;' %
+                         (term, (group * 7919 + leaf * 104729 + node * 31 +
+                                 term) & 0xffffffff))
+        lines.append('            name = "leaf_%d_%d_node_%d";' %
+                     (group, leaf, node))
+        lines.append('            values = [%d, %d, %d, %d];' %
+                     (node, terms, leaf, group))
+        lines.append('        }')
+    lines += ['    }', '}', '']
+    with open(path, 'w') as file:
+        file.write('\n'.join(lines))
+
+
+def generate_tree(work_dir, groups, leaves, nodes, terms):
+    with open(os.path.join(work_dir, 'common.hcs'), 'w') as file:
+        file.write('root {\n    module = "bench";\n'
+                   '    common {\n        version = 1;\n    }\n}\n')
+
+    root = []
+    for group in range(groups):
+        group_name = 'group_%d.hcs' % group
+        root.append('#include "%s"' % group_name)
+        lines = ['#include "common.hcs"']
+        for leaf in range(leaves):
+            leaf_name = 'leaf_%d_%d.hcs' % (group, leaf)
+            lines.append('#include "%s"' % leaf_name)
+            write_leaf(os.path.join(work_dir, leaf_name), group, leaf,
+                       nodes, terms)
+        lines += ['root {', '    group_%d {' % group,
+                  '        id = %d;' % group, '    }', '}', '']
+        with open(os.path.join(work_dir, group_name), 'w') as file:
+            file.write('\n'.join(lines))
+    root += ['root {', '    module = "bench";', '}', '']
+    root_path = os.path.join(work_dir, 'root.hcs')
+    with open(root_path, 'w') as file:
+        file.write('\n'.join(root))
+    return root_path
+
+
+def compile_once(hcgen, source, output, extra_args):
+    start = time.time()
+    result = subprocess.run([hcgen] + extra_args + ['-o', output, source],
+                            stdout=subprocess.PIPE, stderr=subprocess.STDOUT)
+    cost = (time.time() - start) * 1000
+    if result.returncode != 0:
+        print(result.stdout.decode(errors='replace'))
+        raise RuntimeError('hc-gen failed with %s' % ' '.join(extra_args))
+    with open(output + '.hcb', 'rb') as file:
+        return cost, file.read()
+
+
+def bench(hcgen, source, output, rounds, extra_args):
+    costs = []
+    blob = None
+    for _ in range(rounds):
+        cost, blob = compile_once(hcgen, source, output, extra_args)
+        costs.append(cost)
+    return statistics.median(costs), blob
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument('hcgen', help='path of the hc-gen binary')
+    parser.add_argument('--groups', type=int, default=16)
+    parser.add_argument('--leaves', type=int, default=16)
+    parser.add_argument('--nodes', type=int, default=20)
+    parser.add_argument('--terms', type=int, default=16)
+    parser.add_argument('--rounds', type=int, default=5)
+    parser.add_argument('--jobs', type=int,
+                        default=multiprocessing.cpu_count())
+    args = parser.parse_args()
+
+    hcgen = os.path.abspath(args.hcgen)
+    work_dir = tempfile.mkdtemp(prefix='hcgen_bench_')
+    try:
+        source = generate_tree(work_dir, args.groups, args.leaves,
+                               args.nodes, args.terms)
+        output = os.path.join(work_dir, 'out')
+        size = sum(os.path.getsize(os.path.join(work_dir, name))
+                   for name in os.listdir(work_dir) if name.endswith('.hcs'))
+        print('%d files, %.1f KB of hcs' %
+              (args.groups * (args.leaves + 1) + 2, size / 1024.0))
+
+        serial_cost, serial_blob = bench(hcgen, source, output, args.rounds,
+                                         ['-j', '1'])
+        print('%-8s jobs %3d: %8.1f ms' % ('serial', 1, serial_cost))
+        cost, blob = bench(hcgen, source, output, args.rounds,
+                           ['-j', str(args.jobs)])
+        print('%-8s jobs %3d: %8.1f ms%s' %
+              ('parallel', args.jobs, cost,
+               '' if blob == serial_blob else '  (output differs)'))
+        return 0 if blob == serial_blob else 1
+    finally:
+        shutil.rmtree(work_dir)
+
+
+if __name__ == '__main__':
+    sys.exit(main())
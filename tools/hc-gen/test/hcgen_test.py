@@ -145,6 +145,10 @@ def test_compile(case_name, mode):
 
     if mode == 'text':
         command = "%s -o %s -t  %s" % (HCGEN, output_file, source_file)
+    elif mode == 'table':
+        command = "%s -o %s -c %s" % (HCGEN, output_file, source_file)
+    elif mode == 'index':
+        command = "%s -o %s_index -x %s" % (HCGEN, output_file, source_file)
     else:
         command = "%s -o %s %s" % (HCGEN, output_file, source_file)
 
@@ -217,6 +221,59 @@ def test_text_code_compile(case_name):
     return c_file_compare and header_file_compare
 
 
+def test_table_code_compile(case_name):
+    golden_result_file = os.path.join(WORK_DIR, case_name,
+                                      'golden_table_compile_result.txt')
+    if not os.path.exists(golden_result_file):
+        return True
+
+    compile_result = test_compile(case_name, 'table')
+    if not compile_result:
+        return False
+
+    case_c_file = os.path.join(WORK_DIR, TEMP_DIR, case_name, 'golden.c')
+    golden_c_file = os.path.join(WORK_DIR, case_name, 'golden_table.c.gen')
+    c_file_compare = text_file_compare(case_c_file, golden_c_file)
+    if not c_file_compare:
+        print("Error: The generated table C file mismatch with golden")
+    return c_file_compare
+
+
+def test_index_code_compile(case_name):
+    golden_result_file = os.path.join(WORK_DIR, case_name,
+                                      'golden_index_compile_result.txt')
+    if not os.path.exists(golden_result_file):
+        return True
+
+    compile_result = test_compile(case_name, 'index')
+    if not compile_result:
+        return False
+
+    case_hcb = os.path.join(WORK_DIR, TEMP_DIR, case_name, 'golden_index.hcb')
+    golden_hcb = os.path.join(WORK_DIR, case_name, 'golden_index.hcb')
+    hcb_header_size = 20  # hcb compare skip hcb header
+    if not binary_file_compare(case_hcb, golden_hcb, hcb_header_size, True):
+        print('Error: indexed hcb output mismatch with golden')
+        return False
+
+    # the index is invisible to the decompiler
+    output_file = os.path.join(WORK_DIR, TEMP_DIR, case_name, 'case_index.hcs')
+    command = "%s -o %s -d %s" % (HCGEN, output_file, case_hcb)
+    status, output = exec_command(command)
+    if status != 0:
+        print('decompile indexed hcb fail')
+        print(output)
+        return False
+    case_decompile_file = \
+        os.path.join(WORK_DIR, TEMP_DIR, case_name, 'case_index.d.hcs')
+    golden_decompile_file = os.path.join(WORK_DIR, case_name, 'golden.d.hcs')
+    if not text_file_compare(case_decompile_file, golden_decompile_file):
+        print('Error: case %s decompile indexed hcb mismatch with golden'
+              % case_name)
+        return False
+    return True
+
+
 def test_decompile(case_name):
     golden_decompile_file_name = \
         os.path.join(WORK_DIR, case_name, 'golden.d.hcs')
@@ -257,9 +314,12 @@ def test_cases(cases):
         print('[ RUN      ] %s' % case)
         binary_compile_result = binary_code_compile(case)
         text_compile_result = test_text_code_compile(case)
+        table_compile_result = test_table_code_compile(case)
+        index_compile_result = test_index_code_compile(case)
         case_finish_time = get_current_time_ms()
         used_time_str = ' (%d ms)' % (case_finish_time - case_start_time)
-        if (not binary_compile_result) or (not text_compile_result):
+        if (not binary_compile_result) or (not text_compile_result) or \
+                (not table_compile_result) or (not index_compile_result):
             print('[    ERROR ] %s%s' % (case, used_time_str))
             failed_cases.append(case)
         else:
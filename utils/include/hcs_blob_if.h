@@ -33,6 +33,7 @@ struct HbcHeader {
 #define HBC_HEADER_LENGTH sizeof(struct HbcHeader)
 #define HBC_BLOB_MAX_LENGTH (1024 * 1024 * 10) // The maximum length is 10 MB.
 #define HBC_ROOT_NAME "root"
+#define HBC_INDEX_VERSION_MINOR 8 // first hc-gen version able to append a lookup index
 
 bool HcsIsByteAlign(void);
 #define HCS_ALIGN_SIZE 4
@@ -77,6 +78,8 @@ int32_t HcsGetAttrLength(const char *start);
 int32_t HcsGetNodeOrAttrLength(const char *start);
 int32_t HcsGetNodeLength(const char *blob);
 bool HcsCheckBlobFormat(const char *start, uint32_t length);
+/* Returns the offset of the lookup index appended to a checked blob, or 0 if it has none. */
+uint32_t HcsGetBlobIndexOffset(const char *start, uint32_t length);
 bool HcsSwapToUint8(uint8_t *value, const char *realValue, uint32_t type);
 bool HcsSwapToUint16(uint16_t *value, const char *realValue, uint32_t type);
 bool HcsSwapToUint32(uint32_t *value, const char *realValue, uint32_t type);
@@ -21,6 +21,7 @@ extern "C" {
 #define HCS_MATCH_ATTR "match_attr"
 
 const struct DeviceResourceNode *HcsGetRootNode(void);
+const struct DeviceResourceNode *HcsBlobGetRootNode(void);
 bool HcsGetBool(const struct DeviceResourceNode *node, const char *attrName);
 int32_t HcsGetUint8(const struct DeviceResourceNode *node, const char *attrName, uint8_t *value, uint8_t def);
 int32_t HcsGetUint8ArrayElem(const struct DeviceResourceNode *node, const char *attrName, uint32_t index,
@@ -47,6 +48,8 @@ int32_t HcsGetStringArrayElem(const struct DeviceResourceNode *node, const char
 int32_t HcsGetString(const struct DeviceResourceNode *node, const char *attrName, const char **value, const char *def);
 int32_t HcsGetElemNum(const struct DeviceResourceNode *node, const char *attrName);
 const struct DeviceResourceNode *HcsGetNodeByMatchAttr(const struct DeviceResourceNode *node, const char *attrValue);
+const struct DeviceResourceNode *HcsBlobGetNodeByMatchAttr(const struct DeviceResourceNode *node,
+    const char *attrValue);
 const struct DeviceResourceNode *HcsGetChildNode(const struct DeviceResourceNode *node, const char *nodeName);
 const struct DeviceResourceNode *HcsGetNodeByRefAttr(const struct DeviceResourceNode *node, const char *attrName);
 
@@ -16,21 +16,40 @@ extern "C" {
 #endif /* __cplusplus */
 
 struct MapNode;
+struct MapTable;
+
+enum MapType {
+    MAP_TYPE_CHAINED = 0, /**< Buckets of chained nodes, each node allocated on its own */
+    MAP_TYPE_OPEN,        /**< Open addressing over groups of control bytes, keys and values kept in slabs */
+};
 
 typedef struct {
     struct MapNode **nodes; /**< Map node bucket */
     uint32_t nodeSize; /**< Map node count */
     uint32_t bucketSize; /**< Map node bucket size */
+    uint32_t type; /**< Map type, see {@link MapType} */
+    struct MapTable *table; /**< Slot table of MAP_TYPE_OPEN */
 } Map;
 
 void MapInit(Map *map);
 
+/*
+ * Initializes a map of the given type. Value pointers returned by MapGet stay valid
+ * until the key is erased, whatever the type is.
+ */
+void MapInitWithType(Map *map, uint32_t type);
+
 void MapDelete(Map *map);
 
 int32_t MapSet(Map *map, const char *key, const void *value, uint32_t valueSize);
 
 void *MapGet(const Map *map, const char *key);
 
+/* Hash of a key, to look it up repeatedly with MapGetByHash without hashing it again. */
+uint32_t MapHashKey(const char *key);
+
+void *MapGetByHash(const Map *map, const char *key, uint32_t hash);
+
 int32_t MapErase(Map *map, const char *key);
 
 #ifdef __cplusplus
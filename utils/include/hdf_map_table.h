@@ -0,0 +1,31 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ *
+ * HDF is dual licensed: you can use it either under the terms of
+ * the GPL, or the BSD license, at your option.
+ * See the LICENSE file in the root of this repository for complete details.
+ */
+
+#ifndef HDF_MAP_TABLE_H
+#define HDF_MAP_TABLE_H
+
+#include "hdf_map.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/* Backend of MAP_TYPE_OPEN maps, callers validate parameters and pass the key hash from MapHashKey. */
+int32_t MapTableSet(Map *map, const char *key, uint32_t hash, const void *value, uint32_t valueSize);
+
+void *MapTableGet(const Map *map, const char *key, uint32_t hash);
+
+int32_t MapTableErase(Map *map, const char *key, uint32_t hash);
+
+void MapTableDelete(Map *map);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* HDF_MAP_TABLE_H */
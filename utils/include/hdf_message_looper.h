@@ -22,6 +22,7 @@ struct HdfMessageLooper {
     void (*Start)(struct HdfMessageLooper *);
     void (*Stop)(struct HdfMessageLooper *);
     bool isRunning;
+    bool drainAll; /* take all due messages per queue lock acquisition and dispatch them as a batch */
 };
 
 void HdfMessageLooperConstruct(struct HdfMessageLooper *looper);
@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ *
+ * HDF is dual licensed: you can use it either under the terms of
+ * the GPL, or the BSD license, at your option.
+ * See the LICENSE file in the root of this repository for complete details.
+ */
+
+#ifndef HDF_MPMC_QUEUE_H
+#define HDF_MPMC_QUEUE_H
+
+#include "hdf_base.h"
+#include "osal_atomic.h"
+#include "osal_sem.h"
+#include "osal_spinlock.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+#define HDF_MPMC_CACHE_LINE 64
+
+/*
+ * Bounded multi-producer multi-consumer ring. Producers and consumers each take their own lock, so
+ * push and pop never contend with each other. The free and filled slot counters let a full or empty
+ * ring be reported without taking a lock, and the value returning atomic op updating them inside the
+ * lock publishes the cell to the other side. The two sides are kept on separate cache lines.
+ */
+struct HdfMpmcQueue {
+    void **cells;
+    uint32_t mask;
+    uint8_t pad0[HDF_MPMC_CACHE_LINE - sizeof(void *) - sizeof(uint32_t)];
+    OsalSpinlock enqueueLock;
+    uint32_t enqueuePos;
+    OsalAtomic freeSlots;
+    uint8_t pad1[HDF_MPMC_CACHE_LINE - sizeof(OsalSpinlock) - sizeof(uint32_t) - sizeof(OsalAtomic)];
+    OsalSpinlock dequeueLock;
+    uint32_t dequeuePos;
+    OsalAtomic filledSlots;
+    uint8_t pad2[HDF_MPMC_CACHE_LINE - sizeof(OsalSpinlock) - sizeof(uint32_t) - sizeof(OsalAtomic)];
+    OsalAtomic waiters;
+    struct OsalSem sem;
+};
+
+/* Capacity is rounded up to a power of two. */
+int32_t HdfMpmcQueueInit(struct HdfMpmcQueue *queue, uint32_t capacity);
+
+void HdfMpmcQueueDestroy(struct HdfMpmcQueue *queue);
+
+/* Non-blocking push, returns false if the ring is full. @data must not be NULL. */
+bool HdfMpmcQueueTryPush(struct HdfMpmcQueue *queue, void *data);
+
+/* Non-blocking pop, returns NULL if the ring is empty. */
+void *HdfMpmcQueueTryPop(struct HdfMpmcQueue *queue);
+
+/* Pushes and wakes a consumer sleeping in HdfMpmcQueuePoll, returns HDF_ERR_QUEUE_FULL if the ring is full. */
+int32_t HdfMpmcQueueOffer(struct HdfMpmcQueue *queue, void *data);
+
+/*
+ * Pops, sleeping up to @timeout ms (or HDF_WAIT_FOREVER) only while the ring is empty.
+ * Returns NULL on timeout or when woken by HdfMpmcQueueWake, callers should loop.
+ */
+void *HdfMpmcQueuePoll(struct HdfMpmcQueue *queue, uint32_t timeout);
+
+/* Wakes one consumer sleeping in HdfMpmcQueuePoll, e.g. to make it check a stop flag. */
+void HdfMpmcQueueWake(struct HdfMpmcQueue *queue);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* HDF_MPMC_QUEUE_H */
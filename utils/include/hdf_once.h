@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ *
+ * HDF is dual licensed: you can use it either under the terms of
+ * the GPL, or the BSD license, at your option.
+ * See the LICENSE file in the root of this repository for complete details.
+ */
+
+#ifndef HDF_ONCE_H
+#define HDF_ONCE_H
+
+#include "hdf_base.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/*
+ * Runs an initializer once and publishes the object it returns. Callers arriving while it runs
+ * block on a mutex instead of spinning. The object is published after a full barrier, so anything
+ * the initializer wrote is visible to a caller that reaches it through the returned pointer.
+ */
+struct HdfOnce {
+    bool done;
+    void *volatile object;
+};
+
+#define HDF_ONCE_INIT { false, NULL }
+
+/* Returns the object to publish, or NULL if initialization failed. */
+typedef void *(*HdfOnceFunc)(void *arg);
+
+/*
+ * Returns the published object, running @func first if no caller has yet. A failed initialization
+ * is not retried. @func must not run another HdfOnce, they share one lock.
+ */
+void *HdfOnceRun(struct HdfOnce *once, HdfOnceFunc func, void *arg);
+
+/* Returns the published object, or NULL while it is not initialized. Never blocks. */
+static inline void *HdfOncePeek(const struct HdfOnce *once)
+{
+    return once->object;
+}
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* HDF_ONCE_H */
@@ -64,6 +64,9 @@ struct HdfSBufImpl {
     struct HdfSBufImpl *(*move)(struct HdfSBufImpl *sbuf);
     struct HdfSBufImpl *(*copy)(const struct HdfSBufImpl *sbuf);
     void (*transDataOwnership)(struct HdfSBufImpl *sbuf);
+    bool (*writeBufferRef)(struct HdfSBufImpl *sbuf, const uint8_t *data, uint32_t writeSize,
+        void (*release)(void *priv), void *priv);
+    bool (*linearize)(struct HdfSBufImpl *sbuf);
 };
 
 #ifdef __cplusplus
@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ *
+ * HDF is dual licensed: you can use it either under the terms of
+ * the GPL, or the BSD license, at your option.
+ * See the LICENSE file in the root of this repository for complete details.
+ */
+
+#ifndef HDF_SBUF_POOL_H
+#define HDF_SBUF_POOL_H
+
+#include "hdf_base.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+enum HdfSbufPoolCacheId {
+    SBUF_POOL_WRAPPER = 0,  /* struct HdfSBuf objects */
+    SBUF_POOL_RAW_IMPL,     /* struct HdfSBufRaw objects */
+    SBUF_POOL_DATA_256,     /* data blocks up to 256 bytes */
+    SBUF_POOL_DATA_1K,      /* data blocks up to 1 KB */
+    SBUF_POOL_DATA_4K,      /* data blocks up to 4 KB */
+    SBUF_POOL_DATA_64K,     /* data blocks up to 64 KB */
+    SBUF_POOL_DATA_512K,    /* data blocks up to 512 KB */
+    SBUF_POOL_CACHE_MAX,
+};
+
+struct HdfSbufPoolStat {
+    size_t blockSize;   /**< Block size of the cache, 0 for object caches sized by caller */
+    uint32_t limit;     /**< Max count of blocks kept in the cache */
+    uint32_t cached;    /**< Count of blocks currently kept in the cache */
+    uint32_t hit;       /**< Obtain requests served from the cache */
+    uint32_t miss;      /**< Obtain requests that fell back to heap allocation */
+    uint32_t overflow;  /**< Recycled blocks released to heap because the cache was full */
+};
+
+/*
+ * Returns the data cache fitting a capacity and its block size, or SBUF_POOL_CACHE_MAX
+ * if the capacity exceeds the largest class.
+ */
+uint32_t HdfSbufPoolDataClass(size_t capacity, size_t *blockSize);
+
+/*
+ * Obtains a block from a cache, allocating from heap on miss. Object caches allocate
+ * @size bytes on miss, data caches always allocate their class size.
+ * Blocks are not cleared when served from the cache.
+ */
+void *HdfSbufPoolObtain(uint32_t cacheId, size_t size);
+
+void HdfSbufPoolRecycle(uint32_t cacheId, void *block);
+
+int32_t HdfSbufPoolSetLimit(uint32_t cacheId, uint32_t limit);
+
+int32_t HdfSbufPoolGetStat(uint32_t cacheId, struct HdfSbufPoolStat *stat);
+
+void HdfSbufPoolDrain(void);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* HDF_SBUF_POOL_H */
@@ -10,10 +10,16 @@
 #define HDF_TASK_QUEUE_H
 
 #include "hdf_dlist.h"
+#include "hdf_mpmc_queue.h"
+#include "osal_atomic.h"
 #include "osal_sem.h"
 #include "osal_mutex.h"
 #include "osal_thread.h"
 
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
 struct HdfTaskType;
 typedef int32_t (*HdfTaskFunc)(struct HdfTaskType *para);
 
@@ -22,12 +28,17 @@ struct HdfTaskType {
     HdfTaskFunc func;
 };
 
+/*
+ * Tasks are passed through a lock-free ring and run on the queue thread without holding any lock.
+ * The mutex only guards thread start and the overflow list used while the ring is full.
+ */
 struct HdfTaskQueue {
-    struct OsalSem sem;
+    struct HdfMpmcQueue ring;
     struct OsalMutex mutex;
     struct DListHead head;
+    OsalAtomic overflowCount;
     struct OsalThread thread;
-    bool threadRunFlag;
+    OsalAtomic threadRunFlag;
     HdfTaskFunc queueFunc;
     const char *queueName;
 };
@@ -36,4 +47,8 @@ void HdfTaskEnqueue(struct HdfTaskQueue *queue, struct HdfTaskType *task);
 struct HdfTaskQueue *HdfTaskQueueCreate(HdfTaskFunc queueFunc, const char *name);
 void HdfTaskQueueDestroy(struct HdfTaskQueue *queue);
 
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
 #endif /* HDF_TASK_QUEUE_H */
\ No newline at end of file
@@ -19,10 +19,20 @@ struct HdfMessage {
     struct HdfSListNode entry;
     struct HdfMessageTask *target;
     int16_t messageId;
+    uint16_t flags;    /* HDF_MESSAGE_FLAG_* owned by the message allocator */
+    uint32_t sequence; /* enqueue order, breaks ties between messages due at the same time */
     uint64_t timeStamp;
     void *data[1];
 };
 
+#define HDF_MESSAGE_FLAG_SLAB 0x1
+
+/*
+ * Messages with up to HDF_MESSAGE_SLAB_EXTEND_SIZE bytes of extension are served from a
+ * fixed-size slab with a free list, larger ones fall back to heap allocation.
+ */
+#define HDF_MESSAGE_SLAB_EXTEND_SIZE 64
+
 struct HdfMessage *HdfMessageObtain(size_t extendSize);
 void HdfMessageRecycle(struct HdfMessage *message);
 void HdfMessageDelete(struct HdfSListNode *listEntry);
@@ -18,10 +18,20 @@
 extern "C" {
 #endif /* __cplusplus */
 
+/*
+ * Messages due now are kept in FIFO order on list, delayed messages in a min-heap ordered by
+ * timeStamp so the consumer sleeps exactly until the earliest one is due.
+ */
 struct HdfMessageQueue {
     struct OsalMutex mutex;
     struct OsalSem   semaphore;
     struct HdfSList  list;
+    struct HdfSListNode *tail;
+    struct HdfMessage **timers;
+    uint32_t timerCount;
+    uint32_t timerCapacity;
+    uint32_t sequence;
+    bool waiting;
 };
 
 void OsalMessageQueueInit(struct HdfMessageQueue *queue);
@@ -31,6 +41,15 @@ void HdfMessageQueueEnqueue(
 
 struct HdfMessage *HdfMessageQueueNext(struct HdfMessageQueue *queue);
 
+/*
+ * Removes all messages that are due under a single lock acquisition and returns them as a
+ * chain linked through entry.next in dispatch order. Like HdfMessageQueueNext, returns NULL
+ * after sleeping until a message is enqueued or the earliest delayed message is due.
+ */
+struct HdfMessage *HdfMessageQueueDrain(struct HdfMessageQueue *queue);
+
+void HdfMessageQueueFlush(struct HdfMessageQueue *queue);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
@@ -40,6 +40,14 @@ static bool DeviceResourceIfaceConstruct(struct DeviceResourceIface *instance, D
         case HDF_CONFIG_SOURCE:
             HcsIfaceConstruct(instance);
             break;
+#ifdef LOSCFG_DRIVERS_HDF_CONFIG_BLOB
+        case HDF_CONFIG_SOURCE_BLOB:
+            // the getters resolve attributes of blob nodes themselves, only the entry points differ
+            HcsIfaceConstruct(instance);
+            instance->GetRootNode = HcsBlobGetRootNode;
+            instance->GetNodeByMatchAttr = HcsBlobGetNodeByMatchAttr;
+            break;
+#endif
         default:
             HDF_LOGE("%s: Currently, this configuration type is not supported, the type is %d", __func__, type);
             return false;
@@ -49,13 +57,17 @@ static bool DeviceResourceIfaceConstruct(struct DeviceResourceIface *instance, D
 
 struct DeviceResourceIface *DeviceResourceGetIfaceInstance(DeviceResourceType type)
 {
-    static struct DeviceResourceIface *instance = NULL;
-    if (instance == NULL) {
-        static struct DeviceResourceIface singletonInstance;
-        if (!DeviceResourceIfaceConstruct(&singletonInstance, type)) {
+    static struct DeviceResourceIface *instances[INVALID] = { NULL };
+    static struct DeviceResourceIface singletonInstances[INVALID];
+    if ((uint32_t)type >= INVALID) {
+        HDF_LOGE("%s: invalid configuration type %d", __func__, type);
+        return NULL;
+    }
+    if (instances[type] == NULL) {
+        if (!DeviceResourceIfaceConstruct(&singletonInstances[type], type)) {
             return NULL;
         }
-        instance = &singletonInstance;
+        instances[type] = &singletonInstances[type];
     }
-    return instance;
+    return instances[type];
 }
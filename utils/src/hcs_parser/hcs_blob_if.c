@@ -7,6 +7,7 @@
  */
 
 #include "hcs_blob_if.h"
+#include "hcs_blob_index.h"
 #include "hdf_log.h"
 
 #define HDF_LOG_TAG hcs_blob_if
@@ -170,7 +171,33 @@ bool HcsSwapToUint64(uint64_t *value, const char *realValue, uint32_t type)
     return false;
 }
 
-static bool CheckHcsBlobLength(uint32_t length, struct HbcHeader *header)
+static uint32_t HcsGetTreeEnd(const struct HbcHeader *header)
+{
+    return (header->totalSize >= 0) ? (uint32_t)(HBC_HEADER_LENGTH + header->totalSize) :
+        (uint32_t)(HBC_HEADER_LENGTH - header->totalSize);
+}
+
+/* hc-gen 0.8 and later may append a lookup index after the tree, see hcs_blob_index.h. */
+uint32_t HcsGetBlobIndexOffset(const char *start, uint32_t length)
+{
+    const struct HbcHeader *header = (const struct HbcHeader *)start;
+    uint32_t indexOffset = (uint32_t)HcsAlignSize(HcsGetTreeEnd(header));
+    const struct HcsBlobIndexHeader *index = NULL;
+
+    if ((header->versionMajor == 0) && (header->versionMinor < HBC_INDEX_VERSION_MINOR)) {
+        return 0;
+    }
+    if ((length <= indexOffset) || (length - indexOffset < sizeof(struct HcsBlobIndexHeader))) {
+        return 0;
+    }
+    index = (const struct HcsBlobIndexHeader *)(start + indexOffset);
+    if ((index->magic != HCS_BLOB_INDEX_MAGIC) || (index->size != length - indexOffset)) {
+        return 0;
+    }
+    return indexOffset;
+}
+
+static bool CheckHcsBlobLength(const char *start, uint32_t length, struct HbcHeader *header)
 {
     uint32_t rootNodeLen = HCS_STRING_LENGTH(HBC_ROOT_NAME) + HCS_PREFIX_LENGTH + HCS_DWORD_LENGTH;
     uint32_t minLength = rootNodeLen + HBC_HEADER_LENGTH;
@@ -184,7 +211,7 @@ static bool CheckHcsBlobLength(uint32_t length, struct HbcHeader *header)
         g_byteAlign = true;
         HDF_LOGI("%s: the blobLength: %u, byteAlign: %d", __func__, blobLength, g_byteAlign);
     }
-    if ((length != blobLength) || (blobLength < minLength)) {
+    if (((length != blobLength) && (HcsGetBlobIndexOffset(start, length) == 0)) || (blobLength < minLength)) {
         HDF_LOGE("%s failed, Hcsblob file length is %u,  but the calculated length is %u",
                  __func__, length, blobLength);
         return false;
@@ -204,7 +231,7 @@ bool HcsCheckBlobFormat(const char *start, uint32_t length)
         HDF_LOGE("%s failed, the magic number of HBC is %x", __func__, header->magicNumber);
         return false;
     }
-    if (!CheckHcsBlobLength(length, header)) {
+    if (!CheckHcsBlobLength(start, length, header)) {
         return false;
     }
     return true;
@@ -0,0 +1,480 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ *
+ * HDF is dual licensed: you can use it either under the terms of
+ * the GPL, or the BSD license, at your option.
+ * See the LICENSE file in the root of this repository for complete details.
+ */
+
+#include "hcs_blob_index.h"
+#include "hcs_blob_if.h"
+#include "hcs_generate_tree.h"
+#include "hcs_tree_if.h"
+#include "hdf_log.h"
+#include "osal_mem.h"
+#include "securec.h"
+
+#define HDF_LOG_TAG hcs_blob_index
+
+#define HCS_BLOB_INDEX_ALIGN(size) (((size) + sizeof(uint32_t) - 1) & ~(sizeof(uint32_t) - 1))
+
+struct HcsBlobIndexCount {
+    uint32_t nodeCount;
+    uint32_t attrCount;
+    uint32_t matchCount;
+};
+
+struct HcsBlobIndexLayer {
+    uint32_t node;
+    uint32_t end;        // tree offset where the node body ends
+    uint32_t lastChild;
+};
+
+typedef int32_t (*HcsBlobIndexCmp)(const char *blob, const void *a, const void *b);
+
+static const char *HcsBlobAttrName(const char *blob, uint32_t offset)
+{
+    return blob + offset + HCS_PREFIX_LENGTH;
+}
+
+static const char *HcsBlobAttrValue(const char *blob, uint32_t offset)
+{
+    const char *name = HcsBlobAttrName(blob, offset);
+    return name + HCS_STRING_LENGTH(name);
+}
+
+static bool HcsBlobIsMatchAttr(const char *blob, uint32_t offset)
+{
+    return (strcmp(HcsBlobAttrName(blob, offset), HCS_MATCH_ATTR) == 0) &&
+        (HcsGetPrefix(HcsBlobAttrValue(blob, offset)) == CONFIG_STRING);
+}
+
+static uint32_t *HcsBlobIndexAttrs(struct HcsBlobIndexHeader *index)
+{
+    return (uint32_t *)((char *)index + index->attrTable);
+}
+
+static struct HcsBlobIndexMatch *HcsBlobIndexMatches(const struct HcsBlobIndexHeader *index)
+{
+    return (struct HcsBlobIndexMatch *)((char *)index + index->matchTable);
+}
+
+static const uint32_t *HcsBlobIndexTable(const struct HcsBlobIndexHeader *index, uint32_t table)
+{
+    return (const uint32_t *)((const char *)index + table);
+}
+
+static int32_t HcsBlobIndexCountItems(const char *blob, struct HcsBlobIndexCount *count)
+{
+    const char *treeStart = blob + HBC_HEADER_LENGTH;
+    int32_t length = HcsGetNodeLength(treeStart);
+    int32_t offset = 0;
+
+    (void)memset_s(count, sizeof(*count), 0, sizeof(*count));
+    while ((offset < length) && (length > 0)) {
+        int32_t termOffset = HcsGetNodeOrAttrLength(treeStart + offset);
+        if (termOffset <= 0) {
+            return HDF_FAILURE;
+        }
+        if (HcsGetPrefix(treeStart + offset) == CONFIG_NODE) {
+            count->nodeCount++;
+        } else {
+            count->attrCount++;
+            if (HcsBlobIsMatchAttr(blob, (uint32_t)offset + HBC_HEADER_LENGTH)) {
+                count->matchCount++;
+            }
+        }
+        offset += termOffset;
+    }
+    return (count->nodeCount > 0) ? HDF_SUCCESS : HDF_FAILURE;
+}
+
+static void HcsBlobIndexAddNode(struct HcsBlobIndexNode *nodes, uint32_t node, uint32_t offset,
+    struct HcsBlobIndexLayer *parent)
+{
+    nodes[node].offset = offset;
+    nodes[node].parent = HCS_BLOB_INDEX_NONE;
+    nodes[node].child = HCS_BLOB_INDEX_NONE;
+    nodes[node].sibling = HCS_BLOB_INDEX_NONE;
+    nodes[node].attrStart = 0;
+    nodes[node].attrCount = 0;
+    if (parent == NULL) {
+        return;
+    }
+    nodes[node].parent = parent->node;
+    if (parent->lastChild == HCS_BLOB_INDEX_NONE) {
+        nodes[parent->node].child = node;
+    } else {
+        nodes[parent->lastChild].sibling = node;
+    }
+    parent->lastChild = node;
+}
+
+static void HcsBlobIndexAddAttr(const char *blob, struct HcsBlobIndexHeader *index, struct HcsBlobIndexNode *node,
+    uint32_t nodeId, uint32_t offset)
+{
+    HcsBlobIndexAttrs(index)[node->attrStart + node->attrCount++] = offset;
+    if (HcsBlobIsMatchAttr(blob, offset)) {
+        struct HcsBlobIndexMatch *match = &HcsBlobIndexMatches(index)[index->matchCount++];
+        match->value = (uint32_t)(HcsBlobAttrValue(blob, offset) + HCS_PREFIX_LENGTH - blob);
+        match->node = nodeId;
+    }
+}
+
+/*
+ * The first pass links the nodes and counts their attributes, the second fills the attribute
+ * and match_attr tables once each node's attribute range is known.
+ */
+static int32_t HcsBlobIndexWalk(const char *blob, struct HcsBlobIndexHeader *index, bool fillAttr)
+{
+    struct HcsBlobIndexNode *nodes = (struct HcsBlobIndexNode *)HcsBlobIndexNodes(index);
+    struct HcsBlobIndexLayer stack[TREE_STACK_MAX];
+    const char *treeStart = blob + HBC_HEADER_LENGTH;
+    int32_t length = HcsGetNodeLength(treeStart);
+    uint32_t nodeCount = 0;
+    int32_t depth = 0;
+    int32_t offset = 0;
+
+    while (offset < length) {
+        const char *item = treeStart + offset;
+        int32_t termOffset = HcsGetNodeOrAttrLength(item);
+        uint32_t bodySize;
+        if (termOffset <= 0) {
+            return HDF_FAILURE;
+        }
+        while ((depth > 0) && (stack[depth - 1].end <= (uint32_t)offset)) {
+            depth--;
+        }
+        if (HcsGetPrefix(item) == CONFIG_NODE) {
+            if ((depth >= TREE_STACK_MAX) || (nodeCount >= index->nodeCount)) {
+                return HDF_FAILURE;
+            }
+            (void)HcsSwapToUint32(&bodySize, item + HCS_PREFIX_LENGTH + HCS_STRING_LENGTH(item + HCS_PREFIX_LENGTH),
+                CONFIG_DWORD);
+            if (!fillAttr) {
+                HcsBlobIndexAddNode(nodes, nodeCount, (uint32_t)offset + HBC_HEADER_LENGTH,
+                    (depth > 0) ? &stack[depth - 1] : NULL);
+            }
+            stack[depth].node = nodeCount++;
+            stack[depth].end = (uint32_t)(offset + termOffset) + bodySize;
+            stack[depth].lastChild = HCS_BLOB_INDEX_NONE;
+            depth++;
+        } else {
+            if (depth == 0) {
+                return HDF_FAILURE;
+            }
+            if (fillAttr) {
+                HcsBlobIndexAddAttr(blob, index, &nodes[stack[depth - 1].node], stack[depth - 1].node,
+                    (uint32_t)offset + HBC_HEADER_LENGTH);
+            } else {
+                nodes[stack[depth - 1].node].attrCount++;
+            }
+        }
+        offset += termOffset;
+    }
+    return HDF_SUCCESS;
+}
+
+static void HcsBlobIndexSort(const char *blob, uint8_t *base, uint32_t count, uint32_t size, HcsBlobIndexCmp cmp)
+{
+    static const uint32_t gaps[] = { 1750, 701, 301, 132, 57, 23, 10, 4, 1 };
+    uint8_t tmp[sizeof(struct HcsBlobIndexMatch)];
+    uint32_t g;
+    uint32_t i;
+
+    for (g = 0; g < sizeof(gaps) / sizeof(gaps[0]); g++) {
+        uint32_t gap = gaps[g];
+        for (i = gap; i < count; i++) {
+            uint32_t j = i;
+            (void)memcpy_s(tmp, sizeof(tmp), base + i * size, size);
+            while ((j >= gap) && (cmp(blob, base + (j - gap) * size, tmp) > 0)) {
+                (void)memcpy_s(base + j * size, size, base + (j - gap) * size, size);
+                j -= gap;
+            }
+            (void)memcpy_s(base + j * size, size, tmp, size);
+        }
+    }
+}
+
+static int32_t HcsBlobAttrCmp(const char *blob, const void *a, const void *b)
+{
+    uint32_t offsetA = *(const uint32_t *)a;
+    uint32_t offsetB = *(const uint32_t *)b;
+    int32_t ret = strcmp(HcsBlobAttrName(blob, offsetA), HcsBlobAttrName(blob, offsetB));
+    if (ret != 0) {
+        return ret;
+    }
+    // the tree lists attributes in reverse blob order, so the last duplicate wins there too
+    return (offsetA > offsetB) ? -1 : (offsetA < offsetB);
+}
+
+static int32_t HcsBlobMatchCmp(const char *blob, const void *a, const void *b)
+{
+    const struct HcsBlobIndexMatch *matchA = (const struct HcsBlobIndexMatch *)a;
+    const struct HcsBlobIndexMatch *matchB = (const struct HcsBlobIndexMatch *)b;
+    int32_t ret = strcmp(blob + matchA->value, blob + matchB->value);
+    if (ret != 0) {
+        return ret;
+    }
+    return (matchA->node < matchB->node) ? -1 : (matchA->node > matchB->node);
+}
+
+static struct HcsBlobIndexHeader *HcsBlobIndexAlloc(const struct HcsBlobIndexCount *count)
+{
+    struct HcsBlobIndexHeader *index = NULL;
+    uint32_t nodeTable = HCS_BLOB_INDEX_ALIGN(sizeof(struct HcsBlobIndexHeader));
+    uint32_t attrTable = nodeTable + count->nodeCount * sizeof(struct HcsBlobIndexNode);
+    uint32_t matchTable = attrTable + count->attrCount * sizeof(uint32_t);
+    uint32_t size = matchTable + count->matchCount * sizeof(struct HcsBlobIndexMatch);
+
+    index = (struct HcsBlobIndexHeader *)OsalMemCalloc(size);
+    if (index == NULL) {
+        return NULL;
+    }
+    index->magic = HCS_BLOB_INDEX_MAGIC;
+    index->size = size;
+    index->nodeCount = count->nodeCount;
+    index->nodeTable = nodeTable;
+    index->attrCount = count->attrCount;
+    index->attrTable = attrTable;
+    index->matchCount = 0;
+    index->matchTable = matchTable;
+    return index;
+}
+
+struct HcsBlobIndexHeader *HcsBlobIndexBuild(const char *blob)
+{
+    struct HcsBlobIndexCount count;
+    struct HcsBlobIndexHeader *index = NULL;
+    struct HcsBlobIndexNode *nodes = NULL;
+    uint32_t attrStart = 0;
+    uint32_t i;
+
+    if (HcsBlobIndexCountItems(blob, &count) != HDF_SUCCESS) {
+        HDF_LOGE("%s failed, invalid blob", __func__);
+        return NULL;
+    }
+    index = HcsBlobIndexAlloc(&count);
+    if (index == NULL) {
+        HDF_LOGE("%s failed, OsalMemCalloc error", __func__);
+        return NULL;
+    }
+    if (HcsBlobIndexWalk(blob, index, false) != HDF_SUCCESS) {
+        goto ERROR;
+    }
+    nodes = (struct HcsBlobIndexNode *)HcsBlobIndexNodes(index);
+    for (i = 0; i < index->nodeCount; i++) {
+        nodes[i].attrStart = attrStart;
+        attrStart += nodes[i].attrCount;
+        nodes[i].attrCount = 0;
+    }
+    if (HcsBlobIndexWalk(blob, index, true) != HDF_SUCCESS) {
+        goto ERROR;
+    }
+    for (i = 0; i < index->nodeCount; i++) {
+        HcsBlobIndexSort(blob, (uint8_t *)&HcsBlobIndexAttrs(index)[nodes[i].attrStart], nodes[i].attrCount,
+            sizeof(uint32_t), HcsBlobAttrCmp);
+    }
+    HcsBlobIndexSort(blob, (uint8_t *)HcsBlobIndexMatches(index), index->matchCount,
+        sizeof(struct HcsBlobIndexMatch), HcsBlobMatchCmp);
+    return index;
+
+ERROR:
+    HDF_LOGE("%s failed, malformed blob", __func__);
+    OsalMemFree(index);
+    return NULL;
+}
+
+static bool HcsBlobIndexTableCheck(const struct HcsBlobIndexHeader *index, uint32_t table, uint32_t count,
+    uint32_t entrySize)
+{
+    return ((table % sizeof(uint32_t)) == 0) && (table >= sizeof(*index)) && (table <= index->size) &&
+        ((uint64_t)count * entrySize <= index->size - table);
+}
+
+static bool HcsBlobIndexLayoutCheck(const struct HcsBlobIndexHeader *index)
+{
+    uint32_t refMask = index->refSlotCount - 1;
+    if (!HcsBlobIndexTableCheck(index, index->nodeTable, index->nodeCount, sizeof(struct HcsBlobIndexNode)) ||
+        !HcsBlobIndexTableCheck(index, index->attrTable, index->attrCount, sizeof(uint32_t)) ||
+        !HcsBlobIndexTableCheck(index, index->matchTable, index->matchCount, sizeof(struct HcsBlobIndexMatch)) ||
+        !HcsBlobIndexTableCheck(index, index->hashSeedTable, index->hashBucketCount, sizeof(uint32_t)) ||
+        !HcsBlobIndexTableCheck(index, index->hashSlotTable, index->hashSlotCount, sizeof(uint32_t)) ||
+        !HcsBlobIndexTableCheck(index, index->refTable, index->refSlotCount, sizeof(uint32_t))) {
+        return false;
+    }
+    if ((index->nodeCount == 0) || ((index->hashBucketCount != 0) && (index->hashSlotCount == 0))) {
+        return false;
+    }
+    // the ref table needs a free slot to end probing
+    return (index->refSlotCount == 0) || (((index->refSlotCount & refMask) == 0) &&
+        (index->refSlotCount > index->nodeCount));
+}
+
+static bool HcsBlobIndexNodeCheck(const struct HcsBlobIndexHeader *index, uint32_t treeEnd)
+{
+    const struct HcsBlobIndexNode *nodes = HcsBlobIndexNodes(index);
+    const uint32_t *attrs = HcsBlobIndexTable(index, index->attrTable);
+    uint32_t prevOffset = 0;
+    uint32_t i;
+
+    if (nodes[0].offset != HBC_HEADER_LENGTH) {
+        return false;
+    }
+    for (i = 0; i < index->nodeCount; i++) {
+        const struct HcsBlobIndexNode *node = &nodes[i];
+        if ((node->offset >= treeEnd) || ((i > 0) && (node->offset <= prevOffset)) ||
+            ((node->parent >= index->nodeCount) && (node->parent != HCS_BLOB_INDEX_NONE)) ||
+            ((node->child >= index->nodeCount) && (node->child != HCS_BLOB_INDEX_NONE)) ||
+            ((node->sibling >= index->nodeCount) && (node->sibling != HCS_BLOB_INDEX_NONE)) ||
+            (node->attrStart > index->attrCount) || (node->attrCount > index->attrCount - node->attrStart)) {
+            return false;
+        }
+        prevOffset = node->offset;
+    }
+    for (i = 0; i < index->attrCount; i++) {
+        if ((attrs[i] < HBC_HEADER_LENGTH) || (attrs[i] >= treeEnd)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool HcsBlobIndexHashCheck(const struct HcsBlobIndexHeader *index, uint32_t treeEnd)
+{
+    const struct HcsBlobIndexMatch *matches = HcsBlobIndexMatches(index);
+    const uint32_t *slots = HcsBlobIndexTable(index, index->hashSlotTable);
+    const uint32_t *refs = HcsBlobIndexTable(index, index->refTable);
+    uint32_t refEmpty = 0;
+    uint32_t i;
+
+    for (i = 0; i < index->matchCount; i++) {
+        if ((matches[i].value < HBC_HEADER_LENGTH) || (matches[i].value >= treeEnd) ||
+            (matches[i].node >= index->nodeCount)) {
+            return false;
+        }
+    }
+    for (i = 0; i < index->hashSlotCount; i++) {
+        if (slots[i] >= index->matchCount) {
+            return false;
+        }
+    }
+    for (i = 0; i < index->refSlotCount; i++) {
+        if (refs[i] == HCS_BLOB_INDEX_NONE) {
+            refEmpty++;
+        } else if (refs[i] >= index->nodeCount) {
+            return false;
+        }
+    }
+    // a ref lookup probes until it hits an empty slot, a full table would never end a miss
+    return (index->refSlotCount == 0) || (refEmpty != 0);
+}
+
+bool HcsBlobIndexCheck(const struct HcsBlobIndexHeader *index, uint32_t size, uint32_t treeEnd)
+{
+    if ((size < sizeof(*index)) || (index->magic != HCS_BLOB_INDEX_MAGIC) || (index->size != size)) {
+        HDF_LOGE("%s failed, bad index header", __func__);
+        return false;
+    }
+    if (!HcsBlobIndexLayoutCheck(index) || !HcsBlobIndexNodeCheck(index, treeEnd) ||
+        !HcsBlobIndexHashCheck(index, treeEnd)) {
+        HDF_LOGE("%s failed, malformed index", __func__);
+        return false;
+    }
+    return true;
+}
+
+uint32_t HcsBlobIndexFindAttr(const char *blob, const struct HcsBlobIndexHeader *index, uint32_t node,
+    const char *attrName)
+{
+    const struct HcsBlobIndexNode *entry = &HcsBlobIndexNodes(index)[node];
+    const uint32_t *attrs = (const uint32_t *)((const char *)index + index->attrTable) + entry->attrStart;
+    uint32_t low = 0;
+    uint32_t high = entry->attrCount;
+
+    // lower bound, so a duplicated name resolves to its last occurrence in the blob
+    while (low < high) {
+        uint32_t mid = low + (high - low) / 2;
+        if (strcmp(HcsBlobAttrName(blob, attrs[mid]), attrName) < 0) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    if ((low < entry->attrCount) && (strcmp(HcsBlobAttrName(blob, attrs[low]), attrName) == 0)) {
+        return attrs[low];
+    }
+    return 0;
+}
+
+static uint32_t HcsBlobIndexHashMatch(const char *blob, const struct HcsBlobIndexHeader *index, uint32_t start,
+    const char *attrValue)
+{
+    const struct HcsBlobIndexMatch *matches = HcsBlobIndexMatches(index);
+    const uint32_t *seeds = HcsBlobIndexTable(index, index->hashSeedTable);
+    const uint32_t *slots = HcsBlobIndexTable(index, index->hashSlotTable);
+    uint32_t seed = seeds[HcsBlobIndexHash(attrValue, 0) % index->hashBucketCount];
+    uint32_t match = slots[HcsBlobIndexHash(attrValue, seed) % index->hashSlotCount];
+
+    // the slot only proves a hash hit, entries of the same value follow it in node order
+    for (; (match < index->matchCount) && (strcmp(blob + matches[match].value, attrValue) == 0); match++) {
+        if (matches[match].node >= start) {
+            return matches[match].node;
+        }
+    }
+    return HCS_BLOB_INDEX_NONE;
+}
+
+uint32_t HcsBlobIndexFindMatch(const char *blob, const struct HcsBlobIndexHeader *index, uint32_t start,
+    const char *attrValue)
+{
+    const struct HcsBlobIndexMatch *matches = HcsBlobIndexMatches(index);
+    uint32_t low = 0;
+    uint32_t high = index->matchCount;
+
+    if (index->hashBucketCount != 0) {
+        return HcsBlobIndexHashMatch(blob, index, start, attrValue);
+    }
+    while (low < high) {
+        uint32_t mid = low + (high - low) / 2;
+        int32_t ret = strcmp(blob + matches[mid].value, attrValue);
+        if ((ret < 0) || ((ret == 0) && (matches[mid].node < start))) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    if ((low < index->matchCount) && (strcmp(blob + matches[low].value, attrValue) == 0)) {
+        return matches[low].node;
+    }
+    return HCS_BLOB_INDEX_NONE;
+}
+
+uint32_t HcsBlobIndexFindNode(const struct HcsBlobIndexHeader *index, uint32_t offset)
+{
+    const struct HcsBlobIndexNode *nodes = HcsBlobIndexNodes(index);
+    uint32_t low = 0;
+    uint32_t high = index->nodeCount;
+
+    if (index->refSlotCount != 0) {
+        const uint32_t *refs = HcsBlobIndexTable(index, index->refTable);
+        uint32_t mask = index->refSlotCount - 1;
+        uint32_t slot = HcsBlobIndexMix(offset) & mask;
+        while ((refs[slot] != HCS_BLOB_INDEX_NONE) && (nodes[refs[slot]].offset != offset)) {
+            slot = (slot + 1) & mask;
+        }
+        return refs[slot];
+    }
+    while (low < high) {
+        uint32_t mid = low + (high - low) / 2;
+        if (nodes[mid].offset == offset) {
+            return mid;
+        }
+        if (nodes[mid].offset < offset) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return HCS_BLOB_INDEX_NONE;
+}
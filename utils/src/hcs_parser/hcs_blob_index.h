@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ *
+ * HDF is dual licensed: you can use it either under the terms of
+ * the GPL, or the BSD license, at your option.
+ * See the LICENSE file in the root of this repository for complete details.
+ */
+
+#ifndef HCS_BLOB_INDEX_H
+#define HCS_BLOB_INDEX_H
+
+#include "device_resource_if.h"
+#include "hdf_base.h"
+
+/*
+ * Offset index over an hcb blob. All offsets inside the index are relative to the index start,
+ * blob offsets are relative to the blob start, so a node's blob offset equals its hashValue.
+ * hc-gen -x appends the same layout to the blob, the hash tables are only present in that case.
+ */
+#define HCS_BLOB_INDEX_MAGIC 0x58444E49
+#define HCS_BLOB_INDEX_NONE 0xFFFFFFFF
+
+struct HcsBlobIndexHeader {
+    uint32_t magic;
+    uint32_t size;       // bytes of the whole index
+    uint32_t nodeCount;
+    uint32_t nodeTable;  // HcsBlobIndexNode[nodeCount] in preorder, so blob offsets are ascending
+    uint32_t attrCount;
+    uint32_t attrTable;  // uint32_t blob offsets of attributes, grouped by node and sorted by name
+    uint32_t matchCount;
+    uint32_t matchTable; // HcsBlobIndexMatch[matchCount] sorted by match_attr value, then node
+    uint32_t hashBucketCount; // minimal perfect hash over distinct match_attr values, 0 if absent
+    uint32_t hashSeedTable;   // uint32_t seed of each bucket
+    uint32_t hashSlotCount;   // count of distinct match_attr values
+    uint32_t hashSlotTable;   // uint32_t first match table entry of the value hashed to each slot
+    uint32_t refSlotCount;    // power of two, 0 if absent
+    uint32_t refTable;        // uint32_t node numbers keyed by blob offset, HCS_BLOB_INDEX_NONE if empty
+};
+
+struct HcsBlobIndexNode {
+    uint32_t offset;     // blob offset of the node
+    uint32_t parent;     // node numbers, HCS_BLOB_INDEX_NONE if absent
+    uint32_t child;
+    uint32_t sibling;
+    uint32_t attrStart;  // first entry of the node in the attribute table
+    uint32_t attrCount;
+};
+
+struct HcsBlobIndexMatch {
+    uint32_t value;      // blob offset of the match_attr string
+    uint32_t node;
+};
+
+static inline uint32_t HcsBlobIndexMix(uint32_t value)
+{
+    value ^= value >> 16;
+    value *= 0x85EBCA6B;
+    value ^= value >> 13;
+    value *= 0xC2B2AE35;
+    value ^= value >> 16;
+    return value;
+}
+
+/* Must match ByteCodeIndex::Hash() of hc-gen. */
+static inline uint32_t HcsBlobIndexHash(const char *str, uint32_t seed)
+{
+    uint32_t hash = seed ^ 0x811C9DC5;
+    while (*str != '\0') {
+        hash ^= (uint8_t)*str++;
+        hash *= 0x01000193;
+    }
+    return HcsBlobIndexMix(hash);
+}
+
+static inline const struct HcsBlobIndexNode *HcsBlobIndexNodes(const struct HcsBlobIndexHeader *index)
+{
+    return (const struct HcsBlobIndexNode *)((const char *)index + index->nodeTable);
+}
+
+/* Builds the index of a checked blob at runtime. The result is freed with OsalMemFree. */
+struct HcsBlobIndexHeader *HcsBlobIndexBuild(const char *blob);
+
+/* Validates an index appended to a blob whose config tree ends at @treeEnd. */
+bool HcsBlobIndexCheck(const struct HcsBlobIndexHeader *index, uint32_t size, uint32_t treeEnd);
+
+/* Returns the blob offset of an attribute of a node, or 0 if absent. */
+uint32_t HcsBlobIndexFindAttr(const char *blob, const struct HcsBlobIndexHeader *index, uint32_t node,
+    const char *attrName);
+
+/* Returns the first node at or after @start in preorder with the match_attr value, or HCS_BLOB_INDEX_NONE. */
+uint32_t HcsBlobIndexFindMatch(const char *blob, const struct HcsBlobIndexHeader *index, uint32_t start,
+    const char *attrValue);
+
+/* Returns the node at a blob offset, or HCS_BLOB_INDEX_NONE. */
+uint32_t HcsBlobIndexFindNode(const struct HcsBlobIndexHeader *index, uint32_t offset);
+
+/* Attribute and lookup helpers of the HDF_CONFIG_SOURCE_BLOB backend, whose nodes carry no attrData. */
+bool HcsBlobIsNode(const struct DeviceResourceNode *node);
+struct DeviceResourceAttr *HcsBlobGetAttr(const struct DeviceResourceNode *node, const char *attrName,
+    struct DeviceResourceAttr *attr);
+const struct DeviceResourceNode *HcsBlobGetNodeByRef(uint32_t hashValue);
+
+#endif /* HCS_BLOB_INDEX_H */
@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ *
+ * HDF is dual licensed: you can use it either under the terms of
+ * the GPL, or the BSD license, at your option.
+ * See the LICENSE file in the root of this repository for complete details.
+ */
+
+#include "hcs_blob_if.h"
+#include "hcs_blob_index.h"
+#include "hcs_tree_if.h"
+#include "hdf_log.h"
+#include "hdf_once.h"
+#include "osal_mem.h"
+
+#define HDF_LOG_TAG hcs_blob_parser
+
+/*
+ * Nodes are kept as an array in preorder so a node's position in it is its number in the blob
+ * index. Attributes are never materialized, getters decode them straight from the blob.
+ */
+struct HcsBlobTree {
+    const char *blob;
+    const struct HcsBlobIndexHeader *index;
+    struct DeviceResourceNode *nodes;
+};
+
+static struct HcsBlobTree g_hcsBlobTree;
+/* publishes &g_hcsBlobTree once it is built, readers reach the tree through the published pointer */
+static struct HdfOnce g_hcsBlobTreeOnce = HDF_ONCE_INIT;
+
+void __attribute__((weak)) HdfGetBuildInConfigData(const unsigned char **data, unsigned int *size);
+
+static struct DeviceResourceNode *HcsBlobNodeAt(const struct HcsBlobTree *tree, uint32_t node)
+{
+    return (node == HCS_BLOB_INDEX_NONE) ? NULL : &tree->nodes[node];
+}
+
+static bool HcsBlobTreeLink(struct HcsBlobTree *tree, const char *blob, const struct HcsBlobIndexHeader *index)
+{
+    const struct HcsBlobIndexNode *entries = HcsBlobIndexNodes(index);
+    struct DeviceResourceNode *nodes = NULL;
+    uint32_t i;
+
+    nodes = (struct DeviceResourceNode *)OsalMemCalloc(sizeof(*nodes) * index->nodeCount);
+    if (nodes == NULL) {
+        HDF_LOGE("%s failed, OsalMemCalloc error", __func__);
+        return false;
+    }
+    tree->nodes = nodes;
+    for (i = 0; i < index->nodeCount; i++) {
+        nodes[i].name = blob + entries[i].offset + HCS_PREFIX_LENGTH;
+        nodes[i].hashValue = entries[i].offset;
+        nodes[i].parent = HcsBlobNodeAt(tree, entries[i].parent);
+        nodes[i].child = HcsBlobNodeAt(tree, entries[i].child);
+        nodes[i].sibling = HcsBlobNodeAt(tree, entries[i].sibling);
+    }
+    return true;
+}
+
+/* Prefers the index appended by hc-gen -x and falls back to building one from the tree. */
+static const struct HcsBlobIndexHeader *HcsBlobIndexLoad(const char *blob, uint32_t length, bool *embedded)
+{
+    uint32_t indexOffset = HcsGetBlobIndexOffset(blob, length);
+    const struct HcsBlobIndexHeader *index = (const struct HcsBlobIndexHeader *)(blob + indexOffset);
+
+    *embedded = (indexOffset != 0) && HcsBlobIndexCheck(index, length - indexOffset, indexOffset);
+    if (*embedded) {
+        return index;
+    }
+    if (indexOffset != 0) {
+        HDF_LOGW("%s: ignore the malformed index of the blob", __func__);
+    }
+    return HcsBlobIndexBuild(blob);
+}
+
+static bool HcsBlobTreeBuild(struct HcsBlobTree *tree)
+{
+    uint32_t length;
+    const unsigned char *hcsBlob = NULL;
+    const struct HcsBlobIndexHeader *index = NULL;
+    bool embedded = false;
+
+    if (HdfGetBuildInConfigData == NULL) {
+        HDF_LOGE("no build-in hdf config");
+        return false;
+    }
+    HdfGetBuildInConfigData(&hcsBlob, &length);
+    if (!HcsCheckBlobFormat((const char *)hcsBlob, length)) {
+        return false;
+    }
+    index = HcsBlobIndexLoad((const char *)hcsBlob, length, &embedded);
+    if (index == NULL) {
+        return false;
+    }
+    if (!HcsBlobTreeLink(tree, (const char *)hcsBlob, index)) {
+        if (!embedded) {
+            OsalMemFree((void *)index);
+        }
+        return false;
+    }
+    tree->index = index;
+    tree->blob = (const char *)hcsBlob;
+    return true;
+}
+
+/* The built-in blob never changes, so a failed build is not retried. */
+static void *HcsBlobTreeInit(void *arg)
+{
+    struct HcsBlobTree *tree = (struct HcsBlobTree *)arg;
+    if (!HcsBlobTreeBuild(tree)) {
+        HDF_LOGE("failed to build blob config index");
+        return NULL;
+    }
+    return tree;
+}
+
+const struct DeviceResourceNode *HcsBlobGetRootNode(void)
+{
+    const struct HcsBlobTree *tree = HdfOnceRun(&g_hcsBlobTreeOnce, HcsBlobTreeInit, &g_hcsBlobTree);
+    return (tree != NULL) ? tree->nodes : NULL;
+}
+
+bool HcsBlobIsNode(const struct DeviceResourceNode *node)
+{
+    /* the tree may still be under construction by another thread until it is published */
+    const struct HcsBlobTree *tree = HdfOncePeek(&g_hcsBlobTreeOnce);
+    return (tree != NULL) && (node >= tree->nodes) && (node < tree->nodes + tree->index->nodeCount);
+}
+
+struct DeviceResourceAttr *HcsBlobGetAttr(const struct DeviceResourceNode *node, const char *attrName,
+    struct DeviceResourceAttr *attr)
+{
+    const struct HcsBlobTree *tree = HdfOncePeek(&g_hcsBlobTreeOnce);
+    uint32_t offset;
+    if (tree == NULL) {
+        return NULL;
+    }
+    offset = HcsBlobIndexFindAttr(tree->blob, tree->index, (uint32_t)(node - tree->nodes), attrName);
+    if (offset == 0) {
+        return NULL;
+    }
+    attr->name = tree->blob + offset + HCS_PREFIX_LENGTH;
+    attr->value = attr->name + HCS_STRING_LENGTH(attr->name);
+    attr->next = NULL;
+    return attr;
+}
+
+const struct DeviceResourceNode *HcsBlobGetNodeByMatchAttr(const struct DeviceResourceNode *node,
+    const char *attrValue)
+{
+    const struct DeviceResourceNode *start = (node != NULL) ? node : HcsBlobGetRootNode();
+    const struct HcsBlobTree *tree = HdfOncePeek(&g_hcsBlobTreeOnce);
+    if ((attrValue == NULL) || !HcsBlobIsNode(start) || (tree == NULL)) {
+        HDF_LOGE("%s failed, attrValue or node error", __func__);
+        return NULL;
+    }
+    return HcsBlobNodeAt(tree, HcsBlobIndexFindMatch(tree->blob, tree->index,
+        (uint32_t)(start - tree->nodes), attrValue));
+}
+
+const struct DeviceResourceNode *HcsBlobGetNodeByRef(uint32_t hashValue)
+{
+    const struct HcsBlobTree *tree = HdfOncePeek(&g_hcsBlobTreeOnce);
+    if (tree == NULL) {
+        return NULL;
+    }
+    return HcsBlobNodeAt(tree, HcsBlobIndexFindNode(tree->index, hashValue));
+}
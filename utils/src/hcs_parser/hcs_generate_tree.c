@@ -126,6 +126,32 @@ static int32_t ParseByteCode(const char *treeStart, int32_t offset, char **treeM
     return termOffset;
 }
 
+int32_t CountCfgTree(const char *treeStart, int32_t length, uint32_t *nodeCount, uint32_t *attrCount)
+{
+    int32_t offset = 0;
+    *nodeCount = 0;
+    *attrCount = 0;
+    while (offset < length) {
+        int32_t termOffset = HcsGetNodeOrAttrLength(treeStart + offset);
+        if (termOffset <= 0) {
+            HDF_LOGE("%s failed, HcsGetNodeOrAttrLength error, errno: %d", __func__, termOffset);
+            return HDF_FAILURE;
+        }
+        switch (HcsGetPrefix(treeStart + offset)) {
+            case CONFIG_NODE:
+                (*nodeCount)++;
+                break;
+            case CONFIG_ATTR:
+                (*attrCount)++;
+                break;
+            default:
+                return HDF_FAILURE;
+        }
+        offset += termOffset;
+    }
+    return HDF_SUCCESS;
+}
+
 int32_t GenerateCfgTree(const char *treeStart, int32_t length, char *treeMem, struct DeviceResourceNode **root)
 {
     int32_t offset = 0;
@@ -16,6 +16,7 @@ struct TreeStack {
     uint32_t offset; // The offset of the node in the blob.
     struct DeviceResourceNode *node; // The head node of a layer tree.
 };
+int32_t CountCfgTree(const char *treeStart, int32_t length, uint32_t *nodeCount, uint32_t *attrCount);
 int32_t GenerateCfgTree(const char *treeStart, int32_t length, char *treeMem, struct DeviceResourceNode **root);
 
 #endif /* HCS_GENERATE_TREE_H */
\ No newline at end of file
@@ -9,20 +9,27 @@
 #include "hcs_parser.h"
 #include "hcs_blob_if.h"
 #include "hcs_generate_tree.h"
+#include "hcs_tree_index.h"
 #include "hdf_log.h"
 #include "osal_mem.h"
 
 #define HDF_LOG_TAG hcs_parser
 
-static int32_t GetHcsTreeSize(const char *blob, int32_t nodeLength)
+static int32_t GetHcsTreeSize(const char *blob, int32_t nodeLength, uint32_t *nodeCount, uint32_t *attrCount)
 {
-    return GenerateCfgTree(blob, nodeLength, NULL, NULL);
+    if ((CountCfgTree(blob, nodeLength, nodeCount, attrCount) != HDF_SUCCESS) || (*nodeCount == 0)) {
+        return HDF_FAILURE;
+    }
+    return (int32_t)(*nodeCount * sizeof(struct DeviceResourceNode) + *attrCount * sizeof(struct DeviceResourceAttr));
 }
 
 bool HcsDecompile(const char *hcsBlob, uint32_t offset, struct DeviceResourceNode **root)
 {
     int32_t nodeLength = HcsGetNodeLength(hcsBlob + offset);
     int32_t treeMemLength;
+    uint32_t indexMemLength;
+    uint32_t nodeCount = 0;
+    uint32_t attrCount = 0;
     char *treeMem = NULL;
     int32_t treeLayer;
     if (nodeLength < 0) {
@@ -30,13 +37,15 @@ bool HcsDecompile(const char *hcsBlob, uint32_t offset, struct DeviceResourceNod
         return false;
     }
 
-    treeMemLength = GetHcsTreeSize(hcsBlob + offset, nodeLength);
+    treeMemLength = GetHcsTreeSize(hcsBlob + offset, nodeLength, &nodeCount, &attrCount);
     if (treeMemLength <= 0) {
         HDF_LOGE("%s failed, GetHcsTreeSize error, treeMemLength = %d", __func__, treeMemLength);
         return false;
     }
 
-    treeMem = (char *)OsalMemCalloc(treeMemLength);
+    // the lookup index lives in the same arena, right after the tree
+    indexMemLength = HcsTreeIndexSize(nodeCount, attrCount);
+    treeMem = (char *)OsalMemCalloc((uint32_t)treeMemLength + indexMemLength);
     if (treeMem == NULL) {
         HDF_LOGE("%s failed, OsalMemCalloc error", __func__);
         return false;
@@ -48,5 +57,8 @@ bool HcsDecompile(const char *hcsBlob, uint32_t offset, struct DeviceResourceNod
         *root = NULL;
         return false;
     }
+    if (!HcsTreeIndexBuild(*root, nodeCount, treeMem + treeMemLength, indexMemLength)) {
+        HDF_LOGW("%s: config tree is not indexed, lookups fall back to linear search", __func__);
+    }
     return true;
-}
\ No newline at end of file
+}
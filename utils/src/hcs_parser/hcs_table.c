@@ -0,0 +1,246 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ *
+ * HDF is dual licensed: you can use it either under the terms of
+ * the GPL, or the BSD license, at your option.
+ * See the LICENSE file in the root of this repository for complete details.
+ */
+
+#include "hcs_table.h"
+#include "hdf_log.h"
+#include "securec.h"
+
+#define HDF_LOG_TAG hcs_table
+
+#define HCS_TABLE_MATCH_ATTR "match_attr"
+
+const struct HcsTable *__attribute__((weak)) HdfGetBuildInConfigTable(void);
+
+const struct HcsTable *HcsTableGetInstance(void)
+{
+    if (HdfGetBuildInConfigTable == NULL) {
+        HDF_LOGE("no build-in hdf config table");
+        return NULL;
+    }
+    return HdfGetBuildInConfigTable();
+}
+
+const struct HcsTableNode *HcsTableGetRootNode(void)
+{
+    const struct HcsTable *table = HcsTableGetInstance();
+    return (table != NULL) ? table->root : NULL;
+}
+
+const struct HcsTableNode *HcsTableGetChildNode(const struct HcsTableNode *node, const char *nodeName)
+{
+    uint32_t low = 0;
+    uint32_t high;
+    if ((node == NULL) || (nodeName == NULL)) {
+        return NULL;
+    }
+    high = node->childCount;
+    while (low < high) {
+        uint32_t mid = low + (high - low) / 2;
+        const struct HcsTableNode *child = &node->children[node->childIndex[mid]];
+        int cmp = strcmp(child->name, nodeName);
+        if (cmp == 0) {
+            return child;
+        }
+        if (cmp < 0) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return NULL;
+}
+
+const struct HcsTableAttr *HcsTableGetAttr(const struct HcsTableNode *node, const char *attrName)
+{
+    uint32_t low = 0;
+    uint32_t high;
+    if ((node == NULL) || (attrName == NULL)) {
+        return NULL;
+    }
+    high = node->attrCount;
+    while (low < high) {
+        uint32_t mid = low + (high - low) / 2;
+        int cmp = strcmp(node->attrs[mid].name, attrName);
+        if (cmp == 0) {
+            return &node->attrs[mid];
+        }
+        if (cmp < 0) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return NULL;
+}
+
+const struct HcsTableNode *HcsTableGetNodeByMatchAttr(const char *attrValue)
+{
+    const struct HcsTable *table = HcsTableGetInstance();
+    uint32_t low = 0;
+    uint32_t high;
+    if ((table == NULL) || (attrValue == NULL)) {
+        return NULL;
+    }
+    // lower bound, duplicated values are kept in depth-first order by hc-gen
+    high = table->matchCount;
+    while (low < high) {
+        uint32_t mid = low + (high - low) / 2;
+        if (strcmp(table->matches[mid].matchAttr, attrValue) < 0) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    if ((low < table->matchCount) && (strcmp(table->matches[low].matchAttr, attrValue) == 0)) {
+        return table->matches[low].node;
+    }
+    HDF_LOGE("%s failed, %s of %s is not found", __func__, HCS_TABLE_MATCH_ATTR, attrValue);
+    return NULL;
+}
+
+const struct HcsTableNode *HcsTableGetNodeByRefAttr(const struct HcsTableNode *node, const char *attrName)
+{
+    const struct HcsTableAttr *attr = HcsTableGetAttr(node, attrName);
+    if ((attr == NULL) || (attr->type != HCS_TABLE_REF) || attr->isArray) {
+        HDF_LOGE("%s failed, the attr of %s is not a reference", __func__, (attrName == NULL) ? "error attrName" :
+            attrName);
+        return NULL;
+    }
+    return (const struct HcsTableNode *)attr->data;
+}
+
+static uint64_t HcsTableArrayElem(const struct HcsTableAttr *attr, uint32_t index)
+{
+    switch (attr->type) {
+        case HCS_TABLE_UINT8:
+            return ((const uint8_t *)attr->data)[index];
+        case HCS_TABLE_UINT16:
+            return ((const uint16_t *)attr->data)[index];
+        case HCS_TABLE_UINT32:
+            return ((const uint32_t *)attr->data)[index];
+        default:
+            return ((const uint64_t *)attr->data)[index];
+    }
+}
+
+/* An integer is read only into a type at least as wide as the type hc-gen fitted it to, as the blob does. */
+static int32_t HcsTableGetInteger(const struct HcsTableNode *node, const char *attrName, uint32_t index,
+    bool isArray, uint32_t type, uint64_t *value)
+{
+    const struct HcsTableAttr *attr = HcsTableGetAttr(node, attrName);
+    if (attr == NULL) {
+        HDF_LOGE("%s failed, the attr of %s is NULL", __func__, (attrName == NULL) ? "error attrName" : attrName);
+        return HDF_FAILURE;
+    }
+    if ((attr->type < HCS_TABLE_UINT8) || (attr->type > type) || (attr->isArray != isArray)) {
+        HDF_LOGE("%s failed, the attr of %s has type %u", __func__, attrName, attr->type);
+        return HDF_ERR_INVALID_OBJECT;
+    }
+    if (!isArray) {
+        *value = attr->value;
+        return HDF_SUCCESS;
+    }
+    if (index >= attr->count) {
+        HDF_LOGE("%s failed, index: %u >= count: %u", __func__, index, attr->count);
+        return HDF_FAILURE;
+    }
+    *value = HcsTableArrayElem(attr, index);
+    return HDF_SUCCESS;
+}
+
+bool HcsTableGetBool(const struct HcsTableNode *node, const char *attrName)
+{
+    uint64_t value = 0;
+    if (HcsTableGetInteger(node, attrName, 0, false, HCS_TABLE_UINT8, &value) != HDF_SUCCESS) {
+        return false;
+    }
+    return value ? true : false;
+}
+
+#define HCS_TABLE_DEFINE_GET_UINT(bits)                                                                        \
+int32_t HcsTableGetUint##bits(const struct HcsTableNode *node, const char *attrName, uint##bits##_t *value,    \
+    uint##bits##_t def)                                                                                        \
+{                                                                                                              \
+    uint64_t data = 0;                                                                                         \
+    int32_t ret;                                                                                               \
+    if (value == NULL) {                                                                                       \
+        return HDF_ERR_INVALID_PARAM;                                                                          \
+    }                                                                                                          \
+    ret = HcsTableGetInteger(node, attrName, 0, false, HCS_TABLE_UINT##bits, &data);                           \
+    *value = (ret == HDF_SUCCESS) ? (uint##bits##_t)data : def;                                                \
+    return ret;                                                                                                \
+}                                                                                                              \
+                                                                                                               \
+int32_t HcsTableGetUint##bits##ArrayElem(const struct HcsTableNode *node, const char *attrName, uint32_t index, \
+    uint##bits##_t *value, uint##bits##_t def)                                                                 \
+{                                                                                                              \
+    uint64_t data = 0;                                                                                         \
+    int32_t ret;                                                                                               \
+    if (value == NULL) {                                                                                       \
+        return HDF_ERR_INVALID_PARAM;                                                                          \
+    }                                                                                                          \
+    ret = HcsTableGetInteger(node, attrName, index, true, HCS_TABLE_UINT##bits, &data);                        \
+    *value = (ret == HDF_SUCCESS) ? (uint##bits##_t)data : def;                                                \
+    return ret;                                                                                                \
+}
+
+HCS_TABLE_DEFINE_GET_UINT(8)
+HCS_TABLE_DEFINE_GET_UINT(16)
+HCS_TABLE_DEFINE_GET_UINT(32)
+HCS_TABLE_DEFINE_GET_UINT(64)
+
+int32_t HcsTableGetString(const struct HcsTableNode *node, const char *attrName, const char **value,
+    const char *def)
+{
+    const struct HcsTableAttr *attr = NULL;
+    if (value == NULL) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+    *value = def;
+    attr = HcsTableGetAttr(node, attrName);
+    if ((attr == NULL) || (attr->type != HCS_TABLE_STRING) || attr->isArray) {
+        HDF_LOGE("%s failed, the attr of %s is not a string", __func__, (attrName == NULL) ? "error attrName" :
+            attrName);
+        return HDF_FAILURE;
+    }
+    *value = (const char *)attr->data;
+    return HDF_SUCCESS;
+}
+
+int32_t HcsTableGetStringArrayElem(const struct HcsTableNode *node, const char *attrName, uint32_t index,
+    const char **value, const char *def)
+{
+    const struct HcsTableAttr *attr = NULL;
+    if (value == NULL) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+    *value = def;
+    attr = HcsTableGetAttr(node, attrName);
+    if ((attr == NULL) || (attr->type != HCS_TABLE_STRING) || !attr->isArray) {
+        HDF_LOGE("%s failed, the attr of %s is not a string array", __func__, (attrName == NULL) ?
+            "error attrName" : attrName);
+        return HDF_FAILURE;
+    }
+    if (index >= attr->count) {
+        HDF_LOGE("%s failed, index: %u >= count: %u", __func__, index, attr->count);
+        return HDF_FAILURE;
+    }
+    *value = ((const char *const *)attr->data)[index];
+    return HDF_SUCCESS;
+}
+
+int32_t HcsTableGetElemNum(const struct HcsTableNode *node, const char *attrName)
+{
+    const struct HcsTableAttr *attr = HcsTableGetAttr(node, attrName);
+    if ((attr == NULL) || !attr->isArray) {
+        HDF_LOGE("%s failed, the attr of %s is not an array", __func__, (attrName == NULL) ? "error attrName" :
+            attrName);
+        return HDF_FAILURE;
+    }
+    return attr->count;
+}
@@ -8,16 +8,26 @@
 
 #include "hcs_tree_if.h"
 #include "hcs_blob_if.h"
+#include "hcs_blob_index.h"
+#include "hcs_tree_index.h"
 #include "hdf_log.h"
 
 #define HDF_LOG_TAG hcs_tree_if
 
-static struct DeviceResourceAttr *GetAttrInNode(const struct DeviceResourceNode *node, const char *attrName)
+/* @attrBuf receives the attribute of nodes from the blob backend, which has no attribute objects. */
+static struct DeviceResourceAttr *GetAttrInNode(const struct DeviceResourceNode *node, const char *attrName,
+    struct DeviceResourceAttr *attrBuf)
 {
     struct DeviceResourceAttr *attr = NULL;
     if ((node == NULL) || (attrName == NULL)) {
         return NULL;
     }
+    if (HcsBlobIsNode(node)) {
+        return HcsBlobGetAttr(node, attrName, attrBuf);
+    }
+    if ((node->index != NULL) && (node->index->attrTable != NULL)) {
+        return (struct DeviceResourceAttr *)HcsIndexGetAttr(node->index, attrName);
+    }
     for (attr = node->attrData; attr != NULL; attr = attr->next) {
         if ((attr->name != NULL) && (strcmp(attr->name, attrName) == 0)) {
             break;
@@ -29,7 +39,8 @@ static struct DeviceResourceAttr *GetAttrInNode(const struct DeviceResourceNode
 bool HcsGetBool(const struct DeviceResourceNode *node, const char *attrName)
 {
     uint8_t value;
-    struct DeviceResourceAttr *attr = GetAttrInNode(node, attrName);
+    struct DeviceResourceAttr attrBuf;
+    struct DeviceResourceAttr *attr = GetAttrInNode(node, attrName, &attrBuf);
     if ((attr == NULL) || (attr->value == NULL)) {
         HDF_LOGE("%s failed, the node or attrName is NULL", __func__);
         return false;
@@ -55,7 +66,8 @@ bool HcsGetBool(const struct DeviceResourceNode *node, const char *attrName)
 
 int32_t HcsGetUint8(const struct DeviceResourceNode *node, const char *attrName, uint8_t *value, uint8_t def)
 {
-    struct DeviceResourceAttr *attr = GetAttrInNode(node, attrName);
+    struct DeviceResourceAttr attrBuf;
+    struct DeviceResourceAttr *attr = GetAttrInNode(node, attrName, &attrBuf);
     RETURN_DEFAULT_VALUE(attr, attrName, value, def);
 
     if (!HcsSwapToUint8(value, attr->value + HCS_PREFIX_LENGTH, HcsGetPrefix(attr->value))) {
@@ -68,7 +80,8 @@ int32_t HcsGetUint8(const struct DeviceResourceNode *node, const char *attrName,
 
 int32_t HcsGetUint16(const struct DeviceResourceNode *node, const char *attrName, uint16_t *value, uint16_t def)
 {
-    struct DeviceResourceAttr *attr = GetAttrInNode(node, attrName);
+    struct DeviceResourceAttr attrBuf;
+    struct DeviceResourceAttr *attr = GetAttrInNode(node, attrName, &attrBuf);
     RETURN_DEFAULT_VALUE(attr, attrName, value, def);
 
     if (!HcsSwapToUint16(value, attr->value + HCS_PREFIX_LENGTH, HcsGetPrefix(attr->value))) {
@@ -81,7 +94,8 @@ int32_t HcsGetUint16(const struct DeviceResourceNode *node, const char *attrName
 
 int32_t HcsGetUint32(const struct DeviceResourceNode *node, const char *attrName, uint32_t *value, uint32_t def)
 {
-    struct DeviceResourceAttr *attr = GetAttrInNode(node, attrName);
+    struct DeviceResourceAttr attrBuf;
+    struct DeviceResourceAttr *attr = GetAttrInNode(node, attrName, &attrBuf);
     RETURN_DEFAULT_VALUE(attr, attrName, value, def);
 
     if (!HcsSwapToUint32(value, attr->value + HCS_PREFIX_LENGTH, HcsGetPrefix(attr->value))) {
@@ -94,7 +108,8 @@ int32_t HcsGetUint32(const struct DeviceResourceNode *node, const char *attrName
 
 int32_t HcsGetUint64(const struct DeviceResourceNode *node, const char *attrName, uint64_t *value, uint64_t def)
 {
-    struct DeviceResourceAttr *attr = GetAttrInNode(node, attrName);
+    struct DeviceResourceAttr attrBuf;
+    struct DeviceResourceAttr *attr = GetAttrInNode(node, attrName, &attrBuf);
     RETURN_DEFAULT_VALUE(attr, attrName, value, def);
 
     if (!HcsSwapToUint64(value, attr->value + HCS_PREFIX_LENGTH, HcsGetPrefix(attr->value))) {
@@ -133,7 +148,8 @@ int32_t HcsGetUint8ArrayElem(const struct DeviceResourceNode *node, const char *
     uint8_t *value, uint8_t def)
 {
     const char *realValue = NULL;
-    struct DeviceResourceAttr *attr = GetAttrInNode(node, attrName);
+    struct DeviceResourceAttr attrBuf;
+    struct DeviceResourceAttr *attr = GetAttrInNode(node, attrName, &attrBuf);
     RETURN_DEFAULT_VALUE(attr, attrName, value, def);
 
     realValue = GetArrayElem(attr, index);
@@ -154,7 +170,8 @@ int32_t HcsGetUint16ArrayElem(const struct DeviceResourceNode *node, const char
     uint16_t *value, uint16_t def)
 {
     const char *realValue = NULL;
-    struct DeviceResourceAttr *attr = GetAttrInNode(node, attrName);
+    struct DeviceResourceAttr attrBuf;
+    struct DeviceResourceAttr *attr = GetAttrInNode(node, attrName, &attrBuf);
     RETURN_DEFAULT_VALUE(attr, attrName, value, def);
 
     realValue = GetArrayElem(attr, index);
@@ -175,7 +192,8 @@ int32_t HcsGetUint32ArrayElem(const struct DeviceResourceNode *node, const char
     uint32_t *value, uint32_t def)
 {
     const char *realValue = NULL;
-    struct DeviceResourceAttr *attr = GetAttrInNode(node, attrName);
+    struct DeviceResourceAttr attrBuf;
+    struct DeviceResourceAttr *attr = GetAttrInNode(node, attrName, &attrBuf);
     RETURN_DEFAULT_VALUE(attr, attrName, value, def);
 
     realValue = GetArrayElem(attr, index);
@@ -196,7 +214,8 @@ int32_t HcsGetUint64ArrayElem(const struct DeviceResourceNode *node, const char
     uint64_t *value, uint64_t def)
 {
     const char *realValue = NULL;
-    struct DeviceResourceAttr *attr = GetAttrInNode(node, attrName);
+    struct DeviceResourceAttr attrBuf;
+    struct DeviceResourceAttr *attr = GetAttrInNode(node, attrName, &attrBuf);
     RETURN_DEFAULT_VALUE(attr, attrName, value, def);
 
     realValue = GetArrayElem(attr, index);
@@ -297,7 +316,8 @@ int32_t HcsGetStringArrayElem(const struct DeviceResourceNode *node, const char
     const char **value, const char *def)
 {
     const char *realValue = NULL;
-    struct DeviceResourceAttr *attr = GetAttrInNode(node, attrName);
+    struct DeviceResourceAttr attrBuf;
+    struct DeviceResourceAttr *attr = GetAttrInNode(node, attrName, &attrBuf);
     RETURN_DEFAULT_VALUE(attr, attrName, value, def);
 
     realValue = GetArrayElem(attr, index);
@@ -312,7 +332,8 @@ int32_t HcsGetStringArrayElem(const struct DeviceResourceNode *node, const char
 
 int32_t HcsGetString(const struct DeviceResourceNode *node, const char *attrName, const char **value, const char *def)
 {
-    struct DeviceResourceAttr *attr = GetAttrInNode(node, attrName);
+    struct DeviceResourceAttr attrBuf;
+    struct DeviceResourceAttr *attr = GetAttrInNode(node, attrName, &attrBuf);
     RETURN_DEFAULT_VALUE(attr, attrName, value, def);
     if (HcsGetPrefix(attr->value) != CONFIG_STRING) {
         *value = def;
@@ -326,7 +347,8 @@ int32_t HcsGetString(const struct DeviceResourceNode *node, const char *attrName
 int32_t HcsGetElemNum(const struct DeviceResourceNode *node, const char *attrName)
 {
     uint16_t num;
-    struct DeviceResourceAttr *attr = GetAttrInNode(node, attrName);
+    struct DeviceResourceAttr attrBuf;
+    struct DeviceResourceAttr *attr = GetAttrInNode(node, attrName, &attrBuf);
     if ((attr == NULL) || (attr->value == NULL) || (HcsGetPrefix(attr->value) != CONFIG_ARRAY)) {
         HDF_LOGE("%s failed, %s attr error", __func__, (attrName == NULL) ? "error attrName" : attrName);
         return HDF_FAILURE;
@@ -370,6 +392,12 @@ const struct DeviceResourceNode *HcsGetNodeByMatchAttr(const struct DeviceResour
         return NULL;
     }
     curNode = (node != NULL) ? node : instance->GetRootNode();
+    if (HcsBlobIsNode(curNode)) {
+        return HcsBlobGetNodeByMatchAttr(curNode, attrValue);
+    }
+    if ((curNode != NULL) && (curNode->index != NULL)) {
+        return HcsIndexGetNodeByMatchAttr(curNode->index, attrValue);
+    }
     while (curNode != NULL) {
         if (GetAttrValueInNode(curNode, attrValue) != NULL) {
             break;
@@ -400,13 +428,20 @@ const struct DeviceResourceNode *HcsGetNodeByRefAttr(const struct DeviceResource
     uint32_t attrValue;
     struct DeviceResourceIface *instance = NULL;
     const struct DeviceResourceNode *curNode = NULL;
-    struct DeviceResourceAttr *attr = GetAttrInNode(node, attrName);
+    struct DeviceResourceAttr attrBuf;
+    struct DeviceResourceAttr *attr = GetAttrInNode(node, attrName, &attrBuf);
     if ((attr == NULL) || (attr->value == NULL) || (HcsGetPrefix(attr->value) != CONFIG_REFERENCE)) {
         HDF_LOGE("%s failed, %s attr error", __func__, (attrName == NULL) ? "error attrName" : attrName);
         return NULL;
     }
 
     (void)HcsSwapToUint32(&attrValue, attr->value + HCS_PREFIX_LENGTH, CONFIG_DWORD);
+    if (HcsBlobIsNode(node)) {
+        return HcsBlobGetNodeByRef(attrValue);
+    }
+    if (node->index != NULL) {
+        return HcsIndexGetNodeByRef(node->index->tree, attrValue);
+    }
     instance = DeviceResourceGetIfaceInstance(HDF_CONFIG_SOURCE);
     if ((instance == NULL) || (instance->GetRootNode == NULL)) {
         HDF_LOGE("%s failed, DeviceResourceGetIfaceInstance error", __func__);
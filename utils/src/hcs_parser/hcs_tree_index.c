@@ -0,0 +1,250 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ *
+ * HDF is dual licensed: you can use it either under the terms of
+ * the GPL, or the BSD license, at your option.
+ * See the LICENSE file in the root of this repository for complete details.
+ */
+
+#include "hcs_tree_index.h"
+#include "hcs_blob_if.h"
+#include "hcs_tree_if.h"
+#include "hdf_log.h"
+#include "hdf_map.h"
+
+#define HDF_LOG_TAG hcs_tree_index
+
+// Tables are sized to twice their entries and probed linearly.
+#define HCS_INDEX_LOAD_FACTOR 2
+#define HCS_INDEX_ALIGN(size) (((size) + sizeof(void *) - 1) & ~(sizeof(void *) - 1))
+
+struct HcsIndexArena {
+    char *cur;
+    char *end;
+};
+
+static void *HcsIndexCarve(struct HcsIndexArena *arena, uint32_t size)
+{
+    char *mem = arena->cur;
+    uint32_t alignSize = HCS_INDEX_ALIGN(size);
+    if ((uint32_t)(arena->end - arena->cur) < alignSize) {
+        return NULL;
+    }
+    arena->cur += alignSize;
+    return mem;
+}
+
+static struct DeviceResourceNode *HcsIndexNextNode(struct DeviceResourceNode *node)
+{
+    if (node->child != NULL) {
+        return node->child;
+    }
+    while ((node->parent != NULL) && (node->sibling == NULL)) {
+        node = node->parent;
+    }
+    return node->sibling;
+}
+
+uint32_t HcsTreeIndexSize(uint32_t nodeCount, uint32_t attrCount)
+{
+    uint32_t size = HCS_INDEX_ALIGN(sizeof(struct HcsTreeIndex));
+    size += nodeCount * HCS_INDEX_ALIGN(sizeof(struct HcsNodeIndex));
+    // per-node attribute tables, plus the ref and match_attr tables
+    size += HCS_INDEX_LOAD_FACTOR * attrCount * sizeof(void *);
+    size += HCS_INDEX_LOAD_FACTOR * nodeCount * sizeof(void *) * 2;
+    return size;
+}
+
+static uint32_t HcsIndexCountAttr(const struct DeviceResourceNode *node, const char **matchAttr)
+{
+    uint32_t count = 0;
+    const struct DeviceResourceAttr *attr = NULL;
+    *matchAttr = NULL;
+    for (attr = node->attrData; attr != NULL; attr = attr->next) {
+        count++;
+        // the first attribute in list order wins, the same as a linear lookup
+        if ((*matchAttr == NULL) && (attr->name != NULL) && (attr->value != NULL) &&
+            (strcmp(attr->name, HCS_MATCH_ATTR) == 0) && (HcsGetPrefix(attr->value) == CONFIG_STRING)) {
+            *matchAttr = attr->value + HCS_PREFIX_LENGTH;
+        }
+    }
+    return count;
+}
+
+static bool HcsIndexBuildAttrTable(struct HcsNodeIndex *index, const struct DeviceResourceNode *node,
+    uint32_t attrCount, struct HcsIndexArena *arena)
+{
+    const struct DeviceResourceAttr *attr = NULL;
+    uint32_t capacity = attrCount * HCS_INDEX_LOAD_FACTOR;
+    const struct DeviceResourceAttr **table =
+        (const struct DeviceResourceAttr **)HcsIndexCarve(arena, capacity * sizeof(*table));
+    if (table == NULL) {
+        return false;
+    }
+    for (attr = node->attrData; attr != NULL; attr = attr->next) {
+        uint32_t slot;
+        if (attr->name == NULL) {
+            continue;
+        }
+        slot = MapHashKey(attr->name) % capacity;
+        while ((table[slot] != NULL) && (strcmp(table[slot]->name, attr->name) != 0)) {
+            slot = (slot + 1) % capacity;
+        }
+        if (table[slot] == NULL) {
+            table[slot] = attr;
+        }
+    }
+    index->attrTable = table;
+    index->attrCapacity = capacity;
+    return true;
+}
+
+static void HcsIndexAddRef(struct HcsTreeIndex *tree, const struct DeviceResourceNode *node)
+{
+    uint32_t slot = node->hashValue % tree->refCapacity;
+    while (tree->refTable[slot] != NULL) {
+        slot = (slot + 1) % tree->refCapacity;
+    }
+    tree->refTable[slot] = node;
+}
+
+static void HcsIndexAddMatch(struct HcsTreeIndex *tree, const struct DeviceResourceNode *node)
+{
+    struct HcsNodeIndex *tail = NULL;
+    uint32_t slot = MapHashKey(node->index->matchAttr) % tree->matchCapacity;
+    while (tree->matchTable[slot] != NULL) {
+        if (strcmp(tree->matchTable[slot]->index->matchAttr, node->index->matchAttr) == 0) {
+            // nodes are added in preorder, so appending keeps each chain sorted
+            tail = (struct HcsNodeIndex *)tree->matchTable[slot]->index;
+            while (tail->matchNext != NULL) {
+                tail = (struct HcsNodeIndex *)tail->matchNext->index;
+            }
+            tail->matchNext = node;
+            return;
+        }
+        slot = (slot + 1) % tree->matchCapacity;
+    }
+    tree->matchTable[slot] = node;
+}
+
+static bool HcsIndexBuildNodes(struct HcsTreeIndex *tree, struct DeviceResourceNode *root,
+    struct HcsIndexArena *arena, uint32_t *matchCount)
+{
+    uint32_t order = 0;
+    struct DeviceResourceNode *node = NULL;
+
+    for (node = root; node != NULL; node = HcsIndexNextNode(node)) {
+        uint32_t attrCount;
+        struct HcsNodeIndex *index = (struct HcsNodeIndex *)HcsIndexCarve(arena, sizeof(*index));
+        if (index == NULL) {
+            return false;
+        }
+        index->tree = tree;
+        index->order = order++;
+        attrCount = HcsIndexCountAttr(node, &index->matchAttr);
+        if ((attrCount > HCS_ATTR_INDEX_MIN) && !HcsIndexBuildAttrTable(index, node, attrCount, arena)) {
+            return false;
+        }
+        if (index->matchAttr != NULL) {
+            (*matchCount)++;
+        }
+        node->index = index;
+        HcsIndexAddRef(tree, node);
+    }
+    return true;
+}
+
+static void HcsIndexReset(struct DeviceResourceNode *root)
+{
+    struct DeviceResourceNode *node = NULL;
+    for (node = root; node != NULL; node = HcsIndexNextNode(node)) {
+        node->index = NULL;
+    }
+}
+
+bool HcsTreeIndexBuild(struct DeviceResourceNode *root, uint32_t nodeCount, char *indexMem, uint32_t indexMemLength)
+{
+    uint32_t matchCount = 0;
+    struct DeviceResourceNode *node = NULL;
+    struct HcsIndexArena arena = { indexMem, indexMem + indexMemLength };
+    struct HcsTreeIndex *tree = (struct HcsTreeIndex *)HcsIndexCarve(&arena, sizeof(*tree));
+
+    if ((root == NULL) || (tree == NULL) || (nodeCount == 0)) {
+        return false;
+    }
+    tree->refCapacity = nodeCount * HCS_INDEX_LOAD_FACTOR;
+    tree->refTable = (const struct DeviceResourceNode **)HcsIndexCarve(&arena,
+        tree->refCapacity * sizeof(*tree->refTable));
+    if ((tree->refTable == NULL) || !HcsIndexBuildNodes(tree, root, &arena, &matchCount)) {
+        HDF_LOGE("%s failed, index memory exhausted", __func__);
+        HcsIndexReset(root);
+        return false;
+    }
+    if (matchCount == 0) {
+        return true;
+    }
+
+    tree->matchCapacity = matchCount * HCS_INDEX_LOAD_FACTOR;
+    tree->matchTable = (const struct DeviceResourceNode **)HcsIndexCarve(&arena,
+        tree->matchCapacity * sizeof(*tree->matchTable));
+    if (tree->matchTable == NULL) {
+        HDF_LOGE("%s failed, index memory exhausted", __func__);
+        HcsIndexReset(root);
+        return false;
+    }
+    for (node = root; node != NULL; node = HcsIndexNextNode(node)) {
+        if (node->index->matchAttr != NULL) {
+            HcsIndexAddMatch(tree, node);
+        }
+    }
+    return true;
+}
+
+const struct DeviceResourceAttr *HcsIndexGetAttr(const struct HcsNodeIndex *index, const char *attrName)
+{
+    uint32_t slot = MapHashKey(attrName) % index->attrCapacity;
+    while (index->attrTable[slot] != NULL) {
+        if (strcmp(index->attrTable[slot]->name, attrName) == 0) {
+            return index->attrTable[slot];
+        }
+        slot = (slot + 1) % index->attrCapacity;
+    }
+    return NULL;
+}
+
+const struct DeviceResourceNode *HcsIndexGetNodeByMatchAttr(const struct HcsNodeIndex *start, const char *attrValue)
+{
+    const struct HcsTreeIndex *tree = start->tree;
+    const struct DeviceResourceNode *node = NULL;
+    uint32_t slot;
+
+    if (tree->matchCapacity == 0) {
+        return NULL;
+    }
+    slot = MapHashKey(attrValue) % tree->matchCapacity;
+    while (tree->matchTable[slot] != NULL) {
+        if (strcmp(tree->matchTable[slot]->index->matchAttr, attrValue) == 0) {
+            break;
+        }
+        slot = (slot + 1) % tree->matchCapacity;
+    }
+    // a lookup starting at a node covers that node and every node after it in preorder
+    for (node = tree->matchTable[slot]; node != NULL; node = node->index->matchNext) {
+        if (node->index->order >= start->order) {
+            break;
+        }
+    }
+    return node;
+}
+
+const struct DeviceResourceNode *HcsIndexGetNodeByRef(const struct HcsTreeIndex *tree, uint32_t hashValue)
+{
+    uint32_t slot = hashValue % tree->refCapacity;
+    while (tree->refTable[slot] != NULL) {
+        if (tree->refTable[slot]->hashValue == hashValue) {
+            return tree->refTable[slot];
+        }
+        slot = (slot + 1) % tree->refCapacity;
+    }
+    return NULL;
+}
@@ -0,0 +1,41 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ *
+ * HDF is dual licensed: you can use it either under the terms of
+ * the GPL, or the BSD license, at your option.
+ * See the LICENSE file in the root of this repository for complete details.
+ */
+
+#ifndef HCS_TREE_INDEX_H
+#define HCS_TREE_INDEX_H
+
+#include "device_resource_if.h"
+
+/* Nodes with at most this many attributes are searched linearly. */
+#define HCS_ATTR_INDEX_MIN 4
+
+struct HcsTreeIndex {
+    const struct DeviceResourceNode **refTable;   // nodes hashed by hashValue
+    uint32_t refCapacity;
+    const struct DeviceResourceNode **matchTable; // first node in preorder of each match_attr value
+    uint32_t matchCapacity;
+};
+
+struct HcsNodeIndex {
+    const struct HcsTreeIndex *tree;
+    const struct DeviceResourceAttr **attrTable;  // attributes hashed by name, NULL for small nodes
+    uint32_t attrCapacity;
+    uint32_t order;                               // preorder position of the node in the tree
+    const char *matchAttr;                        // match_attr value of the node, or NULL
+    const struct DeviceResourceNode *matchNext;   // next node in preorder with the same match_attr value
+};
+
+/* Upper bound of the index memory for a tree, to be reserved in the tree arena. */
+uint32_t HcsTreeIndexSize(uint32_t nodeCount, uint32_t attrCount);
+bool HcsTreeIndexBuild(struct DeviceResourceNode *root, uint32_t nodeCount, char *indexMem, uint32_t indexMemLength);
+
+const struct DeviceResourceAttr *HcsIndexGetAttr(const struct HcsNodeIndex *index, const char *attrName);
+const struct DeviceResourceNode *HcsIndexGetNodeByMatchAttr(const struct HcsNodeIndex *start, const char *attrValue);
+const struct DeviceResourceNode *HcsIndexGetNodeByRef(const struct HcsTreeIndex *tree, uint32_t hashValue);
+
+#endif /* HCS_TREE_INDEX_H */
@@ -78,6 +78,10 @@ enum HdfTestCaseCmd {
     HDF_MACRO_TRAVERSAL_NODE_CHILD,
     HDF_MACRO_TRAVERSAL_NODE_CHILD_VARGS,
     HDF_MACRO_GET_ONE_FILE,
+    HDF_HCS_INDEX_LOOKUP_001,
+    HDF_HCS_BLOB_SOURCE_001,
+    HDF_HCS_BLOB_INDEX_001,
+    HDF_HCS_TABLE_001,
 };
 
 class HdfConfigTest : public testing::Test {
@@ -767,4 +771,52 @@ HWTEST_F(HdfConfigTest, HslTestMacroTraversalOneFile, TestSize.Level1)
     printf("HdfConfigTest last enter\n\r");
     EXPECT_EQ(0, HdfTestSendMsgToService(&msg));
 }
+
+/**
+ * @tc.name: HslTestIndexLookup001
+ * @tc.desc: indexed attribute, match_attr and reference lookups agree with a tree walk
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(HdfConfigTest, HslTestIndexLookup001, TestSize.Level1)
+{
+    struct HdfTestMsg msg = {TEST_CONFIG_TYPE, HDF_HCS_INDEX_LOOKUP_001, HDF_MSG_RESULT_DEFAULT};
+    EXPECT_EQ(0, HdfTestSendMsgToService(&msg));
+}
+
+/**
+ * @tc.name: HslTestBlobSource001
+ * @tc.desc: the blob config source reads the same nodes and attributes as the tree source
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(HdfConfigTest, HslTestBlobSource001, TestSize.Level1)
+{
+    struct HdfTestMsg msg = {TEST_CONFIG_TYPE, HDF_HCS_BLOB_SOURCE_001, HDF_MSG_RESULT_DEFAULT};
+    EXPECT_EQ(0, HdfTestSendMsgToService(&msg));
+}
+
+/**
+ * @tc.name: HslTestBlobIndex001
+ * @tc.desc: the index embedded by hc-gen -x answers lookups like the index built at runtime
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(HdfConfigTest, HslTestBlobIndex001, TestSize.Level1)
+{
+    struct HdfTestMsg msg = {TEST_CONFIG_TYPE, HDF_HCS_BLOB_INDEX_001, HDF_MSG_RESULT_DEFAULT};
+    EXPECT_EQ(0, HdfTestSendMsgToService(&msg));
+}
+
+/**
+ * @tc.name: HslTestTable001
+ * @tc.desc: the getters of hcs_table.c read the values of a table generated by hc-gen -c
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(HdfConfigTest, HslTestTable001, TestSize.Level1)
+{
+    struct HdfTestMsg msg = {TEST_CONFIG_TYPE, HDF_HCS_TABLE_001, HDF_MSG_RESULT_DEFAULT};
+    EXPECT_EQ(0, HdfTestSendMsgToService(&msg));
+}
 };
@@ -7,6 +7,7 @@
  */
 
 #include "hdf_map.h"
+#include "hdf_map_table.h"
 #if defined(__KERNEL__)
 #include <linux/string.h>
 #else
@@ -128,6 +129,9 @@ int32_t MapSet(Map *map, const char *key, const void *value, uint32_t valueSize)
         return HDF_ERR_INVALID_PARAM;
     }
     hash = MapHash(key);
+    if (map->type == MAP_TYPE_OPEN) {
+        return MapTableSet(map, key, hash, value, valueSize);
+    }
     if (map->nodeSize > 0 && map->nodes != NULL) {
         uint32_t idx = MapHashIdx(map, hash);
         node = map->nodes[idx];
@@ -166,17 +170,26 @@ int32_t MapSet(Map *map, const char *key, const void *value, uint32_t valueSize)
     return HDF_SUCCESS;
 }
 
-void* MapGet(const Map *map, const char *key)
+uint32_t MapHashKey(const char *key)
+{
+    return (key == NULL) ? 0 : MapHash(key);
+}
+
+void *MapGetByHash(const Map *map, const char *key, uint32_t hash)
 {
-    uint32_t hash;
     uint32_t idx;
     struct MapNode *node = NULL;
 
-    if (map == NULL || key == NULL || map->nodeSize == 0 || map->nodes == NULL) {
+    if (map == NULL || key == NULL || map->nodeSize == 0) {
+        return NULL;
+    }
+    if (map->type == MAP_TYPE_OPEN) {
+        return MapTableGet(map, key, hash);
+    }
+    if (map->nodes == NULL) {
         return NULL;
     }
 
-    hash = MapHash(key);
     idx = MapHashIdx(map, hash);
     node = map->nodes[idx];
 
@@ -191,6 +204,15 @@ void* MapGet(const Map *map, const char *key)
     return NULL;
 }
 
+void* MapGet(const Map *map, const char *key)
+{
+    if (map == NULL || key == NULL || map->nodeSize == 0) {
+        return NULL;
+    }
+
+    return MapGetByHash(map, key, MapHash(key));
+}
+
 int32_t MapErase(Map *map, const char *key)
 {
     uint32_t hash;
@@ -198,7 +220,13 @@ int32_t MapErase(Map *map, const char *key)
     struct MapNode *node = NULL;
     struct MapNode *prev = NULL;
 
-    if (map == NULL || key == NULL || map->nodeSize == 0 || map->nodes == NULL) {
+    if (map == NULL || key == NULL || map->nodeSize == 0) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+    if (map->type == MAP_TYPE_OPEN) {
+        return MapTableErase(map, key, MapHash(key));
+    }
+    if (map->nodes == NULL) {
         return HDF_ERR_INVALID_PARAM;
     }
 
@@ -234,6 +262,16 @@ void MapInit(Map *map)
     map->nodes = NULL;
     map->nodeSize = 0;
     map->bucketSize = 0;
+    map->type = MAP_TYPE_CHAINED;
+    map->table = NULL;
+}
+
+void MapInitWithType(Map *map, uint32_t type)
+{
+    MapInit(map);
+    if (map != NULL && type == MAP_TYPE_OPEN) {
+        map->type = MAP_TYPE_OPEN;
+    }
 }
 
 void MapDelete(Map *map)
@@ -242,7 +280,15 @@ void MapDelete(Map *map)
     struct MapNode *node = NULL;
     struct MapNode *next = NULL;
 
-    if (map == NULL || map->nodes == NULL) {
+    if (map == NULL) {
+        return;
+    }
+    if (map->type == MAP_TYPE_OPEN) {
+        MapTableDelete(map);
+        map->nodeSize = 0;
+        return;
+    }
+    if (map->nodes == NULL) {
         return;
     }
 
@@ -0,0 +1,467 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ *
+ * HDF is dual licensed: you can use it either under the terms of
+ * the GPL, or the BSD license, at your option.
+ * See the LICENSE file in the root of this repository for complete details.
+ */
+
+#include "hdf_map_table.h"
+#if defined(__KERNEL__)
+#include <linux/string.h>
+#else
+#include <string.h>
+#endif
+#include "osal_mem.h"
+#include "securec.h"
+
+/*
+ * Slots are probed a group of control bytes at a time. A control byte is MAP_CTRL_EMPTY,
+ * MAP_CTRL_DELETED or a 7-bit tag of the key hash of a full slot, so most mismatching
+ * slots are skipped without touching their entries. The group bytes are matched in one
+ * 64-bit word, which works the same in kernel and user space. A group fills one cache line,
+ * its last control byte is a sentinel that matches nothing.
+ */
+#define MAP_GROUP_WIDTH 8
+#define MAP_GROUP_SLOTS (MAP_GROUP_WIDTH - 1)
+#define MAP_CTRL_EMPTY 0x80
+#define MAP_CTRL_DELETED 0xFE
+#define MAP_CTRL_SENTINEL 0xFF
+#define MAP_CTRL_FULL_MASK 0x80
+#define MAP_H2_MULTIPLIER 0x9E3779B1U
+#define MAP_H2_SHIFT 25
+#define MAP_BYTE_BITS 8
+#define MAP_LSBS 0x0101010101010101ULL
+#define MAP_MSBS 0x8080808080808080ULL
+#define MAP_EMPTY_SHIFT 6
+#define MAP_EMPTY_OR_DELETED_SHIFT 7
+#define MAP_CACHE_LINE 64
+#define MAP_SLOT_NONE 0xFFFFFFFF
+#define MAP_MAX_LOAD(capacity) ((capacity) - ((capacity) + 7) / 8)
+#define MAP_SLAB_SIZE 4096
+#define MAP_ALIGN 8
+#define MAP_ALIGN_UP(size) (((size) + MAP_ALIGN - 1) & ~(MAP_ALIGN - 1))
+#define MAP_HOLE_BUCKETS 16
+
+/*
+ * Keys and values are carved from slabs and never move, so value pointers stay valid until their key is
+ * erased. An erased entry at the end of the current slab is given back to it, any other becomes a hole
+ * that the next entry of the same size reuses. Entries are carved only when no hole of their size is left,
+ * so the slabs hold at most the peak live bytes of each entry size plus the unused tail of each slab, and
+ * set/erase churn at a steady size does not grow them. A slab is released when its last entry is erased.
+ */
+struct MapSlab {
+    struct MapSlab *next;
+    uint32_t size;
+    uint32_t used;
+    uint32_t live;
+    uint32_t reserved;
+    uint64_t data[];
+};
+
+/* An entry is carved from a slab, the key follows the header and the value is aligned after the key. */
+struct MapEntry {
+    struct MapSlab *slab;
+    uint32_t hash;
+    uint32_t valueSize;
+    uint32_t valueOffset;
+    uint32_t reserved;
+    char key[];
+};
+
+/* An erased entry waiting for reuse, it fits in the header and key of the smallest entry. */
+struct MapHole {
+    struct MapSlab *slab;
+    uint32_t size;
+    uint32_t reserved;
+    struct MapHole *next;
+};
+
+/* Control bytes are kept next to the entries of the group, a probe touches the group and the entry. */
+struct MapGroup {
+    union {
+        uint8_t ctrl[MAP_GROUP_WIDTH];
+        uint64_t word;
+    };
+    struct MapEntry *entries[MAP_GROUP_SLOTS];
+};
+
+struct MapTable {
+    struct MapGroup *groups;
+    uint32_t groupCount;
+    uint32_t capacity;
+    uint32_t growthLeft;
+    uint32_t deleted;
+    struct MapSlab *slabs;
+    struct MapHole *holes[MAP_HOLE_BUCKETS];
+};
+
+/* The group comes from the low bits of the key hash, the control byte from its multiplied high bits. */
+static uint8_t MapTableH2(uint32_t hash)
+{
+    return (uint8_t)((hash * MAP_H2_MULTIPLIER) >> MAP_H2_SHIFT);
+}
+
+static uint64_t MapGroupLoad(const struct MapGroup *group)
+{
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+    return __builtin_bswap64(group->word);
+#else
+    return group->word;
+#endif
+}
+
+static uint64_t MapGroupMatch(uint64_t group, uint8_t h2)
+{
+    uint64_t x = group ^ (MAP_LSBS * h2);
+    /* may report a full slot next to a true match, entries are verified anyway */
+    return (x - MAP_LSBS) & ~x & MAP_MSBS;
+}
+
+static uint64_t MapGroupMatchEmpty(uint64_t group)
+{
+    return group & ~(group << MAP_EMPTY_SHIFT) & MAP_MSBS;
+}
+
+static uint64_t MapGroupMatchEmptyOrDeleted(uint64_t group)
+{
+    return group & ~(group << MAP_EMPTY_OR_DELETED_SHIFT) & MAP_MSBS;
+}
+
+static uint32_t MapGroupLowestByte(uint64_t mask)
+{
+    return (uint32_t)__builtin_ctzll(mask) / MAP_BYTE_BITS;
+}
+
+static void *MapEntryValue(struct MapEntry *entry)
+{
+    return (uint8_t *)entry + entry->valueOffset;
+}
+
+static uint32_t MapTableFind(const struct MapTable *table, const char *key, uint32_t hash)
+{
+    uint32_t groupMask = table->groupCount - 1;
+    uint32_t index = hash & groupMask;
+    uint8_t h2 = MapTableH2(hash);
+    uint32_t step;
+
+    for (step = 0; step <= groupMask; step++) {
+        const struct MapGroup *group = &table->groups[index];
+        uint64_t word = MapGroupLoad(group);
+        uint64_t match = MapGroupMatch(word, h2);
+        while (match != 0) {
+            uint32_t pos = MapGroupLowestByte(match);
+            const struct MapEntry *entry = group->entries[pos];
+            if (entry->hash == hash && strcmp(entry->key, key) == 0) {
+                return index * MAP_GROUP_WIDTH + pos;
+            }
+            match &= match - 1;
+        }
+        if (MapGroupMatchEmpty(word) != 0) {
+            break;
+        }
+        index = (index + step + 1) & groupMask;
+    }
+
+    return MAP_SLOT_NONE;
+}
+
+static uint32_t MapTableFindFree(const struct MapTable *table, uint32_t hash)
+{
+    uint32_t groupMask = table->groupCount - 1;
+    uint32_t index = hash & groupMask;
+    uint32_t step;
+
+    for (step = 0; step <= groupMask; step++) {
+        uint64_t match = MapGroupMatchEmptyOrDeleted(MapGroupLoad(&table->groups[index]));
+        if (match != 0) {
+            return index * MAP_GROUP_WIDTH + MapGroupLowestByte(match);
+        }
+        index = (index + step + 1) & groupMask;
+    }
+
+    return MAP_SLOT_NONE;
+}
+
+static void MapTableFill(struct MapTable *table, uint32_t slot, uint8_t ctrl, struct MapEntry *entry)
+{
+    struct MapGroup *group = &table->groups[slot / MAP_GROUP_WIDTH];
+    group->ctrl[slot % MAP_GROUP_WIDTH] = ctrl;
+    group->entries[slot % MAP_GROUP_WIDTH] = entry;
+}
+
+static int32_t MapTableRehash(struct MapTable *table, uint32_t groupCount, uint32_t count)
+{
+    struct MapGroup *oldGroups = table->groups;
+    uint32_t oldGroupCount = table->groupCount;
+    struct MapGroup *groups = NULL;
+    uint32_t i;
+    uint32_t pos;
+
+    groups = (struct MapGroup *)OsalMemAllocAlign(MAP_CACHE_LINE, groupCount * sizeof(struct MapGroup));
+    if (groups == NULL) {
+        return HDF_ERR_MALLOC_FAIL;
+    }
+    (void)memset_s(groups, groupCount * sizeof(struct MapGroup), 0, groupCount * sizeof(struct MapGroup));
+    for (i = 0; i < groupCount; i++) {
+        (void)memset_s(groups[i].ctrl, MAP_GROUP_SLOTS, MAP_CTRL_EMPTY, MAP_GROUP_SLOTS);
+        groups[i].ctrl[MAP_GROUP_SLOTS] = MAP_CTRL_SENTINEL;
+    }
+    table->groups = groups;
+    table->groupCount = groupCount;
+    table->capacity = groupCount * MAP_GROUP_SLOTS;
+
+    /* entries are relinked, keys and values stay where they are */
+    for (i = 0; i < oldGroupCount; i++) {
+        for (pos = 0; pos < MAP_GROUP_SLOTS; pos++) {
+            if ((oldGroups[i].ctrl[pos] & MAP_CTRL_FULL_MASK) != 0) {
+                continue;
+            }
+            struct MapEntry *entry = oldGroups[i].entries[pos];
+            MapTableFill(table, MapTableFindFree(table, entry->hash), MapTableH2(entry->hash), entry);
+        }
+    }
+    table->growthLeft = MAP_MAX_LOAD(table->capacity) - count;
+    table->deleted = 0;
+
+    OsalMemFree(oldGroups);
+    return HDF_SUCCESS;
+}
+
+static int32_t MapTableGrow(Map *map)
+{
+    struct MapTable *table = map->table;
+    uint32_t groupCount = 1;
+
+    if (table == NULL) {
+        table = (struct MapTable *)OsalMemCalloc(sizeof(*table));
+        if (table == NULL) {
+            return HDF_ERR_MALLOC_FAIL;
+        }
+        map->table = table;
+    } else if (table->deleted * 2 >= MAP_MAX_LOAD(table->capacity)) {
+        /* mostly tombstones, clean them up in place */
+        groupCount = table->groupCount;
+    } else {
+        groupCount = table->groupCount * 2;
+    }
+
+    return MapTableRehash(table, groupCount, map->nodeSize);
+}
+
+static uint32_t MapEntrySize(const struct MapEntry *entry)
+{
+    return entry->valueOffset + MAP_ALIGN_UP(entry->valueSize);
+}
+
+static struct MapHole **MapHoleBucket(struct MapTable *table, uint32_t size)
+{
+    return &table->holes[(size / MAP_ALIGN) % MAP_HOLE_BUCKETS];
+}
+
+static struct MapEntry *MapHoleTake(struct MapTable *table, uint32_t size)
+{
+    struct MapHole **link = NULL;
+    struct MapHole *hole = NULL;
+
+    for (link = MapHoleBucket(table, size); *link != NULL; link = &(*link)->next) {
+        if ((*link)->size == size) {
+            hole = *link;
+            *link = hole->next;
+            hole->slab->live++;
+            return (struct MapEntry *)hole;
+        }
+    }
+    return NULL;
+}
+
+/* holes of a slab going empty must not be handed out once it is reset or freed */
+static void MapHolePurge(struct MapTable *table, const struct MapSlab *slab)
+{
+    struct MapHole **link = NULL;
+    uint32_t i;
+
+    for (i = 0; i < MAP_HOLE_BUCKETS; i++) {
+        link = &table->holes[i];
+        while (*link != NULL) {
+            if ((*link)->slab == slab) {
+                *link = (*link)->next;
+            } else {
+                link = &(*link)->next;
+            }
+        }
+    }
+}
+
+static struct MapEntry *MapSlabAlloc(struct MapTable *table, uint32_t size)
+{
+    struct MapSlab *slab = table->slabs;
+    struct MapEntry *entry = MapHoleTake(table, size);
+
+    if (entry != NULL) {
+        return entry;
+    }
+    if (slab == NULL || slab->size - slab->used < size) {
+        uint32_t slabSize = (size > MAP_SLAB_SIZE) ? size : MAP_SLAB_SIZE;
+        slab = (struct MapSlab *)OsalMemAlloc(sizeof(struct MapSlab) + slabSize);
+        if (slab == NULL) {
+            return NULL;
+        }
+        slab->size = slabSize;
+        slab->used = 0;
+        slab->live = 0;
+        slab->next = table->slabs;
+        table->slabs = slab;
+    }
+
+    entry = (struct MapEntry *)((uint8_t *)slab->data + slab->used);
+    entry->slab = slab;
+    slab->used += size;
+    slab->live++;
+    return entry;
+}
+
+static void MapSlabRelease(struct MapTable *table, struct MapEntry *entry)
+{
+    struct MapSlab *slab = entry->slab;
+    uint32_t size = MapEntrySize(entry);
+    struct MapHole *hole = NULL;
+    struct MapSlab **link = NULL;
+
+    if (--slab->live == 0) {
+        MapHolePurge(table, slab);
+        if (slab == table->slabs) {
+            slab->used = 0;
+            return;
+        }
+        for (link = &table->slabs; *link != NULL; link = &(*link)->next) {
+            if (*link == slab) {
+                *link = slab->next;
+                OsalMemFree(slab);
+                return;
+            }
+        }
+        return;
+    }
+    if (slab == table->slabs && (uint8_t *)entry + size == (uint8_t *)slab->data + slab->used) {
+        slab->used -= size;
+        return;
+    }
+    hole = (struct MapHole *)entry;
+    hole->size = size;
+    hole->next = *MapHoleBucket(table, size);
+    *MapHoleBucket(table, size) = hole;
+}
+
+static struct MapEntry *MapTableEntry(const struct MapTable *table, uint32_t slot)
+{
+    return table->groups[slot / MAP_GROUP_WIDTH].entries[slot % MAP_GROUP_WIDTH];
+}
+
+int32_t MapTableSet(Map *map, const char *key, uint32_t hash, const void *value, uint32_t valueSize)
+{
+    struct MapTable *table = map->table;
+    struct MapEntry *entry = NULL;
+    uint32_t keySize = strlen(key) + 1;
+    uint32_t valueOffset;
+    uint32_t slot;
+
+    if (table != NULL && map->nodeSize > 0) {
+        slot = MapTableFind(table, key, hash);
+        if (slot != MAP_SLOT_NONE) {
+            entry = MapTableEntry(table, slot);
+            if (entry->valueSize != valueSize) {
+                return HDF_ERR_INVALID_OBJECT;
+            }
+            return (memcpy_s(MapEntryValue(entry), entry->valueSize, value, valueSize) != EOK) ?
+                HDF_FAILURE : HDF_SUCCESS;
+        }
+    }
+    if (table == NULL || table->growthLeft == 0) {
+        if (MapTableGrow(map) != HDF_SUCCESS) {
+            return HDF_ERR_MALLOC_FAIL;
+        }
+        table = map->table;
+    }
+
+    valueOffset = MAP_ALIGN_UP(sizeof(struct MapEntry) + keySize);
+    entry = MapSlabAlloc(table, valueOffset + MAP_ALIGN_UP(valueSize));
+    if (entry == NULL) {
+        return HDF_ERR_MALLOC_FAIL;
+    }
+    entry->hash = hash;
+    entry->valueSize = valueSize;
+    entry->valueOffset = valueOffset;
+    if (memcpy_s(entry->key, keySize, key, keySize) != EOK ||
+        memcpy_s(MapEntryValue(entry), valueSize, value, valueSize) != EOK) {
+        MapSlabRelease(table, entry);
+        return HDF_FAILURE;
+    }
+
+    slot = MapTableFindFree(table, hash);
+    if (table->groups[slot / MAP_GROUP_WIDTH].ctrl[slot % MAP_GROUP_WIDTH] == MAP_CTRL_DELETED) {
+        table->deleted--;
+    } else {
+        table->growthLeft--;
+    }
+    MapTableFill(table, slot, MapTableH2(hash), entry);
+    map->nodeSize++;
+
+    return HDF_SUCCESS;
+}
+
+void *MapTableGet(const Map *map, const char *key, uint32_t hash)
+{
+    uint32_t slot;
+
+    if (map->table == NULL) {
+        return NULL;
+    }
+    slot = MapTableFind(map->table, key, hash);
+    return (slot != MAP_SLOT_NONE) ? MapEntryValue(MapTableEntry(map->table, slot)) : NULL;
+}
+
+int32_t MapTableErase(Map *map, const char *key, uint32_t hash)
+{
+    struct MapTable *table = map->table;
+    uint32_t slot;
+
+    if (table == NULL) {
+        return HDF_FAILURE;
+    }
+    slot = MapTableFind(table, key, hash);
+    if (slot == MAP_SLOT_NONE) {
+        return HDF_FAILURE;
+    }
+
+    MapSlabRelease(table, MapTableEntry(table, slot));
+    /* a group that still has an empty slot never made a probe go on, no tombstone is needed */
+    if (MapGroupMatchEmpty(MapGroupLoad(&table->groups[slot / MAP_GROUP_WIDTH])) != 0) {
+        MapTableFill(table, slot, MAP_CTRL_EMPTY, NULL);
+        table->growthLeft++;
+    } else {
+        MapTableFill(table, slot, MAP_CTRL_DELETED, NULL);
+        table->deleted++;
+    }
+    map->nodeSize--;
+
+    return HDF_SUCCESS;
+}
+
+void MapTableDelete(Map *map)
+{
+    struct MapTable *table = map->table;
+    struct MapSlab *slab = NULL;
+
+    if (table == NULL) {
+        return;
+    }
+    while (table->slabs != NULL) {
+        slab = table->slabs;
+        table->slabs = slab->next;
+        OsalMemFree(slab);
+    }
+    OsalMemFree(table->groups);
+    OsalMemFree(table);
+    map->table = NULL;
+}
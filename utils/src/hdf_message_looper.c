@@ -10,6 +10,46 @@
 #include "hdf_message_task.h"
 #include "osal_message.h"
 
+static void HdfMessageLooperExit(struct HdfMessageLooper *looper, struct HdfMessage *message)
+{
+    HdfMessageRecycle(message);
+    OsalMessageQueueDestroy(&looper->messageQueue);
+    looper->isRunning = false;
+}
+
+static void HdfMessageLooperDispatch(struct HdfMessage *message)
+{
+    if (message->target != NULL) {
+        struct HdfMessageTask *task = message->target;
+        task->DispatchMessage(task, message);
+    }
+    HdfMessageRecycle(message);
+}
+
+static void HdfMessageLooperRunBatch(struct HdfMessageLooper *looper)
+{
+    struct HdfMessage *message = NULL;
+    struct HdfMessage *next = NULL;
+
+    while (looper->isRunning) {
+        message = HdfMessageQueueDrain(&looper->messageQueue);
+        for (; message != NULL; message = next) {
+            next = (struct HdfMessage *)message->entry.next;
+            if (message->messageId == MESSAGE_STOP_LOOP) {
+                /* messages behind the stop request in this batch are dropped like the queued ones */
+                while (next != NULL) {
+                    struct HdfMessage *drop = next;
+                    next = (struct HdfMessage *)drop->entry.next;
+                    HdfMessageRecycle(drop);
+                }
+                HdfMessageLooperExit(looper, message);
+                break;
+            }
+            HdfMessageLooperDispatch(message);
+        }
+    }
+}
+
 void HdfMessageLooperStart(struct HdfMessageLooper *looper)
 {
     struct HdfMessage *message = NULL;
@@ -17,19 +57,18 @@ void HdfMessageLooperStart(struct HdfMessageLooper *looper)
         return;
     }
     looper->isRunning = true;
+    if (looper->drainAll) {
+        HdfMessageLooperRunBatch(looper);
+        return;
+    }
     while (true) {
         message = HdfMessageQueueNext(&looper->messageQueue);
         if (message != NULL) {
             if (message->messageId == MESSAGE_STOP_LOOP) {
-                HdfMessageRecycle(message);
-                OsalMessageQueueDestroy(&looper->messageQueue);
-                looper->isRunning = false;
+                HdfMessageLooperExit(looper, message);
                 break;
-            } else if (message->target != NULL) {
-                struct HdfMessageTask *task = message->target;
-                task->DispatchMessage(task, message);
             }
-            HdfMessageRecycle(message);
+            HdfMessageLooperDispatch(message);
         }
     }
 }
@@ -51,6 +90,7 @@ void HdfMessageLooperConstruct(struct HdfMessageLooper *looper)
 {
     if (looper != NULL) {
         OsalMessageQueueInit(&looper->messageQueue);
+        looper->drainAll = false;
         looper->Start = HdfMessageLooperStart;
         looper->Stop = HdfMessageLooperStop;
     }
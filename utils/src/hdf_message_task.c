@@ -21,7 +21,7 @@ int32_t HdfMessageTaskSendMessageLater(
         if (sync) {
             if (task->messageHandler != NULL && task->messageHandler->Dispatch != NULL) {
                 int ret = task->messageHandler->Dispatch(task, msg);
-                OsalMemFree(msg);
+                HdfMessageRecycle(msg);
                 return ret;
             }
         } else {
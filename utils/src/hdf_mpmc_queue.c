@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ *
+ * HDF is dual licensed: you can use it either under the terms of
+ * the GPL, or the BSD license, at your option.
+ * See the LICENSE file in the root of this repository for complete details.
+ */
+
+#include "hdf_mpmc_queue.h"
+#include "hdf_log.h"
+#include "osal_mem.h"
+
+#define HDF_LOG_TAG hdf_mpmc_queue
+
+#define HDF_MPMC_CAPACITY_MAX (1U << 24)
+
+static uint32_t HdfMpmcRoundUp(uint32_t capacity)
+{
+    uint32_t size = 1;
+    while (size < capacity) {
+        size <<= 1;
+    }
+    return size;
+}
+
+int32_t HdfMpmcQueueInit(struct HdfMpmcQueue *queue, uint32_t capacity)
+{
+    uint32_t size;
+
+    if (queue == NULL || capacity == 0 || capacity > HDF_MPMC_CAPACITY_MAX) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+
+    size = HdfMpmcRoundUp(capacity);
+    queue->cells = (void **)OsalMemCalloc(sizeof(void *) * size);
+    if (queue->cells == NULL) {
+        HDF_LOGE("%s: alloc %u cells fail", __func__, size);
+        return HDF_ERR_MALLOC_FAIL;
+    }
+    queue->mask = size - 1;
+    queue->enqueuePos = 0;
+    queue->dequeuePos = 0;
+    OsalAtomicSet(&queue->freeSlots, (int32_t)size);
+    OsalAtomicSet(&queue->filledSlots, 0);
+    OsalAtomicSet(&queue->waiters, 0);
+
+    if (OsalSpinInit(&queue->enqueueLock) != HDF_SUCCESS) {
+        goto ERROR;
+    }
+    if (OsalSpinInit(&queue->dequeueLock) != HDF_SUCCESS) {
+        (void)OsalSpinDestroy(&queue->enqueueLock);
+        goto ERROR;
+    }
+    if (OsalSemInit(&queue->sem, 0) != HDF_SUCCESS) {
+        (void)OsalSpinDestroy(&queue->dequeueLock);
+        (void)OsalSpinDestroy(&queue->enqueueLock);
+        goto ERROR;
+    }
+    return HDF_SUCCESS;
+
+ERROR:
+    HDF_LOGE("%s: init lock fail", __func__);
+    OsalMemFree(queue->cells);
+    queue->cells = NULL;
+    return HDF_FAILURE;
+}
+
+void HdfMpmcQueueDestroy(struct HdfMpmcQueue *queue)
+{
+    if (queue == NULL || queue->cells == NULL) {
+        return;
+    }
+    (void)OsalSemDestroy(&queue->sem);
+    (void)OsalSpinDestroy(&queue->dequeueLock);
+    (void)OsalSpinDestroy(&queue->enqueueLock);
+    OsalMemFree(queue->cells);
+    queue->cells = NULL;
+}
+
+bool HdfMpmcQueueTryPush(struct HdfMpmcQueue *queue, void *data)
+{
+    uint32_t flags = 0;
+
+    if (OsalAtomicRead(&queue->freeSlots) == 0) {
+        return false;
+    }
+    (void)OsalSpinLockIrqSave(&queue->enqueueLock, &flags);
+    /* only producers take free slots and they hold this lock, so the count can not drop under us */
+    if (OsalAtomicRead(&queue->freeSlots) == 0) {
+        (void)OsalSpinUnlockIrqRestore(&queue->enqueueLock, &flags);
+        return false;
+    }
+    (void)OsalAtomicDecReturn(&queue->freeSlots);
+    queue->cells[queue->enqueuePos & queue->mask] = data;
+    queue->enqueuePos++;
+    /* cells are published in order, a consumer never sees a filled slot before its data */
+    (void)OsalAtomicIncReturn(&queue->filledSlots);
+    (void)OsalSpinUnlockIrqRestore(&queue->enqueueLock, &flags);
+    return true;
+}
+
+void *HdfMpmcQueueTryPop(struct HdfMpmcQueue *queue)
+{
+    uint32_t flags = 0;
+    void *data = NULL;
+
+    if (OsalAtomicRead(&queue->filledSlots) == 0) {
+        return NULL;
+    }
+    (void)OsalSpinLockIrqSave(&queue->dequeueLock, &flags);
+    if (OsalAtomicRead(&queue->filledSlots) == 0) {
+        (void)OsalSpinUnlockIrqRestore(&queue->dequeueLock, &flags);
+        return NULL;
+    }
+    (void)OsalAtomicDecReturn(&queue->filledSlots);
+    data = queue->cells[queue->dequeuePos & queue->mask];
+    queue->dequeuePos++;
+    /* cells are released in order, a producer never overwrites one that is still being read */
+    (void)OsalAtomicIncReturn(&queue->freeSlots);
+    (void)OsalSpinUnlockIrqRestore(&queue->dequeueLock, &flags);
+    return data;
+}
+
+int32_t HdfMpmcQueueOffer(struct HdfMpmcQueue *queue, void *data)
+{
+    if (queue == NULL || data == NULL) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+    if (!HdfMpmcQueueTryPush(queue, data)) {
+        return HDF_ERR_QUEUE_FULL;
+    }
+    /*
+     * the filled slot increment in the push and the waiter increment in HdfMpmcQueuePoll are both full
+     * barriers, so either the consumer sees the data or this sees the waiter
+     */
+    if (OsalAtomicRead(&queue->waiters) != 0) {
+        (void)OsalSemPost(&queue->sem);
+    }
+    return HDF_SUCCESS;
+}
+
+void *HdfMpmcQueuePoll(struct HdfMpmcQueue *queue, uint32_t timeout)
+{
+    void *data = NULL;
+
+    if (queue == NULL) {
+        return NULL;
+    }
+    data = HdfMpmcQueueTryPop(queue);
+    if (data != NULL) {
+        return data;
+    }
+
+    (void)OsalAtomicIncReturn(&queue->waiters);
+    data = HdfMpmcQueueTryPop(queue);
+    if (data == NULL) {
+        (void)OsalSemWait(&queue->sem, timeout);
+        data = HdfMpmcQueueTryPop(queue);
+    }
+    (void)OsalAtomicDecReturn(&queue->waiters);
+    return data;
+}
+
+void HdfMpmcQueueWake(struct HdfMpmcQueue *queue)
+{
+    if (queue != NULL) {
+        (void)OsalSemPost(&queue->sem);
+    }
+}
@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ *
+ * HDF is dual licensed: you can use it either under the terms of
+ * the GPL, or the BSD license, at your option.
+ * See the LICENSE file in the root of this repository for complete details.
+ */
+
+#include "hdf_once.h"
+#include "hdf_log.h"
+#include "osal_atomic.h"
+#include "osal_mutex.h"
+#include "osal_time.h"
+
+#define HDF_LOG_TAG hdf_once
+
+#define HDF_ONCE_LOCK_WAIT_MS 1
+
+static struct OsalMutex g_onceLock;
+static OsalAtomic g_onceLockClaim = { 0 };
+static OsalAtomic g_onceLockReady = { 0 };
+static OsalAtomic g_onceFence = { 0 };
+
+/* The value returning OSAL atomics are full barriers, this is one that leaves no trace. */
+static void HdfOnceFence(void)
+{
+    (void)OsalAtomicIncReturn(&g_onceFence);
+    (void)OsalAtomicDecReturn(&g_onceFence);
+}
+
+/*
+ * The lock itself has to be created on first use. Only OsalMutexInit runs in that window, and
+ * callers losing the claim sleep rather than spin so a preempted claimer always gets to finish.
+ */
+static bool HdfOnceLockGet(void)
+{
+    int32_t ready = OsalAtomicRead(&g_onceLockReady);
+    if (ready == 0 && OsalAtomicIncReturn(&g_onceLockClaim) == 1) {
+        ready = (OsalMutexInit(&g_onceLock) == HDF_SUCCESS) ? 1 : -1;
+        if (ready < 0) {
+            HDF_LOGE("%s: failed to init once lock", __func__);
+        }
+        HdfOnceFence();
+        OsalAtomicSet(&g_onceLockReady, ready);
+    }
+    while ((ready = OsalAtomicRead(&g_onceLockReady)) == 0) {
+        OsalMSleep(HDF_ONCE_LOCK_WAIT_MS);
+    }
+    HdfOnceFence();
+    return ready > 0;
+}
+
+void *HdfOnceRun(struct HdfOnce *once, HdfOnceFunc func, void *arg)
+{
+    void *object = NULL;
+
+    if (once == NULL || func == NULL) {
+        return NULL;
+    }
+    object = once->object;
+    if (object != NULL) {
+        return object;
+    }
+    if (!HdfOnceLockGet()) {
+        return NULL;
+    }
+
+    (void)OsalMutexLock(&g_onceLock);
+    if (!once->done) {
+        object = func(arg);
+        once->done = true;
+        /* what func wrote is visible before the object pointer is */
+        HdfOnceFence();
+        once->object = object;
+    }
+    object = once->object;
+    (void)OsalMutexUnlock(&g_onceLock);
+    return object;
+}
@@ -9,7 +9,7 @@
 #include "hdf_sbuf.h"
 #include "hdf_log.h"
 #include "hdf_sbuf_impl.h"
-#include "osal_mem.h"
+#include "hdf_sbuf_pool.h"
 
 #define HDF_SBUF_DEFAULT_SIZE 256
 #define HDF_SBUF_IMPL_CHECK_RETURN(sbuf, api, retCode)               \
@@ -47,6 +47,8 @@ struct HdfSBufImpl *SbufObtainIpc(size_t capacity) __attribute__((weak));
 struct HdfSBufImpl *SbufBindIpc(uintptr_t base, size_t size) __attribute__((weak));
 struct HdfSBufImpl *SbufObtainIpcHw(size_t capacity) __attribute__((weak));
 struct HdfSBufImpl *SbufBindRawIpcHw(uintptr_t base, size_t size) __attribute__((weak));
+struct HdfSBufImpl *SbufObtainSg(size_t capacity) __attribute__((weak));
+struct HdfSBufImpl *SbufBindSg(uintptr_t base, size_t size) __attribute__((weak));
 
 static const struct HdfSbufConstructor g_sbufConstructorMap[SBUF_TYPE_MAX] = {
     [SBUF_RAW] = {
@@ -61,8 +63,22 @@ static const struct HdfSbufConstructor g_sbufConstructorMap[SBUF_TYPE_MAX] = {
         .obtain = SbufObtainIpcHw,
         .bind = SbufBindRawIpcHw,
     },
+    [SBUF_SG] = {
+        .obtain = SbufObtainSg,
+        .bind = SbufBindSg,
+    },
 };
 
+static struct HdfSBuf *HdfSbufWrapperObtain(void)
+{
+    return (struct HdfSBuf *)HdfSbufPoolObtain(SBUF_POOL_WRAPPER, sizeof(struct HdfSBuf));
+}
+
+static void HdfSbufWrapperRecycle(struct HdfSBuf *sbuf)
+{
+    HdfSbufPoolRecycle(SBUF_POOL_WRAPPER, sbuf);
+}
+
 static const struct HdfSbufConstructor *HdfSbufConstructorGet(uint32_t type)
 {
     if (type >= SBUF_TYPE_MAX) {
@@ -75,6 +91,10 @@ static const struct HdfSbufConstructor *HdfSbufConstructorGet(uint32_t type)
 uint8_t *HdfSbufGetData(const struct HdfSBuf *sbuf)
 {
     HDF_SBUF_IMPL_CHECK_RETURN(sbuf, getData, NULL);
+    /* segmented implementations gather their data into one block before exposing it */
+    if (sbuf->impl->linearize != NULL && !sbuf->impl->linearize(sbuf->impl)) {
+        return NULL;
+    }
     return (uint8_t *)sbuf->impl->getData(sbuf->impl);
 }
 
@@ -118,6 +138,23 @@ bool HdfSbufWriteUnpadBuffer(struct HdfSBuf *sbuf, const uint8_t *data, uint32_t
     return sbuf->impl->writeUnpadBuffer(sbuf->impl, data, writeSize);
 }
 
+bool HdfSbufWriteBufferRef(struct HdfSBuf *sbuf, const void *data, uint32_t writeSize,
+    HdfSbufRefRelease release, void *priv)
+{
+    HDF_SBUF_IMPL_CHECK_RETURN(sbuf, writeBuffer, false);
+    if (sbuf->impl->writeBufferRef != NULL) {
+        return sbuf->impl->writeBufferRef(sbuf->impl, (const uint8_t *)data, writeSize, release, priv);
+    }
+
+    if (!sbuf->impl->writeBuffer(sbuf->impl, (const uint8_t *)data, writeSize)) {
+        return false;
+    }
+    if (release != NULL) {
+        release(priv);
+    }
+    return true;
+}
+
 const uint8_t *HdfSbufReadUnpadBuffer(struct HdfSBuf *sbuf, size_t length)
 {
     HDF_SBUF_IMPL_CHECK_RETURN(sbuf, readUnpadBuffer, NULL);
@@ -317,7 +354,7 @@ struct HdfSBuf *HdfSbufTypedObtainCapacity(uint32_t type, size_t capacity)
         return NULL;
     }
 
-    sbuf = (struct HdfSBuf *)OsalMemAlloc(sizeof(struct HdfSBuf));
+    sbuf = HdfSbufWrapperObtain();
     if (sbuf == NULL) {
         HDF_LOGE("instance sbuf failure");
         return NULL;
@@ -325,7 +362,7 @@ struct HdfSBuf *HdfSbufTypedObtainCapacity(uint32_t type, size_t capacity)
 
     sbuf->impl = constructor->obtain(capacity);
     if (sbuf->impl == NULL) {
-        OsalMemFree(sbuf);
+        HdfSbufWrapperRecycle(sbuf);
         HDF_LOGE("sbuf obtain fail, size=%u", (uint32_t)capacity);
         return NULL;
     }
@@ -340,7 +377,7 @@ struct HdfSBuf *HdfSbufTypedObtainInplace(uint32_t type, struct HdfSBufImpl *imp
         return NULL;
     }
 
-    sbuf = (struct HdfSBuf *)OsalMemAlloc(sizeof(struct HdfSBuf));
+    sbuf = HdfSbufWrapperObtain();
     if (sbuf == NULL) {
         HDF_LOGE("obtain in-place sbuf failure");
         return NULL;
@@ -370,7 +407,7 @@ struct HdfSBuf *HdfSbufTypedBind(uint32_t type, uintptr_t base, size_t size)
         return NULL;
     }
 
-    sbuf = (struct HdfSBuf *)OsalMemAlloc(sizeof(struct HdfSBuf));
+    sbuf = HdfSbufWrapperObtain();
     if (sbuf == NULL) {
         HDF_LOGE("instance sbuf failure");
         return NULL;
@@ -378,7 +415,7 @@ struct HdfSBuf *HdfSbufTypedBind(uint32_t type, uintptr_t base, size_t size)
 
     sbuf->impl = constructor->bind(base, size);
     if (sbuf->impl == NULL) {
-        OsalMemFree(sbuf);
+        HdfSbufWrapperRecycle(sbuf);
         HDF_LOGE("sbuf bind fail");
         return NULL;
     }
@@ -410,13 +447,13 @@ struct HdfSBuf *HdfSbufCopy(const struct HdfSBuf *sbuf)
 {
     struct HdfSBuf *newBuf = NULL;
     HDF_SBUF_IMPL_CHECK_RETURN(sbuf, copy, NULL);
-    newBuf = (struct HdfSBuf *)OsalMemAlloc(sizeof(struct HdfSBuf));
+    newBuf = HdfSbufWrapperObtain();
     if (newBuf == NULL) {
         return NULL;
     }
     newBuf->impl = sbuf->impl->copy(sbuf->impl);
     if (newBuf->impl == NULL) {
-        OsalMemFree(newBuf);
+        HdfSbufWrapperRecycle(newBuf);
         return NULL;
     }
     newBuf->type = sbuf->type;
@@ -427,15 +464,16 @@ struct HdfSBuf *HdfSbufMove(struct HdfSBuf *sbuf)
 {
     struct HdfSBuf *newBuf = NULL;
     HDF_SBUF_IMPL_CHECK_RETURN(sbuf, move, NULL);
-    newBuf = (struct HdfSBuf *)OsalMemAlloc(sizeof(struct HdfSBuf));
+    newBuf = HdfSbufWrapperObtain();
     if (newBuf == NULL) {
         return NULL;
     }
     newBuf->impl = sbuf->impl->move(sbuf->impl);
     if (newBuf->impl == NULL) {
-        OsalMemFree(newBuf);
+        HdfSbufWrapperRecycle(newBuf);
         return NULL;
     }
+    newBuf->type = sbuf->type;
     return newBuf;
 }
 
@@ -452,7 +490,7 @@ void HdfSbufRecycle(struct HdfSBuf *sbuf)
             sbuf->impl->recycle(sbuf->impl);
             sbuf->impl = NULL;
         }
-        OsalMemFree(sbuf);
+        HdfSbufWrapperRecycle(sbuf);
     }
 }
 
@@ -463,7 +501,7 @@ void HdfSBufRecycle(struct HdfSBuf *sbuf)
             sbuf->impl->recycle(sbuf->impl);
             sbuf->impl = NULL;
         }
-        OsalMemFree(sbuf);
+        HdfSbufWrapperRecycle(sbuf);
     }
 }
 
@@ -9,6 +9,7 @@
 #include "hdf_log.h"
 #include "hdf_sbuf.h"
 #include "hdf_sbuf_impl.h"
+#include "hdf_sbuf_pool.h"
 #include "osal_mem.h"
 #include "securec.h"
 
@@ -31,6 +32,7 @@ struct HdfSBufRaw {
     size_t capacity; /**< Storage capacity, 512 KB at most. */
     uint8_t *data;   /**< Pointer to data storage */
     bool isBind;     /**< Whether to bind the externally transferred pointer to data storage */
+    uint32_t dataCache; /**< Pool cache owning data storage, SBUF_POOL_CACHE_MAX for heap storage */
 };
 
 #define SBUF_RAW_CAST(impl) (struct HdfSBufRaw *)(impl)
@@ -43,14 +45,44 @@ static size_t SbufRawImplGetAlignSize(size_t size)
     return (size + HDF_SBUF_ALIGN - 1) & (~(HDF_SBUF_ALIGN - 1));
 }
 
+static struct HdfSBufRaw *SbufRawImplObtainShell(void)
+{
+    struct HdfSBufRaw *sbuf = (struct HdfSBufRaw *)HdfSbufPoolObtain(SBUF_POOL_RAW_IMPL, sizeof(struct HdfSBufRaw));
+    if (sbuf == NULL) {
+        return NULL;
+    }
+    (void)memset_s(sbuf, sizeof(struct HdfSBufRaw), 0, sizeof(struct HdfSBufRaw));
+    sbuf->dataCache = SBUF_POOL_CACHE_MAX;
+    return sbuf;
+}
+
+static uint8_t *SbufRawImplObtainData(size_t capacity, size_t *blockSize, uint32_t *dataCache)
+{
+    *dataCache = HdfSbufPoolDataClass(capacity, blockSize);
+    if (*dataCache == SBUF_POOL_CACHE_MAX) {
+        return NULL;
+    }
+    return (uint8_t *)HdfSbufPoolObtain(*dataCache, *blockSize);
+}
+
+static void SbufRawImplReleaseData(struct HdfSBufRaw *sbuf)
+{
+    if (sbuf->data == NULL || sbuf->isBind) {
+        return;
+    }
+    if (sbuf->dataCache != SBUF_POOL_CACHE_MAX) {
+        HdfSbufPoolRecycle(sbuf->dataCache, sbuf->data);
+    } else {
+        OsalMemFree(sbuf->data);
+    }
+}
+
 static void SbufRawImplRecycle(struct HdfSBufImpl *impl)
 {
     struct HdfSBufRaw *sbuf = SBUF_RAW_CAST(impl);
     if (sbuf != NULL) {
-        if (sbuf->data != NULL && !sbuf->isBind) {
-            OsalMemFree(sbuf->data);
-        }
-        OsalMemFree(sbuf);
+        SbufRawImplReleaseData(sbuf);
+        HdfSbufPoolRecycle(SBUF_POOL_RAW_IMPL, sbuf);
     }
 }
 
@@ -143,7 +175,8 @@ static size_t SbufRawImplGetDataSize(const struct HdfSBufImpl *impl)
 
 static bool SbufRawImplGrow(struct HdfSBufRaw *sbuf, uint32_t growSize)
 {
-    uint32_t newSize;
+    size_t newSize;
+    uint32_t newDataCache;
     uint8_t *newData = NULL;
     if (sbuf->isBind) {
         HDF_LOGE("%s: binded sbuf oom", __func__);
@@ -160,22 +193,24 @@ static bool SbufRawImplGrow(struct HdfSBufRaw *sbuf, uint32_t growSize)
         return false;
     }
 
-    newData = OsalMemCalloc(newSize);
+    /* growing to the next pool class keeps the number of copies logarithmic */
+    newData = SbufRawImplObtainData(newSize, &newSize, &newDataCache);
     if (newData == NULL) {
         HDF_LOGE("%s: oom", __func__);
         return false;
     }
 
     if (sbuf->data != NULL) {
-        if (memcpy_s(newData, newSize, sbuf->data, sbuf->writePos) != EOK) {
-            OsalMemFree(newData);
+        if (sbuf->writePos > 0 && memcpy_s(newData, newSize, sbuf->data, sbuf->writePos) != EOK) {
+            HdfSbufPoolRecycle(newDataCache, newData);
             return false;
         }
-        OsalMemFree(sbuf->data);
+        SbufRawImplReleaseData(sbuf);
     }
 
     sbuf->data = newData;
     sbuf->capacity = newSize;
+    sbuf->dataCache = newDataCache;
 
     return true;
 }
@@ -215,6 +250,10 @@ static bool SbufRawImplWrite(struct HdfSBufImpl *impl, const uint8_t *data, uint
     if (memcpy_s(dest, writeableSize, data, size) != EOK) {
         return false; /* never hits */
     }
+    /* pooled storage is not cleared on obtain, keep stale bytes out of the padding */
+    if (alignSize > size) {
+        (void)memset_s(dest + size, writeableSize - size, 0, alignSize - size);
+    }
 
     sbuf->writePos += alignSize;
     return true;
@@ -427,10 +466,9 @@ static struct HdfSBufImpl *SbufRawImplCopy(const struct HdfSBufImpl *impl)
     if (new == NULL) {
         return NULL;
     }
-    new->capacity = sbuf->capacity;
     new->readPos = 0;
     new->writePos = sbuf->writePos;
-    if (memcpy_s(new->data, new->capacity, sbuf->data, sbuf->capacity) != EOK) {
+    if (sbuf->writePos > 0 && memcpy_s(new->data, new->capacity, sbuf->data, sbuf->writePos) != EOK) {
         SbufRawImplRecycle(&new->infImpl);
         return NULL;
     }
@@ -446,7 +484,7 @@ static struct HdfSBufImpl *SbufRawImplMove(struct HdfSBufImpl *impl)
         return NULL;
     }
 
-    new = OsalMemCalloc(sizeof(struct HdfSBufRaw));
+    new = SbufRawImplObtainShell();
     if (new == NULL) {
         return NULL;
     }
@@ -454,9 +492,11 @@ static struct HdfSBufImpl *SbufRawImplMove(struct HdfSBufImpl *impl)
     new->readPos = 0;
     new->writePos = sbuf->writePos;
     new->data = sbuf->data;
+    new->dataCache = sbuf->dataCache;
 
     sbuf->data = NULL;
     sbuf->capacity = 0;
+    sbuf->dataCache = SBUF_POOL_CACHE_MAX;
     SbufRawImplFlush(&sbuf->infImpl);
     SbufInterfaceAssign(&new->infImpl);
 
@@ -513,15 +553,15 @@ static struct HdfSBufRaw *SbufRawImplNewInstance(size_t capacity)
         HDF_LOGE("%s: Sbuf size exceeding max limit", __func__);
         return NULL;
     }
-    sbuf = (struct HdfSBufRaw *)OsalMemCalloc(sizeof(struct HdfSBufRaw));
+    sbuf = SbufRawImplObtainShell();
     if (sbuf == NULL) {
         HDF_LOGE("Sbuf instance failure");
         return NULL;
     }
 
-    sbuf->data = (uint8_t *)OsalMemCalloc(capacity);
+    sbuf->data = SbufRawImplObtainData(capacity, &capacity, &sbuf->dataCache);
     if (sbuf->data == NULL) {
-        OsalMemFree(sbuf);
+        HdfSbufPoolRecycle(SBUF_POOL_RAW_IMPL, sbuf);
         HDF_LOGE("sbuf obtain memory oom, size=%u", (uint32_t)capacity);
         return NULL;
     }
@@ -553,7 +593,7 @@ struct HdfSBufImpl *SbufBindRaw(uintptr_t base, size_t size)
         HDF_LOGE("Base not in 4-byte alignment");
         return NULL;
     }
-    sbuf = (struct HdfSBufRaw *)OsalMemAlloc(sizeof(struct HdfSBufRaw));
+    sbuf = SbufRawImplObtainShell();
     if (sbuf == NULL) {
         HDF_LOGE("%s: oom", __func__);
         return NULL;
@@ -0,0 +1,856 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ *
+ * HDF is dual licensed: you can use it either under the terms of
+ * the GPL, or the BSD license, at your option.
+ * See the LICENSE file in the root of this repository for complete details.
+ */
+
+#include "hdf_log.h"
+#include "hdf_sbuf.h"
+#include "hdf_sbuf_impl.h"
+#include "hdf_sbuf_pool.h"
+#include "osal_mem.h"
+#include "securec.h"
+
+#define HDF_SBUF_SG_SEGMENT_MIN 256
+#define HDF_SBUF_SG_SEGMENT_MAX (64 * 1024)
+#define HDF_SBUF_SG_MAX_SIZE (64 * 1024 * 1024) // 64MB
+#define HDF_SBUF_SG_ALIGN 4
+#define HDF_SBUF_SG_STRING_MAX 32767
+
+struct HdfSbufSgSegment {
+    struct HdfSbufSgSegment *next;
+    uint8_t *data;
+    size_t size;                 /**< Bytes of the stream stored in this segment */
+    size_t capacity;             /**< Storage size of this segment */
+    uint32_t cacheId;            /**< Pool cache of owned storage, SBUF_POOL_CACHE_MAX for heap storage */
+    bool external;               /**< Whether the storage is referenced instead of owned */
+    void (*release)(void *priv); /**< Releases external storage, NULL if the caller keeps the ownership */
+    void *priv;
+};
+
+struct HdfSBufSg {
+    struct HdfSBufImpl infImpl;
+    struct HdfSbufSgSegment *head;
+    struct HdfSbufSgSegment *tail;
+    struct HdfSbufSgSegment *retired; /**< Storage still referenced by pointers handed out to readers */
+    struct HdfSbufSgSegment *readSeg;
+    size_t readOffset;                /**< Read offset inside readSeg */
+    size_t readPos;                   /**< Current read position of the stream */
+    size_t writePos;                  /**< Current write position of the stream */
+    size_t capacity;
+};
+
+#define SBUF_SG_CAST(impl) (struct HdfSBufSg *)(impl)
+
+static const uint8_t g_sbufSgPadding[HDF_SBUF_SG_ALIGN] = { 0 };
+
+static void SbufSgInterfaceAssign(struct HdfSBufImpl *inf);
+
+static size_t SbufSgGetAlignSize(size_t size)
+{
+    return (size + HDF_SBUF_SG_ALIGN - 1) & (~(HDF_SBUF_SG_ALIGN - 1));
+}
+
+static struct HdfSbufSgSegment *SbufSgSegmentNew(size_t capacity)
+{
+    struct HdfSbufSgSegment *seg = NULL;
+    size_t blockSize = sizeof(struct HdfSbufSgSegment) + capacity;
+    uint32_t cacheId = HdfSbufPoolDataClass(blockSize, &blockSize);
+
+    if (cacheId != SBUF_POOL_CACHE_MAX) {
+        seg = (struct HdfSbufSgSegment *)HdfSbufPoolObtain(cacheId, blockSize);
+    } else {
+        seg = (struct HdfSbufSgSegment *)OsalMemAlloc(blockSize);
+    }
+    if (seg == NULL) {
+        HDF_LOGE("%s: oom, size=%u", __func__, (uint32_t)capacity);
+        return NULL;
+    }
+
+    seg->next = NULL;
+    seg->data = (uint8_t *)(seg + 1);
+    seg->size = 0;
+    seg->capacity = blockSize - sizeof(struct HdfSbufSgSegment);
+    seg->cacheId = cacheId;
+    seg->external = false;
+    seg->release = NULL;
+    seg->priv = NULL;
+    return seg;
+}
+
+static struct HdfSbufSgSegment *SbufSgSegmentNewRef(
+    const uint8_t *data, size_t size, void (*release)(void *priv), void *priv)
+{
+    struct HdfSbufSgSegment *seg = (struct HdfSbufSgSegment *)OsalMemAlloc(sizeof(struct HdfSbufSgSegment));
+    if (seg == NULL) {
+        HDF_LOGE("%s: oom", __func__);
+        return NULL;
+    }
+
+    seg->next = NULL;
+    seg->data = (uint8_t *)data;
+    seg->size = size;
+    seg->capacity = size;
+    seg->cacheId = SBUF_POOL_CACHE_MAX;
+    seg->external = true;
+    seg->release = release;
+    seg->priv = priv;
+    return seg;
+}
+
+static void SbufSgSegmentFree(struct HdfSbufSgSegment *seg)
+{
+    if (seg->external) {
+        if (seg->release != NULL) {
+            seg->release(seg->priv);
+        }
+        OsalMemFree(seg);
+    } else if (seg->cacheId != SBUF_POOL_CACHE_MAX) {
+        HdfSbufPoolRecycle(seg->cacheId, seg);
+    } else {
+        OsalMemFree(seg);
+    }
+}
+
+static void SbufSgSegmentListFree(struct HdfSbufSgSegment *seg)
+{
+    struct HdfSbufSgSegment *next = NULL;
+    while (seg != NULL) {
+        next = seg->next;
+        SbufSgSegmentFree(seg);
+        seg = next;
+    }
+}
+
+static void SbufSgRetire(struct HdfSBufSg *sbuf, struct HdfSbufSgSegment *seg)
+{
+    seg->next = sbuf->retired;
+    sbuf->retired = seg;
+}
+
+static void SbufSgAppendSegment(struct HdfSBufSg *sbuf, struct HdfSbufSgSegment *seg)
+{
+    if (sbuf->tail == NULL) {
+        sbuf->head = seg;
+        sbuf->readSeg = seg;
+        sbuf->readOffset = 0;
+    } else {
+        sbuf->tail->next = seg;
+    }
+    sbuf->tail = seg;
+    sbuf->capacity += seg->capacity;
+}
+
+static size_t SbufSgNextSegmentSize(const struct HdfSBufSg *sbuf, size_t size)
+{
+    /* segment header and storage share one pool block, size storage to fill the block */
+    size_t segSize = HDF_SBUF_SG_SEGMENT_MIN - sizeof(struct HdfSbufSgSegment);
+    if (sbuf->tail != NULL && !sbuf->tail->external) {
+        segSize = sbuf->tail->capacity * 2; // grow geometrically to keep the chain short
+    }
+    if (segSize > HDF_SBUF_SG_SEGMENT_MAX - sizeof(struct HdfSbufSgSegment)) {
+        segSize = HDF_SBUF_SG_SEGMENT_MAX - sizeof(struct HdfSbufSgSegment);
+    }
+    return (segSize < size) ? size : segSize;
+}
+
+static bool SbufSgAppend(struct HdfSBufSg *sbuf, const uint8_t *data, size_t size)
+{
+    struct HdfSbufSgSegment *tail = NULL;
+    size_t copySize;
+
+    while (size > 0) {
+        tail = sbuf->tail;
+        if (tail == NULL || tail->external || tail->size == tail->capacity) {
+            tail = SbufSgSegmentNew(SbufSgNextSegmentSize(sbuf, size));
+            if (tail == NULL) {
+                return false;
+            }
+            SbufSgAppendSegment(sbuf, tail);
+        }
+
+        copySize = tail->capacity - tail->size;
+        copySize = (copySize < size) ? copySize : size;
+        if (memcpy_s(tail->data + tail->size, tail->capacity - tail->size, data, copySize) != EOK) {
+            return false; // never hit
+        }
+        tail->size += copySize;
+        sbuf->writePos += copySize;
+        data += copySize;
+        size -= copySize;
+    }
+    return true;
+}
+
+static void SbufSgSeekRead(struct HdfSBufSg *sbuf, size_t pos)
+{
+    struct HdfSbufSgSegment *seg = sbuf->head;
+    size_t offset = pos;
+
+    while (seg != NULL && offset >= seg->size && seg->next != NULL) {
+        offset -= seg->size;
+        seg = seg->next;
+    }
+    sbuf->readSeg = seg;
+    sbuf->readOffset = offset;
+    sbuf->readPos = pos;
+}
+
+static void SbufSgTruncate(struct HdfSBufSg *sbuf, size_t size)
+{
+    struct HdfSbufSgSegment *seg = sbuf->head;
+    struct HdfSbufSgSegment *prev = NULL;
+    struct HdfSbufSgSegment *next = NULL;
+    size_t left = size;
+
+    while (seg != NULL && left > seg->size) {
+        left -= seg->size;
+        prev = seg;
+        seg = seg->next;
+    }
+    if (seg != NULL) {
+        if (left > 0 || prev == NULL) {
+            seg->size = left;
+            prev = seg;
+            seg = seg->next;
+            prev->next = NULL;
+        } else {
+            prev->next = NULL;
+        }
+    }
+    sbuf->tail = prev;
+    if (prev == NULL) {
+        sbuf->head = NULL;
+    }
+    while (seg != NULL) {
+        next = seg->next;
+        sbuf->capacity -= seg->capacity;
+        SbufSgRetire(sbuf, seg);
+        seg = next;
+    }
+
+    sbuf->writePos = size;
+    SbufSgSeekRead(sbuf, (sbuf->readPos > size) ? size : sbuf->readPos);
+}
+
+static bool SbufSgWrite(struct HdfSBufImpl *impl, const uint8_t *data, uint32_t size)
+{
+    struct HdfSBufSg *sbuf = SBUF_SG_CAST(impl);
+    size_t writePos;
+    size_t alignSize;
+    if (sbuf == NULL || data == NULL) {
+        return false;
+    }
+    if (size == 0) {
+        return true;
+    }
+
+    alignSize = SbufSgGetAlignSize(size);
+    if (alignSize < size || alignSize > HDF_SBUF_SG_MAX_SIZE - sbuf->writePos) {
+        HDF_LOGE("%s: buf size over limit", __func__);
+        return false;
+    }
+    writePos = sbuf->writePos;
+    if (!SbufSgAppend(sbuf, data, size) || !SbufSgAppend(sbuf, g_sbufSgPadding, alignSize - size)) {
+        SbufSgTruncate(sbuf, writePos);
+        return false;
+    }
+    return true;
+}
+
+static void SbufSgSkipDrained(struct HdfSBufSg *sbuf)
+{
+    while (sbuf->readSeg != NULL && sbuf->readOffset == sbuf->readSeg->size && sbuf->readSeg->next != NULL) {
+        sbuf->readSeg = sbuf->readSeg->next;
+        sbuf->readOffset = 0;
+    }
+}
+
+static void SbufSgAdvance(struct HdfSBufSg *sbuf, size_t size)
+{
+    struct HdfSbufSgSegment *seg = sbuf->readSeg;
+    size_t left;
+
+    sbuf->readPos += size;
+    while (seg != NULL) {
+        left = seg->size - sbuf->readOffset;
+        if (size < left || (size == left && seg->next == NULL)) {
+            sbuf->readOffset += size;
+            break;
+        }
+        size -= left;
+        seg = seg->next;
+        sbuf->readOffset = 0;
+        sbuf->readSeg = seg;
+    }
+}
+
+static void SbufSgCopyOut(const struct HdfSBufSg *sbuf, uint8_t *dest, size_t size)
+{
+    const struct HdfSbufSgSegment *seg = sbuf->readSeg;
+    size_t offset = sbuf->readOffset;
+    size_t copySize;
+
+    while (seg != NULL && size > 0) {
+        copySize = seg->size - offset;
+        copySize = (copySize < size) ? copySize : size;
+        if (copySize > 0 && memcpy_s(dest, size, seg->data + offset, copySize) != EOK) {
+            return; // never hit
+        }
+        dest += copySize;
+        size -= copySize;
+        seg = seg->next;
+        offset = 0;
+    }
+}
+
+static bool SbufSgRead(struct HdfSBufImpl *impl, uint8_t *data, uint32_t readSize)
+{
+    struct HdfSBufSg *sbuf = SBUF_SG_CAST(impl);
+    size_t alignSize;
+    if (sbuf == NULL || data == NULL) {
+        return false;
+    }
+    if (readSize == 0) {
+        return true;
+    }
+
+    alignSize = SbufSgGetAlignSize(readSize);
+    if (alignSize > sbuf->writePos - sbuf->readPos) {
+        HDF_LOGE("Read out of buffer range");
+        return false;
+    }
+
+    SbufSgCopyOut(sbuf, data, readSize);
+    SbufSgAdvance(sbuf, alignSize);
+    return true;
+}
+
+/*
+ * Returns a contiguous view of the next bytes. Data spanning segments, or external data when
+ * a writable view is required, is gathered into a scratch segment living as long as the sbuf.
+ */
+static uint8_t *SbufSgReadView(struct HdfSBufSg *sbuf, size_t size, bool writable)
+{
+    struct HdfSbufSgSegment *seg = NULL;
+    struct HdfSbufSgSegment *scratch = NULL;
+    uint8_t *view = NULL;
+
+    SbufSgSkipDrained(sbuf);
+    seg = sbuf->readSeg;
+    if (seg != NULL && seg->size - sbuf->readOffset >= size && !(writable && seg->external)) {
+        view = seg->data + sbuf->readOffset;
+    } else {
+        scratch = SbufSgSegmentNew(size);
+        if (scratch == NULL) {
+            return NULL;
+        }
+        SbufSgCopyOut(sbuf, scratch->data, size);
+        SbufSgRetire(sbuf, scratch);
+        view = scratch->data;
+    }
+
+    SbufSgAdvance(sbuf, SbufSgGetAlignSize(size));
+    return view;
+}
+
+static bool SbufSgWriteUint64(struct HdfSBufImpl *impl, uint64_t value)
+{
+    return SbufSgWrite(impl, (uint8_t *)(&value), sizeof(value));
+}
+
+static bool SbufSgWriteUint32(struct HdfSBufImpl *impl, uint32_t value)
+{
+    return SbufSgWrite(impl, (uint8_t *)(&value), sizeof(value));
+}
+
+static bool SbufSgWriteUint16(struct HdfSBufImpl *impl, uint16_t value)
+{
+    return SbufSgWrite(impl, (uint8_t *)(&value), sizeof(value));
+}
+
+static bool SbufSgWriteUint8(struct HdfSBufImpl *impl, uint8_t value)
+{
+    return SbufSgWrite(impl, (uint8_t *)(&value), sizeof(value));
+}
+
+static bool SbufSgWriteInt64(struct HdfSBufImpl *impl, int64_t value)
+{
+    return SbufSgWrite(impl, (uint8_t *)(&value), sizeof(value));
+}
+
+static bool SbufSgWriteInt32(struct HdfSBufImpl *impl, int32_t value)
+{
+    return SbufSgWrite(impl, (uint8_t *)(&value), sizeof(value));
+}
+
+static bool SbufSgWriteInt16(struct HdfSBufImpl *impl, int16_t value)
+{
+    return SbufSgWrite(impl, (uint8_t *)(&value), sizeof(value));
+}
+
+static bool SbufSgWriteInt8(struct HdfSBufImpl *impl, int8_t value)
+{
+    return SbufSgWrite(impl, (uint8_t *)(&value), sizeof(value));
+}
+
+static bool SbufSgWriteBuffer(struct HdfSBufImpl *impl, const uint8_t *data, uint32_t writeSize)
+{
+    struct HdfSBufSg *sbuf = SBUF_SG_CAST(impl);
+    size_t writePos;
+    if (sbuf == NULL) {
+        HDF_LOGE("Failed to write the Sbuf, invalid input params");
+        return false;
+    }
+    if (data == NULL) {
+        return SbufSgWriteInt32(impl, 0);
+    }
+
+    writePos = sbuf->writePos;
+    if (!SbufSgWriteInt32(impl, writeSize)) {
+        return false;
+    }
+    if (!SbufSgWrite(impl, data, writeSize)) {
+        SbufSgTruncate(sbuf, writePos);
+        return false;
+    }
+    return true;
+}
+
+static bool SbufSgWriteBufferRef(struct HdfSBufImpl *impl, const uint8_t *data, uint32_t writeSize,
+    void (*release)(void *priv), void *priv)
+{
+    struct HdfSBufSg *sbuf = SBUF_SG_CAST(impl);
+    struct HdfSbufSgSegment *seg = NULL;
+    size_t writePos;
+    size_t alignSize;
+    if (sbuf == NULL || data == NULL || writeSize == 0) {
+        HDF_LOGE("%s: input invalid", __func__);
+        return false;
+    }
+
+    alignSize = SbufSgGetAlignSize(writeSize);
+    if (alignSize < writeSize || alignSize + sizeof(int32_t) > HDF_SBUF_SG_MAX_SIZE - sbuf->writePos) {
+        HDF_LOGE("%s: buf size over limit", __func__);
+        return false;
+    }
+
+    writePos = sbuf->writePos;
+    if (!SbufSgWriteInt32(impl, writeSize)) {
+        return false;
+    }
+    seg = SbufSgSegmentNewRef(data, writeSize, NULL, NULL);
+    if (seg == NULL) {
+        SbufSgTruncate(sbuf, writePos);
+        return false;
+    }
+    SbufSgAppendSegment(sbuf, seg);
+    sbuf->writePos += writeSize;
+    if (!SbufSgAppend(sbuf, g_sbufSgPadding, alignSize - writeSize)) {
+        SbufSgTruncate(sbuf, writePos);
+        return false;
+    }
+
+    /* the ownership is taken over only once nothing can fail any more */
+    seg->release = release;
+    seg->priv = priv;
+    return true;
+}
+
+static bool SbufSgWriteString(struct HdfSBufImpl *impl, const char *value)
+{
+    if (impl == NULL) {
+        HDF_LOGE("%s: input null", __func__);
+        return false;
+    }
+
+    return SbufSgWriteBuffer(impl, (const uint8_t *)value, value ? (strlen(value) + 1) : 0);
+}
+
+static bool SbufSgReadUint64(struct HdfSBufImpl *impl, uint64_t *value)
+{
+    return SbufSgRead(impl, (uint8_t *)(value), sizeof(*value));
+}
+
+static bool SbufSgReadUint32(struct HdfSBufImpl *impl, uint32_t *value)
+{
+    return SbufSgRead(impl, (uint8_t *)(value), sizeof(*value));
+}
+
+static bool SbufSgReadUint16(struct HdfSBufImpl *impl, uint16_t *value)
+{
+    return SbufSgRead(impl, (uint8_t *)(value), sizeof(*value));
+}
+
+static bool SbufSgReadUint8(struct HdfSBufImpl *impl, uint8_t *value)
+{
+    return SbufSgRead(impl, (uint8_t *)(value), sizeof(*value));
+}
+
+static bool SbufSgReadInt64(struct HdfSBufImpl *impl, int64_t *value)
+{
+    return SbufSgRead(impl, (uint8_t *)(value), sizeof(*value));
+}
+
+static bool SbufSgReadInt32(struct HdfSBufImpl *impl, int32_t *value)
+{
+    return SbufSgRead(impl, (uint8_t *)(value), sizeof(*value));
+}
+
+static bool SbufSgReadInt16(struct HdfSBufImpl *impl, int16_t *value)
+{
+    return SbufSgRead(impl, (uint8_t *)(value), sizeof(*value));
+}
+
+static bool SbufSgReadInt8(struct HdfSBufImpl *impl, int8_t *value)
+{
+    return SbufSgRead(impl, (uint8_t *)(value), sizeof(*value));
+}
+
+static bool SbufSgReadBuffer(struct HdfSBufImpl *impl, const uint8_t **data, uint32_t *readSize)
+{
+    struct HdfSBufSg *sbuf = SBUF_SG_CAST(impl);
+    int32_t buffSize = 0;
+    size_t readPos;
+    if (sbuf == NULL || data == NULL || readSize == NULL) {
+        HDF_LOGE("%s: input invalid", __func__);
+        return false;
+    }
+
+    readPos = sbuf->readPos;
+    if (!SbufSgReadInt32(impl, &buffSize)) {
+        return false;
+    }
+    if (buffSize == 0) {
+        *data = NULL;
+        *readSize = 0;
+        return true;
+    }
+    if (buffSize < 0 || SbufSgGetAlignSize(buffSize) > sbuf->writePos - sbuf->readPos) {
+        HDF_LOGE("%s:readBuff out of range", __func__);
+        SbufSgSeekRead(sbuf, readPos);
+        return false;
+    }
+
+    *data = SbufSgReadView(sbuf, buffSize, false);
+    if (*data == NULL) {
+        SbufSgSeekRead(sbuf, readPos);
+        return false;
+    }
+    *readSize = buffSize;
+    return true;
+}
+
+static const char *SbufSgReadString(struct HdfSBufImpl *impl)
+{
+    struct HdfSBufSg *sbuf = SBUF_SG_CAST(impl);
+    int32_t strLen = 0;
+    size_t readPos;
+    char *str = NULL;
+    if (sbuf == NULL) {
+        HDF_LOGE("%s: input null", __func__);
+        return NULL;
+    }
+
+    readPos = sbuf->readPos;
+    /* This length contains the '\0' at the end of the string. */
+    if (!SbufSgReadInt32(impl, &strLen) || strLen <= 0) {
+        return NULL;
+    }
+    if (strLen > HDF_SBUF_SG_STRING_MAX || SbufSgGetAlignSize(strLen) > sbuf->writePos - sbuf->readPos) {
+        SbufSgSeekRead(sbuf, readPos);
+        return NULL;
+    }
+
+    str = (char *)SbufSgReadView(sbuf, strLen, true);
+    if (str == NULL) {
+        SbufSgSeekRead(sbuf, readPos);
+        return NULL;
+    }
+    /* Set '\0' at end of the string forcibly. */
+    str[strLen - 1] = '\0';
+    return str;
+}
+
+/* Gathers the whole stream into one owned segment, keeping old storage alive for handed out pointers. */
+static bool SbufSgLinearize(struct HdfSBufImpl *impl)
+{
+    struct HdfSBufSg *sbuf = SBUF_SG_CAST(impl);
+    struct HdfSbufSgSegment *seg = NULL;
+    struct HdfSbufSgSegment *next = NULL;
+    size_t readPos;
+
+    if (sbuf == NULL) {
+        return false;
+    }
+    if (sbuf->head == NULL || sbuf->head == sbuf->tail) {
+        return true;
+    }
+
+    readPos = sbuf->readPos;
+    seg = SbufSgSegmentNew(sbuf->writePos);
+    if (seg == NULL) {
+        return false;
+    }
+    SbufSgSeekRead(sbuf, 0);
+    SbufSgCopyOut(sbuf, seg->data, sbuf->writePos);
+    seg->size = sbuf->writePos;
+
+    for (next = sbuf->head; next != NULL; next = sbuf->head) {
+        sbuf->head = next->next;
+        SbufSgRetire(sbuf, next);
+    }
+    sbuf->tail = NULL;
+    sbuf->capacity = 0;
+    SbufSgAppendSegment(sbuf, seg);
+    SbufSgSeekRead(sbuf, readPos);
+    return true;
+}
+
+/* Only a linear stream has contiguous data, callers go through linearize() first. */
+static const uint8_t *SbufSgGetData(const struct HdfSBufImpl *impl)
+{
+    const struct HdfSBufSg *sbuf = (const struct HdfSBufSg *)impl;
+    if (sbuf == NULL) {
+        HDF_LOGE("The obtained data is null, and the input Sbuf is null.");
+        return NULL;
+    }
+    if (sbuf->head != sbuf->tail) {
+        HDF_LOGE("%s: sbuf data is not linear", __func__);
+        return NULL;
+    }
+    return (sbuf->head != NULL) ? sbuf->head->data : NULL;
+}
+
+static void SbufSgFlush(struct HdfSBufImpl *impl)
+{
+    struct HdfSBufSg *sbuf = SBUF_SG_CAST(impl);
+    if (sbuf == NULL) {
+        return;
+    }
+
+    SbufSgSegmentListFree(sbuf->head);
+    SbufSgSegmentListFree(sbuf->retired);
+    sbuf->head = NULL;
+    sbuf->tail = NULL;
+    sbuf->retired = NULL;
+    sbuf->readSeg = NULL;
+    sbuf->readOffset = 0;
+    sbuf->readPos = 0;
+    sbuf->writePos = 0;
+    sbuf->capacity = 0;
+}
+
+static size_t SbufSgGetCapacity(const struct HdfSBufImpl *impl)
+{
+    struct HdfSBufSg *sbuf = SBUF_SG_CAST(impl);
+    return (sbuf != NULL) ? sbuf->capacity : 0;
+}
+
+static size_t SbufSgGetDataSize(const struct HdfSBufImpl *impl)
+{
+    struct HdfSBufSg *sbuf = SBUF_SG_CAST(impl);
+    return (sbuf != NULL) ? sbuf->writePos : 0;
+}
+
+static void SbufSgSetDataSize(struct HdfSBufImpl *impl, size_t size)
+{
+    struct HdfSBufSg *sbuf = SBUF_SG_CAST(impl);
+    struct HdfSbufSgSegment *tail = NULL;
+    if (sbuf == NULL) {
+        return;
+    }
+
+    if (size <= sbuf->writePos) {
+        SbufSgTruncate(sbuf, size);
+    } else {
+        /* data filled in through getData() can only extend into the room left in the tail segment */
+        tail = sbuf->tail;
+        if (tail == NULL || tail->external || size - sbuf->writePos > tail->capacity - tail->size) {
+            return;
+        }
+        tail->size += size - sbuf->writePos;
+        sbuf->writePos = size;
+    }
+    SbufSgSeekRead(sbuf, 0);
+}
+
+static void SbufSgRecycle(struct HdfSBufImpl *impl)
+{
+    struct HdfSBufSg *sbuf = SBUF_SG_CAST(impl);
+    if (sbuf != NULL) {
+        SbufSgFlush(impl);
+        OsalMemFree(sbuf);
+    }
+}
+
+static struct HdfSBufSg *SbufSgNewInstance(void)
+{
+    struct HdfSBufSg *sbuf = (struct HdfSBufSg *)OsalMemCalloc(sizeof(struct HdfSBufSg));
+    if (sbuf == NULL) {
+        HDF_LOGE("Sbuf instance failure");
+        return NULL;
+    }
+    SbufSgInterfaceAssign(&sbuf->infImpl);
+    return sbuf;
+}
+
+static struct HdfSBufImpl *SbufSgCopy(const struct HdfSBufImpl *impl)
+{
+    struct HdfSBufSg *sbuf = SBUF_SG_CAST(impl);
+    struct HdfSBufSg *new = NULL;
+    struct HdfSbufSgSegment *seg = NULL;
+    size_t readPos;
+    if (sbuf == NULL) {
+        return NULL;
+    }
+
+    new = SbufSgNewInstance();
+    if (new == NULL) {
+        return NULL;
+    }
+    seg = SbufSgSegmentNew((sbuf->writePos > 0) ? sbuf->writePos : HDF_SBUF_SG_SEGMENT_MIN);
+    if (seg == NULL) {
+        OsalMemFree(new);
+        return NULL;
+    }
+
+    readPos = sbuf->readPos;
+    SbufSgSeekRead(sbuf, 0);
+    SbufSgCopyOut(sbuf, seg->data, sbuf->writePos);
+    SbufSgSeekRead(sbuf, readPos);
+    seg->size = sbuf->writePos;
+    SbufSgAppendSegment(new, seg);
+    new->writePos = sbuf->writePos;
+    return &new->infImpl;
+}
+
+static struct HdfSBufImpl *SbufSgMove(struct HdfSBufImpl *impl)
+{
+    struct HdfSBufSg *sbuf = SBUF_SG_CAST(impl);
+    struct HdfSBufSg *new = NULL;
+    if (sbuf == NULL) {
+        return NULL;
+    }
+
+    new = SbufSgNewInstance();
+    if (new == NULL) {
+        return NULL;
+    }
+    new->head = sbuf->head;
+    new->tail = sbuf->tail;
+    new->retired = sbuf->retired;
+    new->writePos = sbuf->writePos;
+    new->capacity = sbuf->capacity;
+    SbufSgSeekRead(new, 0);
+
+    sbuf->head = NULL;
+    sbuf->tail = NULL;
+    sbuf->retired = NULL;
+    SbufSgFlush(&sbuf->infImpl);
+    return &new->infImpl;
+}
+
+static void SbufSgReleaseBindData(void *priv)
+{
+    OsalMemFree(priv);
+}
+
+static void SbufSgTransDataOwnership(struct HdfSBufImpl *impl)
+{
+    struct HdfSBufSg *sbuf = SBUF_SG_CAST(impl);
+    if (sbuf == NULL || sbuf->head == NULL || !sbuf->head->external || sbuf->head->release != NULL) {
+        return;
+    }
+
+    sbuf->head->release = SbufSgReleaseBindData;
+    sbuf->head->priv = sbuf->head->data;
+}
+
+static void SbufSgInterfaceAssign(struct HdfSBufImpl *inf)
+{
+    inf->writeBuffer = SbufSgWriteBuffer;
+    inf->writeBufferRef = SbufSgWriteBufferRef;
+    inf->writeUint64 = SbufSgWriteUint64;
+    inf->writeUint32 = SbufSgWriteUint32;
+    inf->writeUint16 = SbufSgWriteUint16;
+    inf->writeUint8 = SbufSgWriteUint8;
+    inf->writeInt64 = SbufSgWriteInt64;
+    inf->writeInt32 = SbufSgWriteInt32;
+    inf->writeInt16 = SbufSgWriteInt16;
+    inf->writeInt8 = SbufSgWriteInt8;
+    inf->writeString = SbufSgWriteString;
+    inf->readBuffer = SbufSgReadBuffer;
+    inf->readUint64 = SbufSgReadUint64;
+    inf->readUint32 = SbufSgReadUint32;
+    inf->readUint16 = SbufSgReadUint16;
+    inf->readUint8 = SbufSgReadUint8;
+    inf->readInt64 = SbufSgReadInt64;
+    inf->readInt32 = SbufSgReadInt32;
+    inf->readInt16 = SbufSgReadInt16;
+    inf->readInt8 = SbufSgReadInt8;
+    inf->readString = SbufSgReadString;
+    inf->getData = SbufSgGetData;
+    inf->flush = SbufSgFlush;
+    inf->getCapacity = SbufSgGetCapacity;
+    inf->getDataSize = SbufSgGetDataSize;
+    inf->setDataSize = SbufSgSetDataSize;
+    inf->recycle = SbufSgRecycle;
+    inf->move = SbufSgMove;
+    inf->copy = SbufSgCopy;
+    inf->transDataOwnership = SbufSgTransDataOwnership;
+    inf->linearize = SbufSgLinearize;
+}
+
+struct HdfSBufImpl *SbufObtainSg(size_t capacity)
+{
+    struct HdfSbufSgSegment *seg = NULL;
+    struct HdfSBufSg *sbuf = NULL;
+    if (capacity > HDF_SBUF_SG_MAX_SIZE) {
+        HDF_LOGE("%s: Sbuf size exceeding max limit", __func__);
+        return NULL;
+    }
+
+    sbuf = SbufSgNewInstance();
+    if (sbuf == NULL) {
+        return NULL;
+    }
+    if (capacity > 0) {
+        seg = SbufSgSegmentNew(capacity);
+        if (seg == NULL) {
+            OsalMemFree(sbuf);
+            return NULL;
+        }
+        SbufSgAppendSegment(sbuf, seg);
+    }
+    return &sbuf->infImpl;
+}
+
+struct HdfSBufImpl *SbufBindSg(uintptr_t base, size_t size)
+{
+    struct HdfSbufSgSegment *seg = NULL;
+    struct HdfSBufSg *sbuf = NULL;
+    if (base == 0 || size == 0) {
+        return NULL;
+    }
+    /* 4-byte alignment is required for base. */
+    if ((base & 0x3) != 0) {
+        HDF_LOGE("Base not in 4-byte alignment");
+        return NULL;
+    }
+
+    sbuf = SbufSgNewInstance();
+    if (sbuf == NULL) {
+        return NULL;
+    }
+    seg = SbufSgSegmentNewRef((const uint8_t *)base, size, NULL, NULL);
+    if (seg == NULL) {
+        OsalMemFree(sbuf);
+        return NULL;
+    }
+    SbufSgAppendSegment(sbuf, seg);
+    sbuf->writePos = size;
+    return &sbuf->infImpl;
+}
@@ -0,0 +1,196 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ *
+ * HDF is dual licensed: you can use it either under the terms of
+ * the GPL, or the BSD license, at your option.
+ * See the LICENSE file in the root of this repository for complete details.
+ */
+
+#include "hdf_sbuf_pool.h"
+#include "hdf_log.h"
+#include "hdf_once.h"
+#include "osal_mem.h"
+#include "osal_spinlock.h"
+
+#define SBUF_POOL_OBJECT_LIMIT_DEFAULT 64
+#define SBUF_POOL_DATA_256_SIZE 256
+#define SBUF_POOL_DATA_1K_SIZE 1024
+#define SBUF_POOL_DATA_4K_SIZE (4 * 1024)
+#define SBUF_POOL_DATA_64K_SIZE (64 * 1024)
+#define SBUF_POOL_DATA_512K_SIZE (512 * 1024)
+
+struct HdfSbufPoolBlock {
+    struct HdfSbufPoolBlock *next;
+};
+
+struct HdfSbufPoolCache {
+    OsalSpinlock lock;
+    struct HdfSbufPoolBlock *freeList;
+    struct HdfSbufPoolStat stat;
+};
+
+static struct HdfSbufPoolCache g_sbufPoolCaches[SBUF_POOL_CACHE_MAX] = {
+    [SBUF_POOL_WRAPPER] = { .stat = { .blockSize = 0, .limit = SBUF_POOL_OBJECT_LIMIT_DEFAULT } },
+    [SBUF_POOL_RAW_IMPL] = { .stat = { .blockSize = 0, .limit = SBUF_POOL_OBJECT_LIMIT_DEFAULT } },
+    [SBUF_POOL_DATA_256] = { .stat = { .blockSize = SBUF_POOL_DATA_256_SIZE, .limit = 64 } },
+    [SBUF_POOL_DATA_1K] = { .stat = { .blockSize = SBUF_POOL_DATA_1K_SIZE, .limit = 32 } },
+    [SBUF_POOL_DATA_4K] = { .stat = { .blockSize = SBUF_POOL_DATA_4K_SIZE, .limit = 16 } },
+    [SBUF_POOL_DATA_64K] = { .stat = { .blockSize = SBUF_POOL_DATA_64K_SIZE, .limit = 4 } },
+    [SBUF_POOL_DATA_512K] = { .stat = { .blockSize = SBUF_POOL_DATA_512K_SIZE, .limit = 1 } },
+};
+
+/* publishes g_sbufPoolCaches once the cache locks are initialized */
+static struct HdfOnce g_sbufPoolOnce = HDF_ONCE_INIT;
+
+static void *HdfSbufPoolInit(void *arg)
+{
+    struct HdfSbufPoolCache *caches = (struct HdfSbufPoolCache *)arg;
+    uint32_t i;
+    for (i = 0; i < SBUF_POOL_CACHE_MAX; i++) {
+        (void)OsalSpinInit(&caches[i].lock);
+    }
+    return caches;
+}
+
+static struct HdfSbufPoolCache *HdfSbufPoolCacheGet(uint32_t cacheId)
+{
+    struct HdfSbufPoolCache *caches = NULL;
+    if (cacheId >= SBUF_POOL_CACHE_MAX) {
+        return NULL;
+    }
+    caches = (struct HdfSbufPoolCache *)HdfOnceRun(&g_sbufPoolOnce, HdfSbufPoolInit, g_sbufPoolCaches);
+    return (caches != NULL) ? &caches[cacheId] : NULL;
+}
+
+uint32_t HdfSbufPoolDataClass(size_t capacity, size_t *blockSize)
+{
+    uint32_t cacheId;
+    for (cacheId = SBUF_POOL_DATA_256; cacheId < SBUF_POOL_CACHE_MAX; cacheId++) {
+        if (capacity <= g_sbufPoolCaches[cacheId].stat.blockSize) {
+            if (blockSize != NULL) {
+                *blockSize = g_sbufPoolCaches[cacheId].stat.blockSize;
+            }
+            return cacheId;
+        }
+    }
+    return SBUF_POOL_CACHE_MAX;
+}
+
+void *HdfSbufPoolObtain(uint32_t cacheId, size_t size)
+{
+    struct HdfSbufPoolBlock *block = NULL;
+    struct HdfSbufPoolCache *cache = HdfSbufPoolCacheGet(cacheId);
+    if (cache == NULL) {
+        return NULL;
+    }
+
+    (void)OsalSpinLock(&cache->lock);
+    block = cache->freeList;
+    if (block != NULL) {
+        cache->freeList = block->next;
+        cache->stat.cached--;
+        cache->stat.hit++;
+    } else {
+        cache->stat.miss++;
+    }
+    (void)OsalSpinUnlock(&cache->lock);
+
+    if (block != NULL) {
+        return block;
+    }
+
+    if (cache->stat.blockSize != 0) {
+        size = cache->stat.blockSize;
+    }
+    if (size < sizeof(struct HdfSbufPoolBlock)) {
+        size = sizeof(struct HdfSbufPoolBlock);
+    }
+    return OsalMemAlloc(size);
+}
+
+void HdfSbufPoolRecycle(uint32_t cacheId, void *block)
+{
+    struct HdfSbufPoolBlock *node = (struct HdfSbufPoolBlock *)block;
+    struct HdfSbufPoolCache *cache = HdfSbufPoolCacheGet(cacheId);
+    if (block == NULL) {
+        return;
+    }
+    if (cache == NULL) {
+        OsalMemFree(block);
+        return;
+    }
+
+    (void)OsalSpinLock(&cache->lock);
+    if (cache->stat.cached < cache->stat.limit) {
+        node->next = cache->freeList;
+        cache->freeList = node;
+        cache->stat.cached++;
+        node = NULL;
+    } else {
+        cache->stat.overflow++;
+    }
+    (void)OsalSpinUnlock(&cache->lock);
+
+    if (node != NULL) {
+        OsalMemFree(node);
+    }
+}
+
+static void HdfSbufPoolShrink(struct HdfSbufPoolCache *cache, uint32_t limit)
+{
+    struct HdfSbufPoolBlock *releaseList = NULL;
+    struct HdfSbufPoolBlock *block = NULL;
+
+    (void)OsalSpinLock(&cache->lock);
+    while (cache->stat.cached > limit && cache->freeList != NULL) {
+        block = cache->freeList;
+        cache->freeList = block->next;
+        block->next = releaseList;
+        releaseList = block;
+        cache->stat.cached--;
+    }
+    (void)OsalSpinUnlock(&cache->lock);
+
+    while (releaseList != NULL) {
+        block = releaseList;
+        releaseList = block->next;
+        OsalMemFree(block);
+    }
+}
+
+int32_t HdfSbufPoolSetLimit(uint32_t cacheId, uint32_t limit)
+{
+    struct HdfSbufPoolCache *cache = HdfSbufPoolCacheGet(cacheId);
+    if (cache == NULL) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+
+    (void)OsalSpinLock(&cache->lock);
+    cache->stat.limit = limit;
+    (void)OsalSpinUnlock(&cache->lock);
+    HdfSbufPoolShrink(cache, limit);
+    return HDF_SUCCESS;
+}
+
+int32_t HdfSbufPoolGetStat(uint32_t cacheId, struct HdfSbufPoolStat *stat)
+{
+    struct HdfSbufPoolCache *cache = HdfSbufPoolCacheGet(cacheId);
+    if (cache == NULL || stat == NULL) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+
+    (void)OsalSpinLock(&cache->lock);
+    *stat = cache->stat;
+    (void)OsalSpinUnlock(&cache->lock);
+    return HDF_SUCCESS;
+}
+
+void HdfSbufPoolDrain(void)
+{
+    uint32_t cacheId;
+    struct HdfSbufPoolCache *cache = NULL;
+    for (cacheId = 0; cacheId < SBUF_POOL_CACHE_MAX; cacheId++) {
+        cache = HdfSbufPoolCacheGet(cacheId);
+        HdfSbufPoolShrink(cache, 0);
+    }
+}
@@ -15,6 +15,8 @@ static int32_t HdfThreadTasker(void *data);
 
 #define HDF_LOG_TAG hdf_task_queue
 
+#define HDF_TASK_QUEUE_RING_SIZE 256
+
 static int32_t HdfCreateThread(struct HdfTaskQueue *queue)
 {
     int32_t ret;
@@ -47,9 +49,9 @@ struct HdfTaskQueue *HdfTaskQueueCreate(HdfTaskFunc func, const char *name)
         return NULL;
     }
 
-    ret = OsalSemInit(&queue->sem, 0);
+    ret = HdfMpmcQueueInit(&queue->ring, HDF_TASK_QUEUE_RING_SIZE);
     if (ret != HDF_SUCCESS) {
-        HDF_LOGE("%s OsalSemInit fail", __func__);
+        HDF_LOGE("%s HdfMpmcQueueInit fail", __func__);
         OsalMutexDestroy(&queue->mutex);
         OsalMemFree(queue);
         return NULL;
@@ -59,13 +61,13 @@ struct HdfTaskQueue *HdfTaskQueueCreate(HdfTaskFunc func, const char *name)
     if (ret != HDF_SUCCESS) {
         HDF_LOGE("%s HdfCreateThread fail", __func__);
         (void)OsalMutexDestroy(&queue->mutex);
-        (void)OsalSemDestroy(&queue->sem);
+        HdfMpmcQueueDestroy(&queue->ring);
         OsalMemFree(queue);
         return NULL;
     }
 
     queue->queueName = name;
-    queue->threadRunFlag = false;
+    OsalAtomicSet(&queue->threadRunFlag, 0);
 
     if (func != NULL) {
         queue->queueFunc = func;
@@ -76,19 +78,13 @@ struct HdfTaskQueue *HdfTaskQueueCreate(HdfTaskFunc func, const char *name)
 
 static void hdfQueueStopThread(struct HdfTaskQueue *queue)
 {
-    int32_t ret;
-
     if (queue == NULL) {
         HDF_LOGE("%s queue ptr is null", __func__);
         return;
     }
 
-    queue->threadRunFlag = false;
-
-    ret = OsalSemPost(&queue->sem);
-    if (ret != HDF_SUCCESS) {
-        HDF_LOGE("%s OsalSemPost fail", __func__);
-    }
+    OsalAtomicSet(&queue->threadRunFlag, 0);
+    HdfMpmcQueueWake(&queue->ring);
 }
 
 void HdfTaskQueueDestroy(struct HdfTaskQueue *queue)
@@ -108,7 +104,7 @@ static void hdfQueueStartThread(struct HdfTaskQueue *queue)
     (void)memset_s(&param, sizeof(param), 0, sizeof(param));
     param.name = (char *)queue->queueName;
     param.priority = OSAL_THREAD_PRI_HIGH;
-    queue->threadRunFlag = true;
+    OsalAtomicSet(&queue->threadRunFlag, 1);
 
     ret = OsalThreadStart(&queue->thread, &param);
     if (ret != HDF_SUCCESS) {
@@ -125,77 +121,95 @@ void HdfTaskEnqueue(struct HdfTaskQueue *queue, struct HdfTaskType *task)
         return;
     }
 
+    if (OsalAtomicRead(&queue->threadRunFlag) == 0) {
+        ret = OsalMutexLock(&queue->mutex);
+        if (ret != HDF_SUCCESS) {
+            HDF_LOGE("%s OsalMutexLock fail", __func__);
+            return;
+        }
+        if (OsalAtomicRead(&queue->threadRunFlag) == 0) {
+            hdfQueueStartThread(queue);
+        }
+        (void)OsalMutexUnlock(&queue->mutex);
+    }
+
+    /* keep tasks behind the overflow list until it drains so each producer's tasks stay in order */
+    if (OsalAtomicRead(&queue->overflowCount) == 0 &&
+        HdfMpmcQueueOffer(&queue->ring, task) == HDF_SUCCESS) {
+        return;
+    }
+
     ret = OsalMutexLock(&queue->mutex);
     if (ret != HDF_SUCCESS) {
         HDF_LOGE("%s OsalMutexLock fail", __func__);
         return;
     }
-
-    if (!queue->threadRunFlag) {
-        hdfQueueStartThread(queue);
-    }
-
     DListInsertTail(&task->node, &queue->head);
-
+    OsalAtomicInc(&queue->overflowCount);
     ret = OsalMutexUnlock(&queue->mutex);
     if (ret != HDF_SUCCESS) {
         HDF_LOGE("%s OsalMutexUnlock fail", __func__);
-        return;
     }
 
-    ret = OsalSemPost(&queue->sem);
-    if (ret != HDF_SUCCESS) {
-        HDF_LOGE("%s OsalSemPost fail", __func__);
-    }
+    HdfMpmcQueueWake(&queue->ring);
 }
 
 static struct HdfTaskType *HdfTaskDequeue(struct HdfTaskQueue *queue)
 {
-    struct HdfTaskType *task = NULL;
+    struct HdfTaskType *task = (struct HdfTaskType *)HdfMpmcQueueTryPop(&queue->ring);
+
+    if (task != NULL || OsalAtomicRead(&queue->overflowCount) == 0) {
+        return task;
+    }
 
+    if (OsalMutexLock(&queue->mutex) != HDF_SUCCESS) {
+        HDF_LOGE("%s OsalMutexLock fail", __func__);
+        return NULL;
+    }
     if (!DListIsEmpty(&queue->head)) {
         task = DLIST_FIRST_ENTRY(&queue->head, struct HdfTaskType, node);
         DListRemove(&task->node);
+        OsalAtomicDec(&queue->overflowCount);
     }
+    (void)OsalMutexUnlock(&queue->mutex);
 
     return task;
 }
 
+static void HdfTaskRun(struct HdfTaskQueue *queue, struct HdfTaskType *task)
+{
+    if (task->func) {
+        task->func(task);
+    } else if (queue->queueFunc) {
+        queue->queueFunc(task);
+    } else {
+        HDF_LOGE("%s no task and queue function", __func__);
+    }
+}
+
 static int32_t HdfThreadTasker(void *data)
 {
-    int32_t ret;
     struct HdfTaskType *task = NULL;
     struct HdfTaskQueue *queue = (struct HdfTaskQueue *)data;
 
-    while (queue->threadRunFlag) {
-        ret = OsalSemWait(&queue->sem, HDF_WAIT_FOREVER);
-        if (ret != HDF_SUCCESS) {
-            continue;
-        }
-        ret = OsalMutexLock(&queue->mutex);
-        if (ret != HDF_SUCCESS) {
-            HDF_LOGE("%s OsalMutexLock fail", __func__);
-            continue;
-        }
+    while (OsalAtomicRead(&queue->threadRunFlag) != 0) {
         task = HdfTaskDequeue(queue);
-        while (task != NULL) {
-            if (task->func) {
-                task->func(task);
-            } else if (queue->queueFunc) {
-                queue->queueFunc(task);
-            } else {
-                HDF_LOGE("%s no task and queue function", __func__);
+        if (task == NULL) {
+            task = (struct HdfTaskType *)HdfMpmcQueuePoll(&queue->ring, HDF_WAIT_FOREVER);
+            if (task == NULL) {
+                continue;
             }
-            task = HdfTaskDequeue(queue);
-        }
-        ret = OsalMutexUnlock(&queue->mutex);
-        if (ret != HDF_SUCCESS) {
-            HDF_LOGE("%s OsalMutexUnlock fail", __func__);
         }
+        HdfTaskRun(queue, task);
+    }
+
+    /* tasks enqueued before HdfTaskQueueDestroy still run, the queue owner may be waiting on them */
+    while ((task = HdfTaskDequeue(queue)) != NULL) {
+        HdfTaskRun(queue, task);
     }
 
     (void)OsalMutexDestroy(&queue->mutex);
-    (void)OsalSemDestroy(&queue->sem);
+    HdfMpmcQueueDestroy(&queue->ring);
     OsalMemFree(queue);
     HDF_LOGI("%s thread exit", __func__);
 
@@ -7,17 +7,128 @@
  */
 
 #include "osal_message.h"
+#include "hdf_once.h"
 #include "osal_mem.h"
+#include "osal_spinlock.h"
+#include "securec.h"
+
+#define HDF_MESSAGE_SLAB_BLOCK_SIZE \
+    ((sizeof(struct HdfMessage) + HDF_MESSAGE_SLAB_EXTEND_SIZE + sizeof(void *) - 1) & ~(sizeof(void *) - 1))
+#define HDF_MESSAGE_SLAB_CHUNK_BLOCKS 64
+#define HDF_MESSAGE_SLAB_CHUNK_MAX 32
+
+/*
+ * Chunks are carved into fixed-size blocks on demand and kept for the lifetime of the
+ * framework, so the slab holds at most HDF_MESSAGE_SLAB_CHUNK_MAX * HDF_MESSAGE_SLAB_CHUNK_BLOCKS
+ * messages and never returns memory to the heap.
+ */
+struct HdfMessageSlab {
+    OsalSpinlock lock;
+    struct HdfSListNode *freeList;
+    uint32_t chunkCount;
+};
+
+static struct HdfMessageSlab g_messageSlab;
+/* publishes g_messageSlab once its lock is initialized */
+static struct HdfOnce g_messageSlabOnce = HDF_ONCE_INIT;
+
+static void *HdfMessageSlabInit(void *arg)
+{
+    struct HdfMessageSlab *slab = (struct HdfMessageSlab *)arg;
+    (void)OsalSpinInit(&slab->lock);
+    return slab;
+}
+
+static struct HdfMessageSlab *HdfMessageSlabGet(void)
+{
+    return (struct HdfMessageSlab *)HdfOnceRun(&g_messageSlabOnce, HdfMessageSlabInit, &g_messageSlab);
+}
+
+static struct HdfMessage *HdfMessageSlabGrow(struct HdfMessageSlab *slab)
+{
+    uint32_t i;
+    uint8_t *chunk = NULL;
+
+    if (slab->chunkCount >= HDF_MESSAGE_SLAB_CHUNK_MAX) {
+        return NULL;
+    }
+    chunk = (uint8_t *)OsalMemAlloc(HDF_MESSAGE_SLAB_BLOCK_SIZE * HDF_MESSAGE_SLAB_CHUNK_BLOCKS);
+    if (chunk == NULL) {
+        return NULL;
+    }
+
+    (void)OsalSpinLock(&slab->lock);
+    if (slab->chunkCount >= HDF_MESSAGE_SLAB_CHUNK_MAX) {
+        (void)OsalSpinUnlock(&slab->lock);
+        OsalMemFree(chunk);
+        return NULL;
+    }
+    slab->chunkCount++;
+    /* the first block goes to the caller, the rest to the free list */
+    for (i = 1; i < HDF_MESSAGE_SLAB_CHUNK_BLOCKS; i++) {
+        struct HdfSListNode *node = (struct HdfSListNode *)(chunk + i * HDF_MESSAGE_SLAB_BLOCK_SIZE);
+        node->next = slab->freeList;
+        slab->freeList = node;
+    }
+    (void)OsalSpinUnlock(&slab->lock);
+    return (struct HdfMessage *)chunk;
+}
+
+static struct HdfMessage *HdfMessageSlabAlloc(void)
+{
+    struct HdfMessageSlab *slab = HdfMessageSlabGet();
+    struct HdfSListNode *node = NULL;
+
+    if (slab == NULL) {
+        return NULL;
+    }
+    (void)OsalSpinLock(&slab->lock);
+    node = slab->freeList;
+    if (node != NULL) {
+        slab->freeList = node->next;
+    }
+    (void)OsalSpinUnlock(&slab->lock);
+
+    if (node == NULL) {
+        return HdfMessageSlabGrow(slab);
+    }
+    return (struct HdfMessage *)node;
+}
 
 struct HdfMessage *HdfMessageObtain(size_t extendSize)
 {
     size_t newSize = sizeof(struct HdfMessage) + extendSize;
+    struct HdfMessage *message = NULL;
+
+    if (extendSize <= HDF_MESSAGE_SLAB_EXTEND_SIZE) {
+        message = HdfMessageSlabAlloc();
+        if (message != NULL) {
+            (void)memset_s(message, newSize, 0, newSize);
+            message->flags = HDF_MESSAGE_FLAG_SLAB;
+            return message;
+        }
+    }
     return (struct HdfMessage *)OsalMemCalloc(newSize);
 }
 
 void HdfMessageRecycle(struct HdfMessage *message)
 {
-    OsalMemFree(message);
+    struct HdfMessageSlab *slab = NULL;
+
+    if (message == NULL) {
+        return;
+    }
+    if ((message->flags & HDF_MESSAGE_FLAG_SLAB) == 0) {
+        OsalMemFree(message);
+        return;
+    }
+
+    /* a slab message was carved from the published slab, so it is there */
+    slab = HdfMessageSlabGet();
+    (void)OsalSpinLock(&slab->lock);
+    message->entry.next = slab->freeList;
+    slab->freeList = &message->entry;
+    (void)OsalSpinUnlock(&slab->lock);
 }
 
 void HdfMessageDelete(struct HdfSListNode *listEntry)
@@ -27,4 +138,3 @@ void HdfMessageDelete(struct HdfSListNode *listEntry)
         HdfMessageRecycle(message);
     }
 }
-
@@ -7,8 +7,15 @@
  */
 
 #include "osal_msg_queue.h"
+#include "hdf_log.h"
+#include "osal_mem.h"
 #include "osal_message.h"
 #include "osal_time.h"
+#include "securec.h"
+
+#define HDF_LOG_TAG osal_msg_queue
+
+#define MESSAGE_TIMER_CAPACITY_MIN 8
 
 void OsalMessageQueueInit(struct HdfMessageQueue *queue)
 {
@@ -16,76 +23,210 @@ void OsalMessageQueueInit(struct HdfMessageQueue *queue)
         OsalMutexInit(&queue->mutex);
         OsalSemInit(&queue->semaphore, 0);
         HdfSListInit(&queue->list);
+        queue->tail = NULL;
+        queue->timers = NULL;
+        queue->timerCount = 0;
+        queue->timerCapacity = 0;
+        queue->sequence = 0;
+        queue->waiting = false;
     }
 }
 
 void OsalMessageQueueDestroy(struct HdfMessageQueue *queue)
 {
     if (queue != NULL) {
+        HdfMessageQueueFlush(queue);
         OsalMutexDestroy(&queue->mutex);
         OsalSemDestroy(&queue->semaphore);
-        HdfSListFlush(&queue->list, HdfMessageDelete);
+        OsalMemFree(queue->timers);
+        queue->timers = NULL;
+        queue->timerCapacity = 0;
+    }
+}
+
+static bool MessageTimerBefore(const struct HdfMessage *a, const struct HdfMessage *b)
+{
+    if (a->timeStamp != b->timeStamp) {
+        return a->timeStamp < b->timeStamp;
+    }
+    return (int32_t)(a->sequence - b->sequence) < 0;
+}
+
+static int32_t MessageTimerPush(struct HdfMessageQueue *queue, struct HdfMessage *message)
+{
+    uint32_t index;
+
+    if (queue->timerCount == queue->timerCapacity) {
+        uint32_t capacity = (queue->timerCapacity == 0) ? MESSAGE_TIMER_CAPACITY_MIN : queue->timerCapacity * 2;
+        struct HdfMessage **timers = (struct HdfMessage **)OsalMemAlloc(sizeof(*timers) * capacity);
+        if (timers == NULL) {
+            return HDF_ERR_MALLOC_FAIL;
+        }
+        if (queue->timerCount != 0 && memcpy_s(timers, sizeof(*timers) * capacity,
+            queue->timers, sizeof(*timers) * queue->timerCount) != EOK) {
+            OsalMemFree(timers);
+            return HDF_FAILURE;
+        }
+        OsalMemFree(queue->timers);
+        queue->timers = timers;
+        queue->timerCapacity = capacity;
+    }
+
+    index = queue->timerCount++;
+    while (index > 0) {
+        uint32_t parent = (index - 1) / 2;
+        if (!MessageTimerBefore(message, queue->timers[parent])) {
+            break;
+        }
+        queue->timers[index] = queue->timers[parent];
+        index = parent;
+    }
+    queue->timers[index] = message;
+    return HDF_SUCCESS;
+}
+
+static struct HdfMessage *MessageTimerPop(struct HdfMessageQueue *queue)
+{
+    struct HdfMessage *top = queue->timers[0];
+    struct HdfMessage *last = queue->timers[--queue->timerCount];
+    uint32_t index = 0;
+
+    while (true) {
+        uint32_t child = index * 2 + 1;
+        if (child >= queue->timerCount) {
+            break;
+        }
+        if (child + 1 < queue->timerCount && MessageTimerBefore(queue->timers[child + 1], queue->timers[child])) {
+            child++;
+        }
+        if (!MessageTimerBefore(queue->timers[child], last)) {
+            break;
+        }
+        queue->timers[index] = queue->timers[child];
+        index = child;
+    }
+    queue->timers[index] = last;
+    return top;
+}
+
+static void MessageReadyAdd(struct HdfMessageQueue *queue, struct HdfMessage *message)
+{
+    message->entry.next = NULL;
+    if (queue->tail == NULL) {
+        queue->list.root = &message->entry;
+    } else {
+        queue->tail->next = &message->entry;
     }
+    queue->tail = &message->entry;
+}
+
+/* moves delayed messages that are due to the tail of the ready list, must hold mutex */
+static void MessageTimerExpire(struct HdfMessageQueue *queue, uint64_t currentTime)
+{
+    while (queue->timerCount > 0 && queue->timers[0]->timeStamp <= currentTime) {
+        MessageReadyAdd(queue, MessageTimerPop(queue));
+    }
+}
+
+/* marks the consumer as sleeping and returns how long it may sleep, must hold mutex */
+static uint32_t MessageQueuePrepareWait(struct HdfMessageQueue *queue, uint64_t currentTime)
+{
+    uint64_t delay;
+
+    queue->waiting = true;
+    if (queue->timerCount == 0) {
+        return OSAL_WAIT_FOREVER;
+    }
+    delay = queue->timers[0]->timeStamp - currentTime;
+    return (delay >= OSAL_WAIT_FOREVER) ? (OSAL_WAIT_FOREVER - 1) : (uint32_t)delay;
 }
 
 void HdfMessageQueueEnqueue(
     struct HdfMessageQueue *queue, struct HdfMessage *message, long delayed)
 {
+    bool wakeup = false;
+
     if (queue == NULL || message == NULL) {
         return;
     }
 
-    struct HdfSListIterator it;
-    (void)delayed;
-    message->timeStamp += OsalGetSysTimeMs();
+    uint64_t currentTime = OsalGetSysTimeMs();
+    message->timeStamp += currentTime + ((delayed > 0) ? (uint64_t)delayed : 0);
     OsalMutexLock(&queue->mutex);
-    HdfSListIteratorInit(&it, &queue->list);
-    while (HdfSListIteratorHasNext(&it)) {
-        struct HdfMessage *next = (struct HdfMessage *)HdfSListIteratorNext(&it);
-        if (next->timeStamp > message->timeStamp) {
-            HdfSListIteratorInsert(&it, &message->entry);
-            goto COMPLETE;
-        }
+    message->sequence = queue->sequence++;
+    if (message->timeStamp <= currentTime) {
+        MessageReadyAdd(queue, message);
+        wakeup = queue->waiting;
+    } else if (MessageTimerPush(queue, message) == HDF_SUCCESS) {
+        /* the consumer only needs to recompute its timeout if this became the earliest timer */
+        wakeup = queue->waiting && queue->timers[0] == message;
+    } else {
+        HDF_LOGE("%s: no memory for delayed message %d, dropped", __func__, message->messageId);
+        HdfMessageRecycle(message);
+    }
+    if (wakeup) {
+        queue->waiting = false;
     }
-
-    HdfSListAddTail(&queue->list, &message->entry);
-COMPLETE:
     OsalMutexUnlock(&queue->mutex);
-    OsalSemPost(&queue->semaphore);
+    if (wakeup) {
+        OsalSemPost(&queue->semaphore);
+    }
 }
 
 struct HdfMessage* HdfMessageQueueNext(struct HdfMessageQueue *queue)
 {
-    struct HdfSListIterator it;
     struct HdfMessage *message = NULL;
     uint64_t currentTime = OsalGetSysTimeMs();
+    uint32_t timeout;
 
     OsalMutexLock(&queue->mutex);
-    HdfSListIteratorInit(&it, &queue->list);
-    while (HdfSListIteratorHasNext(&it)) {
-        message = (struct HdfMessage *)HdfSListIteratorNext(&it);
-        if (message->timeStamp <= currentTime) {
-            HdfSListIteratorRemove(&it);
-            OsalMutexUnlock(&queue->mutex);
-            return message;
+    queue->waiting = false;
+    MessageTimerExpire(queue, currentTime);
+    message = (struct HdfMessage *)HdfSListPop(&queue->list);
+    if (message != NULL) {
+        if (queue->list.root == NULL) {
+            queue->tail = NULL;
         }
+        OsalMutexUnlock(&queue->mutex);
+        return message;
     }
 
+    timeout = MessageQueuePrepareWait(queue, currentTime);
     OsalMutexUnlock(&queue->mutex);
-    OsalSemWait(&queue->semaphore, OSAL_WAIT_FOREVER);
+    OsalSemWait(&queue->semaphore, timeout);
     return NULL;
 }
 
-void HdfMessageQueueFlush(struct HdfMessageQueue *queue)
+struct HdfMessage *HdfMessageQueueDrain(struct HdfMessageQueue *queue)
 {
-    struct HdfSListIterator it;
+    struct HdfMessage *message = NULL;
+    uint64_t currentTime = OsalGetSysTimeMs();
+    uint32_t timeout;
+
     OsalMutexLock(&queue->mutex);
-    HdfSListIteratorInit(&it, &queue->list);
-    while (HdfSListIteratorHasNext(&it)) {
-        struct HdfMessage *msgNode = (struct HdfMessage *)HdfSListIteratorNext(&it);
-        HdfSListIteratorRemove(&it);
-        HdfMessageRecycle(msgNode);
+    queue->waiting = false;
+    MessageTimerExpire(queue, currentTime);
+    message = (struct HdfMessage *)queue->list.root;
+    if (message != NULL) {
+        HdfSListInit(&queue->list);
+        queue->tail = NULL;
+        OsalMutexUnlock(&queue->mutex);
+        return message;
     }
+
+    timeout = MessageQueuePrepareWait(queue, currentTime);
     OsalMutexUnlock(&queue->mutex);
+    OsalSemWait(&queue->semaphore, timeout);
+    return NULL;
 }
 
+void HdfMessageQueueFlush(struct HdfMessageQueue *queue)
+{
+    OsalMutexLock(&queue->mutex);
+    HdfSListFlush(&queue->list, HdfMessageDelete);
+    queue->tail = NULL;
+    while (queue->timerCount > 0) {
+        HdfMessageRecycle(queue->timers[--queue->timerCount]);
+    }
+    OsalMutexUnlock(&queue->mutex);
+}